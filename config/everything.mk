@@ -203,6 +203,7 @@ $(EBPF_BINDIR)/$(1).o: $(MKPATH)$(1).c
 	#######################################################################
 	# Creating ebpf-bin $$@ from $$^
 	#######################################################################
+	@command -v $(EBPF_CC) > /dev/null || { echo "ebpf-bin requires $(EBPF_CC) with the bpf target (set EBPF_CC)"; exit 1; }
 	$(MKDIR) $$(dir $$@) && \
 $(EBPF_CC) $(EBPF_CPPFLAGS) $(EBPF_CFLAGS) -c $$< -o $$@
 
@@ -212,6 +213,14 @@ endef
 
 make-ebpf-bin = $(eval $(call _make-ebpf-bin,$(1)))
 
+# The eBPF programs are only buildable (and only used) with libbpf, so
+# asking for them without it fails loudly instead of doing nothing
+
+ifndef FD_HAS_LIBBPF
+ebpf-bin:
+	@echo "ebpf-bin requires EXTRAS=libbpf"; exit 1
+endif
+
 ##############################
 ## GENERIC RULES
 
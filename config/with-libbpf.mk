@@ -1,3 +1,7 @@
+ifneq "$(shell pkg-config --exists libbpf && echo 1)" "1"
+$(error EXTRAS libbpf requires pkg-config and libbpf (see README.md))
+endif
+
 CFLAGS+=-DFD_HAS_LIBBPF=1
 CFLAGS+=$(shell pkg-config --cflags libbpf)
 LDFLAGS+=$(shell pkg-config --libs libbpf)
@@ -0,0 +1,2 @@
+CPPFLAGS+=-DFD_HAS_TRACE=1
+FD_HAS_TRACE:=1
@@ -19,7 +19,16 @@
 
      {HA,SV}_FILT_{CNT,SZ} is frank specific and the number of times a
      transaction was dropped by a verify tile due to failing signature
-     verification. */
+     verification.
+
+     {SPIN,WORK,BACKP,HKEEP}_TICKS are same as standard
+     {SPIN,WORK,BACKP,HKEEP}_TICKS (frank tiles use a cnc app region
+     large enough to hold them).
+
+     PERF_{CYCLES,INSNS,LLC_MISS,BR_MISS,DTLB_MISS,FAIL_CNT} are same as
+     standard PERF_{CYCLES,INSNS,LLC_MISS,BR_MISS,DTLB_MISS,FAIL_CNT}
+     (these stay zero for tiles running on hosts without performance
+     counter support). */
 
 #define FD_FRANK_CNC_DIAG_IN_BACKP    FD_CNC_DIAG_IN_BACKP  /* ==0 */
 #define FD_FRANK_CNC_DIAG_BACKP_CNT   FD_CNC_DIAG_BACKP_CNT /* ==1 */
@@ -27,14 +36,25 @@
 #define FD_FRANK_CNC_DIAG_HA_FILT_SZ  (3UL)                 /* " */
 #define FD_FRANK_CNC_DIAG_SV_FILT_CNT (4UL)                 /* ", ideally never */
 #define FD_FRANK_CNC_DIAG_SV_FILT_SZ  (5UL)                 /* " */
+#define FD_FRANK_CNC_DIAG_SPIN_TICKS  FD_CNC_DIAG_SPIN_TICKS  /* ==8 */
+#define FD_FRANK_CNC_DIAG_WORK_TICKS  FD_CNC_DIAG_WORK_TICKS  /* ==9 */
+#define FD_FRANK_CNC_DIAG_BACKP_TICKS FD_CNC_DIAG_BACKP_TICKS /* ==10 */
+#define FD_FRANK_CNC_DIAG_HKEEP_TICKS FD_CNC_DIAG_HKEEP_TICKS /* ==11 */
+#define FD_FRANK_CNC_DIAG_PERF_CYCLES    FD_CNC_DIAG_PERF_CYCLES    /* ==16 */
+#define FD_FRANK_CNC_DIAG_PERF_INSNS     FD_CNC_DIAG_PERF_INSNS     /* ==17 */
+#define FD_FRANK_CNC_DIAG_PERF_LLC_MISS  FD_CNC_DIAG_PERF_LLC_MISS  /* ==18 */
+#define FD_FRANK_CNC_DIAG_PERF_BR_MISS   FD_CNC_DIAG_PERF_BR_MISS   /* ==19 */
+#define FD_FRANK_CNC_DIAG_PERF_DTLB_MISS FD_CNC_DIAG_PERF_DTLB_MISS /* ==20 */
+#define FD_FRANK_CNC_DIAG_PERF_FAIL_CNT  FD_CNC_DIAG_PERF_FAIL_CNT  /* ==21 */
 
 FD_PROTOTYPES_BEGIN
 
-/* fd_frank_{verify,dedup,pack}_task is a fd_tile_task_t compatible
-   function whose task is to run a {verify,dedup,pack} tile.  argc is
-   ignored, argv[0] points to a cstr with the tile name (for a verify,
-   this is also used to find the specific verify configuration in the
-   frank instance's configuration), argv[1] points to a cstr with the
+/* fd_frank_{verify,dedup,mux,pack}_task is a fd_tile_task_t compatible
+   function whose task is to run a {verify,dedup,mux,pack} tile.  argc
+   is ignored, argv[0] points to a cstr with the tile name (for a verify
+   or a dedup shard, this is also used to find the specific verify or
+   dedup shard configuration in the frank instance's configuration),
+   argv[1] points to a cstr with the
    gaddr of the pod containing the frank instance's configuration and
    argv[2] points to a cstr with the path to the frank instance's
    configuration.  The lifetime of these cstr should be longer than the
@@ -52,6 +72,15 @@ int
 fd_frank_dedup_task( int     argc,
                      char ** argv );
 
+/* The mux tile is only run when the dedup is sharded (i.e. the
+   configuration's dedup.shard_cnt is greater than 1).  It merges the
+   dedup shard outputs into the single dedup output consumed by the
+   pack. */
+
+int
+fd_frank_mux_task( int     argc,
+                   char ** argv );
+
 int
 fd_frank_pack_task( int     argc,
                     char ** argv );
@@ -7,7 +7,8 @@ fd_frank_dedup_task( int     argc,
                      char ** argv ) {
   (void)argc;
   fd_log_thread_set( argv[0] );
-  FD_LOG_INFO(( "dedup init" ));
+  char const * dedup_name = argv[0];
+  FD_LOG_INFO(( "%s init", dedup_name ));
 
   /* Parse "command line" arguments */
 
@@ -21,8 +22,34 @@ fd_frank_dedup_task( int     argc,
   uchar const * cfg_pod = fd_pod_query_subpod( pod, cfg_path );
   if( FD_UNLIKELY( !cfg_pod ) ) FD_LOG_ERR(( "path not found" ));
 
-  FD_LOG_INFO(( "joining %s.dedup.cnc", cfg_path ));
-  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( cfg_pod, "dedup.cnc" ) );
+  /* If dedup is sharded (dedup.shard_cnt>1), this tile is the shard
+     configured at dedup.shard.[dedup_name] (and dedup itself is the mux
+     that merges the shards).  Otherwise, this tile is configured at
+     dedup. */
+
+  ulong shard_cnt = fd_pod_query_ulong( cfg_pod, "dedup.shard_cnt", 1UL );
+  FD_LOG_INFO(( "%s.dedup.shard_cnt %lu", cfg_path, shard_cnt ));
+  if( FD_UNLIKELY( (!shard_cnt) | (shard_cnt>FD_DEDUP_TILE_SHARD_MAX) ) ) FD_LOG_ERR(( "bad dedup.shard_cnt" ));
+
+  char dedup_path[ 128 ];
+  if( shard_cnt==1UL ) fd_cstr_printf( dedup_path, 128UL, NULL, "dedup" );
+  else                 fd_cstr_printf( dedup_path, 128UL, NULL, "dedup.shard.%s", dedup_name );
+
+  uchar const * dedup_pod = fd_pod_query_subpod( cfg_pod, dedup_path );
+  if( FD_UNLIKELY( !dedup_pod ) ) FD_LOG_ERR(( "%s.%s path not found", cfg_path, dedup_path ));
+
+  ulong shard_idx = fd_pod_query_ulong( dedup_pod, "shard_idx", 0UL );
+  FD_LOG_INFO(( "%s.%s.shard_idx %lu", cfg_path, dedup_path, shard_idx ));
+  if( FD_UNLIKELY( shard_idx>=shard_cnt ) ) FD_LOG_ERR(( "bad shard_idx" ));
+
+  /* The verify fseq used to return credits to each verify */
+
+  char in_fseq_path[ 128 ];
+  if( shard_cnt==1UL ) fd_cstr_printf( in_fseq_path, 128UL, NULL, "fseq" );
+  else                 fd_cstr_printf( in_fseq_path, 128UL, NULL, "shard.%s.fseq", dedup_name );
+
+  FD_LOG_INFO(( "joining %s.%s.cnc", cfg_path, dedup_path ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( dedup_pod, "cnc" ) );
   if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
   if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
   /* FIXME: CNC DIAG REGION? */
@@ -51,33 +78,33 @@ fd_frank_dedup_task( int     argc,
     in_mcache[ in_idx ] = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
     if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
 
-    FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
-    in_fseq[ in_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
+    FD_LOG_INFO(( "joining %s.verify.%s.%s", cfg_path, verify_name, in_fseq_path ));
+    in_fseq[ in_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, in_fseq_path ) );
     if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
 
     in_idx++;
   }
 
-  FD_LOG_INFO(( "joining %s.dedup.tcache", cfg_path ));
-  fd_tcache_t * tcache = fd_tcache_join( fd_wksp_pod_map( cfg_pod, "dedup.tcache" ) );
+  FD_LOG_INFO(( "joining %s.%s.tcache", cfg_path, dedup_path ));
+  fd_tcache_t * tcache = fd_tcache_join( fd_wksp_pod_map( dedup_pod, "tcache" ) );
   if( FD_UNLIKELY( !tcache ) ) FD_LOG_ERR(( "fd_tcache_join failed" ));
 
-  FD_LOG_INFO(( "joining %s.dedup.mcache", cfg_path ));
-  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_pod_map( cfg_pod, "dedup.mcache" ) );
+  FD_LOG_INFO(( "joining %s.%s.mcache", cfg_path, dedup_path ));
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_pod_map( dedup_pod, "mcache" ) );
   if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
 
-  FD_LOG_INFO(( "joining %s.dedup.fseq", cfg_path ));
-  ulong * out_fseq = fd_fseq_join( fd_wksp_pod_map( cfg_pod, "dedup.fseq" ) );
+  FD_LOG_INFO(( "joining %s.%s.fseq", cfg_path, dedup_path ));
+  ulong * out_fseq = fd_fseq_join( fd_wksp_pod_map( dedup_pod, "fseq" ) );
   if( FD_UNLIKELY( !out_fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
 
   /* Setup local objects used by this tile */
 
-  ulong cr_max = fd_pod_query_ulong( cfg_pod, "dedup.cr_max", 0UL ); /*  0  <> pick reasonable default */
-  long  lazy   = fd_pod_query_long ( cfg_pod, "dedup.lazy",   0L  ); /* <=0 <> pick reasonable default */
-  FD_LOG_INFO(( "configuring flow control (%s.dedup.cr_max %lu %s.dedup.lazy %li)", cfg_path, cr_max, cfg_path, lazy ));
+  ulong cr_max = fd_pod_query_ulong( dedup_pod, "cr_max", 0UL ); /*  0  <> pick reasonable default */
+  long  lazy   = fd_pod_query_long ( dedup_pod, "lazy",   0L  ); /* <=0 <> pick reasonable default */
+  FD_LOG_INFO(( "configuring flow control (%s.%s.cr_max %lu %s.%s.lazy %li)", cfg_path, dedup_path, cr_max, cfg_path, dedup_path, lazy ));
 
-  uint seed = fd_pod_query_uint( cfg_pod, "dedup.seed", (uint)fd_tile_id() ); /* use app tile_id as default */
-  FD_LOG_INFO(( "creating rng (%s.dedup.seed %u)", cfg_path, seed ));
+  uint seed = fd_pod_query_uint( dedup_pod, "seed", (uint)fd_tile_id() ); /* use app tile_id as default */
+  FD_LOG_INFO(( "creating rng (%s.%s.seed %u)", cfg_path, dedup_path, seed ));
   fd_rng_t _rng[ 1 ];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
   if( FD_UNLIKELY( !rng ) ) FD_LOG_ERR(( "fd_rng_join failed" ));
@@ -90,13 +117,14 @@ fd_frank_dedup_task( int     argc,
 
   /* Start deduping */
 
-  FD_LOG_INFO(( "dedup run" ));
-  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, tcache, mcache, 1UL, &out_fseq, cr_max, lazy, rng, scratch );
+  FD_LOG_INFO(( "%s run", dedup_name ));
+  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, tcache, shard_idx, shard_cnt, mcache, 1UL, &out_fseq,
+                           cr_max, lazy, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
 
   /* Clean up */
 
-  FD_LOG_INFO(( "dedup fini" ));
+  FD_LOG_INFO(( "%s fini", dedup_name ));
   fd_rng_delete    ( fd_rng_leave   ( rng      ) );
   fd_wksp_pod_unmap( fd_fseq_leave  ( out_fseq ) );
   fd_wksp_pod_unmap( fd_mcache_leave( mcache   ) );
@@ -63,7 +63,19 @@ main( int     argc,
   ulong verify_cnt = fd_pod_cnt_subpod( verify_pods );
   FD_LOG_NOTICE(( "%lu verify found", verify_cnt ));
 
-  ulong tile_cnt = 3UL + verify_cnt;
+  /* If the dedup is sharded, dedup is run by a mux tile that merges
+     the outputs of the dedup shard tiles */
+
+  ulong shard_cnt = fd_pod_query_ulong( cfg_pod, "dedup.shard_cnt", 1UL );
+  if( FD_UNLIKELY( (!shard_cnt) | (shard_cnt>FD_DEDUP_TILE_SHARD_MAX) ) ) FD_LOG_ERR(( "bad dedup.shard_cnt" ));
+  uchar const * shard_pods = fd_pod_query_subpod( cfg_pod, "dedup.shard" );
+  if( shard_cnt>1UL ) {
+    if( FD_UNLIKELY( fd_pod_cnt_subpod( shard_pods )!=shard_cnt ) ) FD_LOG_ERR(( "dedup.shard does not match dedup.shard_cnt" ));
+    FD_LOG_NOTICE(( "%lu dedup shards found", shard_cnt ));
+  }
+  ulong dedup_shard_tile_cnt = fd_ulong_if( shard_cnt>1UL, shard_cnt, 0UL );
+
+  ulong tile_cnt = 3UL + dedup_shard_tile_cnt + verify_cnt;
   if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "at least %lu tiles required for this config", tile_cnt ));
   if( FD_UNLIKELY( fd_tile_cnt()>tile_cnt ) ) FD_LOG_WARNING(( "only %lu tiles required for this config", tile_cnt ));
 
@@ -99,6 +111,22 @@ main( int     argc,
     if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
     tile_idx++;
 
+    if( shard_cnt>1UL ) {
+      for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+        fd_pod_info_t info = fd_pod_iter_info( iter );
+        if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+        char const  * shard_name =                info.key;
+        uchar const * shard_pod  = (uchar const *)info.val;
+
+        FD_LOG_NOTICE(( "joining %s.dedup.shard.%s.cnc", cfg_path, shard_name ));
+        tile_name[ tile_idx ] = shard_name;
+        tile_cnc [ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( shard_pod, "cnc" ) );
+        if( FD_UNLIKELY( !tile_cnc[tile_idx] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+        if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
+        tile_idx++;
+      }
+    }
+
     for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
       fd_pod_info_t info = fd_pod_iter_info( iter );
       if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
@@ -125,10 +153,10 @@ main( int     argc,
 
     fd_tile_task_t task;
     switch( tile_idx ) {
-    case 0UL: task = main;                 break;
-    case 1UL: task = fd_frank_pack_task;   break;
-    case 2UL: task = fd_frank_dedup_task;  break;
-    default:  task = fd_frank_verify_task; break;
+    case 0UL: task = main;                                                       break;
+    case 1UL: task = fd_frank_pack_task;                                         break;
+    case 2UL: task = (shard_cnt>1UL) ? fd_frank_mux_task : fd_frank_dedup_task; break;
+    default:  task = (tile_idx<3UL+dedup_shard_tile_cnt) ? fd_frank_dedup_task : fd_frank_verify_task; break;
     }
 
     char * task_argv[3];
@@ -222,13 +222,61 @@ printf_pct( ulong  num_now,
   /**/                 printf( ">999.999" );
 }
 
+/* printf_lat prints to stdout the value at quantile q of the latencies
+   binned in the histogram hist_now - hist_then (i.e. latencies binned
+   between then and now) as an age in ns.  The value will be estimated
+   as the middle of the histogram bucket that holds the quantile
+   (histogram buckets have a relative width of ~1/FD_LHIST_SUB_CNT).
+   Will be exactly 10 char wide.  hist_{now,then} are assumed to be
+   histograms of tick counts and ns_per_tic is the conversion factor to
+   ns. */
+
+static void
+printf_lat( ulong const * hist_now,
+            ulong const * hist_then,
+            double        q,
+            double        ns_per_tic ) {
+  ulong hist[ FD_LHIST_BUCKET_CNT ];
+  for( ulong idx=0UL; idx<FD_LHIST_BUCKET_CNT; idx++ ) hist[ idx ] = hist_now[ idx ] - hist_then[ idx ];
+  ulong idx = fd_lhist_quantile( hist, q );
+  if( FD_UNLIKELY( idx>=FD_LHIST_BUCKET_CNT ) ) { printf( "         -" ); return; } /* no samples */
+  ulong lo = fd_lhist_bucket_lo( idx );
+  ulong hi = fd_lhist_bucket_hi( idx );
+  double tic = (idx<FD_LHIST_BUCKET_CNT-1UL) ? 0.5*((double)lo + (double)hi) : (double)lo;
+  printf_age( (long)(0.5 + ns_per_tic*tic) );
+}
+
+/* printf_ratio prints to stdout:
+
+     (num_now-num_then) / (den_now-den_then)
+
+   Will be exactly 8 char wide, right justified with aligned decimal
+   point.  If either counter did not change between then and now (e.g.
+   the counter is not available), prints "-".  num and den are assumed
+   to be monotonically increasing counters. */
+
+static void
+printf_ratio( ulong num_now,
+              ulong num_then,
+              ulong den_now,
+              ulong den_then ) {
+  if( FD_UNLIKELY( (num_now<num_then) | (den_now<den_then) ) ) {
+    printf( TEXT_RED " invalid" TEXT_NORMAL );
+    return;
+  }
+  if( FD_UNLIKELY( (num_now==num_then) | (den_now==den_then) ) ) { printf( "       -" ); return; }
+  double ratio = (double)(num_now - num_then) / (double)(den_now - den_then);
+  if( ratio<=9999.999 ) { printf( " %7.3f", ratio ); return; }
+  /**/                    printf( ">9999.99" );
+}
+
 /**********************************************************************/
 
 /* snap reads all the IPC diagnostics in a frank instance and stores
    them into the easy to process structure snap */
 
 struct snap {
-  ulong pmap; /* Bit {0,1,2} set <> {cnc,mcache,fseq} values are valid */
+  ulong pmap; /* Bit {0,1,2,3,4,5} set <> {cnc,mcache,fseq,lhist,ticks,perf} values are valid */
 
   long  cnc_heartbeat;
   ulong cnc_signal;
@@ -239,6 +287,11 @@ struct snap {
   ulong cnc_diag_ha_filt_sz;
   ulong cnc_diag_sv_filt_cnt;
   ulong cnc_diag_sv_filt_sz;
+  ulong cnc_diag_spin_ticks;
+  ulong cnc_diag_work_ticks;
+  ulong cnc_diag_backp_ticks;
+  ulong cnc_diag_hkeep_ticks;
+  ulong cnc_diag_perf[ FD_PERF_EVENT_CNT ];
 
   ulong mcache_seq;
 
@@ -251,6 +304,9 @@ struct snap {
   ulong fseq_diag_ovrnp_cnt;
   ulong fseq_diag_ovrnr_cnt;
   ulong fseq_diag_slow_cnt;
+
+  ulong lhist_orig[ FD_LHIST_BUCKET_CNT ];
+  ulong lhist_pub [ FD_LHIST_BUCKET_CNT ];
 };
 
 typedef struct snap snap_t;
@@ -282,6 +338,37 @@ snap( ulong             tile_cnt,     /* Number of tiles to snapshot */
       FD_COMPILER_MFENCE();
 
       pmap |= 1UL;
+
+      if( FD_LIKELY( fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_TICKS_APP_SZ ) ) {
+        FD_COMPILER_MFENCE();
+        snap->cnc_diag_spin_ticks  = cnc_diag[ FD_FRANK_CNC_DIAG_SPIN_TICKS  ];
+        snap->cnc_diag_work_ticks  = cnc_diag[ FD_FRANK_CNC_DIAG_WORK_TICKS  ];
+        snap->cnc_diag_backp_ticks = cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_TICKS ];
+        snap->cnc_diag_hkeep_ticks = cnc_diag[ FD_FRANK_CNC_DIAG_HKEEP_TICKS ];
+        FD_COMPILER_MFENCE();
+
+        pmap |= 16UL;
+      }
+
+      if( FD_LIKELY( fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ) ) {
+        FD_COMPILER_MFENCE();
+        for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ )
+          snap->cnc_diag_perf[ event ] = cnc_diag[ FD_FRANK_CNC_DIAG_PERF_CYCLES+event ];
+        FD_COMPILER_MFENCE();
+
+        pmap |= 32UL;
+      }
+
+      if( FD_LIKELY( fd_cnc_app_sz( cnc )>=FD_LHIST_CNC_APP_SZ ) ) {
+        ulong const * lhist_orig = (ulong const *)((ulong)cnc_diag + FD_LHIST_CNC_APP_ORIG_OFF);
+        ulong const * lhist_pub  = (ulong const *)((ulong)cnc_diag + FD_LHIST_CNC_APP_PUB_OFF );
+        FD_COMPILER_MFENCE();
+        for( ulong idx=0UL; idx<FD_LHIST_BUCKET_CNT; idx++ ) snap->lhist_orig[ idx ] = lhist_orig[ idx ];
+        for( ulong idx=0UL; idx<FD_LHIST_BUCKET_CNT; idx++ ) snap->lhist_pub [ idx ] = lhist_pub [ idx ];
+        FD_COMPILER_MFENCE();
+
+        pmap |= 8UL;
+      }
     }
 
     fd_frag_meta_t const * mcache = tile_mcache[ tile_idx ];
@@ -345,7 +432,20 @@ main( int     argc,
   uchar const * verify_pods = fd_pod_query_subpod( cfg_pod, "verify" );
   ulong verify_cnt = fd_pod_cnt_subpod( verify_pods );
   FD_LOG_INFO(( "%lu verify found", verify_cnt ));
-  ulong tile_cnt = 3UL + verify_cnt;
+
+  /* If the dedup is sharded, the dedup tile is the mux that merges the
+     dedup shards and the verify fseqs shown are the ones of the first
+     shard. */
+
+  ulong         shard_cnt  = fd_pod_query_ulong( cfg_pod, "dedup.shard_cnt", 1UL );
+  uchar const * shard_pods = fd_pod_query_subpod( cfg_pod, "dedup.shard" );
+  ulong         dedup_shard_tile_cnt = fd_ulong_if( shard_cnt>1UL, fd_pod_cnt_subpod( shard_pods ), 0UL );
+  FD_LOG_INFO(( "%lu dedup shards found", dedup_shard_tile_cnt ));
+
+  char verify_fseq_path[ 128 ];
+  fd_cstr_printf( verify_fseq_path, 128UL, NULL, "fseq" );
+
+  ulong tile_cnt = 3UL + dedup_shard_tile_cnt + verify_cnt;
 
   /* Join all IPC objects for this frank instance */
 
@@ -389,6 +489,30 @@ main( int     argc,
     if( FD_UNLIKELY( !tile_fseq[ tile_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
     tile_idx++;
 
+    if( dedup_shard_tile_cnt ) {
+      for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+        fd_pod_info_t info = fd_pod_iter_info( iter );
+        if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+        char const  * shard_name =                info.key;
+        uchar const * shard_pod  = (uchar const *)info.val;
+
+        if( tile_idx==3UL ) fd_cstr_printf( verify_fseq_path, 128UL, NULL, "shard.%s.fseq", shard_name );
+
+        FD_LOG_INFO(( "joining %s.dedup.shard.%s.cnc", cfg_path, shard_name ));
+        tile_name[ tile_idx ] = shard_name;
+        tile_cnc [ tile_idx ] = fd_cnc_join( fd_wksp_pod_map( shard_pod, "cnc" ) );
+        if( FD_UNLIKELY( !tile_cnc[tile_idx] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+        if( FD_UNLIKELY( fd_cnc_app_sz( tile_cnc[ tile_idx ] )<64UL ) ) FD_LOG_ERR(( "cnc app sz should be at least 64 bytes" ));
+        FD_LOG_INFO(( "joining %s.dedup.shard.%s.mcache", cfg_path, shard_name ));
+        tile_mcache[ tile_idx ] = fd_mcache_join( fd_wksp_pod_map( shard_pod, "mcache" ) );
+        if( FD_UNLIKELY( !tile_mcache[ tile_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+        FD_LOG_INFO(( "joining %s.dedup.shard.%s.fseq", cfg_path, shard_name ));
+        tile_fseq[ tile_idx ] = fd_fseq_join( fd_wksp_pod_map( shard_pod, "fseq" ) );
+        if( FD_UNLIKELY( !tile_fseq[ tile_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+        tile_idx++;
+      }
+    }
+
     for( fd_pod_iter_t iter = fd_pod_iter_init( verify_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
       fd_pod_info_t info = fd_pod_iter_info( iter );
       if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
@@ -403,8 +527,8 @@ main( int     argc,
       FD_LOG_INFO(( "joining %s.verify.%s.mcache", cfg_path, verify_name ));
       tile_mcache[ tile_idx ] = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
       if( FD_UNLIKELY( !tile_mcache[ tile_idx ] ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
-      FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
-      tile_fseq[ tile_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
+      FD_LOG_INFO(( "joining %s.verify.%s.%s", cfg_path, verify_name, verify_fseq_path ));
+      tile_fseq[ tile_idx ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, verify_fseq_path ) );
       if( FD_UNLIKELY( !tile_fseq[ tile_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
       tile_idx++;
     }
@@ -485,8 +609,12 @@ main( int     argc,
     for( ulong tile_idx=2UL; tile_idx<tile_cnt; tile_idx++ ) {
       snap_t * prv = &snap_prv[ tile_idx ];
       snap_t * cur = &snap_cur[ tile_idx ];
-      if( tile_idx==2UL ) printf( " %5s->%-5s", tile_name[ 2        ], tile_name[ 1 ] );
-      else                printf( " %5s->%-5s", tile_name[ tile_idx ], tile_name[ 2 ] );
+      ulong dst_idx;
+      if(      tile_idx==2UL                                         ) dst_idx = 1UL; /* dedup -> pack */
+      else if( tile_idx<3UL+dedup_shard_tile_cnt                     ) dst_idx = 2UL; /* shard -> dedup (mux) */
+      else if( dedup_shard_tile_cnt                                  ) dst_idx = 3UL; /* verify -> first shard */
+      else                                                             dst_idx = 2UL; /* verify -> dedup */
+      printf( " %5s->%-5s", tile_name[ tile_idx ], tile_name[ dst_idx ] );
       long dt = now-then;
       ulong cur_raw_cnt = cur->cnc_diag_ha_filt_cnt + cur->fseq_diag_tot_cnt;
       ulong cur_raw_sz  = cur->cnc_diag_ha_filt_sz  + cur->fseq_diag_tot_sz;
@@ -513,6 +641,85 @@ main( int     argc,
       printf( "\n" );
     }
     printf( "\n" );
+    printf( "         link |   orig p50 |   orig p99 | orig p99.9 |    pub p50 |    pub p99 |  pub p99.9\n" );
+    printf( "--------------+------------+------------+------------+------------+------------+------------\n" );
+    for( ulong tile_idx=1UL; tile_idx<3UL; tile_idx++ ) { /* pack and dedup consume, dedup aggregates over all verify */
+      snap_t * prv = &snap_prv[ tile_idx ];
+      snap_t * cur = &snap_cur[ tile_idx ];
+      if( tile_idx==1UL ) printf( " %5s->%-5s", tile_name[ 2 ], tile_name[ 1 ] );
+      else                printf( " %5s->%-5s", "*",            tile_name[ 2 ] );
+      if( FD_LIKELY( (cur->pmap & prv->pmap) & 8UL ) ) {
+        printf( " | " ); printf_lat( cur->lhist_orig, prv->lhist_orig, 0.5,   ns_per_tic );
+        printf( " | " ); printf_lat( cur->lhist_orig, prv->lhist_orig, 0.99,  ns_per_tic );
+        printf( " | " ); printf_lat( cur->lhist_orig, prv->lhist_orig, 0.999, ns_per_tic );
+        printf( " | " ); printf_lat( cur->lhist_pub,  prv->lhist_pub,  0.5,   ns_per_tic );
+        printf( " | " ); printf_lat( cur->lhist_pub,  prv->lhist_pub,  0.99,  ns_per_tic );
+        printf( " | " ); printf_lat( cur->lhist_pub,  prv->lhist_pub,  0.999, ns_per_tic );
+      } else {
+        printf( " |          - |          - |          - |          - |          - |          -" );
+      }
+      printf( "\n" );
+    }
+    printf( "\n" );
+    printf( "  tile |   spin%% |   work%% |  backp%% |  hkeep%% |           backp cnt\n" );
+    printf( "-------+----------+----------+----------+----------+---------------------\n" );
+    for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+      snap_t * prv = &snap_prv[ tile_idx ];
+      snap_t * cur = &snap_cur[ tile_idx ];
+      printf( " %5s", tile_name[ tile_idx ] );
+      if( FD_LIKELY( (cur->pmap & prv->pmap) & 16UL ) ) {
+        ulong cur_ticks = cur->cnc_diag_spin_ticks + cur->cnc_diag_work_ticks + cur->cnc_diag_backp_ticks + cur->cnc_diag_hkeep_ticks;
+        ulong prv_ticks = prv->cnc_diag_spin_ticks + prv->cnc_diag_work_ticks + prv->cnc_diag_backp_ticks + prv->cnc_diag_hkeep_ticks;
+        printf( " | " ); printf_pct    ( cur->cnc_diag_spin_ticks,  prv->cnc_diag_spin_ticks,  0., cur_ticks, prv_ticks, DBL_MIN );
+        printf( " | " ); printf_pct    ( cur->cnc_diag_work_ticks,  prv->cnc_diag_work_ticks,  0., cur_ticks, prv_ticks, DBL_MIN );
+        printf( " | " ); printf_pct    ( cur->cnc_diag_backp_ticks, prv->cnc_diag_backp_ticks, 0., cur_ticks, prv_ticks, DBL_MIN );
+        printf( " | " ); printf_pct    ( cur->cnc_diag_hkeep_ticks, prv->cnc_diag_hkeep_ticks, 0., cur_ticks, prv_ticks, DBL_MIN );
+        printf( " | " ); printf_err_cnt( cur->cnc_diag_backp_cnt,   prv->cnc_diag_backp_cnt );
+      } else {
+        printf( " |        - |        - |        - |        - |                   -" );
+      }
+      printf( "\n" );
+    }
+    printf( "\n" );
+
+    /* The frags a tile handled over the interval are the frags it
+       published plus the frags it filtered for tiles with an mcache and
+       the frags it consumed for pack.  Per frag counts are shown as "-"
+       if the tile isn't sampling the corresponding counter (e.g. the
+       host doesn't support it) or the tile didn't handle any frags. */
+
+    printf( "  tile | cycles/s |      IPC | llc/frag |  br/frag | dtlb/frg | ins/frag\n" );
+    printf( "-------+----------+----------+----------+----------+----------+----------\n" );
+    for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+      snap_t * prv = &snap_prv[ tile_idx ];
+      snap_t * cur = &snap_cur[ tile_idx ];
+      printf( " %5s", tile_name[ tile_idx ] );
+      if( FD_LIKELY( (cur->pmap & prv->pmap) & 32UL ) ) {
+        ulong cur_frag = 0UL;
+        ulong prv_frag = 0UL;
+        if( tile_idx==1UL ) { /* pack consumes from dedup */
+          snap_t * cur_in = &snap_cur[ 2 ];
+          snap_t * prv_in = &snap_prv[ 2 ];
+          if( FD_LIKELY( (cur_in->pmap & prv_in->pmap) & 4UL ) ) { cur_frag = cur_in->fseq_seq; prv_frag = prv_in->fseq_seq; }
+        } else if( FD_LIKELY( (cur->pmap & prv->pmap) & 2UL ) ) {
+          cur_frag = cur->mcache_seq + cur->cnc_diag_ha_filt_cnt + cur->cnc_diag_sv_filt_cnt;
+          prv_frag = prv->mcache_seq + prv->cnc_diag_ha_filt_cnt + prv->cnc_diag_sv_filt_cnt;
+        }
+        ulong const * cur_perf = cur->cnc_diag_perf;
+        ulong const * prv_perf = prv->cnc_diag_perf;
+        printf( " | " ); printf_rate ( 1e9, 0., cur_perf[ FD_PERF_EVENT_CYCLES ], prv_perf[ FD_PERF_EVENT_CYCLES ], now-then );
+        printf( " | " ); printf_ratio( cur_perf[ FD_PERF_EVENT_INSNS     ], prv_perf[ FD_PERF_EVENT_INSNS     ],
+                                       cur_perf[ FD_PERF_EVENT_CYCLES    ], prv_perf[ FD_PERF_EVENT_CYCLES    ] );
+        printf( " | " ); printf_ratio( cur_perf[ FD_PERF_EVENT_LLC_MISS  ], prv_perf[ FD_PERF_EVENT_LLC_MISS  ], cur_frag, prv_frag );
+        printf( " | " ); printf_ratio( cur_perf[ FD_PERF_EVENT_BR_MISS   ], prv_perf[ FD_PERF_EVENT_BR_MISS   ], cur_frag, prv_frag );
+        printf( " | " ); printf_ratio( cur_perf[ FD_PERF_EVENT_DTLB_MISS ], prv_perf[ FD_PERF_EVENT_DTLB_MISS ], cur_frag, prv_frag );
+        printf( " | " ); printf_ratio( cur_perf[ FD_PERF_EVENT_INSNS     ], prv_perf[ FD_PERF_EVENT_INSNS     ], cur_frag, prv_frag );
+      } else {
+        printf( " |        - |        - |        - |        - |        - |        -" );
+      }
+      printf( "\n" );
+    }
+    printf( "\n" );
 
     /* Stop once we've been monitoring for duration ns */
 
@@ -27,7 +27,31 @@ fd_frank_pack_task( int     argc,
   fd_cnc_t * cnc = fd_cnc_join( fd_wksp_pod_map( cfg_pod, "pack.cnc" ) );
   if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
   if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
-  /* FIXME: CNC DIAG REGION? */
+  /* Hook up to this pack's duty cycle diagnostics (will be stored in
+     the pack's cnc) */
+  ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+  if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<FD_CNC_DIAG_TICKS_APP_SZ ) ) FD_LOG_ERR(( "cnc app region too small for duty cycle diagnostics" ));
+  FD_COMPILER_MFENCE();
+  cnc_diag[ FD_FRANK_CNC_DIAG_SPIN_TICKS  ] = 0UL;
+  cnc_diag[ FD_FRANK_CNC_DIAG_WORK_TICKS  ] = 0UL;
+  cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_TICKS ] = 0UL; /* pack is never backpressured */
+  cnc_diag[ FD_FRANK_CNC_DIAG_HKEEP_TICKS ] = 0UL;
+  if( FD_LIKELY( fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ) )
+    for( ulong idx=0UL; idx<FD_PERF_DIAG_CNT; idx++ ) cnc_diag[ FD_FRANK_CNC_DIAG_PERF_CYCLES+idx ] = 0UL;
+  FD_COMPILER_MFENCE();
+  ulong accum_spin_ticks  = 0UL;
+  ulong accum_work_ticks  = 0UL;
+  ulong accum_hkeep_ticks = 0UL;
+
+  /* Hook up to this pack's latency diagnostics (will be stored in the
+     pack's cnc) */
+  ulong * cnc_lhist_orig = fd_lhist_cnc_orig( cnc );
+  ulong * cnc_lhist_pub  = fd_lhist_cnc_pub ( cnc );
+  if( FD_UNLIKELY( !cnc_lhist_orig ) ) FD_LOG_ERR(( "cnc app region too small for latency diagnostics" ));
+  FD_COMPILER_MFENCE();
+  fd_memset( cnc_lhist_orig, 0, FD_LHIST_FOOTPRINT );
+  fd_memset( cnc_lhist_pub,  0, FD_LHIST_FOOTPRINT );
+  FD_COMPILER_MFENCE();
 
   FD_LOG_INFO(( "joining %s.dedup.mcache", cfg_path ));
   fd_frag_meta_t const * mcache = fd_mcache_join( fd_wksp_pod_map( cfg_pod, "dedup.mcache" ) );
@@ -78,6 +102,12 @@ fd_frank_pack_task( int     argc,
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
   if( FD_UNLIKELY( !rng ) ) FD_LOG_ERR(( "fd_rng_join failed" ));
 
+  /* Sample this pack's hardware performance counters (will be stored in
+     the pack's cnc) if available */
+  fd_perf_t   _perf[1];
+  fd_perf_t * perf = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ? fd_perf_open( _perf ) : NULL;
+  FD_LOG_INFO(( "pack %s performance counters", perf ? "sampling" : "not sampling" ));
+
   /* Start packing */
 
   FD_LOG_INFO(( "pack run" ));
@@ -101,11 +131,18 @@ fd_frank_pack_task( int     argc,
       fseq_diag[ FD_FSEQ_DIAG_PUB_SZ    ] += accum_pub_sz;
       fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] += accum_ovrnp_cnt;
       fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] += accum_ovrnr_cnt;
+      cnc_diag [ FD_FRANK_CNC_DIAG_SPIN_TICKS  ] += accum_spin_ticks;
+      cnc_diag [ FD_FRANK_CNC_DIAG_WORK_TICKS  ] += accum_work_ticks;
+      cnc_diag [ FD_FRANK_CNC_DIAG_HKEEP_TICKS ] += accum_hkeep_ticks;
+      if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_FRANK_CNC_DIAG_PERF_CYCLES );
       FD_COMPILER_MFENCE();
-      accum_pub_cnt   = 0UL;
-      accum_pub_sz    = 0UL;
-      accum_ovrnp_cnt = 0UL;
-      accum_ovrnr_cnt = 0UL;
+      accum_pub_cnt     = 0UL;
+      accum_pub_sz      = 0UL;
+      accum_ovrnp_cnt   = 0UL;
+      accum_ovrnr_cnt   = 0UL;
+      accum_spin_ticks  = 0UL;
+      accum_work_ticks  = 0UL;
+      accum_hkeep_ticks = 0UL;
 
       /* Receive command-and-control signals */
       ulong s = fd_cnc_signal_query( cnc );
@@ -114,7 +151,8 @@ fd_frank_pack_task( int     argc,
         break;
       }
 
-      /* Reload housekeeping timer */
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, accum_hkeep_ticks );
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
 
@@ -124,7 +162,7 @@ fd_frank_pack_task( int     argc,
     if( FD_UNLIKELY( diff ) ) { /* caught up or overrun, optimize for expected sequence number ready */
       if( FD_LIKELY( diff<0L ) ) { /* caught up */
         FD_SPIN_PAUSE();
-        now = fd_tickcount();
+        FD_CNC_DIAG_TICK( now, accum_spin_ticks );
         continue;
       }
       /* overrun by dedup tile ... recover */
@@ -133,13 +171,15 @@ fd_frank_pack_task( int     argc,
       /* can keep processing from the new seq */
     }
 
-    now = fd_tickcount();
+    FD_CNC_DIAG_TICK( now, accum_work_ticks );
 
     /* At this point, we have started receiving frag seq with details in
        mline at time now.  Speculatively processs it here. */
 
     /* Placeholder for speculative pack operations */
-    ulong sz = (ulong)mline->sz;
+    ulong sz     = (ulong)mline->sz;
+    ulong tsorig = (ulong)mline->tsorig;
+    ulong tspub  = (ulong)mline->tspub;
 
     /* Check that we weren't overrun while processing */
     seq_found = fd_frag_meta_seq_query( mline );
@@ -152,6 +192,8 @@ fd_frank_pack_task( int     argc,
     /* Placeholder for non-speculative pack operations */
     accum_pub_cnt++;
     accum_pub_sz += sz;
+    fd_lhist_sample( cnc_lhist_orig, fd_lhist_ts_lat( tsorig, now ) );
+    fd_lhist_sample( cnc_lhist_pub,  fd_lhist_ts_lat( tspub,  now ) );
 
     /* Wind up for the next iteration */
     seq   = fd_seq_inc( seq, 1UL );
@@ -162,6 +204,7 @@ fd_frank_pack_task( int     argc,
   
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
   FD_LOG_INFO(( "pack fini" ));
+  if( FD_LIKELY( perf ) ) fd_perf_close( perf );
   fd_rng_delete    ( fd_rng_leave   ( rng    ) );
   fd_wksp_pod_unmap( fd_fseq_leave  ( fseq   ) );
   fd_wksp_pod_unmap( fd_mcache_leave( mcache ) );
@@ -2,6 +2,11 @@
 
 #if FD_HAS_FRANK
 
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_FRANK_CNC_DIAG_HA_FILT_CNT ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_FRANK_CNC_DIAG_HA_FILT_SZ  ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_FRANK_CNC_DIAG_SV_FILT_CNT ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_FRANK_CNC_DIAG_SV_FILT_SZ  ), layout );
+
 int
 fd_frank_verify_task( int     argc,
                       char ** argv ) {
@@ -36,6 +41,7 @@ fd_frank_verify_task( int     argc,
   if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) FD_LOG_ERR(( "cnc not in boot state" ));
   ulong * cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
   if( FD_UNLIKELY( !cnc_diag ) ) FD_LOG_ERR(( "fd_cnc_app_laddr failed" ));
+  if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<FD_CNC_DIAG_TICKS_APP_SZ ) ) FD_LOG_ERR(( "cnc app region too small for duty cycle diagnostics" ));
   int in_backp = 1;
 
   FD_COMPILER_MFENCE();
@@ -45,7 +51,17 @@ fd_frank_verify_task( int     argc,
   FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_HA_FILT_SZ  ] ) = 0UL;
   FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_CNT ] ) = 0UL;
   FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_SZ  ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_SPIN_TICKS  ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_WORK_TICKS  ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_TICKS ] ) = 0UL;
+  FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_HKEEP_TICKS ] ) = 0UL;
+  if( FD_LIKELY( fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ) )
+    for( ulong idx=0UL; idx<FD_PERF_DIAG_CNT; idx++ ) FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_PERF_CYCLES+idx ] ) = 0UL;
   FD_COMPILER_MFENCE();
+  ulong accum_spin_ticks  = 0UL;
+  ulong accum_work_ticks  = 0UL;
+  ulong accum_backp_ticks = 0UL;
+  ulong accum_hkeep_ticks = 0UL;
 
   FD_LOG_INFO(( "joining %s.verify.%s.mcache", cfg_path, verify_name ));
   fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_pod_map( verify_pod, "mcache" ) );
@@ -63,12 +79,37 @@ fd_frank_verify_task( int     argc,
   ulong   wmark  = fd_dcache_compact_wmark ( wksp, dcache, 1542UL ); /* FIXME: MTU? SAFETY CHECK THE FOOTPRINT? */
   ulong   chunk  = chunk0;
 
-  FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
-  ulong * fseq = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
-  if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
-  ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
-  if( FD_UNLIKELY( !fseq_diag ) ) FD_LOG_ERR(( "fd_fseq_app_laddr failed" ));
-  FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL; /* Managed by the fctl */
+  /* If dedup is sharded, every dedup shard is a reliable consumer of
+     this verify and each has its own fseq at verify.[name].shard.[shard
+     name].fseq.  Otherwise, the dedup's fseq is verify.[name].fseq. */
+
+  ulong shard_cnt = fd_pod_query_ulong( cfg_pod, "dedup.shard_cnt", 1UL );
+  FD_LOG_INFO(( "%s.dedup.shard_cnt %lu", cfg_path, shard_cnt ));
+  if( FD_UNLIKELY( (!shard_cnt) | (shard_cnt>FD_DEDUP_TILE_SHARD_MAX) ) ) FD_LOG_ERR(( "bad dedup.shard_cnt" ));
+
+  ulong ** fseq = (ulong **)fd_alloca( alignof(ulong *), sizeof(ulong *)*shard_cnt );
+  if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_alloca failed" ));
+
+  ulong fseq_cnt = 0UL;
+  if( shard_cnt==1UL ) {
+    FD_LOG_INFO(( "joining %s.verify.%s.fseq", cfg_path, verify_name ));
+    fseq[ fseq_cnt ] = fd_fseq_join( fd_wksp_pod_map( verify_pod, "fseq" ) );
+    if( FD_UNLIKELY( !fseq[ fseq_cnt ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+    fseq_cnt++;
+  } else {
+    uchar const * shard_pods = fd_pod_query_subpod( verify_pod, "shard" );
+    if( FD_UNLIKELY( !shard_pods ) ) FD_LOG_ERR(( "%s.verify.%s.shard path not found", cfg_path, verify_name ));
+    for( fd_pod_iter_t iter = fd_pod_iter_init( shard_pods ); !fd_pod_iter_done( iter ); iter = fd_pod_iter_next( iter ) ) {
+      fd_pod_info_t info = fd_pod_iter_info( iter );
+      if( FD_UNLIKELY( info.val_type!=FD_POD_VAL_TYPE_SUBPOD ) ) continue;
+      if( FD_UNLIKELY( fseq_cnt>=shard_cnt ) ) FD_LOG_ERR(( "too many %s.verify.%s.shard found", cfg_path, verify_name ));
+      FD_LOG_INFO(( "joining %s.verify.%s.shard.%s.fseq", cfg_path, verify_name, info.key ));
+      fseq[ fseq_cnt ] = fd_fseq_join( fd_wksp_pod_map( (uchar const *)info.val, "fseq" ) );
+      if( FD_UNLIKELY( !fseq[ fseq_cnt ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+      fseq_cnt++;
+    }
+  }
+  if( FD_UNLIKELY( fseq_cnt!=shard_cnt ) ) FD_LOG_ERR(( "expected %lu dedup fseqs, found %lu", shard_cnt, fseq_cnt ));
 
   /* Setup local objects used by this tile */
 
@@ -82,11 +123,14 @@ fd_frank_verify_task( int     argc,
   FD_LOG_INFO(( "%s.verify.%s.cr_refill %lu", cfg_path, verify_name, cr_refill ));
   FD_LOG_INFO(( "%s.verify.%s.lazy      %li", cfg_path, verify_name, lazy      ));
 
-  fd_fctl_t * fctl = fd_fctl_cfg_done( fd_fctl_cfg_rx_add( fd_fctl_join( fd_fctl_new( fd_alloca( FD_FCTL_ALIGN,
-                                                                                                 fd_fctl_footprint( 1UL ) ),
-                                                                                      1UL ) ),
-                                                           depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ),
-                                       1UL /*cr_burst*/, cr_max, cr_resume, cr_refill );
+  fd_fctl_t * fctl = fd_fctl_join( fd_fctl_new( fd_alloca( FD_FCTL_ALIGN, fd_fctl_footprint( fseq_cnt ) ), fseq_cnt ) );
+  for( ulong fseq_idx=0UL; fseq_idx<fseq_cnt; fseq_idx++ ) {
+    ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq[ fseq_idx ] );
+    if( FD_UNLIKELY( !fseq_diag ) ) FD_LOG_ERR(( "fd_fseq_app_laddr failed" ));
+    FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL; /* Managed by the fctl */
+    fctl = fd_fctl_cfg_rx_add( fctl, depth, fseq[ fseq_idx ], &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] );
+  }
+  fctl = fd_fctl_cfg_done( fctl, 1UL /*cr_burst*/, cr_max, cr_resume, cr_refill );
   if( FD_UNLIKELY( !fctl ) ) FD_LOG_ERR(( "Unable to create flow control" ));
   FD_LOG_INFO(( "using cr_burst %lu, cr_max %lu, cr_resume %lu, cr_refill %lu",
                 fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ) ));
@@ -124,6 +168,12 @@ fd_frank_verify_task( int     argc,
 
   ulong accum_sv_filt_cnt = 0UL; ulong accum_sv_filt_sz = 0UL;
 
+  /* Sample this verify's hardware performance counters (will be stored
+     in the verify's cnc) if available */
+  fd_perf_t   _perf[1];
+  fd_perf_t * perf = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ? fd_perf_open( _perf ) : NULL;
+  FD_LOG_INFO(( "verify.%s %s performance counters", verify_name, perf ? "sampling" : "not sampling" ));
+
   /* Start verifying */
 
   FD_LOG_INFO(( "verify.%s run", verify_name ));
@@ -150,11 +200,20 @@ fd_frank_verify_task( int     argc,
       FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_HA_FILT_SZ  ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_HA_FILT_SZ  ] ) + accum_ha_filt_sz;
       FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_CNT ] ) + accum_sv_filt_cnt;
       FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_SZ  ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_SV_FILT_SZ  ] ) + accum_sv_filt_sz;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_SPIN_TICKS  ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_SPIN_TICKS  ] ) + accum_spin_ticks;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_WORK_TICKS  ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_WORK_TICKS  ] ) + accum_work_ticks;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_TICKS ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_BACKP_TICKS ] ) + accum_backp_ticks;
+      FD_VOLATILE( cnc_diag[ FD_FRANK_CNC_DIAG_HKEEP_TICKS ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_FRANK_CNC_DIAG_HKEEP_TICKS ] ) + accum_hkeep_ticks;
+      if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_FRANK_CNC_DIAG_PERF_CYCLES );
       FD_COMPILER_MFENCE();
       accum_ha_filt_cnt = 0UL;
       accum_ha_filt_sz  = 0UL;
       accum_sv_filt_cnt = 0UL;
       accum_sv_filt_sz  = 0UL;
+      accum_spin_ticks  = 0UL;
+      accum_work_ticks  = 0UL;
+      accum_backp_ticks = 0UL;
+      accum_hkeep_ticks = 0UL;
 
       /* Receive command-and-control signals */
       ulong s = fd_cnc_signal_query( cnc );
@@ -172,7 +231,8 @@ fd_frank_verify_task( int     argc,
         }
       }
 
-      /* Reload housekeeping timer */
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, accum_hkeep_ticks );
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
 
@@ -184,7 +244,7 @@ fd_frank_verify_task( int     argc,
         in_backp = 1;
       }
       FD_SPIN_PAUSE();
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, accum_backp_ticks );
       continue;
     }
 
@@ -195,7 +255,7 @@ fd_frank_verify_task( int     argc,
     (void)tcache_map_cnt;
     (void)chunk;
     (void)wmark;
-    now = fd_tickcount();
+    FD_CNC_DIAG_TICK( now, accum_work_ticks );
 
   }
 
@@ -203,11 +263,12 @@ fd_frank_verify_task( int     argc,
 
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
   FD_LOG_INFO(( "verify.%s fini", verify_name ));
+  if( FD_LIKELY( perf ) ) fd_perf_close( perf );
   fd_sha512_delete ( fd_sha512_leave( sha    ) );
   fd_tcache_delete ( fd_tcache_leave( tcache ) );
   fd_rng_delete    ( fd_rng_leave   ( rng    ) );
   fd_fctl_delete   ( fd_fctl_leave  ( fctl   ) );
-  fd_wksp_pod_unmap( fd_fseq_leave  ( fseq   ) );
+  for( ulong fseq_idx=fseq_cnt; fseq_idx; fseq_idx-- ) fd_wksp_pod_unmap( fd_fseq_leave( fseq[ fseq_idx-1UL ] ) );
   fd_wksp_pod_unmap( fd_dcache_leave( dcache ) );
   fd_wksp_pod_unmap( fd_mcache_leave( mcache ) );
   fd_wksp_pod_unmap( fd_cnc_leave   ( cnc    ) );
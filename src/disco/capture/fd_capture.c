@@ -0,0 +1,765 @@
+/* O_DIRECT requires _GNU_SOURCE */
+#define _GNU_SOURCE
+
+#include "fd_capture.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../../tango/uring/fd_uring.h"
+
+#define SCRATCH_ALLOC( a, s ) (__extension__({                    \
+    ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
+    scratch_top = _scratch_alloc + (s);                           \
+    (void *)_scratch_alloc;                                       \
+  }))
+
+/* A fd_capture_tile_buf has the state of a capture buffer.  A buffer is
+   busy while a write of it is in flight (the kernel reads the buffer
+   until the write completes). */
+
+struct __attribute__((aligned(64))) fd_capture_tile_buf {
+  ulong busy;      /* 1 if a write of this buffer is in flight, 0 otherwise */
+  ulong file_slot; /* file slot of the in flight write */
+  ulong sz;        /* size of the in flight write */
+};
+
+typedef struct fd_capture_tile_buf fd_capture_tile_buf_t;
+
+FD_STATIC_ASSERT( alignof(fd_capture_tile_buf_t)==64UL, layout );
+FD_STATIC_ASSERT( sizeof (fd_capture_tile_buf_t)==64UL, layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_CAPTURE_CNC_DIAG_DISK_DROP_CNT ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_CAPTURE_CNC_DIAG_DISK_DROP_SZ  ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_CAPTURE_CNC_DIAG_OVRN_DROP_CNT ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_CAPTURE_CNC_DIAG_FILE_CNT      ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_CAPTURE_CNC_DIAG_WRITE_SZ      ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_CAPTURE_CNC_DIAG_WRITE_ERR_CNT ), layout );
+
+/* A fd_capture_tile_file has the state of an open capture file.  There
+   are two file slots such that the current file can be written while
+   the previous file's last writes complete. */
+
+struct fd_capture_tile_file {
+  int   fd;       /* File descriptor, -1 if the slot is free */
+  int   direct;   /* 1 if opened with O_DIRECT */
+  int   closing;  /* 1 if the file will be closed once its in flight writes complete */
+  ulong off;      /* File offset of the next write */
+  ulong sz;       /* Actual size of the file (valid once closing) */
+  ulong inflight; /* Number of writes of this file in flight */
+};
+
+typedef struct fd_capture_tile_file fd_capture_tile_file_t;
+
+/* A fd_capture_tile_io has the state of the capture file writer: the
+   io_uring used to write out capture buffers, the capture buffers and
+   the file slots. */
+
+struct fd_capture_tile_io {
+
+  /* io_uring (the rings are mmap'ed from the kernel on init) */
+
+  fd_uring_t uring;
+
+  /* Capture buffers */
+
+  fd_capture_tile_buf_t * buf;      /* buf[buf_idx] is the state of capture buffer buf_idx, indexed [0,buf_cnt) */
+  uchar *                 buf_mem;  /* Capture buffer buf_idx is at buf_mem + buf_idx*buf_sz */
+  ulong                   buf_sz;
+  ulong                   buf_cnt;
+  ulong                   buf_idx;  /* Current capture buffer */
+  ulong                   buf_used; /* Bytes used in the current capture buffer */
+  long                    buf_t0;   /* Tick when the current capture buffer became current */
+
+  /* Capture files */
+
+  fd_capture_tile_file_t file[2];
+  ulong                  file_slot;  /* File slot of the current capture file */
+  ulong                  block_mask; /* FD_CAPTURE_TILE_BLOCK_SZ-1 if the current file is written with O_DIRECT, 0 otherwise */
+  int                    direct;     /* 1 if capture files should be opened with O_DIRECT */
+
+  /* Diagnostics accumulated by the writer */
+
+  ulong write_sz;
+  ulong write_err_cnt;
+};
+
+typedef struct fd_capture_tile_io fd_capture_tile_io_t;
+
+/* fd_capture_tile_io_init creates an io_uring with room for a write per
+   capture buffer.  Returns 0 on success and non-zero on failure (logs
+   details). */
+
+static int
+fd_capture_tile_io_init( fd_capture_tile_io_t * io ) {
+  struct io_uring_params params[1];
+  memset( params, 0, sizeof(struct io_uring_params) );
+  int ring_fd = fd_uring_sys_setup( (uint)fd_ulong_pow2_up( io->buf_cnt ), params );
+  if( FD_UNLIKELY( ring_fd<0 ) ) {
+    FD_LOG_WARNING(( "io_uring_setup failed (%i-%s)", errno, strerror( errno ) ));
+    return 1;
+  }
+  return !fd_uring_map( &io->uring, ring_fd, params );
+}
+
+/* fd_capture_tile_io_file_close closes the file in file slot slot
+   (truncating away the padding of its trailing block if it was written
+   with O_DIRECT). */
+
+static void
+fd_capture_tile_io_file_close( fd_capture_tile_io_t * io,
+                               ulong                  slot ) {
+  fd_capture_tile_file_t * file = io->file + slot;
+  if( FD_UNLIKELY( file->direct && ftruncate( file->fd, (long)file->sz ) ) )
+    FD_LOG_WARNING(( "ftruncate failed (%i-%s)", errno, strerror( errno ) ));
+  if( FD_UNLIKELY( close( file->fd ) ) )
+    FD_LOG_WARNING(( "close failed (%i-%s)", errno, strerror( errno ) ));
+  file->fd      = -1;
+  file->closing = 0;
+}
+
+/* fd_capture_tile_io_file_open opens "<path>.<file_idx>.pcap" (replacing
+   any existing file) in file slot slot, which should be free.  Returns
+   0 on success and non-zero on failure (logs details, slot stays
+   free). */
+
+static int
+fd_capture_tile_io_file_open( fd_capture_tile_io_t * io,
+                              ulong                  slot,
+                              char const *           path,
+                              ulong                  file_idx ) {
+  char name[ PATH_MAX ];
+  if( FD_UNLIKELY( (ulong)snprintf( name, PATH_MAX, "%s.%lu.pcap", path, file_idx )>=(ulong)PATH_MAX ) ) {
+    FD_LOG_WARNING(( "capture path too long" ));
+    return 1;
+  }
+
+  int direct = io->direct;
+  int fd     = direct ? open( name, O_WRONLY|O_CREAT|O_TRUNC|O_DIRECT, 0644 ) : -1;
+  if( FD_UNLIKELY( direct && fd<0 && errno==EINVAL ) ) { /* File system does not support O_DIRECT */
+    FD_LOG_INFO(( "O_DIRECT not supported for %s, using buffered I/O", name ));
+    direct = 0;
+  }
+  if( !direct ) fd = open( name, O_WRONLY|O_CREAT|O_TRUNC, 0644 );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "open( \"%s\" ) failed (%i-%s)", name, errno, strerror( errno ) ));
+    return 1;
+  }
+
+  FD_LOG_INFO(( "Capturing to %s", name ));
+  fd_capture_tile_file_t * file = io->file + slot;
+  file->fd       = fd;
+  file->direct   = direct;
+  file->closing  = 0;
+  file->off      = 0UL;
+  file->sz       = 0UL;
+  file->inflight = 0UL;
+  return 0;
+}
+
+/* fd_capture_tile_io_reap processes the completions of in flight
+   writes: completed buffers are freed and files waiting to be closed
+   are closed once their last write completes. */
+
+static void
+fd_capture_tile_io_reap( fd_capture_tile_io_t * io ) {
+  fd_uring_ring_t * cq = &io->uring.cq;
+
+  uint head = *cq->head; /* Only written by us */
+  uint tail = FD_VOLATILE_CONST( *cq->tail );
+  FD_COMPILER_MFENCE();
+  for( ; head!=tail; head++ ) {
+    struct io_uring_cqe const * cqe = cq->cqes + (head & cq->mask);
+    fd_capture_tile_buf_t *  buf  = io->buf + cqe->user_data;
+    fd_capture_tile_file_t * file = io->file + buf->file_slot;
+    if( FD_UNLIKELY( cqe->res!=(int)buf->sz ) ) {
+      if( cqe->res<0 ) FD_LOG_WARNING(( "capture write failed (%i-%s)", -cqe->res, strerror( -cqe->res ) ));
+      else             FD_LOG_WARNING(( "short capture write (%i of %lu bytes)", cqe->res, buf->sz ));
+      io->write_err_cnt++;
+    } else {
+      io->write_sz += buf->sz;
+    }
+    buf->busy = 0UL;
+    file->inflight--;
+    if( FD_UNLIKELY( file->closing & !file->inflight ) ) fd_capture_tile_io_file_close( io, buf->file_slot );
+  }
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *cq->head ) = head;
+}
+
+/* fd_capture_tile_io_wait waits for at least one in flight write to
+   complete and processes completions. */
+
+static void
+fd_capture_tile_io_wait( fd_capture_tile_io_t * io ) {
+  if( FD_UNLIKELY( fd_uring_sys_enter( io->uring.ring_fd, 0U, 1U, IORING_ENTER_GETEVENTS )<0 && errno!=EINTR ) )
+    FD_LOG_WARNING(( "io_uring_enter failed (%i-%s)", errno, strerror( errno ) ));
+  fd_capture_tile_io_reap( io );
+}
+
+/* fd_capture_tile_io_write starts writing the first sz bytes of capture
+   buffer buf_idx (which should not be busy) to the file in file slot
+   slot at the file's current offset.  sz should be a multiple of
+   FD_CAPTURE_TILE_BLOCK_SZ if the file was opened with O_DIRECT.  The
+   write is forced to a kernel worker (IOSQE_ASYNC) such that the
+   caller never blocks on storage. */
+
+static void
+fd_capture_tile_io_write( fd_capture_tile_io_t * io,
+                          ulong                  buf_idx,
+                          ulong                  sz,
+                          ulong                  slot ) {
+  fd_capture_tile_file_t * file = io->file + slot;
+
+  if( FD_UNLIKELY( file->fd<0 ) ) { /* File failed to open, count as a failed write */
+    io->write_err_cnt++;
+    return;
+  }
+
+  fd_capture_tile_buf_t * buf = io->buf + buf_idx;
+  buf->busy      = 1UL;
+  buf->file_slot = slot;
+  buf->sz        = sz;
+
+  /* There is room in the SQ as there are at least as many SQEs as
+     buffers and we submit each SQE right away */
+
+  fd_uring_ring_t * sq = &io->uring.sq;
+
+  uint tail = *sq->tail; /* Only written by us */
+  uint idx  = tail & sq->mask;
+  struct io_uring_sqe * sqe = io->uring.sqes + idx;
+  memset( sqe, 0, sizeof(struct io_uring_sqe) );
+  sqe->opcode    = IORING_OP_WRITE;
+  sqe->flags     = IOSQE_ASYNC;
+  sqe->fd        = file->fd;
+  sqe->addr      = (ulong)(io->buf_mem + buf_idx*io->buf_sz);
+  sqe->len       = (uint)sz;
+  sqe->off       = file->off;
+  sqe->user_data = buf_idx;
+  sq->array[ idx ] = idx;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *sq->tail ) = tail + 1U;
+
+  file->off += sz;
+  file->inflight++;
+
+  for(;;) {
+    int ret = fd_uring_sys_enter( io->uring.ring_fd, 1U, 0U, 0U );
+    if( FD_LIKELY( ret==1 ) ) break;
+    if( FD_UNLIKELY( !ret || (ret<0 && (errno!=EAGAIN) & (errno!=EBUSY) & (errno!=EINTR)) ) ) {
+      /* The kernel did not take the SQE (retrying a submit that took
+         nothing would spin forever), withdraw it and count the write as
+         failed (the buffer is free again and the file offset is not
+         advanced such that later writes leave no hole) */
+      if( !ret ) FD_LOG_WARNING(( "io_uring_enter submitted nothing" ));
+      else       FD_LOG_WARNING(( "io_uring_enter failed (%i-%s)", errno, strerror( errno ) ));
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( *sq->tail ) = tail;
+      file->off -= sz;
+      file->inflight--;
+      buf->busy = 0UL;
+      io->write_err_cnt++;
+      break;
+    }
+    fd_capture_tile_io_reap( io ); /* EAGAIN / EBUSY <> CQ backlogged */
+  }
+}
+
+/* fd_capture_tile_io_advance moves on to the next capture buffer,
+   writing out the current buffer (with O_DIRECT, only the block aligned
+   part of it, the remainder moves to the next buffer).  If final, the
+   whole current buffer is written out (zero padded to a block with
+   O_DIRECT) and the current file is closed once its writes complete.
+   Returns 0 on success and 1 if the next buffer is still busy (nothing
+   is done). */
+
+static int
+fd_capture_tile_io_advance( fd_capture_tile_io_t * io,
+                            int                    final,
+                            long                   now ) {
+  ulong next = io->buf_idx + 1UL; if( next>=io->buf_cnt ) next = 0UL;
+  if( FD_UNLIKELY( io->buf[ next ].busy ) ) return 1;
+
+  fd_capture_tile_file_t * file = io->file + io->file_slot;
+  uchar *                  cur  = io->buf_mem + io->buf_idx*io->buf_sz;
+  ulong                    used = io->buf_used;
+  ulong                    wsz  = used & ~io->block_mask;
+  ulong                    tail = used - wsz;
+
+  if( final ) {
+    file->sz = file->off + used;
+    if( tail ) {
+      wsz += FD_CAPTURE_TILE_BLOCK_SZ;
+      memset( cur + used, 0, wsz - used );
+    }
+    tail = 0UL;
+  }
+
+  if( FD_LIKELY( wsz  ) ) fd_capture_tile_io_write( io, io->buf_idx, wsz, io->file_slot );
+  if( FD_LIKELY( tail ) ) memcpy( io->buf_mem + next*io->buf_sz, cur + wsz, tail );
+
+  if( final && FD_LIKELY( file->fd>=0 ) ) {
+    file->closing = 1;
+    if( !file->inflight ) fd_capture_tile_io_file_close( io, io->file_slot );
+  }
+
+  io->buf_idx  = next;
+  io->buf_used = tail;
+  io->buf_t0   = now;
+  return 0;
+}
+
+ulong
+fd_capture_tile_scratch_align( void ) {
+  return FD_CAPTURE_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_capture_tile_scratch_footprint( ulong buf_sz,
+                                   ulong buf_cnt ) {
+  if( FD_UNLIKELY( (buf_sz<FD_CAPTURE_TILE_BUF_SZ_MIN) | (buf_sz>FD_CAPTURE_TILE_BUF_SZ_MAX) ) ) return 0UL;
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( buf_sz, FD_CAPTURE_TILE_BLOCK_SZ )                  ) ) return 0UL;
+  if( FD_UNLIKELY( (buf_cnt<2UL) | (buf_cnt>FD_CAPTURE_TILE_BUF_CNT_MAX)                     ) ) return 0UL;
+  ulong scratch_top = 0UL;
+  SCRATCH_ALLOC( alignof(fd_capture_tile_buf_t), buf_cnt*sizeof(fd_capture_tile_buf_t) ); /* buf */
+  SCRATCH_ALLOC( FD_CAPTURE_TILE_BLOCK_SZ,       buf_cnt*buf_sz                        ); /* buf_mem */
+  return fd_ulong_align_up( scratch_top, fd_capture_tile_scratch_align() );
+}
+
+int
+fd_capture_tile( fd_cnc_t *             cnc,
+                 fd_frag_meta_t const * mcache,
+                 uchar const *          dcache,
+                 ulong *                fseq,
+                 char const *           path,
+                 ulong                  file_cnt,
+                 ulong                  file_sz_max,
+                 uint                   link_type,
+                 ulong                  snap_len,
+                 int                    ts_src,
+                 int                    direct,
+                 ulong                  buf_sz,
+                 ulong                  buf_cnt,
+                 long                   flush,
+                 long                   lazy,
+                 fd_rng_t *             rng,
+                 void *                 scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;                /* ==fd_cnc_app_laddr( cnc ), local address of the capture tile cnc diagnostic region */
+  ulong   cnc_diag_disk_drop_cnt;  /* Accumulates number of frags dropped waiting on storage between housekeeping events */
+  ulong   cnc_diag_disk_drop_sz;   /* Accumulates payload bytes dropped waiting on storage between housekeeping events */
+  ulong   cnc_diag_ovrn_drop_cnt;  /* Accumulates number of frags dropped by overruns between housekeeping events */
+  ulong   cnc_diag_file_cnt;       /* Accumulates number of capture files opened between housekeeping events */
+  int     cnc_diag_ticks_en;       /* 1 if cnc app region has room for the duty cycle diagnostics, 0 otherwise */
+  ulong   cnc_diag_spin_ticks;     /* Accumulates ticks spent with nothing to capture between housekeeping events */
+  ulong   cnc_diag_work_ticks;     /* Accumulates ticks spent capturing frags between housekeeping events */
+  ulong   cnc_diag_backp_ticks;    /* Accumulates ticks spent waiting on storage between housekeeping events */
+  ulong   cnc_diag_hkeep_ticks;    /* Accumulates ticks spent doing housekeeping between housekeeping events */
+  fd_perf_t   _perf[1];            /* perf state, local to the tile */
+  fd_perf_t * perf;                /* Samples the tile's hardware performance counters, NULL if not sampling */
+
+  /* in frag stream state */
+  ulong                  depth; /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
+  ulong const *          sync;  /* ==fd_mcache_seq_laddr_const( mcache ), local addr where the producer publishes sync info */
+  ulong                  seq;   /* seq of the next frag to capture */
+  fd_frag_meta_t const * mline; /* ==mcache + fd_mcache_line_idx( seq, depth ) */
+  void const *           base;  /* ==fd_wksp_containing( dcache ), chunk reference address in the tile's local address space */
+
+  /* fseq diagnostic state */
+  ulong * fseq_diag;      /* ==fd_fseq_app_laddr( fseq ) or a dummy region if no fseq */
+  ulong   accum_pub_cnt;  /* Accumulates number of frags captured between housekeeping events */
+  ulong   accum_pub_sz;   /* Accumulates payload bytes of frags captured between housekeeping events */
+  ulong   accum_filt_cnt; /* Accumulates number of frags truncated between housekeeping events */
+  ulong   accum_filt_sz;  /* Accumulates payload bytes truncated between housekeeping events */
+  ulong   accum_ovrnp_cnt;
+  ulong   accum_ovrnr_cnt;
+  ulong   fseq_dummy[ 8 ];
+
+  /* timestamp state */
+  long   ts_wallclock; /* fd_log_wallclock at ts_tickcount */
+  long   ts_tickcount; /* fd_tickcount at ts_wallclock */
+  double ns_per_tick;
+
+  /* capture state */
+  fd_capture_tile_io_t io[1];       /* Capture file writer */
+  ulong                file_idx;    /* file_idx of the current capture file */
+  ulong                file_rec;    /* Number of packets in the current capture file */
+  long                 flush_ticks; /* Max ticks buffered data waits to be written */
+
+  /* housekeeping state */
+  ulong async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting capture (buf-sz %lu, buf-cnt %lu)", buf_sz, buf_cnt ));
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_capture_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_capture_tile_scratch_footprint( buf_sz, buf_cnt ) ) ) {
+      FD_LOG_WARNING(( "bad buf_sz or buf_cnt" ));
+      return 1;
+    }
+
+    ulong scratch_top = (ulong)scratch;
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<64UL ) ) { FD_LOG_WARNING(( "cnc app sz must be at least 64" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    cnc_diag_disk_drop_cnt = 0UL;
+    cnc_diag_disk_drop_sz  = 0UL;
+    cnc_diag_ovrn_drop_cnt = 0UL;
+    cnc_diag_file_cnt      = 0UL;
+
+    cnc_diag_ticks_en    = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_TICKS_APP_SZ;
+    cnc_diag_spin_ticks  = 0UL;
+    cnc_diag_work_ticks  = 0UL;
+    cnc_diag_backp_ticks = 0UL;
+    cnc_diag_hkeep_ticks = 0UL;
+
+    /* in frag stream init */
+
+    if( FD_UNLIKELY( !mcache ) ) { FD_LOG_WARNING(( "NULL mcache" )); return 1; }
+    depth = fd_mcache_depth          ( mcache );
+    sync  = fd_mcache_seq_laddr_const( mcache );
+    seq   = fd_mcache_seq_query( sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION */
+    mline = mcache + fd_mcache_line_idx( seq, depth );
+
+    if( FD_UNLIKELY( !dcache ) ) { FD_LOG_WARNING(( "NULL dcache" )); return 1; }
+    base = fd_wksp_containing( dcache );
+    if( FD_UNLIKELY( !base ) ) { FD_LOG_WARNING(( "fd_wksp_containing failed" )); return 1; }
+
+    /* fseq diagnostic init */
+
+    fseq_diag = fseq ? (ulong *)fd_fseq_app_laddr( fseq ) : fseq_dummy;
+    if( FD_UNLIKELY( !fseq_diag ) ) { FD_LOG_WARNING(( "fd_fseq_app_laddr failed" )); return 1; }
+    accum_pub_cnt   = 0UL;
+    accum_pub_sz    = 0UL;
+    accum_filt_cnt  = 0UL;
+    accum_filt_sz   = 0UL;
+    accum_ovrnp_cnt = 0UL;
+    accum_ovrnr_cnt = 0UL;
+
+    /* capture config */
+
+    if( FD_UNLIKELY( !path ) ) { FD_LOG_WARNING(( "NULL path" )); return 1; }
+    if( FD_UNLIKELY( !file_cnt ) ) { FD_LOG_WARNING(( "file_cnt must be positive" )); return 1; }
+    if( FD_UNLIKELY( (!snap_len) | (snap_len>(ulong)USHORT_MAX) ) ) { FD_LOG_WARNING(( "snap_len must be in [1,USHORT_MAX]" )); return 1; }
+    if( FD_UNLIKELY( (ts_src!=FD_CAPTURE_TS_TSPUB) & (ts_src!=FD_CAPTURE_TS_TSORIG) ) ) { FD_LOG_WARNING(( "bad ts_src" )); return 1; }
+
+    /* timestamp init */
+
+    ns_per_tick = 1. / fd_tempo_tick_per_ns( NULL );
+    fd_tempo_observe_pair( &ts_wallclock, &ts_tickcount );
+
+    /* capture io init */
+
+    io->buf           = (fd_capture_tile_buf_t *)SCRATCH_ALLOC( alignof(fd_capture_tile_buf_t), buf_cnt*sizeof(fd_capture_tile_buf_t) );
+    io->buf_mem       = (uchar *)SCRATCH_ALLOC( FD_CAPTURE_TILE_BLOCK_SZ, buf_cnt*buf_sz );
+    io->buf_sz        = buf_sz;
+    io->buf_cnt       = buf_cnt;
+    io->direct        = !!direct;
+    io->write_sz      = 0UL;
+    io->write_err_cnt = 0UL;
+    for( ulong idx=0UL; idx<buf_cnt; idx++ ) io->buf[ idx ].busy = 0UL;
+    for( ulong slot=0UL; slot<2UL; slot++ ) { io->file[ slot ].fd = -1; io->file[ slot ].closing = 0; }
+
+    if( FD_UNLIKELY( fd_capture_tile_io_init( io ) ) ) return 1;
+
+    file_idx = 0UL;
+    file_rec = 0UL;
+    if( FD_UNLIKELY( fd_capture_tile_io_file_open( io, 0UL, path, file_idx ) ) ) {
+      fd_uring_unmap( &io->uring );
+      return 1;
+    }
+    cnc_diag_file_cnt++;
+    io->file_slot  = 0UL;
+    io->block_mask = io->file[ 0 ].direct ? FD_CAPTURE_TILE_BLOCK_SZ-1UL : 0UL;
+
+    io->buf_idx  = 0UL;
+    io->buf_used = FD_PCAP_HDR_SZ;
+    fd_pcap_hdr_init( io->buf_mem, (uint)snap_len, link_type );
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( depth );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); fd_uring_unmap( &io->uring ); return 1; }
+
+    if( flush<=0L ) flush = (long)1e9;
+    flush_ticks = (long)((double)flush / ns_per_tick);
+
+    /* Sample the tile's hardware performance counters if the cnc app
+       region has room for them and they are available on this host */
+    perf = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ? fd_perf_open( _perf ) : NULL;
+    FD_LOG_INFO(( "%s performance counters", perf ? "Sampling" : "Not sampling" ));
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running capture" ));
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  io->buf_t0 = now;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Reap completed writes */
+      fd_capture_tile_io_reap( io );
+
+      /* Write out buffered data that has been waiting too long */
+      if( FD_UNLIKELY( ((now-io->buf_t0)>=flush_ticks) & ((io->buf_used & ~io->block_mask)>0UL) ) )
+        (void)fd_capture_tile_io_advance( io, 0, now );
+
+      /* Resync the wallclock / tickcount relationship used for packet
+         timestamps (tracks tickcount drift) */
+      fd_tempo_observe_pair( &ts_wallclock, &ts_tickcount );
+
+      /* Send capture progress (unreliable, for monitoring only) */
+      if( FD_LIKELY( fseq ) ) fd_fseq_update( fseq, seq );
+
+      /* Send diagnostic info */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      fseq_diag[ FD_FSEQ_DIAG_PUB_CNT   ] += accum_pub_cnt;
+      fseq_diag[ FD_FSEQ_DIAG_PUB_SZ    ] += accum_pub_sz;
+      fseq_diag[ FD_FSEQ_DIAG_FILT_CNT  ] += accum_filt_cnt;
+      fseq_diag[ FD_FSEQ_DIAG_FILT_SZ   ] += accum_filt_sz;
+      fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] += accum_ovrnp_cnt;
+      fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] += accum_ovrnr_cnt;
+      cnc_diag[ FD_CAPTURE_CNC_DIAG_DISK_DROP_CNT ] += cnc_diag_disk_drop_cnt;
+      cnc_diag[ FD_CAPTURE_CNC_DIAG_DISK_DROP_SZ  ] += cnc_diag_disk_drop_sz;
+      cnc_diag[ FD_CAPTURE_CNC_DIAG_OVRN_DROP_CNT ] += cnc_diag_ovrn_drop_cnt;
+      cnc_diag[ FD_CAPTURE_CNC_DIAG_FILE_CNT      ] += cnc_diag_file_cnt;
+      cnc_diag[ FD_CAPTURE_CNC_DIAG_WRITE_SZ      ] += io->write_sz;
+      cnc_diag[ FD_CAPTURE_CNC_DIAG_WRITE_ERR_CNT ] += io->write_err_cnt;
+      if( FD_LIKELY( cnc_diag_ticks_en ) ) {
+        cnc_diag[ FD_CNC_DIAG_SPIN_TICKS  ] += cnc_diag_spin_ticks;
+        cnc_diag[ FD_CNC_DIAG_WORK_TICKS  ] += cnc_diag_work_ticks;
+        cnc_diag[ FD_CNC_DIAG_BACKP_TICKS ] += cnc_diag_backp_ticks;
+        cnc_diag[ FD_CNC_DIAG_HKEEP_TICKS ] += cnc_diag_hkeep_ticks;
+      }
+      if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_CNC_DIAG_PERF_CYCLES );
+      FD_COMPILER_MFENCE();
+      accum_pub_cnt          = 0UL;
+      accum_pub_sz           = 0UL;
+      accum_filt_cnt         = 0UL;
+      accum_filt_sz          = 0UL;
+      accum_ovrnp_cnt        = 0UL;
+      accum_ovrnr_cnt        = 0UL;
+      cnc_diag_disk_drop_cnt = 0UL;
+      cnc_diag_disk_drop_sz  = 0UL;
+      cnc_diag_ovrn_drop_cnt = 0UL;
+      cnc_diag_file_cnt      = 0UL;
+      io->write_sz           = 0UL;
+      io->write_err_cnt      = 0UL;
+      cnc_diag_spin_ticks    = 0UL;
+      cnc_diag_work_ticks    = 0UL;
+      cnc_diag_backp_ticks   = 0UL;
+      cnc_diag_hkeep_ticks   = 0UL;
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        if( FD_UNLIKELY( s!=FD_CAPTURE_CNC_SIGNAL_ACK ) ) {
+          char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+          FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        }
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, cnc_diag_hkeep_ticks );
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if there is a new frag to capture */
+
+    FD_COMPILER_MFENCE();
+    ulong seq_found = mline->seq;
+    FD_COMPILER_MFENCE();
+
+    long diff = fd_seq_diff( seq, seq_found );
+    if( FD_UNLIKELY( diff ) ) { /* Caught up or overrun, optimize for new frag case */
+      if( FD_UNLIKELY( diff<0L ) ) { /* Overrun, the producer lapped us, resume from the frag found */
+        cnc_diag_ovrn_drop_cnt += (ulong)-diff;
+        accum_ovrnp_cnt++;
+        seq   = seq_found;
+        mline = mcache + fd_mcache_line_idx( seq, depth );
+        FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+        continue;
+      }
+      FD_SPIN_PAUSE();
+      FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks );
+      continue;
+    }
+
+    /* Load the frag metadata */
+
+    FD_COMPILER_MFENCE();
+    ulong chunk  = (ulong)mline->chunk;
+    ulong sz     = (ulong)mline->sz;
+    ulong tsorig = (ulong)mline->tsorig;
+    ulong tspub  = (ulong)mline->tspub;
+    FD_COMPILER_MFENCE();
+    ulong seq_test = mline->seq;
+    FD_COMPILER_MFENCE();
+
+    if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading */
+      cnc_diag_ovrn_drop_cnt += (ulong)fd_long_max( fd_seq_diff( seq_test, seq ), 1L );
+      accum_ovrnr_cnt++;
+      seq   = seq_test;
+      mline = mcache + fd_mcache_line_idx( seq, depth );
+      FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+      continue;
+    }
+
+    ulong cap_sz = fd_ulong_min( sz, snap_len );
+    ulong rec_sz = FD_PCAP_PKT_HDR_SZ + cap_sz;
+
+    /* Start a new capture file if this packet would make the current
+       one too large (files always get at least one packet).  If the
+       other file slot is still busy with the previous file's last
+       writes, wait for them (only happens with tiny files). */
+
+    if( FD_UNLIKELY( file_sz_max && file_rec &&
+                     (io->file[ io->file_slot ].off + io->buf_used + rec_sz)>file_sz_max ) ) {
+      if( FD_UNLIKELY( fd_capture_tile_io_advance( io, 1, now ) ) ) goto disk_drop;
+
+      ulong slot = io->file_slot ^ 1UL;
+      while( FD_UNLIKELY( io->file[ slot ].fd>=0 ) ) {
+        FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+        fd_capture_tile_io_wait( io );
+        FD_CNC_DIAG_TICK( now, cnc_diag_backp_ticks );
+      }
+
+      file_idx++; if( file_idx>=file_cnt ) file_idx = 0UL;
+      file_rec = 0UL;
+      io->file_slot  = slot;
+      io->block_mask = 0UL;
+      if( FD_LIKELY( !fd_capture_tile_io_file_open( io, slot, path, file_idx ) ) ) {
+        cnc_diag_file_cnt++;
+        if( io->file[ slot ].direct ) io->block_mask = FD_CAPTURE_TILE_BLOCK_SZ-1UL;
+      } else { /* Writes to this file will be counted as failed */
+        io->file[ slot ].off = 0UL;
+      }
+      fd_pcap_hdr_init( io->buf_mem + io->buf_idx*buf_sz, (uint)snap_len, link_type );
+      io->buf_used = FD_PCAP_HDR_SZ;
+    }
+
+    /* Make room for the packet record in the current buffer */
+
+    if( FD_UNLIKELY( (io->buf_used + rec_sz)>buf_sz ) ) {
+      if( FD_UNLIKELY( fd_capture_tile_io_advance( io, 0, now ) ) ) goto disk_drop;
+    }
+
+    /* Copy the packet record into the buffer */
+
+    do {
+      uchar * rec = io->buf_mem + io->buf_idx*buf_sz + io->buf_used;
+      long    tick = fd_frag_meta_ts_decomp( ts_src==FD_CAPTURE_TS_TSORIG ? tsorig : tspub, now );
+      long    ts   = ts_wallclock + (long)((double)(tick - ts_tickcount)*ns_per_tick);
+      fd_pcap_pkt_hdr_init( rec, ts, cap_sz, sz );
+      fd_memcpy( rec + FD_PCAP_PKT_HDR_SZ, fd_chunk_to_laddr_const( base, chunk ), cap_sz );
+    } while(0);
+
+    /* Check that we weren't overrun while copying.  If so, the copy
+       might be corrupt and is discarded. */
+
+    FD_COMPILER_MFENCE();
+    seq_test = mline->seq;
+    FD_COMPILER_MFENCE();
+
+    if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) {
+      cnc_diag_ovrn_drop_cnt += (ulong)fd_long_max( fd_seq_diff( seq_test, seq ), 1L );
+      accum_ovrnr_cnt++;
+      seq   = seq_test;
+      mline = mcache + fd_mcache_line_idx( seq, depth );
+      FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+      continue;
+    }
+
+    io->buf_used += rec_sz;
+    file_rec++;
+    accum_pub_cnt++;
+    accum_pub_sz   += sz;
+    accum_filt_cnt += (ulong)(cap_sz<sz);
+    accum_filt_sz  += sz - cap_sz;
+
+    /* Windup for the next frag */
+
+    seq   = fd_seq_inc( seq, 1UL );
+    mline = mcache + fd_mcache_line_idx( seq, depth );
+    FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+    continue;
+
+  disk_drop: /* All capture buffers are waiting on storage, drop the frag */
+    cnc_diag_disk_drop_cnt++;
+    cnc_diag_disk_drop_sz += sz;
+    fd_capture_tile_io_reap( io );
+    seq   = fd_seq_inc( seq, 1UL );
+    mline = mcache + fd_mcache_line_idx( seq, depth );
+    FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting capture" ));
+
+    FD_LOG_INFO(( "Flushing capture" ));
+    while( fd_capture_tile_io_advance( io, 1, now ) ) fd_capture_tile_io_wait( io );
+    for( ulong slot=0UL; slot<2UL; slot++ ) while( io->file[ slot ].fd>=0 ) fd_capture_tile_io_wait( io );
+
+    FD_COMPILER_MFENCE();
+    if( FD_LIKELY( fseq ) ) fd_fseq_update( fseq, seq );
+    fseq_diag[ FD_FSEQ_DIAG_PUB_CNT   ] += accum_pub_cnt;
+    fseq_diag[ FD_FSEQ_DIAG_PUB_SZ    ] += accum_pub_sz;
+    fseq_diag[ FD_FSEQ_DIAG_FILT_CNT  ] += accum_filt_cnt;
+    fseq_diag[ FD_FSEQ_DIAG_FILT_SZ   ] += accum_filt_sz;
+    fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] += accum_ovrnp_cnt;
+    fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] += accum_ovrnr_cnt;
+    cnc_diag[ FD_CAPTURE_CNC_DIAG_DISK_DROP_CNT ] += cnc_diag_disk_drop_cnt;
+    cnc_diag[ FD_CAPTURE_CNC_DIAG_DISK_DROP_SZ  ] += cnc_diag_disk_drop_sz;
+    cnc_diag[ FD_CAPTURE_CNC_DIAG_OVRN_DROP_CNT ] += cnc_diag_ovrn_drop_cnt;
+    cnc_diag[ FD_CAPTURE_CNC_DIAG_FILE_CNT      ] += cnc_diag_file_cnt;
+    cnc_diag[ FD_CAPTURE_CNC_DIAG_WRITE_SZ      ] += io->write_sz;
+    cnc_diag[ FD_CAPTURE_CNC_DIAG_WRITE_ERR_CNT ] += io->write_err_cnt;
+    FD_COMPILER_MFENCE();
+
+    FD_LOG_INFO(( "Destroying io_uring" ));
+    fd_uring_unmap( &io->uring );
+
+    if( FD_LIKELY( perf ) ) fd_perf_close( perf );
+
+    FD_LOG_INFO(( "Halted capture" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#undef SCRATCH_ALLOC
+#endif
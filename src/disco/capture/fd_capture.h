@@ -0,0 +1,210 @@
+#ifndef HEADER_fd_src_disco_capture_fd_capture_h
+#define HEADER_fd_src_disco_capture_fd_capture_h
+
+/* fd_capture provides services to capture the frags flowing over a
+   tango link (any mcache / dcache pair) into a rotating set of pcap
+   files for offline debugging.  The capture tile is an unreliable
+   consumer of the link: it never backpressures the link's producer.
+   When the tile (or the storage it writes to) cannot keep up with the
+   link, frags are dropped from the capture and the drops are counted. */
+
+#include "../fd_disco_base.h"
+#include "../../util/net/fd_pcap.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_CAPTURE_CNC_SIGNAL_ACK can
+   be raised by a cnc thread with an open command session while the
+   capture is in the RUN state.  The capture will transition from
+   ACK->RUN the next time it processes cnc signals to indicate it is
+   running normally.  If a signal other than ACK, HALT, or RUN is
+   raised, it will be logged as unexpected and transitioned by back to
+   RUN. */
+
+#define FD_CAPTURE_CNC_SIGNAL_ACK (4UL)
+
+/* A fd_capture_tile will use the fseq and cnc application regions to
+   accumulate the following tile specific counters:
+
+     DISK_DROP_CNT is the number of frags dropped because all capture buffers were waiting on storage
+     DISK_DROP_SZ  is the number of frag payload bytes dropped because all capture buffers were waiting on storage
+     OVRN_DROP_CNT is the number of frags dropped because the link's producer overran the capture
+     FILE_CNT      is the number of capture files opened
+     WRITE_SZ      is the number of bytes written to capture files (including alignment padding)
+     WRITE_ERR_CNT is the number of failed capture file writes (logs details)
+
+   As such, the cnc app region must be at least 64B in size.  If the cnc
+   app region is at least FD_CNC_DIAG_TICKS_APP_SZ, the tile will also
+   accumulate the standard FD_CNC_DIAG_*_TICKS duty cycle diagnostics
+   (BACKP_TICKS counts the ticks spent waiting on storage when rotating
+   files).  If the cnc app region is at least FD_CNC_DIAG_PERF_APP_SZ
+   and the host supports it, the tile will also accumulate the standard
+   FD_CNC_DIAG_PERF_* hardware performance counter diagnostics.  The
+   tile also accumulates the standard FD_FSEQ_DIAG_* diagnostics in the
+   fseq application region (PUB_{CNT,SZ} count the captured frags and
+   their payload bytes, FILT_{CNT,SZ} count the captured frags that were
+   truncated to the snap_len and their truncated bytes and OVRN{P,R}_CNT
+   count overrun events).
+
+   None of the diagnostics are cleared at tile startup (as such that
+   they can be accumulated over multiple runs).  Clearing is up to
+   monitoring scripts. */
+
+#define FD_CAPTURE_CNC_DIAG_DISK_DROP_CNT (2UL) /* On 1st cache line of app region, updated by consumer, frequently */
+#define FD_CAPTURE_CNC_DIAG_DISK_DROP_SZ  (3UL) /* ", frequently */
+#define FD_CAPTURE_CNC_DIAG_OVRN_DROP_CNT (4UL) /* ", frequently */
+#define FD_CAPTURE_CNC_DIAG_FILE_CNT      (5UL) /* ", rarely */
+#define FD_CAPTURE_CNC_DIAG_WRITE_SZ      (6UL) /* ", frequently */
+#define FD_CAPTURE_CNC_DIAG_WRITE_ERR_CNT (7UL) /* ", ideally never */
+
+/* FD_CAPTURE_TS_* specify which frag timestamp is used as the pcap
+   packet timestamp. */
+
+#define FD_CAPTURE_TS_TSPUB  (0) /* When the frag was published to the link */
+#define FD_CAPTURE_TS_TSORIG (1) /* When the frag's message started to be produced */
+
+/* FD_CAPTURE_TILE_BLOCK_SZ is the granularity of capture file writes.
+   Capture buffers are written out in multiples of this at file offsets
+   that are multiples of this such that writes can bypass the page
+   cache (O_DIRECT). */
+
+#define FD_CAPTURE_TILE_BLOCK_SZ (4096UL)
+
+/* FD_CAPTURE_TILE_BUF_SZ_MIN is the smallest supported capture buffer
+   size.  It is large enough to hold the pcap file header and largest
+   possible pcap packet record after an alignment remainder.
+   FD_CAPTURE_TILE_BUF_{CNT_MAX,SZ_MAX} bound the number and size of
+   capture buffers.  These limits are more or less arbitrary from a
+   functional correctness POV. */
+
+#define FD_CAPTURE_TILE_BUF_SZ_MIN  (73728UL)  /* 18 blocks */
+#define FD_CAPTURE_TILE_BUF_SZ_MAX  (1UL<<30)
+#define FD_CAPTURE_TILE_BUF_CNT_MAX (256UL)
+
+/* FD_CAPTURE_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
+   footprint needed for a capture tile scratch region that can support
+   buf_cnt capture buffers of buf_sz bytes.  ALIGN is an integer power
+   of 2 of at least FD_CAPTURE_TILE_BLOCK_SZ such that capture buffers
+   are suitably aligned for direct I/O.  FOOTPRINT will be an integer
+   multiple of ALIGN.  buf_sz and buf_cnt are assumed to be valid (i.e.
+   buf_sz a multiple of FD_CAPTURE_TILE_BLOCK_SZ in
+   [FD_CAPTURE_TILE_BUF_SZ_MIN,FD_CAPTURE_TILE_BUF_SZ_MAX] and buf_cnt
+   in [2,FD_CAPTURE_TILE_BUF_CNT_MAX]).  These are provided to
+   facilitate compile time declarations. */
+
+#define FD_CAPTURE_TILE_SCRATCH_ALIGN (4096UL)
+#define FD_CAPTURE_TILE_SCRATCH_FOOTPRINT( buf_sz, buf_cnt )             \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,   \
+    64UL,                     (buf_cnt)*64UL        ),                  \
+    FD_CAPTURE_TILE_BLOCK_SZ, (buf_cnt)*(buf_sz)    ),                  \
+    FD_CAPTURE_TILE_SCRATCH_ALIGN )
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_capture_tile captures the frags published to mcache (with
+   payloads in the dcache, more precisely, chunks relative to the wksp
+   containing dcache) into a rotating set of pcap files.  The capture
+   starts at the mcache's current sequence number.  The tile is an
+   unreliable consumer of the link.  It should not be added to the
+   producer's reliable consumers (its fseq, if any, is only used for
+   monitoring).
+
+   The capture files are named "<path>.<file_idx>.pcap" with file_idx in
+   [0,file_cnt).  A new file is started when the current file would
+   exceed file_sz_max bytes (0 means no limit), cycling through the
+   file_idx (the oldest file is overwritten).  Files are nanosecond
+   resolution pcaps with link type link_type (e.g.
+   FD_PCAP_LINK_TYPE_ETHERNET for links of Ethernet frames).  Each frag
+   is a pcap packet (multi-frag messages are not reassembled) of at most
+   snap_len bytes (in [1,USHORT_MAX], larger frags are truncated).  The
+   packet timestamp is the frag's tspub or tsorig (as per ts_src, one of
+   FD_CAPTURE_TS_*) converted to fd_log_wallclock ns.
+
+   Frags are copied into the next free space of one of buf_cnt capture
+   buffers of buf_sz bytes in scratch (no per packet I/O).  When a
+   buffer fills, the block aligned part of the buffer is written to the
+   current capture file with io_uring (for O_DIRECT files, the
+   unaligned remainder moves to the next buffer) and the tile moves on to the next buffer while the
+   write completes in the background.  If direct is non-zero, files are
+   opened with O_DIRECT (bypassing the page cache, falling back to
+   buffered I/O for file systems that do not support it) and the
+   trailing block of each file is truncated to the file's actual size
+   when the file is closed.  If buffered data has been waiting for more
+   than flush ns (<=0 means a reasonable default), the block aligned
+   part of the current buffer is written out early such that captures
+   of slow links make progress.
+
+   The tile never waits for the link's producer or storage in its run
+   loop.  If the next capture buffer is still being written when it is
+   needed, frags are dropped (DISK_DROP_*) until the write completes.
+   If the producer laps the capture, the lapped frags are dropped
+   (OVRN_DROP_CNT).  Only when rotating to a file slot whose previous
+   writes are still in flight (which requires tiny files) will the tile
+   wait for storage.
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the capture tile.  That is, the tile booted
+   successfully (transitioning the cnc from BOOT->RUN), ran (handling
+   any application specific cnc signals while running), and (after
+   receiving a HALT signal) wrote out any buffered frags, closed the
+   capture file and halted successfully (transitioning the cnc from
+   HALT->BOOT before return).  Returns a non-zero error code if the tile
+   fails to boot up (logs details ... the cnc will not be transitioned
+   from its original state and thus is likely bootable again if its
+   original state was BOOT).
+
+   lazy is the ballpark interval in ns for how often to do housekeeping
+   (sending diagnostics, receiving cnc signals, reaping write
+   completions).  <=0 indicates to pick a conservative default.
+
+   scratch points to tile scratch memory.  fd_capture_tile_scratch_align
+   and fd_capture_tile_scratch_footprint return the required alignment
+   and footprint needed for this region.  This memory region is
+   exclusively owned by the capture tile while the tile is running and
+   is ideally near the core running the capture tile.
+   fd_capture_tile_scratch_align will return the same value as
+   FD_CAPTURE_TILE_SCRATCH_ALIGN.  If buf_sz or buf_cnt is not valid,
+   fd_capture_tile_scratch_footprint silently returns 0 so callers can
+   diagnose configuration issues.  Otherwise,
+   fd_capture_tile_scratch_footprint will return the same value as
+   FD_CAPTURE_TILE_SCRATCH_FOOTPRINT.
+
+   The lifetime of the cnc, mcache, dcache, fseq, rng and scratch used
+   by this tile should be a superset of this tile's lifetime.  While
+   this tile is running, no other tile should use cnc for its command
+   and control, use fseq or the rng for anything (and the rng should be
+   seeded distinctly from all other rngs in the system), or use scratch
+   for anything.  The path cstr will not be used after the tile has
+   returned. */
+
+FD_FN_CONST ulong
+fd_capture_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_capture_tile_scratch_footprint( ulong buf_sz,
+                                   ulong buf_cnt );
+
+int
+fd_capture_tile( fd_cnc_t *             cnc,         /* Local join to the capture's command-and-control */
+                 fd_frag_meta_t const * mcache,      /* Local join to the mcache of the link to capture */
+                 uchar const *          dcache,      /* Local join to the dcache of the link to capture */
+                 ulong *                fseq,        /* Local join to the capture's fseq (for monitoring), NULL if none */
+                 char const *           path,        /* Points to first byte of cstr with the capture file path prefix */
+                 ulong                  file_cnt,    /* Number of capture files in the rotating set, positive */
+                 ulong                  file_sz_max, /* Capture file size limit in bytes, 0 means no limit */
+                 uint                   link_type,   /* pcap link type of the capture files, a FD_PCAP_LINK_TYPE_* */
+                 ulong                  snap_len,    /* Max bytes of a frag to capture, in [1,USHORT_MAX] */
+                 int                    ts_src,      /* Which frag timestamp to use as packet timestamp, a FD_CAPTURE_TS_* */
+                 int                    direct,      /* Non-zero to write capture files with O_DIRECT */
+                 ulong                  buf_sz,      /* Capture buffer size in bytes */
+                 ulong                  buf_cnt,     /* Number of capture buffers */
+                 long                   flush,       /* Max ns buffered data waits to be written, <=0 means a reasonable default */
+                 long                   lazy,        /* Lazyiness, <=0 means use a reasonable default */
+                 fd_rng_t *             rng,         /* Local join to the rng this capture should use */
+                 void *                 scratch );   /* Tile scratch memory */
+
+FD_PROTOTYPES_END
+
+#endif
+
+#endif /* HEADER_fd_src_disco_capture_fd_capture_h */
@@ -0,0 +1,103 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+FD_STATIC_ASSERT( FD_CAPTURE_TILE_SCRATCH_ALIGN<=FD_SHMEM_HUGE_PAGE_SZ, alignment );
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  FD_LOG_NOTICE(( "Init" ));
+
+  char const * _cnc        = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",         NULL, NULL                       );
+  char const * _mcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",      NULL, NULL                       );
+  char const * _dcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--dcache",      NULL, NULL                       );
+  char const * _fseq       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--fseq",        NULL, NULL                       ); /* NULL <> no fseq */
+  char const * path        = fd_env_strip_cmdline_cstr ( &argc, &argv, "--path",        NULL, NULL                       );
+  ulong        file_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--file-cnt",    NULL, 8UL                        );
+  ulong        file_sz_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--file-sz-max", NULL, 1UL<<30                    ); /* 0 <> no limit */
+  uint         link_type   = fd_env_strip_cmdline_uint ( &argc, &argv, "--link-type",   NULL, FD_PCAP_LINK_TYPE_ETHERNET );
+  ulong        snap_len    = fd_env_strip_cmdline_ulong( &argc, &argv, "--snap-len",    NULL, (ulong)USHORT_MAX          );
+  int          tsorig      = fd_env_strip_cmdline_int  ( &argc, &argv, "--tsorig",      NULL, 0                          ); /* 0 <> tspub */
+  int          direct      = fd_env_strip_cmdline_int  ( &argc, &argv, "--direct",      NULL, 1                          );
+  ulong        buf_sz      = fd_env_strip_cmdline_ulong( &argc, &argv, "--buf-sz",      NULL, 8UL<<20                    );
+  ulong        buf_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--buf-cnt",     NULL, 8UL                        );
+  long         flush       = fd_env_strip_cmdline_long ( &argc, &argv, "--flush",       NULL, 0L                         ); /* <=0 <> use default */
+  long         lazy        = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",        NULL, 0L                         ); /* <=0 <> use default */
+  uint         seed        = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",        NULL, (uint)(ulong)fd_tickcount() );
+
+  if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
+  FD_LOG_NOTICE(( "Joining --cnc %s", _cnc ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_map( _cnc ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+
+  if( FD_UNLIKELY( !_mcache ) ) FD_LOG_ERR(( "--mcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --mcache %s", _mcache ));
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_map( _mcache ) );
+  if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+  if( FD_UNLIKELY( !_dcache ) ) FD_LOG_ERR(( "--dcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --dcache %s", _dcache ));
+  uchar * dcache = fd_dcache_join( fd_wksp_map( _dcache ) );
+  if( FD_UNLIKELY( !dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+
+  ulong * fseq = NULL;
+  if( _fseq ) {
+    FD_LOG_NOTICE(( "Joining --fseq %s", _fseq ));
+    fseq = fd_fseq_join( fd_wksp_map( _fseq ) );
+    if( FD_UNLIKELY( !fseq ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  }
+
+  if( FD_UNLIKELY( !path ) ) FD_LOG_ERR(( "--path not specified" ));
+  FD_LOG_NOTICE(( "Using --path %s, --file-cnt %lu, --file-sz-max %lu, --link-type %u, --snap-len %lu, --tsorig %i, --direct %i",
+                  path, file_cnt, file_sz_max, link_type, snap_len, tsorig, direct ));
+  FD_LOG_NOTICE(( "Using --buf-sz %lu, --buf-cnt %lu, --flush %li, --lazy %li", buf_sz, buf_cnt, flush, lazy ));
+
+  FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+
+  FD_LOG_NOTICE(( "Creating scratch" ));
+  ulong footprint = fd_capture_tile_scratch_footprint( buf_sz, buf_cnt );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_capture_tile_scratch_footprint failed" ));
+  ulong  page_sz  = FD_SHMEM_HUGE_PAGE_SZ;
+  ulong  page_cnt = fd_ulong_align_up( footprint, page_sz ) / page_sz;
+  ulong  cpu_idx  = fd_tile_cpu_id( fd_tile_idx() );
+  void * scratch  = fd_shmem_acquire( page_sz, page_cnt, cpu_idx );
+  if( FD_UNLIKELY( !scratch ) ) FD_LOG_ERR(( "fd_shmem_acquire failed (need at least %lu free huge pages on numa node %lu)",
+                                             page_cnt, fd_shmem_numa_idx( cpu_idx ) ));
+
+  FD_LOG_NOTICE(( "Run" ));
+
+  int err = fd_capture_tile( cnc, mcache, dcache, fseq, path, file_cnt, file_sz_max, link_type, snap_len,
+                             tsorig ? FD_CAPTURE_TS_TSORIG : FD_CAPTURE_TS_TSPUB, direct, buf_sz, buf_cnt, flush, lazy,
+                             rng, scratch );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_capture_tile failed (%i)", err ));
+
+  FD_LOG_NOTICE(( "Fini" ));
+
+  fd_shmem_release( scratch, page_sz, page_cnt );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  if( fseq ) fd_wksp_unmap( fd_fseq_leave( fseq ) );
+  fd_wksp_unmap( fd_dcache_leave( dcache ) );
+  fd_wksp_unmap( fd_mcache_leave( mcache ) );
+  fd_wksp_unmap( fd_cnc_leave   ( cnc    ) );
+
+  fd_halt();
+  return err;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "implement support for this build target" ));
+  fd_halt();
+  return 1;
+}
+
+#endif
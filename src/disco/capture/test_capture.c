@@ -0,0 +1,371 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <stdio.h>
+#include <unistd.h>
+
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_SIGNAL_ACK==4UL, unit_test );
+
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_DIAG_DISK_DROP_CNT==2UL, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_DIAG_DISK_DROP_SZ ==3UL, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_DIAG_OVRN_DROP_CNT==4UL, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_DIAG_FILE_CNT     ==5UL, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_DIAG_WRITE_SZ     ==6UL, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_CNC_DIAG_WRITE_ERR_CNT==7UL, unit_test );
+
+FD_STATIC_ASSERT( FD_CAPTURE_TS_TSPUB ==0, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_TS_TSORIG==1, unit_test );
+
+FD_STATIC_ASSERT( FD_CAPTURE_TILE_BLOCK_SZ   ==4096UL,  unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_TILE_BUF_SZ_MIN ==73728UL, unit_test );
+FD_STATIC_ASSERT( FD_CAPTURE_TILE_BUF_CNT_MAX==256UL,   unit_test );
+
+FD_STATIC_ASSERT( FD_CAPTURE_TILE_SCRATCH_ALIGN==4096UL, unit_test );
+
+FD_STATIC_ASSERT( FD_CAPTURE_TILE_BUF_SZ_MIN>=FD_CAPTURE_TILE_BLOCK_SZ-1UL+FD_PCAP_HDR_SZ+FD_PCAP_PKT_HDR_SZ+(ulong)USHORT_MAX,
+                  unit_test );
+
+struct test_cfg {
+  fd_wksp_t *      wksp;
+
+  fd_frag_meta_t * tx_mcache;
+  uchar *          tx_dcache;
+  ulong            tx_mtu;
+  ulong            tx_cnt;
+  float            tx_rate;
+  ulong            tx_seq0;
+
+  fd_cnc_t *       cap_cnc;
+  ulong *          cap_fseq;
+  char const *     cap_path;
+  ulong            cap_file_cnt;
+  ulong            cap_file_sz_max;
+  ulong            cap_snap_len;
+  int              cap_direct;
+  ulong            cap_buf_sz;
+  ulong            cap_buf_cnt;
+  uint             cap_seed;
+  void *           cap_scratch;
+};
+
+typedef struct test_cfg test_cfg_t;
+
+/* test_frag_sz returns the size of the test frag with sequence number
+   seq (in [16,mtu], at least an Ethernet header as the capture is of
+   link type Ethernet).  The first 8 bytes of a test frag are its seq and
+   byte i>=8 is test_frag_byte( seq, i ). */
+
+static inline ulong
+test_frag_sz( ulong seq,
+              ulong mtu ) {
+  return 16UL + (fd_ulong_hash( seq ) % (mtu-15UL));
+}
+
+static inline uchar
+test_frag_byte( ulong seq,
+                ulong i ) {
+  return (uchar)(seq*7UL + i);
+}
+
+/* TX tile ************************************************************/
+
+/* tx_tile_main publishes tx_cnt test frags (as fast as possible or at
+   tx_rate frags/s) without flow control (the capture is unreliable). */
+
+static int
+tx_tile_main( int     argc,
+              char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_frag_meta_t * mcache = cfg->tx_mcache;
+  ulong            depth  = fd_mcache_depth( mcache );
+  ulong *          sync   = fd_mcache_seq_laddr( mcache );
+  ulong            seq    = fd_mcache_seq_query( sync );
+  ulong            mtu    = cfg->tx_mtu;
+
+  void * base   = fd_wksp_containing( cfg->tx_dcache );
+  ulong  chunk0 = fd_dcache_compact_chunk0( base, cfg->tx_dcache );
+  ulong  wmark  = fd_dcache_compact_wmark ( base, cfg->tx_dcache, mtu );
+  ulong  chunk  = chunk0;
+
+  double tick_per_pkt = cfg->tx_rate>0.f ? fd_tempo_tick_per_ns( NULL )*1e9/(double)cfg->tx_rate : 0.;
+  long   t0           = fd_tickcount();
+
+  for( ulong idx=0UL; idx<cfg->tx_cnt; idx++ ) {
+    if( tick_per_pkt>0. ) while( (fd_tickcount() - (t0 + (long)((double)idx*tick_per_pkt)))<0L ) FD_SPIN_PAUSE();
+
+    ulong   sz = test_frag_sz( seq, mtu );
+    uchar * p  = (uchar *)fd_chunk_to_laddr( base, chunk );
+    FD_STORE( ulong, p, seq );
+    for( ulong i=8UL; i<sz; i++ ) p[i] = test_frag_byte( seq, i );
+
+    ulong ctl    = fd_frag_meta_ctl( 0UL, 1 /*som*/, 1 /*eom*/, 0 /*err*/ );
+    ulong tspub  = fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_mcache_publish( mcache, depth, seq, seq /*sig*/, chunk, sz, ctl, tspub, tspub );
+
+    chunk = fd_dcache_compact_next( chunk, sz, chunk0, wmark );
+    seq   = fd_seq_inc( seq, 1UL );
+    if( !(idx & 1023UL) ) fd_mcache_seq_update( sync, seq );
+  }
+  fd_mcache_seq_update( sync, seq );
+
+  return 0;
+}
+
+/* Capture tile *******************************************************/
+
+static int
+cap_tile_main( int     argc,
+               char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->cap_seed, 0UL ) );
+
+  FD_TEST( !fd_capture_tile( cfg->cap_cnc, cfg->tx_mcache, cfg->tx_dcache, cfg->cap_fseq, cfg->cap_path,
+                             cfg->cap_file_cnt, cfg->cap_file_sz_max, FD_PCAP_LINK_TYPE_ETHERNET, cfg->cap_snap_len,
+                             FD_CAPTURE_TS_TSPUB, cfg->cap_direct, cfg->cap_buf_sz, cfg->cap_buf_cnt, 0L, 0L,
+                             rng, cfg->cap_scratch ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+/* MAIN tail **********************************************************/
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  FD_TEST( fd_capture_tile_scratch_align()==FD_CAPTURE_TILE_SCRATCH_ALIGN );
+  FD_TEST( !fd_capture_tile_scratch_footprint( FD_CAPTURE_TILE_BUF_SZ_MIN-FD_CAPTURE_TILE_BLOCK_SZ, 2UL                             ) );
+  FD_TEST( !fd_capture_tile_scratch_footprint( FD_CAPTURE_TILE_BUF_SZ_MIN+1UL,                      2UL                             ) );
+  FD_TEST( !fd_capture_tile_scratch_footprint( FD_CAPTURE_TILE_BUF_SZ_MAX+FD_CAPTURE_TILE_BLOCK_SZ, 2UL                             ) );
+  FD_TEST( !fd_capture_tile_scratch_footprint( FD_CAPTURE_TILE_BUF_SZ_MIN,                          1UL                             ) );
+  FD_TEST( !fd_capture_tile_scratch_footprint( FD_CAPTURE_TILE_BUF_SZ_MIN,                          FD_CAPTURE_TILE_BUF_CNT_MAX+1UL ) );
+  uint rng_seq = 0U;
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
+  for( ulong iter_rem=1000000UL; iter_rem; iter_rem-- ) {
+    ulong buf_sz  = FD_CAPTURE_TILE_BUF_SZ_MIN + FD_CAPTURE_TILE_BLOCK_SZ*fd_rng_ulong_roll( rng, 1UL<<16 );
+    ulong buf_cnt = 2UL + fd_rng_ulong_roll( rng, FD_CAPTURE_TILE_BUF_CNT_MAX-1UL );
+    FD_TEST( fd_capture_tile_scratch_footprint( buf_sz, buf_cnt )==FD_CAPTURE_TILE_SCRATCH_FOOTPRINT( buf_sz, buf_cnt ) );
+  }
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",         NULL, "gigantic"                   );
+  ulong        page_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",        NULL, 1UL                          );
+  ulong        numa_idx     = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",        NULL, fd_shmem_numa_idx( cpu_idx ) );
+  ulong        tx_mtu       = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",          NULL, 1542UL                       );
+  ulong        tx_depth     = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",        NULL, 32768UL                      );
+  ulong        tx_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cnt",          NULL, 100000UL                     );
+  float        tx_rate      = fd_env_strip_cmdline_float( &argc, &argv, "--tx-rate",         NULL, 0.f /* no pacing */          );
+  char const * cap_path     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cap-path",        NULL, "/tmp/test_capture"          );
+  ulong        cap_file_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--cap-file-cnt",    NULL, 64UL                         );
+  ulong        cap_file_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--cap-file-sz-max", NULL, 16UL<<20                     );
+  ulong        cap_snap_len = fd_env_strip_cmdline_ulong( &argc, &argv, "--cap-snap-len",    NULL, 1024UL                       );
+  int          cap_direct   = fd_env_strip_cmdline_int  ( &argc, &argv, "--cap-direct",      NULL, 1                            );
+  ulong        cap_buf_sz   = fd_env_strip_cmdline_ulong( &argc, &argv, "--cap-buf-sz",      NULL, 1UL<<20                      );
+  ulong        cap_buf_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--cap-buf-cnt",     NULL, 8UL                          );
+  long         duration     = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",        NULL, (long)10e9                   );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz"  ));
+  if( FD_UNLIKELY( (tx_mtu<16UL) | (tx_mtu>(ulong)USHORT_MAX) ) ) FD_LOG_ERR(( "--tx-mtu should be in [16,USHORT_MAX]" ));
+  if( FD_UNLIKELY( (cap_snap_len<16UL) | (cap_snap_len>(ulong)USHORT_MAX) ) ) FD_LOG_ERR(( "--cap-snap-len should be in [16,USHORT_MAX]" ));
+
+  if( FD_UNLIKELY( fd_tile_cnt()<3UL ) ) FD_LOG_ERR(( "this unit test requires at least 3 tiles" ));
+
+  long  hb0  = fd_tickcount();
+  ulong seq0 = fd_rng_ulong( rng );
+
+  test_cfg_t cfg[1];
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  cfg->wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( cfg->wksp );
+
+  FD_LOG_NOTICE(( "Creating tx mcache (--tx-depth %lu, app_sz 0, seq0 %lu)", tx_depth, seq0 ));
+  cfg->tx_mcache = fd_mcache_join( fd_mcache_new( fd_wksp_alloc_laddr( cfg->wksp,
+                                                                       fd_mcache_align(), fd_mcache_footprint( tx_depth, 0UL ),
+                                                                       1UL ),
+                                                  tx_depth, 0UL, seq0 ) );
+  FD_TEST( cfg->tx_mcache );
+
+  FD_LOG_NOTICE(( "Creating tx dcache (--tx-mtu %lu, burst 1, compact 1, app_sz 0)", tx_mtu ));
+  ulong tx_data_sz = fd_dcache_req_data_sz( tx_mtu, tx_depth, 1UL, 1 ); FD_TEST( tx_data_sz );
+  cfg->tx_dcache = fd_dcache_join( fd_dcache_new( fd_wksp_alloc_laddr( cfg->wksp,
+                                                                       fd_dcache_align(), fd_dcache_footprint( tx_data_sz, 0UL ),
+                                                                       1UL ),
+                                                  tx_data_sz, 0UL ) );
+  FD_TEST( cfg->tx_dcache );
+
+  cfg->tx_mtu  = tx_mtu;
+  cfg->tx_cnt  = tx_cnt;
+  cfg->tx_rate = tx_rate;
+  cfg->tx_seq0 = seq0;
+
+  FD_LOG_NOTICE(( "Creating cap cnc (app_sz %lu, type 0, heartbeat0 %li)", FD_CNC_DIAG_TICKS_APP_SZ, hb0 ));
+  cfg->cap_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( FD_CNC_DIAG_TICKS_APP_SZ ), 1UL ),
+                                          FD_CNC_DIAG_TICKS_APP_SZ, 0UL, hb0 ) );
+  FD_TEST( cfg->cap_cnc );
+
+  FD_LOG_NOTICE(( "Creating cap fseq (seq0 %lu)", seq0 ));
+  cfg->cap_fseq = fd_fseq_join( fd_fseq_new( fd_wksp_alloc_laddr( cfg->wksp, fd_fseq_align(), fd_fseq_footprint(), 1UL ), seq0 ) );
+  FD_TEST( cfg->cap_fseq );
+
+  cfg->cap_path        = cap_path;
+  cfg->cap_file_cnt    = cap_file_cnt;
+  cfg->cap_file_sz_max = cap_file_max;
+  cfg->cap_snap_len    = cap_snap_len;
+  cfg->cap_direct      = cap_direct;
+  cfg->cap_buf_sz      = cap_buf_sz;
+  cfg->cap_buf_cnt     = cap_buf_cnt;
+  cfg->cap_seed        = rng_seq++;
+
+  FD_LOG_NOTICE(( "Creating cap scratch (--cap-buf-sz %lu, --cap-buf-cnt %lu)", cap_buf_sz, cap_buf_cnt ));
+  ulong cap_scratch_footprint = fd_capture_tile_scratch_footprint( cap_buf_sz, cap_buf_cnt ); FD_TEST( cap_scratch_footprint );
+  cfg->cap_scratch = fd_wksp_alloc_laddr( cfg->wksp, fd_capture_tile_scratch_align(), cap_scratch_footprint, 1UL );
+  FD_TEST( cfg->cap_scratch );
+
+  FD_LOG_NOTICE(( "Booting" ));
+
+  fd_tile_exec_t * cap_exec = fd_tile_exec_new( 1UL, cap_tile_main, 0, (char **)fd_type_pun( cfg ) ); FD_TEST( cap_exec );
+  FD_TEST( fd_cnc_wait( cfg->cap_cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+
+  FD_LOG_NOTICE(( "Running (--tx-cnt %lu, --tx-rate %g, --cap-path %s, --cap-file-cnt %lu, --cap-file-sz-max %lu, "
+                  "--cap-snap-len %lu, --cap-direct %i)",
+                  tx_cnt, (double)tx_rate, cap_path, cap_file_cnt, cap_file_max, cap_snap_len, cap_direct ));
+
+  long ts_lo = fd_log_wallclock();
+
+  fd_tile_exec_t * tx_exec = fd_tile_exec_new( 2UL, tx_tile_main, 0, (char **)fd_type_pun( cfg ) ); FD_TEST( tx_exec );
+
+  int ret;
+  FD_TEST( !fd_tile_exec_delete( tx_exec, &ret ) ); FD_TEST( !ret );
+
+  /* Wait for the capture to catch up to the end of the stream (or give
+     up at the end of duration) */
+
+  ulong seq1 = fd_seq_inc( seq0, tx_cnt );
+  long  done = fd_log_wallclock() + duration;
+  for(;;) {
+    if( !fd_seq_lt( fd_fseq_query( cfg->cap_fseq ), seq1 ) ) break;
+    if( FD_UNLIKELY( (fd_log_wallclock()-done)>=0L ) ) { FD_LOG_NOTICE(( "capture did not catch up before duration" )); break; }
+    FD_YIELD();
+  }
+
+  FD_LOG_NOTICE(( "Halting" ));
+
+  FD_TEST( !fd_cnc_open( cfg->cap_cnc ) );
+  fd_cnc_signal( cfg->cap_cnc, FD_CNC_SIGNAL_HALT );
+  FD_TEST( fd_cnc_wait( cfg->cap_cnc, FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+  fd_cnc_close( cfg->cap_cnc );
+
+  FD_TEST( !fd_tile_exec_delete( cap_exec, &ret ) ); FD_TEST( !ret );
+
+  long ts_hi = fd_log_wallclock();
+
+  ulong const * cnc_diag  = (ulong const *)fd_cnc_app_laddr_const( cfg->cap_cnc );
+  ulong const * fseq_diag = (ulong const *)fd_fseq_app_laddr_const( cfg->cap_fseq );
+  ulong pub_cnt        = fseq_diag[ FD_FSEQ_DIAG_PUB_CNT                 ];
+  ulong filt_cnt       = fseq_diag[ FD_FSEQ_DIAG_FILT_CNT                ];
+  ulong disk_drop_cnt  = cnc_diag [ FD_CAPTURE_CNC_DIAG_DISK_DROP_CNT    ];
+  ulong ovrn_drop_cnt  = cnc_diag [ FD_CAPTURE_CNC_DIAG_OVRN_DROP_CNT    ];
+  ulong file_cnt       = cnc_diag [ FD_CAPTURE_CNC_DIAG_FILE_CNT         ];
+  ulong write_sz       = cnc_diag [ FD_CAPTURE_CNC_DIAG_WRITE_SZ         ];
+  ulong write_err_cnt  = cnc_diag [ FD_CAPTURE_CNC_DIAG_WRITE_ERR_CNT    ];
+  FD_LOG_NOTICE(( "cap: pub_cnt %lu filt_cnt %lu disk_drop_cnt %lu ovrn_drop_cnt %lu file_cnt %lu write_sz %lu write_err_cnt %lu",
+                  pub_cnt, filt_cnt, disk_drop_cnt, ovrn_drop_cnt, file_cnt, write_sz, write_err_cnt ));
+
+  FD_TEST( !write_err_cnt );
+  FD_TEST( pub_cnt + disk_drop_cnt<=tx_cnt );
+  FD_TEST( file_cnt>=1UL );
+
+  /* Check the capture files.  Every captured frag should be in the
+     files in sequence order with the right size, payload and a sane
+     timestamp.  The files are parsed directly (rather than with a
+     fd_pcap_mem_iter_t) such that truncated packets can be checked. */
+
+  if( FD_UNLIKELY( file_cnt>cap_file_cnt ) ) FD_LOG_WARNING(( "capture files wrapped, skipping capture file checks" ));
+  else {
+    ulong cnt      = 0UL;
+    ulong seq_last = fd_seq_dec( seq0, 1UL );
+    for( ulong file_idx=0UL; file_idx<file_cnt; file_idx++ ) {
+      char name[ 4096 ];
+      FD_TEST( fd_cstr_printf( name, 4096UL, NULL, "%s.%lu.pcap", cap_path, file_idx ) );
+
+      ulong         map_sz;
+      uchar const * map = (uchar const *)fd_pcap_map( name, &map_sz ); FD_TEST( map );
+      FD_TEST( !cap_file_max || map_sz<=fd_ulong_max( cap_file_max, FD_PCAP_HDR_SZ+FD_PCAP_PKT_HDR_SZ+cap_snap_len ) );
+
+      uchar hdr[ FD_PCAP_HDR_SZ ];
+      fd_pcap_hdr_init( hdr, (uint)cap_snap_len, FD_PCAP_LINK_TYPE_ETHERNET );
+      FD_TEST( map_sz>=FD_PCAP_HDR_SZ && !memcmp( map, hdr, FD_PCAP_HDR_SZ ) );
+
+      ulong off      = FD_PCAP_HDR_SZ;
+      ulong file_rec = 0UL;
+      while( off<map_sz ) {
+        FD_TEST( off+FD_PCAP_PKT_HDR_SZ<=map_sz );
+        long  ts      = (long)FD_LOAD( uint, map+off )*(long)1e9 + (long)FD_LOAD( uint, map+off+4UL );
+        ulong sz      = (ulong)FD_LOAD( uint, map+off+ 8UL );
+        ulong orig_sz = (ulong)FD_LOAD( uint, map+off+12UL );
+        off += FD_PCAP_PKT_HDR_SZ;
+        FD_TEST( (16UL<=sz) & (sz<=orig_sz) & (off+sz<=map_sz) );
+
+        uchar const * p   = map + off;
+        ulong         seq = FD_LOAD( ulong, p );
+        FD_TEST( fd_seq_gt( seq, seq_last ) );
+        FD_TEST( fd_seq_lt( seq, seq1     ) );
+        FD_TEST( orig_sz==test_frag_sz( seq, tx_mtu )           );
+        FD_TEST( sz     ==fd_ulong_min( orig_sz, cap_snap_len ) );
+        for( ulong i=8UL; i<sz; i++ ) FD_TEST( p[i]==test_frag_byte( seq, i ) );
+        FD_TEST( (ts_lo-(long)1e9)<=ts && ts<=(ts_hi+(long)1e9) );
+
+        off     += sz;
+        seq_last = seq;
+        file_rec++;
+      }
+      FD_TEST( file_rec ); /* Files always get at least one packet */
+      fd_pcap_unmap( map, map_sz );
+      FD_TEST( !unlink( name ) );
+      cnt += file_rec;
+    }
+    FD_TEST( cnt==pub_cnt );
+    FD_LOG_NOTICE(( "cap: %lu packets in %lu files verified", cnt, file_cnt ));
+  }
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  fd_wksp_free_laddr( cfg->cap_scratch );
+  fd_wksp_free_laddr( fd_fseq_delete  ( fd_fseq_leave  ( cfg->cap_fseq  ) ) );
+  fd_wksp_free_laddr( fd_cnc_delete   ( fd_cnc_leave   ( cfg->cap_cnc   ) ) );
+  fd_wksp_free_laddr( fd_dcache_delete( fd_dcache_leave( cfg->tx_dcache ) ) );
+  fd_wksp_free_laddr( fd_mcache_delete( fd_mcache_leave( cfg->tx_mcache ) ) );
+
+  fd_wksp_delete_anonymous( cfg->wksp );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -72,6 +72,8 @@ fd_dedup_tile_in_update( fd_dedup_tile_in_t * in,
   }))
 
 FD_STATIC_ASSERT( alignof(fd_dedup_tile_in_t)<=FD_DEDUP_TILE_SCRATCH_ALIGN, packing );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_DEDUP_CNC_DIAG_SKIP_CNT ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_DEDUP_CNC_DIAG_SKIP_SZ  ), layout );
 
 ulong
 fd_dedup_tile_scratch_align( void ) {
@@ -98,6 +100,8 @@ fd_dedup_tile( fd_cnc_t *              cnc,
                fd_frag_meta_t const ** in_mcache,
                ulong **                in_fseq,
                fd_tcache_t *           tcache,
+               ulong                   shard_idx,
+               ulong                   shard_cnt,
                fd_frag_meta_t *        mcache,
                ulong                   out_cnt,
                ulong **                _out_fseq,
@@ -107,9 +111,20 @@ fd_dedup_tile( fd_cnc_t *              cnc,
                void *                  scratch ) {
 
   /* cnc state */
-  ulong * cnc_diag;           /* ==fd_cnc_app_laddr( cnc ), local address of the dedup tile cnc diagnostic region */
-  ulong   cnc_diag_in_backp;  /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
-  ulong   cnc_diag_backp_cnt; /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  ulong * cnc_diag;             /* ==fd_cnc_app_laddr( cnc ), local address of the dedup tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;    /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt;   /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  int     cnc_diag_ticks_en;    /* 1 if cnc app region has room for the standard duty cycle diagnostics, 0 otherwise */
+  ulong   cnc_diag_spin_ticks;  /* Accumulates ticks spent caught up between housekeeping events */
+  ulong   cnc_diag_work_ticks;  /* Accumulates ticks spent processing frags between housekeeping events */
+  ulong   cnc_diag_backp_ticks; /* Accumulates ticks spent backpressured between housekeeping events */
+  ulong   cnc_diag_hkeep_ticks; /* Accumulates ticks spent doing housekeeping between housekeeping events */
+  ulong   cnc_diag_skip_cnt;    /* Accumulates number of frags skipped as owned by other shards between housekeeping events */
+  ulong   cnc_diag_skip_sz;     /* Accumulates payload bytes of frags skipped as owned by other shards between housekeeping events */
+  fd_perf_t   _perf[1];         /* perf state, local to the tile */
+  fd_perf_t * perf;             /* Samples the tile's hardware performance counters, NULL if not sampling */
+  ulong * cnc_lhist_orig;       /* ==fd_lhist_cnc_orig( cnc ), where to accumulate in frag tsorig latencies, NULL if not enabled */
+  ulong * cnc_lhist_pub;        /* ==fd_lhist_cnc_pub ( cnc ), where to accumulate in frag tspub  latencies, NULL if not enabled */
 
   /* in frag stream state */
   ulong              in_seq; /* current position in input poll sequence, in [0,in_cnt) */
@@ -169,11 +184,25 @@ fd_dedup_tile( fd_cnc_t *              cnc,
 
     cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
 
+    /* Accumulate in frag latency histograms if the cnc app region has
+       room for them */
+    cnc_lhist_orig = fd_lhist_cnc_orig( cnc );
+    cnc_lhist_pub  = fd_lhist_cnc_pub ( cnc );
+    FD_LOG_INFO(( "%s latency histograms", cnc_lhist_orig ? "Accumulating" : "Not accumulating" ));
+
     /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
        cleared during first housekeeping if credits available */
     cnc_diag_in_backp  = 1UL;
     cnc_diag_backp_cnt = 0UL;
 
+    cnc_diag_ticks_en    = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_TICKS_APP_SZ;
+    cnc_diag_spin_ticks  = 0UL;
+    cnc_diag_work_ticks  = 0UL;
+    cnc_diag_backp_ticks = 0UL;
+    cnc_diag_hkeep_ticks = 0UL;
+    cnc_diag_skip_cnt    = 0UL;
+    cnc_diag_skip_sz     = 0UL;
+
     /* in frag stream init */
 
     in_seq = 0UL; /* First in to poll */
@@ -208,6 +237,14 @@ fd_dedup_tile( fd_cnc_t *              cnc,
 
     if( FD_UNLIKELY( !tcache ) ) { FD_LOG_WARNING(( "NULL tcache" )); return 1; }
 
+    if( !shard_cnt ) shard_cnt = 1UL; /* unsharded */
+    if( FD_UNLIKELY( shard_cnt>FD_DEDUP_TILE_SHARD_MAX ) ) { FD_LOG_WARNING(( "shard_cnt too large" )); return 1; }
+    if( FD_UNLIKELY( shard_idx>=shard_cnt ) ) {
+      FD_LOG_WARNING(( "shard_idx %lu must be in [0,%lu)", shard_idx, shard_cnt ));
+      return 1;
+    }
+    FD_LOG_INFO(( "Deduping shard %lu of %lu", shard_idx, shard_cnt ));
+
     tcache_depth   = fd_tcache_depth       ( tcache );
     tcache_map_cnt = fd_tcache_map_cnt     ( tcache );
     _tcache_sync   = fd_tcache_oldest_laddr( tcache );
@@ -324,6 +361,11 @@ fd_dedup_tile( fd_cnc_t *              cnc,
     async_min = fd_tempo_async_min( lazy, event_cnt, (float)fd_tempo_tick_per_ns( NULL ) );
     if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
 
+    /* Sample the tile's hardware performance counters if the cnc app
+       region has room for them and they are available on this host */
+    perf = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ? fd_perf_open( _perf ) : NULL;
+    FD_LOG_INFO(( "%s performance counters", perf ? "Sampling" : "Not sampling" ));
+
   } while(0);
 
   FD_LOG_INFO(( "Running dedup" ));
@@ -335,6 +377,7 @@ fd_dedup_tile( fd_cnc_t *              cnc,
     /* Do housekeeping at a low rate in the background */
 
     if( FD_UNLIKELY( (now-then)>=0L ) ) {
+      FD_TRACE( now, FD_TRACE_ID_HKEEP, 0UL, 0U, 0UL );
       ulong event_idx = (ulong)event_map[ event_seq ];
 
       /* Do the next async event.  event_idx:
@@ -386,8 +429,23 @@ fd_dedup_tile( fd_cnc_t *              cnc,
         FD_COMPILER_MFENCE();
         cnc_diag[ FD_CNC_DIAG_IN_BACKP  ]  = cnc_diag_in_backp;
         cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] += cnc_diag_backp_cnt;
+        if( FD_LIKELY( cnc_diag_ticks_en ) ) {
+          cnc_diag[ FD_CNC_DIAG_SPIN_TICKS  ] += cnc_diag_spin_ticks;
+          cnc_diag[ FD_CNC_DIAG_WORK_TICKS  ] += cnc_diag_work_ticks;
+          cnc_diag[ FD_CNC_DIAG_BACKP_TICKS ] += cnc_diag_backp_ticks;
+          cnc_diag[ FD_CNC_DIAG_HKEEP_TICKS ] += cnc_diag_hkeep_ticks;
+          cnc_diag[ FD_DEDUP_CNC_DIAG_SKIP_CNT ] += cnc_diag_skip_cnt;
+          cnc_diag[ FD_DEDUP_CNC_DIAG_SKIP_SZ  ] += cnc_diag_skip_sz;
+        }
+        if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_CNC_DIAG_PERF_CYCLES );
         FD_COMPILER_MFENCE();
-        cnc_diag_backp_cnt = 0UL;
+        cnc_diag_backp_cnt   = 0UL;
+        cnc_diag_spin_ticks  = 0UL;
+        cnc_diag_work_ticks  = 0UL;
+        cnc_diag_backp_ticks = 0UL;
+        cnc_diag_hkeep_ticks = 0UL;
+        cnc_diag_skip_cnt    = 0UL;
+        cnc_diag_skip_sz     = 0UL;
 
         /* Receive command-and-control signals */
         ulong s = fd_cnc_signal_query( cnc );
@@ -454,7 +512,8 @@ fd_dedup_tile( fd_cnc_t *              cnc,
         }
       }
 
-      /* Reload housekeeping timer */
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, cnc_diag_hkeep_ticks );
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
 
@@ -467,17 +526,18 @@ fd_dedup_tile( fd_cnc_t *              cnc,
        from not backpressured to backpressured. */
 
     if( FD_UNLIKELY( cr_avail<=cr_filt ) ) {
+      if( FD_UNLIKELY( !cnc_diag_in_backp ) ) FD_TRACE( now, FD_TRACE_ID_BACKP, seq, 0U, 0UL );
       cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
       cnc_diag_in_backp   = 1UL;
       FD_SPIN_PAUSE();
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_backp_ticks );
       continue;
     }
     cnc_diag_in_backp = 0UL;
 
     /* Select which in to poll next (randomized round robin) */
 
-    if( FD_UNLIKELY( !in_cnt ) ) { now = fd_tickcount(); continue; }
+    if( FD_UNLIKELY( !in_cnt ) ) { FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks ); continue; }
     fd_dedup_tile_in_t * this_in = &in[ in_seq ];
     in_seq++;
     if( in_seq>=in_cnt ) in_seq = 0UL; /* cmov */
@@ -496,9 +556,10 @@ fd_dedup_tile( fd_cnc_t *              cnc,
       if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (impossible if in is honoring our flow control) */
         this_in->seq = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
         this_in->accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+        FD_TRACE( now, FD_TRACE_ID_OVRN, seq_found, 0U, 0UL );
       }
       /* Don't bother with spin as polling multiple locations */
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks );
       continue;
     }
 
@@ -517,6 +578,7 @@ fd_dedup_tile( fd_cnc_t *              cnc,
     ulong sz       = (ulong)this_in_mline->sz;
     ulong ctl      = (ulong)this_in_mline->ctl;
     ulong tsorig   = (ulong)this_in_mline->tsorig;
+    ulong in_tspub = (ulong)this_in_mline->tspub;
     FD_COMPILER_MFENCE();
     ulong seq_test =        this_in_mline->seq;
     FD_COMPILER_MFENCE();
@@ -524,18 +586,24 @@ fd_dedup_tile( fd_cnc_t *              cnc,
     if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading (impossible if this_in honoring our fctl) */
       this_in->seq = seq_test; /* Resume from here (probably reasonably current, could query in mcache sync instead) */
       this_in->accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+      FD_TRACE( now, FD_TRACE_ID_OVRN, seq_test, 0U, 0UL );
       /* Don't bother with spin as polling multiple locations */
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
       continue;
     }
 
     /* We have successfully loaded the metadata.  Decide whether it
-       is interesting downstream and publish or filter accordingly. */
-
-    int is_dup;
-    FD_TCACHE_INSERT( is_dup, tcache_sync, _tcache_ring, tcache_depth, _tcache_map, tcache_map_cnt, sig );
-    if( FD_UNLIKELY( is_dup ) ) { /* Optimize for forwarding path */
-      now = fd_tickcount();
+       is interesting downstream and publish or filter accordingly.
+       Frags owned by other shards are skipped without touching the
+       tcache (for an unsharded dedup, every frag is owned by shard 0).
+       These are filtered for flow control purposes but are not
+       duplicates (see diagnostics below). */
+
+    int is_mine = (fd_dedup_shard_idx( sig, shard_cnt )==shard_idx);
+    int is_dup  = 0;
+    if( FD_LIKELY( is_mine ) ) FD_TCACHE_INSERT( is_dup, tcache_sync, _tcache_ring, tcache_depth, _tcache_map, tcache_map_cnt, sig );
+    FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+    if( FD_UNLIKELY( is_dup | !is_mine ) ) { /* Optimize for forwarding path */
       /* If there are any frags from this in that are currently exposed
          downstream, this frag needs to be taken into acount in the flow
          control info we send to this in (see note above).  Since we do
@@ -547,23 +615,39 @@ fd_dedup_tile( fd_cnc_t *              cnc,
          any in).  If cr_avail<cr_max, we assume the worst (that all
          exposed_frags are from this in) and increment cr_filt. */
       cr_filt += (ulong)(cr_avail<cr_max);
+      FD_TRACE( now, FD_TRACE_ID_FILT, this_in_seq, sz, sig );
     } else {
-      now = fd_tickcount();
       ulong tspub = (ulong)fd_frag_meta_ts_comp( now );
       fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+      FD_TRACE( now, FD_TRACE_ID_PUB, seq, sz, sig );
       cr_avail--;
       seq = fd_seq_inc( seq, 1UL );
     }
 
+    /* Accumulate the latency histograms.  This reuses the timestamp
+       taken above (i.e. is the time the frag was processed) and touches
+       a couple of tile owned cache lines that are only rarely read by
+       monitors. */
+
+    if( FD_LIKELY( cnc_lhist_orig ) ) {
+      fd_lhist_sample( cnc_lhist_orig, fd_lhist_ts_lat( tsorig,   now ) );
+      fd_lhist_sample( cnc_lhist_pub,  fd_lhist_ts_lat( in_tspub, now ) );
+    }
+
     /* Windup for the next in poll and accumulate diagnostics */
 
     this_in_seq    = fd_seq_inc( this_in_seq, 1UL );
     this_in->seq   = this_in_seq;
     this_in->mline = this_in->mcache + fd_mcache_line_idx( this_in_seq, this_in->depth );
 
-    ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + 2UL*(ulong)is_dup;
-    this_in->accum[ diag_idx     ]++;
-    this_in->accum[ diag_idx+1UL ] += (uint)sz;
+    if( FD_LIKELY( is_mine ) ) {
+      ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + 2UL*(ulong)is_dup;
+      this_in->accum[ diag_idx     ]++;
+      this_in->accum[ diag_idx+1UL ] += (uint)sz;
+    } else {
+      cnc_diag_skip_cnt++;
+      cnc_diag_skip_sz += sz;
+    }
   }
 
   do {
@@ -576,6 +660,8 @@ fd_dedup_tile( fd_cnc_t *              cnc,
       fd_dedup_tile_in_update( this_in, 0UL ); /* exposed_cnt 0 assumes all reliable consumers caught up or shutdown */
     }
 
+    if( FD_LIKELY( perf ) ) fd_perf_close( perf );
+
     FD_LOG_INFO(( "Halted dedup" ));
     fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
 
@@ -585,5 +671,4 @@ fd_dedup_tile( fd_cnc_t *              cnc,
 }
 
 #undef SCRATCH_ALLOC
-
 #endif
@@ -21,6 +21,16 @@
 
 #define FD_DEDUP_CNC_SIGNAL_ACK (4UL)
 
+/* FD_DEDUP_CNC_DIAG_* specify where a sharded dedup tile accumulates
+   the frags it skipped because they are owned by another shard (see
+   fd_dedup_tile below).  These use application specific slots on the
+   second cache line of the cnc application region and are only
+   accumulated if the cnc application region is at least
+   FD_CNC_DIAG_TICKS_APP_SZ bytes.  An unsharded dedup never skips. */
+
+#define FD_DEDUP_CNC_DIAG_SKIP_CNT (12UL) /* updated by the tile, at housekeeping */
+#define FD_DEDUP_CNC_DIAG_SKIP_SZ  (13UL) /* " */
+
 /* FD_DEDUP_TILE_IN_MAX and FD_DEDUP_TILE_OUT_MAX are the maximum number
    of inputs and outputs respectively that a dedup tile can have.  These
    limits are more or less arbitrary from a functional correctness POV.
@@ -32,6 +42,13 @@
 #define FD_DEDUP_TILE_IN_MAX  FD_FRAG_META_ORIG_MAX
 #define FD_DEDUP_TILE_OUT_MAX FD_FRAG_META_ORIG_MAX
 
+/* FD_DEDUP_TILE_SHARD_MAX is the maximum number of dedup tiles that can
+   partition the sig space of a group of frag streams between them (see
+   fd_dedup_shard_idx below).  Like the above, this is mostly arbitrary
+   and exists to give configuration bugs something to trip over. */
+
+#define FD_DEDUP_TILE_SHARD_MAX (256UL)
+
 /* FD_DEDUP_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
    footprint needed for a dedup tile scratch region that can support
    in_cnt mcaches and out_cnt reliable outputs.  ALIGN is an integer
@@ -55,6 +72,20 @@
 
 FD_PROTOTYPES_BEGIN
 
+/* fd_dedup_shard_idx returns which of shard_cnt dedup shards owns frags
+   with signature sig.  Assumes shard_cnt is in [1,2^32].  Result will
+   be in [0,shard_cnt).  The shard is picked from the high 32 bits of
+   sig (multiplicatively such that shard_cnt need not be a power of 2).
+   tcache maps index by the low bits of sig so, for sigs with
+   uncorrelated bits, the sigs a shard owns are still uniformly spread
+   over its tcache map slots.  shard_cnt 1 puts everything in shard 0. */
+
+FD_FN_CONST static inline ulong
+fd_dedup_shard_idx( ulong sig,
+                    ulong shard_cnt ) {
+  return ((sig>>32)*shard_cnt)>>32;
+}
+
 /* fd_dedup_tile deduplicates multiple fragment streams described by the
    in_mcaches into a single out_mcache that can be consumed by out_cnt
    reliable consumers and an arbitrary number of unreliable consumers.
@@ -100,6 +131,22 @@ FD_PROTOTYPES_BEGIN
    to avoid starvation and minimize slip between different groups of
    streams).
 
+   Dedup can be sharded over multiple tiles to scale past the insert
+   rate of a single tcache.  shard_cnt dedup tiles each consume all the
+   in_mcaches (as reliable consumers of each), each with its own tcache
+   and out mcache.  The tile with shard_idx only dedups and forwards
+   frags for which fd_dedup_shard_idx( sig, shard_cnt )==shard_idx and
+   skips all other frags.  Skipped frags are not accumulated in the in
+   fseq pub / filt diagnostics (such that the filt diagnostics still
+   count only actual duplicates) but in FD_DEDUP_CNC_DIAG_SKIP_{CNT,SZ}
+   of the tile's cnc.  As the sig determines the shard,
+   duplicates always meet in the same tcache and the union of the shard
+   out streams is the same set of frags an unsharded dedup would
+   produce (given each shard's tcache has a depth at least the
+   unsharded depth over shard_cnt).  The out streams can then be merged
+   with a mux tile.  shard_cnt 0 or 1 (with shard_idx 0) is a normal
+   unsharded dedup.  The ordering guarantees below apply per shard.
+
    The sig, chunk, sz, ctl and tsorig input fragment metadata will be
    unchanged by this tile.
 
@@ -221,6 +268,15 @@ FD_PROTOTYPES_BEGIN
    and outputs also use their cnc and fseq application regions similarly
    for monitoring simplicity / consistency.
 
+   The tile also accumulates the standard duty cycle, hardware
+   performance counter and latency histogram diagnostics (the latter
+   across all ins) as its cnc application region size permits (see
+   fd_cnc.h).
+
+   If built with FD_HAS_TRACE, the tile records FD_TRACE_ID_{PUB,FILT,
+   OVRN,BACKP,HKEEP} events into the calling thread's trace (see
+   fd_trace.h), if any.
+
    The lifetime of the cnc, mcaches, fseqs, tcache, rng and scratch used
    by this tile should be a superset of this tile's lifetime.  While
    this tile is running, no other tile should use cnc for its command
@@ -251,6 +307,8 @@ fd_dedup_tile( fd_cnc_t *              cnc,       /* Local join to the dedup's c
                fd_frag_meta_t const ** in_mcache, /* in_mcache[in_idx] is the local join to input in_idx's mcache */
                ulong **                in_fseq,   /* in_fseq  [in_idx] is the local join to input in_idx's fseq */
                fd_tcache_t *           tcache,    /* Local join to the dedup's unique signature cache */
+               ulong                   shard_idx, /* Which sig shard this dedup handles, in [0,shard_cnt) */
+               ulong                   shard_cnt, /* Number of dedup shards, 0 or 1 means unsharded */
                fd_frag_meta_t *        mcache,    /* Local join to the dedup's frag stream output mcache */
                ulong                   out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
                ulong **                out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
@@ -15,6 +15,8 @@ main( int     argc,
   char const * _in_mcaches = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-mcaches", NULL, ""   );
   char const * _in_fseqs   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-fseqs",   NULL, ""   );
   char const * _tcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--tcache",     NULL, NULL );
+  ulong        shard_idx   = fd_env_strip_cmdline_ulong( &argc, &argv, "--shard-idx",  NULL, 0UL  );
+  ulong        shard_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--shard-cnt",  NULL, 1UL  );
   char const * _mcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",     NULL, NULL );
   char const * _out_fseqs  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",  NULL, ""   );
   ulong        cr_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",     NULL, 0UL  ); /*   0 <> use default */
@@ -69,7 +71,9 @@ main( int     argc,
     if( FD_UNLIKELY( !out_fseq[ out_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
   }
 
-  FD_LOG_NOTICE(( "Using --cr-max %lu, --lazy %li", cr_max, lazy ));
+  FD_LOG_NOTICE(( "Using --shard-idx %lu, --shard-cnt %lu, --cr-max %lu, --lazy %li", shard_idx, shard_cnt, cr_max, lazy ));
+
+  fd_trace_t * trace = fd_trace_join_from_args( &argc, &argv ); /* No --trace <> no tracing */
 
   FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
   fd_rng_t _rng[1];
@@ -87,13 +91,14 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Run" ));
 
-  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, tcache, mcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  int err = fd_dedup_tile( cnc, in_cnt, in_mcache, in_fseq, tcache, shard_idx, shard_cnt, mcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
 
   FD_LOG_NOTICE(( "Fini" ));
 
   fd_shmem_release( scratch, page_sz, page_cnt );
   fd_rng_delete( fd_rng_leave( rng ) );
+  fd_trace_leave_from_args( trace );
   for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_fseq_leave( out_fseq[ out_idx-1UL ] ) );
   fd_wksp_unmap( fd_mcache_leave( mcache ) );
   fd_wksp_unmap( fd_tcache_leave( tcache ) );
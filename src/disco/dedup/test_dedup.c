@@ -23,15 +23,16 @@ struct test_cfg {
   uchar *     tx_dcache_mem;   ulong tx_dcache_footprint;
   uchar *     tx_fctl_mem;     ulong tx_fctl_footprint;
 
-  uchar *     dedup_cnc_mem;
-  uchar *     dedup_tcache_mem;
-  uchar *     dedup_mcache_mem;
-  uchar *     dedup_scratch_mem;
+  ulong       dedup_cnt;
+  uchar *     dedup_cnc_mem;     ulong dedup_cnc_footprint;
+  uchar *     dedup_tcache_mem;  ulong dedup_tcache_footprint;
+  uchar *     dedup_mcache_mem;  ulong dedup_mcache_footprint;
+  uchar *     dedup_scratch_mem; ulong dedup_scratch_footprint;
   ulong       dedup_cr_max;
   long        dedup_lazy;
   uint        dedup_seed;
 
-  ulong       rx_cnt;
+  ulong       rx_cnt; /* per dedup */
   int         rx_lazy;
   uchar *     rx_cnc_mem;      ulong rx_cnc_footprint;
   uchar *     rx_rng_mem;      ulong rx_rng_footprint;
@@ -80,15 +81,20 @@ tx_tile_main( int     argc,
   ulong   wmark  = fd_dcache_compact_wmark ( wksp, dcache, cfg->pkt_framing + cfg->pkt_payload_max );
   ulong   chunk  = chunk0;
 
-  /* Hook up to the tx flow control inputs */
-  ulong * fseq      = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint );
-  ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
-
-  FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL;
+  /* Hook up to the tx flow control inputs (one per dedup) */
+  ulong   dedup_cnt = cfg->dedup_cnt;
+  ulong * fseq[ FD_DEDUP_TILE_SHARD_MAX ];
+  ulong * fseq_diag[ FD_DEDUP_TILE_SHARD_MAX ];
+  for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ ) {
+    fseq     [ dedup_idx ] = fd_fseq_join( cfg->tx_fseq_mem + (tx_idx*dedup_cnt+dedup_idx)*cfg->tx_fseq_footprint );
+    fseq_diag[ dedup_idx ] = (ulong *)fd_fseq_app_laddr( fseq[ dedup_idx ] );
+    FD_VOLATILE( fseq_diag[ dedup_idx ][ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL;
+  }
 
   /* Hook up to the tx flow control state */
   fd_fctl_t * fctl = fd_fctl_join( cfg->tx_fctl_mem + tx_idx*cfg->tx_fctl_footprint );
-  fd_fctl_cfg_rx_add( fctl, depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] );
+  for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ )
+    fd_fctl_cfg_rx_add( fctl, depth, fseq[ dedup_idx ], &fseq_diag[ dedup_idx ][ FD_FSEQ_DIAG_SLOW_CNT ] );
   fd_fctl_cfg_done( fctl, 1UL, 0UL, 0UL, 0UL );
   ulong cr_avail = 0UL;
 
@@ -146,9 +152,10 @@ tx_tile_main( int     argc,
         FD_LOG_NOTICE(( "%7.3f Mfrag/s tx (in_backp %lu backp_cnt %lu slow_cnt %lu)", (double)mfps,
                         FD_VOLATILE_CONST( cnc_diag[ FD_CNC_DIAG_IN_BACKP  ] ),
                         FD_VOLATILE_CONST( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ),
-                        fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ));
-        FD_VOLATILE( cnc_diag [ FD_CNC_DIAG_BACKP_CNT ] ) = 0UL;
-        FD_VOLATILE( fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL;
+                        fseq_diag[ 0 ][ FD_FSEQ_DIAG_SLOW_CNT ] ));
+        FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ) = 0UL;
+        for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ )
+          FD_VOLATILE( fseq_diag[ dedup_idx ][ FD_FSEQ_DIAG_SLOW_CNT ] ) = 0UL;
         diag_last = now;
         diag_iter = 0UL;
       }
@@ -263,13 +270,13 @@ tx_tile_main( int     argc,
 static int
 dedup_tile_main( int     argc,
                  char ** argv ) {
-  (void)argc;
-  test_cfg_t * cfg = (test_cfg_t *)argv;
+  ulong        dedup_idx = (ulong)(uint)argc;
+  test_cfg_t * cfg       = (test_cfg_t *)argv;
 
   if( FD_UNLIKELY( cfg->tx_cnt>128UL ) ) FD_LOG_ERR(( "update unit test for this large a tx_cnt" ));
   if( FD_UNLIKELY( cfg->rx_cnt>128UL ) ) FD_LOG_ERR(( "update unit test for this large a rx_cnt" ));
 
-  fd_cnc_t * cnc = fd_cnc_join( cfg->dedup_cnc_mem );
+  fd_cnc_t * cnc = fd_cnc_join( cfg->dedup_cnc_mem + dedup_idx*cfg->dedup_cnc_footprint );
 
   fd_frag_meta_t const * tx_mcache[ 128 ];
   for( ulong tx_idx=0UL; tx_idx<cfg->tx_cnt; tx_idx++ )
@@ -277,20 +284,21 @@ dedup_tile_main( int     argc,
 
   ulong * tx_fseq[ 128 ];
   for( ulong tx_idx=0UL; tx_idx<cfg->tx_cnt; tx_idx++ )
-    tx_fseq[ tx_idx ] = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint );
+    tx_fseq[ tx_idx ] = fd_fseq_join( cfg->tx_fseq_mem + (tx_idx*cfg->dedup_cnt+dedup_idx)*cfg->tx_fseq_footprint );
 
-  fd_tcache_t *    dedup_tcache = fd_tcache_join( cfg->dedup_tcache_mem );
-  fd_frag_meta_t * dedup_mcache = fd_mcache_join( cfg->dedup_mcache_mem );
+  fd_tcache_t *    dedup_tcache = fd_tcache_join( cfg->dedup_tcache_mem + dedup_idx*cfg->dedup_tcache_footprint );
+  fd_frag_meta_t * dedup_mcache = fd_mcache_join( cfg->dedup_mcache_mem + dedup_idx*cfg->dedup_mcache_footprint );
 
   ulong * rx_fseq[ 128 ];
   for( ulong rx_idx=0UL; rx_idx<cfg->rx_cnt; rx_idx++ )
-    rx_fseq[ rx_idx ] = fd_fseq_join( cfg->rx_fseq_mem + rx_idx*cfg->rx_fseq_footprint );
+    rx_fseq[ rx_idx ] = fd_fseq_join( cfg->rx_fseq_mem + (dedup_idx*cfg->rx_cnt+rx_idx)*cfg->rx_fseq_footprint );
 
   fd_rng_t _rng[1];
-  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->dedup_seed, 0UL ) );
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->dedup_seed + (uint)dedup_idx, 0UL ) );
 
-  int err = fd_dedup_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, dedup_tcache, dedup_mcache, cfg->rx_cnt, rx_fseq,
-                           cfg->dedup_cr_max, cfg->dedup_lazy, rng, cfg->dedup_scratch_mem );
+  int err = fd_dedup_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, dedup_tcache, dedup_idx, cfg->dedup_cnt,
+                           dedup_mcache, cfg->rx_cnt, rx_fseq, cfg->dedup_cr_max, cfg->dedup_lazy, rng,
+                           cfg->dedup_scratch_mem + dedup_idx*cfg->dedup_scratch_footprint );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_dedup_tile failed (%i)", err ));
 
   fd_rng_delete( fd_rng_leave( rng ) );
@@ -307,20 +315,23 @@ dedup_tile_main( int     argc,
 
 /* This uses the same methodology as test_frag_rx.c to process test
    traffic from multiple TX tiles via a DEDUP tile.  See test_frag_rx.c
-   for more details */
+   for more details.  rx_idx indexes all rxs over all dedups, the rxs of
+   dedup dedup_idx are [dedup_idx*rx_cnt,(dedup_idx+1)*rx_cnt). */
 
 static int
 rx_tile_main( int     argc,
               char ** argv ) {
-  ulong        rx_idx = (ulong)(uint)argc;
-  test_cfg_t * cfg    = (test_cfg_t *)argv;
-  fd_wksp_t *  wksp   = cfg->wksp;
+  ulong        rx_idx    = (ulong)(uint)argc;
+  test_cfg_t * cfg       = (test_cfg_t *)argv;
+  fd_wksp_t *  wksp      = cfg->wksp;
+  ulong        dedup_cnt = cfg->dedup_cnt;
+  ulong        dedup_idx = rx_idx / cfg->rx_cnt;
 
   /* Hook up to rx cnc */
   fd_cnc_t * cnc = fd_cnc_join( cfg->rx_cnc_mem + rx_idx*cfg->rx_cnc_footprint );
 
   /* Hook up to dedup mcache */
-  fd_frag_meta_t const * mcache = fd_mcache_join( cfg->dedup_mcache_mem );
+  fd_frag_meta_t const * mcache = fd_mcache_join( cfg->dedup_mcache_mem + dedup_idx*cfg->dedup_mcache_footprint );
   ulong                  depth  = fd_mcache_depth( mcache );
   ulong const *          sync   = fd_mcache_seq_laddr_const( mcache );
   ulong                  seq    = fd_mcache_seq_query( sync );
@@ -407,6 +418,7 @@ rx_tile_main( int     argc,
     int is_dup;
     FD_TCACHE_INSERT( is_dup, tcache_sync, _tcache_ring, tcache_depth, _tcache_map, tcache_map_cnt, sig );
     if( FD_UNLIKELY( is_dup ) ) FD_LOG_ERR(( "Received a duplicate" ));
+    if( FD_UNLIKELY( fd_dedup_shard_idx( sig, dedup_cnt )!=dedup_idx ) ) FD_LOG_ERR(( "Received a frag from another shard" ));
 
     (void)ctl; (void)tsorig; (void)tspub; (void)sz; (void)chunk; (void)wksp;
 
@@ -471,6 +483,7 @@ main( int     argc,
   ulong        tx_depth       = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",       NULL, 32768UL                    );
   ulong        tx_mtu         = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",         NULL, 1472UL                     );
   long         tx_lazy        = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",        NULL, 0L                         );
+  ulong        dedup_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--shard-cnt",      NULL, 1UL                        );
   ulong        tcache_depth   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-depth",   NULL, 4194302UL                  );
   ulong        tcache_map_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--tcache-map-cnt", NULL, 0UL /* use default */      );
   ulong        dedup_depth    = fd_env_strip_cmdline_ulong( &argc, &argv, "--dedup-depth",    NULL, 32768UL                    );
@@ -493,11 +506,13 @@ main( int     argc,
   if( FD_UNLIKELY( !page_sz                     ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
   if( FD_UNLIKELY( !tx_cnt                      ) ) FD_LOG_ERR(( "tx_cnt should be positive" ));
   if( FD_UNLIKELY( !rx_cnt                      ) ) FD_LOG_ERR(( "rx_cnt should be positive" ));
+  if( FD_UNLIKELY( !dedup_cnt                   ) ) FD_LOG_ERR(( "--shard-cnt should be positive" ));
+  if( FD_UNLIKELY( dedup_cnt>FD_DEDUP_TILE_SHARD_MAX ) ) FD_LOG_ERR(( "--shard-cnt too large" ));
   if( FD_UNLIKELY( tx_cnt>FD_DEDUP_TILE_IN_MAX  ) ) FD_LOG_ERR(( "--tx-cnt too large for this unit test" ));
   if( FD_UNLIKELY( rx_cnt>FD_DEDUP_TILE_OUT_MAX ) ) FD_LOG_ERR(( "--rx-cnt too large for this unit test" ));
   if( FD_UNLIKELY( test_depth>tcache_depth      ) ) FD_LOG_ERR(( "--test-depth should be at most --tcache-depth" ));
 
-  ulong tile_cnt = 1UL+tx_cnt+1UL+rx_cnt; /* 1 main(cnc,this) + tx_cnt tx_mains + 1 dedup_main + rx_cnt rx_mains */
+  ulong tile_cnt = 1UL+tx_cnt+dedup_cnt*(1UL+rx_cnt); /* 1 main(cnc,this) + tx_cnt tx_mains + dedup_cnt dedup_mains + dedup_cnt*rx_cnt rx_mains */
   if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
 
   FD_LOG_NOTICE(( "Configuring synthetic load (--burst-avg %g B --pkt-framing %lu B --pkt-payload-max %lu B --pkt-bw %g b/s "
@@ -530,20 +545,23 @@ main( int     argc,
   fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
   FD_TEST( wksp );
 
-  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, dedup-cnt 1, --rx-cnt %lu, app-sz 64)", tx_cnt, rx_cnt ));
-  ulong   cnc_footprint = fd_cnc_footprint( 64UL ); /* Room for 8 64-bit diagnostic counters */
-  uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), cnc_footprint*(tx_cnt+1UL+rx_cnt), 1UL );
+  ulong rx_tot = dedup_cnt*rx_cnt; /* --rx-cnt rxs per dedup */
+
+  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, --shard-cnt %lu, --rx-cnt %lu per shard, tx/rx app-sz 64, dedup app-sz %lu)",
+                  tx_cnt, dedup_cnt, rx_cnt, FD_LHIST_CNC_APP_SZ ));
+  ulong   cnc_footprint = fd_cnc_footprint( FD_LHIST_CNC_APP_SZ ); /* Room for the dedup's standard diagnostics (see fd_cnc.h) */
+  uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), cnc_footprint*(tx_cnt+dedup_cnt+rx_tot), 1UL );
   FD_TEST( cnc_mem );
 
   FD_LOG_NOTICE(( "Creating fseqs" ));
   ulong   fseq_footprint = fd_fseq_footprint();
-  uchar * fseq_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fseq_align(), fseq_footprint*(tx_cnt+rx_cnt), 1UL );
+  uchar * fseq_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fseq_align(), fseq_footprint*(tx_cnt*dedup_cnt+rx_tot), 1UL );
   FD_TEST( fseq_mem );
 
   FD_LOG_NOTICE(( "Creating rngs" ));
   ulong   rng_align     = fd_ulong_max( fd_rng_align(), 128UL ); /* overalign to avoid false sharing */
   ulong   rng_footprint = fd_ulong_align_up( fd_rng_footprint(), rng_align );
-  uchar * rng_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, rng_align, rng_footprint*(tx_cnt+rx_cnt), 1UL );
+  uchar * rng_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, rng_align, rng_footprint*(tx_cnt+rx_tot), 1UL );
   FD_TEST( rng_mem );
 
   FD_LOG_NOTICE(( "Creating tx mcaches (--tx-depth %lu, app-sz 0)", tx_depth ));
@@ -559,28 +577,29 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Creating tx fctls (--tx-depth %lu, app-sz 0)", tx_depth ));
   ulong   tx_fctl_align     = fd_ulong_max( fd_fctl_align(), 128UL ); /* overalign to avoid false sharing */
-  ulong   tx_fctl_footprint = fd_ulong_align_up( fd_fctl_footprint( 1UL ), tx_fctl_align );
+  ulong   tx_fctl_footprint = fd_ulong_align_up( fd_fctl_footprint( dedup_cnt ), tx_fctl_align );
   uchar * tx_fctl_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, tx_fctl_align, tx_fctl_footprint*tx_cnt, 1UL );
   FD_TEST( tx_fctl_mem );
 
-  FD_LOG_NOTICE(( "Creating tcache (--tcache-depth %lu, --tcache-map-cnt %lu)", tcache_depth, tcache_map_cnt ));
+  FD_LOG_NOTICE(( "Creating tcaches (--tcache-depth %lu, --tcache-map-cnt %lu per shard)", tcache_depth, tcache_map_cnt ));
   ulong   dedup_tcache_footprint = fd_tcache_footprint( tcache_depth, tcache_map_cnt );
-  uchar * dedup_tcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_tcache_align(), dedup_tcache_footprint, 1UL );
+  uchar * dedup_tcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_tcache_align(), dedup_tcache_footprint*dedup_cnt, 1UL );
   FD_TEST( dedup_tcache_mem );
 
-  FD_LOG_NOTICE(( "Creating dedup mcache (--dedup-depth %lu, app-sz 0)", dedup_depth ));
+  FD_LOG_NOTICE(( "Creating dedup mcaches (--dedup-depth %lu, app-sz 0)", dedup_depth ));
   ulong   dedup_mcache_footprint = fd_mcache_footprint( dedup_depth, 0UL ); /* No app region for the mcache */
-  uchar * dedup_mcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), dedup_mcache_footprint, 1UL );
+  uchar * dedup_mcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), dedup_mcache_footprint*dedup_cnt, 1UL );
   FD_TEST( dedup_mcache_mem );
 
-  FD_LOG_NOTICE(( "Creating dedup scratch" ));
+  FD_LOG_NOTICE(( "Creating dedup scratches" ));
   ulong   dedup_scratch_footprint = fd_dedup_tile_scratch_footprint( tx_cnt, rx_cnt );
-  uchar * dedup_scratch_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_dedup_tile_scratch_align(), dedup_scratch_footprint, 1UL );
+  uchar * dedup_scratch_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_dedup_tile_scratch_align(),
+                                                                  dedup_scratch_footprint*dedup_cnt, 1UL );
   FD_TEST( dedup_scratch_mem );
 
-  FD_LOG_NOTICE(( "Creating rx tcache (--test-depth %lu, --test-map-cnt %lu)", test_depth, test_map_cnt ));
+  FD_LOG_NOTICE(( "Creating rx tcaches (--test-depth %lu, --test-map-cnt %lu)", test_depth, test_map_cnt ));
   ulong   rx_tcache_footprint = fd_tcache_footprint( test_depth, test_map_cnt );
-  uchar * rx_tcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_tcache_align(), rx_tcache_footprint, 1UL );
+  uchar * rx_tcache_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_tcache_align(), rx_tcache_footprint*rx_tot, 1UL );
   FD_TEST( rx_tcache_mem );
 
   long now = fd_tickcount();
@@ -598,19 +617,20 @@ main( int     argc,
   cfg->tx_dcache_mem = tx_dcache_mem; cfg->tx_dcache_footprint = tx_dcache_footprint;
   cfg->tx_fctl_mem   = tx_fctl_mem;   cfg->tx_fctl_footprint   = tx_fctl_footprint;
 
-  cfg->dedup_cnc_mem     = cnc_mem + tx_cnt*cnc_footprint;
-  cfg->dedup_tcache_mem  = dedup_tcache_mem;
-  cfg->dedup_mcache_mem  = dedup_mcache_mem;
-  cfg->dedup_scratch_mem = dedup_scratch_mem;
+  cfg->dedup_cnt         = dedup_cnt;
+  cfg->dedup_cnc_mem     = cnc_mem + tx_cnt*cnc_footprint; cfg->dedup_cnc_footprint     = cnc_footprint;
+  cfg->dedup_tcache_mem  = dedup_tcache_mem;               cfg->dedup_tcache_footprint  = dedup_tcache_footprint;
+  cfg->dedup_mcache_mem  = dedup_mcache_mem;               cfg->dedup_mcache_footprint  = dedup_mcache_footprint;
+  cfg->dedup_scratch_mem = dedup_scratch_mem;              cfg->dedup_scratch_footprint = dedup_scratch_footprint;
   cfg->dedup_cr_max      = dedup_cr_max;
   cfg->dedup_lazy        = dedup_lazy;
-  cfg->dedup_seed        = rng_seq++;
+  cfg->dedup_seed        = rng_seq; rng_seq += (uint)dedup_cnt;
 
   cfg->rx_cnt        = rx_cnt;
   cfg->rx_lazy       = rx_lazy;
-  cfg->rx_cnc_mem    = cnc_mem  + (tx_cnt+1UL)*cnc_footprint;  cfg->rx_cnc_footprint    = cnc_footprint;
-  cfg->rx_rng_mem    = rng_mem  +  tx_cnt     *rng_footprint;  cfg->rx_rng_footprint    = rng_footprint;
-  cfg->rx_fseq_mem   = fseq_mem +  tx_cnt     *fseq_footprint; cfg->rx_fseq_footprint   = fseq_footprint;
+  cfg->rx_cnc_mem    = cnc_mem  + (tx_cnt+dedup_cnt)*cnc_footprint;  cfg->rx_cnc_footprint  = cnc_footprint;
+  cfg->rx_rng_mem    = rng_mem  +  tx_cnt           *rng_footprint;  cfg->rx_rng_footprint  = rng_footprint;
+  cfg->rx_fseq_mem   = fseq_mem +  tx_cnt*dedup_cnt *fseq_footprint; cfg->rx_fseq_footprint = fseq_footprint;
   cfg->rx_tcache_mem = rx_tcache_mem;                          cfg->rx_tcache_footprint = rx_tcache_footprint;
   
   cfg->pkt_framing     = pkt_framing;
@@ -624,21 +644,26 @@ main( int     argc,
     ulong tx_seq0 = fd_rng_ulong( rng );
     FD_TEST( fd_cnc_new   ( cfg->tx_cnc_mem    + tx_idx*cfg->tx_cnc_footprint,    64UL, 0UL, now         ) );
     FD_TEST( fd_rng_new   ( cfg->tx_rng_mem    + tx_idx*cfg->tx_rng_footprint,    rng_seq++, 0UL         ) );
-    FD_TEST( fd_fseq_new  ( cfg->tx_fseq_mem   + tx_idx*cfg->tx_fseq_footprint,   tx_seq0                ) );
+    for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ )
+      FD_TEST( fd_fseq_new( cfg->tx_fseq_mem + (tx_idx*dedup_cnt+dedup_idx)*cfg->tx_fseq_footprint, tx_seq0 ) );
     FD_TEST( fd_mcache_new( cfg->tx_mcache_mem + tx_idx*cfg->tx_mcache_footprint, tx_depth, 0UL, tx_seq0 ) );
     FD_TEST( fd_dcache_new( cfg->tx_dcache_mem + tx_idx*cfg->tx_dcache_footprint, tx_data_sz, 0UL        ) );
-    FD_TEST( fd_fctl_new  ( cfg->tx_fctl_mem   + tx_idx*cfg->tx_fctl_footprint,   1UL                    ) );
+    FD_TEST( fd_fctl_new  ( cfg->tx_fctl_mem   + tx_idx*cfg->tx_fctl_footprint,   dedup_cnt              ) );
   }
 
-  ulong dedup_seq0 = fd_rng_ulong( rng );
-  FD_TEST( fd_cnc_new   ( cfg->dedup_cnc_mem,    64UL, 1UL, now               ) );
-  FD_TEST( fd_tcache_new( cfg->dedup_tcache_mem, tcache_depth, tcache_map_cnt ) );
-  FD_TEST( fd_mcache_new( cfg->dedup_mcache_mem, dedup_depth, 0UL, dedup_seq0 ) );
+  ulong dedup_seq0[ FD_DEDUP_TILE_SHARD_MAX ];
+  for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ ) {
+    dedup_seq0[ dedup_idx ] = fd_rng_ulong( rng );
+    FD_TEST( fd_cnc_new   ( cfg->dedup_cnc_mem    + dedup_idx*cfg->dedup_cnc_footprint,    FD_LHIST_CNC_APP_SZ, 1UL, now ) );
+    FD_TEST( fd_tcache_new( cfg->dedup_tcache_mem + dedup_idx*cfg->dedup_tcache_footprint, tcache_depth, tcache_map_cnt  ) );
+    FD_TEST( fd_mcache_new( cfg->dedup_mcache_mem + dedup_idx*cfg->dedup_mcache_footprint, dedup_depth, 0UL,
+                            dedup_seq0[ dedup_idx ] ) );
+  }
 
-  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+  for( ulong rx_idx=0UL; rx_idx<rx_tot; rx_idx++ ) {
     FD_TEST( fd_cnc_new   ( cfg->rx_cnc_mem    + rx_idx*cfg->rx_cnc_footprint,    64UL, 2UL, now           ) );
     FD_TEST( fd_rng_new   ( cfg->rx_rng_mem    + rx_idx*cfg->rx_rng_footprint,    rng_seq++, 0UL           ) );
-    FD_TEST( fd_fseq_new  ( cfg->rx_fseq_mem   + rx_idx*cfg->rx_fseq_footprint,   dedup_seq0               ) );
+    FD_TEST( fd_fseq_new  ( cfg->rx_fseq_mem   + rx_idx*cfg->rx_fseq_footprint,   dedup_seq0[ rx_idx/rx_cnt ] ) );
     FD_TEST( fd_tcache_new( cfg->rx_tcache_mem + rx_idx*cfg->rx_tcache_footprint, test_depth, test_map_cnt ) );
   }
 
@@ -650,21 +675,21 @@ main( int     argc,
     FD_TEST( cnc[ tile_idx ] );
   }
 
-  for( ulong tile_idx=tile_cnt-1UL; tile_idx>0UL; tile_idx-- ) { /* reverse order to bring rxs -> dedup -> txs */
+  for( ulong tile_idx=tile_cnt-1UL; tile_idx>0UL; tile_idx-- ) { /* reverse order to bring rxs -> dedups -> txs */
     fd_tile_task_t tile_main;
     int            argc;
     char **        argv = (char **)fd_type_pun( cfg );
-    if(      tile_idx<= tx_cnt      ) { tile_main =  tx_tile_main; argc = (int)(uint)(tile_idx-1UL);        }
-    else if( tile_idx==(tx_cnt+1UL) ) { tile_main = dedup_tile_main; argc = 0;                              }
-    else                              { tile_main =  rx_tile_main; argc = (int)(uint)(tile_idx-tx_cnt-2UL); }
+    if(      tile_idx<=tx_cnt           ) { tile_main =    tx_tile_main; argc = (int)(uint)(tile_idx-1UL);                  }
+    else if( tile_idx<=tx_cnt+dedup_cnt ) { tile_main = dedup_tile_main; argc = (int)(uint)(tile_idx-tx_cnt-1UL);           }
+    else                                  { tile_main =    rx_tile_main; argc = (int)(uint)(tile_idx-tx_cnt-dedup_cnt-1UL); }
     FD_TEST( fd_tile_exec_new( tile_idx, tile_main, argc, argv ) );
   }
 
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
     FD_TEST( fd_cnc_wait( cnc[ tile_idx ], FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
 
-  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --dedup-cr-max %lu, --dedup-lazy %li ns, --rx-lazy %i)",
-                  duration, tx_lazy, dedup_cr_max, dedup_lazy, rx_lazy ));
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --shard-cnt %lu, --dedup-cr-max %lu, --dedup-lazy %li ns, "
+                  "--rx-lazy %i)", duration, tx_lazy, dedup_cnt, dedup_cr_max, dedup_lazy, rx_lazy ));
 
   /* FIXME: DO MONITORING WHILE RUNNING */
   fd_log_sleep( duration );
@@ -686,26 +711,73 @@ main( int     argc,
     FD_TEST( !ret );
   }
 
+  for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ ) {
+    fd_cnc_t * dedup_cnc = cnc[ tx_cnt+1UL+dedup_idx ];
+    ulong      lat_cnt = fd_lhist_cnt( fd_lhist_cnc_orig( dedup_cnc ) );
+    FD_TEST( fd_lhist_cnt( fd_lhist_cnc_pub( dedup_cnc ) )==lat_cnt );
+    if( lat_cnt ) {
+      ulong orig_idx = fd_lhist_quantile( fd_lhist_cnc_orig( dedup_cnc ), 0.5 );
+      ulong pub_idx  = fd_lhist_quantile( fd_lhist_cnc_pub ( dedup_cnc ), 0.5 );
+      FD_LOG_NOTICE(( "dedup %lu: cnt %lu, median tsorig lat [%lu,%lu) ticks, median tspub lat [%lu,%lu) ticks", dedup_idx, lat_cnt,
+                      fd_lhist_bucket_lo( orig_idx ), fd_lhist_bucket_hi( orig_idx ),
+                      fd_lhist_bucket_lo( pub_idx  ), fd_lhist_bucket_hi( pub_idx  ) ));
+    }
+  }
+
+  /* Report the aggregate dedup throughput.  Each dedup accumulated how
+     many frags from each tx it forwarded (unique frags it owns) and
+     filtered (duplicates it owns) in the corresponding tx fseq and how
+     many frags it skipped (frags owned by other shards) in its cnc.
+     Every dedup sees every frag, so the
+     forwarded counts summed over dedups give the system wide unique
+     frag rate (this is what scales with --shard-cnt). */
+
+  do {
+    ulong uniq_cnt = 0UL;
+    for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ ) {
+      ulong pub_cnt  = 0UL;
+      ulong filt_cnt = 0UL;
+      for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+        ulong *       fseq      = fd_fseq_join( cfg->tx_fseq_mem + (tx_idx*dedup_cnt+dedup_idx)*cfg->tx_fseq_footprint );
+        ulong const * fseq_diag = (ulong const *)fd_fseq_app_laddr_const( fseq );
+        FD_TEST( !fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] );
+        FD_TEST( !fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] );
+        pub_cnt  += fseq_diag[ FD_FSEQ_DIAG_PUB_CNT  ];
+        filt_cnt += fseq_diag[ FD_FSEQ_DIAG_FILT_CNT ];
+        FD_TEST( fd_fseq_leave( fseq ) );
+      }
+      ulong const * cnc_diag = (ulong const *)fd_cnc_app_laddr_const( cnc[ tx_cnt+1UL+dedup_idx ] );
+      ulong skip_cnt = cnc_diag[ FD_DEDUP_CNC_DIAG_SKIP_CNT ];
+      FD_TEST( (dedup_cnt>1UL) | !skip_cnt ); /* An unsharded dedup never skips */
+      FD_LOG_NOTICE(( "dedup %lu: pub_cnt %lu, filt_cnt %lu, skip_cnt %lu", dedup_idx, pub_cnt, filt_cnt, skip_cnt ));
+      uniq_cnt += pub_cnt;
+    }
+    FD_LOG_NOTICE(( "shard-cnt %lu: %7.3f Munique/s", dedup_cnt, 1e3*(double)uniq_cnt / (double)duration ));
+  } while(0);
+
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_cnc_leave( cnc[ tile_idx ] ) );
 
   FD_LOG_NOTICE(( "Cleaning up" ));
 
-  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+  for( ulong rx_idx=0UL; rx_idx<rx_tot; rx_idx++ ) {
     FD_TEST( fd_tcache_delete( cfg->rx_tcache_mem + rx_idx*cfg->rx_tcache_footprint ) );
     FD_TEST( fd_fseq_delete  ( cfg->rx_fseq_mem   + rx_idx*cfg->rx_fseq_footprint   ) );
     FD_TEST( fd_rng_delete   ( cfg->rx_rng_mem    + rx_idx*cfg->rx_rng_footprint    ) );
     FD_TEST( fd_cnc_delete   ( cfg->rx_cnc_mem    + rx_idx*cfg->rx_cnc_footprint    ) );
   }
 
-  FD_TEST( fd_mcache_delete( cfg->dedup_mcache_mem ) );
-  FD_TEST( fd_tcache_delete( cfg->dedup_tcache_mem ) );
-  FD_TEST( fd_cnc_delete   ( cfg->dedup_cnc_mem    ) );
+  for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ ) {
+    FD_TEST( fd_mcache_delete( cfg->dedup_mcache_mem + dedup_idx*cfg->dedup_mcache_footprint ) );
+    FD_TEST( fd_tcache_delete( cfg->dedup_tcache_mem + dedup_idx*cfg->dedup_tcache_footprint ) );
+    FD_TEST( fd_cnc_delete   ( cfg->dedup_cnc_mem    + dedup_idx*cfg->dedup_cnc_footprint    ) );
+  }
 
   for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
     FD_TEST( fd_fctl_delete  ( cfg->tx_fctl_mem   + tx_idx*cfg->tx_fctl_footprint   ) );
     FD_TEST( fd_dcache_delete( cfg->tx_dcache_mem + tx_idx*cfg->tx_dcache_footprint ) );
     FD_TEST( fd_mcache_delete( cfg->tx_mcache_mem + tx_idx*cfg->tx_mcache_footprint ) );
-    FD_TEST( fd_fseq_delete  ( cfg->tx_fseq_mem   + tx_idx*cfg->tx_fseq_footprint   ) );
+    for( ulong dedup_idx=0UL; dedup_idx<dedup_cnt; dedup_idx++ )
+      FD_TEST( fd_fseq_delete( cfg->tx_fseq_mem + (tx_idx*dedup_cnt+dedup_idx)*cfg->tx_fseq_footprint ) );
     FD_TEST( fd_rng_delete   ( cfg->tx_rng_mem    + tx_idx*cfg->tx_rng_footprint    ) );
     FD_TEST( fd_cnc_delete   ( cfg->tx_cnc_mem    + tx_idx*cfg->tx_cnc_footprint    ) );
   }
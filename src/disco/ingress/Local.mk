@@ -0,0 +1,8 @@
+$(call add-hdrs,fd_ingress.h)
+$(call add-objs,fd_ingress,fd_disco)
+$(call make-unit-test,test_ingress,test_ingress,fd_disco fd_tango fd_util)
+$(call make-bin,fd_ingress_mon,fd_ingress_mon,fd_disco fd_tango fd_util)
+ifdef FD_HAS_LIBBPF
+$(call make-bin,fd_ingress_tile,fd_ingress_tile,fd_disco fd_xdp fd_tango fd_util)
+$(call add-test-scripts,test_ingress_mq_init test_ingress_mq_full test_ingress_mq_fini)
+endif
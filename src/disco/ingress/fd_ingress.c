@@ -0,0 +1,676 @@
+#include "fd_ingress.h"
+#include "../../util/net/fd_eth.h"
+#include "../../util/net/fd_udp.h"
+
+/* fd_ingress_private_parse does the structural parsing of
+   fd_ingress_parse (i.e. everything but checksum validation).  On
+   success, returns 0 and *_ip4, *_udp, *_payload_off and *_payload_sz
+   hold the location of the ip4 header, udp header, udp payload offset
+   and udp payload size.  On failure, returns the drop reason and these
+   might have been clobbered.  If this succeeds, the ip4 header (with
+   options) and udp datagram are entirely contained in the frame such
+   that they can be checksummed safely. */
+
+static inline int
+fd_ingress_private_parse( uchar const *          frame,
+                          ulong                  frame_sz,
+                          ulong                  mtu,
+                          fd_ip4_hdr_t const **  _ip4,
+                          fd_udp_hdr_t const **  _udp,
+                          ulong *                _payload_off,
+                          ulong *                _payload_sz ) {
+
+  /* Parse the ethernet header (and any VLAN tag) */
+
+  ulong off = sizeof(fd_eth_hdr_t);
+  if( FD_UNLIKELY( frame_sz<off ) ) return FD_INGRESS_DROP_TRUNC;
+  ushort net_type = ((fd_eth_hdr_t const *)frame)->net_type;
+  if( FD_UNLIKELY( net_type==fd_ushort_bswap( FD_ETH_HDR_TYPE_VLAN ) ) ) {
+    if( FD_UNLIKELY( frame_sz<off+sizeof(fd_vlan_tag_t) ) ) return FD_INGRESS_DROP_TRUNC;
+    net_type = ((fd_vlan_tag_t const *)(frame+off))->net_type;
+    off += sizeof(fd_vlan_tag_t);
+  }
+  if( FD_UNLIKELY( net_type!=fd_ushort_bswap( FD_ETH_HDR_TYPE_IP ) ) ) return FD_INGRESS_DROP_ETH;
+
+  /* Parse the ip4 header.  Trailing bytes past the ip4 total length are
+     ethernet padding and ignored. */
+
+  if( FD_UNLIKELY( frame_sz<off+sizeof(fd_ip4_hdr_t) ) ) return FD_INGRESS_DROP_TRUNC;
+  fd_ip4_hdr_t const * ip4 = (fd_ip4_hdr_t const *)(frame+off);
+  ulong hdr_sz  = 4UL*(ulong)ip4->ihl;
+  ulong tot_len = (ulong)fd_ushort_bswap( ip4->net_tot_len );
+  if( FD_UNLIKELY( (ip4->version!=4U) | (hdr_sz<sizeof(fd_ip4_hdr_t)) | (tot_len<hdr_sz) ) ) return FD_INGRESS_DROP_IP4;
+  if( FD_UNLIKELY( frame_sz<off+tot_len ) ) return FD_INGRESS_DROP_TRUNC;
+  if( FD_UNLIKELY( !fd_ip4_hdr_net_frag_off_is_unfragmented( ip4->net_frag_off ) ) ) return FD_INGRESS_DROP_FRAG;
+  if( FD_UNLIKELY( ip4->protocol!=FD_IP4_HDR_PROTOCOL_UDP ) ) return FD_INGRESS_DROP_PROTO;
+
+  /* Parse the udp header */
+
+  if( FD_UNLIKELY( tot_len<hdr_sz+sizeof(fd_udp_hdr_t) ) ) return FD_INGRESS_DROP_UDP;
+  fd_udp_hdr_t const * udp = (fd_udp_hdr_t const *)((ulong)ip4 + hdr_sz);
+  ulong udp_len = (ulong)fd_ushort_bswap( udp->net_len );
+  if( FD_UNLIKELY( (udp_len<sizeof(fd_udp_hdr_t)) | (udp_len>tot_len-hdr_sz) ) ) return FD_INGRESS_DROP_UDP;
+
+  ulong payload_sz = udp_len - sizeof(fd_udp_hdr_t);
+  if( FD_UNLIKELY( payload_sz>mtu ) ) return FD_INGRESS_DROP_OVERSZ;
+
+  *_ip4         = ip4;
+  *_udp         = udp;
+  *_payload_off = off + hdr_sz + sizeof(fd_udp_hdr_t);
+  *_payload_sz  = payload_sz;
+  return 0;
+}
+
+int
+fd_ingress_parse( uchar const * frame,
+                  ulong         frame_sz,
+                  ulong         mtu,
+                  int           check,
+                  ulong *       _payload_off,
+                  ulong *       _payload_sz,
+                  ulong *       _sig ) {
+  fd_ip4_hdr_t const * ip4;
+  fd_udp_hdr_t const * udp;
+  ulong                payload_off;
+  ulong                payload_sz;
+  int reason = fd_ingress_private_parse( frame, frame_sz, mtu, &ip4, &udp, &payload_off, &payload_sz );
+  if( FD_UNLIKELY( reason ) ) return reason;
+
+  if( check ) {
+    if( FD_UNLIKELY( fd_ip4_hdr_check( ip4 ) ) ) return FD_INGRESS_DROP_IP4_CHECK;
+    if( FD_UNLIKELY( udp->check && fd_ip4_udp_check( ip4->saddr, ip4->daddr, udp, frame+payload_off ) ) )
+      return FD_INGRESS_DROP_UDP_CHECK;
+  }
+
+  *_payload_off = payload_off;
+  *_payload_sz  = payload_sz;
+  *_sig         = fd_ingress_sig( ip4->saddr, udp->net_sport, udp->net_dport );
+  return 0;
+}
+
+char const *
+fd_ingress_drop_cstr( int r ) {
+  switch( r ) {
+  case 0:                         return "success";
+  case FD_INGRESS_DROP_TRUNC:     return "trunc";
+  case FD_INGRESS_DROP_ETH:       return "eth";
+  case FD_INGRESS_DROP_IP4:       return "ip4";
+  case FD_INGRESS_DROP_FRAG:      return "frag";
+  case FD_INGRESS_DROP_PROTO:     return "proto";
+  case FD_INGRESS_DROP_UDP:       return "udp";
+  case FD_INGRESS_DROP_OVERSZ:    return "oversz";
+  case FD_INGRESS_DROP_IP4_CHECK: return "ip4-check";
+  case FD_INGRESS_DROP_UDP_CHECK: return "udp-check";
+  case FD_INGRESS_DROP_RATE:      return "rate";
+  case FD_INGRESS_DROP_BACKP:     return "backp";
+  default: break;
+  }
+  return "unknown";
+}
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#define SCRATCH_ALLOC( a, s ) (__extension__({                    \
+    ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
+    scratch_top = _scratch_alloc + (s);                           \
+    (void *)_scratch_alloc;                                       \
+  }))
+
+FD_STATIC_ASSERT( FD_FCTL_ALIGN<=FD_INGRESS_TILE_SCRATCH_ALIGN, packing );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_CHUNK_IDX ),                                    layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_RX_CNT    ),                                    layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_RX_SZ     ),                                    layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_PUB_CNT   ),                                    layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_PUB_SZ    ),                                    layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_FILT_CNT  ),                                    layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_INGRESS_CNC_DIAG_FILT_SZ   ),                                    layout );
+FD_STATIC_ASSERT( FD_INGRESS_CNC_DIAG_DROP( 1 )==FD_CNC_DIAG_EXT,                                         layout );
+FD_STATIC_ASSERT( FD_INGRESS_CNC_DIAG_DROP( FD_INGRESS_DROP_MAX )<FD_INGRESS_CNC_DIAG_ZC_CNT,             layout );
+FD_STATIC_ASSERT( FD_INGRESS_CNC_DIAG_ZC_MOVE_CNT                <FD_INGRESS_CNC_APP_SZ/sizeof(ulong),    layout );
+
+/* FD_INGRESS_PRIVATE_RELEASE_BATCH is the max number of frames a zero
+   copy ingress releases to the rx backend per release call */
+
+#define FD_INGRESS_PRIVATE_RELEASE_BATCH (64UL)
+
+/* fd_ingress_private_ctx_t holds the state of a running ingress tile
+   that is shared between the run loop and the rx aio callback (the
+   callback is invoked by the rx backend from within rx service, i.e.
+   on the tile's thread). */
+
+struct fd_ingress_private_ctx {
+
+  /* out frag stream state */
+  fd_frag_meta_t * mcache;   /* Local join to the output mcache */
+  ulong            depth;    /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
+  ulong            seq;      /* seq of next frag to publish */
+  void *           base;     /* ==fd_wksp_containing( dcache ), chunk reference address in the tile's local address space */
+  ulong            chunk0;   /* ==fd_dcache_compact_chunk0( base, dcache ) */
+  ulong            wmark;    /* ==fd_dcache_compact_wmark ( base, dcache, mtu ), payloads chunks start in [chunk0,wmark] */
+  ulong            chunk;    /* Chunk where next payload will be written, in [chunk0,wmark] */
+  ulong            ctl;      /* ctl to publish frags with */
+  ulong            mtu;      /* largest payload to publish */
+  ulong            cr_avail; /* number of flow control credits available to publish downstream */
+
+  /* zero copy state (only used if rx_release is non-NULL) */
+  fd_ingress_rx_release_func_t rx_release; /* ==rx->release, NULL if the rx backend copies */
+  void *                       rx_ctx;     /* ==rx->ctx */
+  ulong                        rel_seq;    /* frags [rel_seq,seq) hold frames that have not been released yet */
+
+  /* rate limiting state */
+  fd_rlimit_t *    rlimit;   /* Local join to the per source rate limiter, NULL if none */
+
+  /* diagnostics accumulated between housekeeping events */
+  ulong rx_cnt;
+  ulong rx_sz;
+  ulong pub_cnt;
+  ulong pub_sz;
+  ulong filt_cnt;
+  ulong filt_sz;
+  ulong drop_cnt[ FD_INGRESS_DROP_MAX+1 ]; /* indexed by reason, drop_cnt[0] unused */
+  ulong zc_cnt;
+  ulong zc_move_cnt;
+};
+
+typedef struct fd_ingress_private_ctx fd_ingress_private_ctx_t;
+
+/* fd_ingress_private_rx is the fd_aio send function the rx backend
+   delivers received frames to.  Frames are processed in batches of
+   FD_IP4_UDP_CHECK_BATCH_MAX.  Each batch is parsed and the checksums
+   of the structurally valid frames in the batch are validated together
+   (see fd_ip4_{hdr,udp}_check_batch).  Valid frames are then rate
+   limited by source (the sources' rlimit sets are prefetched while the
+   checksums are computed) and the remaining payloads are copied into
+   the dcache (or, if zero copy, published in place) and published.
+   All frames are always consumed (frames that can't be published are
+   dropped and counted, and their frames released if zero copy). */
+
+static int
+fd_ingress_private_rx( void *                    _ctx,
+                       fd_aio_pkt_info_t const * batch,
+                       ulong                     batch_cnt,
+                       ulong *                   opt_batch_idx ) {
+  (void)opt_batch_idx;
+
+  fd_ingress_private_ctx_t * ctx = (fd_ingress_private_ctx_t *)_ctx;
+
+  fd_ingress_rx_release_func_t rx_release = ctx->rx_release;
+
+  long  now    = fd_tickcount();
+  ulong tsorig = fd_frag_meta_ts_comp( now );
+
+  for( ulong batch_off=0UL; batch_off<batch_cnt; batch_off+=FD_IP4_UDP_CHECK_BATCH_MAX ) {
+    fd_aio_pkt_info_t const * pkt = batch + batch_off;
+    ulong                     cnt = fd_ulong_min( batch_cnt-batch_off, FD_IP4_UDP_CHECK_BATCH_MAX );
+
+    /* Parse the frames.  Headers of structurally valid frames are
+       compacted into ip4 / udp for checksum validation (idx gives the
+       frame for each). */
+
+    int                  reason     [ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    ulong                payload_off[ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    ulong                payload_sz [ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    ulong                sig        [ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    fd_ip4_hdr_t const * ip4        [ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    fd_udp_hdr_t const * udp        [ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    ulong                idx        [ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    ulong                valid_cnt = 0UL;
+
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ctx->rx_cnt++;
+      ctx->rx_sz += (ulong)pkt[i].buf_sz;
+      reason[i] = fd_ingress_private_parse( (uchar const *)pkt[i].buf, (ulong)pkt[i].buf_sz, ctx->mtu,
+                                            ip4+valid_cnt, udp+valid_cnt, payload_off+i, payload_sz+i );
+      if( FD_LIKELY( !reason[i] ) ) {
+        sig[i] = fd_ingress_sig( ip4[ valid_cnt ]->saddr, udp[ valid_cnt ]->net_sport, udp[ valid_cnt ]->net_dport );
+        idx[ valid_cnt++ ] = i;
+      }
+    }
+
+    /* Validate checksums and rate limit (the sig of a frame holds its
+       source address in the low 32 bits) */
+
+    if( FD_LIKELY( valid_cnt ) ) {
+      fd_rlimit_t * rlimit = ctx->rlimit;
+      if( rlimit ) for( ulong j=0UL; j<valid_cnt; j++ ) fd_rlimit_prefetch( rlimit, (uint)sig[ idx[j] ] );
+
+      int ip4_ok = fd_ip4_hdr_check_batch( ip4,      valid_cnt );
+      int udp_ok = fd_ip4_udp_check_batch( ip4, udp, valid_cnt );
+      for( ulong j=0UL; j<valid_cnt; j++ ) {
+        ulong i = idx[j];
+        if(      FD_UNLIKELY( !((ip4_ok>>j) & 1) ) ) reason[i] = FD_INGRESS_DROP_IP4_CHECK;
+        else if( FD_UNLIKELY( !((udp_ok>>j) & 1) ) ) reason[i] = FD_INGRESS_DROP_UDP_CHECK;
+        else if( rlimit && FD_UNLIKELY( !fd_rlimit_take( rlimit, (uint)sig[i], (ulong)now ) ) ) reason[i] = FD_INGRESS_DROP_RATE;
+      }
+    }
+
+    /* Publish the valid payloads.  If zero copy, a payload is
+       published from the frame it was received in (moving it down to
+       a chunk boundary within its frame if necessary) and the frames
+       of dropped frames are released. */
+
+    void * rel[ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    ulong  rel_cnt = 0UL;
+
+    for( ulong i=0UL; i<cnt; i++ ) {
+      int r = reason[i];
+      if( FD_LIKELY( !r ) ) {
+        if( FD_LIKELY( ctx->cr_avail ) ) {
+          ulong sz = payload_sz[i];
+          ulong chunk;
+          if( rx_release ) {
+            uchar * payload = (uchar *)pkt[i].buf + payload_off[i];
+            uchar * dst     = (uchar *)fd_ulong_align_dn( (ulong)payload, FD_CHUNK_ALIGN );
+            if( FD_UNLIKELY( dst!=payload ) ) { memmove( dst, payload, sz ); ctx->zc_move_cnt++; }
+            else                                                             ctx->zc_cnt++;
+            chunk = fd_laddr_to_chunk( ctx->base, dst );
+          } else {
+            chunk = ctx->chunk;
+            fd_memcpy( fd_chunk_to_laddr( ctx->base, chunk ), (uchar const *)pkt[i].buf + payload_off[i], sz );
+            ctx->chunk = fd_dcache_compact_next( chunk, sz, ctx->chunk0, ctx->wmark );
+          }
+          fd_mcache_publish( ctx->mcache, ctx->depth, ctx->seq, sig[i], chunk, sz, ctx->ctl, tsorig, tsorig );
+
+          ctx->seq   = fd_seq_inc( ctx->seq, 1UL );
+          ctx->cr_avail--;
+          ctx->pub_cnt++;
+          ctx->pub_sz += sz;
+          continue;
+        }
+        r = FD_INGRESS_DROP_BACKP;
+      }
+      ctx->drop_cnt[ r ]++;
+      ctx->filt_cnt++;
+      ctx->filt_sz += (ulong)pkt[i].buf_sz;
+      rel[ rel_cnt++ ] = pkt[i].buf;
+    }
+
+    if( rx_release && rel_cnt ) rx_release( ctx->rx_ctx, rel, rel_cnt );
+  }
+
+  return FD_AIO_SUCCESS;
+}
+
+/* fd_ingress_private_release releases the frames of the frags all of
+   fctl's reliable consumers have advanced past to a zero copy rx
+   backend.  The frame of a frag is found from its mcache line (the
+   tile never publishes depth or more frags past the oldest frag with an
+   unreleased frame such that these lines are never overwritten before
+   the frame is released). */
+
+static void
+fd_ingress_private_release( fd_ingress_private_ctx_t * ctx,
+                            fd_fctl_t const *          fctl ) {
+
+  /* Find the oldest frag a reliable consumer might still read */
+
+  ulong seq    = ctx->seq;
+  ulong rx_cnt = fd_fctl_rx_cnt( fctl );
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    ulong rx_seq = fd_fseq_query( fd_fctl_rx_seq_laddr( fctl, rx_idx ) );
+    if( fd_seq_lt( rx_seq, seq ) ) seq = rx_seq;
+  }
+  if( FD_UNLIKELY( !fd_seq_lt( ctx->rel_seq, seq ) ) ) return; /* Nothing to release (or consumer behind rel_seq, e.g. reset) */
+
+  void * frame[ FD_INGRESS_PRIVATE_RELEASE_BATCH ];
+  ulong  frame_cnt = 0UL;
+  for( ulong rel_seq=ctx->rel_seq; fd_seq_ne( rel_seq, seq ); rel_seq=fd_seq_inc( rel_seq, 1UL ) ) {
+    fd_frag_meta_t const * mline = ctx->mcache + fd_mcache_line_idx( rel_seq, ctx->depth );
+    frame[ frame_cnt++ ] = fd_chunk_to_laddr( ctx->base, (ulong)mline->chunk );
+    if( FD_UNLIKELY( frame_cnt==FD_INGRESS_PRIVATE_RELEASE_BATCH ) ) {
+      ctx->rx_release( ctx->rx_ctx, frame, frame_cnt );
+      frame_cnt = 0UL;
+    }
+  }
+  if( FD_LIKELY( frame_cnt ) ) ctx->rx_release( ctx->rx_ctx, frame, frame_cnt );
+
+  ctx->rel_seq = seq;
+}
+
+ulong
+fd_ingress_tile_scratch_align( void ) {
+  return FD_INGRESS_TILE_SCRATCH_ALIGN;
+}
+
+ulong
+fd_ingress_tile_scratch_footprint( ulong out_cnt ) {
+  if( FD_UNLIKELY( out_cnt>FD_INGRESS_TILE_OUT_MAX ) ) return 0UL;
+  ulong scratch_top = 0UL;
+  SCRATCH_ALLOC( fd_fctl_align(), fd_fctl_footprint( out_cnt ) ); /* fctl */
+  SCRATCH_ALLOC( fd_aio_align(),  fd_aio_footprint()           ); /* aio */
+  return fd_ulong_align_up( scratch_top, fd_ingress_tile_scratch_align() );
+}
+
+int
+fd_ingress_tile( fd_cnc_t *              cnc,
+                 fd_ingress_rx_t const * _rx,
+                 fd_rlimit_t *           rlimit,
+                 ulong                   mtu,
+                 ulong                   orig,
+                 fd_frag_meta_t *        mcache,
+                 uchar *                 dcache,
+                 ulong                   out_cnt,
+                 ulong **                out_fseq,
+                 ulong                   cr_max,
+                 long                    lazy,
+                 fd_rng_t *              rng,
+                 void *                  scratch ) {
+
+  /* cnc state */
+  ulong * cnc_diag;             /* ==fd_cnc_app_laddr( cnc ), local address of the ingress tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;    /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt;   /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  ulong   cnc_diag_spin_ticks;  /* Accumulates ticks spent with nothing received between housekeeping events */
+  ulong   cnc_diag_work_ticks;  /* Accumulates ticks spent processing received frames between housekeeping events */
+  ulong   cnc_diag_backp_ticks; /* Accumulates ticks spent backpressured between housekeeping events */
+  ulong   cnc_diag_hkeep_ticks; /* Accumulates ticks spent doing housekeeping between housekeeping events */
+  fd_perf_t   _perf[1];         /* perf state, local to the tile */
+  fd_perf_t * perf;             /* Samples the tile's hardware performance counters, NULL if not sampling */
+
+  /* in rx state */
+  fd_ingress_rx_t rx[1]; /* Copy of the rx backend description */
+  fd_aio_t *      aio;   /* aio the rx backend delivers frames to */
+
+  /* out frag stream and rx callback state (the frag stream / rx
+     diagnostics live in ctx as they are updated by the rx callback) */
+  fd_ingress_private_ctx_t ctx[1];
+  ulong *                  sync;  /* ==fd_mcache_seq_laddr( mcache ), local addr where ingress mcache sync info is published */
+
+  /* flow control state */
+  fd_fctl_t * fctl; /* output flow control */
+
+  /* housekeeping state */
+  ulong async_min; /* minimum number of ticks between processing a housekeeping event, positive integer power of 2 */
+
+  do {
+
+    FD_LOG_INFO(( "Booting ingress (out-cnt %lu)", out_cnt ));
+    if( FD_UNLIKELY( out_cnt>FD_INGRESS_TILE_OUT_MAX ) ) { FD_LOG_WARNING(( "out_cnt too large" )); return 1; }
+
+    if( FD_UNLIKELY( !scratch ) ) {
+      FD_LOG_WARNING(( "NULL scratch" ));
+      return 1;
+    }
+
+    if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)scratch, fd_ingress_tile_scratch_align() ) ) ) {
+      FD_LOG_WARNING(( "misaligned scratch" ));
+      return 1;
+    }
+
+    ulong scratch_top = (ulong)scratch;
+
+    /* cnc state init */
+
+    if( FD_UNLIKELY( !cnc ) ) { FD_LOG_WARNING(( "NULL cnc" )); return 1; }
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<FD_INGRESS_CNC_APP_SZ ) ) {
+      FD_LOG_WARNING(( "cnc app sz must be at least %lu", FD_INGRESS_CNC_APP_SZ ));
+      return 1;
+    }
+    if( FD_UNLIKELY( fd_cnc_signal_query( cnc )!=FD_CNC_SIGNAL_BOOT ) ) { FD_LOG_WARNING(( "already booted" )); return 1; }
+
+    cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
+
+    /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
+       cleared during first housekeeping if credits available */
+    cnc_diag_in_backp    = 1UL;
+    cnc_diag_backp_cnt   = 0UL;
+    cnc_diag_spin_ticks  = 0UL;
+    cnc_diag_work_ticks  = 0UL;
+    cnc_diag_backp_ticks = 0UL;
+    cnc_diag_hkeep_ticks = 0UL;
+
+    memset( ctx, 0, sizeof(fd_ingress_private_ctx_t) );
+
+    /* in rx init */
+
+    if( FD_UNLIKELY( !_rx                               ) ) { FD_LOG_WARNING(( "NULL rx"                  )); return 1; }
+    if( FD_UNLIKELY( (!_rx->set_rx) | (!_rx->service)   ) ) { FD_LOG_WARNING(( "NULL rx set_rx / service" )); return 1; }
+    if( FD_UNLIKELY( !_rx->burst_max                    ) ) { FD_LOG_WARNING(( "zero rx burst_max"        )); return 1; }
+    rx[0] = _rx[0];
+
+    ctx->rx_release = rx->release; /* NULL okay (copying rx backend) */
+    ctx->rx_ctx     = rx->ctx;
+
+    ctx->rlimit = rlimit; /* NULL okay (no rate limiting) */
+
+    if( FD_UNLIKELY( !mtu ) ) { FD_LOG_WARNING(( "mtu must be positive" )); return 1; }
+    if( FD_UNLIKELY( orig>=FD_FRAG_META_ORIG_MAX ) ) { FD_LOG_WARNING(( "orig too large" )); return 1; }
+    ctx->mtu = mtu;
+    ctx->ctl = fd_frag_meta_ctl( orig, 1 /*som*/, 1 /*eom*/, 0 /*err*/ );
+
+    aio = fd_aio_join( fd_aio_new( SCRATCH_ALLOC( fd_aio_align(), fd_aio_footprint() ), ctx, fd_ingress_private_rx ) );
+    if( FD_UNLIKELY( !aio ) ) { FD_LOG_WARNING(( "join failed" )); return 1; }
+
+    /* out frag stream init */
+
+    if( FD_UNLIKELY( !mcache ) ) { FD_LOG_WARNING(( "NULL mcache" )); return 1; }
+    ctx->mcache = mcache;
+    ctx->depth  = fd_mcache_depth( mcache );
+    sync        = fd_mcache_seq_laddr( mcache );
+
+    ctx->seq     = fd_mcache_seq_query( sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION */
+    ctx->rel_seq = ctx->seq;
+
+    if( FD_UNLIKELY( !dcache ) ) { FD_LOG_WARNING(( "NULL dcache" )); return 1; }
+
+    ctx->base = fd_wksp_containing( dcache );
+    if( FD_UNLIKELY( !ctx->base ) ) { FD_LOG_WARNING(( "fd_wksp_containing failed" )); return 1; }
+
+    if( ctx->rx_release ) {
+
+      /* Zero copy: payloads are published from the rx backend's frames
+         (which live in the dcache's wksp) so the tile doesn't write to
+         the dcache */
+
+      FD_LOG_INFO(( "zero copy rx" ));
+
+    } else {
+
+      if( FD_UNLIKELY( !fd_dcache_compact_is_safe( ctx->base, dcache, mtu, ctx->depth ) ) ) {
+        FD_LOG_WARNING(( "dcache not compatible with wksp base, mtu and mcache depth" ));
+        return 1;
+      }
+
+      ctx->chunk0 = fd_dcache_compact_chunk0( ctx->base, dcache );
+      ctx->wmark  = fd_dcache_compact_wmark ( ctx->base, dcache, mtu );
+      ctx->chunk  = FD_VOLATILE_CONST( cnc_diag[ FD_INGRESS_CNC_DIAG_CHUNK_IDX ] );
+      if( FD_UNLIKELY( !((ctx->chunk0<=ctx->chunk) & (ctx->chunk<=ctx->wmark)) ) ) {
+        ctx->chunk = ctx->chunk0;
+        FD_LOG_INFO(( "out of bounds cnc chunk index; overriding initial chunk to chunk0" ));
+      }
+      FD_LOG_INFO(( "chunk %lu", ctx->chunk ));
+
+    }
+
+    /* out flow control init */
+
+    if( FD_UNLIKELY( !!out_cnt && !out_fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq" )); return 1; }
+
+    fctl = fd_fctl_join( fd_fctl_new( SCRATCH_ALLOC( fd_fctl_align(), fd_fctl_footprint( out_cnt ) ), out_cnt ) );
+    if( FD_UNLIKELY( !fctl ) ) { FD_LOG_WARNING(( "join failed" )); return 1; }
+
+    for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+
+      ulong * fseq = out_fseq[ out_idx ];
+      if( FD_UNLIKELY( !fseq ) ) { FD_LOG_WARNING(( "NULL out_fseq[%lu]", out_idx )); return 1; }
+      ulong * fseq_diag = (ulong *)fd_fseq_app_laddr( fseq );
+
+      /* Assumes lag_max==depth */
+      /* FIXME: CONSIDER ADDING LAG_MAX THIS TO FSEQ AS A FIELD? */
+      if( FD_UNLIKELY( !fd_fctl_cfg_rx_add( fctl, ctx->depth, fseq, &fseq_diag[ FD_FSEQ_DIAG_SLOW_CNT ] ) ) ) {
+        FD_LOG_WARNING(( "fd_fctl_cfg_rx_add failed" ));
+        return 1;
+      }
+    }
+
+    /* cr_burst is rx burst_max because a single rx service call can
+       publish up to that many frags before we check cr_avail again.  We
+       use defaults for cr_resume and cr_refill (and possible cr_max if
+       the user wanted to use defaults here too). */
+
+    if( FD_UNLIKELY( !fd_fctl_cfg_done( fctl, rx->burst_max, cr_max, 0UL, 0UL ) ) ) {
+      FD_LOG_WARNING(( "fd_fctl_cfg_done failed (rx burst_max %lu too large for cr_max?)", rx->burst_max ));
+      return 1;
+    }
+    FD_LOG_INFO(( "cr_burst %lu cr_max %lu cr_resume %lu cr_refill %lu",
+                  fd_fctl_cr_burst( fctl ), fd_fctl_cr_max( fctl ), fd_fctl_cr_resume( fctl ), fd_fctl_cr_refill( fctl ) ));
+
+    cr_max        = fd_fctl_cr_max( fctl );
+    ctx->cr_avail = 0UL; /* Will be initialized by run loop */
+
+    /* housekeeping init */
+
+    if( lazy<=0L ) lazy = fd_tempo_lazy_default( cr_max );
+    FD_LOG_INFO(( "Configuring housekeeping (lazy %li ns)", lazy ));
+
+    async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
+    if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
+
+    /* Sample the tile's hardware performance counters if they are
+       available on this host (the cnc app region always has room for
+       them) */
+    perf = fd_perf_open( _perf );
+    FD_LOG_INFO(( "%s performance counters", perf ? "Sampling" : "Not sampling" ));
+
+  } while(0);
+
+  FD_LOG_INFO(( "Running ingress (orig %lu)", orig ));
+  rx->set_rx( rx->ctx, aio );
+  fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+  long then = fd_tickcount();
+  long now  = then;
+  for(;;) {
+
+    /* Do housekeeping at a low rate in the background */
+    if( FD_UNLIKELY( (now-then)>=0L ) ) {
+
+      /* Send synchronization info */
+      fd_mcache_seq_update( sync, ctx->seq );
+
+      /* Send diagnostic info */
+      /* When we drain, we don't do a fully atomic update of the
+         diagnostics as it is only diagnostic and it will still be
+         correct the usual case where individual diagnostic counters
+         aren't used by multiple writers spread over different threads
+         of execution. */
+      fd_cnc_heartbeat( cnc, now );
+      FD_COMPILER_MFENCE();
+      cnc_diag[ FD_CNC_DIAG_IN_BACKP            ]  = cnc_diag_in_backp;
+      cnc_diag[ FD_CNC_DIAG_BACKP_CNT           ] += cnc_diag_backp_cnt;
+      if( !ctx->rx_release ) cnc_diag[ FD_INGRESS_CNC_DIAG_CHUNK_IDX ] = ctx->chunk;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_RX_CNT      ] += ctx->rx_cnt;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_RX_SZ       ] += ctx->rx_sz;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_PUB_CNT     ] += ctx->pub_cnt;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_PUB_SZ      ] += ctx->pub_sz;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_FILT_CNT    ] += ctx->filt_cnt;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_FILT_SZ     ] += ctx->filt_sz;
+      for( int r=1; r<=FD_INGRESS_DROP_MAX; r++ ) cnc_diag[ FD_INGRESS_CNC_DIAG_DROP( r ) ] += ctx->drop_cnt[ r ];
+      cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_CNT      ] += ctx->zc_cnt;
+      cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_MOVE_CNT ] += ctx->zc_move_cnt;
+      cnc_diag[ FD_CNC_DIAG_SPIN_TICKS          ] += cnc_diag_spin_ticks;
+      cnc_diag[ FD_CNC_DIAG_WORK_TICKS          ] += cnc_diag_work_ticks;
+      cnc_diag[ FD_CNC_DIAG_BACKP_TICKS         ] += cnc_diag_backp_ticks;
+      cnc_diag[ FD_CNC_DIAG_HKEEP_TICKS         ] += cnc_diag_hkeep_ticks;
+      if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_CNC_DIAG_PERF_CYCLES );
+      FD_COMPILER_MFENCE();
+      cnc_diag_backp_cnt   = 0UL;
+      ctx->rx_cnt          = 0UL;
+      ctx->rx_sz           = 0UL;
+      ctx->pub_cnt         = 0UL;
+      ctx->pub_sz          = 0UL;
+      ctx->filt_cnt        = 0UL;
+      ctx->filt_sz         = 0UL;
+      for( int r=1; r<=FD_INGRESS_DROP_MAX; r++ ) ctx->drop_cnt[ r ] = 0UL;
+      ctx->zc_cnt          = 0UL;
+      ctx->zc_move_cnt     = 0UL;
+      cnc_diag_spin_ticks  = 0UL;
+      cnc_diag_work_ticks  = 0UL;
+      cnc_diag_backp_ticks = 0UL;
+      cnc_diag_hkeep_ticks = 0UL;
+
+      /* Receive command-and-control signals */
+      ulong s = fd_cnc_signal_query( cnc );
+      if( FD_UNLIKELY( s!=FD_CNC_SIGNAL_RUN ) ) {
+        if( FD_LIKELY( s==FD_CNC_SIGNAL_HALT ) ) break;
+        if( FD_UNLIKELY( s!=FD_INGRESS_CNC_SIGNAL_ACK ) ) {
+          char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+          FD_LOG_WARNING(( "Unexpected signal %s (%lu) received; trying to resume", fd_cnc_signal_cstr( s, buf ), s ));
+        }
+        fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
+      }
+
+      /* Release the frames of frags all reliable consumers are done
+         with (zero copy only) */
+      if( ctx->rx_release ) fd_ingress_private_release( ctx, fctl );
+
+      /* Receive flow control credits.  If zero copy, also limit credits
+         such that the mcache lines of frags with unreleased frames
+         aren't overwritten (see fd_ingress_private_release). */
+      ctx->cr_avail = fd_fctl_tx_cr_update( fctl, ctx->cr_avail, ctx->seq );
+      if( ctx->rx_release ) ctx->cr_avail = fd_ulong_min( ctx->cr_avail, ctx->depth - (ulong)fd_seq_diff( ctx->seq, ctx->rel_seq ) );
+
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, cnc_diag_hkeep_ticks );
+      then = now + (long)fd_tempo_async_reload( rng, async_min );
+    }
+
+    /* Check if we are backpressured.  Since a single rx service call
+       can publish up to burst_max frags, we are backpressured if we
+       have fewer credits than that (rather than dropping frames that
+       we already pulled from the backend).  If so, count any transition
+       into a backpressured regime and spin to wait for flow control
+       credits to return.  (The backend will buffer and/or drop frames
+       meanwhile as per its own policies, e.g. NIC rx ring overflow.) */
+
+    if( FD_UNLIKELY( ctx->cr_avail<rx->burst_max ) ) {
+      cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
+      cnc_diag_in_backp   = 1UL;
+      FD_SPIN_PAUSE();
+      FD_CNC_DIAG_TICK( now, cnc_diag_backp_ticks );
+      continue;
+    }
+    cnc_diag_in_backp = 0UL;
+
+    /* Poll the rx backend (which will call fd_ingress_private_rx with
+       any frames received) */
+
+    ulong rx_cnt = ctx->rx_cnt;
+    rx->service( rx->ctx );
+    if( FD_UNLIKELY( ctx->rx_cnt==rx_cnt ) ) {
+      FD_SPIN_PAUSE();
+      FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks );
+      continue;
+    }
+    FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+  }
+
+  do {
+
+    FD_LOG_INFO(( "Halting ingress" ));
+
+    FD_LOG_INFO(( "Disconnecting rx" ));
+    rx->set_rx( rx->ctx, NULL );
+
+    if( ctx->rx_release ) {
+      FD_LOG_INFO(( "Releasing consumed frames" ));
+      fd_ingress_private_release( ctx, fctl );
+    }
+
+    FD_LOG_INFO(( "Destroying fctl" ));
+    fd_fctl_delete( fd_fctl_leave( fctl ) );
+
+    FD_LOG_INFO(( "Destroying aio" ));
+    fd_aio_delete( fd_aio_leave( aio ) );
+
+    if( FD_LIKELY( perf ) ) fd_perf_close( perf );
+
+    FD_LOG_INFO(( "Halted ingress" ));
+    fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
+
+  } while(0);
+
+  return 0;
+}
+
+#undef SCRATCH_ALLOC
+#endif
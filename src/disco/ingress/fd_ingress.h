@@ -0,0 +1,337 @@
+#ifndef HEADER_fd_src_disco_ingress_fd_ingress_h
+#define HEADER_fd_src_disco_ingress_fd_ingress_h
+
+/* fd_ingress provides services to turn raw ethernet frames received
+   from the network by an fd_aio receive path (e.g. an fd_xsk_aio) into
+   a tango frag stream of validated UDP payloads (e.g. transactions).
+   Malformed, fragmented and oversized packets (and, optionally,
+   packets from sources exceeding a per source rate limit) are dropped
+   and counted by reason. */
+
+#include "../fd_disco_base.h"
+
+/* FD_INGRESS_DROP_* give the reasons a frame can be dropped by ingress
+   parsing.  These are positive integers in [1,FD_INGRESS_DROP_MAX] (0
+   indicates the frame was accepted).  When a frame has multiple
+   problems, the reason reported is the first in the order below (i.e.
+   structural problems take precedence over checksum failures). */
+
+#define FD_INGRESS_DROP_TRUNC      ( 1) /* Frame too short for the headers it claims to have */
+#define FD_INGRESS_DROP_ETH        ( 2) /* Not an IPv4 frame (after at most one VLAN tag) */
+#define FD_INGRESS_DROP_IP4        ( 3) /* Bad IPv4 version, header length or total length */
+#define FD_INGRESS_DROP_FRAG       ( 4) /* IPv4 fragment (more fragments set or non-zero fragment offset) */
+#define FD_INGRESS_DROP_PROTO      ( 5) /* Not a UDP datagram */
+#define FD_INGRESS_DROP_UDP        ( 6) /* Bad UDP length */
+#define FD_INGRESS_DROP_OVERSZ     ( 7) /* UDP payload larger than the ingress mtu */
+#define FD_INGRESS_DROP_IP4_CHECK  ( 8) /* Bad IPv4 header checksum */
+#define FD_INGRESS_DROP_UDP_CHECK  ( 9) /* Bad UDP checksum */
+#define FD_INGRESS_DROP_RATE       (10) /* Valid but source exceeded its rate limit (tile only) */
+#define FD_INGRESS_DROP_BACKP      (11) /* Valid but received while downstream had no room (tile only) */
+#define FD_INGRESS_DROP_MAX        (11)
+
+/* FD_INGRESS_FRAME_TAILROOM is the number of bytes past the end of a
+   received frame that ingress parsing might read (but ignore) when
+   validating checksums.  Receive buffers should have at least this
+   much readable memory past the end of each frame (true for any AF_XDP
+   UMEM frame or any receive buffer larger than the largest frame). */
+
+#define FD_INGRESS_FRAME_TAILROOM (3UL)
+
+/* FD_INGRESS_ZC_HEADROOM is the receive buffer headroom that puts the
+   UDP payload of an untagged IPv4 frame without options (i.e. at offset
+   42 of the frame) on a FD_CHUNK_ALIGN boundary when the buffer itself
+   is FD_CHUNK_ALIGN aligned (e.g. an AF_XDP UMEM frame).  A zero copy
+   ingress tile can publish such payloads in place without moving them
+   (see fd_ingress_tile). */
+
+#define FD_INGRESS_ZC_HEADROOM (FD_CHUNK_ALIGN-42UL)
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* Beyond the standard FD_CNC_SIGNAL_HALT, FD_INGRESS_CNC_SIGNAL_ACK can
+   be raised by a cnc thread with an open command session while the
+   ingress is in the RUN state.  The ingress will transition from
+   ACK->RUN the next time it processes cnc signals to indicate it is
+   running normally.  If a signal other than ACK, HALT, or RUN is
+   raised, it will be logged as unexpected and transitioned by back to
+   RUN. */
+
+#define FD_INGRESS_CNC_SIGNAL_ACK (4UL)
+
+/* A fd_ingress_tile will use the fseq and cnc application regions to
+   accumulate flow control diagnostics in the standard ways.  It
+   additionally will accumulate to the cnc application region the
+   following tile specific counters:
+
+     CHUNK_IDX   is the chunk idx where ingress tile should start publishing payloads on boot (ignored if not valid on boot)
+     RX_CNT      is the number of frames received from the rx backend
+     RX_SZ       is the number of frame bytes received from the rx backend
+     PUB_CNT     is the number of UDP payloads published by the ingress
+     PUB_SZ      is the number of UDP payload bytes published by the ingress
+     FILT_CNT    is the number of frames dropped by the ingress (for any reason)
+     FILT_SZ     is the number of frame bytes dropped by the ingress (for any reason)
+     DROP(r)     is the number of frames dropped for reason r, r in [1,FD_INGRESS_DROP_MAX]
+     ZC_CNT      is the number of UDP payloads published in place without copying (zero copy only)
+     ZC_MOVE_CNT is the number of UDP payloads published in place after moving them to a chunk boundary within their frame (zero copy only)
+
+   As such, the cnc app region must be at least FD_INGRESS_CNC_APP_SZ.
+   The standard FD_CNC_DIAG_*_TICKS duty cycle diagnostics are always
+   accumulated.  If the host supports it, the standard FD_CNC_DIAG_PERF_*
+   hardware performance counter diagnostics of the tile's thread are
+   also accumulated (see fd_perf.h).
+
+   The ingress tile does not clear its cnc diagnostics at boot.  The
+   counters accumulate over multiple runs of the tile (clearing is up
+   to monitoring scripts), IN_BACKP is simply overwritten at the first
+   housekeeping and CHUNK_IDX is read at boot such that a restarted
+   copying ingress resumes publishing where the previous run left off
+   (a zero copy ingress publishes in place and neither reads nor
+   updates CHUNK_IDX). */
+
+#define FD_INGRESS_CNC_DIAG_CHUNK_IDX (2UL) /* On 1st cache line of app region, updated by producer, frequently */
+#define FD_INGRESS_CNC_DIAG_RX_CNT    (3UL) /* ", frequently */
+#define FD_INGRESS_CNC_DIAG_RX_SZ     (4UL) /* ", frequently */
+#define FD_INGRESS_CNC_DIAG_PUB_CNT   (5UL) /* ", frequently */
+#define FD_INGRESS_CNC_DIAG_PUB_SZ    (6UL) /* ", frequently */
+#define FD_INGRESS_CNC_DIAG_FILT_CNT  (7UL) /* ", frequently */
+#define FD_INGRESS_CNC_DIAG_FILT_SZ  (12UL) /* On 2nd cache line of app region (after the tick diagnostics), frequently */
+#define FD_INGRESS_CNC_DIAG_DROP(r) (FD_CNC_DIAG_EXT-1UL+(ulong)(r)) /* After the latency histograms (see fd_cnc.h), frequently */
+#define FD_INGRESS_CNC_DIAG_ZC_CNT      (FD_CNC_DIAG_EXT+11UL)         /* ", frequently */
+#define FD_INGRESS_CNC_DIAG_ZC_MOVE_CNT (FD_CNC_DIAG_EXT+12UL)         /* ", frequently */
+
+#define FD_INGRESS_CNC_APP_SZ (FD_CNC_DIAG_EXT_OFF+128UL)
+
+/* FD_INGRESS_TILE_OUT_MAX are the maximum number of outputs an ingress
+   tile can have.  These limits are more or less arbitrary from a
+   functional correctness POV.  They mostly exist to set some practical
+   upper bounds for things like scratch footprint. */
+
+#define FD_INGRESS_TILE_OUT_MAX FD_FRAG_META_ORIG_MAX
+
+/* FD_INGRESS_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
+   footprint needed for an ingress tile scratch region that can support
+   out_cnt outputs.  ALIGN is an integer power of 2 of at least double
+   cache line to mitigate various kinds of false sharing.  FOOTPRINT
+   will be an integer multiple of ALIGN.  out_cnt is assumed to be valid
+   (i.e. at most FD_INGRESS_TILE_OUT_MAX).  These are provided to
+   facilitate compile time declarations. */
+
+#define FD_INGRESS_TILE_SCRATCH_ALIGN (128UL)
+#define FD_INGRESS_TILE_SCRATCH_FOOTPRINT( out_cnt )                     \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,    \
+    FD_FCTL_ALIGN,         FD_FCTL_FOOTPRINT( (out_cnt) ) ),             \
+    alignof(fd_aio_t),     sizeof(fd_aio_t)               ),             \
+    FD_INGRESS_TILE_SCRATCH_ALIGN )
+
+/* An fd_ingress_rx_t describes the receive path an ingress tile pulls
+   frames from.  This is typically a thin wrapper around an fd_aio
+   receive backend like fd_xsk_aio:
+
+   - set_rx(ctx,aio) tells the backend to deliver received frames to
+     aio (i.e. to call fd_aio_send( aio, batch, batch_cnt, ... ) with
+     batch[i].buf pointing to the first byte of the ethernet header of
+     a received frame and batch[i].buf_sz giving the frame size).
+     aio==NULL tells the backend to stop delivering frames.  The
+     backend should treat the aio as having been sent all frames in a
+     batch on return (the ingress never asks for retransmission).
+     Frames must have FD_INGRESS_FRAME_TAILROOM readable bytes past
+     their end and need only be valid for the duration of the call.
+
+   - service(ctx) polls the backend, delivering at most burst_max
+     frames to the aio given to set_rx.  The tile will only call this
+     when it has at least burst_max flow control credits available such
+     that a well behaved backend never has frames dropped for
+     backpressure.  (If the backend delivers more, the excess will be
+     dropped and counted as FD_INGRESS_DROP_BACKP.)
+
+   - release(ctx,frame,frame_cnt), if non-NULL, makes the receive path
+     zero copy.  Frames delivered to the aio are then owned by the tile
+     (instead of only for the duration of the call) until the tile gives
+     them back by calling release.  frame[i] for i in [0,frame_cnt)
+     points somewhere into the buffer that held a delivered frame (not
+     necessarily to its first byte, e.g. a backend with fixed size,
+     aligned buffers like AF_XDP UMEM frames can round down to find the
+     buffer).  Frames in a zero copy receive path must live in the
+     tile's dcache wksp, their buffers must start on a FD_CHUNK_ALIGN
+     boundary and their contents may be modified by the tile. */
+
+typedef void (*fd_ingress_rx_set_func_t    )( void * ctx, fd_aio_t const * aio );
+typedef void (*fd_ingress_rx_service_func_t)( void * ctx );
+typedef void (*fd_ingress_rx_release_func_t)( void * ctx, void * const * frame, ulong frame_cnt );
+
+struct fd_ingress_rx {
+  void *                       ctx;
+  fd_ingress_rx_set_func_t     set_rx;
+  fd_ingress_rx_service_func_t service;
+  fd_ingress_rx_release_func_t release; /* NULL for a copying receive path */
+  ulong                        burst_max;
+};
+
+typedef struct fd_ingress_rx fd_ingress_rx_t;
+
+#endif /* FD_HAS_HOSTED && FD_HAS_X86 */
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_ingress_parse parses the frame_sz byte ethernet frame at frame
+   (with at most one VLAN tag) as an IPv4 UDP datagram.  Returns 0 if
+   the frame holds a valid unfragmented UDP datagram with a payload of
+   at most mtu bytes and a FD_INGRESS_DROP_* reason otherwise.  If check
+   is non-zero, the IPv4 header and UDP checksums are also validated
+   (UDP datagrams without a checksum are accepted).  If check is zero,
+   the checksums are not validated (this is how the tile parses, as it
+   validates checksums in batches).
+
+   On success, *_payload_off and *_payload_sz will hold the offset from
+   frame and size of the UDP payload and *_sig will hold the frag
+   signature the ingress tile would publish for it (see
+   fd_ingress_sig).  On failure, these are not touched.  Reads at most
+   FD_INGRESS_FRAME_TAILROOM bytes past the end of the frame when
+   validating checksums.  Ethernet padding (i.e. trailing frame bytes
+   past the IPv4 total length) is ignored. */
+
+int
+fd_ingress_parse( uchar const * frame,
+                  ulong         frame_sz,
+                  ulong         mtu,
+                  int           check,
+                  ulong *       _payload_off,
+                  ulong *       _payload_sz,
+                  ulong *       _sig );
+
+/* fd_ingress_sig returns the signature an ingress tile publishes for a
+   UDP payload from source address saddr (as in fd_ip4_hdr_t, i.e. net
+   order) and net order source port net_sport to net order destination
+   port net_dport.  The source address is in the low 32 bits, the source
+   port (host order) in bits [32,48) and the destination port (host
+   order) in bits [48,64).  This lets downstream consumers filter and
+   shard by flow without touching the payload. */
+
+FD_FN_CONST static inline ulong
+fd_ingress_sig( uint   saddr,
+                ushort net_sport,
+                ushort net_dport ) {
+  return ((ulong)saddr) | (((ulong)fd_ushort_bswap( net_sport ))<<32) | (((ulong)fd_ushort_bswap( net_dport ))<<48);
+}
+
+/* fd_ingress_drop_cstr returns a human readable cstr describing drop
+   reason r.  The lifetime of the returned pointer is infinite.  The
+   returned pointer is always to a non-NULL cstr. */
+
+FD_FN_CONST char const *
+fd_ingress_drop_cstr( int r );
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* fd_ingress_tile receives frames from rx, parses and validates them
+   and publishes the UDP payloads of valid frames as a tango fragment
+   stream from origin orig into the given mcache and dcache.  Payloads
+   are copied once, from the backend's receive buffer into the dcache
+   (e.g. AF_XDP UMEM frames are returned to the fill ring as soon as the
+   backend's callback returns so they can't be referenced by frags).
+   The tile can send to out_cnt reliable consumers and an arbitrary
+   number of unreliable consumers.
+
+   If rx is zero copy (rx->release non-NULL), payloads are instead
+   published in place: each frag's chunk points into the frame the
+   payload was received in (e.g. an AF_XDP UMEM laid out over the
+   dcache's data region).  Payloads that don't start on a chunk boundary
+   are moved down to one within their frame first (this is rare if the
+   backend uses FD_INGRESS_ZC_HEADROOM).  The frames of dropped frames
+   are released immediately and the frame of a published frag is
+   released once all reliable consumers have advanced past the frag
+   (checked during housekeeping, so the backend should have enough
+   frames to cover a housekeeping interval's worth of cr_max published
+   frags in addition to its receive queue).  Frames of frags reliable
+   consumers have not yet consumed when the tile halts are not released
+   (the backend should reclaim all its frames when it is reset).  As a
+   released frame can be refilled by the backend at any time, there is
+   no way for an unreliable consumer to detect that it was overrun in
+   the middle of reading a payload, so zero copy is only suitable for
+   reliable consumers.  In zero copy mode, the tile does not write to
+   the dcache itself (it only uses it to find the wksp the frames live
+   in) and the dcache need not be compatible with mtu and depth.
+
+   Each published frag has sz equal to the payload size, sig as
+   described in fd_ingress_sig and tsorig equal to when the batch
+   containing its frame was received by the tile.  Frags are published
+   with som and eom set (each frag is a complete UDP payload).
+
+   When this is called, the cnc should be in the BOOT state.  Returns 0
+   on a successful run of the ingress tile.  That is, the tile booted
+   successfully (transitioning the cnc from BOOT->RUN), ran (handling
+   any application specific cnc signals while running), and (after
+   receiving a HALT signal) halted successfully (transitioning the cnc
+   from HALT->BOOT before return).  Returns a non-zero error code if the
+   tile fails to boot up (logs details ... the cnc will not be
+   transitioned from its original state and thus is likely bootable
+   again if its original state was BOOT).  The tile connects to rx
+   (via rx->set_rx) while running and disconnects from it before
+   returning.
+
+   If rlimit is non-NULL, each frame that passes validation takes a
+   token from its IPv4 source address' bucket in rlimit (using
+   fd_tickcount as the rlimit's clock) and frames from sources over
+   their limit are dropped as FD_INGRESS_DROP_RATE.  Rate limiting is
+   done after checksum validation such that corrupt frames (e.g. with a
+   spoofed source address) don't consume the source's tokens.
+
+   mtu is the largest UDP payload the tile will publish (larger payloads
+   are dropped as FD_INGRESS_DROP_OVERSZ).  The dcache should be
+   compatible with mtu and the mcache depth as per compact writing.
+   cr_max and lazy are as in fd_replay_tile.  rx->burst_max should be in
+   [1,cr_max].
+
+   scratch points to tile scratch memory.  fd_ingress_tile_scratch_align
+   and fd_ingress_tile_scratch_footprint return the required alignment
+   and footprint needed for this region.  This memory region is
+   exclusively owned by the ingress tile while the tile is running and
+   is ideally near the core running the ingress tile.
+   fd_ingress_tile_scratch_align will return the same value as
+   FD_INGRESS_TILE_SCRATCH_ALIGN.  If out_cnt is not valid,
+   fd_ingress_tile_scratch_footprint silently returns 0 so callers can
+   diagnose configuration issues.  Otherwise,
+   fd_ingress_tile_scratch_footprint will return the same value as
+   FD_INGRESS_TILE_SCRATCH_FOOTPRINT.
+
+   The lifetime of the cnc, rx backend, rlimit, mcache, dcache,
+   out_fseq[*], rng and scratch used by this tile should be a superset
+   of this tile's lifetime.  While this tile is running, no other tile
+   should use cnc for its command and control, service the rx backend,
+   use the rlimit, publish into mcache or dcache, use the rng for
+   anything (and the rng should be
+   seeded distinctly from all other rngs in the system), or use scratch
+   for anything.  This tile uses the fseqs passed to it in the usual
+   producer ways (e.g. discovering the location of reliable consumers in
+   the mcache's sequence space and updating producer oriented
+   diagnostics).  The out_fseq array and rx will not be used the after
+   the tile has successfully booted (transitioned the cnc from BOOT to
+   RUN) or returned (e.g. failed to boot), whichever comes first (the
+   tile keeps a copy of *rx). */
+
+FD_FN_CONST ulong
+fd_ingress_tile_scratch_align( void );
+
+FD_FN_CONST ulong
+fd_ingress_tile_scratch_footprint( ulong out_cnt );
+
+int
+fd_ingress_tile( fd_cnc_t *              cnc,      /* Local join to the ingress' command-and-control */
+                 fd_ingress_rx_t const * rx,       /* Receive path to pull frames from */
+                 fd_rlimit_t *           rlimit,   /* Local join to the per source rate limiter, NULL for no rate limiting */
+                 ulong                   mtu,      /* Largest UDP payload to publish */
+                 ulong                   orig,     /* Origin for this frag stream, in [0,FD_FRAG_META_ORIG_MAX) */
+                 fd_frag_meta_t *        mcache,   /* Local join to the ingress' frag stream output mcache */
+                 uchar *                 dcache,   /* Local join to the ingress' frag stream output dcache */
+                 ulong                   out_cnt,  /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
+                 ulong **                out_fseq, /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
+                 ulong                   cr_max,   /* Maximum number of flow control credits, 0 means use a reasonable default */
+                 long                    lazy,     /* Lazyiness, <=0 means use a reasonable default */
+                 fd_rng_t *              rng,      /* Local join to the rng this ingress should use */
+                 void *                  scratch ); /* Tile scratch memory */
+
+#endif /* FD_HAS_HOSTED && FD_HAS_X86 */
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_ingress_fd_ingress_h */
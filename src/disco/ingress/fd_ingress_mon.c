@@ -0,0 +1,124 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <stdio.h>
+
+/* fd_ingress_mon periodically reports the receive rates of a set of
+   ingress tiles given by the comma separated list of cnc gaddrs --cncs
+   (e.g. one ingress tile per NIC RX queue).  Every --interval ns, it
+   prints one line per tile with the rates of received, published and
+   filtered frames over the interval and the rate of payloads published
+   in place by zero copy tiles, followed by the total.  This makes
+   it easy to check how RSS spreads load over the queues.  Runs for
+   --duration ns (0 for until killed). */
+
+#define CNC_MAX (256UL)
+
+/* snap_query snapshots the counters of interest from an ingress tile's
+   cnc diagnostics into snap (indexed by SNAP_*). */
+
+#define SNAP_RX_CNT   (0UL)
+#define SNAP_RX_SZ    (1UL)
+#define SNAP_PUB_CNT  (2UL)
+#define SNAP_FILT_CNT (3UL)
+#define SNAP_ZC_CNT   (4UL)
+#define SNAP_CNT      (5UL)
+
+static void
+snap_query( ulong const * diag,
+            ulong *       snap ) {
+  FD_COMPILER_MFENCE();
+  snap[ SNAP_RX_CNT   ] = FD_VOLATILE_CONST( diag[ FD_INGRESS_CNC_DIAG_RX_CNT   ] );
+  snap[ SNAP_RX_SZ    ] = FD_VOLATILE_CONST( diag[ FD_INGRESS_CNC_DIAG_RX_SZ    ] );
+  snap[ SNAP_PUB_CNT  ] = FD_VOLATILE_CONST( diag[ FD_INGRESS_CNC_DIAG_PUB_CNT  ] );
+  snap[ SNAP_FILT_CNT ] = FD_VOLATILE_CONST( diag[ FD_INGRESS_CNC_DIAG_FILT_CNT ] );
+  snap[ SNAP_ZC_CNT   ] = FD_VOLATILE_CONST( diag[ FD_INGRESS_CNC_DIAG_ZC_CNT   ] );
+  FD_COMPILER_MFENCE();
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _cncs    = fd_env_strip_cmdline_cstr( &argc, &argv, "--cncs",     NULL, NULL      );
+  long         interval = fd_env_strip_cmdline_long( &argc, &argv, "--interval", NULL, (long)1e9 );
+  long         duration = fd_env_strip_cmdline_long( &argc, &argv, "--duration", NULL, 0L        );
+
+  if( FD_UNLIKELY( !_cncs       ) ) FD_LOG_ERR(( "--cncs not specified" ));
+  if( FD_UNLIKELY( interval<=0L ) ) FD_LOG_ERR(( "--interval should be positive" ));
+
+  char * _cnc[ CNC_MAX ];
+  ulong cnc_cnt = fd_cstr_tokenize( _cnc, CNC_MAX, (char *)_cncs, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( !cnc_cnt         ) ) FD_LOG_ERR(( "no --cncs specified" ));
+  if( FD_UNLIKELY( cnc_cnt>CNC_MAX  ) ) FD_LOG_ERR(( "too many --cncs specified for current implementation" ));
+
+  fd_cnc_t *    cnc [ CNC_MAX ];
+  ulong const * diag[ CNC_MAX ];
+  for( ulong cnc_idx=0UL; cnc_idx<cnc_cnt; cnc_idx++ ) {
+    FD_LOG_NOTICE(( "Joining --cncs[%lu] %s", cnc_idx, _cnc[ cnc_idx ] ));
+    cnc[ cnc_idx ] = fd_cnc_join( fd_wksp_map( _cnc[ cnc_idx ] ) );
+    if( FD_UNLIKELY( !cnc[ cnc_idx ] ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+    if( FD_UNLIKELY( fd_cnc_app_sz( cnc[ cnc_idx ] )<FD_INGRESS_CNC_APP_SZ ) ) FD_LOG_ERR(( "cnc app sz too small" ));
+    diag[ cnc_idx ] = (ulong const *)fd_cnc_app_laddr_const( cnc[ cnc_idx ] );
+  }
+
+  /* Counters snapshotted at the start of the current interval */
+
+  static ulong snap[ CNC_MAX ][ SNAP_CNT ];
+  for( ulong cnc_idx=0UL; cnc_idx<cnc_cnt; cnc_idx++ ) snap_query( diag[ cnc_idx ], snap[ cnc_idx ] );
+
+  long then = fd_log_wallclock();
+  long stop = duration>0L ? then + duration : LONG_MAX;
+  for(;;) {
+    fd_log_sleep( interval );
+    long now = fd_log_wallclock();
+    double dt = 1e-9*(double)(now - then);
+
+    printf( "\n  queue  signal      rx pkt/s     rx Gbit/s     pub pkt/s    filt pkt/s      zc pkt/s\n" );
+    double tot_rx_rate = 0.; double tot_rx_bps = 0.; double tot_pub_rate = 0.; double tot_filt_rate = 0.; double tot_zc_rate = 0.;
+    for( ulong cnc_idx=0UL; cnc_idx<cnc_cnt; cnc_idx++ ) {
+      ulong now_snap[ SNAP_CNT ];
+      snap_query( diag[ cnc_idx ], now_snap );
+
+      double rx_rate   = (double)(now_snap[ SNAP_RX_CNT   ] - snap[ cnc_idx ][ SNAP_RX_CNT   ]) / dt;
+      double rx_bps    = (double)(now_snap[ SNAP_RX_SZ    ] - snap[ cnc_idx ][ SNAP_RX_SZ    ]) * 8. / dt;
+      double pub_rate  = (double)(now_snap[ SNAP_PUB_CNT  ] - snap[ cnc_idx ][ SNAP_PUB_CNT  ]) / dt;
+      double filt_rate = (double)(now_snap[ SNAP_FILT_CNT ] - snap[ cnc_idx ][ SNAP_FILT_CNT ]) / dt;
+      double zc_rate   = (double)(now_snap[ SNAP_ZC_CNT   ] - snap[ cnc_idx ][ SNAP_ZC_CNT   ]) / dt;
+      tot_rx_rate += rx_rate; tot_rx_bps += rx_bps; tot_pub_rate += pub_rate; tot_filt_rate += filt_rate; tot_zc_rate += zc_rate;
+
+      char buf[ FD_CNC_SIGNAL_CSTR_BUF_MAX ];
+      printf( "  %5lu  %6s  %12.3e  %12.3f  %12.3e  %12.3e  %12.3e\n", cnc_idx,
+              fd_cnc_signal_cstr( fd_cnc_signal_query( cnc[ cnc_idx ] ), buf ),
+              rx_rate, 1e-9*rx_bps, pub_rate, filt_rate, zc_rate );
+
+      memcpy( snap[ cnc_idx ], now_snap, sizeof(now_snap) );
+    }
+    printf( "  total          %12.3e  %12.3f  %12.3e  %12.3e  %12.3e\n",
+            tot_rx_rate, 1e-9*tot_rx_bps, tot_pub_rate, tot_filt_rate, tot_zc_rate );
+    fflush( stdout );
+
+    then = now;
+    if( now>=stop ) break;
+  }
+
+  for( ulong cnc_idx=cnc_cnt; cnc_idx; cnc_idx-- ) fd_wksp_unmap( fd_cnc_leave( cnc[ cnc_idx-1UL ] ) );
+
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_ERR(( "fd_ingress_mon not supported on this platform" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
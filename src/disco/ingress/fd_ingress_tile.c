@@ -0,0 +1,292 @@
+#include "../fd_disco.h"
+
+#if FD_HAS_HOSTED && FD_HAS_X86 && defined(__linux__)
+
+#include "../../tango/xdp/fd_xsk_aio.h"
+
+FD_STATIC_ASSERT( FD_INGRESS_TILE_SCRATCH_ALIGN<=FD_SHMEM_HUGE_PAGE_SZ, alignment );
+
+/* The ingress tile pulls frames from an AF_XDP socket bound to
+   --ifname / --ifqueue (the XDP redirect program for --app-name should
+   already be installed on the interface). */
+
+static void
+xsk_rx_set( void *           ctx,
+            fd_aio_t const * aio ) {
+  fd_aio_t null_aio[1];
+  if( !aio ) { memset( null_aio, 0, sizeof(fd_aio_t) ); aio = null_aio; } /* Frames received while disconnected are discarded */
+  fd_xsk_aio_set_rx( (fd_xsk_aio_t *)ctx, aio );
+}
+
+static void
+xsk_rx_service( void * ctx ) {
+  fd_xsk_aio_service( (fd_xsk_aio_t *)ctx );
+}
+
+/* With --zero-copy, the tile instead lays the XSK UMEM over the data
+   region of --dcache and uses the zero copy backend below: received
+   frames are handed to the tile in place and only go back to the fill
+   ring once the tile releases them (i.e. once all reliable consumers
+   are done with them).  Frames are located by rounding a payload
+   address down to a frame boundary. */
+
+struct xsk_zc {
+  fd_xsk_t *            xsk;
+  uchar *               umem;      /* Local address of the UMEM (frame_sz aligned) */
+  ulong                 frame_sz;
+  ulong                 burst_max;
+  fd_aio_t              aio[1];    /* Where to deliver received frames, send_func NULL when disconnected */
+  fd_xsk_frame_meta_t * meta;      /* Indexed [0,burst_max) */
+  fd_aio_pkt_info_t *   pkt;       /* Indexed [0,burst_max) */
+};
+
+typedef struct xsk_zc xsk_zc_t;
+
+#define XSK_ZC_RELEASE_BATCH (64UL)
+
+static ulong
+xsk_zc_footprint( ulong burst_max ) {
+  return fd_ulong_align_up( sizeof(xsk_zc_t), FD_XDP_FRAME_META_ALIGN ) + burst_max*sizeof(fd_xsk_frame_meta_t)
+       + burst_max*sizeof(fd_aio_pkt_info_t);
+}
+
+static void
+xsk_zc_rx_set( void *           ctx,
+               fd_aio_t const * aio ) {
+  xsk_zc_t * zc = (xsk_zc_t *)ctx;
+  if( aio ) *zc->aio = *aio;
+  else      memset( zc->aio, 0, sizeof(fd_aio_t) );
+}
+
+static void
+xsk_zc_rx_service( void * ctx ) {
+  xsk_zc_t *            zc   = (xsk_zc_t *)ctx;
+  fd_xsk_frame_meta_t * meta = zc->meta;
+  fd_aio_pkt_info_t *   pkt  = zc->pkt;
+
+  ulong rx_cnt = fd_xsk_rx_complete( zc->xsk, meta, zc->burst_max );
+  if( !rx_cnt ) return;
+
+  for( ulong i=0UL; i<rx_cnt; i++ ) pkt[i] = (fd_aio_pkt_info_t) { .buf = zc->umem + meta[i].off, .buf_sz = (ushort)meta[i].sz };
+
+  if( FD_LIKELY( zc->aio->send_func ) ) {
+    fd_aio_send( zc->aio, pkt, rx_cnt, NULL ); /* The tile releases every frame it was given */
+  } else {
+    /* Frames received while disconnected are discarded */
+    ulong enq_cnt = fd_xsk_rx_enqueue2( zc->xsk, meta, rx_cnt );
+    if( FD_UNLIKELY( enq_cnt<rx_cnt ) ) FD_LOG_WARNING(( "frames lost trying to replenish fill ring" ));
+  }
+}
+
+static void
+xsk_zc_rx_release( void *         ctx,
+                   void * const * frame,
+                   ulong          frame_cnt ) {
+  xsk_zc_t * zc = (xsk_zc_t *)ctx;
+  ulong off[ XSK_ZC_RELEASE_BATCH ];
+  while( frame_cnt ) {
+    ulong batch_cnt = fd_ulong_min( frame_cnt, XSK_ZC_RELEASE_BATCH );
+    for( ulong i=0UL; i<batch_cnt; i++ ) off[i] = fd_ulong_align_dn( (ulong)frame[i] - (ulong)zc->umem, zc->frame_sz );
+    ulong enq_cnt = fd_xsk_rx_enqueue( zc->xsk, off, batch_cnt );
+    if( FD_UNLIKELY( enq_cnt<batch_cnt ) ) FD_LOG_WARNING(( "frames lost trying to replenish fill ring" ));
+    frame += batch_cnt; frame_cnt -= batch_cnt;
+  }
+}
+
+static void *
+shmem_acquire( ulong   footprint,
+               ulong   cpu_idx,
+               ulong * _page_cnt ) {
+  ulong  page_sz  = FD_SHMEM_HUGE_PAGE_SZ;
+  ulong  page_cnt = fd_ulong_align_up( footprint, page_sz ) / page_sz;
+  void * mem      = fd_shmem_acquire( page_sz, page_cnt, cpu_idx );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "fd_shmem_acquire failed (need at least %lu free huge pages on numa node %lu)",
+                                         page_cnt, fd_shmem_numa_idx( cpu_idx ) ));
+  *_page_cnt = page_cnt;
+  return mem;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  FD_LOG_NOTICE(( "Init" ));
+
+  char const * _cnc       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",            NULL, NULL         );
+  char const * app_name   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--app-name",       NULL, "firedancer" );
+  char const * ifname     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--ifname",         NULL, NULL         );
+  uint         ifqueue    = fd_env_strip_cmdline_uint ( &argc, &argv, "--ifqueue",        NULL, 0U           );
+  ulong        frame_sz   = fd_env_strip_cmdline_ulong( &argc, &argv, "--frame-sz",       NULL, 2048UL       );
+  ulong        xsk_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--xsk-depth",      NULL, 1024UL       );
+  ulong        burst_max  = fd_env_strip_cmdline_ulong( &argc, &argv, "--burst-max",      NULL, 64UL         );
+  ulong        mtu        = fd_env_strip_cmdline_ulong( &argc, &argv, "--mtu",            NULL, 1472UL       );
+  ulong        orig       = fd_env_strip_cmdline_ulong( &argc, &argv, "--orig",           NULL, 0UL          );
+  char const * _mcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",         NULL, NULL         );
+  char const * _dcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--dcache",         NULL, NULL         );
+  char const * _out_fseqs = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",      NULL, ""           );
+  ulong        cr_max     = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",         NULL, 0UL          ); /*   0 <> use default */
+  long         lazy       = fd_env_strip_cmdline_long ( &argc, &argv, "--lazy",           NULL, 0L           ); /* <=0 <> use default */
+  float        rl_rate    = fd_env_strip_cmdline_float( &argc, &argv, "--rlimit-rate",    NULL, 0.f          ); /* pkt/s per source, 0 <> off */
+  ulong        rl_burst   = fd_env_strip_cmdline_ulong( &argc, &argv, "--rlimit-burst",   NULL, 64UL         );
+  ulong        rl_set_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--rlimit-set-cnt", NULL, 1UL<<16      );
+  uint         seed       = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",           NULL, (uint)(ulong)fd_tickcount() );
+  int          zero_copy  = fd_env_strip_cmdline_int  ( &argc, &argv, "--zero-copy",      NULL, 0            ); /* non-zero <> UMEM over --dcache */
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+
+  if( FD_UNLIKELY( !_cnc ) ) FD_LOG_ERR(( "--cnc not specified" ));
+  FD_LOG_NOTICE(( "Joining --cnc %s", _cnc ));
+  fd_cnc_t * cnc = fd_cnc_join( fd_wksp_map( _cnc ) );
+  if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
+
+  if( FD_UNLIKELY( !_mcache ) ) FD_LOG_ERR(( "--mcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --mcache %s", _mcache ));
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_map( _mcache ) );
+  if( FD_UNLIKELY( !mcache ) ) FD_LOG_ERR(( "fd_mcache_join failed" ));
+
+  if( FD_UNLIKELY( !_dcache ) ) FD_LOG_ERR(( "--dcache not specified" ));
+  FD_LOG_NOTICE(( "Joining --dcache %s", _dcache ));
+  uchar * dcache = fd_dcache_join( fd_wksp_map( _dcache ) );
+  if( FD_UNLIKELY( !dcache ) ) FD_LOG_ERR(( "fd_dcache_join failed" ));
+
+  if( FD_UNLIKELY( !ifname ) ) FD_LOG_ERR(( "--ifname not specified" ));
+
+  fd_xsk_t *      xsk;
+  ulong           xsk_page_cnt;
+  fd_xsk_aio_t *  xsk_aio = NULL;
+  ulong           xsk_aio_page_cnt = 0UL;
+  xsk_zc_t *      zc      = NULL;
+  ulong           zc_page_cnt = 0UL;
+  fd_ingress_rx_t rx[1];
+
+  if( !zero_copy ) {
+
+    FD_LOG_NOTICE(( "Creating xsk (--app-name %s, --ifname %s, --ifqueue %u, --frame-sz %lu, --xsk-depth %lu)",
+                    app_name, ifname, ifqueue, frame_sz, xsk_depth ));
+    ulong xsk_footprint = fd_xsk_footprint( frame_sz, xsk_depth, xsk_depth, xsk_depth, xsk_depth );
+    if( FD_UNLIKELY( !xsk_footprint ) ) FD_LOG_ERR(( "bad --frame-sz and/or --xsk-depth" ));
+    void * xsk_mem = shmem_acquire( xsk_footprint, cpu_idx, &xsk_page_cnt );
+    xsk = fd_xsk_join( fd_xsk_bind( fd_xsk_new( xsk_mem, frame_sz, xsk_depth, xsk_depth, xsk_depth, xsk_depth ),
+                                    app_name, ifname, ifqueue ) );
+    if( FD_UNLIKELY( !xsk ) ) FD_LOG_ERR(( "fd_xsk_join failed" ));
+
+    FD_LOG_NOTICE(( "Creating xsk_aio (--burst-max %lu)", burst_max ));
+    void * xsk_aio_mem = shmem_acquire( fd_xsk_aio_footprint( xsk_depth, burst_max ), cpu_idx, &xsk_aio_page_cnt );
+    xsk_aio = fd_xsk_aio_join( fd_xsk_aio_new( xsk_aio_mem, xsk_depth, burst_max ), xsk );
+    if( FD_UNLIKELY( !xsk_aio ) ) FD_LOG_ERR(( "fd_xsk_aio_join failed" ));
+
+    *rx = (fd_ingress_rx_t){ .ctx = xsk_aio, .set_rx = xsk_rx_set, .service = xsk_rx_service, .release = NULL, .burst_max = burst_max };
+
+  } else {
+
+    /* UMEM is the largest frame_sz multiple that fits in the dcache
+       data region once aligned for XSK */
+
+    ulong umem     = fd_ulong_align_up( (ulong)dcache, FD_XSK_UMEM_ALIGN );
+    ulong data_end = (ulong)dcache + fd_dcache_data_sz( dcache );
+    ulong umem_sz  = umem<data_end ? fd_ulong_align_dn( data_end - umem, frame_sz ) : 0UL;
+    if( FD_UNLIKELY( !umem_sz ) ) FD_LOG_ERR(( "--dcache too small for a --zero-copy UMEM" ));
+    ulong frame_cnt = umem_sz / frame_sz;
+
+    FD_LOG_NOTICE(( "Creating zero copy xsk (--app-name %s, --ifname %s, --ifqueue %u, --frame-sz %lu, --xsk-depth %lu; "
+                    "%lu frames over --dcache)", app_name, ifname, ifqueue, frame_sz, xsk_depth, frame_cnt ));
+    void * xsk_mem = shmem_acquire( fd_xsk_footprint_umem(), cpu_idx, &xsk_page_cnt );
+    xsk = fd_xsk_join( fd_xsk_bind( fd_xsk_new_umem( xsk_mem, (void *)umem, umem_sz, frame_sz, FD_INGRESS_ZC_HEADROOM,
+                                                     fd_ulong_pow2_up( frame_cnt ), xsk_depth, xsk_depth, xsk_depth ),
+                                    app_name, ifname, ifqueue ) );
+    if( FD_UNLIKELY( !xsk ) ) FD_LOG_ERR(( "fd_xsk_join failed" ));
+
+    FD_LOG_NOTICE(( "Creating zero copy rx (--burst-max %lu)", burst_max ));
+    uchar * zc_mem = (uchar *)shmem_acquire( xsk_zc_footprint( burst_max ), cpu_idx, &zc_page_cnt );
+    zc            = (xsk_zc_t *)zc_mem;
+    zc->xsk       = xsk;
+    zc->umem      = (uchar *)umem;
+    zc->frame_sz  = frame_sz;
+    zc->burst_max = burst_max;
+    memset( zc->aio, 0, sizeof(fd_aio_t) );
+    zc->meta      = (fd_xsk_frame_meta_t *)(zc_mem + fd_ulong_align_up( sizeof(xsk_zc_t), FD_XDP_FRAME_META_ALIGN ));
+    zc->pkt       = (fd_aio_pkt_info_t   *)(zc->meta + burst_max);
+
+    /* Give the kernel all the frames to start */
+
+    for( ulong frame_idx=0UL; frame_idx<frame_cnt; frame_idx++ ) {
+      ulong off = frame_idx*frame_sz;
+      if( FD_UNLIKELY( fd_xsk_rx_enqueue( xsk, &off, 1UL )!=1UL ) ) FD_LOG_ERR(( "fd_xsk_rx_enqueue failed" ));
+    }
+
+    *rx = (fd_ingress_rx_t){ .ctx = zc, .set_rx = xsk_zc_rx_set, .service = xsk_zc_rx_service, .release = xsk_zc_rx_release,
+                             .burst_max = burst_max };
+
+  }
+
+  char * _out_fseq[ 256 ];
+  ulong out_cnt = fd_cstr_tokenize( _out_fseq, 256UL, (char *)_out_fseqs, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( out_cnt>256UL ) ) FD_LOG_ERR(( "too many --out-fseqs specified for current implementation" ));
+
+  ulong * out_fseq[ 256 ];
+  for( ulong out_idx=0UL; out_idx<out_cnt; out_idx++ ) {
+    FD_LOG_NOTICE(( "Joining --out-fseqs[%lu] %s", out_idx, _out_fseq[ out_idx ] ));
+    out_fseq[ out_idx ] = fd_fseq_join( fd_wksp_map( _out_fseq[ out_idx ] ) );
+    if( FD_UNLIKELY( !out_fseq[ out_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
+  }
+
+  FD_LOG_NOTICE(( "Using --mtu %lu, --orig %lu, --cr-max %lu, --lazy %li", mtu, orig, cr_max, lazy ));
+
+  FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
+
+  fd_rlimit_t * rlimit = NULL;
+  ulong         rlimit_page_cnt = 0UL;
+  if( rl_rate>0.f ) {
+    ulong interval = fd_rlimit_rate_to_interval( 1e9*fd_tempo_tick_per_ns( NULL ), (double)rl_rate );
+    FD_LOG_NOTICE(( "Creating rlimit (--rlimit-rate %.1f, --rlimit-burst %lu, --rlimit-set-cnt %lu; interval %lu ticks)",
+                    (double)rl_rate, rl_burst, rl_set_cnt, interval ));
+    ulong rlimit_footprint = fd_rlimit_footprint( rl_set_cnt );
+    if( FD_UNLIKELY( !rlimit_footprint ) ) FD_LOG_ERR(( "bad --rlimit-set-cnt" ));
+    void * rlimit_mem = shmem_acquire( rlimit_footprint, cpu_idx, &rlimit_page_cnt );
+    rlimit = fd_rlimit_join( fd_rlimit_new( rlimit_mem, rl_set_cnt, interval, rl_burst, fd_rng_ulong( rng ) ) );
+    if( FD_UNLIKELY( !rlimit ) ) FD_LOG_ERR(( "fd_rlimit_join failed" ));
+  }
+
+  FD_LOG_NOTICE(( "Creating scratch" ));
+  ulong footprint = fd_ingress_tile_scratch_footprint( out_cnt );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_ingress_tile_scratch_footprint failed" ));
+  ulong  scratch_page_cnt;
+  void * scratch = shmem_acquire( footprint, cpu_idx, &scratch_page_cnt );
+
+  FD_LOG_NOTICE(( "Run" ));
+
+  int err = fd_ingress_tile( cnc, rx, rlimit, mtu, orig, mcache, dcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_ingress_tile failed (%i)", err ));
+
+  FD_LOG_NOTICE(( "Fini" ));
+
+  fd_shmem_release( scratch, FD_SHMEM_HUGE_PAGE_SZ, scratch_page_cnt );
+  if( rlimit ) fd_shmem_release( fd_rlimit_delete( fd_rlimit_leave( rlimit ) ), FD_SHMEM_HUGE_PAGE_SZ, rlimit_page_cnt );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_fseq_leave( out_fseq[ out_idx-1UL ] ) );
+  if( zc      ) fd_shmem_release( zc, FD_SHMEM_HUGE_PAGE_SZ, zc_page_cnt );
+  if( xsk_aio ) fd_shmem_release( fd_xsk_aio_delete( fd_xsk_aio_leave( xsk_aio ) ), FD_SHMEM_HUGE_PAGE_SZ, xsk_aio_page_cnt );
+  fd_shmem_release( fd_xsk_delete( fd_xsk_unbind( fd_xsk_leave( xsk ) ) ), FD_SHMEM_HUGE_PAGE_SZ, xsk_page_cnt );
+  fd_wksp_unmap( fd_dcache_leave( dcache ) ); /* After unbind as the UMEM might be over it */
+  fd_wksp_unmap( fd_mcache_leave( mcache ) );
+  fd_wksp_unmap( fd_cnc_leave( cnc ) );
+
+  fd_halt();
+  return err;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "implement support for this build target" ));
+  fd_halt();
+  return 1;
+}
+
+#endif
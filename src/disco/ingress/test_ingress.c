@@ -0,0 +1,686 @@
+#include "../fd_disco.h"
+#include "../../util/net/fd_eth.h"
+#include "../../util/net/fd_udp.h"
+#include "../../util/net/fd_pcap.h"
+
+FD_STATIC_ASSERT( FD_INGRESS_DROP_TRUNC    == 1, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_ETH      == 2, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_IP4      == 3, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_FRAG     == 4, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_PROTO    == 5, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_UDP      == 6, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_OVERSZ   == 7, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_IP4_CHECK== 8, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_UDP_CHECK== 9, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_RATE     ==10, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_BACKP    ==11, unit_test );
+FD_STATIC_ASSERT( FD_INGRESS_DROP_MAX      ==11, unit_test );
+
+/* PARSE_REASON_CNT is the number of outcomes of fd_ingress_parse (the
+   remaining reasons are tile only) */
+
+#define PARSE_REASON_CNT (FD_INGRESS_DROP_UDP_CHECK+1)
+
+FD_STATIC_ASSERT( FD_INGRESS_FRAME_TAILROOM==3UL, unit_test );
+
+#define FRAME_MAX (2048UL)
+
+/* build_frame writes to frame a valid ethernet frame (with a VLAN tag if
+   vlan is set) holding an ip4 header (with opt_sz bytes of options,
+   opt_sz a multiple of 4 at most 40) and a udp datagram with a random
+   payload_sz byte payload followed by pad_sz bytes of ethernet padding.
+   The source address is *opt_saddr if opt_saddr is non-NULL and random
+   otherwise.  The udp checksum is omitted if no_check is set.  Returns the frame
+   size.  *_payload_off and *_sig will hold the payload offset and
+   expected frag signature. */
+
+static ulong
+build_frame( fd_rng_t * rng,
+             uchar *    frame,
+             ulong      payload_sz,
+             int        vlan,
+             ulong      opt_sz,
+             ulong      pad_sz,
+             int        no_check,
+             uint const * opt_saddr,
+             ulong *    _payload_off,
+             ulong *    _sig ) {
+  ulong off = 0UL;
+
+  fd_eth_hdr_t * eth = (fd_eth_hdr_t *)frame;
+  for( ulong i=0UL; i<6UL; i++ ) eth->dst[i] = fd_rng_uchar( rng );
+  for( ulong i=0UL; i<6UL; i++ ) eth->src[i] = fd_rng_uchar( rng );
+  off += sizeof(fd_eth_hdr_t);
+  if( vlan ) {
+    eth->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_VLAN );
+    fd_vlan_tag_t * tag = (fd_vlan_tag_t *)(frame+off);
+    tag->net_vid  = fd_ushort_bswap( (ushort)fd_rng_uint_roll( rng, 4096U ) );
+    tag->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
+    off += sizeof(fd_vlan_tag_t);
+  } else {
+    eth->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
+  }
+
+  ulong          hdr_sz = 20UL + opt_sz;
+  fd_ip4_hdr_t * ip4    = (fd_ip4_hdr_t *)(frame+off);
+  frame[off]            = (uchar)(0x40UL | (hdr_sz>>2)); /* version 4, ihl */
+  ip4->tos              = (uchar)0;
+  ip4->net_tot_len      = fd_ushort_bswap( (ushort)(hdr_sz+8UL+payload_sz) );
+  ip4->net_id           = fd_rng_ushort( rng );
+  ip4->net_frag_off     = fd_ushort_bswap( fd_rng_uint_roll( rng, 2U ) ? FD_IP4_HDR_FRAG_OFF_DF : (ushort)0 );
+  ip4->ttl              = (uchar)64;
+  ip4->protocol         = FD_IP4_HDR_PROTOCOL_UDP;
+  ip4->check            = (ushort)0;
+  ip4->saddr            = opt_saddr ? *opt_saddr : fd_rng_uint( rng );
+  ip4->daddr            = fd_rng_uint( rng );
+  for( ulong i=0UL; i<opt_sz; i++ ) frame[ off+20UL+i ] = (uchar)1; /* NOP options */
+  ip4->check            = fd_ip4_hdr_check( ip4 );
+  off += hdr_sz;
+
+  fd_udp_hdr_t * udp = (fd_udp_hdr_t *)(frame+off);
+  udp->net_sport = fd_rng_ushort( rng );
+  udp->net_dport = fd_rng_ushort( rng );
+  udp->net_len   = fd_ushort_bswap( (ushort)(8UL+payload_sz) );
+  udp->check     = (ushort)0;
+  off += sizeof(fd_udp_hdr_t);
+
+  for( ulong i=0UL; i<payload_sz+pad_sz+FD_INGRESS_FRAME_TAILROOM; i++ ) frame[ off+i ] = fd_rng_uchar( rng );
+
+  if( !no_check ) {
+    udp->check = fd_ip4_udp_check( ip4->saddr, ip4->daddr, udp, frame+off );
+    if( !udp->check ) udp->check = (ushort)0xffff; /* (0 and 0xffff are equivalent in one's complement) */
+  }
+
+  *_payload_off = off;
+  *_sig         = fd_ingress_sig( ip4->saddr, udp->net_sport, udp->net_dport );
+  return off + payload_sz + pad_sz;
+}
+
+/* make_frame builds a random frame that ingress parsing with the given
+   mtu should report as reason (reason 0 is a valid frame) from source
+   address *opt_saddr (random if opt_saddr is NULL).  Frames
+   will be larger than an ethernet header (such that they can be round
+   tripped through a pcap with the last 4 bytes as the "FCS"). */
+
+static ulong
+make_frame( fd_rng_t * rng,
+            uchar *    frame,
+            int        reason,
+            ulong      mtu,
+            uint const * opt_saddr,
+            ulong *    _payload_off,
+            ulong *    _payload_sz,
+            ulong *    _sig ) {
+  int   vlan    = !fd_rng_uint_roll( rng, 4U );
+  ulong opt_sz  = fd_rng_uint_roll( rng, 4U ) ? 0UL : 4UL*fd_rng_ulong_roll( rng, 11UL );
+  ulong pad_sz  = fd_rng_uint_roll( rng, 4U ) ? 0UL : fd_rng_ulong_roll( rng, 32UL );
+  ulong max_sz  = fd_ulong_min( mtu, 1472UL - opt_sz );
+  ulong pay_sz  = fd_rng_uint_roll( rng, 2U ) ? fd_rng_ulong_roll( rng, fd_ulong_min( max_sz, 64UL )+1UL )
+                                              : fd_rng_ulong_roll( rng, max_sz+1UL );
+  int no_check  = !fd_rng_uint_roll( rng, 8U );
+  if( reason==FD_INGRESS_DROP_UDP_CHECK ) { no_check = 0; pay_sz = fd_ulong_max( pay_sz, 1UL ); }
+  if( reason==FD_INGRESS_DROP_OVERSZ    ) pay_sz = mtu + 1UL + fd_rng_ulong_roll( rng, 16UL );
+
+  ulong payload_off;
+  ulong sig;
+  ulong sz = build_frame( rng, frame, pay_sz, vlan, opt_sz, pad_sz, no_check, opt_saddr, &payload_off, &sig );
+
+  ulong          l3_off = vlan ? 18UL : 14UL;
+  fd_ip4_hdr_t * ip4    = (fd_ip4_hdr_t *)(frame+l3_off);
+  ulong          hdr_sz = 20UL + opt_sz;
+  fd_udp_hdr_t * udp    = (fd_udp_hdr_t *)(frame+l3_off+hdr_sz);
+
+  switch( reason ) {
+  case FD_INGRESS_DROP_TRUNC: { /* Cut the frame somewhere before the end of the ip4 packet */
+    ulong end = l3_off + hdr_sz + 8UL + pay_sz;
+    sz = 15UL + fd_rng_ulong_roll( rng, end-15UL );
+    break;
+  }
+  case FD_INGRESS_DROP_ETH: {
+    ushort type = fd_rng_uint_roll( rng, 2U ) ? FD_ETH_HDR_TYPE_ARP : (ushort)0x86dd; /* IPv6 */
+    if( vlan ) ((fd_vlan_tag_t *)(frame+14UL))->net_type = fd_ushort_bswap( type );
+    else       ((fd_eth_hdr_t  *) frame       )->net_type = fd_ushort_bswap( type );
+    break;
+  }
+  case FD_INGRESS_DROP_IP4: {
+    switch( fd_rng_uint_roll( rng, 3U ) ) {
+    case 0U: frame[l3_off] = (uchar)((frame[l3_off] & 0x0fU) | (fd_rng_uint_roll( rng, 2U ) ? 0x60U : 0x00U)); break; /* version */
+    case 1U: frame[l3_off] = (uchar)(0x40U | fd_rng_uint_roll( rng, 5U ));                                       break; /* ihl<5 */
+    default: ip4->net_tot_len = fd_ushort_bswap( (ushort)fd_rng_ulong_roll( rng, hdr_sz ) );                     break; /* tot_len<hdr */
+    }
+    break;
+  }
+  case FD_INGRESS_DROP_FRAG: {
+    ushort frag_off = fd_rng_uint_roll( rng, 2U ) ? FD_IP4_HDR_FRAG_OFF_MF
+                    : (ushort)(1U + fd_rng_uint_roll( rng, (uint)FD_IP4_HDR_FRAG_OFF_MASK ));
+    ip4->net_frag_off = fd_ushort_bswap( frag_off );
+    break;
+  }
+  case FD_INGRESS_DROP_PROTO: {
+    ip4->protocol = fd_rng_uint_roll( rng, 2U ) ? FD_IP4_HDR_PROTOCOL_TCP : FD_IP4_HDR_PROTOCOL_ICMP;
+    break;
+  }
+  case FD_INGRESS_DROP_UDP: {
+    if( fd_rng_uint_roll( rng, 2U ) ) udp->net_len = fd_ushort_bswap( (ushort)fd_rng_ulong_roll( rng, 8UL ) );
+    else                              udp->net_len = fd_ushort_bswap( (ushort)(8UL+pay_sz+1UL+fd_rng_ulong_roll( rng, 8UL )) );
+    break;
+  }
+  case FD_INGRESS_DROP_IP4_CHECK: {
+    ip4->ttl = (uchar)(ip4->ttl ^ (1U<<fd_rng_uint_roll( rng, 8U )));
+    break;
+  }
+  case FD_INGRESS_DROP_UDP_CHECK: {
+    uchar * p = frame + payload_off + fd_rng_ulong_roll( rng, pay_sz );
+    *p = (uchar)(*p ^ (1U<<fd_rng_uint_roll( rng, 8U )));
+    break;
+  }
+  default: break;
+  }
+
+  *_payload_off = payload_off;
+  *_payload_sz  = pay_sz;
+  *_sig         = sig;
+  return sz;
+}
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#include <stdio.h>
+
+/* pcap_rx is an fd_ingress_rx_t stand-in for a network receive path.
+   It reads frames from a pcap stream and delivers them to the ingress'
+   aio in randomly sized bursts of at most BURST_MAX frames.
+
+   If zc, it is a zero copy receive path modeled after an AF_XDP socket
+   with its UMEM laid out over a dcache's data region: each frame is
+   read into a free FRAME_MAX byte frame of the UMEM (after
+   FD_INGRESS_ZC_HEADROOM bytes of headroom) and the frame is held until
+   the ingress releases it. */
+
+#define BURST_MAX (16UL)
+
+struct pcap_rx {
+  fd_pcap_iter_t * iter;
+  fd_rng_t *       rng;
+  fd_aio_t         aio[1];
+  int              connected;
+  int              done;
+  uchar            buf[ BURST_MAX ][ FRAME_MAX ];
+
+  /* zero copy state */
+  int              zc;
+  uchar *          umem;      /* FRAME_MAX aligned */
+  ulong            frame_cnt; /* frames in the umem */
+  ulong *          free;      /* stack of indices of free frames, indexed [0,free_cnt) */
+  ulong            free_cnt;
+  uchar *          held;      /* held[ frame_idx ] is 1 if the frame is held by the ingress */
+  ulong            rel_cnt;   /* number of frames released */
+};
+
+typedef struct pcap_rx pcap_rx_t;
+
+static void
+pcap_rx_set( void *           ctx,
+             fd_aio_t const * aio ) {
+  pcap_rx_t * rx = (pcap_rx_t *)ctx;
+  if( aio ) rx->aio[0] = aio[0];
+  rx->connected = !!aio;
+}
+
+static void
+pcap_rx_service( void * ctx ) {
+  pcap_rx_t * rx = (pcap_rx_t *)ctx;
+  if( FD_UNLIKELY( rx->done ) ) return;
+
+  fd_aio_pkt_info_t batch[ BURST_MAX ];
+  ulong             batch_cnt = 0UL;
+  ulong             burst     = 1UL + fd_rng_ulong_roll( rx->rng, BURST_MAX );
+  if( rx->zc ) burst = fd_ulong_min( burst, rx->free_cnt ); /* Out of frames (a NIC would drop here) */
+  while( batch_cnt<burst ) {
+    uchar * buf;
+    ulong   frame_idx = 0UL;
+    if( rx->zc ) { frame_idx = rx->free[ rx->free_cnt-1UL ]; buf = rx->umem + frame_idx*FRAME_MAX + FD_INGRESS_ZC_HEADROOM; }
+    else         buf = rx->buf[ batch_cnt ];
+    long  ts;
+    ulong sz = fd_pcap_iter_next( rx->iter, buf, FRAME_MAX-FD_INGRESS_ZC_HEADROOM-FD_INGRESS_FRAME_TAILROOM, &ts );
+    if( FD_UNLIKELY( !sz ) ) { FD_COMPILER_MFENCE(); FD_VOLATILE( rx->done ) = 1; break; }
+    if( rx->zc ) {
+      rx->free_cnt--;
+      FD_TEST( !rx->held[ frame_idx ] );
+      FD_VOLATILE( rx->held[ frame_idx ] ) = (uchar)1;
+    }
+    batch[ batch_cnt ].buf    = buf;
+    batch[ batch_cnt ].buf_sz = (ushort)sz;
+    batch_cnt++;
+  }
+  if( FD_LIKELY( batch_cnt && rx->connected ) ) FD_TEST( !fd_aio_send( rx->aio, batch, batch_cnt, NULL ) );
+}
+
+static void
+pcap_rx_release( void *         ctx,
+                 void * const * frame,
+                 ulong          frame_cnt ) {
+  pcap_rx_t * rx = (pcap_rx_t *)ctx;
+  FD_TEST( rx->zc );
+  FD_TEST( (1UL<=frame_cnt) & (frame_cnt<=64UL) );
+  for( ulong i=0UL; i<frame_cnt; i++ ) {
+    ulong off       = (ulong)frame[i] - (ulong)rx->umem;
+    ulong frame_idx = off / FRAME_MAX;
+    FD_TEST( frame_idx<rx->frame_cnt );
+    FD_TEST( rx->held[ frame_idx ] );
+    FD_VOLATILE( rx->held[ frame_idx ] ) = (uchar)0;
+    rx->free[ rx->free_cnt++ ] = frame_idx;
+    rx->rel_cnt++;
+  }
+}
+
+#define FRAME_CNT    (4096UL)
+#define FLOOD_BURST  (16UL)
+#define ZC_FRAME_CNT (512UL)
+
+static uchar frame_mem[ FRAME_CNT*FRAME_MAX ] __attribute__((aligned(128)));
+
+/* Frames generated for the tile test and their expected outcomes */
+
+static int   frame_reason[ FRAME_CNT ];
+static ulong frame_off   [ FRAME_CNT ];
+static ulong frame_psz   [ FRAME_CNT ];
+static ulong frame_sig   [ FRAME_CNT ];
+
+struct test_cfg {
+  fd_cnc_t *       cnc;
+  fd_ingress_rx_t  rx[1];
+  ulong            mtu;
+  ulong            orig;
+  fd_frag_meta_t * mcache;
+  uchar *          dcache;
+  ulong *          fseq;
+  ulong            cr_max;
+  fd_rlimit_t *    rlimit;
+  uint             seed;
+};
+
+typedef struct test_cfg test_cfg_t;
+
+static int
+ingress_tile_main( int     argc,
+                   char ** argv ) {
+  (void)argc;
+  test_cfg_t * cfg = (test_cfg_t *)argv;
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->seed, 0UL ) );
+
+  uchar scratch[ FD_INGRESS_TILE_SCRATCH_FOOTPRINT( 1UL ) ] __attribute__((aligned( FD_INGRESS_TILE_SCRATCH_ALIGN )));
+
+  FD_TEST( !fd_ingress_tile( cfg->cnc, cfg->rx, cfg->rlimit, cfg->mtu, cfg->orig, cfg->mcache, cfg->dcache,
+                             1UL, &cfg->fseq, cfg->cr_max, 0L, rng, scratch ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+/* test_tile runs an ingress tile over the frames in pcap (copying if
+   zc is zero and zero copy otherwise) with a reliable consumer on this
+   tile that checks each frag against the next valid frame.  Returns
+   the rate frags were received by the consumer in frag/s. */
+
+static double
+test_tile( fd_wksp_t * wksp,
+           FILE *      pcap,
+           int         zc,
+           ulong       depth,
+           ulong       mtu,
+           ulong const exp_drop[ FD_INGRESS_DROP_MAX+1 ],
+           ulong       exp_pub_cnt,
+           ulong       exp_pub_sz,
+           ulong       exp_rx_sz,
+           ulong       exp_move_cnt,
+           fd_rng_t *  rng ) {
+  rewind( pcap );
+
+  static pcap_rx_t pcap_rx[1];
+  memset( pcap_rx, 0, sizeof(pcap_rx_t) );
+  pcap_rx->iter      = fd_pcap_iter_new( pcap ); FD_TEST( pcap_rx->iter );
+  pcap_rx->rng       = rng;
+  pcap_rx->connected = 0;
+  pcap_rx->done      = 0;
+  pcap_rx->zc        = zc;
+
+  test_cfg_t cfg[1];
+
+  cfg->rx->ctx       = pcap_rx;
+  cfg->rx->set_rx    = pcap_rx_set;
+  cfg->rx->service   = pcap_rx_service;
+  cfg->rx->release   = zc ? pcap_rx_release : NULL;
+  cfg->rx->burst_max = BURST_MAX;
+
+  cfg->mtu  = mtu;
+  cfg->orig = 3UL;
+  cfg->seed = 1234U;
+
+  long  hb0  = fd_tickcount();
+  ulong seq0 = fd_rng_ulong( rng );
+
+  FD_LOG_NOTICE(( "Creating cnc (app_sz %lu)", FD_INGRESS_CNC_APP_SZ ));
+  cfg->cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( wksp, fd_cnc_align(), fd_cnc_footprint( FD_INGRESS_CNC_APP_SZ ), 1UL ),
+                                      FD_INGRESS_CNC_APP_SZ, 0UL, hb0 ) );
+  FD_TEST( cfg->cnc );
+
+  FD_LOG_NOTICE(( "Creating mcache (--depth %lu, seq0 %lu)", depth, seq0 ));
+  cfg->mcache = fd_mcache_join( fd_mcache_new( fd_wksp_alloc_laddr( wksp, fd_mcache_align(), fd_mcache_footprint( depth, 0UL ), 1UL ),
+                                               depth, 0UL, seq0 ) );
+  FD_TEST( cfg->mcache );
+
+  /* If zero copy, the umem is laid out over the dcache's data region */
+
+  ulong data_sz = zc ? (ZC_FRAME_CNT+1UL)*FRAME_MAX : fd_dcache_req_data_sz( mtu, depth, 1UL, 1 ); FD_TEST( data_sz );
+  FD_LOG_NOTICE(( "Creating dcache (data_sz %lu)", data_sz ));
+  cfg->dcache = fd_dcache_join( fd_dcache_new( fd_wksp_alloc_laddr( wksp, fd_dcache_align(), fd_dcache_footprint( data_sz, 0UL ), 1UL ),
+                                               data_sz, 0UL ) );
+  FD_TEST( cfg->dcache );
+
+  static ulong free [ ZC_FRAME_CNT ];
+  static uchar held [ ZC_FRAME_CNT ];
+  if( zc ) {
+    pcap_rx->umem      = (uchar *)fd_ulong_align_up( (ulong)cfg->dcache, FRAME_MAX );
+    pcap_rx->frame_cnt = ZC_FRAME_CNT;
+    pcap_rx->free      = free;
+    pcap_rx->held      = held;
+    FD_TEST( pcap_rx->umem + ZC_FRAME_CNT*FRAME_MAX <= cfg->dcache + data_sz );
+    for( ulong i=0UL; i<ZC_FRAME_CNT; i++ ) { free[i] = ZC_FRAME_CNT-1UL-i; held[i] = (uchar)0; }
+    pcap_rx->free_cnt  = ZC_FRAME_CNT;
+  }
+
+  FD_LOG_NOTICE(( "Creating fseq" ));
+  cfg->fseq = fd_fseq_join( fd_fseq_new( fd_wksp_alloc_laddr( wksp, fd_fseq_align(), fd_fseq_footprint(), 1UL ), seq0 ) );
+  FD_TEST( cfg->fseq );
+
+  cfg->cr_max = depth;
+
+  FD_LOG_NOTICE(( "Creating rlimit (burst %lu)", FLOOD_BURST ));
+  cfg->rlimit = fd_rlimit_join( fd_rlimit_new( fd_wksp_alloc_laddr( wksp, fd_rlimit_align(), fd_rlimit_footprint( 64UL ), 1UL ),
+                                               64UL, 1UL<<40, FLOOD_BURST, fd_rng_ulong( rng ) ) );
+  FD_TEST( cfg->rlimit );
+
+  FD_LOG_NOTICE(( "Booting (%s)", zc ? "zero copy" : "copy" ));
+
+  fd_tile_exec_t * exec = fd_tile_exec_new( 1UL, ingress_tile_main, 0, (char **)fd_type_pun( cfg ) ); FD_TEST( exec );
+  FD_TEST( fd_cnc_wait( cfg->cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+
+  /* Consume the frag stream, checking each frag against the next valid
+     frame */
+
+  FD_LOG_NOTICE(( "Running" ));
+
+  ulong const * cnc_diag = (ulong const *)fd_cnc_app_laddr_const( cfg->cnc );
+
+  ulong seq       = seq0;
+  ulong frame_idx = 0UL;
+  long  tic       = fd_log_wallclock();
+  long  timeout   = tic + (long)30e9;
+  for( ulong rx_idx=0UL; rx_idx<exp_pub_cnt; rx_idx++ ) {
+    while( frame_reason[ frame_idx ] ) frame_idx++;
+
+    fd_frag_meta_t const * mline = cfg->mcache + fd_mcache_line_idx( seq, depth );
+    for(;;) {
+      long diff = fd_seq_diff( fd_frag_meta_seq_query( mline ), seq );
+      FD_TEST( diff<=0L ); /* Reliable consumer can't be overrun */
+      if( FD_LIKELY( !diff ) ) break;
+      FD_TEST( fd_log_wallclock()<timeout );
+      FD_YIELD();
+    }
+
+    FD_COMPILER_MFENCE();
+    ulong sig   = mline->sig;
+    ulong chunk = (ulong)mline->chunk;
+    ulong sz    = (ulong)mline->sz;
+    ulong ctl   = (ulong)mline->ctl;
+    FD_COMPILER_MFENCE();
+
+    FD_TEST( sig==frame_sig[ frame_idx ] );
+    FD_TEST( sz ==frame_psz[ frame_idx ] );
+    FD_TEST( fd_frag_meta_ctl_orig( ctl )==cfg->orig );
+    FD_TEST( fd_frag_meta_ctl_som ( ctl ) );
+    FD_TEST( fd_frag_meta_ctl_eom ( ctl ) );
+    FD_TEST( !fd_frag_meta_ctl_err( ctl ) );
+    uchar const * payload = (uchar const *)fd_chunk_to_laddr_const( wksp, chunk );
+    FD_TEST( !memcmp( payload, frame_mem + frame_idx*FRAME_MAX + frame_off[ frame_idx ], sz ) );
+    FD_TEST( fd_seq_eq( fd_frag_meta_seq_query( mline ), seq ) );
+
+    if( zc ) {
+
+      /* The payload is in the umem and its frame is still held (we
+         haven't advanced our fseq past it yet) */
+
+      ulong umem_off = (ulong)payload - (ulong)pcap_rx->umem;
+      FD_TEST( umem_off<ZC_FRAME_CNT*FRAME_MAX );
+      FD_TEST( FD_VOLATILE_CONST( pcap_rx->held[ umem_off / FRAME_MAX ] ) );
+    }
+
+    seq = fd_seq_inc( seq, 1UL );
+    fd_fctl_rx_cr_return( cfg->fseq, seq );
+    frame_idx++;
+  }
+  long toc = fd_log_wallclock();
+
+  /* Wait for the stand-in to run dry and the diagnostics to be flushed */
+
+  for(;;) {
+    FD_COMPILER_MFENCE();
+    ulong rx_cnt = cnc_diag[ FD_INGRESS_CNC_DIAG_RX_CNT ];
+    FD_COMPILER_MFENCE();
+    if( FD_VOLATILE_CONST( pcap_rx->done ) && rx_cnt==FRAME_CNT ) break;
+    FD_TEST( fd_log_wallclock()<timeout );
+    FD_YIELD();
+  }
+
+  FD_LOG_NOTICE(( "Halting" ));
+
+  FD_TEST( !fd_cnc_open( cfg->cnc ) );
+  fd_cnc_signal( cfg->cnc, FD_CNC_SIGNAL_HALT );
+  FD_TEST( fd_cnc_wait( cfg->cnc, FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+  fd_cnc_close( cfg->cnc );
+
+  int ret;
+  FD_TEST( !fd_tile_exec_delete( exec, &ret ) ); FD_TEST( !ret );
+  FD_TEST( !pcap_rx->connected );
+
+  /* Nothing past the last valid frame was published */
+
+  FD_TEST( fd_seq_lt( fd_frag_meta_seq_query( cfg->mcache + fd_mcache_line_idx( seq, depth ) ), seq ) );
+
+  FD_LOG_NOTICE(( "rx_cnt %lu rx_sz %lu pub_cnt %lu pub_sz %lu filt_cnt %lu filt_sz %lu zc_cnt %lu zc_move_cnt %lu",
+                  cnc_diag[ FD_INGRESS_CNC_DIAG_RX_CNT   ], cnc_diag[ FD_INGRESS_CNC_DIAG_RX_SZ      ],
+                  cnc_diag[ FD_INGRESS_CNC_DIAG_PUB_CNT  ], cnc_diag[ FD_INGRESS_CNC_DIAG_PUB_SZ     ],
+                  cnc_diag[ FD_INGRESS_CNC_DIAG_FILT_CNT ], cnc_diag[ FD_INGRESS_CNC_DIAG_FILT_SZ    ],
+                  cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_CNT   ], cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_MOVE_CNT ] ));
+  for( int r=1; r<=FD_INGRESS_DROP_MAX; r++ ) {
+    FD_LOG_NOTICE(( "drop %-9s %lu", fd_ingress_drop_cstr( r ), cnc_diag[ FD_INGRESS_CNC_DIAG_DROP( r ) ] ));
+    FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_DROP( r ) ]==exp_drop[ r ] );
+  }
+
+  FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_RX_CNT   ]==FRAME_CNT             );
+  FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_RX_SZ    ]==exp_rx_sz             );
+  FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_PUB_CNT  ]==exp_pub_cnt           );
+  FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_PUB_SZ   ]==exp_pub_sz            );
+  FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_FILT_CNT ]==FRAME_CNT-exp_pub_cnt );
+
+  if( zc ) {
+
+    /* Every payload was published in place (payloads of frames with a
+       vlan tag or ip4 options had to be moved) and, as the consumer
+       consumed everything before the halt, every frame was released */
+
+    FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_CNT      ]==exp_pub_cnt-exp_move_cnt );
+    FD_TEST( cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_MOVE_CNT ]==exp_move_cnt             );
+    FD_TEST( pcap_rx->rel_cnt ==FRAME_CNT    );
+    FD_TEST( pcap_rx->free_cnt==ZC_FRAME_CNT );
+  } else {
+    FD_TEST( !cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_CNT      ] );
+    FD_TEST( !cnc_diag[ FD_INGRESS_CNC_DIAG_ZC_MOVE_CNT ] );
+  }
+
+  FD_TEST( fd_rlimit_drop_cnt( cfg->rlimit )==exp_drop[ FD_INGRESS_DROP_RATE ] );
+  FD_TEST( fd_rlimit_pass_cnt( cfg->rlimit )==exp_pub_cnt                     );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+
+  FD_TEST( fd_pcap_iter_delete( pcap_rx->iter )==(void *)pcap );
+
+  fd_wksp_free_laddr( fd_rlimit_delete( fd_rlimit_leave( cfg->rlimit ) ) );
+  fd_wksp_free_laddr( fd_fseq_delete  ( fd_fseq_leave  ( cfg->fseq   ) ) );
+  fd_wksp_free_laddr( fd_dcache_delete( fd_dcache_leave( cfg->dcache ) ) );
+  fd_wksp_free_laddr( fd_mcache_delete( fd_mcache_leave( cfg->mcache ) ) );
+  fd_wksp_free_laddr( fd_cnc_delete   ( fd_cnc_leave   ( cfg->cnc    ) ) );
+
+  return (double)exp_pub_cnt / (1e-9*(double)(toc-tic));
+}
+
+#endif
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  static uchar frame[ FRAME_MAX ] __attribute__((aligned(64)));
+
+  /* Test parsing */
+
+  for( int r=0; r<=FD_INGRESS_DROP_MAX; r++ ) FD_TEST( strcmp( fd_ingress_drop_cstr( r ), "unknown" ) );
+  FD_TEST( !strcmp( fd_ingress_drop_cstr( FD_INGRESS_DROP_MAX+1 ), "unknown" ) );
+  FD_TEST( !strcmp( fd_ingress_drop_cstr( -1                    ), "unknown" ) );
+
+  FD_TEST( fd_ingress_sig( FD_IP4_ADDR( 1,2,3,4 ), fd_ushort_bswap( (ushort)8001 ), fd_ushort_bswap( (ushort)9001 ) )
+           ==( ((ulong)FD_IP4_ADDR( 1,2,3,4 )) | (8001UL<<32) | (9001UL<<48) ) );
+
+  ulong reason_cnt[ PARSE_REASON_CNT ]; memset( reason_cnt, 0, sizeof(reason_cnt) );
+  for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+    int   reason = fd_rng_uint_roll( rng, 2U ) ? 0 : (int)fd_rng_uint_roll( rng, (uint)PARSE_REASON_CNT );
+    ulong mtu    = fd_rng_uint_roll( rng, 2U ) ? 1472UL : 1UL + fd_rng_ulong_roll( rng, 1472UL );
+    ulong exp_off;
+    ulong exp_sz;
+    ulong exp_sig;
+    ulong sz = make_frame( rng, frame, reason, mtu, NULL, &exp_off, &exp_sz, &exp_sig );
+
+    /* Checksum failures are only detected when checking */
+
+    int reason_nocheck = (reason==FD_INGRESS_DROP_IP4_CHECK || reason==FD_INGRESS_DROP_UDP_CHECK) ? 0 : reason;
+
+    ulong off = ~0UL; ulong psz = ~0UL; ulong sig = ~0UL;
+    FD_TEST( fd_ingress_parse( frame, sz, mtu, 1, &off, &psz, &sig )==reason );
+    if( !reason ) FD_TEST( (off==exp_off) & (psz==exp_sz) & (sig==exp_sig) );
+    else          FD_TEST( (off==~0UL) & (psz==~0UL) & (sig==~0UL) );
+
+    off = ~0UL; psz = ~0UL; sig = ~0UL;
+    FD_TEST( fd_ingress_parse( frame, sz, mtu, 0, &off, &psz, &sig )==reason_nocheck );
+    if( !reason_nocheck ) FD_TEST( (off==exp_off) & (psz==exp_sz) & (sig==exp_sig) );
+
+    reason_cnt[ reason ]++;
+  }
+  for( int r=0; r<PARSE_REASON_CNT; r++ ) FD_TEST( reason_cnt[r] );
+
+  /* Zero size and runt frames (make_frame doesn't generate these) */
+
+  ulong dummy;
+  FD_TEST( fd_ingress_parse( frame, 0UL,  1472UL, 1, &dummy, &dummy, &dummy )==FD_INGRESS_DROP_TRUNC );
+  FD_TEST( fd_ingress_parse( frame, 13UL, 1472UL, 1, &dummy, &dummy, &dummy )==FD_INGRESS_DROP_TRUNC );
+  FD_TEST( fd_ingress_parse( frame, 14UL, 1472UL, 1, &dummy, &dummy, &dummy )==FD_INGRESS_DROP_TRUNC );
+
+# if FD_HAS_HOSTED && FD_HAS_X86
+
+  /* Test the tile (copying and zero copy) by running it against a
+     pcap-fed rx stand-in with a reliable consumer on this tile */
+
+  if( FD_UNLIKELY( fd_tile_cnt()<2UL ) ) {
+    FD_LOG_WARNING(( "skip: tile test requires at least 2 tiles" ));
+    fd_rng_delete( fd_rng_leave( rng ) );
+    FD_LOG_NOTICE(( "pass" ));
+    fd_halt();
+    return 0;
+  }
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "gigantic"                   );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 1UL                          );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( cpu_idx ) );
+  ulong        depth    = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth",    NULL, 128UL                        );
+  ulong        mtu      = fd_env_strip_cmdline_ulong( &argc, &argv, "--mtu",      NULL, 1232UL                       );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  /* Generate the frames and write them to a pcap (the last 4 bytes of
+     each frame are written as the "FCS") */
+
+  FD_LOG_NOTICE(( "Generating %lu frames (--mtu %lu)", FRAME_CNT, mtu ));
+
+  /* A quarter of the frames come from a flooding source.  The rate
+     limit effectively never refills during the test so exactly the
+     first FLOOD_BURST valid frames from the flooding source should get
+     through (invalid frames from it shouldn't consume tokens). */
+
+  uint  flood_addr     = FD_IP4_ADDR( 10,0,0,1 );
+  ulong flood_pass_cnt = 0UL;
+
+  ulong exp_drop[ FD_INGRESS_DROP_MAX+1 ]; memset( exp_drop, 0, sizeof(exp_drop) );
+  ulong exp_pub_cnt  = 0UL;
+  ulong exp_pub_sz   = 0UL;
+  ulong exp_rx_sz    = 0UL;
+  ulong exp_move_cnt = 0UL; /* Published payloads not on a chunk boundary with FD_INGRESS_ZC_HEADROOM */
+
+  FILE * pcap = tmpfile(); FD_TEST( pcap );
+  FD_TEST( fd_pcap_fwrite_hdr( pcap )==1UL );
+  for( ulong i=0UL; i<FRAME_CNT; i++ ) {
+    uchar * f      = frame_mem + i*FRAME_MAX;
+    int     reason = fd_rng_uint_roll( rng, 4U ) ? 0 : 1+(int)fd_rng_uint_roll( rng, (uint)PARSE_REASON_CNT-1U );
+    int     flood  = !fd_rng_uint_roll( rng, 4U );
+    ulong   sz     = make_frame( rng, f, reason, mtu, flood ? &flood_addr : NULL, frame_off+i, frame_psz+i, frame_sig+i );
+    if( !reason && flood ) {
+      if( flood_pass_cnt<FLOOD_BURST ) flood_pass_cnt++;
+      else                             reason = FD_INGRESS_DROP_RATE;
+    }
+    frame_reason[i] = reason;
+    exp_drop[ reason ]++;
+    exp_rx_sz += sz;
+    if( !reason ) {
+      exp_pub_cnt++;
+      exp_pub_sz   += frame_psz[i];
+      exp_move_cnt += (ulong)!fd_ulong_is_aligned( FD_INGRESS_ZC_HEADROOM + frame_off[i], FD_CHUNK_ALIGN );
+    }
+    FD_TEST( fd_pcap_fwrite_pkt( (long)i, f, sz-4UL, NULL, 0UL, FD_LOAD( uint, f+sz-4UL ), pcap )==1UL );
+  }
+  FD_TEST( !fflush( pcap ) );
+
+  /* Run the tile copying and zero copy */
+
+  double copy_rate = test_tile( wksp, pcap, 0, depth, mtu, exp_drop, exp_pub_cnt, exp_pub_sz, exp_rx_sz, exp_move_cnt, rng );
+  double zc_rate   = test_tile( wksp, pcap, 1, depth, mtu, exp_drop, exp_pub_cnt, exp_pub_sz, exp_rx_sz, exp_move_cnt, rng );
+
+  FD_LOG_NOTICE(( "copy: %.3e frag/s (%lu payload copies)", copy_rate, exp_pub_cnt ));
+  FD_LOG_NOTICE(( "zc:   %.3e frag/s (%lu payload copies avoided, %lu payloads moved within their frame)",
+                  zc_rate, exp_pub_cnt-exp_move_cnt, exp_move_cnt ));
+
+  FD_TEST( !fclose( pcap ) );
+
+  fd_wksp_delete_anonymous( wksp );
+
+# else
+  FD_LOG_WARNING(( "skip: tile test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+# endif
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
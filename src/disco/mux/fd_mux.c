@@ -3,7 +3,8 @@
 #if FD_HAS_HOSTED && FD_HAS_X86
 
 /* A fd_mux_tile_in has all the state needed for muxing frags from an
-   in.  It fits on exactly one cache line. */
+   in.  It fits on exactly two cache lines (the state needed to poll the
+   in is on the first). */
 
 struct __attribute__((aligned(64))) fd_mux_tile_in {
   fd_frag_meta_t const * mcache;   /* local join to this in's mcache */
@@ -12,12 +13,30 @@ struct __attribute__((aligned(64))) fd_mux_tile_in {
                                       updated when frag from this in published/filtered */
   fd_frag_meta_t const * mline;    /* == mcache + fd_mcache_line_idx( seq, depth ), location to poll next */
   ulong *                fseq;     /* local join to the fseq used to return flow control credits the in */
-  uint                   accum[6]; /* local diagnostic accumualtors.  These are drained during in housekeeping. */
-                                   /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5 */
+  uint                   weight;   /* number of frags this in can have muxed per round, in [1,FD_MUX_TILE_IN_WEIGHT_MAX] (const) */
+  uint                   deficit;  /* number of frags this in can still have muxed in the current round, in [0,weight],
+                                      0 indicates the in will start a new round the next time it is polled */
+  uint                   accum[8]; /* local diagnostic accumualtors.  These are drained during in housekeeping. */
+                                   /* Assumes FD_FSEQ_DIAG_{PUB_CNT,PUB_SZ,FILT_CNT,FILT_SZ,OVRNP_CNT,OVRNR_CONT} are 0:5
+                                      and FD_MUX_FSEQ_DIAG_SKIP_CNT is 7 (6, SLOW_CNT, is not used by the mux) */
 };
 
 typedef struct fd_mux_tile_in fd_mux_tile_in_t;
 
+FD_STATIC_ASSERT( sizeof(fd_mux_tile_in_t)==128UL, layout );
+
+/* A fd_mux_tile_cls has the state needed for round robining over the
+   ins in a priority class. */
+
+struct fd_mux_tile_cls {
+  ulong lo;   /* ins in this class are in[lo,hi) (const) */
+  ulong hi;   /* " */
+  ulong seq;  /* in[seq] is the in in this class to poll next, in [lo,hi) */
+  ulong idle; /* number of consecutive polls of ins in this class that found nothing to mux, in [0,hi-lo) */
+};
+
+typedef struct fd_mux_tile_cls fd_mux_tile_cls_t;
+
 /* fd_mux_tile_in_update returns flow control credits to the in assuming
    that there are at most exposed_cnt frags currently exposed to
    reliable outs and drains the run-time diagnostics accumulated since
@@ -57,12 +76,15 @@ fd_mux_tile_in_update( fd_mux_tile_in_t * in,
   uint *  accum = in->accum;
   ulong a0 = (ulong)accum[0]; ulong a1 = (ulong)accum[1]; ulong a2 = (ulong)accum[2];
   ulong a3 = (ulong)accum[3]; ulong a4 = (ulong)accum[4]; ulong a5 = (ulong)accum[5];
+  ulong a7 = (ulong)accum[7];
   FD_COMPILER_MFENCE();
   diag[0] += a0;              diag[1] += a1;              diag[2] += a2;
   diag[3] += a3;              diag[4] += a4;              diag[5] += a5;
+  diag[7] += a7;
   FD_COMPILER_MFENCE();
   accum[0] = 0U;              accum[1] = 0U;              accum[2] = 0U;
   accum[3] = 0U;              accum[4] = 0U;              accum[5] = 0U;
+  accum[7] = 0U;
 }
 
 #define SCRATCH_ALLOC( a, s ) (__extension__({                    \
@@ -97,6 +119,8 @@ fd_mux_tile( fd_cnc_t *              cnc,
              ulong                   in_cnt,
              fd_frag_meta_t const ** in_mcache,
              ulong **                in_fseq,
+             ulong const *           in_weight,
+             ulong const *           in_prio,
              fd_frag_meta_t *        mcache,
              ulong                   out_cnt,
              ulong **                _out_fseq,
@@ -106,15 +130,27 @@ fd_mux_tile( fd_cnc_t *              cnc,
              void *                  scratch ) {
 
   /* cnc state */
-  ulong * cnc_diag;           /* ==fd_cnc_app_laddr( cnc ), local address of the mux tile cnc diagnostic region */
-  ulong   cnc_diag_in_backp;  /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
-  ulong   cnc_diag_backp_cnt; /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  ulong * cnc_diag;             /* ==fd_cnc_app_laddr( cnc ), local address of the mux tile cnc diagnostic region */
+  ulong   cnc_diag_in_backp;    /* is the run loop currently backpressured by one or more of the outs, in [0,1] */
+  ulong   cnc_diag_backp_cnt;   /* Accumulates number of transitions of tile to backpressured between housekeeping events */
+  int     cnc_diag_ticks_en;    /* 1 if cnc app region has room for the standard duty cycle diagnostics, 0 otherwise */
+  ulong   cnc_diag_spin_ticks;  /* Accumulates ticks spent caught up between housekeeping events */
+  ulong   cnc_diag_work_ticks;  /* Accumulates ticks spent processing frags between housekeeping events */
+  ulong   cnc_diag_backp_ticks; /* Accumulates ticks spent backpressured between housekeeping events */
+  ulong   cnc_diag_hkeep_ticks; /* Accumulates ticks spent doing housekeeping between housekeeping events */
+  fd_perf_t   _perf[1];         /* perf state, local to the tile */
+  fd_perf_t * perf;             /* Samples the tile's hardware performance counters, NULL if not sampling */
+  ulong * cnc_lhist_orig;       /* ==fd_lhist_cnc_orig( cnc ), where to accumulate in frag tsorig latencies, NULL if not enabled */
+  ulong * cnc_lhist_pub;        /* ==fd_lhist_cnc_pub ( cnc ), where to accumulate in frag tspub  latencies, NULL if not enabled */
 
   /* in frag stream state */
-  ulong              in_seq; /* current position in input poll sequence, in [0,in_cnt) */
-  fd_mux_tile_in_t * in;     /* in[in_seq] for in_seq in [0,in_cnt) has information about input fragment stream currently at
-                                position in_seq in the in_idx polling sequence.  The ordering of this array is continuously
-                                shuffled to avoid lighthousing effects in the output fragment stream at extreme fan-in and load */
+  fd_mux_tile_in_t * in;      /* in[in_seq] for in_seq in [0,in_cnt) has information about input fragment stream currently at
+                                 position in_seq in the in_idx polling sequence.  Ins are grouped by priority class (highest
+                                 priority class first).  The ordering within a class is continuously shuffled to avoid
+                                 lighthousing effects in the output fragment stream at extreme fan-in and load */
+  ulong              cls_cnt; /* number of priority classes with at least one in, in [0,FD_MUX_TILE_IN_PRIO_CNT] */
+  ulong              cls_cur; /* priority class currently being serviced, in [0,cls_cnt), 0 is the highest priority class */
+  fd_mux_tile_cls_t  cls[ FD_MUX_TILE_IN_PRIO_CNT ]; /* cls[cls_idx] for cls_idx in [0,cls_cnt) is the state of class cls_idx */
 
   /* out frag stream state */
   ulong   depth; /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
@@ -159,20 +195,38 @@ fd_mux_tile( fd_cnc_t *              cnc,
 
     cnc_diag = (ulong *)fd_cnc_app_laddr( cnc );
 
+    /* Accumulate in frag latency histograms if the cnc app region has
+       room for them */
+    cnc_lhist_orig = fd_lhist_cnc_orig( cnc );
+    cnc_lhist_pub  = fd_lhist_cnc_pub ( cnc );
+    FD_LOG_INFO(( "%s latency histograms", cnc_lhist_orig ? "Accumulating" : "Not accumulating" ));
+
     /* in_backp==1, backp_cnt==0 indicates waiting for initial credits,
        cleared during first housekeeping if credits available */
     cnc_diag_in_backp  = 1UL;
     cnc_diag_backp_cnt = 0UL;
 
+    cnc_diag_ticks_en    = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_TICKS_APP_SZ;
+    cnc_diag_spin_ticks  = 0UL;
+    cnc_diag_work_ticks  = 0UL;
+    cnc_diag_backp_ticks = 0UL;
+    cnc_diag_hkeep_ticks = 0UL;
+
     /* in frag stream init */
 
-    in_seq = 0UL; /* First in to poll */
     in = (fd_mux_tile_in_t *)SCRATCH_ALLOC( alignof(fd_mux_tile_in_t), in_cnt*sizeof(fd_mux_tile_in_t) );
 
     ulong min_in_depth = (ulong)LONG_MAX;
 
     if( FD_UNLIKELY( !!in_cnt && !in_mcache ) ) { FD_LOG_WARNING(( "NULL in_mcache" )); return 1; }
     if( FD_UNLIKELY( !!in_cnt && !in_fseq   ) ) { FD_LOG_WARNING(( "NULL in_fseq"   )); return 1; }
+
+    /* Validate the ins and count the number of ins in each priority
+       class such that we can lay out the ins grouped by class below */
+
+    ulong prio_off[ FD_MUX_TILE_IN_PRIO_CNT ];
+    for( ulong prio=0UL; prio<FD_MUX_TILE_IN_PRIO_CNT; prio++ ) prio_off[ prio ] = 0UL;
+
     for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
 
       /* FIXME: CONSIDER NULL OR EMPTY CSTR IN_FCTL[ IN_IDX ] TO SPECIFY
@@ -180,7 +234,41 @@ fd_mux_tile( fd_cnc_t *              cnc,
       if( FD_UNLIKELY( !in_mcache[ in_idx ] ) ) { FD_LOG_WARNING(( "NULL in_mcache[%lu]", in_idx )); return 1; }
       if( FD_UNLIKELY( !in_fseq  [ in_idx ] ) ) { FD_LOG_WARNING(( "NULL in_fseq[%lu]",   in_idx )); return 1; }
 
-      fd_mux_tile_in_t * this_in = &in[ in_idx ];
+      ulong weight = in_weight ? in_weight[ in_idx ] : 1UL;
+      ulong prio   = in_prio   ? in_prio  [ in_idx ] : 0UL;
+      if( FD_UNLIKELY( !((1UL<=weight) & (weight<=FD_MUX_TILE_IN_WEIGHT_MAX)) ) ) {
+        FD_LOG_WARNING(( "in_weight[%lu] %lu must be in [1,%lu]", in_idx, weight, FD_MUX_TILE_IN_WEIGHT_MAX ));
+        return 1;
+      }
+      if( FD_UNLIKELY( prio>=FD_MUX_TILE_IN_PRIO_CNT ) ) {
+        FD_LOG_WARNING(( "in_prio[%lu] %lu must be in [0,%lu)", in_idx, prio, FD_MUX_TILE_IN_PRIO_CNT ));
+        return 1;
+      }
+      prio_off[ prio ]++;
+    }
+
+    /* Convert the per priority in counts into the location of each
+       class in the in array (highest priority first) */
+
+    cls_cnt = 0UL;
+    cls_cur = 0UL; /* First class to service */
+    ulong off = 0UL;
+    for( ulong prio=FD_MUX_TILE_IN_PRIO_CNT; prio; prio-- ) {
+      ulong cnt = prio_off[ prio-1UL ];
+      prio_off[ prio-1UL ] = off;
+      if( !cnt ) continue;
+      FD_LOG_INFO(( "in prio %lu: %lu ins", prio-1UL, cnt ));
+      cls[ cls_cnt ].lo   = off;
+      cls[ cls_cnt ].hi   = off + cnt;
+      cls[ cls_cnt ].seq  = off; /* First in to poll in this class */
+      cls[ cls_cnt ].idle = 0UL;
+      cls_cnt++;
+      off += cnt;
+    }
+
+    for( ulong in_idx=0UL; in_idx<in_cnt; in_idx++ ) {
+
+      fd_mux_tile_in_t * this_in = &in[ prio_off[ in_prio ? in_prio[ in_idx ] : 0UL ]++ ];
 
       this_in->mcache = in_mcache[ in_idx ];
       this_in->fseq   = in_fseq  [ in_idx ];
@@ -190,8 +278,12 @@ fd_mux_tile( fd_cnc_t *              cnc,
       this_in->seq    = fd_mcache_seq_query( this_in_sync ); /* FIXME: ALLOW OPTION FOR MANUAL SPECIFICATION? */
       this_in->mline  = this_in->mcache + fd_mcache_line_idx( this_in->seq, this_in->depth );
 
+      this_in->weight  = (uint)(in_weight ? in_weight[ in_idx ] : 1UL);
+      this_in->deficit = 0U; /* Start a new round when first polled */
+
       this_in->accum[0] = 0U; this_in->accum[1] = 0U; this_in->accum[2] = 0U;
       this_in->accum[3] = 0U; this_in->accum[4] = 0U; this_in->accum[5] = 0U;
+      this_in->accum[6] = 0U; this_in->accum[7] = 0U;
     }
 
     /* out frag stream init */
@@ -338,6 +430,11 @@ fd_mux_tile( fd_cnc_t *              cnc,
     async_min = fd_tempo_async_min( lazy, event_cnt, (float)fd_tempo_tick_per_ns( NULL ) );
     if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
 
+    /* Sample the tile's hardware performance counters if the cnc app
+       region has room for them and they are available on this host */
+    perf = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ? fd_perf_open( _perf ) : NULL;
+    FD_LOG_INFO(( "%s performance counters", perf ? "Sampling" : "Not sampling" ));
+
   } while(0);
 
   FD_LOG_INFO(( "Running mux" ));
@@ -349,6 +446,7 @@ fd_mux_tile( fd_cnc_t *              cnc,
     /* Do housekeeping at a low rate in the background */
 
     if( FD_UNLIKELY( (now-then)>=0L ) ) {
+      FD_TRACE( now, FD_TRACE_ID_HKEEP, 0UL, 0U, 0UL );
       ulong event_idx = (ulong)event_map[ event_seq ];
 
       /* Do the next async event.  event_idx:
@@ -391,8 +489,19 @@ fd_mux_tile( fd_cnc_t *              cnc,
         FD_COMPILER_MFENCE();
         cnc_diag[ FD_CNC_DIAG_IN_BACKP  ]  = cnc_diag_in_backp;
         cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] += cnc_diag_backp_cnt;
+        if( FD_LIKELY( cnc_diag_ticks_en ) ) {
+          cnc_diag[ FD_CNC_DIAG_SPIN_TICKS  ] += cnc_diag_spin_ticks;
+          cnc_diag[ FD_CNC_DIAG_WORK_TICKS  ] += cnc_diag_work_ticks;
+          cnc_diag[ FD_CNC_DIAG_BACKP_TICKS ] += cnc_diag_backp_ticks;
+          cnc_diag[ FD_CNC_DIAG_HKEEP_TICKS ] += cnc_diag_hkeep_ticks;
+        }
+        if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_CNC_DIAG_PERF_CYCLES );
         FD_COMPILER_MFENCE();
-        cnc_diag_backp_cnt = 0UL;
+        cnc_diag_backp_cnt   = 0UL;
+        cnc_diag_spin_ticks  = 0UL;
+        cnc_diag_work_ticks  = 0UL;
+        cnc_diag_backp_ticks = 0UL;
+        cnc_diag_hkeep_ticks = 0UL;
 
         /* Receive command-and-control signals */
         ulong s = fd_cnc_signal_query( cnc );
@@ -442,16 +551,23 @@ fd_mux_tile( fd_cnc_t *              cnc,
 
         /* We also do the same with the ins to prevent there being a
            correlated order frag origins from different inputs
-           downstream at extreme fan in and extreme in load. */
-
-        swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)in_cnt );
-        fd_mux_tile_in_t in_tmp;
-        in_tmp         = in[ swap_idx ];
-        in[ swap_idx ] = in[ 0        ];
-        in[ 0        ] = in_tmp;
+           downstream at extreme fan in and extreme in load.  Ins are
+           only shuffled within their priority class. */
+
+        if( FD_LIKELY( in_cnt ) ) {
+          swap_idx = (ulong)fd_rng_uint_roll( rng, (uint)in_cnt );
+          ulong cls_idx = 0UL;
+          while( swap_idx>=cls[ cls_idx ].hi ) cls_idx++;
+          ulong swap_lo = cls[ cls_idx ].lo;
+          fd_mux_tile_in_t in_tmp;
+          in_tmp         = in[ swap_idx ];
+          in[ swap_idx ] = in[ swap_lo  ];
+          in[ swap_lo  ] = in_tmp;
+        }
       }
 
-      /* Reload housekeeping timer */
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, cnc_diag_hkeep_ticks );
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
 
@@ -464,20 +580,23 @@ fd_mux_tile( fd_cnc_t *              cnc,
        from not backpressured to backpressured. */
 
     if( FD_UNLIKELY( !cr_avail ) ) {
+      if( FD_UNLIKELY( !cnc_diag_in_backp ) ) FD_TRACE( now, FD_TRACE_ID_BACKP, seq, 0U, 0UL );
       cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
       cnc_diag_in_backp   = 1UL;
       FD_SPIN_PAUSE();
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_backp_ticks );
       continue;
     }
     cnc_diag_in_backp = 0UL;
 
-    /* Select which in to poll next (randomized round robin) */
+    /* Select which in to poll next (deficit round robin within the
+       current priority class, see below).  If the in is starting a new
+       round, give it its weight's worth of frags for the round. */
 
-    if( FD_UNLIKELY( !in_cnt ) ) { now = fd_tickcount(); continue; }
-    fd_mux_tile_in_t * this_in = &in[ in_seq ];
-    in_seq++;
-    if( in_seq>=in_cnt ) in_seq = 0UL; /* cmov */
+    if( FD_UNLIKELY( !in_cnt ) ) { FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks ); continue; }
+    fd_mux_tile_cls_t * this_cls = &cls[ cls_cur ];
+    fd_mux_tile_in_t *  this_in  = &in[ this_cls->seq ];
+    if( FD_UNLIKELY( !this_in->deficit ) ) this_in->deficit = this_in->weight;
 
     /* Check if this in has any new fragments to mux */
 
@@ -493,9 +612,28 @@ fd_mux_tile( fd_cnc_t *              cnc,
       if( FD_UNLIKELY( diff<0L ) ) { /* Overrun (impossible if in is honoring our flow control) */
         this_in->seq = seq_found; /* Resume from here (probably reasonably current, could query in mcache sync directly instead) */
         this_in->accum[ FD_FSEQ_DIAG_OVRNP_CNT ]++;
+        FD_TRACE( now, FD_TRACE_ID_OVRN, seq_found, 0U, 0UL );
+      }
+
+      /* This in has nothing to mux right now.  As per usual for DRR, it
+         forfeits the remainder of its round and we move onto the next
+         in in this class.  If we've polled every in in this class in a
+         row without finding anything to mux, we move onto the next
+         lower priority class (wrapping around to the highest priority
+         class from the lowest). */
+
+      this_in->deficit = 0U;
+      ulong next_seq = this_cls->seq + 1UL;
+      this_cls->seq  = fd_ulong_if( next_seq<this_cls->hi, next_seq, this_cls->lo );
+      this_cls->idle++;
+      if( FD_UNLIKELY( this_cls->idle>=(this_cls->hi-this_cls->lo) ) ) {
+        this_cls->idle = 0UL;
+        cls_cur++;
+        if( cls_cur>=cls_cnt ) cls_cur = 0UL; /* cmov */
       }
+
       /* Don't bother with spin as polling multiple locations */
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks );
       continue;
     }
 
@@ -514,6 +652,7 @@ fd_mux_tile( fd_cnc_t *              cnc,
     ulong sz       = (ulong)this_in_mline->sz;
     ulong ctl      = (ulong)this_in_mline->ctl;
     ulong tsorig   = (ulong)this_in_mline->tsorig;
+    ulong in_tspub = (ulong)this_in_mline->tspub;
     FD_COMPILER_MFENCE();
     ulong seq_test =        this_in_mline->seq;
     FD_COMPILER_MFENCE();
@@ -521,8 +660,9 @@ fd_mux_tile( fd_cnc_t *              cnc,
     if( FD_UNLIKELY( fd_seq_ne( seq_test, seq_found ) ) ) { /* Overrun while reading (impossible if this_in honoring our fctl) */
       this_in->seq = seq_test; /* Resume from here (probably reasonably current, could query in mcache sync instead) */
       this_in->accum[ FD_FSEQ_DIAG_OVRNR_CNT ]++;
+      FD_TRACE( now, FD_TRACE_ID_OVRN, seq_test, 0U, 0UL );
       /* Don't bother with spin as polling multiple locations */
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
       continue;
     }
 
@@ -531,15 +671,25 @@ fd_mux_tile( fd_cnc_t *              cnc,
 
     ulong should_filter = 0UL; /* FIXME: FILTERING LOGIC HERE */
 
-    if( FD_UNLIKELY( should_filter ) ) now = fd_tickcount(); /* Optimize for forwarding path */
-    else {
-      now = fd_tickcount();
+    FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+    if( FD_LIKELY( !should_filter ) ) { /* Optimize for forwarding path */
       ulong tspub = (ulong)fd_frag_meta_ts_comp( now );
       fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+      FD_TRACE( now, FD_TRACE_ID_PUB, seq, sz, sig );
       cr_avail--;
       seq = fd_seq_inc( seq, 1UL );
     }
 
+    /* Accumulate the latency histograms.  This reuses the timestamp
+       taken above (i.e. is the time the frag was processed) and touches
+       a couple of tile owned cache lines that are only rarely read by
+       monitors. */
+
+    if( FD_LIKELY( cnc_lhist_orig ) ) {
+      fd_lhist_sample( cnc_lhist_orig, fd_lhist_ts_lat( tsorig,   now ) );
+      fd_lhist_sample( cnc_lhist_pub,  fd_lhist_ts_lat( in_tspub, now ) );
+    }
+
     /* Windup for the next in poll and accumulate diagnostics */
 
     this_in_seq    = fd_seq_inc( this_in_seq, 1UL );
@@ -549,6 +699,24 @@ fd_mux_tile( fd_cnc_t *              cnc,
     ulong diag_idx = FD_FSEQ_DIAG_PUB_CNT + should_filter*2UL;
     this_in->accum[ diag_idx     ]++;
     this_in->accum[ diag_idx+1UL ] += (uint)sz;
+
+    /* Charge this frag to this in's round.  If this in has used up its
+       round, move onto the next in in this class, counting if this in
+       was passed over with another frag already ready to mux (reads the
+       line we will poll on our next visit anyway).  Then return to the
+       highest priority class such that higher priority ins preempt
+       lower priority ins at frag granularity (when the highest priority
+       class is already being serviced, this is a no-op). */
+
+    this_cls->idle = 0UL;
+    this_in->deficit--;
+    if( FD_UNLIKELY( !this_in->deficit ) ) {
+      if( FD_LIKELY( (this_cls->hi-this_cls->lo)>1UL ) )
+        this_in->accum[ FD_MUX_FSEQ_DIAG_SKIP_CNT ] += (uint)(fd_frag_meta_seq_query( this_in->mline )==this_in_seq);
+      ulong next_seq = this_cls->seq + 1UL;
+      this_cls->seq  = fd_ulong_if( next_seq<this_cls->hi, next_seq, this_cls->lo );
+    }
+    cls_cur = 0UL;
   }
 
   do {
@@ -561,6 +729,8 @@ fd_mux_tile( fd_cnc_t *              cnc,
       fd_mux_tile_in_update( this_in, 0UL ); /* exposed_cnt 0 assumes all reliable consumers caught up or shutdown */
     }
 
+    if( FD_LIKELY( perf ) ) fd_perf_close( perf );
+
     FD_LOG_INFO(( "Halted mux" ));
     fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
 
@@ -570,5 +740,4 @@ fd_mux_tile( fd_cnc_t *              cnc,
 }
 
 #undef SCRATCH_ALLOC
-
 #endif
@@ -32,6 +32,22 @@
 #define FD_MUX_TILE_IN_MAX  FD_FRAG_META_ORIG_MAX
 #define FD_MUX_TILE_OUT_MAX FD_FRAG_META_ORIG_MAX
 
+/* FD_MUX_TILE_IN_WEIGHT_MAX is the maximum weight an in can be given
+   and FD_MUX_TILE_IN_PRIO_CNT is the number of priority classes an in
+   can be assigned to (see fd_mux_tile below for details). */
+
+#define FD_MUX_TILE_IN_WEIGHT_MAX (65535UL)
+#define FD_MUX_TILE_IN_PRIO_CNT   (8UL)
+
+/* FD_MUX_FSEQ_DIAG_SKIP_CNT is the location in an in's fseq application
+   region where a mux tile accumulates the number of times it moved on
+   from the in with another frag from the in ready to mux because the
+   in had used up its weight for the current round.  This is one of the
+   application specific fseq diagnostic locations (see fd_fseq.h) and
+   is on the 2nd fseq cache line, updated by the mux at housekeeping. */
+
+#define FD_MUX_FSEQ_DIAG_SKIP_CNT (7UL)
+
 /* FD_MUX_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
    footprint needed for a mux tile scratch region that can support
    in_cnt inputs and out_cnt outputs.  ALIGN is an integer power of 2 of
@@ -46,7 +62,7 @@
 #define FD_MUX_TILE_SCRATCH_FOOTPRINT( in_cnt, out_cnt )                \
   FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( \
   FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,                   \
-    64UL,             (in_cnt)*64UL                           ),        \
+    64UL,             (in_cnt)*128UL                          ),        \
     alignof(ulong *), (out_cnt)*sizeof(ulong *)               ),        \
     alignof(ulong *), (out_cnt)*sizeof(ulong *)               ),        \
     alignof(ulong),   (out_cnt)*sizeof(ulong)                 ),        \
@@ -68,6 +84,30 @@ FD_PROTOTYPES_BEGIN
    interleaved (but this makes an extreme best effort to avoid
    starvation and minimize slip between different groups of streams).
 
+   Specifically, ins are serviced by strict priority between priority
+   classes and deficit round robin (DRR) within a class.  in_prio[in_idx]
+   is the priority class of in in_idx, in [0,FD_MUX_TILE_IN_PRIO_CNT)
+   with larger values being higher priority.  in_weight[in_idx] is the
+   weight of in in_idx, in [1,FD_MUX_TILE_IN_WEIGHT_MAX].  When the ins
+   of a class are all backlogged, each in of the class will have up to
+   its weight's worth of frags muxed per round such that the fraction of
+   the class's frags muxed from an in is its weight relative to the
+   class's total weight.  An in that runs out of frags to mux forfeits
+   the remainder of its round as usual for DRR (so a weight only
+   bounds how much a flooding in can crowd out the other ins in its
+   class; it does not reserve capacity for an in).  Lower priority
+   classes are only polled when all the ins in the higher priority
+   classes are caught up and a higher priority in will preempt a lower
+   priority in at frag granularity.  Note that this means a higher
+   priority flood can starve lower priority ins and that, while a lower
+   priority class is serviced, every in in a higher priority class is
+   polled between frags (this is usually cheap when the number of
+   higher priority ins is small).  If in_prio is NULL, all ins are in
+   the same class and, if in_weight is NULL, all ins have weight 1.
+   With the defaults, ins are serviced in a randomized round robin.
+   (Frags are charged by count, not by size, as downstream consumers
+   usually have a per frag cost.)
+
    The signature, chunk, sz, ctl and tsorig input fragment metadata will
    be unchanged by this tile.
 
@@ -181,6 +221,20 @@ FD_PROTOTYPES_BEGIN
    up to monitoring scripts.  It is recommend that inputs and outputs
    also use their cnc and fseq application regions similarly for
    monitoring simplicity / consistency.
+
+   The mux will additionally accumulate FD_MUX_FSEQ_DIAG_SKIP_CNT in
+   the in fseqs.  In conjunction with the standard FD_FSEQ_DIAG_PUB_CNT
+   and FD_FSEQ_DIAG_FILT_CNT (i.e. the frags accepted from an in), this
+   allows monitoring the fairness of the mux under skewed loads.
+
+   The tile also accumulates the standard duty cycle, hardware
+   performance counter and latency histogram diagnostics (the latter
+   across all ins) as its cnc application region size permits (see
+   fd_cnc.h).
+
+   If built with FD_HAS_TRACE, the tile records FD_TRACE_ID_{PUB,OVRN,
+   BACKP,HKEEP} events into the calling thread's trace (see
+   fd_trace.h), if any.
    
    The lifetime of the cnc, mcaches, fseqs, rng and scratch used by this
    tile should be a superset of this tile's lifetime.  While this tile
@@ -196,7 +250,8 @@ FD_PROTOTYPES_BEGIN
    updating producer oriented diagnostics).  The in_mcache, in_fseq and
    out_fseq arrays will not be used the after the tile has successfully
    booted (transitioned the cnc from BOOT to RUN) or returned (e.g.
-   failed to boot), whichever comes first. */
+   failed to boot), whichever comes first.  Likewise for the in_weight
+   and in_prio arrays. */
 
 FD_FN_CONST ulong
 fd_mux_tile_scratch_align( void );
@@ -210,6 +265,8 @@ fd_mux_tile( fd_cnc_t *              cnc,       /* Local join to the mux's comma
              ulong                   in_cnt,    /* Number of input mcaches to multiplex, inputs are indexed [0,in_cnt) */
              fd_frag_meta_t const ** in_mcache, /* in_mcache[in_idx] is the local join to input in_idx's mcache */
              ulong **                in_fseq,   /* in_fseq  [in_idx] is the local join to input in_idx's fseq */
+             ulong const *           in_weight, /* in_weight[in_idx] is input in_idx's DRR weight, NULL means all 1 */
+             ulong const *           in_prio,   /* in_prio  [in_idx] is input in_idx's priority class, NULL means all 0 */
              fd_frag_meta_t *        mcache,    /* Local join to the mux's frag stream output mcache */
              ulong                   out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
              ulong **                out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
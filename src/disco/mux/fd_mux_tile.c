@@ -14,6 +14,8 @@ main( int     argc,
   char const * _cnc        = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",        NULL, NULL );
   char const * _in_mcaches = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-mcaches", NULL, ""   );
   char const * _in_fseqs   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-fseqs",   NULL, ""   );
+  char const * _in_weights = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-weights", NULL, ""   ); /* empty <> all 1 */
+  char const * _in_prios   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in-prios",   NULL, ""   ); /* empty <> all 0 */
   char const * _mcache     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",     NULL, NULL );
   char const * _out_fseqs  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--out-fseqs",  NULL, ""   );
   ulong        cr_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--cr-max",     NULL, 0UL  ); /*   0 <> use default */
@@ -47,6 +49,20 @@ main( int     argc,
     if( FD_UNLIKELY( !in_fseq[ in_idx ] ) ) FD_LOG_ERR(( "fd_fseq_join failed" ));
   }
 
+  char * _in_weight[ 256 ];
+  ulong weight_cnt = fd_cstr_tokenize( _in_weight, 256UL, (char *)_in_weights, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( !!weight_cnt & (weight_cnt!=in_cnt) ) ) FD_LOG_ERR(( "--in-mcaches and --in-weights mismatch" ));
+
+  ulong in_weight[ 256 ];
+  for( ulong in_idx=0UL; in_idx<weight_cnt; in_idx++ ) in_weight[ in_idx ] = fd_cstr_to_ulong( _in_weight[ in_idx ] );
+
+  char * _in_prio[ 256 ];
+  ulong prio_cnt = fd_cstr_tokenize( _in_prio, 256UL, (char *)_in_prios, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( !!prio_cnt & (prio_cnt!=in_cnt) ) ) FD_LOG_ERR(( "--in-mcaches and --in-prios mismatch" ));
+
+  ulong in_prio[ 256 ];
+  for( ulong in_idx=0UL; in_idx<prio_cnt; in_idx++ ) in_prio[ in_idx ] = fd_cstr_to_ulong( _in_prio[ in_idx ] );
+
   if( FD_UNLIKELY( !_mcache ) ) FD_LOG_ERR(( "--mcache not specified" ));
   FD_LOG_NOTICE(( "Joining --mcache %s", _mcache ));
   fd_frag_meta_t * mcache = fd_mcache_join( fd_wksp_map( _mcache ) );
@@ -65,6 +81,8 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Using --cr-max %lu, --lazy %li", cr_max, lazy ));
 
+  fd_trace_t * trace = fd_trace_join_from_args( &argc, &argv ); /* No --trace <> no tracing */
+
   FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
@@ -81,13 +99,15 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Run" ));
 
-  int err = fd_mux_tile( cnc, in_cnt, in_mcache, in_fseq, mcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  int err = fd_mux_tile( cnc, in_cnt, in_mcache, in_fseq, weight_cnt ? in_weight : NULL, prio_cnt ? in_prio : NULL,
+                         mcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_mux_tile failed (%i)", err ));
 
   FD_LOG_NOTICE(( "Fini" ));
 
   fd_shmem_release( scratch, page_sz, page_cnt );
   fd_rng_delete( fd_rng_leave( rng ) );
+  fd_trace_leave_from_args( trace );
   for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_fseq_leave( out_fseq[ out_idx-1UL ] ) );
   fd_wksp_unmap( fd_mcache_leave( mcache ) );
   for( ulong in_idx=in_cnt; in_idx; in_idx-- ) fd_wksp_unmap( fd_fseq_leave  ( in_fseq  [ in_idx-1UL ] ) );
@@ -16,6 +16,7 @@ struct test_cfg {
 
   ulong       tx_cnt;
   long        tx_lazy;
+  float       tx_skew;
   uchar *     tx_cnc_mem;      ulong tx_cnc_footprint;
   uchar *     tx_rng_mem;      ulong tx_rng_footprint;
   uchar *     tx_fseq_mem;     ulong tx_fseq_footprint;
@@ -26,6 +27,8 @@ struct test_cfg {
   uchar *     mux_cnc_mem;
   uchar *     mux_mcache_mem;
   uchar *     mux_scratch_mem;
+  ulong *     mux_in_weight;
+  ulong *     mux_in_prio;
   ulong       mux_cr_max;
   long        mux_lazy;
   uint        mux_seed;
@@ -107,7 +110,7 @@ tx_tile_main( int     argc,
   /* Configure the synthetic load model */
   ulong pkt_framing     = cfg->pkt_framing;
   ulong pkt_payload_max = cfg->pkt_payload_max;
-  float burst_tau       = cfg->burst_tau;
+  float burst_tau       = tx_idx ? cfg->burst_tau : (cfg->burst_tau / cfg->tx_skew); /* tx 0 offers tx_skew times the load */
   float burst_avg       = cfg->burst_avg;
 
   int   ctl_som    = 1;
@@ -275,8 +278,8 @@ mux_tile_main( int     argc,
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->mux_seed, 0UL ) );
 
-  int err = fd_mux_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, mux_mcache, cfg->rx_cnt, rx_fseq,
-                         cfg->mux_cr_max, cfg->mux_lazy, rng, cfg->mux_scratch_mem );
+  int err = fd_mux_tile( cnc, cfg->tx_cnt, tx_mcache, tx_fseq, cfg->mux_in_weight, cfg->mux_in_prio, mux_mcache, cfg->rx_cnt,
+                         rx_fseq, cfg->mux_cr_max, cfg->mux_lazy, rng, cfg->mux_scratch_mem );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_mux_tile failed (%i)", err ));
 
   fd_rng_delete( fd_rng_leave( rng ) );
@@ -407,6 +410,158 @@ rx_tile_main( int     argc,
   return 0;
 }
 
+/* Scheduling test ****************************************************/
+
+/* sched_test checks the mux scheduling deterministically.  Each of
+   SCHED_IN_CNT ins has a backlog of SCHED_BACKLOG frags published
+   before the mux boots (the mux starts from each in's sync, which is
+   still at the start of the backlog, so every in is backlogged from the
+   mux's POV until it is drained) and the mux has no outs (so it is
+   never backpressured).  The sig of each frag encodes the in and the
+   frag's position in that in's backlog such that the schedule can be
+   recovered from the mux's mcache afterward.  In SCHED_PRIO_IN is the
+   only in in the higher priority class and the remaining ins have the
+   weights in sched_weight. */
+
+#define SCHED_IN_CNT  (4UL)
+#define SCHED_PRIO_IN (3UL)
+#define SCHED_BACKLOG (4096UL)
+
+static ulong const sched_weight[ SCHED_IN_CNT ] = { 1UL, 2UL, 4UL, 1UL };
+static ulong const sched_prio  [ SCHED_IN_CNT ] = { 0UL, 0UL, 0UL, 1UL };
+
+struct sched_cfg {
+  fd_cnc_t *             cnc;
+  fd_frag_meta_t const * in_mcache[ SCHED_IN_CNT ];
+  ulong *                in_fseq  [ SCHED_IN_CNT ];
+  fd_frag_meta_t *       mcache;
+  fd_rng_t *             rng;
+  void *                 scratch;
+};
+
+typedef struct sched_cfg sched_cfg_t;
+
+static int
+sched_mux_main( int     argc,
+                char ** argv ) {
+  (void)argc;
+  sched_cfg_t * cfg = (sched_cfg_t *)argv;
+  int err = fd_mux_tile( cfg->cnc, SCHED_IN_CNT, cfg->in_mcache, cfg->in_fseq, sched_weight, sched_prio, cfg->mcache,
+                         0UL, NULL, 0UL, 0L, cfg->rng, cfg->scratch );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_mux_tile failed (%i)", err ));
+  return 0;
+}
+
+static void
+sched_test( fd_wksp_t * wksp ) {
+  ulong in_depth = 2UL*SCHED_BACKLOG;
+  ulong depth    = SCHED_IN_CNT*SCHED_BACKLOG; /* Room for the whole schedule */
+  ulong tot_cnt  = SCHED_IN_CNT*SCHED_BACKLOG;
+
+  FD_LOG_NOTICE(( "Testing scheduling (in-cnt %lu, backlog %lu)", SCHED_IN_CNT, SCHED_BACKLOG ));
+
+  ulong in_mcache_footprint = fd_mcache_footprint( in_depth, 0UL );
+  uchar * in_mcache_mem = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), in_mcache_footprint*SCHED_IN_CNT, 1UL );
+  uchar * in_fseq_mem   = (uchar *)fd_wksp_alloc_laddr( wksp, fd_fseq_align(), fd_fseq_footprint()*SCHED_IN_CNT, 1UL );
+  uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), fd_cnc_footprint( FD_CNC_DIAG_TICKS_APP_SZ ), 1UL );
+  uchar * mcache_mem    = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mcache_align(), fd_mcache_footprint( depth, 0UL ), 1UL );
+  uchar * scratch_mem   = (uchar *)fd_wksp_alloc_laddr( wksp, fd_mux_tile_scratch_align(),
+                                                        fd_mux_tile_scratch_footprint( SCHED_IN_CNT, 0UL ), 1UL );
+  FD_TEST( in_mcache_mem ); FD_TEST( in_fseq_mem ); FD_TEST( cnc_mem ); FD_TEST( mcache_mem ); FD_TEST( scratch_mem );
+
+  sched_cfg_t cfg[1];
+  fd_rng_t _rng[1];
+  cfg->cnc     = fd_cnc_join( fd_cnc_new( cnc_mem, FD_CNC_DIAG_TICKS_APP_SZ, 2UL, fd_tickcount() ) ); FD_TEST( cfg->cnc );
+  cfg->mcache  = fd_mcache_join( fd_mcache_new( mcache_mem, depth, 0UL, 0UL ) );                    FD_TEST( cfg->mcache );
+  cfg->rng     = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+  cfg->scratch = scratch_mem;
+
+  for( ulong in_idx=0UL; in_idx<SCHED_IN_CNT; in_idx++ ) {
+    fd_frag_meta_t * in_mcache = fd_mcache_join( fd_mcache_new( in_mcache_mem + in_idx*in_mcache_footprint, in_depth, 0UL, 0UL ) );
+    FD_TEST( in_mcache );
+    for( ulong idx=0UL; idx<SCHED_BACKLOG; idx++ )
+      fd_mcache_publish( in_mcache, in_depth, idx, (in_idx<<32) | idx, 0UL, 0UL, fd_frag_meta_ctl( 0UL, 1, 1, 0 ), 0UL, 0UL );
+    cfg->in_mcache[ in_idx ] = in_mcache;
+    cfg->in_fseq  [ in_idx ] = fd_fseq_join( fd_fseq_new( in_fseq_mem + in_idx*fd_fseq_footprint(), 0UL ) );
+    FD_TEST( cfg->in_fseq[ in_idx ] );
+  }
+
+  /* Run the mux until it has muxed all the backlogs */
+
+  FD_TEST( fd_tile_exec_new( 1UL, sched_mux_main, 0, (char **)fd_type_pun( cfg ) ) );
+  FD_TEST( fd_cnc_wait( cfg->cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
+  ulong const * sync = fd_mcache_seq_laddr_const( cfg->mcache );
+  long  deadline = fd_log_wallclock() + (long)30e9;
+  while( fd_seq_lt( fd_mcache_seq_query( sync ), tot_cnt ) ) {
+    if( FD_UNLIKELY( fd_log_wallclock()>deadline ) ) FD_LOG_ERR(( "mux did not drain the backlogs" ));
+    fd_log_sleep( (long)1e6 );
+  }
+  FD_TEST( !fd_cnc_open( cfg->cnc ) );
+  fd_cnc_signal( cfg->cnc, FD_CNC_SIGNAL_HALT );
+  fd_cnc_close( cfg->cnc );
+  FD_TEST( fd_cnc_wait( cfg->cnc, FD_CNC_SIGNAL_HALT, (long)5e9, NULL )==FD_CNC_SIGNAL_BOOT );
+  int ret;
+  FD_TEST( !fd_tile_exec_delete( fd_tile_exec( 1UL ), &ret ) );
+  FD_TEST( !ret );
+
+  /* Recover the schedule.  Every frag should have been muxed exactly
+     once and in order for its in.  The higher priority in should have
+     been drained before anything else was muxed.  While all the lower
+     priority ins are backlogged (i.e. until the heaviest one is
+     drained, ~SCHED_BACKLOG / its weight rounds in), each should get
+     its weight's share of the output (to within 1% of the window to
+     allow for the mux shuffling the poll order within the class). */
+
+  ulong in_cnt[ SCHED_IN_CNT ];
+  for( ulong in_idx=0UL; in_idx<SCHED_IN_CNT; in_idx++ ) in_cnt[ in_idx ] = 0UL;
+
+  ulong wgt_tot = 0UL;
+  ulong wgt_max = 0UL;
+  for( ulong in_idx=0UL; in_idx<SCHED_IN_CNT; in_idx++ ) {
+    if( in_idx==SCHED_PRIO_IN ) continue;
+    wgt_tot += sched_weight[ in_idx ];
+    wgt_max  = fd_ulong_max( wgt_max, sched_weight[ in_idx ] );
+  }
+  ulong win_cnt = (SCHED_BACKLOG / wgt_max)*wgt_tot*7UL/8UL; /* Comfortably before the heaviest in drains */
+
+  for( ulong seq=0UL; seq<tot_cnt; seq++ ) {
+    fd_frag_meta_t const * mline = cfg->mcache + fd_mcache_line_idx( seq, depth );
+    FD_TEST( mline->seq==seq );
+    ulong in_idx = mline->sig >> 32;
+    ulong idx    = mline->sig & 0xffffffffUL;
+    FD_TEST( in_idx<SCHED_IN_CNT );
+    FD_TEST( idx==in_cnt[ in_idx ] );
+    FD_TEST( (seq<SCHED_BACKLOG)==(in_idx==SCHED_PRIO_IN) );
+    in_cnt[ in_idx ]++;
+
+    if( seq==SCHED_BACKLOG+win_cnt-1UL ) {
+      for( ulong win_idx=0UL; win_idx<SCHED_IN_CNT; win_idx++ ) {
+        if( win_idx==SCHED_PRIO_IN ) continue;
+        long cnt_exp = (long)(win_cnt*sched_weight[ win_idx ] / wgt_tot);
+        long cnt_err = (long)in_cnt[ win_idx ] - cnt_exp;
+        FD_LOG_NOTICE(( "sched: in %lu (weight %lu): %lu of %lu frags (expected %li)",
+                        win_idx, sched_weight[ win_idx ], in_cnt[ win_idx ], win_cnt, cnt_exp ));
+        FD_TEST( (ulong)fd_long_abs( cnt_err )<=win_cnt/100UL );
+      }
+    }
+  }
+  for( ulong in_idx=0UL; in_idx<SCHED_IN_CNT; in_idx++ ) FD_TEST( in_cnt[ in_idx ]==SCHED_BACKLOG );
+
+  for( ulong in_idx=0UL; in_idx<SCHED_IN_CNT; in_idx++ ) {
+    FD_TEST( fd_fseq_delete( fd_fseq_leave( cfg->in_fseq[ in_idx ] ) ) );
+    FD_TEST( fd_mcache_delete( fd_mcache_leave( cfg->in_mcache[ in_idx ] ) ) );
+  }
+  fd_rng_delete( fd_rng_leave( cfg->rng ) );
+  FD_TEST( fd_mcache_delete( fd_mcache_leave( cfg->mcache ) ) );
+  FD_TEST( fd_cnc_delete( fd_cnc_leave( cfg->cnc ) ) );
+
+  fd_wksp_free_laddr( scratch_mem   );
+  fd_wksp_free_laddr( mcache_mem    );
+  fd_wksp_free_laddr( cnc_mem       );
+  fd_wksp_free_laddr( in_fseq_mem   );
+  fd_wksp_free_laddr( in_mcache_mem );
+}
+
 /* CNC tile ***********************************************************/
 
 int
@@ -436,9 +591,12 @@ main( int     argc,
   ulong        tx_depth   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",   NULL, 32768UL                      );
   ulong        tx_mtu     = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",     NULL, 1472UL                       );
   long         tx_lazy    = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",    NULL, 0L                           );
+  float        tx_skew    = fd_env_strip_cmdline_float( &argc, &argv, "--tx-skew",    NULL, 1.f                          );
   ulong        mux_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--mux-depth",  NULL, 32768UL                      );
   ulong        mux_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--mux-cr-max", NULL, 0UL /* use default */        );
   long         mux_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--mux-lazy",   NULL, 0L /* use default */         );
+  char const * _weights   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mux-weights", NULL, "" /* all 1 */             );
+  char const * _prios     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mux-prios",   NULL, "" /* all 0 */             );
   ulong        rx_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--rx-cnt",     NULL, 2UL                          );
   int          rx_lazy    = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",    NULL, 7                            );
   long         duration   = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",   NULL, (long)10e9                   );
@@ -454,6 +612,23 @@ main( int     argc,
   if( FD_UNLIKELY( !rx_cnt                    ) ) FD_LOG_ERR(( "rx_cnt should be positive" ));
   if( FD_UNLIKELY( tx_cnt>FD_MUX_TILE_IN_MAX  ) ) FD_LOG_ERR(( "--tx-cnt too large for this unit test" ));
   if( FD_UNLIKELY( rx_cnt>FD_MUX_TILE_OUT_MAX ) ) FD_LOG_ERR(( "--rx-cnt too large for this unit test" ));
+  if( FD_UNLIKELY( !(tx_skew>0.f)             ) ) FD_LOG_ERR(( "--tx-skew should be positive" ));
+
+  /* Parse the mux in scheduling configuration (unspecified ins get the
+     defaults) */
+
+  FD_LOG_NOTICE(( "Configuring mux ins (--mux-weights \"%s\" --mux-prios \"%s\")", _weights, _prios ));
+
+  static ulong mux_in_weight[ 128 ];
+  static ulong mux_in_prio  [ 128 ];
+  for( ulong tx_idx=0UL; tx_idx<128UL; tx_idx++ ) { mux_in_weight[ tx_idx ] = 1UL; mux_in_prio[ tx_idx ] = 0UL; }
+  do {
+    char * tok[ 128 ];
+    ulong  tok_cnt = fd_cstr_tokenize( tok, 128UL, (char *)_weights, ',' ); /* argv is non-const */
+    for( ulong tok_idx=0UL; tok_idx<fd_ulong_min( tok_cnt, 128UL ); tok_idx++ ) mux_in_weight[ tok_idx ] = fd_cstr_to_ulong( tok[ tok_idx ] );
+    tok_cnt = fd_cstr_tokenize( tok, 128UL, (char *)_prios, ',' ); /* argv is non-const */
+    for( ulong tok_idx=0UL; tok_idx<fd_ulong_min( tok_cnt, 128UL ); tok_idx++ ) mux_in_prio  [ tok_idx ] = fd_cstr_to_ulong( tok[ tok_idx ] );
+  } while(0);
 
   ulong tile_cnt = 1UL+tx_cnt+1UL+rx_cnt; /* 1 main(cnc,this) + tx_cnt tx_mains + 1 mux_main + rx_cnt rx_mains */
   if( FD_UNLIKELY( fd_tile_cnt()<tile_cnt ) ) FD_LOG_ERR(( "this unit test requires at least %lu tiles", tile_cnt ));
@@ -482,8 +657,11 @@ main( int     argc,
   fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
   FD_TEST( wksp );
 
-  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, mux-cnt 1, --rx-cnt %lu, app-sz 64)", tx_cnt, rx_cnt ));
-  ulong   cnc_footprint = fd_cnc_footprint( 64UL ); /* Room for 8 64-bit diagnostic counters */
+  sched_test( wksp );
+
+  FD_LOG_NOTICE(( "Creating cncs (--tx-cnt %lu, mux-cnt 1, --rx-cnt %lu, tx/rx app-sz 64, mux app-sz %lu)",
+                  tx_cnt, rx_cnt, FD_LHIST_CNC_APP_SZ ));
+  ulong   cnc_footprint = fd_cnc_footprint( FD_LHIST_CNC_APP_SZ ); /* Room for the mux's standard diagnostics (see fd_cnc.h) */
   uchar * cnc_mem       = (uchar *)fd_wksp_alloc_laddr( wksp, fd_cnc_align(), cnc_footprint*(tx_cnt+1UL+rx_cnt), 1UL );
   FD_TEST( cnc_mem );
 
@@ -533,6 +711,7 @@ main( int     argc,
 
   cfg->tx_cnt        = tx_cnt;
   cfg->tx_lazy       = tx_lazy;
+  cfg->tx_skew       = tx_skew;
   cfg->tx_cnc_mem    = cnc_mem;       cfg->tx_cnc_footprint    = cnc_footprint;
   cfg->tx_rng_mem    = rng_mem;       cfg->tx_rng_footprint    = rng_footprint;
   cfg->tx_fseq_mem   = fseq_mem;      cfg->tx_fseq_footprint   = fseq_footprint;
@@ -543,6 +722,8 @@ main( int     argc,
   cfg->mux_cnc_mem     = cnc_mem + tx_cnt*cnc_footprint;
   cfg->mux_mcache_mem  = mux_mcache_mem;
   cfg->mux_scratch_mem = mux_scratch_mem;
+  cfg->mux_in_weight   = mux_in_weight;
+  cfg->mux_in_prio     = mux_in_prio;
   cfg->mux_cr_max      = mux_cr_max;
   cfg->mux_lazy        = mux_lazy;
   cfg->mux_seed        = rng_seq++;
@@ -569,7 +750,7 @@ main( int     argc,
   }
 
   ulong mux_seq0 = fd_rng_ulong( rng );
-  FD_TEST( fd_cnc_new   ( cfg->mux_cnc_mem,    64UL, 1UL, now           ) );
+  FD_TEST( fd_cnc_new   ( cfg->mux_cnc_mem,    FD_LHIST_CNC_APP_SZ, 1UL, now           ) );
   FD_TEST( fd_mcache_new( cfg->mux_mcache_mem, mux_depth, 0UL, mux_seq0 ) );
 
   for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
@@ -599,8 +780,8 @@ main( int     argc,
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
     FD_TEST( fd_cnc_wait( cnc[ tile_idx ], FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
 
-  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --mux-cr-max %lu, --mux-lazy %li ns, --rx-lazy %i)",
-                  duration, tx_lazy, mux_cr_max, mux_lazy, rx_lazy ));
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --tx-skew %g, --mux-cr-max %lu, --mux-lazy %li ns, --rx-lazy %i)",
+                  duration, tx_lazy, (double)tx_skew, mux_cr_max, mux_lazy, rx_lazy ));
 
   /* FIXME: DO MONITORING WHILE RUNNING */
   fd_log_sleep( duration );
@@ -622,6 +803,60 @@ main( int     argc,
     FD_TEST( !ret );
   }
 
+  do {
+    fd_cnc_t * mux_cnc = cnc[ tx_cnt+1UL ];
+    ulong      lat_cnt = fd_lhist_cnt( fd_lhist_cnc_orig( mux_cnc ) );
+    FD_TEST( fd_lhist_cnt( fd_lhist_cnc_pub( mux_cnc ) )==lat_cnt );
+    if( lat_cnt ) {
+      ulong orig_idx = fd_lhist_quantile( fd_lhist_cnc_orig( mux_cnc ), 0.5 );
+      ulong pub_idx  = fd_lhist_quantile( fd_lhist_cnc_pub ( mux_cnc ), 0.5 );
+      FD_LOG_NOTICE(( "mux: cnt %lu, median tsorig lat [%lu,%lu) ticks, median tspub lat [%lu,%lu) ticks", lat_cnt,
+                      fd_lhist_bucket_lo( orig_idx ), fd_lhist_bucket_hi( orig_idx ),
+                      fd_lhist_bucket_lo( pub_idx  ), fd_lhist_bucket_hi( pub_idx  ) ));
+    }
+  } while(0);
+
+  do {
+    ulong const * mux_diag = (ulong const *)fd_cnc_app_laddr_const( cnc[ tx_cnt+1UL ] );
+    ulong spin_ticks  = mux_diag[ FD_CNC_DIAG_SPIN_TICKS  ];
+    ulong work_ticks  = mux_diag[ FD_CNC_DIAG_WORK_TICKS  ];
+    ulong backp_ticks = mux_diag[ FD_CNC_DIAG_BACKP_TICKS ];
+    ulong hkeep_ticks = mux_diag[ FD_CNC_DIAG_HKEEP_TICKS ];
+    ulong ticks       = spin_ticks + work_ticks + backp_ticks + hkeep_ticks;
+    FD_TEST( ticks );
+    FD_LOG_NOTICE(( "mux: spin %.1f%%, work %.1f%%, backp %.1f%%, hkeep %.1f%%, backp cnt %lu",
+                    100.*(double)spin_ticks /(double)ticks, 100.*(double)work_ticks /(double)ticks,
+                    100.*(double)backp_ticks/(double)ticks, 100.*(double)hkeep_ticks/(double)ticks,
+                    mux_diag[ FD_CNC_DIAG_BACKP_CNT ] ));
+  } while(0);
+
+  /* Show how the mux shared its output among the ins.  As the txs
+     honor the mux's flow control, the mux should never have been
+     overrun.  When the mux is the bottleneck, the accepted shares within
+     a priority class should track the in weights for the ins that are
+     backlogged (e.g. --tx-skew 100 to flood tx 0). */
+
+  do {
+    ulong * tx_fseq[ 128 ];
+    ulong   tot_cnt = 0UL;
+    for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+      tx_fseq[ tx_idx ] = fd_fseq_join( cfg->tx_fseq_mem + tx_idx*cfg->tx_fseq_footprint ); FD_TEST( tx_fseq[ tx_idx ] );
+      ulong const * fseq_diag = (ulong const *)fd_fseq_app_laddr_const( tx_fseq[ tx_idx ] );
+      FD_TEST( !fseq_diag[ FD_FSEQ_DIAG_OVRNP_CNT ] );
+      FD_TEST( !fseq_diag[ FD_FSEQ_DIAG_OVRNR_CNT ] );
+      tot_cnt += fseq_diag[ FD_FSEQ_DIAG_PUB_CNT ] + fseq_diag[ FD_FSEQ_DIAG_FILT_CNT ];
+    }
+    for( ulong tx_idx=0UL; tx_idx<tx_cnt; tx_idx++ ) {
+      ulong const * fseq_diag = (ulong const *)fd_fseq_app_laddr_const( tx_fseq[ tx_idx ] );
+      ulong         acc_cnt   = fseq_diag[ FD_FSEQ_DIAG_PUB_CNT ] + fseq_diag[ FD_FSEQ_DIAG_FILT_CNT ];
+      FD_LOG_NOTICE(( "mux: in %lu (weight %lu, prio %lu): accepted %lu (%.1f%%), skipped %lu", tx_idx,
+                      mux_in_weight[ tx_idx ], mux_in_prio[ tx_idx ], acc_cnt,
+                      100.*(double)acc_cnt / (double)fd_ulong_max( tot_cnt, 1UL ), fseq_diag[ FD_MUX_FSEQ_DIAG_SKIP_CNT ] ));
+      FD_TEST( fd_fseq_leave( tx_fseq[ tx_idx ] ) );
+    }
+    FD_LOG_NOTICE(( "mux: %.3f Mfrag/s", 1e3*(double)tot_cnt / (double)duration ));
+  } while(0);
+
   for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_cnc_leave( cnc[ tile_idx ] ) );
 
   FD_LOG_NOTICE(( "Cleaning up" ));
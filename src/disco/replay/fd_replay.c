@@ -3,8 +3,6 @@
 #if FD_HAS_HOSTED && FD_HAS_X86
 
 #include "../../util/net/fd_pcap.h"
-#include <stdio.h>
-#include <errno.h>
 
 #define SCRATCH_ALLOC( a, s ) (__extension__({                    \
     ulong _scratch_alloc = fd_ulong_align_up( scratch_top, (a) ); \
@@ -12,7 +10,54 @@
     (void *)_scratch_alloc;                                       \
   }))
 
+/* A fd_replay_tile_pcap has the state of one of the pcaps being
+   replayed.  The pcap is mapped into the tile's address space and each
+   pcap has a one packet lookahead (pointing into the mapping) such that
+   the replay can pick the earliest packet over all pcaps.  Published
+   packets are copied exactly once, from the mapping into the dcache. */
+
+struct __attribute__((aligned(128))) fd_replay_tile_pcap {
+  void const *       map;    /* first byte of the pcap mapping */
+  ulong              map_sz; /* pcap mapping size */
+  uchar const *      pkt;    /* lookahead packet (in the mapping) */
+  ulong              raw_sz; /* size of the lookahead packet as captured */
+  ulong              sz;     /* size of the lookahead packet as published, 0 if the pcap has no more packets in the current pass */
+  long               ts;     /* pcap timestamp of the lookahead packet */
+  fd_pcap_mem_iter_t iter[1];
+};
+
+typedef struct fd_replay_tile_pcap fd_replay_tile_pcap_t;
+
+FD_STATIC_ASSERT( alignof(fd_replay_tile_pcap_t)==128UL, layout );
+FD_STATIC_ASSERT( sizeof (fd_replay_tile_pcap_t)==384UL, layout );
+
 FD_STATIC_ASSERT( FD_FCTL_ALIGN<=FD_REPLAY_TILE_SCRATCH_ALIGN, packing );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_CHUNK_IDX     ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PCAP_DONE     ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PCAP_PUB_CNT  ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PACE_LATE_SUM ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_PACE_LATE_MAX ), layout );
+FD_STATIC_ASSERT( FD_CNC_DIAG_APP_OK( FD_REPLAY_CNC_DIAG_LOOP_CNT      ), layout );
+
+/* fd_replay_tile_pcap_next loads the next packet of pcap as pcap's
+   lookahead packet.  Like fd_pcap_iter_next, a packet larger than
+   pkt_max ends the pcap's current pass (logs details). */
+
+static inline void
+fd_replay_tile_pcap_next( fd_replay_tile_pcap_t * pcap,
+                          ulong                   pkt_max ) {
+  pcap->pkt = fd_pcap_mem_iter_next( pcap->iter, &pcap->raw_sz, &pcap->ts );
+  if( FD_UNLIKELY( !pcap->pkt ) ) { pcap->sz = 0UL; return; }
+  ulong sz = fd_pcap_pkt_eth_sz( pcap->raw_sz, fd_pcap_mem_iter_type( pcap->iter ) );
+  if( FD_UNLIKELY( sz>pkt_max ) ) {
+    FD_LOG_WARNING(( "Too large packet detected in pcap (%lu bytes with %lu max)", sz, pkt_max ));
+    sz = 0UL;
+  }
+  pcap->sz = sz;
+}
 
 ulong
 fd_replay_tile_scratch_align( void ) {
@@ -20,17 +65,24 @@ fd_replay_tile_scratch_align( void ) {
 }
 
 ulong
-fd_replay_tile_scratch_footprint( ulong out_cnt ) {
+fd_replay_tile_scratch_footprint( ulong pcap_cnt,
+                                  ulong out_cnt ) {
+  if( FD_UNLIKELY( (!pcap_cnt) | (pcap_cnt>FD_REPLAY_TILE_PCAP_MAX) ) ) return 0UL;
   if( FD_UNLIKELY( out_cnt>FD_REPLAY_TILE_OUT_MAX ) ) return 0UL;
   ulong scratch_top = 0UL;
-  SCRATCH_ALLOC( fd_fctl_align(), fd_fctl_footprint( out_cnt ) ); /* fctl */
+  SCRATCH_ALLOC( alignof(fd_replay_tile_pcap_t), pcap_cnt*sizeof(fd_replay_tile_pcap_t) ); /* pcap */
+  SCRATCH_ALLOC( fd_fctl_align(),                fd_fctl_footprint( out_cnt )           ); /* fctl */
   return fd_ulong_align_up( scratch_top, fd_replay_tile_scratch_align() );
 }
 
 int
 fd_replay_tile( fd_cnc_t *       cnc,
-                char const *     pcap_path,
+                ulong            pcap_cnt,
+                char const **    pcap_path,
                 ulong            pkt_max,
+                float            pace_speed,
+                float            pace_rate,
+                ulong            loop_cnt,
                 ulong            orig,
                 fd_frag_meta_t * mcache,
                 uchar *          dcache,
@@ -50,10 +102,31 @@ fd_replay_tile( fd_cnc_t *       cnc,
   ulong   cnc_diag_pcap_pub_sz;   /* Accumulates pcap payload bytes publised between housekeeping events */
   ulong   cnc_diag_pcap_filt_cnt; /* Accumulates number of pcap packets filtered between housekeeping events */
   ulong   cnc_diag_pcap_filt_sz;  /* Accumulates pcap payload bytes filtered between housekeeping events */
+  ulong   cnc_diag_pace_late_sum; /* Accumulates ticks paced packets were published late between housekeeping events */
+  ulong   cnc_diag_pace_late_max; /* Largest ticks a paced packet was published late between housekeeping events */
+  ulong   cnc_diag_loop_cnt;      /* Accumulates number of passes completed between housekeeping events */
+  int     cnc_diag_ticks_en;      /* 1 if cnc app region has room for the duty cycle and pacing diagnostics, 0 otherwise */
+  ulong   cnc_diag_spin_ticks;    /* Accumulates ticks spent with nothing to replay between housekeeping events */
+  ulong   cnc_diag_work_ticks;    /* Accumulates ticks spent replaying packets between housekeeping events */
+  ulong   cnc_diag_backp_ticks;   /* Accumulates ticks spent backpressured between housekeeping events */
+  ulong   cnc_diag_hkeep_ticks;   /* Accumulates ticks spent doing housekeeping between housekeeping events */
+  fd_perf_t   _perf[1];           /* perf state, local to the tile */
+  fd_perf_t * perf;               /* Samples the tile's hardware performance counters, NULL if not sampling */
 
   /* in pcap stream state */
-  FILE *           pcap_file; /* handle of pcap file stream */
-  fd_pcap_iter_t * pcap_iter; /* iterator for the pcap file stream */
+  fd_replay_tile_pcap_t * pcap;        /* pcap[pcap_idx] is the state of pcap pcap_idx, indexed [0,pcap_cnt) */
+  long                    ts0;         /* Earliest pcap timestamp of the first packets of the pcaps */
+  long                    loop_off;    /* Offset added to pcap timestamps of packets in the current pass */
+  ulong                   loop_idx;    /* Number of passes completed */
+  ulong                   pass_cnt;    /* Number of packets replayed in the current pass */
+  long                    pass_ts_max; /* Latest pcap timestamp of packets replayed in the current pass */
+
+  /* pacing state */
+  int    pace_en;           /* 1 if pacing, 0 if publishing as fast as possible */
+  double pace_tick_per_ts;  /* Ticks between publishing packets per ns between their pcap timestamps, 0 if not timestamp pacing */
+  double pace_tick_per_pkt; /* Ticks between publishing consecutive packets, 0 if not steady pacing */
+  long   pace_t0;           /* Tick when the first packet replayed was scheduled to be published */
+  ulong  pace_idx;          /* Number of packets paced so far */
 
   /* out frag stream state */
   ulong   depth;  /* ==fd_mcache_depth( mcache ), depth of the mcache / positive integer power of 2 */
@@ -106,17 +179,48 @@ fd_replay_tile( fd_cnc_t *       cnc,
     cnc_diag_pcap_pub_sz   = 0UL;
     cnc_diag_pcap_filt_cnt = 0UL;
     cnc_diag_pcap_filt_sz  = 0UL;
+    cnc_diag_pace_late_sum = 0UL;
+    cnc_diag_pace_late_max = 0UL;
+    cnc_diag_loop_cnt      = 0UL;
+
+    cnc_diag_ticks_en    = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_TICKS_APP_SZ;
+    cnc_diag_spin_ticks  = 0UL;
+    cnc_diag_work_ticks  = 0UL;
+    cnc_diag_backp_ticks = 0UL;
+    cnc_diag_hkeep_ticks = 0UL;
 
     /* in pcap stream init */
 
     if( FD_UNLIKELY( !pkt_max ) ) { FD_LOG_WARNING(( "pkt_max must be positive" )); return 1; }
+    if( FD_UNLIKELY( pkt_max>(ulong)USHORT_MAX ) ) { FD_LOG_WARNING(( "pkt_max too large" )); return 1; }
+    if( FD_UNLIKELY( !pcap_cnt ) ) { FD_LOG_WARNING(( "pcap_cnt must be positive" )); return 1; }
+    if( FD_UNLIKELY( pcap_cnt>FD_REPLAY_TILE_PCAP_MAX ) ) { FD_LOG_WARNING(( "pcap_cnt too large" )); return 1; }
     if( FD_UNLIKELY( !pcap_path ) ) { FD_LOG_WARNING(( "NULL pcap path" )); return 1; }
-    FD_LOG_INFO(( "Opening pcap %s (pkt_max %lu)", pcap_path, pkt_max ));
-    pcap_file = fopen( pcap_path, "r" );
-    if( FD_UNLIKELY( !pcap_file ) ) { FD_LOG_WARNING(( "fopen failed" )); return 1; }
 
-    pcap_iter = fd_pcap_iter_new( pcap_file );
-    if( FD_UNLIKELY( !pcap_iter ) ) { FD_LOG_WARNING(( "fd_pcap_iter_new failed" )); return 1; }
+    pcap = (fd_replay_tile_pcap_t *)SCRATCH_ALLOC( alignof(fd_replay_tile_pcap_t), pcap_cnt*sizeof(fd_replay_tile_pcap_t) );
+
+    ts0 = LONG_MAX;
+    for( ulong pcap_idx=0UL; pcap_idx<pcap_cnt; pcap_idx++ ) {
+      fd_replay_tile_pcap_t * p = pcap + pcap_idx;
+      if( FD_UNLIKELY( !pcap_path[ pcap_idx ] ) ) { FD_LOG_WARNING(( "NULL pcap path[%lu]", pcap_idx )); return 1; }
+      FD_LOG_INFO(( "Mapping pcap %lu %s (pkt_max %lu)", pcap_idx, pcap_path[ pcap_idx ], pkt_max ));
+      p->map = fd_pcap_map( pcap_path[ pcap_idx ], &p->map_sz );
+      if( FD_UNLIKELY( !p->map ) ) { FD_LOG_WARNING(( "fd_pcap_map failed" )); return 1; }
+
+      if( FD_UNLIKELY( !fd_pcap_mem_iter_new( p->iter, p->map, p->map_sz ) ) ) {
+        FD_LOG_WARNING(( "fd_pcap_mem_iter_new failed" ));
+        return 1;
+      }
+
+      fd_replay_tile_pcap_next( p, pkt_max );
+      if( FD_LIKELY( p->sz ) ) ts0 = fd_long_min( ts0, p->ts );
+    }
+    if( FD_UNLIKELY( ts0==LONG_MAX ) ) ts0 = 0L; /* All pcaps are empty */
+    pass_ts_max = ts0;
+    loop_off    = 0L;
+    loop_idx    = 0UL;
+    pass_cnt    = 0UL;
+
     FD_COMPILER_MFENCE();
     cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_DONE ] = 0UL; /* Clear before entering running state */
     FD_COMPILER_MFENCE();
@@ -190,16 +294,37 @@ fd_replay_tile( fd_cnc_t *       cnc,
     async_min = fd_tempo_async_min( lazy, 1UL /*event_cnt*/, (float)fd_tempo_tick_per_ns( NULL ) );
     if( FD_UNLIKELY( !async_min ) ) { FD_LOG_WARNING(( "bad lazy" )); return 1; }
 
+    /* pacing init */
+
+    if( FD_UNLIKELY( (pace_speed>0.f) & (pace_rate>0.f) ) ) {
+      FD_LOG_WARNING(( "at most one of pace_speed and pace_rate can be positive" ));
+      return 1;
+    }
+
+    double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+    pace_en           = (pace_speed>0.f) | (pace_rate>0.f);
+    pace_tick_per_ts  = pace_speed>0.f ? tick_per_ns       / (double)pace_speed : 0.;
+    pace_tick_per_pkt = pace_rate >0.f ? tick_per_ns * 1e9 / (double)pace_rate  : 0.;
+    pace_idx          = 0UL;
+    FD_LOG_INFO(( "Configuring pacing (speed %g, rate %g pkt/s, loop_cnt %lu)", (double)pace_speed, (double)pace_rate, loop_cnt ));
+
+    /* Sample the tile's hardware performance counters if the cnc app
+       region has room for them and they are available on this host */
+    perf = fd_cnc_app_sz( cnc )>=FD_CNC_DIAG_PERF_APP_SZ ? fd_perf_open( _perf ) : NULL;
+    FD_LOG_INFO(( "%s performance counters", perf ? "Sampling" : "Not sampling" ));
+
   } while(0);
 
   FD_LOG_INFO(( "Running replay (orig %lu)", orig ));
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
   long then = fd_tickcount();
   long now  = then;
+  pace_t0 = now;
   for(;;) {
 
     /* Do housekeeping at a low rate in the background */
     if( FD_UNLIKELY( (now-then)>=0L ) ) {
+      FD_TRACE( now, FD_TRACE_ID_HKEEP, 0UL, 0U, 0UL );
 
       /* Send synchronization info */
       fd_mcache_seq_update( sync, seq );
@@ -220,12 +345,30 @@ fd_replay_tile( fd_cnc_t *       cnc,
       cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   ] += cnc_diag_pcap_pub_sz;
       cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT ] += cnc_diag_pcap_filt_cnt;
       cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  ] += cnc_diag_pcap_filt_sz;
+      if( FD_LIKELY( cnc_diag_ticks_en ) ) {
+        cnc_diag[ FD_CNC_DIAG_SPIN_TICKS  ] += cnc_diag_spin_ticks;
+        cnc_diag[ FD_CNC_DIAG_WORK_TICKS  ] += cnc_diag_work_ticks;
+        cnc_diag[ FD_CNC_DIAG_BACKP_TICKS ] += cnc_diag_backp_ticks;
+        cnc_diag[ FD_CNC_DIAG_HKEEP_TICKS ] += cnc_diag_hkeep_ticks;
+        cnc_diag[ FD_REPLAY_CNC_DIAG_PACE_LATE_SUM ] += cnc_diag_pace_late_sum;
+        cnc_diag[ FD_REPLAY_CNC_DIAG_PACE_LATE_MAX ]  = fd_ulong_max( cnc_diag[ FD_REPLAY_CNC_DIAG_PACE_LATE_MAX ],
+                                                                      cnc_diag_pace_late_max );
+        cnc_diag[ FD_REPLAY_CNC_DIAG_LOOP_CNT      ] += cnc_diag_loop_cnt;
+      }
+      if( FD_LIKELY( perf ) ) fd_perf_drain( perf, cnc_diag + FD_CNC_DIAG_PERF_CYCLES );
       FD_COMPILER_MFENCE();
       cnc_diag_backp_cnt     = 0UL;
       cnc_diag_pcap_pub_cnt  = 0UL;
       cnc_diag_pcap_pub_sz   = 0UL;
       cnc_diag_pcap_filt_cnt = 0UL;
       cnc_diag_pcap_filt_sz  = 0UL;
+      cnc_diag_spin_ticks    = 0UL;
+      cnc_diag_work_ticks    = 0UL;
+      cnc_diag_backp_ticks   = 0UL;
+      cnc_diag_hkeep_ticks   = 0UL;
+      cnc_diag_pace_late_sum = 0UL;
+      cnc_diag_pace_late_max = 0UL;
+      cnc_diag_loop_cnt      = 0UL;
 
       /* Receive command-and-control signals */
       ulong s = fd_cnc_signal_query( cnc );
@@ -241,7 +384,8 @@ fd_replay_tile( fd_cnc_t *       cnc,
       /* Receive flow control credits */
       cr_avail = fd_fctl_tx_cr_update( fctl, cr_avail, seq );
 
-      /* Reload housekeeping timer */
+      /* Reload housekeeping timer (see FD_CNC_DIAG_TICK) */
+      FD_CNC_DIAG_TICK( now, cnc_diag_hkeep_ticks );
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
 
@@ -254,46 +398,100 @@ fd_replay_tile( fd_cnc_t *       cnc,
        from not backpressured to backpressured. */
 
     if( FD_UNLIKELY( !cr_avail ) ) {
+      if( FD_UNLIKELY( !cnc_diag_in_backp ) ) FD_TRACE( now, FD_TRACE_ID_BACKP, seq, 0U, 0UL );
       cnc_diag_backp_cnt += (ulong)!cnc_diag_in_backp;
       cnc_diag_in_backp   = 1UL;
       FD_SPIN_PAUSE();
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_backp_ticks );
       continue;
     }
     cnc_diag_in_backp = 0UL;
 
-    /* Try to load the next packet directly into the dcache at chunk */
+    /* Select the pcap with the earliest lookahead packet */
 
     if( FD_UNLIKELY( cnc_diag_pcap_done ) ) {
       FD_SPIN_PAUSE();
-      now = fd_tickcount();
+      FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks );
       continue;
     }
 
-    long  ts;
-    ulong sz = fd_pcap_iter_next( pcap_iter, fd_chunk_to_laddr( base, chunk ), pkt_max, &ts );
-    if( FD_UNLIKELY( !sz ) ) {
-      cnc_diag_pcap_done = 1UL;
-      now = fd_tickcount();
+    ulong pcap_idx = ULONG_MAX;
+    long  ts       = LONG_MAX;
+    for( ulong idx=0UL; idx<pcap_cnt; idx++ ) {
+      if( pcap[ idx ].sz && ( (pcap_idx==ULONG_MAX) | (pcap[ idx ].ts<ts) ) ) {
+        pcap_idx = idx;
+        ts       = pcap[ idx ].ts;
+      }
+    }
+
+    if( FD_UNLIKELY( pcap_idx==ULONG_MAX ) ) {
+
+      /* All pcaps are done for this pass.  If there are more passes to
+         do, rewind the pcaps and schedule the next pass to start an
+         average inter-packet gap after the end of this one. */
+
+      loop_idx++;
+      cnc_diag_loop_cnt++;
+      if( FD_UNLIKELY( (!pass_cnt) | (loop_idx==loop_cnt) ) ) {
+        cnc_diag_pcap_done = 1UL;
+        FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
+        continue;
+      }
+
+      long pass_span = pass_ts_max - ts0;
+      loop_off   += pass_span + (pass_cnt>1UL ? pass_span / (long)(pass_cnt-1UL) : 0L);
+      pass_cnt    = 0UL;
+      pass_ts_max = ts0;
+
+      for( ulong idx=0UL; idx<pcap_cnt; idx++ ) {
+        fd_pcap_mem_iter_rewind( pcap[ idx ].iter );
+        fd_replay_tile_pcap_next( pcap + idx, pkt_max );
+      }
+
+      FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
       continue;
     }
 
+    fd_replay_tile_pcap_t * p = pcap + pcap_idx;
+    ulong sz = p->sz;
+
     int should_filter = 0; /* FIXME: filter logic goes here */
 
     if( FD_UNLIKELY( should_filter ) ) {
       cnc_diag_pcap_filt_cnt++;
       cnc_diag_pcap_filt_sz += sz;
-      now = fd_tickcount();
+      pass_cnt++;
+      pass_ts_max = fd_long_max( pass_ts_max, ts );
+      fd_replay_tile_pcap_next( p, pkt_max );
+      FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
       continue;
     }
 
-    ulong sig = (ulong)ts; /* FIXME: TEMPORARY HACK */
+    /* If pacing, wait until the packet is scheduled to be published */
+
+    long sched = 0L;
+    if( pace_en ) {
+      sched = pace_t0 + (long)( (double)(ts + loop_off - ts0)*pace_tick_per_ts + (double)pace_idx*pace_tick_per_pkt );
+      if( FD_LIKELY( (now-sched)<0L ) ) {
+        FD_SPIN_PAUSE();
+        FD_CNC_DIAG_TICK( now, cnc_diag_spin_ticks );
+        continue;
+      }
+    }
+
+    /* Copy the packet from the pcap mapping into the dcache at chunk
+       and publish it */
+
+    fd_pcap_pkt_to_eth( fd_chunk_to_laddr( base, chunk ), p->pkt, p->raw_sz, fd_pcap_mem_iter_type( p->iter ) );
+
+    ulong sig = (ulong)(ts + loop_off); /* FIXME: TEMPORARY HACK */
     ulong ctl = fd_frag_meta_ctl( orig, 1 /*som*/, 1 /*eom*/, 0 /*err*/ );
 
-    now = fd_tickcount();
+    FD_CNC_DIAG_TICK( now, cnc_diag_work_ticks );
     ulong tsorig = fd_frag_meta_ts_comp( now );
     ulong tspub  = tsorig;
     fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+    FD_TRACE( now, FD_TRACE_ID_PUB, seq, sz, sig );
 
     /* Windup for the next iteration and accumulate diagnostics */
 
@@ -302,6 +500,19 @@ fd_replay_tile( fd_cnc_t *       cnc,
     cr_avail--;
     cnc_diag_pcap_pub_cnt++;
     cnc_diag_pcap_pub_sz += sz;
+    pass_cnt++;
+    pass_ts_max = fd_long_max( pass_ts_max, ts );
+
+    if( pace_en ) {
+      ulong late = (ulong)(now - sched);
+      cnc_diag_pace_late_sum += late;
+      cnc_diag_pace_late_max  = fd_ulong_max( cnc_diag_pace_late_max, late );
+      pace_idx++;
+    }
+
+    /* Load the pcap's next packet */
+
+    fd_replay_tile_pcap_next( p, pkt_max );
   }
 
   do {
@@ -311,9 +522,13 @@ fd_replay_tile( fd_cnc_t *       cnc,
     FD_LOG_INFO(( "Destroying fctl" ));
     fd_fctl_delete( fd_fctl_leave( fctl ) );
 
-    FD_LOG_INFO(( "Closing pcap" ));
-    if( FD_UNLIKELY( fclose( fd_pcap_iter_delete( pcap_iter ) ) ) )
-      FD_LOG_WARNING(( "fclose failed (%i-%s)", errno, strerror( errno ) ));
+    FD_LOG_INFO(( "Unmapping pcaps" ));
+    for( ulong pcap_idx=0UL; pcap_idx<pcap_cnt; pcap_idx++ ) {
+      (void)fd_pcap_mem_iter_delete( pcap[ pcap_idx ].iter );
+      fd_pcap_unmap( pcap[ pcap_idx ].map, pcap[ pcap_idx ].map_sz );
+    }
+
+    if( FD_LIKELY( perf ) ) fd_perf_close( perf );
 
     FD_LOG_INFO(( "Halted replay" ));
     fd_cnc_signal( cnc, FD_CNC_SIGNAL_BOOT );
@@ -324,5 +539,4 @@ fd_replay_tile( fd_cnc_t *       cnc,
 }
 
 #undef SCRATCH_ALLOC
-
 #endif
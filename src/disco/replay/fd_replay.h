@@ -28,8 +28,19 @@
      PCAP_PUB_SZ   is the number of pcap packet payload bytes published by the replay
      PCAP_FILT_CNT is the number of pcap packets filtered by the replay
      PCAP_FILT_SZ  is the number of pcap packet payload bytes filtered by the replay
+     PACE_LATE_SUM is the number of ticks paced packets were published after their scheduled publish tick, summed over packets
+     PACE_LATE_MAX is the largest number of ticks a paced packet was published after its scheduled publish tick
+     LOOP_CNT      is the number of passes over the pcaps completed by the replay
 
    As such, the cnc app region must be at least 64B in size.
+   If the cnc app region is at least FD_CNC_DIAG_TICKS_APP_SZ, the tile
+   will also accumulate the standard FD_CNC_DIAG_*_TICKS duty cycle
+   diagnostics and the PACE_* and LOOP_CNT diagnostics.  PACE_* are
+   only accumulated when pacing (PCAP_PUB_CNT gives the number of paced
+   packets such that PACE_LATE_SUM / PCAP_PUB_CNT is the average pacing
+   error).  If the cnc app region is at least FD_CNC_DIAG_PERF_APP_SZ
+   and the host supports it, the tile will also accumulate the standard
+   FD_CNC_DIAG_PERF_* hardware performance counter diagnostics.
 
    Except for IN_BACKP, none of the diagnostics are cleared at
    tile startup (as such that they can be accumulated over multiple
@@ -41,6 +52,14 @@
 #define FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   (5UL) /* ", frequently */
 #define FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT (6UL) /* ", frequently */
 #define FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  (7UL) /* ", frequently */
+#define FD_REPLAY_CNC_DIAG_PACE_LATE_SUM (12UL) /* On 2nd cache line of app region (after the tick diagnostics), frequently */
+#define FD_REPLAY_CNC_DIAG_PACE_LATE_MAX (13UL) /* ", frequently */
+#define FD_REPLAY_CNC_DIAG_LOOP_CNT      (14UL) /* ", rarely */
+
+/* FD_REPLAY_TILE_PCAP_MAX is the maximum number of pcaps a replay tile
+   can interleave. */
+
+#define FD_REPLAY_TILE_PCAP_MAX (64UL)
 
 /* FD_REPLAY_TILE_OUT_MAX are the maximum number of outputs a replay
    tile can have.  These limits are more or less arbitrary from a
@@ -51,22 +70,33 @@
 
 /* FD_REPLAY_TILE_SCRATCH_{ALIGN,FOOTPRINT} specify the alignment and
    footprint needed for a replay tile scratch region that can support
-   out_cnt outputs.  ALIGN is an integer power of 2 of at least double
-   cache line to mitigate various kinds of false sharing.  FOOTPRINT
-   will be an integer multiple of ALIGN.  out_cnt is assumed to be valid
-   (i.e. at most FD_REPLAY_TILE_OUT_MAX).  These are provided to
-   facilitate compile time declarations. */
+   interleaving pcap_cnt pcaps into a stream with out_cnt outputs.
+   ALIGN is an integer power of 2 of at least double cache line to
+   mitigate various kinds of false sharing.  FOOTPRINT will be an
+   integer multiple of ALIGN.  pcap_cnt and out_cnt are assumed to be
+   valid (i.e. pcap_cnt in [1,FD_REPLAY_TILE_PCAP_MAX] and out_cnt at
+   most FD_REPLAY_TILE_OUT_MAX).  These are provided to facilitate
+   compile time declarations. */
 
 #define FD_REPLAY_TILE_SCRATCH_ALIGN (128UL)
-#define FD_REPLAY_TILE_SCRATCH_FOOTPRINT( out_cnt )  \
-  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,  \
-    FD_FCTL_ALIGN, FD_FCTL_FOOTPRINT( (out_cnt) ) ), \
+#define FD_REPLAY_TILE_SCRATCH_FOOTPRINT( pcap_cnt, out_cnt )                 \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_INIT,         \
+    128UL,         (pcap_cnt)*384UL               ),                          \
+    FD_FCTL_ALIGN, FD_FCTL_FOOTPRINT( (out_cnt) ) ),                          \
     FD_REPLAY_TILE_SCRATCH_ALIGN )
 
 FD_PROTOTYPES_BEGIN
 
-/* fd_replay_tile replays a packets in a pcap file as a tango fragment
-   stream from origin orig into the given mcache and dcache.  The tile
+/* fd_replay_tile replays the packets in pcap_cnt pcap files as a tango
+   fragment stream from origin orig into the given mcache and dcache.
+   When pcap_cnt>1, the packets of the pcaps are interleaved in pcap
+   timestamp order (ties go to the pcap with the lowest index, each pcap
+   is assumed to be in timestamp order).  The pcaps can be pcap
+   (microsecond or nanosecond resolution) or pcapng captures of
+   Ethernet and/or cooked packets.  They are mapped read-only into the
+   tile's address space (see fd_pcap_map) and each packet is copied
+   exactly once, from the mapping into the dcache.  Packets larger than
+   pkt_max bytes (as published) end the pcap's current pass.  The tile
    can send to out_cnt reliable consumers and an arbitrary number of
    unreliable consumers.  (While reliable consumers are simple to reason
    about, they have especially high demands on their implementation as a
@@ -92,6 +122,24 @@ FD_PROTOTYPES_BEGIN
    mcache to facilitate easy muxing.  The dcache size should be adequate
    for compact writing.
 
+   By default, packets are published as fast as flow control allows.
+   If pace_speed is positive, packets are instead published at their
+   pcap timestamps relative to the first packet replayed, with the
+   inter-packet gaps divided by pace_speed (e.g. 1 replays at the
+   captured rate, 2 replays twice as fast).  If pace_rate is positive,
+   packets are instead published at a steady pace_rate packets per
+   second.  At most one of pace_speed and pace_rate can be positive.
+   Pacing is done by spinning until a packet's scheduled publish tick;
+   packets that could not be published by then (e.g. because of
+   backpressure) are published as soon as possible and the pacing
+   error is reported in the PACE_* diagnostics.  Pacing never drops
+   packets so a replay that falls behind catches up by bursting.
+
+   loop_cnt is the number of passes to make over the pcaps (0 means
+   loop forever).  Each pass is scheduled to start an average
+   inter-packet gap after the end of the previous pass.  The PCAP_DONE
+   diagnostic is set when the last pass is done.
+
    cr_max is the maximum number of flow control credits the replay tile
    is allowed for publishing frags.  It represents the maximum number of
    frags a reliable out can lag behind the output stream.  In the
@@ -116,11 +164,15 @@ FD_PROTOTYPES_BEGIN
    exclusively owned by the replay tile while the tile is running and is
    ideally near the core running the replay tile.
    fd_replay_tile_scratch_align will return the same value as
-   FD_REPLAY_TILE_SCRATCH_ALIGN.  If out_cnt is not valid,
+   FD_REPLAY_TILE_SCRATCH_ALIGN.  If pcap_cnt or out_cnt is not valid,
    fd_replay_tile_scratch_footprint silently returns 0 so callers can
    diagnose configuration issues.  Otherwise,
    fd_replay_tile_scratch_footprint will return the same value as
    FD_REPLAY_TILE_SCRATCH_FOOTPRINT.
+
+   If built with FD_HAS_TRACE, the tile records FD_TRACE_ID_{PUB,BACKP,
+   HKEEP} events into the calling thread's trace (see fd_trace.h), if
+   any.
    
    The lifetime of the cnc, mcache, dcache, out_fseq[*], rng and scratch
    used by this tile should be a superset of this tile's lifetime.
@@ -130,8 +182,9 @@ FD_PROTOTYPES_BEGIN
    in the system), or use scratch for anything.  This tile uses the
    fseqs passed to it in the usual producer ways (e.g. discovering the
    location of reliable consumers in the mcache's sequence space and
-   updating producer oriented diagnostics).  The out_fseq array and
-   pcap_path cstr will not be used the after the tile has successfully
+   updating producer oriented diagnostics).  The out_fseq array,
+   pcap_path array and pcap_path cstrs will not be used the after the
+   tile has successfully
    booted (transitioned the cnc from BOOT to RUN) or returned (e.g.
    failed to boot), whichever comes first. */
 
@@ -139,21 +192,26 @@ FD_FN_CONST ulong
 fd_replay_tile_scratch_align( void );
 
 FD_FN_CONST ulong
-fd_replay_tile_scratch_footprint( ulong out_cnt );
+fd_replay_tile_scratch_footprint( ulong pcap_cnt,
+                                  ulong out_cnt );
 
 int
-fd_replay_tile( fd_cnc_t *       cnc,       /* Local join to the replay's command-and-control */
-                char const *     pcap_path, /* Points to first byte of cstr with the path to the pcap to use */
-                ulong            pkt_max,   /* Upper bound of a size of packet in the pcap */
-                ulong            orig,      /* Origin for this pcap fragment stream, in [0,FD_FRAG_META_ORIG_MAX) */
-                fd_frag_meta_t * mcache,    /* Local join to the replay's frag stream output mcache */
-                uchar *          dcache,    /* Local join to the replay's frag stream output dcache */
-                ulong            out_cnt,   /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
-                ulong **         out_fseq,  /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
-                ulong            cr_max,    /* Maximum number of flow control credits, 0 means use a reasonable default */
-                long             lazy,      /* Lazyiness, <=0 means use a reasonable default */
-                fd_rng_t *       rng,       /* Local join to the rng this replay should use */
-                void *           scratch ); /* Tile scratch memory */
+fd_replay_tile( fd_cnc_t *       cnc,        /* Local join to the replay's command-and-control */
+                ulong            pcap_cnt,   /* Number of pcaps to interleave, in [1,FD_REPLAY_TILE_PCAP_MAX] */
+                char const **    pcap_path,  /* pcap_path[pcap_idx] points to first byte of cstr with the path to pcap pcap_idx */
+                ulong            pkt_max,    /* Upper bound of a size of packet in the pcaps, in [1,USHORT_MAX] */
+                float            pace_speed, /* Timestamp pacing speed multiplier, <=0 means no timestamp pacing */
+                float            pace_rate,  /* Steady pacing rate in packets per second, <=0 means no steady pacing */
+                ulong            loop_cnt,   /* Number of passes over the pcaps, 0 means loop forever */
+                ulong            orig,       /* Origin for this pcap fragment stream, in [0,FD_FRAG_META_ORIG_MAX) */
+                fd_frag_meta_t * mcache,     /* Local join to the replay's frag stream output mcache */
+                uchar *          dcache,     /* Local join to the replay's frag stream output dcache */
+                ulong            out_cnt,    /* Number of reliable consumers, reliable consumers are indexed [0,out_cnt) */
+                ulong **         out_fseq,   /* out_fseq[out_idx] is the local join to reliable consumer out_idx's fseq */
+                ulong            cr_max,     /* Maximum number of flow control credits, 0 means use a reasonable default */
+                long             lazy,       /* Lazyiness, <=0 means use a reasonable default */
+                fd_rng_t *       rng,        /* Local join to the rng this replay should use */
+                void *           scratch );  /* Tile scratch memory */
 
 FD_PROTOTYPES_END
 
@@ -12,8 +12,11 @@ main( int     argc,
   FD_LOG_NOTICE(( "Init" ));
 
   char const * _cnc       = fd_env_strip_cmdline_cstr ( &argc, &argv, "--cnc",       NULL, NULL   );
-  char const * _pcap      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--pcap",      NULL, NULL   );
+  char const * _pcaps     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--pcap",      NULL, NULL   );
   ulong        pkt_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-max",   NULL, 1522UL );
+  float        speed      = fd_env_strip_cmdline_float( &argc, &argv, "--speed",     NULL, 0.f    ); /* <=0 <> no timestamp pacing */
+  float        rate       = fd_env_strip_cmdline_float( &argc, &argv, "--rate",      NULL, 0.f    ); /* <=0 <> no steady pacing */
+  ulong        loop_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--loop-cnt",  NULL, 1UL    ); /*   0 <> loop forever */
   ulong        orig       = fd_env_strip_cmdline_ulong( &argc, &argv, "--orig",      NULL, 0UL    );
   char const * _mcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mcache",    NULL, NULL   );
   char const * _dcache    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--dcache",    NULL, NULL   );
@@ -27,8 +30,13 @@ main( int     argc,
   fd_cnc_t * cnc = fd_cnc_join( fd_wksp_map( _cnc ) );
   if( FD_UNLIKELY( !cnc ) ) FD_LOG_ERR(( "fd_cnc_join failed" ));
 
-  if( FD_UNLIKELY( !_pcap ) ) FD_LOG_ERR(( "--pcap not specified" ));
-  FD_LOG_NOTICE(( "Using --pcap %s", _pcap ));
+  if( FD_UNLIKELY( !_pcaps ) ) FD_LOG_ERR(( "--pcap not specified" ));
+  char * _pcap[ FD_REPLAY_TILE_PCAP_MAX+1UL ];
+  ulong pcap_cnt = fd_cstr_tokenize( _pcap, FD_REPLAY_TILE_PCAP_MAX+1UL, (char *)_pcaps, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( !pcap_cnt ) ) FD_LOG_ERR(( "--pcap not specified" ));
+  if( FD_UNLIKELY( pcap_cnt>FD_REPLAY_TILE_PCAP_MAX ) ) FD_LOG_ERR(( "too many --pcap specified for current implementation" ));
+  for( ulong pcap_idx=0UL; pcap_idx<pcap_cnt; pcap_idx++ ) FD_LOG_NOTICE(( "Using --pcap[%lu] %s", pcap_idx, _pcap[ pcap_idx ] ));
+  FD_LOG_NOTICE(( "Using --speed %g, --rate %g, --loop-cnt %lu", (double)speed, (double)rate, loop_cnt ));
 
   if( FD_UNLIKELY( !_mcache ) ) FD_LOG_ERR(( "--mcache not specified" ));
   FD_LOG_NOTICE(( "Joining --mcache %s", _mcache ));
@@ -53,12 +61,14 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Using --cr-max %lu, --lazy %li", cr_max, lazy ));
 
+  fd_trace_t * trace = fd_trace_join_from_args( &argc, &argv ); /* No --trace <> no tracing */
+
   FD_LOG_NOTICE(( "Creating rng --seed %u", seed ));
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, seed, 0UL ) );
 
   FD_LOG_NOTICE(( "Creating scratch" ));
-  ulong footprint = fd_replay_tile_scratch_footprint( out_cnt );
+  ulong footprint = fd_replay_tile_scratch_footprint( pcap_cnt, out_cnt );
   if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "fd_replay_tile_scratch_footprint failed" ));
   ulong  page_sz  = FD_SHMEM_HUGE_PAGE_SZ;
   ulong  page_cnt = fd_ulong_align_up( footprint, page_sz ) / page_sz;
@@ -69,13 +79,15 @@ main( int     argc,
 
   FD_LOG_NOTICE(( "Run" ));
 
-  int err = fd_replay_tile( cnc, _pcap, pkt_max, orig, mcache, dcache, out_cnt, out_fseq, cr_max, lazy, rng, scratch );
+  int err = fd_replay_tile( cnc, pcap_cnt, (char const **)_pcap, pkt_max, speed, rate, loop_cnt, orig, mcache, dcache,
+                            out_cnt, out_fseq, cr_max, lazy, rng, scratch );
   if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_replay_tile failed (%i)", err ));
 
   FD_LOG_NOTICE(( "Fini" ));
 
   fd_shmem_release( scratch, page_sz, page_cnt );
   fd_rng_delete( fd_rng_leave( rng ) );
+  fd_trace_leave_from_args( trace );
   for( ulong out_idx=out_cnt; out_idx; out_idx-- ) fd_wksp_unmap( fd_fseq_leave( out_fseq[ out_idx-1UL ] ) );
   fd_wksp_unmap( fd_dcache_leave( dcache ) );
   fd_wksp_unmap( fd_mcache_leave( mcache ) );
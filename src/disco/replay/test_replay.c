@@ -10,8 +10,12 @@ FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_PUB_CNT ==4UL, unit_test );
 FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ  ==5UL, unit_test );
 FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT==6UL, unit_test );
 FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ ==7UL, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PACE_LATE_SUM==12UL, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_PACE_LATE_MAX==13UL, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_CNC_DIAG_LOOP_CNT     ==14UL, unit_test );
 
-FD_STATIC_ASSERT( FD_REPLAY_TILE_OUT_MAX==8192UL, unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_TILE_PCAP_MAX==64UL,   unit_test );
+FD_STATIC_ASSERT( FD_REPLAY_TILE_OUT_MAX ==8192UL, unit_test );
 
 FD_STATIC_ASSERT( FD_REPLAY_TILE_SCRATCH_ALIGN==128UL, unit_test );
 
@@ -19,14 +23,19 @@ struct test_cfg {
   fd_wksp_t *  wksp;
 
   fd_cnc_t *       tx_cnc;
-  char const *     tx_pcap;
+  ulong            tx_pcap_cnt;
+  char const **    tx_pcap;
   ulong            tx_mtu;
+  float            tx_speed;
+  float            tx_rate;
+  ulong            tx_loop_cnt;
   ulong            tx_orig;
   fd_frag_meta_t * tx_mcache;
   uchar *          tx_dcache;
   ulong            tx_cr_max;
   long             tx_lazy;
   uint             tx_seed;
+  void *           tx_scratch;
 
   fd_cnc_t *       rx_cnc;
   ulong *          rx_fseq;
@@ -47,10 +56,9 @@ tx_tile_main( int     argc,
   fd_rng_t _rng[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, cfg->tx_seed, 0UL ) );
 
-  uchar scratch[ FD_REPLAY_TILE_SCRATCH_FOOTPRINT( 1UL ) ] __attribute__((aligned( FD_REPLAY_TILE_SCRATCH_ALIGN )));
-
-  FD_TEST( !fd_replay_tile( cfg->tx_cnc, cfg->tx_pcap, cfg->tx_mtu, cfg->tx_orig, cfg->tx_mcache, cfg->tx_dcache,
-                            1UL, &cfg->rx_fseq, cfg->tx_cr_max, cfg->tx_lazy, rng, scratch ) );
+  FD_TEST( !fd_replay_tile( cfg->tx_cnc, cfg->tx_pcap_cnt, cfg->tx_pcap, cfg->tx_mtu,
+                            cfg->tx_speed, cfg->tx_rate, cfg->tx_loop_cnt, cfg->tx_orig, cfg->tx_mcache, cfg->tx_dcache,
+                            1UL, &cfg->rx_fseq, cfg->tx_cr_max, cfg->tx_lazy, rng, cfg->tx_scratch ) );
 
   fd_rng_delete( fd_rng_leave( rng ) );
   return 0;
@@ -68,6 +76,8 @@ rx_tile_main( int     argc,
 
   /* Hook up to rx cnc */
   fd_cnc_t * cnc = cfg->rx_cnc;
+  ulong *    cnc_lhist_orig = fd_lhist_cnc_orig( cnc ); FD_TEST( cnc_lhist_orig );
+  ulong *    cnc_lhist_pub  = fd_lhist_cnc_pub ( cnc ); FD_TEST( cnc_lhist_pub  );
 
   /* Hook up to tx mcache */
   fd_frag_meta_t const * mcache = cfg->tx_mcache;
@@ -155,6 +165,11 @@ rx_tile_main( int     argc,
     seq_found = fd_frag_meta_seq_query( mline );
     if( FD_UNLIKELY( fd_seq_ne( seq_found, seq ) ) ) FD_LOG_ERR(( "Overrun while reading" ));
 
+    /* Accumulate latency diagnostics */
+    long now = fd_tickcount();
+    fd_lhist_sample( cnc_lhist_orig, fd_lhist_ts_lat( tsorig, now ) );
+    fd_lhist_sample( cnc_lhist_pub,  fd_lhist_ts_lat( tspub,  now ) );
+
     /* Wind up for the next iteration */
     seq = fd_seq_inc( seq, 1UL );
   }
@@ -175,30 +190,40 @@ main( int     argc,
   fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seq++, 0UL ) );
 
   FD_TEST( fd_replay_tile_scratch_align()==FD_REPLAY_TILE_SCRATCH_ALIGN );
-  FD_TEST( !fd_replay_tile_scratch_footprint( FD_REPLAY_TILE_OUT_MAX+1UL ) );
+  FD_TEST( !fd_replay_tile_scratch_footprint( 0UL,                         1UL                        ) );
+  FD_TEST( !fd_replay_tile_scratch_footprint( FD_REPLAY_TILE_PCAP_MAX+1UL, 1UL                        ) );
+  FD_TEST( !fd_replay_tile_scratch_footprint( 1UL,                         FD_REPLAY_TILE_OUT_MAX+1UL ) );
   for( ulong iter_rem=10000000UL; iter_rem; iter_rem-- ) {
-    ulong out_cnt = fd_rng_ulong_roll( rng, FD_REPLAY_TILE_OUT_MAX+1UL );
-    FD_TEST( fd_replay_tile_scratch_footprint( out_cnt )==FD_REPLAY_TILE_SCRATCH_FOOTPRINT( out_cnt ) );
+    ulong pcap_cnt = fd_rng_ulong_roll( rng, FD_REPLAY_TILE_PCAP_MAX ) + 1UL;
+    ulong out_cnt  = fd_rng_ulong_roll( rng, FD_REPLAY_TILE_OUT_MAX+1UL );
+    FD_TEST( fd_replay_tile_scratch_footprint( pcap_cnt, out_cnt )==FD_REPLAY_TILE_SCRATCH_FOOTPRINT( pcap_cnt, out_cnt ) );
   }
 
   ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
   if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
 
-  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                   );
-  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                          );
-  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx( cpu_idx ) );
-  char const * tx_pcap   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--tx-pcap",   NULL, NULL                         );
-  ulong        tx_mtu    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",    NULL, 1542UL                       );
-  ulong        tx_orig   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-orig",   NULL, 0UL                          );
-  ulong        tx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",  NULL, 32768UL                      );
-  ulong        tx_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cr-max", NULL, 0UL /* use default */        );
-  long         tx_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",   NULL, 0L /* use default */         );
-  int          rx_lazy   = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",   NULL, 7                            );
-  long         duration  = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",  NULL, (long)10e9                   );
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",     NULL, "gigantic"                   );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",    NULL, 1UL                          );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",    NULL, fd_shmem_numa_idx( cpu_idx ) );
+  char const * tx_pcaps  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--tx-pcap",     NULL, NULL                         );
+  ulong        tx_mtu    = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-mtu",      NULL, 1542UL                       );
+  float        tx_speed  = fd_env_strip_cmdline_float( &argc, &argv, "--tx-speed",    NULL, 0.f /* no ts pacing */       );
+  float        tx_rate   = fd_env_strip_cmdline_float( &argc, &argv, "--tx-rate",     NULL, 0.f /* no steady pacing */   );
+  ulong        tx_loops  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-loop-cnt", NULL, 1UL                          );
+  ulong        tx_orig   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-orig",     NULL, 0UL                          );
+  ulong        tx_depth  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-depth",    NULL, 32768UL                      );
+  ulong        tx_cr_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-cr-max",   NULL, 0UL /* use default */        );
+  long         tx_lazy   = fd_env_strip_cmdline_long ( &argc, &argv, "--tx-lazy",     NULL, 0L /* use default */         );
+  int          rx_lazy   = fd_env_strip_cmdline_int  ( &argc, &argv, "--rx-lazy",     NULL, 7                            );
+  long         duration  = fd_env_strip_cmdline_long ( &argc, &argv, "--duration",    NULL, (long)10e9                   );
 
   ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
   if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz"  ));
-  if( FD_UNLIKELY( !tx_pcap ) ) FD_LOG_ERR(( "--tx-pcap not specifed" ));
+  if( FD_UNLIKELY( !tx_pcaps ) ) FD_LOG_ERR(( "--tx-pcap not specifed" ));
+
+  char * tx_pcap[ FD_REPLAY_TILE_PCAP_MAX+1UL ];
+  ulong  tx_pcap_cnt = fd_cstr_tokenize( tx_pcap, FD_REPLAY_TILE_PCAP_MAX+1UL, (char *)tx_pcaps, ',' ); /* argv is non-const */
+  if( FD_UNLIKELY( (!tx_pcap_cnt) | (tx_pcap_cnt>FD_REPLAY_TILE_PCAP_MAX) ) ) FD_LOG_ERR(( "bad --tx-pcap" ));
 
   if( FD_UNLIKELY( fd_tile_cnt()<3UL ) ) FD_LOG_ERR(( "this unit test requires at least 3 tiles" ));
 
@@ -211,14 +236,18 @@ main( int     argc,
   cfg->wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
   FD_TEST( cfg->wksp );
 
-  FD_LOG_NOTICE(( "Creating tx cnc (app_sz 64, type 0, heartbeat0 %li)", hb0 ));
-  cfg->tx_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ), 1UL ),
-                             64UL, 0UL, hb0 ) );
+  FD_LOG_NOTICE(( "Creating tx cnc (app_sz %lu, type 0, heartbeat0 %li)", FD_CNC_DIAG_TICKS_APP_SZ, hb0 ));
+  cfg->tx_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( FD_CNC_DIAG_TICKS_APP_SZ ), 1UL ),
+                             FD_CNC_DIAG_TICKS_APP_SZ, 0UL, hb0 ) );
   FD_TEST( cfg->tx_cnc );
 
-  cfg->tx_pcap = tx_pcap;
-  cfg->tx_mtu  = tx_mtu;
-  cfg->tx_orig = tx_orig;
+  cfg->tx_pcap_cnt = tx_pcap_cnt;
+  cfg->tx_pcap     = (char const **)tx_pcap;
+  cfg->tx_mtu      = tx_mtu;
+  cfg->tx_speed    = tx_speed;
+  cfg->tx_rate     = tx_rate;
+  cfg->tx_loop_cnt = tx_loops;
+  cfg->tx_orig     = tx_orig;
 
   FD_LOG_NOTICE(( "Creating tx mcache (--tx-depth %lu, app_sz 0, seq0 %lu)", tx_depth, seq0 ));
   cfg->tx_mcache = fd_mcache_join( fd_mcache_new( fd_wksp_alloc_laddr( cfg->wksp,
@@ -239,9 +268,14 @@ main( int     argc,
   cfg->tx_lazy   = tx_lazy;
   cfg->tx_seed   = rng_seq++;
 
-  FD_LOG_NOTICE(( "Creating rx cnc (app_sz 64, type 1, heartbeat0 %li)", hb0 ));
-  cfg->rx_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( 64UL ), 1UL ),
-                                         64UL, 1UL, hb0 ) );
+  FD_LOG_NOTICE(( "Creating tx scratch (pcap_cnt %lu)", tx_pcap_cnt ));
+  ulong tx_scratch_footprint = fd_replay_tile_scratch_footprint( tx_pcap_cnt, 1UL ); FD_TEST( tx_scratch_footprint );
+  cfg->tx_scratch = fd_wksp_alloc_laddr( cfg->wksp, fd_replay_tile_scratch_align(), tx_scratch_footprint, 1UL );
+  FD_TEST( cfg->tx_scratch );
+
+  FD_LOG_NOTICE(( "Creating rx cnc (app_sz %lu, type 1, heartbeat0 %li)", FD_LHIST_CNC_APP_SZ, hb0 ));
+  cfg->rx_cnc = fd_cnc_join( fd_cnc_new( fd_wksp_alloc_laddr( cfg->wksp, fd_cnc_align(), fd_cnc_footprint( FD_LHIST_CNC_APP_SZ ), 1UL ),
+                                         FD_LHIST_CNC_APP_SZ, 1UL, hb0 ) );
   FD_TEST( cfg->rx_cnc );
 
   FD_LOG_NOTICE(( "Creating rx fseq (seq0 %lu)", seq0 ));
@@ -259,8 +293,9 @@ main( int     argc,
   FD_TEST( fd_cnc_wait( cfg->tx_cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
   FD_TEST( fd_cnc_wait( cfg->rx_cnc, FD_CNC_SIGNAL_BOOT, (long)5e9, NULL )==FD_CNC_SIGNAL_RUN );
 
-  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --tx-cr-max %lu, tx_seed %u, --rx-lazy %i)",
-                  duration, tx_lazy, tx_cr_max, cfg->tx_seed, rx_lazy ));
+  FD_LOG_NOTICE(( "Running (--duration %li ns, --tx-lazy %li ns, --tx-cr-max %lu, tx_seed %u, --rx-lazy %i, "
+                  "--tx-speed %g, --tx-rate %g, --tx-loop-cnt %lu)",
+                  duration, tx_lazy, tx_cr_max, cfg->tx_seed, rx_lazy, (double)tx_speed, (double)tx_rate, tx_loops ));
 
   ulong const * tx_cnc_diag = (ulong const *)fd_cnc_app_laddr( cfg->tx_cnc );
 
@@ -282,10 +317,14 @@ main( int     argc,
       ulong pub_sz    = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_PUB_SZ   ];
       ulong filt_cnt  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_CNT ];
       ulong filt_sz   = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PCAP_FILT_SZ  ];
+      ulong late_sum  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PACE_LATE_SUM ];
+      ulong late_max  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_PACE_LATE_MAX ];
+      ulong loop_cnt  = tx_cnc_diag[ FD_REPLAY_CNC_DIAG_LOOP_CNT      ];
       FD_COMPILER_MFENCE();
       FD_LOG_NOTICE(( "monitor\n\t"
-                      "tx: pub_cnt %20lu pub_sz %20lu filt_cnt %20lu filt_sz %20lu",
-                      pub_cnt, pub_sz, filt_cnt, filt_sz ));
+                      "tx: pub_cnt %20lu pub_sz %20lu filt_cnt %20lu filt_sz %20lu\n\t"
+                      "tx: loop_cnt %lu pace late avg %lu max %lu ticks",
+                      pub_cnt, pub_sz, filt_cnt, filt_sz, loop_cnt, pub_cnt ? late_sum/pub_cnt : 0UL, late_max ));
       if( FD_UNLIKELY( pcap_done ) ) {
         FD_LOG_NOTICE(( "pcap replay finished before duration" ));
         break;
@@ -313,8 +352,23 @@ main( int     argc,
   FD_TEST( !fd_tile_exec_delete( tx_exec, &ret ) ); FD_TEST( !ret );
   FD_TEST( !fd_tile_exec_delete( rx_exec, &ret ) ); FD_TEST( !ret );
 
+  do {
+    ulong const * lhist_orig = fd_lhist_cnc_orig( cfg->rx_cnc );
+    ulong const * lhist_pub  = fd_lhist_cnc_pub ( cfg->rx_cnc );
+    ulong         rx_cnt     = fd_lhist_cnt( lhist_orig );
+    FD_TEST( fd_lhist_cnt( lhist_pub )==rx_cnt );
+    if( rx_cnt ) {
+      ulong orig_idx = fd_lhist_quantile( lhist_orig, 0.5 );
+      ulong pub_idx  = fd_lhist_quantile( lhist_pub,  0.5 );
+      FD_LOG_NOTICE(( "rx: cnt %lu, median tsorig lat [%lu,%lu) ticks, median tspub lat [%lu,%lu) ticks", rx_cnt,
+                      fd_lhist_bucket_lo( orig_idx ), fd_lhist_bucket_hi( orig_idx ),
+                      fd_lhist_bucket_lo( pub_idx  ), fd_lhist_bucket_hi( pub_idx  ) ));
+    }
+  } while(0);
+
   FD_LOG_NOTICE(( "Cleaning up" ));
   
+  fd_wksp_free_laddr( cfg->tx_scratch );
   fd_wksp_free_laddr( fd_fseq_delete  ( fd_fseq_leave  ( cfg->rx_fseq   ) ) );
   fd_wksp_free_laddr( fd_cnc_delete   ( fd_cnc_leave   ( cfg->rx_cnc    ) ) );
   fd_wksp_free_laddr( fd_dcache_delete( fd_dcache_leave( cfg->tx_dcache ) ) );
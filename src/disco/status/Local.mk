@@ -0,0 +1,5 @@
+$(call add-hdrs,fd_status_cache.h)
+$(call add-objs,fd_status_cache,fd_disco)
+$(call make-unit-test,test_status_cache,test_status_cache,fd_disco fd_tango fd_util)
+$(call make-unit-test,bench_status_cache,bench_status_cache,fd_disco fd_tango fd_util)
+$(call run-unit-test,test_status_cache,)
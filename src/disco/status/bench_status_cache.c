@@ -0,0 +1,185 @@
+#include "../fd_disco.h"
+
+/* bench_status_cache simulates replay-side duplicate detection on a
+   single fork.  Every slot has a new blockhash and --txn-per-slot
+   transactions land in it, each referencing a uniformly random
+   blockhash from the last --bh-win slots.  For each slot, it purges the
+   blockhash that just expired, queries each transaction against the
+   fork's ancestors (these miss, as they would for a non-duplicate),
+   inserts the slot's transactions and queries them again (these hit,
+   as they would for a duplicate).  Once the cache has reached its
+   steady state size (--bh-win slots of history), it reports the rates
+   of each operation alongside the 1M txn/s target. */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",      NULL, "gigantic"                   );
+  ulong        page_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",     NULL, 1UL                          );
+  ulong        numa_idx     = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",     NULL, fd_shmem_numa_idx( cpu_idx ) );
+  ulong        txn_per_slot = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-per-slot", NULL, 16384UL                      );
+  ulong        bh_win       = fd_env_strip_cmdline_ulong( &argc, &argv, "--bh-win",       NULL, 150UL                        );
+  ulong        slot_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--slot-cnt",     NULL, 450UL                        );
+
+  if( FD_UNLIKELY( !txn_per_slot       ) ) FD_LOG_ERR(( "--txn-per-slot should be positive" ));
+  if( FD_UNLIKELY( !bh_win             ) ) FD_LOG_ERR(( "--bh-win should be positive" ));
+  if( FD_UNLIKELY( slot_cnt<=2UL*bh_win ) ) FD_LOG_ERR(( "--slot-cnt should be larger than 2*--bh-win" ));
+
+  /* A blockhash created in slot s is referenced by txns landing in
+     slots [s,s+bh_win) and purged at the start of slot s+bh_win.  So
+     there are at most bh_win blockhashes and bh_win*txn_per_slot txns
+     in the cache. */
+
+  ulong bh_max  = bh_win;
+  ulong txn_max = bh_win*txn_per_slot;
+
+  ulong footprint = fd_status_cache_footprint( bh_max, txn_max );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "--txn-per-slot and/or --bh-win too large" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp =
+    fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  FD_LOG_NOTICE(( "Creating status cache (bh_max %lu, txn_max %lu, footprint %.1f MiB)",
+                  bh_max, txn_max, ((double)footprint)/((double)(1UL<<20)) ));
+
+  void * mem = fd_wksp_alloc_laddr( wksp, fd_status_cache_align(), footprint, 1UL );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "status cache too large for workspace" ));
+  fd_status_cache_t * cache = fd_status_cache_join( fd_status_cache_new( mem, bh_max, txn_max, fd_rng_ulong( rng ) ) );
+  FD_TEST( cache );
+
+  /* txn_bh[i] / txn_sig[i] hold the blockhash and signature of the i-th
+     txn of the current slot (generated outside the timed region).  The
+     blockhash of slot s is a hash of s.  anc holds the current slot and
+     its ancestors within the blockhash window in ascending order. */
+
+  uchar * txn_bh  = (uchar *)fd_wksp_alloc_laddr( wksp, 0UL, txn_per_slot*FD_STATUS_CACHE_BLOCKHASH_SZ,  1UL );
+  uchar * txn_sig = (uchar *)fd_wksp_alloc_laddr( wksp, 0UL, txn_per_slot*FD_STATUS_CACHE_SIG_PREFIX_SZ, 1UL );
+  ulong * anc     = (ulong *)fd_wksp_alloc_laddr( wksp, 0UL, bh_win*sizeof(ulong),                       1UL );
+  if( FD_UNLIKELY( (!txn_bh) | (!txn_sig) | (!anc) ) ) FD_LOG_ERR(( "--txn-per-slot too large for workspace" ));
+
+  FD_LOG_NOTICE(( "Benchmarking (--txn-per-slot %lu --bh-win %lu --slot-cnt %lu)", txn_per_slot, bh_win, slot_cnt ));
+
+# define BH(  i) (txn_bh  + (i)*FD_STATUS_CACHE_BLOCKHASH_SZ )
+# define SIG( i) (txn_sig + (i)*FD_STATUS_CACHE_SIG_PREFIX_SZ)
+
+  long  dt_miss   = 0L;
+  long  dt_insert = 0L;
+  long  dt_hit    = 0L;
+  long  dt_purge  = 0L;
+  ulong txn_cnt   = 0UL;
+  ulong err_cnt   = 0UL;
+
+  ulong txn_seq = 0UL;
+  for( ulong slot=0UL; slot<slot_cnt; slot++ ) {
+
+    /* Generate this slot's txns */
+
+    ulong bh_min = slot - fd_ulong_min( slot, bh_win-1UL );
+    for( ulong txn_idx=0UL; txn_idx<txn_per_slot; txn_idx++ ) {
+      ulong   bh_slot = bh_min + fd_rng_ulong_roll( rng, slot-bh_min+1UL );
+      uchar * bh      = txn_bh  + txn_idx*FD_STATUS_CACHE_BLOCKHASH_SZ;
+      uchar * sig     = txn_sig + txn_idx*FD_STATUS_CACHE_SIG_PREFIX_SZ;
+      for( ulong i=0UL; i<4UL; i++ ) FD_STORE( ulong, bh + i*sizeof(ulong), fd_ulong_hash( (bh_slot<<2) | i ) );
+      FD_STORE( ulong, sig,               fd_ulong_hash( (txn_seq<<1)     ) );
+      FD_STORE( ulong, sig+sizeof(ulong), fd_ulong_hash( (txn_seq<<1)|1UL ) );
+      txn_seq++;
+    }
+
+    ulong anc_cnt = slot-bh_min+1UL;
+    for( ulong anc_idx=0UL; anc_idx<anc_cnt; anc_idx++ ) anc[ anc_idx ] = bh_min + anc_idx;
+
+    int measure = (slot>=bh_win);
+
+    /* Expire the blockhash created bh_win slots ago */
+
+    long tic = fd_log_wallclock();
+    if( slot>=bh_win ) {
+      uchar bh[ FD_STATUS_CACHE_BLOCKHASH_SZ ];
+      ulong bh_slot = slot-bh_win;
+      for( ulong i=0UL; i<4UL; i++ ) FD_STORE( ulong, bh + i*sizeof(ulong), fd_ulong_hash( (bh_slot<<2) | i ) );
+      fd_status_cache_purge( cache, bh );
+    }
+    long toc = fd_log_wallclock(); if( measure ) dt_purge += toc - tic;
+
+    /* Query (misses) */
+
+    tic = fd_log_wallclock();
+    for( ulong txn_idx=0UL; txn_idx<txn_per_slot; txn_idx++ ) {
+      err_cnt += (ulong)( fd_status_cache_query( cache, BH( txn_idx ), SIG( txn_idx ), anc, anc_cnt )!=FD_STATUS_CACHE_SLOT_NULL );
+    }
+    toc = fd_log_wallclock(); if( measure ) dt_miss += toc - tic;
+
+    /* Insert */
+
+    tic = fd_log_wallclock();
+    for( ulong txn_idx=0UL; txn_idx<txn_per_slot; txn_idx++ ) {
+      err_cnt += (ulong)!!fd_status_cache_insert( cache, BH( txn_idx ), SIG( txn_idx ), slot );
+    }
+    toc = fd_log_wallclock(); if( measure ) dt_insert += toc - tic;
+
+    /* Query (hits) */
+
+    tic = fd_log_wallclock();
+    for( ulong txn_idx=0UL; txn_idx<txn_per_slot; txn_idx++ ) {
+      err_cnt += (ulong)( fd_status_cache_query( cache, BH( txn_idx ), SIG( txn_idx ), anc, anc_cnt )!=slot );
+    }
+    toc = fd_log_wallclock(); if( measure ) dt_hit += toc - tic;
+
+    if( measure ) txn_cnt += txn_per_slot;
+  }
+
+# undef SIG
+# undef BH
+
+  FD_TEST( !err_cnt );
+  FD_TEST( !fd_status_cache_verify( cache ) );
+
+  FD_LOG_NOTICE(( "steady state: %lu blockhashes, %lu txns", fd_status_cache_bh_cnt( cache ), fd_status_cache_txn_cnt( cache ) ));
+
+  double target = 1e-3; /* 1M txn/s in txn/ns */
+  double txn    = (double)txn_cnt;
+# define REPORT( name, dt ) \
+  FD_LOG_NOTICE(( "%-12s %8.3f Mtxn/s, %7.3f ns/txn (%.1fx the 1M txn/s target)", \
+                  name, 1e3*txn/(double)(dt), (double)(dt)/txn, txn/((double)(dt)*target) ))
+  REPORT( "query miss", dt_miss                              );
+  REPORT( "insert",     dt_insert                            );
+  REPORT( "query hit",  dt_hit                               );
+  REPORT( "purge",      dt_purge                             );
+  REPORT( "replay",     dt_miss + dt_insert + dt_purge       ); /* check + record + expire per txn */
+# undef REPORT
+
+  fd_wksp_free_laddr( anc     );
+  fd_wksp_free_laddr( txn_sig );
+  fd_wksp_free_laddr( txn_bh  );
+  fd_wksp_free_laddr( fd_status_cache_delete( fd_status_cache_leave( cache ) ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -0,0 +1,414 @@
+#include "fd_status_cache.h"
+
+/* Provide the actual map implementations */
+
+#define MAP_NAME              fd_status_cache_bh_map
+#define MAP_T                 fd_status_cache_bh_ele_t
+#define MAP_KEY_T             fd_status_cache_bh_t
+#define MAP_KEY               bh
+#define MAP_KEY_EQ(k0,k1)     fd_status_cache_bh_eq((k0),(k1))
+#define MAP_KEY_HASH(k0,seed) fd_status_cache_bh_hash((k0),(seed))
+#define MAP_NEXT              map_next
+#define MAP_MAGIC             (0xf17eda2c35ca4b40UL) /* firedancer status cache bh map version 0 */
+#define MAP_IMPL_STYLE        2
+#include "../../util/tmpl/fd_map_giant.c"
+
+#define MAP_NAME              fd_status_cache_txn_map
+#define MAP_T                 fd_status_cache_txn_ele_t
+#define MAP_KEY_T             fd_status_cache_txn_key_t
+#define MAP_KEY               key
+#define MAP_KEY_EQ(k0,k1)     fd_status_cache_txn_key_eq((k0),(k1))
+#define MAP_KEY_HASH(k0,seed) fd_status_cache_txn_key_hash((k0),(seed))
+#define MAP_NEXT              map_next
+#define MAP_MAGIC             (0xf17eda2c35ca7c40UL) /* firedancer status cache txn map version 0 */
+#define MAP_IMPL_STYLE        2
+#include "../../util/tmpl/fd_map_giant.c"
+
+/* fd_status_cache_private_{bh_map,txn_map}_off return the byte offsets
+   of the blockhash and txn map shmem regions from the start of the
+   status cache.  Assumes bh_max and txn_max are valid. */
+
+FD_FN_CONST static inline ulong
+fd_status_cache_private_bh_map_off( void ) {
+  return fd_ulong_align_up( sizeof(fd_status_cache_t), fd_status_cache_bh_map_align() );
+}
+
+FD_FN_CONST static inline ulong
+fd_status_cache_private_txn_map_off( ulong bh_max ) {
+  return fd_ulong_align_up( fd_status_cache_private_bh_map_off() + fd_status_cache_bh_map_footprint( bh_max ),
+                            fd_status_cache_txn_map_align() );
+}
+
+ulong
+fd_status_cache_align( void ) {
+  return FD_STATUS_CACHE_ALIGN;
+}
+
+ulong
+fd_status_cache_footprint( ulong bh_max,
+                           ulong txn_max ) {
+  if( FD_UNLIKELY( (!bh_max) | (!txn_max) ) ) return 0UL;
+
+  ulong bh_map_footprint  = fd_status_cache_bh_map_footprint ( bh_max  ); if( FD_UNLIKELY( !bh_map_footprint  ) ) return 0UL;
+  ulong txn_map_footprint = fd_status_cache_txn_map_footprint( txn_max ); if( FD_UNLIKELY( !txn_map_footprint ) ) return 0UL;
+
+  /* Each map footprint is less than 2^63 so the below can't overflow */
+
+  ulong txn_map_off = fd_status_cache_private_txn_map_off( bh_max );
+  return fd_ulong_align_up( txn_map_off + txn_map_footprint, FD_STATUS_CACHE_ALIGN );
+}
+
+void *
+fd_status_cache_new( void * shmem,
+                     ulong  bh_max,
+                     ulong  txn_max,
+                     ulong  seed ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_status_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_status_cache_footprint( bh_max, txn_max ) ) ) {
+    FD_LOG_WARNING(( "bad bh_max (%lu) and/or txn_max (%lu)", bh_max, txn_max ));
+    return NULL;
+  }
+
+  fd_status_cache_t * cache = (fd_status_cache_t *)shmem;
+
+  fd_memset( cache, 0, sizeof(fd_status_cache_t) );
+
+  ulong bh_map_off  = fd_status_cache_private_bh_map_off();
+  ulong txn_map_off = fd_status_cache_private_txn_map_off( bh_max );
+
+  fd_status_cache_bh_ele_t * bh_map =
+    fd_status_cache_bh_map_join( fd_status_cache_bh_map_new( (void *)((ulong)shmem + bh_map_off), bh_max, seed ) );
+  if( FD_UNLIKELY( !bh_map ) ) {
+    FD_LOG_WARNING(( "fd_status_cache_bh_map_new failed" ));
+    return NULL;
+  }
+
+  fd_status_cache_txn_ele_t * txn_map =
+    fd_status_cache_txn_map_join( fd_status_cache_txn_map_new( (void *)((ulong)shmem + txn_map_off), txn_max, seed ) );
+  if( FD_UNLIKELY( !txn_map ) ) {
+    FD_LOG_WARNING(( "fd_status_cache_txn_map_new failed" ));
+    fd_status_cache_bh_map_delete( fd_status_cache_bh_map_leave( bh_map ) );
+    return NULL;
+  }
+
+  cache->bh_max      = bh_max;
+  cache->txn_max     = txn_max;
+  cache->seed        = seed;
+  cache->bh_map_off  = (ulong)bh_map  - (ulong)shmem;
+  cache->txn_map_off = (ulong)txn_map - (ulong)shmem;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = FD_STATUS_CACHE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_status_cache_t *
+fd_status_cache_join( void * shcache ) {
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_status_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  fd_status_cache_t * cache = (fd_status_cache_t *)shcache;
+  if( FD_UNLIKELY( cache->magic!=FD_STATUS_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return cache;
+}
+
+void *
+fd_status_cache_leave( fd_status_cache_t * cache ) {
+
+  if( FD_UNLIKELY( !cache ) ) {
+    FD_LOG_WARNING(( "NULL cache" ));
+    return NULL;
+  }
+
+  return (void *)cache;
+}
+
+void *
+fd_status_cache_delete( void * shcache ) {
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_status_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  fd_status_cache_t * cache = (fd_status_cache_t *)shcache;
+  if( FD_UNLIKELY( cache->magic!=FD_STATUS_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  fd_status_cache_txn_map_delete( fd_status_cache_txn_map_leave( fd_status_cache_txn_map( cache ) ) );
+  fd_status_cache_bh_map_delete ( fd_status_cache_bh_map_leave ( fd_status_cache_bh_map ( cache ) ) );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shcache;
+}
+
+int
+fd_status_cache_insert( fd_status_cache_t * cache,
+                        uchar const *       blockhash,
+                        uchar const *       sig,
+                        ulong               slot ) {
+
+  fd_status_cache_bh_ele_t  * bh_map  = fd_status_cache_bh_map ( cache );
+  fd_status_cache_txn_ele_t * txn_map = fd_status_cache_txn_map( cache );
+
+  fd_status_cache_bh_t bh[1];
+  fd_memcpy( bh->uc, blockhash, FD_STATUS_CACHE_BLOCKHASH_SZ );
+
+  fd_status_cache_txn_key_t key[1];
+  fd_memcpy( key->sig, sig, FD_STATUS_CACHE_SIG_PREFIX_SZ );
+
+  fd_status_cache_bh_ele_t * bh_ele = fd_status_cache_bh_map_query( bh_map, bh, NULL );
+  if( FD_LIKELY( bh_ele ) ) {
+
+    /* The blockhash is known.  If this txn has already landed
+       somewhere, record this slot in its slot list. */
+
+    key->bh_idx = (ulong)(bh_ele - bh_map);
+
+    fd_status_cache_txn_ele_t * txn_ele = fd_status_cache_txn_map_query( txn_map, key, NULL );
+    if( FD_UNLIKELY( txn_ele ) ) {
+      ulong slot_cnt = txn_ele->slot_cnt;
+      for( ulong slot_idx=0UL; slot_idx<slot_cnt; slot_idx++ ) if( txn_ele->slot[ slot_idx ]==slot ) return FD_STATUS_CACHE_SUCCESS;
+      if( FD_UNLIKELY( slot_cnt>=FD_STATUS_CACHE_SLOT_MAX ) ) return FD_STATUS_CACHE_ERR_SLOT_MAX;
+      txn_ele->slot[ slot_cnt ] = slot;
+      txn_ele->slot_cnt         = slot_cnt+1UL;
+      bh_ele->slot_min = fd_ulong_min( bh_ele->slot_min, slot );
+      bh_ele->slot_max = fd_ulong_max( bh_ele->slot_max, slot );
+      return FD_STATUS_CACHE_SUCCESS;
+    }
+
+    if( FD_UNLIKELY( fd_status_cache_txn_map_is_full( txn_map ) ) ) return FD_STATUS_CACHE_ERR_FULL;
+
+  } else {
+
+    /* New blockhash.  Make sure there is room for both the blockhash
+       and the txn before modifying anything. */
+
+    if( FD_UNLIKELY( fd_status_cache_bh_map_is_full ( bh_map  ) |
+                     fd_status_cache_txn_map_is_full( txn_map ) ) ) return FD_STATUS_CACHE_ERR_FULL;
+
+    bh_ele = fd_status_cache_bh_map_insert( bh_map, bh );
+    bh_ele->slot_min     = slot;
+    bh_ele->slot_max     = slot;
+    bh_ele->txn_head_idx = FD_STATUS_CACHE_IDX_NULL;
+    bh_ele->txn_cnt      = 0UL;
+
+    key->bh_idx = (ulong)(bh_ele - bh_map);
+  }
+
+  fd_status_cache_txn_ele_t * txn_ele = fd_status_cache_txn_map_insert( txn_map, key );
+  txn_ele->bh_next_idx = bh_ele->txn_head_idx;
+  txn_ele->slot_cnt    = 1UL;
+  txn_ele->slot[0]     = slot;
+
+  bh_ele->txn_head_idx = (ulong)(txn_ele - txn_map);
+  bh_ele->txn_cnt++;
+  bh_ele->slot_min = fd_ulong_min( bh_ele->slot_min, slot );
+  bh_ele->slot_max = fd_ulong_max( bh_ele->slot_max, slot );
+
+  return FD_STATUS_CACHE_SUCCESS;
+}
+
+ulong
+fd_status_cache_query( fd_status_cache_t const * cache,
+                       uchar const *             blockhash,
+                       uchar const *             sig,
+                       ulong const *             ancestor,
+                       ulong                     ancestor_cnt ) {
+
+  fd_status_cache_bh_ele_t  const * bh_map  = fd_status_cache_bh_map_const ( cache );
+  fd_status_cache_txn_ele_t const * txn_map = fd_status_cache_txn_map_const( cache );
+
+  fd_status_cache_bh_t bh[1];
+  fd_memcpy( bh->uc, blockhash, FD_STATUS_CACHE_BLOCKHASH_SZ );
+
+  fd_status_cache_bh_ele_t const * bh_ele = fd_status_cache_bh_map_query_const( bh_map, bh, NULL );
+  if( FD_UNLIKELY( !bh_ele ) ) return FD_STATUS_CACHE_SLOT_NULL;
+
+  fd_status_cache_txn_key_t key[1];
+  key->bh_idx = (ulong)(bh_ele - bh_map);
+  fd_memcpy( key->sig, sig, FD_STATUS_CACHE_SIG_PREFIX_SZ );
+
+  fd_status_cache_txn_ele_t const * txn_ele = fd_status_cache_txn_map_query_const( txn_map, key, NULL );
+  if( FD_LIKELY( !txn_ele ) ) return FD_STATUS_CACHE_SLOT_NULL;
+
+  if( !ancestor ) return txn_ele->slot[0];
+
+  /* Binary search the (sorted) ancestors for each slot this txn landed
+     in.  slot_cnt is almost always 1 (the txn only landed on a single
+     fork). */
+
+  ulong slot_cnt = txn_ele->slot_cnt;
+  for( ulong slot_idx=0UL; slot_idx<slot_cnt; slot_idx++ ) {
+    ulong slot = txn_ele->slot[ slot_idx ];
+    ulong l = 0UL;
+    ulong h = ancestor_cnt;
+    while( l<h ) { /* ancestor[i]<slot for i in [0,l) and ancestor[i]>=slot for i in [h,ancestor_cnt) */
+      ulong m = (l+h) >> 1;
+      int   c = ancestor[ m ]<slot;
+      l = fd_ulong_if( c, m+1UL, l );
+      h = fd_ulong_if( c, h,     m );
+    }
+    if( (l<ancestor_cnt) && ancestor[ l ]==slot ) return slot;
+  }
+
+  return FD_STATUS_CACHE_SLOT_NULL;
+}
+
+/* fd_status_cache_private_purge removes bh_ele and all its txns from
+   the cache.  Returns the number of txns removed. */
+
+static ulong
+fd_status_cache_private_purge( fd_status_cache_bh_ele_t  * bh_map,
+                               fd_status_cache_txn_ele_t * txn_map,
+                               fd_status_cache_bh_ele_t  * bh_ele ) {
+  ulong txn_cnt = bh_ele->txn_cnt;
+
+  ulong txn_idx = bh_ele->txn_head_idx;
+  while( txn_idx!=FD_STATUS_CACHE_IDX_NULL ) {
+    fd_status_cache_txn_ele_t * txn_ele = txn_map + txn_idx;
+    txn_idx = txn_ele->bh_next_idx; /* Read before txn_ele is freed */
+    fd_status_cache_txn_key_t key[1]; *key = txn_ele->key;
+    fd_status_cache_txn_map_remove( txn_map, key );
+  }
+
+  fd_status_cache_bh_t bh[1]; *bh = bh_ele->bh;
+  fd_status_cache_bh_map_remove( bh_map, bh );
+
+  return txn_cnt;
+}
+
+ulong
+fd_status_cache_purge( fd_status_cache_t * cache,
+                       uchar const *       blockhash ) {
+
+  fd_status_cache_bh_ele_t  * bh_map  = fd_status_cache_bh_map ( cache );
+  fd_status_cache_txn_ele_t * txn_map = fd_status_cache_txn_map( cache );
+
+  fd_status_cache_bh_t bh[1];
+  fd_memcpy( bh->uc, blockhash, FD_STATUS_CACHE_BLOCKHASH_SZ );
+
+  fd_status_cache_bh_ele_t * bh_ele = fd_status_cache_bh_map_query( bh_map, bh, NULL );
+  if( FD_UNLIKELY( !bh_ele ) ) return 0UL;
+
+  return fd_status_cache_private_purge( bh_map, txn_map, bh_ele );
+}
+
+ulong
+fd_status_cache_purge_older( fd_status_cache_t * cache,
+                             ulong               slot ) {
+
+  fd_status_cache_bh_ele_t  * bh_map  = fd_status_cache_bh_map ( cache );
+  fd_status_cache_txn_ele_t * txn_map = fd_status_cache_txn_map( cache );
+
+  /* Note: the map iterator visits elements in descending index order
+     so it is fine to remove the current element while iterating. */
+
+  ulong txn_cnt = 0UL;
+  for( fd_status_cache_bh_map_iter_t iter = fd_status_cache_bh_map_iter_init( bh_map );
+       !fd_status_cache_bh_map_iter_done( bh_map, iter );
+       iter = fd_status_cache_bh_map_iter_next( bh_map, iter ) ) {
+    fd_status_cache_bh_ele_t * bh_ele = fd_status_cache_bh_map_iter_ele( bh_map, iter );
+    if( bh_ele->slot_max<slot ) txn_cnt += fd_status_cache_private_purge( bh_map, txn_map, bh_ele );
+  }
+
+  return txn_cnt;
+}
+
+int
+fd_status_cache_verify( fd_status_cache_t const * cache ) {
+
+# define TEST(c) do {                                                            \
+    if( FD_UNLIKELY( !(c) ) ) { FD_LOG_WARNING(( "FAIL: %s", #c )); return -1; } \
+  } while(0)
+
+  TEST( cache );
+  TEST( cache->magic==FD_STATUS_CACHE_MAGIC );
+
+  fd_status_cache_bh_ele_t  const * bh_map  = fd_status_cache_bh_map_const ( cache );
+  fd_status_cache_txn_ele_t const * txn_map = fd_status_cache_txn_map_const( cache );
+
+  TEST( !fd_status_cache_bh_map_verify ( bh_map  ) );
+  TEST( !fd_status_cache_txn_map_verify( txn_map ) );
+
+  ulong bh_max  = cache->bh_max;
+  ulong txn_max = cache->txn_max;
+
+  TEST( fd_status_cache_bh_map_key_max ( bh_map  )==bh_max  );
+  TEST( fd_status_cache_txn_map_key_max( txn_map )==txn_max );
+
+  /* Every txn of every blockhash should point back to its blockhash,
+     have a sane slot list in the blockhash's slot range and every txn
+     should be reachable from exactly one blockhash. */
+
+  ulong txn_cnt = 0UL;
+  for( fd_status_cache_bh_map_iter_t iter = fd_status_cache_bh_map_iter_init( bh_map );
+       !fd_status_cache_bh_map_iter_done( bh_map, iter );
+       iter = fd_status_cache_bh_map_iter_next( bh_map, iter ) ) {
+    fd_status_cache_bh_ele_t const * bh_ele = fd_status_cache_bh_map_iter_ele_const( bh_map, iter );
+    ulong bh_idx = (ulong)(bh_ele - bh_map);
+
+    TEST( bh_ele->txn_cnt );
+    TEST( bh_ele->slot_min<=bh_ele->slot_max );
+
+    ulong cnt     = 0UL;
+    ulong txn_idx = bh_ele->txn_head_idx;
+    while( txn_idx!=FD_STATUS_CACHE_IDX_NULL ) {
+      TEST( txn_idx<txn_max );
+      TEST( cnt<bh_ele->txn_cnt ); /* Detect cycles */
+      fd_status_cache_txn_ele_t const * txn_ele = txn_map + txn_idx;
+      TEST( txn_ele->key.bh_idx==bh_idx );
+      TEST( fd_status_cache_txn_map_query_const( txn_map, &txn_ele->key, NULL )==txn_ele );
+      TEST( (1UL<=txn_ele->slot_cnt) & (txn_ele->slot_cnt<=FD_STATUS_CACHE_SLOT_MAX) );
+      for( ulong slot_idx=0UL; slot_idx<txn_ele->slot_cnt; slot_idx++ ) {
+        ulong s = txn_ele->slot[ slot_idx ];
+        TEST( (bh_ele->slot_min<=s) & (s<=bh_ele->slot_max) );
+        for( ulong prev_idx=0UL; prev_idx<slot_idx; prev_idx++ ) TEST( txn_ele->slot[ prev_idx ]!=s );
+      }
+      cnt++;
+      txn_idx = txn_ele->bh_next_idx;
+    }
+    TEST( cnt==bh_ele->txn_cnt );
+    txn_cnt += cnt;
+  }
+
+  TEST( txn_cnt==fd_status_cache_txn_map_key_cnt( txn_map ) );
+
+# undef TEST
+
+  return 0;
+}
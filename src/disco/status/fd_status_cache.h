@@ -0,0 +1,333 @@
+#ifndef HEADER_fd_src_disco_status_fd_status_cache_h
+#define HEADER_fd_src_disco_status_fd_status_cache_h
+
+/* A fd_status_cache_t records which slots transactions landed in such
+   that replay can tell if a transaction was already processed on the
+   fork it is replaying.  Unlike a tcache (which forgets purely by
+   insertion order and knows nothing about forks), entries are keyed by
+   the transaction's recent blockhash and a prefix of its first
+   signature, record the (small number of) slots the transaction landed
+   in across forks and are purged in bulk when their blockhash expires
+   (i.e. falls out of the blockhash validity window).
+
+   Queries are fork aware: a query gives the set of slots that are
+   ancestors of (or are) the slot being replayed and the cache reports
+   whether the transaction landed in any of them.
+
+   Under the hood, there are two fd_map_giant.  The blockhash map has an
+   element per blockhash currently in the cache.  The txn map has an
+   element per (blockhash,signature prefix) currently in the cache.  The
+   txn elements of a blockhash are linked together from the blockhash's
+   element such that purging a blockhash is O(number of transactions
+   referencing it) (and not O(cache size)).  Both maps and the cache
+   metadata live in a single memory region (e.g. a wksp allocation)
+   that is position independent (e.g. can be mapped at different
+   addresses by different processes or persisted). */
+
+#include "../fd_disco_base.h"
+
+/* FD_STATUS_CACHE_{BLOCKHASH_SZ,SIG_PREFIX_SZ} give the number of bytes
+   in a blockhash and the number of leading bytes of a transaction's
+   first signature used to identify a transaction.  Signatures are
+   effectively random so 16 bytes is more than ample to avoid spurious
+   collisions among the transactions referencing a given blockhash. */
+
+#define FD_STATUS_CACHE_BLOCKHASH_SZ  (32UL)
+#define FD_STATUS_CACHE_SIG_PREFIX_SZ (16UL)
+
+/* FD_STATUS_CACHE_SLOT_MAX is the maximum number of distinct slots
+   recorded for a transaction.  A transaction can only land multiple
+   times if it lands on different forks, so this is the number of
+   competing forks (within the blockhash window) a transaction can land
+   on. */
+
+#define FD_STATUS_CACHE_SLOT_MAX (4UL)
+
+/* FD_STATUS_CACHE_{SLOT,IDX}_NULL are sentinel slot and element index
+   values. */
+
+#define FD_STATUS_CACHE_SLOT_NULL (ULONG_MAX)
+#define FD_STATUS_CACHE_IDX_NULL  (ULONG_MAX)
+
+/* FD_STATUS_CACHE_{SUCCESS,ERR_*} are error codes returned by the
+   status cache APIs.  SUCCESS is zero and ERR_* are negative integers. */
+
+#define FD_STATUS_CACHE_SUCCESS      (0)  /* Success */
+#define FD_STATUS_CACHE_ERR_FULL     (-1) /* Failed because the blockhash or txn map is full */
+#define FD_STATUS_CACHE_ERR_SLOT_MAX (-2) /* Failed because the transaction already landed in SLOT_MAX slots */
+
+/* fd_status_cache_bh_t is a blockhash */
+
+union fd_status_cache_bh {
+  uchar uc[ FD_STATUS_CACHE_BLOCKHASH_SZ ];
+  ulong ul[ FD_STATUS_CACHE_BLOCKHASH_SZ/sizeof(ulong) ];
+};
+
+typedef union fd_status_cache_bh fd_status_cache_bh_t;
+
+/* fd_status_cache_bh_ele_t is an element of the blockhash map */
+
+struct fd_status_cache_bh_ele {
+  fd_status_cache_bh_t bh;           /* Managed by the bh map */
+  ulong                map_next;     /* Managed by the bh map */
+  ulong                slot_min;     /* Smallest slot a transaction referencing this blockhash landed in */
+  ulong                slot_max;     /* Largest  slot "                                             " */
+  ulong                txn_head_idx; /* txn map index of the most recently inserted txn of this blockhash, IDX_NULL if none */
+  ulong                txn_cnt;      /* Number of txns of this blockhash */
+};
+
+typedef struct fd_status_cache_bh_ele fd_status_cache_bh_ele_t;
+
+/* fd_status_cache_txn_key_t identifies a transaction.  bh_idx is the
+   blockhash map index of the transaction's blockhash (stable while the
+   blockhash is in the cache). */
+
+struct fd_status_cache_txn_key {
+  ulong bh_idx;
+  ulong sig[ FD_STATUS_CACHE_SIG_PREFIX_SZ/sizeof(ulong) ];
+};
+
+typedef struct fd_status_cache_txn_key fd_status_cache_txn_key_t;
+
+/* fd_status_cache_txn_ele_t is an element of the txn map */
+
+struct fd_status_cache_txn_ele {
+  fd_status_cache_txn_key_t key;         /* Managed by the txn map */
+  ulong                     map_next;    /* Managed by the txn map */
+  ulong                     bh_next_idx; /* txn map index of the next txn of this blockhash, IDX_NULL if last */
+  ulong                     slot_cnt;    /* Number of slots this txn landed in, in [1,SLOT_MAX] */
+  ulong                     slot[ FD_STATUS_CACHE_SLOT_MAX ]; /* Indexed [0,slot_cnt) */
+};
+
+typedef struct fd_status_cache_txn_ele fd_status_cache_txn_ele_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_PURE static inline ulong
+fd_status_cache_bh_hash( fd_status_cache_bh_t const * bh,
+                         ulong                        seed ) {
+  return ( fd_ulong_hash( seed ^ (1UL<<0) ^ bh->ul[0] ) ^ fd_ulong_hash( seed ^ (1UL<<1) ^ bh->ul[1] ) ) ^
+         ( fd_ulong_hash( seed ^ (1UL<<2) ^ bh->ul[2] ) ^ fd_ulong_hash( seed ^ (1UL<<3) ^ bh->ul[3] ) );
+}
+
+FD_FN_PURE static inline int
+fd_status_cache_bh_eq( fd_status_cache_bh_t const * a,
+                       fd_status_cache_bh_t const * b ) {
+  return !( (a->ul[0]^b->ul[0]) | (a->ul[1]^b->ul[1]) | (a->ul[2]^b->ul[2]) | (a->ul[3]^b->ul[3]) );
+}
+
+FD_FN_PURE static inline ulong
+fd_status_cache_txn_key_hash( fd_status_cache_txn_key_t const * k,
+                              ulong                             seed ) {
+  /* sig is effectively random so this just needs to mix in bh_idx and
+     the seed */
+  return fd_ulong_hash( seed ^ k->sig[0] ^ fd_ulong_hash( k->bh_idx ^ k->sig[1] ) );
+}
+
+FD_FN_PURE static inline int
+fd_status_cache_txn_key_eq( fd_status_cache_txn_key_t const * a,
+                            fd_status_cache_txn_key_t const * b ) {
+  return !( (a->bh_idx^b->bh_idx) | (a->sig[0]^b->sig[0]) | (a->sig[1]^b->sig[1]) );
+}
+
+FD_PROTOTYPES_END
+
+#define MAP_NAME              fd_status_cache_bh_map
+#define MAP_T                 fd_status_cache_bh_ele_t
+#define MAP_KEY_T             fd_status_cache_bh_t
+#define MAP_KEY               bh
+#define MAP_KEY_EQ(k0,k1)     fd_status_cache_bh_eq((k0),(k1))
+#define MAP_KEY_HASH(k0,seed) fd_status_cache_bh_hash((k0),(seed))
+#define MAP_NEXT              map_next
+#define MAP_MAGIC             (0xf17eda2c35ca4b40UL) /* firedancer status cache bh map version 0 */
+#define MAP_IMPL_STYLE        1
+#include "../../util/tmpl/fd_map_giant.c"
+
+#define MAP_NAME              fd_status_cache_txn_map
+#define MAP_T                 fd_status_cache_txn_ele_t
+#define MAP_KEY_T             fd_status_cache_txn_key_t
+#define MAP_KEY               key
+#define MAP_KEY_EQ(k0,k1)     fd_status_cache_txn_key_eq((k0),(k1))
+#define MAP_KEY_HASH(k0,seed) fd_status_cache_txn_key_hash((k0),(seed))
+#define MAP_NEXT              map_next
+#define MAP_MAGIC             (0xf17eda2c35ca7c40UL) /* firedancer status cache txn map version 0 */
+#define MAP_IMPL_STYLE        1
+#include "../../util/tmpl/fd_map_giant.c"
+
+/* FD_STATUS_CACHE_ALIGN is the alignment of a status cache */
+
+#define FD_STATUS_CACHE_ALIGN (128UL)
+
+/* fd_status_cache_t is an opaque handle of a status cache.  Details
+   are exposed here to facilitate inlining. */
+
+#define FD_STATUS_CACHE_MAGIC (0xf17eda2c35ca0000UL) /* firedancer status cache version 0 */
+
+struct __attribute__((aligned(FD_STATUS_CACHE_ALIGN))) fd_status_cache_private {
+  ulong magic;       /* ==FD_STATUS_CACHE_MAGIC */
+  ulong bh_max;      /* Max number of blockhashes in the cache */
+  ulong txn_max;     /* Max number of txns in the cache */
+  ulong seed;        /* Seed used for map hashing */
+  ulong bh_map_off;  /* Byte offset from the cache to the local join of the blockhash map (position independent) */
+  ulong txn_map_off; /* Byte offset from the cache to the local join of the txn map (position independent) */
+
+  /* Padding to FD_STATUS_CACHE_ALIGN */
+
+  /* blockhash map shmem here */
+  /* txn map shmem here */
+};
+
+typedef struct fd_status_cache_private fd_status_cache_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_status_cache_{align,footprint} return the alignment and footprint
+   needed for a memory region to be used as a status cache that can hold
+   up to bh_max blockhashes and txn_max transactions.  bh_max and
+   txn_max should be positive.  footprint returns 0 for bad parameters
+   (and thus can be used to validate them). */
+
+FD_FN_CONST ulong
+fd_status_cache_align( void );
+
+FD_FN_CONST ulong
+fd_status_cache_footprint( ulong bh_max,
+                           ulong txn_max );
+
+/* fd_status_cache_new formats an unused memory region for use as a
+   status cache.  shmem is a non-NULL pointer to this region in the
+   local address space with the required footprint and alignment.
+   seed is an arbitrary value used to seed the map hash functions.
+   Returns shmem (and the memory region it points to will be formatted
+   as an empty status cache, caller is not joined) on success and NULL
+   on failure (logs details). */
+
+void *
+fd_status_cache_new( void * shmem,
+                     ulong  bh_max,
+                     ulong  txn_max,
+                     ulong  seed );
+
+/* fd_status_cache_join joins the caller to the status cache.
+   fd_status_cache_leave leaves a current local join.
+   fd_status_cache_delete unformats a memory region used as a status
+   cache (assumes nobody is joined).  These have the usual semantics
+   (see e.g. fd_tcache.h). */
+
+fd_status_cache_t *
+fd_status_cache_join( void * shcache );
+
+void *
+fd_status_cache_leave( fd_status_cache_t * cache );
+
+void *
+fd_status_cache_delete( void * shcache );
+
+/* Accessors.  Assumes cache is a current local join. */
+
+FD_FN_PURE static inline ulong fd_status_cache_bh_max ( fd_status_cache_t const * cache ) { return cache->bh_max;  }
+FD_FN_PURE static inline ulong fd_status_cache_txn_max( fd_status_cache_t const * cache ) { return cache->txn_max; }
+FD_FN_PURE static inline ulong fd_status_cache_seed   ( fd_status_cache_t const * cache ) { return cache->seed;    }
+
+/* fd_status_cache_{bh_map,txn_map} return the local joins of the
+   cache's blockhash and txn maps.  These can be indexed as flat arrays
+   (see fd_map_giant.c) and are provided for diagnostics / advanced
+   usage.  The const variants are the same but for const caches. */
+
+FD_FN_PURE static inline fd_status_cache_bh_ele_t *
+fd_status_cache_bh_map( fd_status_cache_t * cache ) {
+  return (fd_status_cache_bh_ele_t *)((ulong)cache + cache->bh_map_off);
+}
+
+FD_FN_PURE static inline fd_status_cache_txn_ele_t *
+fd_status_cache_txn_map( fd_status_cache_t * cache ) {
+  return (fd_status_cache_txn_ele_t *)((ulong)cache + cache->txn_map_off);
+}
+
+FD_FN_PURE static inline fd_status_cache_bh_ele_t const *
+fd_status_cache_bh_map_const( fd_status_cache_t const * cache ) {
+  return (fd_status_cache_bh_ele_t const *)((ulong)cache + cache->bh_map_off);
+}
+
+FD_FN_PURE static inline fd_status_cache_txn_ele_t const *
+fd_status_cache_txn_map_const( fd_status_cache_t const * cache ) {
+  return (fd_status_cache_txn_ele_t const *)((ulong)cache + cache->txn_map_off);
+}
+
+/* fd_status_cache_{bh_cnt,txn_cnt} return the number of blockhashes
+   and transactions currently in the cache. */
+
+FD_FN_PURE static inline ulong
+fd_status_cache_bh_cnt( fd_status_cache_t const * cache ) {
+  return fd_status_cache_bh_map_key_cnt( fd_status_cache_bh_map_const( cache ) );
+}
+
+FD_FN_PURE static inline ulong
+fd_status_cache_txn_cnt( fd_status_cache_t const * cache ) {
+  return fd_status_cache_txn_map_key_cnt( fd_status_cache_txn_map_const( cache ) );
+}
+
+/* fd_status_cache_insert records that the transaction with the given
+   recent blockhash (points to FD_STATUS_CACHE_BLOCKHASH_SZ bytes) and
+   first signature (points to at least FD_STATUS_CACHE_SIG_PREFIX_SZ
+   bytes) landed in slot.  Inserting a transaction that is already
+   recorded for slot is a no-op.  Returns FD_STATUS_CACHE_SUCCESS on
+   success and a FD_STATUS_CACHE_ERR code on failure (the cache is
+   unchanged on failure).  Assumes cache is a current local join and
+   there are no concurrent operations on the cache. */
+
+int
+fd_status_cache_insert( fd_status_cache_t * cache,
+                        uchar const *       blockhash,
+                        uchar const *       sig,
+                        ulong               slot );
+
+/* fd_status_cache_query returns a slot in which the transaction with
+   the given recent blockhash and first signature landed and that is in
+   ancestor.  ancestor points to ancestor_cnt slots sorted in ascending
+   order (e.g. the slot being replayed and its ancestors within the
+   blockhash window).  If ancestor is NULL, any slot the transaction
+   landed in matches.  Returns FD_STATUS_CACHE_SLOT_NULL if no such slot
+   (e.g. the transaction has not been processed on this fork).  Assumes
+   cache is a current local join and there are no concurrent insert /
+   purge operations (concurrent queries are fine). */
+
+FD_FN_PURE ulong
+fd_status_cache_query( fd_status_cache_t const * cache,
+                       uchar const *             blockhash,
+                       uchar const *             sig,
+                       ulong const *             ancestor,
+                       ulong                     ancestor_cnt );
+
+/* fd_status_cache_purge removes the given blockhash and all the
+   transactions referencing it from the cache (e.g. because it has
+   expired).  Returns the number of transactions removed (0 if the
+   blockhash was not in the cache).
+
+   fd_status_cache_purge_older purges all blockhashes (and their
+   transactions) whose transactions all landed in slots before slot
+   (e.g. slot is the oldest slot in the blockhash validity window of
+   the root).  Returns the number of transactions removed.  This is
+   O(bh_max + number of transactions removed).
+
+   Assumes cache is a current local join and there are no concurrent
+   operations on the cache. */
+
+ulong
+fd_status_cache_purge( fd_status_cache_t * cache,
+                       uchar const *       blockhash );
+
+ulong
+fd_status_cache_purge_older( fd_status_cache_t * cache,
+                             ulong               slot );
+
+/* fd_status_cache_verify returns 0 if the cache is not obviously
+   corrupt or -1 (logs details) otherwise.  This is O(bh_max+txn_max)
+   and intended for testing and diagnostics. */
+
+int
+fd_status_cache_verify( fd_status_cache_t const * cache );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_status_fd_status_cache_h */
@@ -0,0 +1,278 @@
+#include "../fd_disco.h"
+
+FD_STATIC_ASSERT( FD_STATUS_CACHE_ALIGN==128UL,                  unit_test );
+FD_STATIC_ASSERT( sizeof(fd_status_cache_t)==FD_STATUS_CACHE_ALIGN, unit_test );
+FD_STATIC_ASSERT( sizeof(fd_status_cache_bh_t)==FD_STATUS_CACHE_BLOCKHASH_SZ, unit_test );
+FD_STATIC_ASSERT( FD_STATUS_CACHE_SUCCESS==0,                    unit_test );
+
+#define BH_MAX  (64UL)
+#define TXN_MAX (4096UL)
+
+static uchar __attribute__((aligned(FD_STATUS_CACHE_ALIGN))) shmem[ 1UL<<20 ];
+
+/* Reference model: txn i references blockhash ref_bh[i] and landed in
+   the slots in ref_slot[i][0,ref_slot_cnt[i]) */
+
+static ulong ref_bh      [ TXN_MAX ];
+static ulong ref_slot    [ TXN_MAX ][ FD_STATUS_CACHE_SLOT_MAX ];
+static ulong ref_slot_cnt[ TXN_MAX ];
+
+static void
+make_bh( uchar * bh,
+         ulong   idx ) {
+  for( ulong i=0UL; i<FD_STATUS_CACHE_BLOCKHASH_SZ/sizeof(ulong); i++ ) FD_STORE( ulong, bh + i*sizeof(ulong), fd_ulong_hash( idx*4UL+i ) );
+}
+
+static void
+make_sig( uchar * sig,
+          ulong   idx ) {
+  for( ulong i=0UL; i<64UL/sizeof(ulong); i++ ) FD_STORE( ulong, sig + i*sizeof(ulong), fd_ulong_hash( (idx<<8) + i + 0x5167UL ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Test footprint validation */
+
+  FD_TEST( fd_status_cache_align()==FD_STATUS_CACHE_ALIGN );
+  FD_TEST( !fd_status_cache_footprint( 0UL,    TXN_MAX ) );
+  FD_TEST( !fd_status_cache_footprint( BH_MAX, 0UL     ) );
+  FD_TEST( !fd_status_cache_footprint( BH_MAX, 1UL<<62 ) );
+  ulong footprint = fd_status_cache_footprint( BH_MAX, TXN_MAX );
+  FD_TEST( footprint && fd_ulong_is_aligned( footprint, FD_STATUS_CACHE_ALIGN ) );
+  FD_TEST( footprint<=sizeof(shmem) );
+  FD_LOG_NOTICE(( "footprint %lu (bh_max %lu, txn_max %lu)", footprint, BH_MAX, TXN_MAX ));
+
+  /* Test construction */
+
+  FD_TEST( !fd_status_cache_new( NULL,    BH_MAX, TXN_MAX, 1234UL ) ); /* NULL shmem */
+  FD_TEST( !fd_status_cache_new( shmem+1, BH_MAX, TXN_MAX, 1234UL ) ); /* misaligned shmem */
+  FD_TEST( !fd_status_cache_new( shmem,   0UL,    TXN_MAX, 1234UL ) ); /* bad bh_max */
+  FD_TEST( !fd_status_cache_new( shmem,   BH_MAX, 0UL,     1234UL ) ); /* bad txn_max */
+
+  void * shcache = fd_status_cache_new( shmem, BH_MAX, TXN_MAX, 1234UL ); FD_TEST( shcache==(void *)shmem );
+
+  FD_TEST( !fd_status_cache_join( NULL    ) ); /* NULL shcache */
+  FD_TEST( !fd_status_cache_join( shmem+1 ) ); /* misaligned shcache */
+
+  fd_status_cache_t * cache = fd_status_cache_join( shcache ); FD_TEST( cache );
+
+  FD_TEST( fd_status_cache_bh_max ( cache )==BH_MAX  );
+  FD_TEST( fd_status_cache_txn_max( cache )==TXN_MAX );
+  FD_TEST( fd_status_cache_seed   ( cache )==1234UL  );
+  FD_TEST( fd_status_cache_bh_cnt ( cache )==0UL     );
+  FD_TEST( fd_status_cache_txn_cnt( cache )==0UL     );
+  FD_TEST( !fd_status_cache_verify( cache ) );
+
+  uchar bh [ FD_STATUS_CACHE_BLOCKHASH_SZ ];
+  uchar sig[ 64 ];
+
+  /* Test fork aware queries.  Fork layout:
+
+       10 - 11 - 12         (fork A)
+              \
+               13 - 14      (fork B)
+
+     txn 0 lands in 11 (common ancestor), txn 1 lands in 12 and 14
+     (both forks), txn 2 lands only in 13. */
+
+  ulong anc_a[] = { 10UL, 11UL, 12UL };
+  ulong anc_b[] = { 10UL, 11UL, 13UL, 14UL };
+
+  make_bh( bh, 0UL );
+  make_sig( sig, 0UL ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 11UL )==FD_STATUS_CACHE_SUCCESS );
+  make_sig( sig, 1UL ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 12UL )==FD_STATUS_CACHE_SUCCESS );
+  make_sig( sig, 1UL ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 14UL )==FD_STATUS_CACHE_SUCCESS );
+  make_sig( sig, 1UL ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 14UL )==FD_STATUS_CACHE_SUCCESS ); /* idempotent */
+  make_sig( sig, 2UL ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 13UL )==FD_STATUS_CACHE_SUCCESS );
+
+  FD_TEST( fd_status_cache_bh_cnt ( cache )==1UL );
+  FD_TEST( fd_status_cache_txn_cnt( cache )==3UL );
+  FD_TEST( !fd_status_cache_verify( cache ) );
+
+  make_sig( sig, 0UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_a, 3UL )==11UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_b, 4UL )==11UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_a, 1UL )==FD_STATUS_CACHE_SLOT_NULL ); /* replaying slot 10 */
+  FD_TEST( fd_status_cache_query( cache, bh, sig, NULL,  0UL )==11UL );
+  make_sig( sig, 1UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_a, 3UL )==12UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_b, 4UL )==14UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_b, 3UL )==FD_STATUS_CACHE_SLOT_NULL ); /* replaying slot 13 */
+  make_sig( sig, 2UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_a, 3UL )==FD_STATUS_CACHE_SLOT_NULL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_b, 4UL )==13UL );
+  make_sig( sig, 3UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, NULL,  0UL )==FD_STATUS_CACHE_SLOT_NULL ); /* unknown txn */
+  make_bh( bh, 1UL ); make_sig( sig, 0UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, NULL,  0UL )==FD_STATUS_CACHE_SLOT_NULL ); /* unknown blockhash */
+
+  /* Same signature under a different blockhash is a different txn */
+
+  FD_TEST( fd_status_cache_insert( cache, bh, sig, 12UL )==FD_STATUS_CACHE_SUCCESS );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_a, 3UL )==12UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, anc_b, 4UL )==FD_STATUS_CACHE_SLOT_NULL );
+
+  /* Test slot list overflow */
+
+  make_bh( bh, 0UL ); make_sig( sig, 0UL );
+  for( ulong i=1UL; i<FD_STATUS_CACHE_SLOT_MAX; i++ ) FD_TEST( fd_status_cache_insert( cache, bh, sig, 20UL+i )==FD_STATUS_CACHE_SUCCESS );
+  FD_TEST( fd_status_cache_insert( cache, bh, sig, 30UL )==FD_STATUS_CACHE_ERR_SLOT_MAX );
+  FD_TEST( fd_status_cache_insert( cache, bh, sig, 11UL )==FD_STATUS_CACHE_SUCCESS ); /* already recorded */
+  FD_TEST( !fd_status_cache_verify( cache ) );
+
+  /* Test purge */
+
+  FD_TEST( fd_status_cache_purge( cache, bh )==3UL );
+  FD_TEST( fd_status_cache_purge( cache, bh )==0UL );
+  FD_TEST( fd_status_cache_bh_cnt ( cache )==1UL );
+  FD_TEST( fd_status_cache_txn_cnt( cache )==1UL );
+  FD_TEST( fd_status_cache_query( cache, bh, sig, NULL, 0UL )==FD_STATUS_CACHE_SLOT_NULL );
+  FD_TEST( !fd_status_cache_verify( cache ) );
+  make_bh( bh, 1UL );
+  FD_TEST( fd_status_cache_purge( cache, bh )==1UL );
+  FD_TEST( fd_status_cache_bh_cnt ( cache )==0UL );
+  FD_TEST( fd_status_cache_txn_cnt( cache )==0UL );
+  FD_TEST( !fd_status_cache_verify( cache ) );
+
+  /* Randomized test against a reference model.  Blockhash j is used by
+     txns landing in slots [j,j+WIN) and, every slot, blockhashes older
+     than the window are purged with purge_older. */
+
+# define WIN (16UL)
+
+  FD_LOG_NOTICE(( "Testing random inserts / queries / purges" ));
+
+  ulong txn_cnt = 0UL;
+  ulong slot    = 0UL;
+  for( ulong iter=0UL; iter<256UL; iter++ ) {
+    slot++;
+
+    /* Expire blockhashes whose txns all landed before the window.  A
+       blockhash survives purge_older(slot-WIN) iff some txn of it
+       landed at or after slot-WIN. */
+
+    if( slot>WIN ) {
+      ulong purged = fd_status_cache_purge_older( cache, slot-WIN );
+
+      ulong ref_purged = 0UL;
+      for( ulong bh_idx=0UL; bh_idx<slot; bh_idx++ ) {
+        ulong bh_slot_max = 0UL;
+        ulong bh_txn_cnt  = 0UL;
+        for( ulong txn_idx=0UL; txn_idx<txn_cnt; txn_idx++ ) {
+          if( (ref_bh[ txn_idx ]!=bh_idx) | (!ref_slot_cnt[ txn_idx ]) ) continue;
+          bh_txn_cnt++;
+          for( ulong j=0UL; j<ref_slot_cnt[ txn_idx ]; j++ ) bh_slot_max = fd_ulong_max( bh_slot_max, ref_slot[ txn_idx ][ j ] );
+        }
+        if( bh_txn_cnt && bh_slot_max<slot-WIN ) {
+          for( ulong txn_idx=0UL; txn_idx<txn_cnt; txn_idx++ ) if( ref_bh[ txn_idx ]==bh_idx ) ref_slot_cnt[ txn_idx ] = 0UL;
+          ref_purged += bh_txn_cnt;
+        }
+      }
+
+      FD_TEST( purged==ref_purged );
+    }
+
+    /* Land some new txns and some old txns again in this slot */
+
+    ulong ins_cnt = fd_rng_ulong_roll( rng, 16UL );
+    for( ulong i=0UL; i<ins_cnt; i++ ) {
+      ulong txn_idx;
+      if( txn_cnt && fd_rng_uint_roll( rng, 4U )==0U ) {
+        txn_idx = fd_rng_ulong_roll( rng, txn_cnt );
+        if( !ref_slot_cnt[ txn_idx ] || ref_bh[ txn_idx ]+WIN<=slot ) continue; /* expired */
+      } else {
+        if( txn_cnt>=TXN_MAX ) continue;
+        txn_idx = txn_cnt++;
+        ref_bh      [ txn_idx ] = slot - fd_ulong_min( slot, fd_rng_ulong_roll( rng, WIN ) );
+        ref_slot_cnt[ txn_idx ] = 0UL;
+      }
+
+      make_bh( bh, ref_bh[ txn_idx ] ); make_sig( sig, txn_idx );
+      int err = fd_status_cache_insert( cache, bh, sig, slot );
+
+      ulong cnt = ref_slot_cnt[ txn_idx ];
+      int   dup = 0; for( ulong j=0UL; j<cnt; j++ ) dup |= (ref_slot[ txn_idx ][ j ]==slot);
+      if( dup )                               FD_TEST( err==FD_STATUS_CACHE_SUCCESS );
+      else if( cnt>=FD_STATUS_CACHE_SLOT_MAX ) FD_TEST( err==FD_STATUS_CACHE_ERR_SLOT_MAX );
+      else {
+        FD_TEST( err==FD_STATUS_CACHE_SUCCESS );
+        ref_slot[ txn_idx ][ cnt ] = slot;
+        ref_slot_cnt[ txn_idx ]    = cnt+1UL;
+      }
+    }
+
+    /* Check the cache matches the reference, querying against a random
+       subset of recent slots as the "ancestors" */
+
+    ulong anc[ WIN ]; ulong anc_cnt = 0UL;
+    for( ulong s=slot-fd_ulong_min( slot, WIN-1UL ); s<=slot; s++ ) if( fd_rng_uint_roll( rng, 2U ) ) anc[ anc_cnt++ ] = s;
+
+    ulong ref_txn_cnt = 0UL;
+    for( ulong txn_idx=0UL; txn_idx<txn_cnt; txn_idx++ ) {
+      make_bh( bh, ref_bh[ txn_idx ] ); make_sig( sig, txn_idx );
+      ulong cnt = ref_slot_cnt[ txn_idx ];
+      ref_txn_cnt += (ulong)!!cnt;
+
+      ulong any = fd_status_cache_query( cache, bh, sig, NULL, 0UL );
+      if( !cnt ) { FD_TEST( any==FD_STATUS_CACHE_SLOT_NULL ); continue; }
+      FD_TEST( any==ref_slot[ txn_idx ][ 0 ] );
+
+      ulong expected = FD_STATUS_CACHE_SLOT_NULL;
+      for( ulong j=0UL; j<cnt && expected==FD_STATUS_CACHE_SLOT_NULL; j++ )
+        for( ulong k=0UL; k<anc_cnt; k++ ) if( anc[ k ]==ref_slot[ txn_idx ][ j ] ) { expected = anc[ k ]; break; }
+      FD_TEST( fd_status_cache_query( cache, bh, sig, anc, anc_cnt )==expected );
+    }
+    FD_TEST( fd_status_cache_txn_cnt( cache )==ref_txn_cnt );
+    FD_TEST( !fd_status_cache_verify( cache ) );
+  }
+
+# undef WIN
+
+  /* Test full */
+
+  fd_status_cache_purge_older( cache, ULONG_MAX );
+  FD_TEST( fd_status_cache_bh_cnt ( cache )==0UL );
+  FD_TEST( fd_status_cache_txn_cnt( cache )==0UL );
+
+  make_bh( bh, 0UL );
+  for( ulong txn_idx=0UL; txn_idx<TXN_MAX; txn_idx++ ) {
+    make_sig( sig, txn_idx );
+    FD_TEST( fd_status_cache_insert( cache, bh, sig, 1UL )==FD_STATUS_CACHE_SUCCESS );
+  }
+  make_sig( sig, TXN_MAX ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 1UL )==FD_STATUS_CACHE_ERR_FULL );
+  make_sig( sig, 0UL     ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 2UL )==FD_STATUS_CACHE_SUCCESS ); /* no new txn needed */
+  FD_TEST( !fd_status_cache_verify( cache ) );
+  FD_TEST( fd_status_cache_purge( cache, bh )==TXN_MAX );
+
+  for( ulong bh_idx=0UL; bh_idx<BH_MAX; bh_idx++ ) {
+    make_bh( bh, bh_idx ); make_sig( sig, bh_idx );
+    FD_TEST( fd_status_cache_insert( cache, bh, sig, bh_idx )==FD_STATUS_CACHE_SUCCESS );
+  }
+  make_bh( bh, BH_MAX ); FD_TEST( fd_status_cache_insert( cache, bh, sig, 0UL )==FD_STATUS_CACHE_ERR_FULL );
+  FD_TEST( fd_status_cache_txn_cnt( cache )==BH_MAX );
+  FD_TEST( fd_status_cache_purge_older( cache, BH_MAX/2UL )==BH_MAX/2UL );
+  FD_TEST( fd_status_cache_bh_cnt( cache )==BH_MAX/2UL );
+  FD_TEST( !fd_status_cache_verify( cache ) );
+
+  /* Test destruction */
+
+  FD_TEST( !fd_status_cache_leave( NULL ) ); /* NULL cache */
+  FD_TEST( fd_status_cache_leave( cache )==shcache );
+
+  FD_TEST( !fd_status_cache_delete( NULL    ) ); /* NULL shcache */
+  FD_TEST( !fd_status_cache_delete( shmem+1 ) ); /* misaligned shcache */
+  FD_TEST( fd_status_cache_delete( shcache )==(void *)shmem );
+  FD_TEST( !fd_status_cache_join  ( shcache ) ); /* bad magic */
+  FD_TEST( !fd_status_cache_delete( shcache ) ); /* bad magic */
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,6 @@
+$(call add-hdrs,fd_bloom.h)
+$(call add-objs,fd_bloom,fd_tango)
+$(call make-unit-test,test_bloom,test_bloom,fd_tango fd_util)
+$(call run-unit-test,test_bloom)
+
+$(call make-unit-test,bench_bloom,bench_bloom,fd_tango fd_util)
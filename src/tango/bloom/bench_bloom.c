@@ -0,0 +1,194 @@
+#include "../fd_tango.h"
+
+/* bench_bloom compares a bloom against a tcache with the same memory
+   footprint as a deduplication history.  It generates a stream of tags
+   where a --dup-frac fraction of tags are duplicates of one of the last
+   --lag-max unique tags (uniformly) and the rest are unique.  For each
+   bloom size, it runs the stream through a bloom (individual inserts
+   and with prefetching --pf-dist tags ahead) and through the deepest
+   (default sparsity) tcache that fits in the same footprint, reporting
+   throughput, the fraction of duplicates missed (the tcache forgets
+   duplicates older than its depth) and the fraction of unique tags
+   falsely flagged as duplicates (bloom false positives). */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+/* stats reports the results of running a dedup over the stream */
+
+static void
+stats( char const *  name,
+       uchar const * truth,
+       uchar const * dup,
+       ulong         tag_cnt,
+       long          dt,
+       ulong         footprint ) {
+  ulong uniq_cnt = 0UL; ulong miss_cnt  = 0UL;
+  ulong dup_cnt  = 0UL; ulong false_cnt = 0UL;
+  for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+    if( truth[ tag_idx ] ) { dup_cnt++;  miss_cnt  += (ulong)!dup[ tag_idx ]; }
+    else                   { uniq_cnt++; false_cnt += (ulong) dup[ tag_idx ]; }
+  }
+  FD_LOG_NOTICE(( "%-24s (%7.1f MiB): %8.3f Mtag/s, %7.3f ns/tag, missed dup %.3e, false dup %.3e",
+                  name, ((double)footprint)/((double)(1UL<<20)),
+                  1e3*((double)tag_cnt)/((double)dt), ((double)dt)/((double)tag_cnt),
+                  ((double)miss_cnt )/((double)fd_ulong_max( dup_cnt,  1UL )),
+                  ((double)false_cnt)/((double)fd_ulong_max( uniq_cnt, 1UL )) ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz     = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",      NULL, "gigantic"                   );
+  ulong        page_cnt     = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",     NULL, 4UL                          );
+  ulong        numa_idx     = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",     NULL, fd_shmem_numa_idx( cpu_idx ) );
+  ulong        blk_cnt_min  = fd_env_strip_cmdline_ulong( &argc, &argv, "--blk-cnt-min",  NULL, 1UL<<14                      );
+  ulong        blk_cnt_max  = fd_env_strip_cmdline_ulong( &argc, &argv, "--blk-cnt-max",  NULL, 1UL<<20                      );
+  ulong        gen_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--gen-cnt",      NULL, 4UL                          );
+  ulong        bits_per_tag = fd_env_strip_cmdline_ulong( &argc, &argv, "--bits-per-tag", NULL, 16UL                         );
+  ulong        tag_cnt      = fd_env_strip_cmdline_ulong( &argc, &argv, "--tag-cnt",      NULL, 1UL<<24                      );
+  float        dup_frac     = fd_env_strip_cmdline_float( &argc, &argv, "--dup-frac",     NULL, 0.1f                         );
+  ulong        lag_max      = fd_env_strip_cmdline_ulong( &argc, &argv, "--lag-max",      NULL, 1UL<<22                      );
+  ulong        pf_dist      = fd_env_strip_cmdline_ulong( &argc, &argv, "--pf-dist",      NULL, 16UL                         );
+
+  if( FD_UNLIKELY( !fd_bloom_footprint( blk_cnt_min, gen_cnt ) ||
+                   !fd_bloom_footprint( blk_cnt_max, gen_cnt ) ||
+                   blk_cnt_min>blk_cnt_max                        ) ) FD_LOG_ERR(( "bad --blk-cnt-min / --blk-cnt-max / --gen-cnt" ));
+  if( FD_UNLIKELY( !bits_per_tag                                  ) ) FD_LOG_ERR(( "--bits-per-tag should be positive" ));
+  if( FD_UNLIKELY( !tag_cnt                                       ) ) FD_LOG_ERR(( "--tag-cnt should be positive" ));
+  if( FD_UNLIKELY( !lag_max                                       ) ) FD_LOG_ERR(( "--lag-max should be positive" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp =
+    fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong * tag   = (ulong *)fd_wksp_alloc_laddr( wksp, 0UL, tag_cnt*sizeof(ulong), 1UL );
+  uchar * truth = (uchar *)fd_wksp_alloc_laddr( wksp, 0UL, tag_cnt,               1UL );
+  uchar * dup   = (uchar *)fd_wksp_alloc_laddr( wksp, 0UL, tag_cnt,               1UL );
+  if( FD_UNLIKELY( (!tag) | (!truth) | (!dup) ) ) FD_LOG_ERR(( "--tag-cnt too large for workspace" ));
+
+  /* Make the tag stream.  The i-th unique tag is fd_ulong_hash(i) (with
+     the least significant bit set to make it non-null) such that a
+     duplicate of a unique tag lag uniques back can be regenerated
+     without keeping a history of unique tags around. */
+
+  FD_LOG_NOTICE(( "Generating stream (--tag-cnt %lu --dup-frac %e --lag-max %lu)", tag_cnt, (double)dup_frac, lag_max ));
+
+  uint  dup_thresh = (uint)(0.5f + dup_frac*(float)(1UL<<32));
+  ulong uniq_cnt   = 0UL;
+  for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+    if( uniq_cnt && fd_rng_uint( rng )<dup_thresh ) {
+      ulong lag = 1UL + fd_rng_ulong_roll( rng, fd_ulong_min( lag_max, uniq_cnt ) );
+      tag  [ tag_idx ] = fd_ulong_hash( uniq_cnt - lag ) | 1UL; /* never null */
+      truth[ tag_idx ] = (uchar)1;
+    } else {
+      tag  [ tag_idx ] = fd_ulong_hash( uniq_cnt ) | 1UL;
+      truth[ tag_idx ] = (uchar)0;
+      uniq_cnt++;
+    }
+  }
+
+  FD_LOG_NOTICE(( "Benchmarking (--blk-cnt-min %lu --blk-cnt-max %lu --gen-cnt %lu --bits-per-tag %lu --pf-dist %lu)",
+                  blk_cnt_min, blk_cnt_max, gen_cnt, bits_per_tag, pf_dist ));
+
+  for( ulong blk_cnt=blk_cnt_min; blk_cnt<=blk_cnt_max; blk_cnt<<=2 ) {
+
+    ulong gen_max   = fd_ulong_max( blk_cnt*512UL / bits_per_tag, 1UL );
+    ulong footprint = fd_bloom_footprint( blk_cnt, gen_cnt );
+
+    FD_LOG_NOTICE(( "blk_cnt %lu, gen_cnt %lu, gen_max %lu (window %lu-%lu unique tags)",
+                    blk_cnt, gen_cnt, gen_max, (gen_cnt-2UL)*gen_max, gen_cnt*gen_max ));
+
+    /* Bloom */
+
+    void * mem = fd_wksp_alloc_laddr( wksp, fd_bloom_align(), footprint, 1UL );
+    if( FD_UNLIKELY( !mem ) ) { FD_LOG_WARNING(( "blk_cnt %lu: bloom too large for workspace; skipping", blk_cnt )); break; }
+
+    for( int pf=0; pf<2; pf++ ) {
+      fd_bloom_t * bloom = fd_bloom_join( fd_bloom_new( mem, blk_cnt, gen_cnt, gen_max ) ); FD_TEST( bloom );
+
+      long dt = -fd_log_wallclock();
+      if( !pf ) {
+        for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) dup[ tag_idx ] = (uchar)fd_bloom_insert( bloom, tag[ tag_idx ] );
+      } else {
+        for( ulong tag_idx=0UL; tag_idx<fd_ulong_min( pf_dist, tag_cnt ); tag_idx++ ) fd_bloom_prefetch( bloom, tag[ tag_idx ] );
+        for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+          if( FD_LIKELY( tag_idx+pf_dist<tag_cnt ) ) fd_bloom_prefetch( bloom, tag[ tag_idx+pf_dist ] );
+          dup[ tag_idx ] = (uchar)fd_bloom_insert( bloom, tag[ tag_idx ] );
+        }
+      }
+      dt += fd_log_wallclock();
+
+      stats( pf ? "bloom (prefetch)" : "bloom", truth, dup, tag_cnt, dt, footprint );
+      FD_TEST( fd_bloom_delete( fd_bloom_leave( bloom ) )==mem );
+    }
+
+    fd_wksp_free_laddr( mem );
+
+    /* Deepest tcache with the same footprint */
+
+    ulong depth_lo = 1UL;              /* fits */
+    ulong depth_hi = footprint/8UL;    /* does not fit */
+    while( depth_hi-depth_lo>1UL ) {
+      ulong depth_mid = depth_lo + ((depth_hi-depth_lo)>>1);
+      ulong fp        = fd_tcache_footprint( depth_mid, 0UL );
+      if( fp && fp<=footprint ) depth_lo = depth_mid;
+      else                      depth_hi = depth_mid;
+    }
+    ulong depth        = depth_lo;
+    ulong tc_footprint = fd_tcache_footprint( depth, 0UL );
+
+    mem = fd_wksp_alloc_laddr( wksp, fd_tcache_align(), tc_footprint, 1UL );
+    if( FD_UNLIKELY( !mem ) ) { FD_LOG_WARNING(( "depth %lu: tcache too large for workspace; skipping", depth )); break; }
+
+    fd_tcache_t * tcache  = fd_tcache_join( fd_tcache_new( mem, depth, 0UL ) ); FD_TEST( tcache );
+    ulong         map_cnt = fd_tcache_map_cnt     ( tcache );
+    ulong *       ring    = fd_tcache_ring_laddr  ( tcache );
+    ulong *       map     = fd_tcache_map_laddr   ( tcache );
+    ulong         oldest  = fd_tcache_oldest_laddr( tcache )[0];
+
+    long dt = -fd_log_wallclock();
+    for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+      int is_dup;
+      FD_TCACHE_INSERT( is_dup, oldest, ring, depth, map, map_cnt, tag[ tag_idx ] );
+      dup[ tag_idx ] = (uchar)is_dup;
+    }
+    dt += fd_log_wallclock();
+
+    char name[ 64 ];
+    stats( fd_cstr_printf( name, 64UL, NULL, "tcache (depth %lu)", depth ), truth, dup, tag_cnt, dt, tc_footprint );
+
+    FD_TEST( fd_tcache_delete( fd_tcache_leave( tcache ) )==mem );
+    fd_wksp_free_laddr( mem );
+  }
+
+  fd_wksp_free_laddr( dup   );
+  fd_wksp_free_laddr( truth );
+  fd_wksp_free_laddr( tag   );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
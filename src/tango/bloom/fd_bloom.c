@@ -0,0 +1,129 @@
+#include "fd_bloom.h"
+
+ulong
+fd_bloom_align( void ) {
+  return FD_BLOOM_ALIGN;
+}
+
+ulong
+fd_bloom_footprint( ulong blk_cnt,
+                    ulong gen_cnt ) {
+  if( FD_UNLIKELY( (!fd_ulong_is_pow2( blk_cnt )) | (blk_cnt>FD_BLOOM_BLK_CNT_MAX) ) ) return 0UL; /* Invalid blk_cnt */
+  if( FD_UNLIKELY( (gen_cnt<2UL) | (gen_cnt>FD_BLOOM_GEN_CNT_MAX) ) ) return 0UL; /* Invalid gen_cnt */
+
+  ulong cnt = blk_cnt*gen_cnt; /* no overflow (<=2^38) */
+  if( FD_UNLIKELY( cnt>((ULONG_MAX-FD_BLOOM_ALIGN)/FD_BLOOM_BLK_SZ) ) ) return 0UL; /* overflow */
+  return FD_BLOOM_FOOTPRINT( blk_cnt, gen_cnt );
+}
+
+void *
+fd_bloom_new( void * shmem,
+              ulong  blk_cnt,
+              ulong  gen_cnt,
+              ulong  gen_max ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_bloom_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_bloom_footprint( blk_cnt, gen_cnt );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad blk_cnt (%lu) and/or gen_cnt (%lu)", blk_cnt, gen_cnt ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (!gen_max) | (gen_max>=(1UL<<32)) ) ) {
+    FD_LOG_WARNING(( "bad gen_max (%lu)", gen_max ));
+    return NULL;
+  }
+
+  fd_memset( shmem, 0, footprint );
+
+  fd_bloom_t * bloom = (fd_bloom_t *)shmem;
+
+  bloom->blk_cnt = blk_cnt;
+  bloom->gen_cnt = gen_cnt;
+  bloom->gen_max = gen_max;
+  bloom->gen     = 0UL;
+  bloom->ins_cnt = 0UL;
+  bloom->clr_cnt = blk_cnt; /* Everything is already clear */
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( bloom->magic ) = FD_BLOOM_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_bloom_t *
+fd_bloom_join( void * _bloom ) {
+
+  if( FD_UNLIKELY( !_bloom ) ) {
+    FD_LOG_WARNING(( "NULL _bloom" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)_bloom, fd_bloom_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned _bloom" ));
+    return NULL;
+  }
+
+  fd_bloom_t * bloom = (fd_bloom_t *)_bloom;
+  if( FD_UNLIKELY( bloom->magic!=FD_BLOOM_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return bloom;
+}
+
+void *
+fd_bloom_leave( fd_bloom_t * bloom ) {
+
+  if( FD_UNLIKELY( !bloom ) ) {
+    FD_LOG_WARNING(( "NULL bloom" ));
+    return NULL;
+  }
+
+  return (void *)bloom;
+}
+
+void *
+fd_bloom_delete( void * _bloom ) {
+
+  if( FD_UNLIKELY( !_bloom ) ) {
+    FD_LOG_WARNING(( "NULL _bloom" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)_bloom, fd_bloom_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned _bloom" ));
+    return NULL;
+  }
+
+  fd_bloom_t * bloom = (fd_bloom_t *)_bloom;
+  if( FD_UNLIKELY( bloom->magic != FD_BLOOM_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( bloom->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return _bloom;
+}
+
+void
+fd_bloom_reset( fd_bloom_t * bloom ) {
+  fd_memset( fd_bloom_blk_laddr( bloom ), 0, bloom->blk_cnt*bloom->gen_cnt*FD_BLOOM_BLK_SZ );
+  bloom->gen     = 0UL;
+  bloom->ins_cnt = 0UL;
+  bloom->clr_cnt = bloom->blk_cnt;
+}
@@ -0,0 +1,388 @@
+#ifndef HEADER_fd_src_tango_bloom_fd_bloom_h
+#define HEADER_fd_src_tango_bloom_fd_bloom_h
+
+/* A fd_bloom_t is a memory compact probabilistic history of recently
+   observed unique 64-bit tags.  Like a tcache, it is useful for
+   deduplication of traffic based on a thumbprint / hash / signature.
+   Unlike a tcache, it never forgets a tag early (no false negatives
+   within its window) but it will occasionally claim to have seen a tag
+   it has not (false positives).  In exchange, it needs ~1-2 bytes per
+   tag of history instead of the ~20-40 bytes per tag of a default
+   sparsity tcache.  This makes histories on the order of hundreds of
+   millions of tags (e.g. all the signatures seen over a blockhash
+   validity window) practical to keep in memory.
+
+   The bloom is blocked: each tag maps to a single 64 byte (i.e. cache
+   line sized and aligned) block and sets FD_BLOOM_BLK_WORD_CNT bits
+   in it, one bit in each 64-bit word of the block (a "split block"
+   bloom filter).  Thus querying or inserting a tag touches a single
+   cache line per generation (below) and computing and testing the bits
+   is a handful of SIMD operations on AVX capable targets.  Blocking
+   costs a little in false positive rate relative to a classical bloom
+   filter with the same number of bits.
+
+   History is aged out by generations.  The bloom has gen_cnt
+   generations of blk_cnt blocks.  Unique tags are inserted into the
+   current generation.  After gen_max unique tags are inserted into the
+   current generation, the next generation (the one holding the oldest
+   history) becomes the current generation.  To avoid a latency spike
+   clearing a potentially large generation all at once, the generation
+   that will become current next is cleared incrementally as tags are
+   inserted into the current generation.  As such, a unique tag is
+   remembered for at least the next (gen_cnt-2)*gen_max unique tags and
+   forgotten after at most the next gen_cnt*gen_max unique tags.
+   Queries check all generations, so the false positive rate is roughly
+   gen_cnt times that of a single generation.
+
+   The generations of a block are stored contiguously such that all the
+   cache lines touched by a query are adjacent (friendly to adjacent
+   line prefetchers and TLBs).  As with tcache, it is strongly
+   recommended that the bloom be backed by a single NUMA page (e.g. in a
+   gigantic page backed workspace) if used in performance critical
+   contexts.
+
+   Tags are hashed before use so they do not need to be IID random
+   (and the bloom can be used alongside other structures that consume
+   tag bits, e.g. sharding by fd_dedup_shard_idx).
+
+   Note that a bloom cannot be used to reduce the memory footprint of
+   an exact tcache covering the same window: a tcache consulted only
+   on possible duplicates still needs every unique tag inserted into
+   it.  Instead, a bloom is a memory compact alternative when an exact
+   history over the desired window is impractical and dropping a small
+   fraction (the false positive rate) of unique tags is acceptable.
+   bench_bloom quantifies this trade off against a tcache with the
+   same memory footprint. */
+
+#include "../fd_tango_base.h"
+
+#if FD_HAS_AVX
+#include "../../util/simd/fd_avx.h"
+#endif
+
+/* FD_BLOOM_BLK_{WORD_CNT,SZ} give the number of 64-bit words in a bloom
+   block and the block size in bytes. */
+
+#define FD_BLOOM_BLK_WORD_CNT (8UL)
+#define FD_BLOOM_BLK_SZ       (64UL)
+
+/* FD_BLOOM_{BLK_CNT_MAX,GEN_CNT_MAX} give the maximum number of blocks
+   per generation and the maximum number of generations. */
+
+#define FD_BLOOM_BLK_CNT_MAX (1UL<<32)
+#define FD_BLOOM_GEN_CNT_MAX (64UL)
+
+/* FD_BLOOM_{ALIGN,FOOTPRINT} specify the alignment and footprint needed
+   for a bloom with blk_cnt blocks per generation and gen_cnt
+   generations.  ALIGN is at least double cache line to mitigate
+   various kinds of false sharing.  blk_cnt and gen_cnt are assumed to
+   be valid (i.e. blk_cnt is an integer power of 2 in
+   [1,FD_BLOOM_BLK_CNT_MAX] and gen_cnt is in [2,FD_BLOOM_GEN_CNT_MAX]).
+   These are provided to facilitate compile time declarations. */
+
+#define FD_BLOOM_ALIGN (128UL)
+#define FD_BLOOM_FOOTPRINT( blk_cnt, gen_cnt ) \
+  (FD_BLOOM_ALIGN + (blk_cnt)*(gen_cnt)*FD_BLOOM_BLK_SZ)
+
+/* fd_bloom_t is an opaque handle of a bloom object.  Details are
+   exposed here to facilitate usage of bloom in performance critical
+   contexts. */
+
+#define FD_BLOOM_MAGIC (0xf17eda2c37b10070UL) /* firedancer bloom ver 0 */
+
+struct __attribute((aligned(FD_BLOOM_ALIGN))) fd_bloom_private {
+  ulong magic;   /* ==FD_BLOOM_MAGIC */
+  ulong blk_cnt; /* Number of blocks per generation, power of 2 */
+  ulong gen_cnt; /* Number of generations, in [2,FD_BLOOM_GEN_CNT_MAX] */
+  ulong gen_max; /* Number of unique tags inserted into a generation before advancing to the next one */
+  ulong gen;     /* Current generation, in [0,gen_cnt) */
+  ulong ins_cnt; /* Number of unique tags inserted into the current generation, in [0,gen_max) */
+  ulong clr_cnt; /* Number of blocks of the next generation already cleared, in [0,blk_cnt] */
+
+  /* Padding to FD_BLOOM_ALIGN */
+
+  /* blk_cnt*gen_cnt blocks of FD_BLOOM_BLK_WORD_CNT ulong (blk):
+
+     Block blk_idx of generation gen is at blk + (blk_idx*gen_cnt+gen)*
+     FD_BLOOM_BLK_WORD_CNT.  That is, the gen_cnt generations of a
+     block are contiguous. */
+};
+
+typedef struct fd_bloom_private fd_bloom_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_bloom_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a bloom.
+   fd_bloom_align returns FD_BLOOM_ALIGN.  If blk_cnt is not an integer
+   power of 2 in [1,FD_BLOOM_BLK_CNT_MAX], gen_cnt is not in
+   [2,FD_BLOOM_GEN_CNT_MAX] and/or the required footprint would be
+   larger than ULONG_MAX, footprint will silently return 0 (and thus can
+   be used by the caller to validate the bloom configuration
+   parameters).  Otherwise, it returns FD_BLOOM_FOOTPRINT. */
+
+FD_FN_CONST ulong
+fd_bloom_align( void );
+
+FD_FN_CONST ulong
+fd_bloom_footprint( ulong blk_cnt,
+                    ulong gen_cnt );
+
+/* fd_bloom_new formats an unused memory region for use as a bloom.
+   shmem is a non-NULL pointer to this region in the local address space
+   with the required footprint and alignment.  blk_cnt and gen_cnt are
+   as described above.  gen_max is the number of unique tags to insert
+   into a generation before advancing to the next and should be in
+   [1,2^32).  A reasonable choice is to target 10-20 bits per tag per
+   generation (i.e. gen_max ~ blk_cnt*512/[10-20]), giving a false
+   positive rate per generation of ~1% to ~0.05% when a generation is
+   full.
+
+   Returns shmem (and the memory region it points to will be formatted
+   as a bloom, caller is not joined, bloom will be empty) on success and
+   NULL on failure (logs details).  Reasons for failure include
+   obviously bad shmem, bad blk_cnt, bad gen_cnt or bad gen_max. */
+
+void *
+fd_bloom_new( void * shmem,
+              ulong  blk_cnt,
+              ulong  gen_cnt,
+              ulong  gen_max );
+
+/* fd_bloom_join joins the caller to the bloom.  _bloom points to the
+   first byte of the memory region backing the bloom in the caller's
+   address space.  Returns a pointer in the local address space to the
+   bloom on success and NULL on failure (logs details).  Every
+   successful join should have a matching leave. */
+
+fd_bloom_t *
+fd_bloom_join( void * _bloom );
+
+/* fd_bloom_leave leaves a current local join.  Returns a pointer to the
+   underlying shared memory region on success and NULL on failure (logs
+   details).  Reasons for failure include bloom is NULL. */
+
+void *
+fd_bloom_leave( fd_bloom_t * bloom );
+
+/* fd_bloom_delete unformats a memory region used as a bloom.  Assumes
+   nobody is joined to the region.  Returns a pointer to the underlying
+   shared memory region or NULL if used obviously in error (e.g. _bloom
+   obviously does not point to a bloom ... logs details).  The ownership
+   of the memory region is transferred to the caller on success. */
+
+void *
+fd_bloom_delete( void * _bloom );
+
+/* fd_bloom_{blk_cnt,gen_cnt,gen_max} return the values used to
+   construct the bloom.  fd_bloom_gen returns the current generation.
+   fd_bloom_blk_laddr returns the location of the bloom's blocks in the
+   caller's address space.  Assumes bloom is a current local join. */
+
+FD_FN_PURE static inline ulong fd_bloom_blk_cnt( fd_bloom_t const * bloom ) { return bloom->blk_cnt; }
+FD_FN_PURE static inline ulong fd_bloom_gen_cnt( fd_bloom_t const * bloom ) { return bloom->gen_cnt; }
+FD_FN_PURE static inline ulong fd_bloom_gen_max( fd_bloom_t const * bloom ) { return bloom->gen_max; }
+FD_FN_PURE static inline ulong fd_bloom_gen    ( fd_bloom_t const * bloom ) { return bloom->gen;     }
+
+FD_FN_CONST static inline ulong *
+fd_bloom_blk_laddr( fd_bloom_t * bloom ) {
+  return (ulong *)((ulong)bloom + FD_BLOOM_ALIGN);
+}
+
+FD_FN_CONST static inline ulong const *
+fd_bloom_blk_laddr_const( fd_bloom_t const * bloom ) {
+  return (ulong const *)((ulong)bloom + FD_BLOOM_ALIGN);
+}
+
+/* fd_bloom_reset forgets all tags in the bloom.  Assumes bloom is a
+   current local join.  This is O(footprint) and not intended to be used
+   in performance critical contexts. */
+
+void
+fd_bloom_reset( fd_bloom_t * bloom );
+
+/* fd_bloom_private_hash returns the hash of tag used to pick the block
+   (the upper 32 bits) and the bits in the block (the lower 32 bits) for
+   tag. */
+
+FD_FN_CONST static inline ulong
+fd_bloom_private_hash( ulong tag ) {
+  return fd_ulong_hash( tag );
+}
+
+/* fd_bloom_private_blk returns the location of the block for a tag with
+   hash h in the generation 0 of bloom.  The blocks of the other
+   generations immediately follow. */
+
+FD_FN_PURE static inline ulong *
+fd_bloom_private_blk( fd_bloom_t const * bloom,
+                      ulong              h ) {
+  ulong blk_idx = (h>>32) & (bloom->blk_cnt-1UL);
+  return (ulong *)fd_bloom_blk_laddr_const( bloom ) + blk_idx*bloom->gen_cnt*FD_BLOOM_BLK_WORD_CNT;
+}
+
+/* FD_BLOOM_PRIVATE_SALT_{0,...,7} are odd constants used to derive the
+   bit set in each word of a block from the lower 32 bits of a tag's
+   hash (the top 6 bits of the 32-bit product of those bits with the
+   salt). */
+
+#define FD_BLOOM_PRIVATE_SALT_0 (0x47b6137bU)
+#define FD_BLOOM_PRIVATE_SALT_1 (0x44974d91U)
+#define FD_BLOOM_PRIVATE_SALT_2 (0x8824ad5bU)
+#define FD_BLOOM_PRIVATE_SALT_3 (0xa2b7289dU)
+#define FD_BLOOM_PRIVATE_SALT_4 (0x705495c7U)
+#define FD_BLOOM_PRIVATE_SALT_5 (0x2df1424bU)
+#define FD_BLOOM_PRIVATE_SALT_6 (0x9efc4947U)
+#define FD_BLOOM_PRIVATE_SALT_7 (0x5c6bfb31U)
+
+/* fd_bloom_private_mask_ref computes the FD_BLOOM_BLK_WORD_CNT word
+   mask for a tag with hash h in a portable way.  This is the reference
+   for the (possibly SIMD accelerated) query and insert below. */
+
+static inline void
+fd_bloom_private_mask_ref( ulong   h,
+                           ulong * mask ) {
+  static uint const salt[ FD_BLOOM_BLK_WORD_CNT ] = {
+    FD_BLOOM_PRIVATE_SALT_0, FD_BLOOM_PRIVATE_SALT_1, FD_BLOOM_PRIVATE_SALT_2, FD_BLOOM_PRIVATE_SALT_3,
+    FD_BLOOM_PRIVATE_SALT_4, FD_BLOOM_PRIVATE_SALT_5, FD_BLOOM_PRIVATE_SALT_6, FD_BLOOM_PRIVATE_SALT_7
+  };
+  uint key = (uint)h;
+  for( ulong word_idx=0UL; word_idx<FD_BLOOM_BLK_WORD_CNT; word_idx++ ) mask[ word_idx ] = 1UL << ((key*salt[ word_idx ]) >> 26);
+}
+
+/* fd_bloom_private_clear_step clears the blocks of the generation after
+   the current generation that should be clear given the number of
+   unique tags inserted into the current generation (such that the
+   next generation is fully clear by the time the current generation
+   is full). */
+
+static inline void
+fd_bloom_private_clear_step( fd_bloom_t * bloom ) {
+  ulong blk_cnt = bloom->blk_cnt;
+  ulong gen_cnt = bloom->gen_cnt;
+  ulong gen_max = bloom->gen_max;
+  ulong clr_cnt = bloom->clr_cnt;
+
+  /* ins_cnt<=gen_max<2^32 and blk_cnt<=2^32 so this does not overflow */
+  ulong clr_tgt = (bloom->ins_cnt*blk_cnt + gen_max - 1UL) / gen_max;
+  if( FD_LIKELY( clr_cnt>=clr_tgt ) ) return;
+
+  ulong   nxt = bloom->gen + 1UL; nxt = fd_ulong_if( nxt<gen_cnt, nxt, 0UL );
+  ulong * blk = fd_bloom_blk_laddr( bloom ) + nxt*FD_BLOOM_BLK_WORD_CNT;
+  for( ; clr_cnt<clr_tgt; clr_cnt++ ) fd_memset( blk + clr_cnt*gen_cnt*FD_BLOOM_BLK_WORD_CNT, 0, FD_BLOOM_BLK_SZ );
+  bloom->clr_cnt = clr_cnt;
+}
+
+#if FD_HAS_AVX
+
+/* FD_BLOOM_PRIVATE_MASK computes the block mask for a tag with hash h
+   as a pair of 4 ulong vectors (words 0-3 and words 4-7). */
+
+#define FD_BLOOM_PRIVATE_MASK( m0, m1, h ) do {                                                          \
+    wu_t _fbpm_k = wu_mul( wu_bcast( (uint)(h) ), wu( FD_BLOOM_PRIVATE_SALT_0, FD_BLOOM_PRIVATE_SALT_1,  \
+                                                      FD_BLOOM_PRIVATE_SALT_2, FD_BLOOM_PRIVATE_SALT_3,  \
+                                                      FD_BLOOM_PRIVATE_SALT_4, FD_BLOOM_PRIVATE_SALT_5,  \
+                                                      FD_BLOOM_PRIVATE_SALT_6, FD_BLOOM_PRIVATE_SALT_7 ) ); \
+    _fbpm_k = wu_shr( _fbpm_k, 26 );                                                                    \
+    (m0) = wv_shl_vector( wv_one(), wu_to_wv( _fbpm_k, 0 ) );                                           \
+    (m1) = wv_shl_vector( wv_one(), wu_to_wv( _fbpm_k, 1 ) );                                           \
+  } while(0)
+
+#endif
+
+/* fd_bloom_query returns 1 if tag might be in the bloom and 0 if tag is
+   definitely not in the bloom.  Assumes bloom is a current local join.
+   Does not modify the bloom. */
+
+FD_FN_PURE static inline int
+fd_bloom_query( fd_bloom_t const * bloom,
+                ulong              tag ) {
+  ulong         h       = fd_bloom_private_hash( tag );
+  ulong const * blk     = fd_bloom_private_blk( bloom, h );
+  ulong         gen_cnt = bloom->gen_cnt;
+
+# if FD_HAS_AVX
+  wv_t m0; wv_t m1; FD_BLOOM_PRIVATE_MASK( m0, m1, h );
+  for( ulong gen=0UL; gen<gen_cnt; gen++ ) {
+    ulong const * b = blk + gen*FD_BLOOM_BLK_WORD_CNT;
+    wv_t miss = wv_or( wv_andnot( wv_ld( b ), m0 ), wv_andnot( wv_ld( b+4 ), m1 ) );
+    if( wc_all( wv_eq( miss, wv_zero() ) ) ) return 1;
+  }
+# else
+  ulong mask[ FD_BLOOM_BLK_WORD_CNT ]; fd_bloom_private_mask_ref( h, mask );
+  for( ulong gen=0UL; gen<gen_cnt; gen++ ) {
+    ulong const * b = blk + gen*FD_BLOOM_BLK_WORD_CNT;
+    ulong miss = 0UL;
+    for( ulong word_idx=0UL; word_idx<FD_BLOOM_BLK_WORD_CNT; word_idx++ ) miss |= mask[ word_idx ] & ~b[ word_idx ];
+    if( !miss ) return 1;
+  }
+# endif
+  return 0;
+}
+
+/* fd_bloom_insert inserts tag into bloom if it is definitely not in the
+   bloom.  Returns 1 if tag might already have been in the bloom (i.e.
+   tag is probably a duplicate and the bloom was not modified) and 0 if
+   tag was definitely not in the bloom (i.e. tag is unique and it was
+   inserted into the current generation).  Assumes bloom is a current
+   local join.  Analogous to FD_TCACHE_INSERT. */
+
+static inline int
+fd_bloom_insert( fd_bloom_t * bloom,
+                 ulong        tag ) {
+  ulong   h       = fd_bloom_private_hash( tag );
+  ulong * blk     = fd_bloom_private_blk( bloom, h );
+  ulong   gen_cnt = bloom->gen_cnt;
+  ulong * b       = blk + bloom->gen*FD_BLOOM_BLK_WORD_CNT;
+
+# if FD_HAS_AVX
+  wv_t m0; wv_t m1; FD_BLOOM_PRIVATE_MASK( m0, m1, h );
+  for( ulong gen=0UL; gen<gen_cnt; gen++ ) {
+    ulong const * c = blk + gen*FD_BLOOM_BLK_WORD_CNT;
+    wv_t miss = wv_or( wv_andnot( wv_ld( c ), m0 ), wv_andnot( wv_ld( c+4 ), m1 ) );
+    if( wc_all( wv_eq( miss, wv_zero() ) ) ) return 1;
+  }
+  wv_st( b,   wv_or( wv_ld( b   ), m0 ) );
+  wv_st( b+4, wv_or( wv_ld( b+4 ), m1 ) );
+# else
+  ulong mask[ FD_BLOOM_BLK_WORD_CNT ]; fd_bloom_private_mask_ref( h, mask );
+  for( ulong gen=0UL; gen<gen_cnt; gen++ ) {
+    ulong const * c = blk + gen*FD_BLOOM_BLK_WORD_CNT;
+    ulong miss = 0UL;
+    for( ulong word_idx=0UL; word_idx<FD_BLOOM_BLK_WORD_CNT; word_idx++ ) miss |= mask[ word_idx ] & ~c[ word_idx ];
+    if( !miss ) return 1;
+  }
+  for( ulong word_idx=0UL; word_idx<FD_BLOOM_BLK_WORD_CNT; word_idx++ ) b[ word_idx ] |= mask[ word_idx ];
+# endif
+
+  /* Age out history */
+
+  ulong ins_cnt = bloom->ins_cnt + 1UL;
+  bloom->ins_cnt = ins_cnt;
+  fd_bloom_private_clear_step( bloom );
+  if( FD_UNLIKELY( ins_cnt>=bloom->gen_max ) ) {
+    ulong gen = bloom->gen + 1UL;
+    bloom->gen     = fd_ulong_if( gen<gen_cnt, gen, 0UL );
+    bloom->ins_cnt = 0UL;
+    bloom->clr_cnt = 0UL;
+  }
+
+  return 0;
+}
+
+/* fd_bloom_prefetch issues prefetches for the cache lines a query or
+   insert of tag will touch.  This is useful for overlapping the memory
+   latency of operations on a batch of tags (e.g. prefetch tag i+d while
+   operating on tag i).  Assumes bloom is a current local join. */
+
+static inline void
+fd_bloom_prefetch( fd_bloom_t const * bloom,
+                   ulong              tag ) {
+  ulong const * blk     = fd_bloom_private_blk( bloom, fd_bloom_private_hash( tag ) );
+  ulong         gen_cnt = bloom->gen_cnt;
+  for( ulong gen=0UL; gen<gen_cnt; gen++ ) __builtin_prefetch( blk + gen*FD_BLOOM_BLK_WORD_CNT, 1, 3 );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_tango_bloom_fd_bloom_h */
@@ -0,0 +1,151 @@
+#include "../fd_tango.h"
+
+FD_STATIC_ASSERT( FD_BLOOM_ALIGN==128UL,                                   unit_test );
+FD_STATIC_ASSERT( FD_BLOOM_BLK_SZ==FD_BLOOM_BLK_WORD_CNT*sizeof(ulong),    unit_test );
+FD_STATIC_ASSERT( FD_BLOOM_FOOTPRINT( 1UL, 2UL )==FD_BLOOM_ALIGN+128UL,    unit_test );
+FD_STATIC_ASSERT( sizeof(fd_bloom_t)==FD_BLOOM_ALIGN,                      unit_test );
+
+#define BLK_CNT (4096UL)
+#define GEN_CNT (4UL)
+#define GEN_MAX (BLK_CNT*512UL/16UL) /* 16 bits per tag per generation */
+
+static uchar __attribute__((aligned(FD_BLOOM_ALIGN))) shmem[ FD_BLOOM_FOOTPRINT( BLK_CNT, GEN_CNT ) ];
+
+#define WIN_MAX ((GEN_CNT-2UL)*GEN_MAX) /* Guaranteed history */
+
+static ulong win[ WIN_MAX ];
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Test footprint validation */
+
+  FD_TEST( fd_bloom_align()==FD_BLOOM_ALIGN );
+  FD_TEST( !fd_bloom_footprint( 0UL,                       GEN_CNT                  ) );
+  FD_TEST( !fd_bloom_footprint( 3UL,                       GEN_CNT                  ) );
+  FD_TEST( !fd_bloom_footprint( FD_BLOOM_BLK_CNT_MAX<<1,   GEN_CNT                  ) );
+  FD_TEST( !fd_bloom_footprint( BLK_CNT,                   1UL                      ) );
+  FD_TEST( !fd_bloom_footprint( BLK_CNT,                   FD_BLOOM_GEN_CNT_MAX+1UL ) );
+  FD_TEST( fd_bloom_footprint( BLK_CNT, GEN_CNT )==FD_BLOOM_FOOTPRINT( BLK_CNT, GEN_CNT ) );
+  FD_TEST( fd_bloom_footprint( FD_BLOOM_BLK_CNT_MAX, FD_BLOOM_GEN_CNT_MAX )==FD_BLOOM_FOOTPRINT( FD_BLOOM_BLK_CNT_MAX, FD_BLOOM_GEN_CNT_MAX ) );
+
+  /* Test construction */
+
+  FD_TEST( !fd_bloom_new( NULL,        BLK_CNT, GEN_CNT, GEN_MAX ) ); /* NULL shmem */
+  FD_TEST( !fd_bloom_new( shmem+1,     BLK_CNT, GEN_CNT, GEN_MAX ) ); /* misaligned shmem */
+  FD_TEST( !fd_bloom_new( shmem,       3UL,     GEN_CNT, GEN_MAX ) ); /* bad blk_cnt */
+  FD_TEST( !fd_bloom_new( shmem,       BLK_CNT, 1UL,     GEN_MAX ) ); /* bad gen_cnt */
+  FD_TEST( !fd_bloom_new( shmem,       BLK_CNT, GEN_CNT, 0UL     ) ); /* bad gen_max */
+  FD_TEST( !fd_bloom_new( shmem,       BLK_CNT, GEN_CNT, 1UL<<32 ) ); /* bad gen_max */
+
+  void * _bloom = fd_bloom_new( shmem, BLK_CNT, GEN_CNT, GEN_MAX ); FD_TEST( _bloom==(void *)shmem );
+
+  FD_TEST( !fd_bloom_join( NULL      ) ); /* NULL _bloom */
+  FD_TEST( !fd_bloom_join( shmem+1   ) ); /* misaligned _bloom */
+
+  fd_bloom_t * bloom = fd_bloom_join( _bloom ); FD_TEST( bloom );
+
+  FD_TEST( fd_bloom_blk_cnt( bloom )==BLK_CNT );
+  FD_TEST( fd_bloom_gen_cnt( bloom )==GEN_CNT );
+  FD_TEST( fd_bloom_gen_max( bloom )==GEN_MAX );
+  FD_TEST( fd_bloom_gen    ( bloom )==0UL     );
+  FD_TEST( (ulong)fd_bloom_blk_laddr( bloom )==(ulong)shmem + FD_BLOOM_ALIGN );
+
+  /* Test insert against the reference mask and that there are no false
+     negatives within the guaranteed history (over several generation
+     advances) */
+
+  FD_LOG_NOTICE(( "Testing insert (blk_cnt %lu, gen_cnt %lu, gen_max %lu)", BLK_CNT, GEN_CNT, GEN_MAX ));
+
+  ulong win_cnt = 0UL;
+  ulong win_nxt = 0UL;
+  ulong fp_cnt  = 0UL;
+  ulong ins_cnt = 0UL;
+  ulong gen_adv = 0UL;
+  for( ulong iter=0UL; iter<4UL*GEN_CNT*GEN_MAX; iter++ ) {
+
+    ulong tag = fd_rng_ulong( rng );
+    ulong gen = fd_bloom_gen( bloom );
+
+    int q   = fd_bloom_query ( bloom, tag );
+    int dup = fd_bloom_insert( bloom, tag );
+    FD_TEST( dup==q );
+    FD_TEST( fd_bloom_query( bloom, tag ) );
+    if( dup ) { fp_cnt++; continue; } /* (Random tags so all dups are false positives) */
+    ins_cnt++;
+
+    /* Check the inserted bits */
+
+    ulong h = fd_bloom_private_hash( tag );
+    ulong mask[ FD_BLOOM_BLK_WORD_CNT ]; fd_bloom_private_mask_ref( h, mask );
+    ulong const * b = fd_bloom_private_blk( bloom, h ) + gen*FD_BLOOM_BLK_WORD_CNT;
+    for( ulong word_idx=0UL; word_idx<FD_BLOOM_BLK_WORD_CNT; word_idx++ ) {
+      FD_TEST( fd_ulong_popcnt( mask[ word_idx ] )==1 );
+      FD_TEST( (b[ word_idx ] & mask[ word_idx ])==mask[ word_idx ] );
+    }
+
+    gen_adv += (ulong)(fd_bloom_gen( bloom )!=gen);
+
+    win[ win_nxt ] = tag;
+    win_nxt = fd_ulong_if( win_nxt+1UL<WIN_MAX, win_nxt+1UL, 0UL );
+    win_cnt = fd_ulong_min( win_cnt+1UL, WIN_MAX );
+
+    if( !(iter & 65535UL) ) for( ulong win_idx=0UL; win_idx<win_cnt; win_idx++ ) FD_TEST( fd_bloom_query( bloom, win[ win_idx ] ) );
+  }
+  for( ulong win_idx=0UL; win_idx<win_cnt; win_idx++ ) FD_TEST( fd_bloom_query( bloom, win[ win_idx ] ) );
+
+  FD_TEST( gen_adv==ins_cnt/GEN_MAX );
+  FD_TEST( fd_bloom_gen( bloom )==(gen_adv % GEN_CNT) );
+
+  double fp_insert = (double)fp_cnt / (double)(4UL*GEN_CNT*GEN_MAX);
+  FD_LOG_NOTICE(( "insert false positive rate %.3e (gen_adv %lu)", fp_insert, gen_adv ));
+  FD_TEST( fp_insert<0.01 );
+
+  /* Test steady state false positive rate */
+
+  fp_cnt = 0UL;
+  ulong const query_cnt = 1UL<<20;
+  for( ulong iter=0UL; iter<query_cnt; iter++ ) fp_cnt += (ulong)fd_bloom_query( bloom, fd_rng_ulong( rng ) );
+  double fp_query = (double)fp_cnt / (double)query_cnt;
+  FD_LOG_NOTICE(( "query false positive rate %.3e", fp_query ));
+  FD_TEST( fp_query<0.01 );
+
+  /* Test that history ages out.  After gen_cnt*gen_max more unique
+     inserts, the old window should only be found at roughly the false
+     positive rate. */
+
+  for( ulong rem=GEN_CNT*GEN_MAX; rem; ) rem -= (ulong)!fd_bloom_insert( bloom, fd_rng_ulong( rng ) );
+  fp_cnt = 0UL;
+  for( ulong win_idx=0UL; win_idx<win_cnt; win_idx++ ) fp_cnt += (ulong)fd_bloom_query( bloom, win[ win_idx ] );
+  double fp_aged = (double)fp_cnt / (double)win_cnt;
+  FD_LOG_NOTICE(( "aged out false positive rate %.3e", fp_aged ));
+  FD_TEST( fp_aged<0.01 );
+
+  /* Test reset */
+
+  fd_bloom_reset( bloom );
+  FD_TEST( fd_bloom_gen( bloom )==0UL );
+  for( ulong win_idx=0UL; win_idx<win_cnt; win_idx++ ) FD_TEST( !fd_bloom_query( bloom, win[ win_idx ] ) );
+  for( ulong win_idx=0UL; win_idx<win_cnt; win_idx++ ) fd_bloom_prefetch( bloom, win[ win_idx ] ); /* Just test it compiles / runs */
+
+  /* Test destruction */
+
+  FD_TEST( !fd_bloom_leave( NULL ) ); /* NULL bloom */
+  FD_TEST( fd_bloom_leave( bloom )==_bloom );
+
+  FD_TEST( !fd_bloom_delete( NULL    ) ); /* NULL _bloom */
+  FD_TEST( !fd_bloom_delete( shmem+1 ) ); /* misaligned _bloom */
+  FD_TEST( fd_bloom_delete( _bloom )==(void *)shmem );
+  FD_TEST( !fd_bloom_join  ( _bloom ) ); /* bad magic */
+  FD_TEST( !fd_bloom_delete( _bloom ) ); /* bad magic */
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -140,6 +140,125 @@
 #define FD_CNC_DIAG_IN_BACKP  (0UL) /* updated by the producer, ideally never */
 #define FD_CNC_DIAG_BACKP_CNT (1UL) /* updated by the producer, ideally never */
 
+/* FD_CNC_DIAG_*_TICKS specify standard locations in a tile's cnc
+   application region for accumulating how a tile's run loop spends its
+   time in a standard remote monitoring friendly way.  These are on the
+   second cache line of the application region such that they don't
+   interfere with the above and applications that only use the first
+   cache line.  A tile should only accumulate these if its cnc
+   application region size is at least FD_CNC_DIAG_TICKS_APP_SZ.
+   Treating the application region as an array of ulongs:
+
+     SPIN_TICKS is the number of ticks the tile spent caught up (e.g.
+     polling for input that hasn't arrived yet).
+
+     WORK_TICKS is the number of ticks the tile spent processing input.
+
+     BACKP_TICKS is the number of ticks the tile spent backpressured
+     (e.g. waiting for flow control credits from consumers).
+
+     HKEEP_TICKS is the number of ticks the tile spent doing
+     housekeeping (e.g. flow control credit exchange, publishing
+     diagnostics, command-and-control, etc).
+
+   The sum of these is the number of ticks the tile has been running
+   such that a monitor can compute the tile's duty cycle from the
+   change in these over an interval.  Typically, a tile attributes the
+   ticks between consecutive fd_tickcount observations in its run loop
+   to the activity that was done between them (i.e. this requires no
+   additional tickcount observations in the run loop) and drains the
+   totals into the cnc during housekeeping.  The counters 12:15 remain
+   available for application specific usage. */
+
+#define FD_CNC_DIAG_SPIN_TICKS   ( 8UL) /* updated by the tile, at housekeeping */
+#define FD_CNC_DIAG_WORK_TICKS   ( 9UL) /* " */
+#define FD_CNC_DIAG_BACKP_TICKS  (10UL) /* " */
+#define FD_CNC_DIAG_HKEEP_TICKS  (11UL) /* " */
+#define FD_CNC_DIAG_TICKS_APP_SZ (128UL)
+
+/* FD_CNC_DIAG_TICK( now, ticks ) observes the tickcount, attributes
+   the ticks elapsed since the previous observation now to the tile
+   local accumulator ticks (a ulong lvalue, e.g. the tile's local copy
+   of WORK_TICKS) and updates now (a long lvalue).  This is used in a
+   tile's run loop in place of a plain fd_tickcount observation such
+   that the above accounting doesn't require any additional
+   observations.  Requires FD_HAS_X86 at the point of use.
+
+   By convention, a tile's run loop uses this for the observation at
+   the end of each housekeeping pass (right before reloading the
+   housekeeping timer).  Since housekeeping is done at a low rate, this
+   attributes the ticks spent housekeeping to HKEEP_TICKS for the cost
+   of one extra tickcount observation per housekeeping pass. */
+
+#define FD_CNC_DIAG_TICK( now, ticks ) do {      \
+    long _fd_tick_next = fd_tickcount();        \
+    (ticks) += (ulong)(_fd_tick_next - (now));  \
+    (now)    = _fd_tick_next;                   \
+  } while(0)
+
+/* FD_CNC_DIAG_PERF_* specify standard locations in a tile's cnc
+   application region for accumulating the hardware performance counter
+   events of the tile's thread (see util/perf/fd_perf.h) in a standard
+   remote monitoring friendly way.  These are on the third cache line of
+   the application region.  A tile should only accumulate these if its
+   cnc application region size is at least FD_CNC_DIAG_PERF_APP_SZ.
+   Treating the application region as an array of ulongs, counter
+   FD_CNC_DIAG_PERF_CYCLES+FD_PERF_EVENT_* holds the number of the
+   corresponding events the tile has incurred since it started sampling
+   (such that fd_perf_drain( perf, cnc_diag + FD_CNC_DIAG_PERF_CYCLES )
+   updates them).  Events unavailable on the tile's host are left at
+   zero.  A monitor can compute the tile's IPC and misses per frag from
+   the change in these over an interval.  PERF_FAIL_CNT is the number
+   of times the tile failed to read its counters (the failures are
+   only logged once).  The counters 22:23 remain available for
+   application specific usage. */
+
+#define FD_CNC_DIAG_PERF_CYCLES    (16UL+FD_PERF_EVENT_CYCLES   ) /* updated by the tile, at housekeeping */
+#define FD_CNC_DIAG_PERF_INSNS     (16UL+FD_PERF_EVENT_INSNS    ) /* " */
+#define FD_CNC_DIAG_PERF_LLC_MISS  (16UL+FD_PERF_EVENT_LLC_MISS ) /* " */
+#define FD_CNC_DIAG_PERF_BR_MISS   (16UL+FD_PERF_EVENT_BR_MISS  ) /* " */
+#define FD_CNC_DIAG_PERF_DTLB_MISS (16UL+FD_PERF_EVENT_DTLB_MISS) /* " */
+#define FD_CNC_DIAG_PERF_FAIL_CNT  (16UL+FD_PERF_DIAG_FAIL_CNT  ) /* ", ideally never */
+#define FD_CNC_DIAG_PERF_APP_SZ    (192UL)
+
+/* The standard layout of a tile's cnc application region is thus
+   (in bytes):
+
+     [   0,  64) IN_BACKP, BACKP_CNT, app specific counters 2:7
+     [  64, 128) *_TICKS,             app specific counters 12:15
+     [ 128, 192) PERF_*,              app specific counters 22:23
+     [ 192,2240) latency histograms (FD_LHIST_CNC_APP_*, see
+                 tango/lhist/fd_lhist.h), reserved even if the tile
+                 doesn't record any
+     [2240, ...) app specific counters FD_CNC_DIAG_EXT onward
+
+   That is, a tile that needs more than the above free counters should
+   place them at FD_CNC_DIAG_EXT or later and size its application
+   region accordingly.  FD_CNC_DIAG_APP_OK( idx ) returns 1 if counter
+   idx is free for application specific usage under this layout and 0
+   if it aliases a standard diagnostic (compile time usable such that
+   tiles can FD_STATIC_ASSERT their own diagnostic locations).
+
+   Tiles that support the above standard diagnostics only accumulate
+   the ones that fit in their cnc's application region: *_TICKS if it is
+   at least FD_CNC_DIAG_TICKS_APP_SZ bytes, PERF_* if it is at least
+   FD_CNC_DIAG_PERF_APP_SZ bytes (and the host supports it, see
+   util/perf/fd_perf.h) and, for tiles that consume frags, the latency
+   histograms if it is at least FD_LHIST_CNC_APP_SZ bytes.  Like the
+   other diagnostics, these are not cleared at tile boot (such that
+   they can be accumulated over multiple runs) and clearing is up to
+   monitoring scripts. */
+
+#define FD_CNC_DIAG_LHIST_OFF (FD_CNC_DIAG_PERF_APP_SZ)                     /* ==192 */
+#define FD_CNC_DIAG_LHIST_SZ  (2048UL)                                      /* ==2*FD_LHIST_FOOTPRINT */
+#define FD_CNC_DIAG_EXT_OFF   (FD_CNC_DIAG_LHIST_OFF+FD_CNC_DIAG_LHIST_SZ)  /* ==2240 */
+#define FD_CNC_DIAG_EXT       (FD_CNC_DIAG_EXT_OFF/sizeof(ulong))           /* ==280 */
+
+#define FD_CNC_DIAG_APP_OK( idx ) ((( 2UL<=(idx)) & ((idx)< 8UL)) | \
+                                   ((12UL<=(idx)) & ((idx)<16UL)) | \
+                                   ((22UL<=(idx)) & ((idx)<24UL)) | \
+                                   (FD_CNC_DIAG_EXT<=(idx)))
+
 /* fd_cnc_t is an opaque handle of a command-and-control object.
    Details are exposed here to facilitate inlining of many cnc
    operations in performance critical app thread paths. */
@@ -3,3 +3,4 @@ $(call add-objs,fd_dcache,fd_tango)
 $(call make-unit-test,test_dcache,test_dcache,fd_tango fd_util)
 $(call run-unit-test,test_dcache)
 
+$(call make-unit-test,bench_dcache_msg,bench_dcache_msg,fd_tango fd_util)
@@ -0,0 +1,122 @@
+#include "../fd_tango.h"
+
+/* bench_dcache_msg measures the single core throughput of publishing
+   and reassembling large multi-frag messages through a dcache.  For
+   each message size, it benchmarks a producer that writes messages as
+   a contiguous chunk run (consumer reassembles zero copy) and a
+   producer that writes each frag into its own slot with a gap between
+   them (consumer has to gather).  The consumer hashes each reassembled
+   message to model touching the payload. */
+
+#define MSG_MAX   (1UL<<20)
+#define DEPTH     (4UL)
+#define DATA_MAX  (FD_DCACHE_SLOT_FOOTPRINT( MSG_MAX + (MSG_MAX/FD_DCACHE_MSG_FRAG_MAX+1UL)*2UL*FD_CHUNK_SZ )*(DEPTH+2UL))
+
+static uchar __attribute__((aligned(FD_DCACHE_ALIGN))) shmem[ FD_DCACHE_FOOTPRINT( DATA_MAX, 0UL ) ];
+static uchar __attribute__((aligned(FD_DCACHE_ALIGN))) gbuf [ MSG_MAX ];
+
+static ulong
+bench( uchar * dcache,
+       ulong   msg_sz,
+       ulong   frag_max,
+       int     gap,
+       ulong   iter_cnt,
+       long *  _dt,
+       ulong * _gather_cnt ) {
+
+  /* A gapped producer is modeled as a producer whose frags are
+     allocated independently (mtu of frag_max) with an extra double
+     chunk between them. */
+
+  ulong mtu    = gap ? (frag_max + 2UL*FD_CHUNK_SZ) : msg_sz;
+  ulong chunk0 = fd_dcache_compact_chunk0( dcache, dcache );
+  ulong wmark  = fd_dcache_compact_wmark ( dcache, dcache, mtu );
+  ulong chunk  = chunk0;
+
+  fd_dcache_msg_rx_t _rx[1]; fd_dcache_msg_rx_t * rx = fd_dcache_msg_rx_init( _rx, gbuf, MSG_MAX );
+
+  ulong frag_cnt   = fd_dcache_msg_frag_cnt( msg_sz, frag_max );
+  ulong hash       = 0UL;
+  ulong gather_cnt = 0UL;
+
+  long dt = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+
+    if( !gap ) {
+
+      /* Producer: write the message into a contiguous chunk run */
+
+      fd_memset( fd_chunk_to_laddr( dcache, chunk ), (int)iter, msg_sz );
+
+      /* Producer / consumer: publish and reassemble the frags */
+
+      for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+        ulong frag_chunk = fd_dcache_msg_frag_chunk( chunk, frag_idx, frag_max );
+        ulong frag_sz    = fd_dcache_msg_frag_sz( msg_sz, frag_idx, frag_max );
+        ulong ctl        = fd_dcache_msg_frag_ctl( 0UL, frag_idx, frag_cnt, 0 );
+        fd_dcache_msg_rx_frag( rx, fd_chunk_to_laddr_const( dcache, frag_chunk ), frag_sz, ctl );
+      }
+
+      chunk = fd_dcache_compact_next( chunk, msg_sz, chunk0, wmark );
+
+    } else {
+
+      for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+        ulong frag_sz = fd_dcache_msg_frag_sz( msg_sz, frag_idx, frag_max );
+        ulong ctl     = fd_dcache_msg_frag_ctl( 0UL, frag_idx, frag_cnt, 0 );
+        fd_memset( fd_chunk_to_laddr( dcache, chunk ), (int)iter, frag_sz );
+        fd_dcache_msg_rx_frag( rx, fd_chunk_to_laddr_const( dcache, chunk ), frag_sz, ctl );
+        chunk = fd_dcache_compact_next( chunk, frag_sz + 2UL*FD_CHUNK_SZ, chunk0, wmark );
+      }
+
+    }
+
+    /* Consumer: touch the reassembled message */
+
+    hash += fd_hash( iter, fd_dcache_msg_rx_laddr( rx ), fd_dcache_msg_rx_sz( rx ) );
+    gather_cnt += (ulong)fd_dcache_msg_rx_is_gather( rx );
+  }
+  dt += fd_log_wallclock();
+
+  *_dt         = dt;
+  *_gather_cnt = gather_cnt;
+  return hash;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong frag_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--frag-max", NULL, FD_DCACHE_MSG_FRAG_MAX );
+  ulong byte_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--byte-cnt", NULL, 1UL<<32               );
+
+  if( FD_UNLIKELY( !frag_max || frag_max>FD_DCACHE_MSG_FRAG_MAX || !fd_ulong_is_aligned( frag_max, 2UL*FD_CHUNK_SZ ) ) )
+    FD_LOG_ERR(( "--frag-max should be a positive double chunk multiple of at most %lu", FD_DCACHE_MSG_FRAG_MAX ));
+
+  FD_LOG_NOTICE(( "Benchmarking (--frag-max %lu --byte-cnt %lu)", frag_max, byte_cnt ));
+
+  uchar * dcache = fd_dcache_join( fd_dcache_new( shmem, DATA_MAX, 0UL ) ); FD_TEST( dcache );
+
+  ulong hash = 0UL;
+  for( ulong msg_sz=(1UL<<16); msg_sz<=MSG_MAX; msg_sz<<=1 ) {
+    ulong iter_cnt = fd_ulong_max( byte_cnt / msg_sz, 1UL );
+    for( int gap=0; gap<2; gap++ ) {
+      long  dt;
+      ulong gather_cnt;
+      hash += bench( dcache, msg_sz, frag_max, gap, iter_cnt, &dt, &gather_cnt );
+      FD_LOG_NOTICE(( "msg_sz %7lu B, %s: %8.3f GB/s, %9.3f us/msg (frag_cnt %lu, gather_cnt %lu)",
+                      msg_sz, gap ? "gather   " : "zero copy",
+                      ((double)(iter_cnt*msg_sz)) / ((double)dt),
+                      1e-3*((double)dt) / ((double)iter_cnt),
+                      fd_dcache_msg_frag_cnt( msg_sz, frag_max ), gather_cnt ));
+    }
+  }
+  FD_LOG_NOTICE(( "hash %016lx", hash ));
+
+  FD_TEST( fd_dcache_delete( fd_dcache_leave( dcache ) )==shmem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -257,3 +257,46 @@ fd_dcache_compact_is_safe( void const * base,
   return 1;
 }
 
+int
+fd_dcache_msg_rx_frag( fd_dcache_msg_rx_t * rx,
+                       void const *         laddr,
+                       ulong                sz,
+                       ulong                ctl ) {
+
+  if( fd_frag_meta_ctl_som( ctl ) ) { /* Start a new message (discards any partially reassembled message) */
+    rx->msg    = (uchar const *)laddr;
+    rx->msg_sz = 0UL;
+    rx->active = 1;
+    rx->gather = 0;
+  } else if( FD_UNLIKELY( !rx->active ) ) {
+    return FD_DCACHE_MSG_RX_ERR_SOM;
+  }
+
+  if( FD_LIKELY( !rx->gather ) ) {
+
+    if( FD_LIKELY( ((ulong)laddr==((ulong)rx->msg + rx->msg_sz)) | (!sz) ) ) rx->msg_sz += sz; /* Contiguous, zero copy */
+    else {
+
+      /* Not contiguous.  Switch to gathering by copying what has been
+         reassembled so far into the gather buffer. */
+
+      if( FD_UNLIKELY( (rx->msg_sz+sz) > rx->buf_max ) ) { rx->active = 0; return FD_DCACHE_MSG_RX_ERR_SZ; }
+      if( FD_LIKELY( rx->msg_sz ) ) fd_memcpy( rx->buf, rx->msg, rx->msg_sz );
+      fd_memcpy( rx->buf + rx->msg_sz, laddr, sz );
+      rx->msg     = rx->buf;
+      rx->msg_sz += sz;
+      rx->gather  = 1;
+
+    }
+
+  } else {
+
+    if( FD_UNLIKELY( (rx->msg_sz+sz) > rx->buf_max ) ) { rx->active = 0; return FD_DCACHE_MSG_RX_ERR_SZ; }
+    fd_memcpy( rx->buf + rx->msg_sz, laddr, sz );
+    rx->msg_sz += sz;
+
+  }
+
+  if( fd_frag_meta_ctl_eom( ctl ) ) { rx->active = 0; return FD_DCACHE_MSG_RX_SUCCESS; }
+  return FD_DCACHE_MSG_RX_PENDING;
+}
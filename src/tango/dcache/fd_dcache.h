@@ -268,6 +268,179 @@ fd_dcache_compact_next( ulong chunk,    /* Assumed in [chunk0,wmark] */
   return fd_ulong_if( chunk>wmark, chunk0, chunk );                 /* If that goes over the high water mark, wrap to zero */
 }
 
+/* Multi-frag message API
+
+   A frag's sz is limited to USHORT_MAX bytes by fd_frag_meta_t.  A
+   logical message larger than this (e.g. an entry batch or a block) is
+   published as a sequence of frags from the same origin where the
+   first frag has its ctl som bit set, the last frag has its ctl eom bit
+   set and the frags in between have neither set (a message that fits
+   in a single frag has both set).  All frags in the sequence except the
+   last are exactly frag_max bytes.  frag_max should be a positive
+   double chunk multiple of at most FD_DCACHE_MSG_FRAG_MAX.
+
+   The recommended convention is for the producer to treat msg_max (the
+   largest message it might publish) as the mtu for the purposes of
+   fd_dcache_compact_wmark and fd_dcache_compact_next above.  That is,
+   the producer reserves the whole message as a single contiguous run of
+   chunks starting at chunk (the normal compact wraparound handling
+   guarantees such a run never straddles the end of the data region),
+   writes the message payload into it and then publishes the frags
+   where frag frag_idx covers the chunks starting at:
+
+     fd_dcache_msg_frag_chunk( chunk, frag_idx, frag_max )
+
+   and has size:
+
+     fd_dcache_msg_frag_sz( msg_sz, frag_idx, frag_max )
+
+   and then advances chunk via fd_dcache_compact_next( chunk, msg_sz,
+   chunk0, wmark ).  A dcache with a data region of at least
+   fd_dcache_req_data_sz( msg_max, depth, 1, 1 ) bytes is sufficient for
+   this (as every message uses at least one mcache line, at most depth
+   messages can be exposed to consumers at any given time).
+
+   Consumers can use fd_dcache_msg_rx_t below to reassemble messages.
+   When the frags of a message are byte contiguous in the local address
+   space (as is the case for the above convention), reassembly is zero
+   copy.  Otherwise (e.g. the producer allocated each frag independently
+   with a msg_max of frag_max, and the message wrapped around the end of
+   the data region), the frags are gathered into a caller provided
+   buffer. */
+
+/* FD_DCACHE_MSG_FRAG_MAX is the largest double chunk multiple that fits
+   in a fd_frag_meta_t sz field. */
+
+#define FD_DCACHE_MSG_FRAG_MAX (65408UL)
+
+/* fd_dcache_msg_frag_cnt returns the number of frags needed to publish
+   a msg_sz byte message when frags hold at most frag_max bytes.  A zero
+   sized message still requires 1 frag.  frag_max assumed positive. */
+
+FD_FN_CONST static inline ulong
+fd_dcache_msg_frag_cnt( ulong msg_sz,
+                        ulong frag_max ) {
+  return fd_ulong_max( (msg_sz + frag_max - 1UL) / frag_max, 1UL );
+}
+
+/* fd_dcache_msg_frag_chunk returns the chunk index of frag frag_idx of
+   a message whose first frag starts at chunk.  frag_max assumed a
+   double chunk multiple. */
+
+FD_FN_CONST static inline ulong
+fd_dcache_msg_frag_chunk( ulong chunk,
+                          ulong frag_idx,
+                          ulong frag_max ) {
+  return chunk + frag_idx*(frag_max >> FD_CHUNK_LG_SZ);
+}
+
+/* fd_dcache_msg_frag_sz returns the size of frag frag_idx of a msg_sz
+   byte message.  frag_idx assumed in [0,fd_dcache_msg_frag_cnt). */
+
+FD_FN_CONST static inline ulong
+fd_dcache_msg_frag_sz( ulong msg_sz,
+                       ulong frag_idx,
+                       ulong frag_max ) {
+  ulong off = frag_idx*frag_max;
+  return fd_ulong_min( msg_sz - fd_ulong_min( off, msg_sz ), frag_max );
+}
+
+/* fd_dcache_msg_frag_ctl returns the ctl bits (see fd_frag_meta_ctl)
+   for frag frag_idx of a frag_cnt frag message from origin orig. */
+
+FD_FN_CONST static inline ulong
+fd_dcache_msg_frag_ctl( ulong orig,
+                        ulong frag_idx,
+                        ulong frag_cnt,
+                        int   err ) {
+  return fd_frag_meta_ctl( orig, !frag_idx, frag_idx==(frag_cnt-1UL), err );
+}
+
+/* FD_DCACHE_MSG_RX_{SUCCESS,PENDING,ERR_*} are the return codes of
+   fd_dcache_msg_rx_frag.  SUCCESS indicates the frag completed a
+   message, PENDING indicates more frags are needed to complete the
+   current message, ERR_SOM indicates the frag was not part of a message
+   whose start was observed (e.g. the consumer started or resynchronized
+   mid message) and ERR_SZ indicates the message required gathering and
+   was too large for the gather buffer.  Frags that result in an error
+   are discarded, as is any partially reassembled message. */
+
+#define FD_DCACHE_MSG_RX_SUCCESS ( 0)
+#define FD_DCACHE_MSG_RX_PENDING ( 1)
+#define FD_DCACHE_MSG_RX_ERR_SOM (-1)
+#define FD_DCACHE_MSG_RX_ERR_SZ  (-2)
+
+/* fd_dcache_msg_rx_t holds a consumer's state for reassembling multi-
+   frag messages from a single origin.  It is a local object and should
+   be initialized with fd_dcache_msg_rx_init before use. */
+
+struct fd_dcache_msg_rx {
+  uchar *       buf;     /* Gather buffer, NULL if none */
+  ulong         buf_max; /* Gather buffer size in bytes */
+  uchar const * msg;     /* Location of current message's first byte, either in the data region or buf */
+  ulong         msg_sz;  /* Number of bytes reassembled so far for the current message */
+  int           active;  /* 1 if a som has been observed for the current message, 0 otherwise */
+  int           gather;  /* 1 if the current message is being gathered into buf, 0 if zero copy */
+};
+
+typedef struct fd_dcache_msg_rx fd_dcache_msg_rx_t;
+
+/* fd_dcache_msg_rx_init initializes a fd_dcache_msg_rx_t.  buf points
+   to a buf_max byte region in the caller's address space used to gather
+   messages whose frags are not contiguous.  buf can be NULL (buf_max
+   should be zero in this case) if the caller knows the producer
+   follows the contiguous convention above.  Returns rx. */
+
+static inline fd_dcache_msg_rx_t *
+fd_dcache_msg_rx_init( fd_dcache_msg_rx_t * rx,
+                       uchar *              buf,
+                       ulong                buf_max ) {
+  rx->buf     = buf;
+  rx->buf_max = fd_ulong_if( !!buf, buf_max, 0UL );
+  rx->msg     = NULL;
+  rx->msg_sz  = 0UL;
+  rx->active  = 0;
+  rx->gather  = 0;
+  return rx;
+}
+
+/* fd_dcache_msg_rx_frag incorporates the sz byte frag payload at laddr
+   with the given ctl bits into the message currently being reassembled
+   by rx.  Returns FD_DCACHE_MSG_RX_SUCCESS if the frag completed the
+   message (on return, fd_dcache_msg_rx_{laddr,sz} give the message),
+   FD_DCACHE_MSG_RX_PENDING if more frags are needed, or a negative
+   FD_DCACHE_MSG_RX_ERR_* code on failure (logs nothing as these are
+   expected in normal operation, e.g. after an overrun).
+
+   As usual, the frag payload can be overwritten by the producer at any
+   point during this call when the consumer is overrun.  So the caller
+   should validate the frag's seq after this call returns as it would
+   for any other speculatively processed frag.  Note that a message
+   reassembled zero copy is not copied until the consumer reads it, so
+   a caller using zero copy should validate that the eom frag was not
+   overrun after it is done reading the message (by the sizing argument
+   above, the rest of the message is still valid if the eom frag was not
+   overrun).  On overrun, the caller should reinitialize or simply
+   continue (the next frag will be discarded with ERR_SOM until the next
+   message start). */
+
+int
+fd_dcache_msg_rx_frag( fd_dcache_msg_rx_t * rx,
+                       void const *         laddr,
+                       ulong                sz,
+                       ulong                ctl );
+
+/* fd_dcache_msg_rx_{laddr,sz,is_gather} return the location, size and
+   whether or not the most recently completed message was gathered.  The
+   location is either in the dcache data region (zero copy) or in the
+   gather buffer.  Only valid after fd_dcache_msg_rx_frag returned
+   FD_DCACHE_MSG_RX_SUCCESS and until the next call to
+   fd_dcache_msg_rx_frag. */
+
+FD_FN_PURE static inline uchar const * fd_dcache_msg_rx_laddr    ( fd_dcache_msg_rx_t const * rx ) { return rx->msg;    }
+FD_FN_PURE static inline ulong         fd_dcache_msg_rx_sz       ( fd_dcache_msg_rx_t const * rx ) { return rx->msg_sz; }
+FD_FN_PURE static inline int           fd_dcache_msg_rx_is_gather( fd_dcache_msg_rx_t const * rx ) { return rx->gather; }
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_tango_dcache_fd_dcache_h */
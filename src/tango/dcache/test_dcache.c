@@ -201,6 +201,131 @@ main( int     argc,
     }
   }
 
+  /* Test multi-frag messages */
+
+  ulong msg_max  = 1024UL;
+  ulong frag_max =  256UL;
+  if( FD_LIKELY( data_sz >= fd_dcache_req_data_sz( msg_max, depth, 1UL /*burst*/, 1 /*compact*/ ) ) ) {
+    FD_TEST( fd_dcache_compact_is_safe( dcache, dcache, msg_max, depth ) );
+    ulong chunk0 = fd_dcache_compact_chunk0( dcache, dcache );
+    ulong chunk1 = fd_dcache_compact_chunk1( dcache, dcache );
+
+    FD_TEST( fd_ulong_is_aligned( FD_DCACHE_MSG_FRAG_MAX, 2UL*FD_CHUNK_SZ ) );
+    FD_TEST( FD_DCACHE_MSG_FRAG_MAX<=(ulong)USHORT_MAX                      );
+    FD_TEST( (FD_DCACHE_MSG_FRAG_MAX+2UL*FD_CHUNK_SZ)>(ulong)USHORT_MAX     );
+
+    FD_TEST( fd_dcache_msg_frag_cnt(   0UL, frag_max )==1UL );
+    FD_TEST( fd_dcache_msg_frag_cnt(   1UL, frag_max )==1UL );
+    FD_TEST( fd_dcache_msg_frag_cnt( 256UL, frag_max )==1UL );
+    FD_TEST( fd_dcache_msg_frag_cnt( 257UL, frag_max )==2UL );
+    FD_TEST( fd_dcache_msg_frag_sz ( 257UL, 0UL, frag_max )==256UL );
+    FD_TEST( fd_dcache_msg_frag_sz ( 257UL, 1UL, frag_max )==  1UL );
+    FD_TEST( fd_dcache_msg_frag_sz (   0UL, 0UL, frag_max )==  0UL );
+
+    static uchar msg[ 1024UL ];
+    static uchar buf[ 1024UL ];
+    fd_dcache_msg_rx_t _rx[1]; fd_dcache_msg_rx_t * rx = fd_dcache_msg_rx_init( _rx, buf, 1024UL );
+
+    /* Contiguous run convention (treats msg_max as the mtu).  Messages
+       should never straddle the end of the data region and should
+       always reassemble zero copy.  Run enough iterations to wrap many
+       times. */
+
+    ulong wmark  = fd_dcache_compact_wmark( dcache, dcache, msg_max );
+    ulong chunk  = chunk0;
+    ulong wrap_cnt = 0UL;
+    for( ulong iter=0UL; iter<100000UL; iter++ ) {
+      ulong msg_sz   = fd_rng_ulong_roll( rng, msg_max+1UL ); /* In [0,msg_max] */
+      ulong frag_cnt = fd_dcache_msg_frag_cnt( msg_sz, frag_max );
+      for( ulong b=0UL; b<msg_sz; b++ ) msg[b] = fd_rng_uchar( rng );
+
+      uchar * p = (uchar *)fd_chunk_to_laddr( dcache, chunk );
+      FD_TEST( (chunk + (fd_ulong_align_up( msg_sz, FD_CHUNK_SZ ) >> FD_CHUNK_LG_SZ))<=chunk1 );
+      fd_memcpy( p, msg, msg_sz );
+
+      for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+        ulong frag_chunk = fd_dcache_msg_frag_chunk( chunk, frag_idx, frag_max );
+        ulong frag_sz    = fd_dcache_msg_frag_sz( msg_sz, frag_idx, frag_max );
+        ulong ctl        = fd_dcache_msg_frag_ctl( 0UL, frag_idx, frag_cnt, 0 );
+        FD_TEST( frag_sz<=frag_max );
+        FD_TEST( fd_frag_meta_ctl_som( ctl )==(frag_idx==0UL         ) );
+        FD_TEST( fd_frag_meta_ctl_eom( ctl )==(frag_idx==frag_cnt-1UL) );
+        int err = fd_dcache_msg_rx_frag( rx, fd_chunk_to_laddr_const( dcache, frag_chunk ), frag_sz, ctl );
+        FD_TEST( err==fd_int_if( frag_idx==frag_cnt-1UL, FD_DCACHE_MSG_RX_SUCCESS, FD_DCACHE_MSG_RX_PENDING ) );
+      }
+
+      FD_TEST( !fd_dcache_msg_rx_is_gather( rx )     );
+      FD_TEST( fd_dcache_msg_rx_laddr( rx )==p       );
+      FD_TEST( fd_dcache_msg_rx_sz   ( rx )==msg_sz  );
+      FD_TEST( !memcmp( fd_dcache_msg_rx_laddr( rx ), msg, msg_sz ) );
+
+      ulong next = fd_dcache_compact_next( chunk, msg_sz, chunk0, wmark );
+      wrap_cnt += (ulong)(next<chunk);
+      chunk = next;
+    }
+    FD_TEST( wrap_cnt );
+
+    /* Independently allocated frags (treats frag_max as the mtu).
+       Messages that straddle the wrap point are not contiguous and
+       should be gathered correctly. */
+
+    wmark = fd_dcache_compact_wmark( dcache, dcache, frag_max );
+    chunk = chunk0;
+    ulong gather_cnt = 0UL;
+    for( ulong iter=0UL; iter<100000UL; iter++ ) {
+      ulong msg_sz   = fd_rng_ulong_roll( rng, msg_max+1UL ); /* In [0,msg_max] */
+      ulong frag_cnt = fd_dcache_msg_frag_cnt( msg_sz, frag_max );
+      for( ulong b=0UL; b<msg_sz; b++ ) msg[b] = fd_rng_uchar( rng );
+
+      int wrapped = 0;
+      for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+        ulong frag_sz = fd_dcache_msg_frag_sz( msg_sz, frag_idx, frag_max );
+        fd_memcpy( fd_chunk_to_laddr( dcache, chunk ), msg + frag_idx*frag_max, frag_sz );
+        ulong ctl = fd_dcache_msg_frag_ctl( 0UL, frag_idx, frag_cnt, 0 );
+        int   err = fd_dcache_msg_rx_frag( rx, fd_chunk_to_laddr_const( dcache, chunk ), frag_sz, ctl );
+        FD_TEST( err==fd_int_if( frag_idx==frag_cnt-1UL, FD_DCACHE_MSG_RX_SUCCESS, FD_DCACHE_MSG_RX_PENDING ) );
+        ulong next = fd_dcache_compact_next( chunk, frag_sz, chunk0, wmark );
+        wrapped |= (next<chunk) & (frag_idx<frag_cnt-1UL);
+        chunk = next;
+      }
+
+      FD_TEST( fd_dcache_msg_rx_is_gather( rx )==wrapped );
+      FD_TEST( fd_dcache_msg_rx_sz( rx )==msg_sz );
+      FD_TEST( !memcmp( fd_dcache_msg_rx_laddr( rx ), msg, msg_sz ) );
+      gather_cnt += (ulong)wrapped;
+    }
+    FD_TEST( gather_cnt );
+
+    /* Overrun / resync handling: frags without an observed som are
+       discarded until the next som, a som mid message restarts
+       reassembly and a gather that doesn't fit is rejected. */
+
+    uchar const * a = fd_chunk_to_laddr_const( dcache, chunk0        );
+    uchar const * b = fd_chunk_to_laddr_const( dcache, chunk0+ 8UL   );
+    uchar const * c = fd_chunk_to_laddr_const( dcache, chunk0+16UL   );
+    ulong ctl_som = fd_frag_meta_ctl( 0UL, 1, 0, 0 );
+    ulong ctl_mid = fd_frag_meta_ctl( 0UL, 0, 0, 0 );
+    ulong ctl_eom = fd_frag_meta_ctl( 0UL, 0, 1, 0 );
+
+    fd_dcache_msg_rx_init( rx, buf, 1024UL );
+    FD_TEST( fd_dcache_msg_rx_frag( rx, b, 512UL, ctl_mid )==FD_DCACHE_MSG_RX_ERR_SOM ); /* joined mid message */
+    FD_TEST( fd_dcache_msg_rx_frag( rx, c, 512UL, ctl_eom )==FD_DCACHE_MSG_RX_ERR_SOM );
+    FD_TEST( fd_dcache_msg_rx_frag( rx, a, 512UL, ctl_som )==FD_DCACHE_MSG_RX_PENDING );
+    FD_TEST( fd_dcache_msg_rx_frag( rx, a, 512UL, ctl_som )==FD_DCACHE_MSG_RX_PENDING ); /* overrun, producer restarted */
+    FD_TEST( fd_dcache_msg_rx_frag( rx, b, 512UL, ctl_eom )==FD_DCACHE_MSG_RX_SUCCESS );
+    FD_TEST( fd_dcache_msg_rx_laddr( rx )==a && fd_dcache_msg_rx_sz( rx )==1024UL && !fd_dcache_msg_rx_is_gather( rx ) );
+    FD_TEST( fd_dcache_msg_rx_frag( rx, c, 512UL, ctl_eom )==FD_DCACHE_MSG_RX_ERR_SOM ); /* duplicate eom */
+
+    FD_TEST( fd_dcache_msg_rx_frag( rx, a, 512UL, ctl_som )==FD_DCACHE_MSG_RX_PENDING );
+    FD_TEST( fd_dcache_msg_rx_frag( rx, c, 512UL, ctl_mid )==FD_DCACHE_MSG_RX_PENDING ); /* gather */
+    FD_TEST( fd_dcache_msg_rx_frag( rx, a, 512UL, ctl_eom )==FD_DCACHE_MSG_RX_ERR_SZ  ); /* too large to gather */
+    FD_TEST( fd_dcache_msg_rx_frag( rx, b, 512UL, ctl_eom )==FD_DCACHE_MSG_RX_ERR_SOM );
+
+    fd_dcache_msg_rx_init( rx, NULL, 0UL ); /* zero copy only */
+    FD_TEST( fd_dcache_msg_rx_frag( rx, a, 512UL, ctl_som )==FD_DCACHE_MSG_RX_PENDING );
+    FD_TEST( fd_dcache_msg_rx_frag( rx, c, 512UL, ctl_eom )==FD_DCACHE_MSG_RX_ERR_SZ  );
+  }
+
   /* Test mcache destruction */
 
   FD_TEST( fd_dcache_leave( NULL   )==NULL     ); /* null dcache */
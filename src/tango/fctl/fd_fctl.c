@@ -27,6 +27,7 @@ fd_fctl_new( void * shmem,
   fctl->cr_max    = 0UL;
   fctl->cr_resume = 0UL;
   fctl->cr_refill = 0UL;
+  fctl->rx_dirty  = 0UL;
 
   return shmem;
 }
@@ -68,6 +69,8 @@ fd_fctl_cfg_rx_add( fd_fctl_t *   fctl,
   rx[ rx_idx ].cr_max     = (long)cr_max;
   rx[ rx_idx ].seq_laddr  = seq_laddr;
   rx[ rx_idx ].slow_laddr = slow_laddr;
+  rx[ rx_idx ].join_laddr = NULL;
+  rx[ rx_idx ].state      = fd_ulong_if( !!seq_laddr, FD_FCTL_RX_STATE_ACTIVE, FD_FCTL_RX_STATE_IDLE );
 
   fctl->rx_cnt = (ushort)(rx_idx+1UL);
   return fctl;
@@ -137,3 +140,126 @@ fd_fctl_cfg_done( fd_fctl_t * fctl,
   return fctl;
 }
 
+fd_fctl_t *
+fd_fctl_rx_join( fd_fctl_t * fctl,
+                 ulong       rx_idx,
+                 ulong *     seq_laddr ) {
+  if( FD_UNLIKELY( !fctl ) ) {
+    FD_LOG_WARNING(( "NULL fctl" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( rx_idx>=(ulong)fctl->rx_cnt ) ) {
+    FD_LOG_WARNING(( "bad rx_idx" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !seq_laddr ) ) {
+    FD_LOG_WARNING(( "NULL seq_laddr" ));
+    return NULL;
+  }
+
+  fd_fctl_private_rx_t * rx = fd_fctl_private_rx( fctl ) + rx_idx;
+
+  if( FD_UNLIKELY( fd_fctl_rx_state( fctl, rx_idx )!=FD_FCTL_RX_STATE_IDLE ) ) {
+    FD_LOG_WARNING(( "rx %lu is not idle", rx_idx ));
+    return NULL;
+  }
+
+  /* Publish the join details before the state change and the state
+     change before marking the fctl dirty (the transmitter observes
+     these in reverse order). */
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rx->join_laddr ) = seq_laddr;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rx->state      ) = FD_FCTL_RX_STATE_JOIN;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( fctl->rx_dirty ) = 1UL;
+  FD_COMPILER_MFENCE();
+
+  return fctl;
+}
+
+fd_fctl_t *
+fd_fctl_rx_leave( fd_fctl_t * fctl,
+                  ulong       rx_idx ) {
+  if( FD_UNLIKELY( !fctl ) ) {
+    FD_LOG_WARNING(( "NULL fctl" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( rx_idx>=(ulong)fctl->rx_cnt ) ) {
+    FD_LOG_WARNING(( "bad rx_idx" ));
+    return NULL;
+  }
+
+  fd_fctl_private_rx_t * rx = fd_fctl_private_rx( fctl ) + rx_idx;
+
+  if( FD_UNLIKELY( fd_fctl_rx_state( fctl, rx_idx )!=FD_FCTL_RX_STATE_ACTIVE ) ) {
+    FD_LOG_WARNING(( "rx %lu is not active", rx_idx ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rx->state      ) = FD_FCTL_RX_STATE_LEAVE;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( fctl->rx_dirty ) = 1UL;
+  FD_COMPILER_MFENCE();
+
+  return fctl;
+}
+
+ulong
+fd_fctl_private_tx_rx_update( fd_fctl_t * fctl,
+                              ulong       cr_avail,
+                              ulong       tx_seq ) {
+
+  /* Clear the dirty flag before scanning the receivers such that any
+     request made concurrently with the scan will be picked up at the
+     next housekeeping.  This needs to be a full memory fence (not just
+     a compiler one) as the receiver state loads below must not be
+     reordered before the clear. */
+
+# if FD_HAS_ATOMIC
+  FD_ATOMIC_XCHG( &fctl->rx_dirty, 0UL );
+# else
+  FD_VOLATILE( fctl->rx_dirty ) = 0UL;
+# endif
+  FD_COMPILER_MFENCE();
+
+  fd_fctl_private_rx_t * rx     = fd_fctl_private_rx( fctl );
+  ulong                  rx_cnt = (ulong)fctl->rx_cnt;
+
+  for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
+    ulong state = FD_VOLATILE_CONST( rx[ rx_idx ].state );
+
+    if( state==FD_FCTL_RX_STATE_JOIN ) {
+
+      /* Start the receiver at our current position in sequence space
+         and make sure we don't use more credits than are safe for it
+         before the next credit query. */
+
+      ulong * seq_laddr = FD_VOLATILE_CONST( rx[ rx_idx ].join_laddr );
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( seq_laddr[0] ) = tx_seq;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( rx[ rx_idx ].seq_laddr ) = seq_laddr;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( rx[ rx_idx ].state ) = FD_FCTL_RX_STATE_ACTIVE;
+      FD_COMPILER_MFENCE();
+      cr_avail = fd_ulong_min( cr_avail, (ulong)rx[ rx_idx ].cr_max );
+
+    } else if( state==FD_FCTL_RX_STATE_LEAVE ) {
+
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( rx[ rx_idx ].seq_laddr ) = NULL;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( rx[ rx_idx ].state ) = FD_FCTL_RX_STATE_IDLE;
+      FD_COMPILER_MFENCE();
+
+    }
+  }
+
+  return cr_avail;
+}
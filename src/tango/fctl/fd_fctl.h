@@ -16,6 +16,24 @@
 
 #define FD_FCTL_RX_MAX_MAX (65535UL)
 
+/* FD_FCTL_RX_STATE_* give the states of a fctl receiver slot.  A
+   receiver added during configuration with a non-NULL seq_laddr starts
+   in the ACTIVE state.  A receiver added with a NULL seq_laddr starts
+   in the IDLE state and can be dynamically attached / detached while
+   the transmitter is running (see fd_fctl_rx_join below).  JOIN and
+   LEAVE indicate a request that the transmitter has not yet processed.
+   The transitions are:
+
+     IDLE   -> JOIN   (fd_fctl_rx_join,      receiver side)
+     JOIN   -> ACTIVE (fd_fctl_tx_rx_update, transmitter side)
+     ACTIVE -> LEAVE  (fd_fctl_rx_leave,     receiver side)
+     LEAVE  -> IDLE   (fd_fctl_tx_rx_update, transmitter side) */
+
+#define FD_FCTL_RX_STATE_IDLE   (0UL)
+#define FD_FCTL_RX_STATE_JOIN   (1UL)
+#define FD_FCTL_RX_STATE_ACTIVE (2UL)
+#define FD_FCTL_RX_STATE_LEAVE  (3UL)
+
 /* FD_FCTL_{ALIGN,FOOTPRINT} specify the alignment and footprint needed
    for a fctl.  ALIGN will be positive integer power of 2.  FOOTPRINT
    assumes rx_max is in [0,FD_FCTL_RX_MAX_RX_MAX]. */
@@ -44,6 +62,8 @@ struct fd_fctl_private_rx {
   long          cr_max;     /* See fd_fctl_cfg_rx_add for details, should be positive */
   ulong const * seq_laddr;  /* ", NULL indicates an inactive rx */
   ulong *       slow_laddr; /* " */
+  ulong *       join_laddr; /* See fd_fctl_rx_join for details, only meaningful in the JOIN state */
+  ulong         state;      /* FD_FCTL_RX_STATE_*, written by the receiver in IDLE / ACTIVE and by the transmitter in JOIN / LEAVE */
 };
 
 typedef struct fd_fctl_private_rx fd_fctl_private_rx_t;
@@ -56,6 +76,7 @@ struct fd_fctl_private {
   ulong  cr_max;    /* ", in [cr_burst,LONG_MAX] */
   ulong  cr_resume; /* ", in [cr_burst,cr_max  ] */
   ulong  cr_refill; /* ", In [1,cr_resume      ] */
+  ulong  rx_dirty;  /* 1 if there might be receivers in the JOIN / LEAVE states, 0 otherwise */
   /* rx_max fd_fctl_private_rx_t array indexed [0,rx_max) follows.  Only
      elements [0,rx_cnt) are in use.  Only elements with non-NULL
      seq_laddr are currently allowed to backpressure this fctl. */
@@ -155,7 +176,7 @@ static inline void *      fd_fctl_delete( void *      shfctl ) { return shfctl;
    in the underlying sequence space.  The user is guaranteed that the
    receiver has processed all sequence numbers strictly before
    *seq_laddr.  NULL is fine here (the fctl will ignore this receiver
-   until it is set, potentially post configuration).
+   until it is set post configuration by fd_fctl_rx_join).
 
    slow_laddr is the location in the user's local address space where
    the fctl should accumulate statistics for which receiver is running
@@ -267,6 +288,86 @@ fd_fctl_rx_slow_laddr_const( fd_fctl_t const * fctl,
   return fd_fctl_private_rx_const( fctl )[rx_idx].slow_laddr;
 }
 
+/* fd_fctl_rx_state returns the current FD_FCTL_RX_STATE_* of receiver
+   rx_idx.  Assumes fctl is a local join to a configured fctl and rx_idx
+   is in [0,rx_cnt).  As the transmitter may concurrently change the
+   state, this is a compiler memory fence and the result should be
+   considered stale immediately after return. */
+
+static inline ulong
+fd_fctl_rx_state( fd_fctl_t const * fctl,
+                  ulong             rx_idx ) {
+  FD_COMPILER_MFENCE();
+  ulong state = FD_VOLATILE_CONST( fd_fctl_private_rx_const( fctl )[rx_idx].state );
+  FD_COMPILER_MFENCE();
+  return state;
+}
+
+/* Dynamic receiver APIs
+
+   fd_fctl_rx_join requests that receiver rx_idx (which should have
+   been added to the fctl during configuration with a NULL seq_laddr and
+   currently be IDLE) be attached to the running transmitter with its
+   position in sequence space given by seq_laddr (e.g. the receiver's
+   fseq).  fd_fctl_rx_leave requests that the currently ACTIVE receiver
+   rx_idx be detached.  These are typically called by the receiver (or
+   some command-and-control agent acting on its behalf) from a thread
+   other than the transmitter's.  As such, a fctl with dynamic receivers
+   should be placed in a memory region shared between the transmitter
+   and these threads.  At most one thread should be making requests for
+   a given rx_idx at a time.
+
+   The requests are processed by the transmitter the next time it does
+   flow control housekeeping (i.e. fd_fctl_tx_cr_update or
+   fd_fctl_tx_rx_update).  On joining, the transmitter writes its
+   current position in sequence space to *seq_laddr, limits the credits
+   it has available to the receiver's cr_max and then transitions the
+   receiver to ACTIVE.  Thus, once the receiver observes it is ACTIVE
+   via fd_fctl_rx_state, it should start receiving at the sequence
+   number it finds at seq_laddr and is guaranteed to not be overrun
+   from that point on (the usual fd_fctl_rx_cr_return rules apply).
+   Until then, the receiver should not touch *seq_laddr.  On leaving,
+   the transmitter stops considering the receiver for flow control and
+   then transitions the receiver to IDLE.  The receiver should keep
+   *seq_laddr valid until it observes it is IDLE (but it is fine for
+   the receiver to stop returning credits as soon as it requests to
+   leave ... a transmitter blocked on it will process the leave when
+   it next does housekeeping).
+
+   Returns fctl on success and NULL on failure (logs details).  Reasons
+   for failure include NULL fctl, bad rx_idx, NULL seq_laddr and
+   receiver not in the appropriate state for the request. */
+
+fd_fctl_t *
+fd_fctl_rx_join( fd_fctl_t * fctl,
+                 ulong       rx_idx,
+                 ulong *     seq_laddr );
+
+fd_fctl_t *
+fd_fctl_rx_leave( fd_fctl_t * fctl,
+                  ulong       rx_idx );
+
+/* fd_fctl_tx_rx_update processes any pending receiver join / leave
+   requests on behalf of a transmitter that has published up to but not
+   including tx_seq and currently has cr_avail credits available.
+   Returns the updated number of credits available (will be at most
+   cr_avail).  This is done automatically by fd_fctl_tx_cr_update below
+   and only needs to be called explicitly by transmitters that do their
+   own credit management.  Fast when there are no pending requests. */
+
+ulong
+fd_fctl_private_tx_rx_update( fd_fctl_t * fctl,
+                              ulong       cr_avail,
+                              ulong       tx_seq );
+
+static inline ulong
+fd_fctl_tx_rx_update( fd_fctl_t * fctl,
+                      ulong       cr_avail,
+                      ulong       tx_seq ) {
+  if( FD_UNLIKELY( FD_VOLATILE_CONST( fctl->rx_dirty ) ) ) cr_avail = fd_fctl_private_tx_rx_update( fctl, cr_avail, tx_seq );
+  return cr_avail;
+}
+
 /* fd_fctl_rx_cr_return updates users of _rx_seq flow control (e.g. from
    rx_seq_laddr above) the position of the receiver in sequence space
    (in the sense that the receiver has consumed all sequence numbers
@@ -355,7 +456,7 @@ fd_fctl_cr_query( fd_fctl_t const * fctl,
      such that rx_cr_max is a fallback in this case). */
 
   for( ulong rx_idx=0UL; rx_idx<rx_cnt; rx_idx++ ) {
-    ulong const * _rx_seq = rx[ rx_idx ].seq_laddr;
+    ulong const * _rx_seq = FD_VOLATILE_CONST( rx[ rx_idx ].seq_laddr );
     if( FD_UNLIKELY( !_rx_seq ) ) continue; /* Skip inactive rx */
 
     ulong rx_seq      = FD_VOLATILE_CONST( *_rx_seq );
@@ -374,7 +475,9 @@ fd_fctl_cr_query( fd_fctl_t const * fctl,
 
    The vast majority of flow control scenarios (even incredibly
    intricate dynamic heterogenous multiple consumer) can typically be
-   handled with just this one call in the transmitter's run loop.
+   handled with just this one call in the transmitter's run loop.  In
+   particular, this also processes any pending dynamic receiver join /
+   leave requests (see fd_fctl_tx_rx_update).
 
    It assumes that reliable receivers are updating their position in
    sequence space moderately frequently, the transmitter and receivers
@@ -508,6 +611,8 @@ fd_fctl_tx_cr_update( fd_fctl_t * fctl,
                       ulong       cr_avail,
                       ulong       tx_seq ) {
 
+  cr_avail = fd_fctl_tx_rx_update( fctl, cr_avail, tx_seq );
+
   int in_refill = fctl->in_refill;
 
   if( FD_UNLIKELY( (cr_avail<fctl->cr_refill) | in_refill ) ) { /* Yes, strictly "<" */
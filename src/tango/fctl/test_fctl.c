@@ -9,6 +9,11 @@ static uchar __attribute__((aligned(FD_FCTL_ALIGN))) shmem[ FD_FCTL_FOOTPRINT( R
 static ulong rx_seq [ RX_MAX ]; /* Init to zero */
 static ulong rx_slow[ RX_MAX ];
 
+#define DYN_RX_CNT (4UL)
+#define DYN_DEPTH  (64UL)
+static uchar __attribute__((aligned(FD_FCTL_ALIGN))) dyn_shmem[ FD_FCTL_FOOTPRINT( DYN_RX_CNT ) ];
+static ulong dyn_ring[ DYN_DEPTH ];
+
 int
 main( int     argc,
       char ** argv ) {
@@ -102,6 +107,138 @@ main( int     argc,
   FD_TEST( fd_fctl_leave ( fctl )==shfctl );
   FD_TEST( fd_fctl_delete( fctl )==shmem  );
 
+  /* Test dynamic receivers under load.  This simulates (single threaded
+     with randomized interleaving) a transmitter publishing into a
+     DYN_DEPTH deep ring with a static reliable receiver (rx 0) and
+     DYN_RX_CNT-1 dynamic reliable receivers that randomly join and
+     leave.  Reliable receivers should never be overrun.  rx 2 has a
+     smaller cr_max than the rest to check that joins limit the
+     transmitter's available credits appropriately. */
+
+  do {
+    ulong dyn_cr_max[ DYN_RX_CNT ];
+    ulong dyn_seq   [ DYN_RX_CNT ]; /* Receiver fseqs */
+    ulong dyn_slow  [ DYN_RX_CNT ];
+    ulong dyn_pos   [ DYN_RX_CNT ]; /* Receiver local positions */
+    ulong dyn_state [ DYN_RX_CNT ]; /* Receiver view of its state */
+    ulong dyn_rx_cnt[ DYN_RX_CNT ]; /* Frags received */
+    ulong join_cnt = 0UL;
+    ulong leave_cnt = 0UL;
+
+    fd_fctl_t * dyn = fd_fctl_join( fd_fctl_new( dyn_shmem, DYN_RX_CNT ) ); FD_TEST( dyn );
+
+    ulong tx_seq = fd_rng_ulong( rng ); /* Arbitrary initial position */
+    for( ulong rx_idx=0UL; rx_idx<DYN_RX_CNT; rx_idx++ ) {
+      dyn_cr_max[ rx_idx ] = fd_ulong_if( rx_idx==2UL, DYN_DEPTH/4UL, DYN_DEPTH );
+      dyn_seq   [ rx_idx ] = fd_ulong_if( !rx_idx, tx_seq, fd_rng_ulong( rng ) ); /* garbage for dynamic rx */
+      dyn_slow  [ rx_idx ] = 0UL;
+      dyn_pos   [ rx_idx ] = dyn_seq[ rx_idx ];
+      dyn_state [ rx_idx ] = fd_ulong_if( !rx_idx, FD_FCTL_RX_STATE_ACTIVE, FD_FCTL_RX_STATE_IDLE );
+      dyn_rx_cnt[ rx_idx ] = 0UL;
+      FD_TEST( fd_fctl_cfg_rx_add( dyn, dyn_cr_max[ rx_idx ], rx_idx ? NULL : &dyn_seq[ rx_idx ], &dyn_slow[ rx_idx ] )==dyn );
+    }
+    FD_TEST( fd_fctl_cfg_done( dyn, 1UL, 0UL, 0UL, 0UL )==dyn );
+
+    FD_TEST( fd_fctl_rx_state( dyn, 0UL )==FD_FCTL_RX_STATE_ACTIVE );
+    for( ulong rx_idx=1UL; rx_idx<DYN_RX_CNT; rx_idx++ ) FD_TEST( fd_fctl_rx_state( dyn, rx_idx )==FD_FCTL_RX_STATE_IDLE );
+
+    /* Test failure cases for fd_fctl_rx_join / fd_fctl_rx_leave */
+    FD_TEST( fd_fctl_rx_join ( NULL, 1UL,        &dyn_seq[1] )==NULL ); /* null fctl      */
+    FD_TEST( fd_fctl_rx_join ( dyn,  DYN_RX_CNT, &dyn_seq[1] )==NULL ); /* bad rx_idx     */
+    FD_TEST( fd_fctl_rx_join ( dyn,  1UL,        NULL        )==NULL ); /* null seq_laddr */
+    FD_TEST( fd_fctl_rx_join ( dyn,  0UL,        &dyn_seq[0] )==NULL ); /* not idle       */
+    FD_TEST( fd_fctl_rx_leave( NULL, 0UL                     )==NULL ); /* null fctl      */
+    FD_TEST( fd_fctl_rx_leave( dyn,  DYN_RX_CNT              )==NULL ); /* bad rx_idx     */
+    FD_TEST( fd_fctl_rx_leave( dyn,  1UL                     )==NULL ); /* not active     */
+
+    ulong cr_avail = 0UL;
+    for( ulong iter=0UL; iter<10000000UL; iter++ ) {
+      uint r = fd_rng_uint( rng );
+
+      /* Transmitter housekeeping */
+
+      if( !(r & 15U) ) cr_avail = fd_fctl_tx_cr_update( dyn, cr_avail, tx_seq );
+      r >>= 4;
+
+      /* Transmitter publishes a frag if it has credits */
+
+      if( cr_avail ) {
+        dyn_ring[ tx_seq & (DYN_DEPTH-1UL) ] = tx_seq;
+        tx_seq = fd_seq_inc( tx_seq, 1UL );
+        cr_avail--;
+      }
+
+      /* Receivers */
+
+      for( ulong rx_idx=0UL; rx_idx<DYN_RX_CNT; rx_idx++ ) {
+        uint rr = fd_rng_uint( rng );
+
+        switch( dyn_state[ rx_idx ] ) {
+
+        case FD_FCTL_RX_STATE_IDLE:
+          if( !(rr & 1023U) ) {
+            dyn_seq[ rx_idx ] = fd_rng_ulong( rng ); /* transmitter should overwrite this */
+            FD_TEST( fd_fctl_rx_join( dyn, rx_idx, &dyn_seq[ rx_idx ] )==dyn );
+            dyn_state[ rx_idx ] = FD_FCTL_RX_STATE_JOIN;
+          }
+          break;
+
+        case FD_FCTL_RX_STATE_JOIN:
+          if( fd_fctl_rx_state( dyn, rx_idx )==FD_FCTL_RX_STATE_ACTIVE ) {
+            dyn_pos  [ rx_idx ] = FD_VOLATILE_CONST( dyn_seq[ rx_idx ] );
+            FD_TEST( fd_seq_le( dyn_pos[ rx_idx ], tx_seq ) );
+            FD_TEST( fd_seq_diff( tx_seq, dyn_pos[ rx_idx ] )<=(long)dyn_cr_max[ rx_idx ] );
+            dyn_state[ rx_idx ] = FD_FCTL_RX_STATE_ACTIVE;
+            join_cnt++;
+          }
+          break;
+
+        case FD_FCTL_RX_STATE_ACTIVE:
+          if( rx_idx && !(rr & 4095U) ) { /* Leave (without returning any final credits) */
+            FD_TEST( fd_fctl_rx_leave( dyn, rx_idx )==dyn );
+            dyn_state[ rx_idx ] = FD_FCTL_RX_STATE_LEAVE;
+            break;
+          }
+          rr >>= 12;
+
+          /* Receive a frag (occasionally stall for a while) and
+             occasionally return credits */
+
+          if( (rr & 3U) && fd_seq_lt( dyn_pos[ rx_idx ], tx_seq ) ) {
+            FD_TEST( dyn_ring[ dyn_pos[ rx_idx ] & (DYN_DEPTH-1UL) ]==dyn_pos[ rx_idx ] ); /* not overrun */
+            dyn_pos[ rx_idx ] = fd_seq_inc( dyn_pos[ rx_idx ], 1UL );
+            dyn_rx_cnt[ rx_idx ]++;
+          }
+          rr >>= 2;
+          if( !(rr & 7U) ) fd_fctl_rx_cr_return( &dyn_seq[ rx_idx ], dyn_pos[ rx_idx ] );
+
+          /* The transmitter should never be further ahead of any
+             reliable receiver than that receiver's cr_max */
+
+          FD_TEST( fd_seq_diff( tx_seq, dyn_seq[ rx_idx ] )<=(long)dyn_cr_max[ rx_idx ] );
+          break;
+
+        case FD_FCTL_RX_STATE_LEAVE:
+          if( fd_fctl_rx_state( dyn, rx_idx )==FD_FCTL_RX_STATE_IDLE ) {
+            dyn_state[ rx_idx ] = FD_FCTL_RX_STATE_IDLE;
+            leave_cnt++;
+          }
+          break;
+
+        default:
+          FD_LOG_ERR(( "unexpected state" ));
+        }
+      }
+    }
+
+    FD_LOG_NOTICE(( "dynamic: %lu joins, %lu leaves, rx cnt %lu %lu %lu %lu",
+                    join_cnt, leave_cnt, dyn_rx_cnt[0], dyn_rx_cnt[1], dyn_rx_cnt[2], dyn_rx_cnt[3] ));
+    FD_TEST( join_cnt ); FD_TEST( leave_cnt );
+    for( ulong rx_idx=0UL; rx_idx<DYN_RX_CNT; rx_idx++ ) FD_TEST( dyn_rx_cnt[ rx_idx ] );
+
+    FD_TEST( fd_fctl_delete( fd_fctl_leave( dyn ) )==dyn_shmem );
+  } while(0);
+
   fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
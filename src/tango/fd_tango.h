@@ -9,6 +9,10 @@
 #include "mcache/fd_mcache.h" /* Includes fd_tango_base.h */
 #include "dcache/fd_dcache.h" /* Includes fd_tango_base.h */
 #include "tcache/fd_tcache.h" /* Includes fd_tango_base.h */
+#include "bloom/fd_bloom.h"   /* Includes fd_tango_base.h */
+#include "rlimit/fd_rlimit.h" /* Includes fd_tango_base.h */
+#include "lhist/fd_lhist.h"   /* Includes cnc/fd_cnc.h */
+#include "trace/fd_trace.h"   /* Includes fd_tango_base.h */
 #include "aio/fd_aio.h"       /* Includes fd_tango_base.h */
 
 #endif /* HEADER_fd_src_tango_fd_tango_h */
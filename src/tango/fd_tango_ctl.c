@@ -721,6 +721,145 @@ main( int     argc,
       FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, gaddr ));
       SHIFT( 1 );
 
+    } else if( !strcmp( cmd, "new-trace" ) ) {
+
+      if( FD_UNLIKELY( argc<3 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * _wksp =                   argv[0];
+      ulong        depth = fd_cstr_to_ulong( argv[1] );
+      char const * name  =                   argv[2];
+
+      ulong align     = fd_trace_align();
+      ulong footprint = fd_trace_footprint( depth );
+      if( FD_UNLIKELY( !footprint ) )
+        FD_LOG_ERR(( "%i: %s: depth (%lu) must be a power-of-2 in [%lu,%lu]\n\tDo %s help for help",
+                     cnt, cmd, depth, FD_TRACE_DEPTH_MIN, FD_TRACE_DEPTH_MAX, bin ));
+
+      fd_wksp_t * wksp = fd_wksp_attach( _wksp );
+      if( FD_UNLIKELY( !wksp ) ) {
+        FD_LOG_ERR(( "%i: %s: fd_wksp_attach( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _wksp, bin ));
+      }
+
+      ulong gaddr = fd_wksp_alloc( wksp, align, footprint, tag );
+      if( FD_UNLIKELY( !gaddr ) ) {
+        fd_wksp_detach( wksp );
+        FD_LOG_ERR(( "%i: %s: fd_wksp_alloc( \"%s\", %lu, %lu, %lu ) failed\n\tDo %s help for help",
+                     cnt, cmd, _wksp, align, footprint, tag, bin ));
+      }
+
+      void * shmem = fd_wksp_laddr( wksp, gaddr );
+      if( FD_UNLIKELY( !shmem ) ) {
+        fd_wksp_free( wksp, gaddr );
+        fd_wksp_detach( wksp );
+        FD_LOG_ERR(( "%i: %s: fd_wksp_laddr( \"%s\", %lu ) failed\n\tDo %s help for help", cnt, cmd, _wksp, gaddr, bin ));
+      }
+
+      void * shtrace = fd_trace_new( shmem, depth, name );
+      if( FD_UNLIKELY( !shtrace ) ) {
+        fd_wksp_free( wksp, gaddr );
+        fd_wksp_detach( wksp );
+        FD_LOG_ERR(( "%i: %s: fd_trace_new( %s:%lu, %lu, \"%s\" ) failed\n\tDo %s help for help",
+                     cnt, cmd, _wksp, gaddr, depth, name, bin ));
+      }
+
+      char buf[ FD_WKSP_CSTR_MAX ];
+      printf( "%s\n", fd_wksp_cstr( wksp, gaddr, buf ) );
+
+      fd_wksp_detach( wksp );
+
+      FD_LOG_NOTICE(( "%i: %s %s %lu %s: success", cnt, cmd, _wksp, depth, name ));
+      SHIFT( 3 );
+
+    } else if( !strcmp( cmd, "delete-trace" ) ) {
+
+      if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * _shtrace = argv[0];
+
+      void * shtrace = fd_wksp_map( _shtrace );
+      if( FD_UNLIKELY( !shtrace ) )
+        FD_LOG_ERR(( "%i: %s: fd_wksp_map( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _shtrace, bin ));
+      if( FD_UNLIKELY( !fd_trace_delete( shtrace ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_trace_delete( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _shtrace, bin ));
+      fd_wksp_unmap( shtrace );
+
+      fd_wksp_cstr_free( _shtrace );
+
+      FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, _shtrace ));
+      SHIFT( 1 );
+
+    } else if( !strcmp( cmd, "query-trace" ) ) {
+
+      if( FD_UNLIKELY( argc<2 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * _shtrace =                 argv[0];
+      int          verbose  = fd_cstr_to_int( argv[1] );
+
+      void * shtrace = fd_wksp_map( _shtrace );
+      if( FD_UNLIKELY( !shtrace ) )
+        FD_LOG_ERR(( "%i: %s: fd_wksp_map( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _shtrace, bin ));
+
+      fd_trace_t const * trace = fd_trace_join( shtrace );
+      if( FD_UNLIKELY( !trace ) )
+        FD_LOG_ERR(( "%i: %s: fd_trace_join( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _shtrace, bin ));
+
+      ulong wr = fd_trace_wr( trace );
+      if( !verbose ) printf( "%lu\n", wr );
+      else {
+        printf( "trace %s\n", _shtrace );
+        printf( "\tname  %s\n",  fd_trace_name ( trace ) );
+        printf( "\tdepth %lu\n", fd_trace_depth( trace ) );
+        printf( "\twr    %lu\n", wr );
+        ulong depth = fd_trace_depth( trace );
+        for( ulong idx=wr-fd_ulong_min( wr, fd_ulong_min( depth-1UL, 16UL ) ); idx<wr; idx++ ) {
+          fd_trace_event_t event[1];
+          if( FD_UNLIKELY( !fd_trace_read( trace, idx, event ) ) ) continue;
+          printf( "\t%5lu: ts %20li id %-7s seq %20lu a0 %10u a1 %016lx\n",
+                  idx, event->ts, fd_trace_id_cstr( event->id ), event->seq, event->a0, event->a1 );
+        }
+      }
+
+      fd_wksp_unmap( fd_trace_leave( trace ) );
+
+      FD_LOG_NOTICE(( "%i: %s %s %i: success", cnt, cmd, _shtrace, verbose ));
+      SHIFT( 2 );
+
+    } else if( !strcmp( cmd, "export-trace" ) ) {
+
+      if( FD_UNLIKELY( argc<2 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * path     = argv[0];
+      char *       _shtrace = argv[1];
+
+      char * _tok[ 256 ];
+      ulong trace_cnt = fd_cstr_tokenize( _tok, 256UL, _shtrace, ',' ); /* argv is non-const */
+      if( FD_UNLIKELY( trace_cnt>256UL ) )
+        FD_LOG_ERR(( "%i: %s: too many traces for current implementation\n\tDo %s help for help", cnt, cmd, bin ));
+
+      fd_trace_t const * trace[ 256 ];
+      for( ulong trace_idx=0UL; trace_idx<trace_cnt; trace_idx++ ) {
+        void * shtrace = fd_wksp_map( _tok[ trace_idx ] );
+        if( FD_UNLIKELY( !shtrace ) )
+          FD_LOG_ERR(( "%i: %s: fd_wksp_map( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _tok[ trace_idx ], bin ));
+        trace[ trace_idx ] = fd_trace_join( shtrace );
+        if( FD_UNLIKELY( !trace[ trace_idx ] ) )
+          FD_LOG_ERR(( "%i: %s: fd_trace_join( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, _tok[ trace_idx ], bin ));
+      }
+
+      FILE * file = fopen( path, "w" );
+      if( FD_UNLIKELY( !file ) )
+        FD_LOG_ERR(( "%i: %s: fopen( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, path, bin ));
+
+      ulong event_cnt = fd_trace_export( file, trace, trace_cnt, fd_tempo_tick_per_ns( NULL ) );
+      if( FD_UNLIKELY( fclose( file ) ) ) event_cnt = ULONG_MAX;
+      if( FD_UNLIKELY( event_cnt==ULONG_MAX ) )
+        FD_LOG_ERR(( "%i: %s: fd_trace_export( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, path, bin ));
+
+      for( ulong trace_idx=trace_cnt; trace_idx; trace_idx-- ) fd_wksp_unmap( fd_trace_leave( trace[ trace_idx-1UL ] ) );
+
+      FD_LOG_NOTICE(( "%i: %s %s (%lu traces, %lu events): success", cnt, cmd, path, trace_cnt, event_cnt ));
+      SHIFT( 2 );
+
     } else {
 
       FD_LOG_ERR(( "%i: %s: unknown command\n\t"
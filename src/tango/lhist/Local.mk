@@ -0,0 +1,3 @@
+$(call add-hdrs,fd_lhist.h)
+$(call make-unit-test,test_lhist,test_lhist,fd_tango fd_util)
+$(call run-unit-test,test_lhist,)
@@ -0,0 +1,165 @@
+#ifndef HEADER_fd_src_tango_lhist_fd_lhist_h
+#define HEADER_fd_src_tango_lhist_fd_lhist_h
+
+/* lhist provides APIs for accumulating log-linear histograms of frag
+   latencies (e.g. now - tsorig and now - tspub as observed by a
+   consumer) into a flat array of counters suitable for placing in a
+   shared memory region (e.g. a consumer's cnc application region) and
+   remotely monitoring in a cheap way.
+
+   A histogram has FD_LHIST_BUCKET_CNT buckets.  Values in [0,SUB_CNT)
+   each get their own bucket.  Larger values are binned by octave (i.e.
+   the index of their most significant bit) with each octave split into
+   SUB_CNT equal width buckets.  Thus the relative resolution of a
+   bucket is 1/SUB_CNT (e.g. 25% for SUB_LG 2) regardless of magnitude
+   and binning a value is a handful of fast integer operations.  The
+   last bucket additionally accumulates all values too large to fit
+   anywhere else.
+
+   For BUCKET_CNT 128 and SUB_LG 2, the largest value binned exactly is
+   ~7*2^30 (~2.5 s at ~3 GHz ticks) and a histogram has a footprint of
+   1 KiB. */
+
+#include "../cnc/fd_cnc.h"
+
+#define FD_LHIST_SUB_LG     (2)
+#define FD_LHIST_SUB_CNT    (4UL)   /* ==1<<SUB_LG */
+#define FD_LHIST_BUCKET_CNT (128UL) /* multiple of SUB_CNT */
+
+/* FD_LHIST_{ALIGN,FOOTPRINT} specify the alignment and footprint of a
+   histogram (a FD_LHIST_BUCKET_CNT array of ulong counters). */
+
+#define FD_LHIST_ALIGN     (alignof(ulong))
+#define FD_LHIST_FOOTPRINT (FD_LHIST_BUCKET_CNT*sizeof(ulong))
+
+/* FD_LHIST_CNC_APP_{ORIG,PUB}_OFF specify the standard byte offsets in
+   a consumer tile's cnc application region where the tile, if the
+   region is at least FD_LHIST_CNC_APP_SZ bytes, accumulates a histogram
+   of the ticks between when it processed a frag and the frag's tsorig
+   and tspub respectively (i.e. the age of frags from origin and from
+   the most recent publication on arrival).  The histograms occupy the
+   region the standard cnc app region layout reserves for them (see
+   FD_CNC_DIAG_LHIST_* in fd_cnc.h) such that they don't interfere with
+   the standard or tile specific diagnostics.  These are updated by the
+   consumer tile frequently. */
+
+#define FD_LHIST_CNC_APP_ORIG_OFF (FD_CNC_DIAG_LHIST_OFF)
+#define FD_LHIST_CNC_APP_PUB_OFF  (FD_LHIST_CNC_APP_ORIG_OFF + FD_LHIST_FOOTPRINT)
+#define FD_LHIST_CNC_APP_SZ       (FD_LHIST_CNC_APP_PUB_OFF  + FD_LHIST_FOOTPRINT)
+
+FD_STATIC_ASSERT( FD_LHIST_CNC_APP_SZ==FD_CNC_DIAG_EXT_OFF, layout );
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_lhist_idx returns the index of the bucket that holds value v.
+   Result will be in [0,FD_LHIST_BUCKET_CNT). */
+
+FD_FN_CONST static inline ulong
+fd_lhist_idx( ulong v ) {
+  if( FD_UNLIKELY( v<FD_LHIST_SUB_CNT ) ) return v;
+  int   e   = fd_ulong_find_msb( v ); /* In [SUB_LG,64) */
+  ulong idx = ((ulong)(e-FD_LHIST_SUB_LG+1) << FD_LHIST_SUB_LG) + ((v >> (e-FD_LHIST_SUB_LG)) & (FD_LHIST_SUB_CNT-1UL));
+  return fd_ulong_min( idx, FD_LHIST_BUCKET_CNT-1UL );
+}
+
+/* fd_lhist_bucket_{lo,hi} return the range [lo,hi) of values held by
+   bucket idx.  Assumes idx is in [0,FD_LHIST_BUCKET_CNT).  As the last
+   bucket also holds all values too large for the other buckets,
+   fd_lhist_bucket_hi returns ULONG_MAX for it (and that is inclusive
+   for this bucket). */
+
+FD_FN_CONST static inline ulong
+fd_lhist_bucket_lo( ulong idx ) {
+  if( FD_UNLIKELY( idx<FD_LHIST_SUB_CNT ) ) return idx;
+  return (FD_LHIST_SUB_CNT + (idx & (FD_LHIST_SUB_CNT-1UL))) << ((idx >> FD_LHIST_SUB_LG)-1UL);
+}
+
+FD_FN_CONST static inline ulong
+fd_lhist_bucket_hi( ulong idx ) {
+  if( FD_UNLIKELY( idx>=FD_LHIST_BUCKET_CNT-1UL ) ) return ULONG_MAX;
+  return fd_lhist_bucket_lo( idx+1UL );
+}
+
+/* fd_lhist_sample bins value v into histogram hist.  Assumes hist is a
+   current local address of a histogram.  This is not atomic (it is
+   assumed that there is a single writer per histogram and that readers
+   can tolerate slightly inconsistent snapshots as is usual for
+   diagnostics). */
+
+static inline void
+fd_lhist_sample( ulong * hist,
+                 ulong   v ) {
+  hist[ fd_lhist_idx( v ) ]++;
+}
+
+/* fd_lhist_ts_lat returns the number of ticks between now and the
+   compressed frag timestamp ts (e.g. a fd_frag_meta_t tsorig or
+   tspub).  now should be within ~2^31 ticks of when ts was compressed.
+   Clock skew that makes ts appear to be in the future is treated as a
+   zero latency. */
+
+FD_FN_CONST static inline ulong
+fd_lhist_ts_lat( ulong ts,
+                 long  now ) {
+  return (ulong)fd_long_max( now - fd_frag_meta_ts_decomp( ts, now ), 0L );
+}
+
+/* fd_lhist_cnt returns the total number of values binned in hist. */
+
+FD_FN_PURE static inline ulong
+fd_lhist_cnt( ulong const * hist ) {
+  ulong cnt = 0UL;
+  for( ulong idx=0UL; idx<FD_LHIST_BUCKET_CNT; idx++ ) cnt += hist[ idx ];
+  return cnt;
+}
+
+/* fd_lhist_rank_idx returns the index of the bucket holding the rank-th
+   smallest value (0 indexed) binned in hist.  If rank is not less than
+   fd_lhist_cnt( hist ), returns FD_LHIST_BUCKET_CNT. */
+
+FD_FN_PURE static inline ulong
+fd_lhist_rank_idx( ulong const * hist,
+                   ulong         rank ) {
+  ulong cum = 0UL;
+  for( ulong idx=0UL; idx<FD_LHIST_BUCKET_CNT; idx++ ) {
+    cum += hist[ idx ];
+    if( rank<cum ) return idx;
+  }
+  return FD_LHIST_BUCKET_CNT;
+}
+
+/* fd_lhist_quantile returns the index of the bucket holding the value
+   at quantile q (in [0,1], e.g. 0.99 for the 99-th percentile) of the
+   cnt values binned in hist.  Specifically, the value at quantile q is
+   the rank floor(q*(cnt-1)) smallest value.  Returns
+   FD_LHIST_BUCKET_CNT if hist is empty. */
+
+static inline ulong
+fd_lhist_quantile( ulong const * hist,
+                   double        q ) {
+  ulong cnt = fd_lhist_cnt( hist );
+  if( FD_UNLIKELY( !cnt ) ) return FD_LHIST_BUCKET_CNT;
+  ulong rank = fd_ulong_min( (ulong)(q*(double)(cnt-1UL)), cnt-1UL );
+  return fd_lhist_rank_idx( hist, rank );
+}
+
+/* fd_lhist_cnc_{orig,pub} return the location of the standard tsorig
+   and tspub latency histograms in cnc's application region.  Returns
+   NULL if the cnc's application region is too small to hold them.
+   Assumes cnc is a current local join. */
+
+FD_FN_PURE static inline ulong *
+fd_lhist_cnc_orig( fd_cnc_t * cnc ) {
+  if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<FD_LHIST_CNC_APP_SZ ) ) return NULL;
+  return (ulong *)((ulong)fd_cnc_app_laddr( cnc ) + FD_LHIST_CNC_APP_ORIG_OFF);
+}
+
+FD_FN_PURE static inline ulong *
+fd_lhist_cnc_pub( fd_cnc_t * cnc ) {
+  if( FD_UNLIKELY( fd_cnc_app_sz( cnc )<FD_LHIST_CNC_APP_SZ ) ) return NULL;
+  return (ulong *)((ulong)fd_cnc_app_laddr( cnc ) + FD_LHIST_CNC_APP_PUB_OFF);
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_tango_lhist_fd_lhist_h */
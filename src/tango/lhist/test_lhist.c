@@ -0,0 +1,146 @@
+#include "../fd_tango.h"
+
+FD_STATIC_ASSERT( FD_LHIST_SUB_LG==2,                                    unit_test );
+FD_STATIC_ASSERT( FD_LHIST_SUB_CNT==(1UL<<FD_LHIST_SUB_LG),              unit_test );
+FD_STATIC_ASSERT( FD_LHIST_BUCKET_CNT==128UL,                            unit_test );
+FD_STATIC_ASSERT( FD_LHIST_FOOTPRINT==1024UL,                            unit_test );
+FD_STATIC_ASSERT( FD_LHIST_CNC_APP_ORIG_OFF==FD_CNC_DIAG_LHIST_OFF,                    unit_test );
+FD_STATIC_ASSERT( FD_LHIST_CNC_APP_PUB_OFF ==FD_CNC_DIAG_LHIST_OFF+FD_LHIST_FOOTPRINT, unit_test );
+FD_STATIC_ASSERT( FD_LHIST_CNC_APP_SZ     ==FD_CNC_DIAG_EXT_OFF,                       unit_test );
+
+#define SAMPLE_MAX (65535UL) /* odd */
+
+static ulong x  [ SAMPLE_MAX ];
+static ulong tmp[ SAMPLE_MAX ];
+
+/* Check that the exact rank-th smallest value of x (computed by fd_stat
+   and fd_sort) is held by the bucket fd_lhist says holds it */
+
+static void
+test_rank( ulong const * hist,
+           ulong         cnt,
+           ulong         rank ) {
+  ulong exact;
+  if( (cnt & 1UL) && rank==(cnt>>1) ) {
+    for( ulong i=0UL; i<cnt; i++ ) tmp[i] = x[i];
+    exact = fd_stat_median_ulong( tmp, cnt );
+  } else {
+    for( ulong i=0UL; i<cnt; i++ ) tmp[i] = x[i];
+    exact = fd_sort_up_ulong_select( tmp, cnt, rank )[ rank ];
+  }
+  ulong idx = fd_lhist_rank_idx( hist, rank );
+  FD_TEST( idx<FD_LHIST_BUCKET_CNT );
+  FD_TEST( fd_lhist_bucket_lo( idx )<=exact );
+  FD_TEST( (idx==FD_LHIST_BUCKET_CNT-1UL) || (exact<fd_lhist_bucket_hi( idx )) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Test bucket geometry */
+
+  FD_TEST( fd_lhist_bucket_lo( 0UL )==0UL );
+  for( ulong idx=0UL; idx<FD_LHIST_BUCKET_CNT; idx++ ) {
+    ulong lo = fd_lhist_bucket_lo( idx );
+    ulong hi = fd_lhist_bucket_hi( idx );
+    FD_TEST( lo<hi );
+    FD_TEST( fd_lhist_idx( lo )==idx );
+    if( idx<FD_LHIST_BUCKET_CNT-1UL ) {
+      FD_TEST( fd_lhist_idx( hi-1UL )==idx );
+      FD_TEST( fd_lhist_idx( hi     )==idx+1UL );
+      FD_TEST( (hi-lo)*FD_LHIST_SUB_CNT<=fd_ulong_max( lo, FD_LHIST_SUB_CNT ) ); /* relative resolution */
+    }
+  }
+  FD_TEST( fd_lhist_bucket_hi( FD_LHIST_BUCKET_CNT-1UL )==ULONG_MAX );
+  FD_TEST( fd_lhist_idx( ULONG_MAX )==FD_LHIST_BUCKET_CNT-1UL );
+
+  /* Test binning exhaustively for small values and randomly for values
+     of all magnitudes */
+
+  ulong last_idx = 0UL;
+  for( ulong v=0UL; v<(1UL<<20); v++ ) {
+    ulong idx = fd_lhist_idx( v );
+    FD_TEST( idx==last_idx || idx==last_idx+1UL );
+    FD_TEST( fd_lhist_bucket_lo( idx )<=v && v<fd_lhist_bucket_hi( idx ) );
+    last_idx = idx;
+  }
+
+  for( ulong iter=0UL; iter<10000000UL; iter++ ) {
+    ulong v   = fd_rng_ulong( rng ) >> fd_rng_uint_roll( rng, 64U );
+    ulong idx = fd_lhist_idx( v );
+    FD_TEST( idx<FD_LHIST_BUCKET_CNT );
+    FD_TEST( fd_lhist_bucket_lo( idx )<=v );
+    FD_TEST( (idx==FD_LHIST_BUCKET_CNT-1UL) || (v<fd_lhist_bucket_hi( idx )) );
+  }
+
+  /* Test timestamp latency computation */
+
+  for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+    long  now = (long)(fd_rng_ulong( rng ) >> 2);
+    long  lat = (long)(fd_rng_uint( rng ) >> 2) - (1L<<20);
+    ulong ts  = fd_frag_meta_ts_comp( now - lat );
+    FD_TEST( fd_lhist_ts_lat( ts, now )==(ulong)fd_long_max( lat, 0L ) );
+  }
+
+  /* Test quantiles against fd_stat */
+
+  ulong hist[ FD_LHIST_BUCKET_CNT ];
+
+  fd_memset( hist, 0, FD_LHIST_FOOTPRINT );
+  FD_TEST( !fd_lhist_cnt( hist ) );
+  FD_TEST( fd_lhist_rank_idx( hist, 0UL )==FD_LHIST_BUCKET_CNT );
+  FD_TEST( fd_lhist_quantile( hist, 0.5 )==FD_LHIST_BUCKET_CNT );
+
+  for( ulong trial=0UL; trial<100UL; trial++ ) {
+    ulong cnt = 1UL + 2UL*(ulong)fd_rng_uint_roll( rng, (uint)(SAMPLE_MAX/2UL) ); /* odd */
+
+    /* Model a latency distribution with a body and a long tail */
+    ulong body = 1UL << fd_rng_uint_roll( rng, 20U );
+    fd_memset( hist, 0, FD_LHIST_FOOTPRINT );
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ulong v = body + fd_rng_ulong_roll( rng, body );
+      if( !fd_rng_uint_roll( rng, 100U ) ) v <<= fd_rng_uint_roll( rng, 16U );
+      x[i] = v;
+      fd_lhist_sample( hist, v );
+    }
+    FD_TEST( fd_lhist_cnt( hist )==cnt );
+
+    test_rank( hist, cnt, cnt>>1 );
+    test_rank( hist, cnt, (ulong)(0.99 *(double)(cnt-1UL)) );
+    test_rank( hist, cnt, (ulong)(0.999*(double)(cnt-1UL)) );
+    test_rank( hist, cnt, 0UL     );
+    test_rank( hist, cnt, cnt-1UL );
+
+    FD_TEST( fd_lhist_quantile( hist, 0.  )==fd_lhist_rank_idx( hist, 0UL     ) );
+    FD_TEST( fd_lhist_quantile( hist, 1.  )==fd_lhist_rank_idx( hist, cnt-1UL ) );
+    FD_TEST( fd_lhist_quantile( hist, 0.5 )==fd_lhist_rank_idx( hist, cnt>>1  ) );
+    FD_TEST( fd_lhist_rank_idx( hist, cnt )==FD_LHIST_BUCKET_CNT );
+  }
+
+  /* Test cnc integration */
+
+  static uchar __attribute__((aligned(FD_CNC_ALIGN))) shmem[ FD_CNC_FOOTPRINT( FD_LHIST_CNC_APP_SZ ) ];
+
+  fd_cnc_t * cnc = fd_cnc_join( fd_cnc_new( shmem, FD_LHIST_CNC_APP_SZ-1UL, 0UL, 0L ) ); FD_TEST( cnc );
+  FD_TEST( !fd_lhist_cnc_orig( cnc ) );
+  FD_TEST( !fd_lhist_cnc_pub ( cnc ) );
+  FD_TEST( fd_cnc_delete( fd_cnc_leave( cnc ) )==shmem );
+
+  cnc = fd_cnc_join( fd_cnc_new( shmem, FD_LHIST_CNC_APP_SZ, 0UL, 0L ) ); FD_TEST( cnc );
+  ulong * orig = fd_lhist_cnc_orig( cnc );
+  ulong * pub  = fd_lhist_cnc_pub ( cnc );
+  FD_TEST( (ulong)orig==(ulong)fd_cnc_app_laddr( cnc ) + FD_LHIST_CNC_APP_ORIG_OFF );
+  FD_TEST( (ulong)pub ==(ulong)fd_cnc_app_laddr( cnc ) + FD_LHIST_CNC_APP_PUB_OFF  );
+  FD_TEST( !fd_lhist_cnt( orig ) && !fd_lhist_cnt( pub ) ); /* cnc_new clears the app region */
+  FD_TEST( fd_cnc_delete( fd_cnc_leave( cnc ) )==shmem );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,6 @@
+$(call add-hdrs,fd_rlimit_bucket.h fd_rlimit.h)
+$(call add-objs,fd_rlimit,fd_tango)
+$(call make-unit-test,test_rlimit,test_rlimit,fd_tango fd_util)
+$(call run-unit-test,test_rlimit)
+
+$(call make-unit-test,bench_rlimit,bench_rlimit,fd_tango fd_util)
@@ -0,0 +1,136 @@
+#include "../fd_tango.h"
+
+/* bench_rlimit measures the throughput of an rlimit on a stream of
+   source addresses resembling a spam event: a --heavy-frac fraction of
+   packets come from --heavy-cnt flooding sources and the rest are
+   uniformly spread over --src-cnt other sources.  Packets arrive at
+   --pkt-rate packets per second in bursts of --burst-max (as received
+   by an ingress tile), with one tickcount observation per burst.  It
+   reports throughput for individual takes and for takes with the
+   burst's sets prefetched up front, along with the fraction of each
+   class of traffic that passed. */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz   = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",    NULL, "gigantic"                   );
+  ulong        page_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",   NULL, 1UL                          );
+  ulong        numa_idx   = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",   NULL, fd_shmem_numa_idx( cpu_idx ) );
+  ulong        set_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--set-cnt",    NULL, 1UL<<16                      );
+  ulong        src_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--src-cnt",    NULL, 100000UL                     );
+  ulong        heavy_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--heavy-cnt",  NULL, 16UL                         );
+  float        heavy_frac = fd_env_strip_cmdline_float( &argc, &argv, "--heavy-frac", NULL, 0.9f                         );
+  float        rate       = fd_env_strip_cmdline_float( &argc, &argv, "--rate",       NULL, 1000.f                       );
+  ulong        burst      = fd_env_strip_cmdline_ulong( &argc, &argv, "--burst",      NULL, 64UL                         );
+  float        pkt_rate   = fd_env_strip_cmdline_float( &argc, &argv, "--pkt-rate",   NULL, 10e6f                        );
+  ulong        burst_max  = fd_env_strip_cmdline_ulong( &argc, &argv, "--burst-max",  NULL, 64UL                         );
+  ulong        pkt_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-cnt",    NULL, 1UL<<24                      );
+
+  if( FD_UNLIKELY( !fd_rlimit_footprint( set_cnt ) ) ) FD_LOG_ERR(( "bad --set-cnt" ));
+  if( FD_UNLIKELY( (!src_cnt) | (!heavy_cnt)       ) ) FD_LOG_ERR(( "--src-cnt and --heavy-cnt should be positive" ));
+  if( FD_UNLIKELY( (!burst_max) | (!pkt_cnt)       ) ) FD_LOG_ERR(( "--burst-max and --pkt-cnt should be positive" ));
+  if( FD_UNLIKELY( !(rate>0.f) || !(pkt_rate>0.f)  ) ) FD_LOG_ERR(( "--rate and --pkt-rate should be positive" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp =
+    fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  uint *  addr  = (uint  *)fd_wksp_alloc_laddr( wksp, 0UL, pkt_cnt*sizeof(uint), 1UL );
+  uchar * heavy = (uchar *)fd_wksp_alloc_laddr( wksp, 0UL, pkt_cnt,              1UL );
+  uchar * pass  = (uchar *)fd_wksp_alloc_laddr( wksp, 0UL, pkt_cnt,              1UL );
+  void *  mem   =          fd_wksp_alloc_laddr( wksp, fd_rlimit_align(), fd_rlimit_footprint( set_cnt ), 1UL );
+  if( FD_UNLIKELY( (!addr) | (!heavy) | (!pass) | (!mem) ) ) FD_LOG_ERR(( "--pkt-cnt and/or --set-cnt too large for workspace" ));
+
+  /* Make the address stream.  Source i's address is the low 32 bits of
+     fd_ulong_hash(i) (heavy sources are the first heavy_cnt). */
+
+  FD_LOG_NOTICE(( "Generating stream (--pkt-cnt %lu --src-cnt %lu --heavy-cnt %lu --heavy-frac %.3f)",
+                  pkt_cnt, src_cnt, heavy_cnt, (double)heavy_frac ));
+
+  double _heavy_thresh = 0.5 + (double)heavy_frac*(double)(1UL<<32);
+  uint   heavy_thresh  = _heavy_thresh<(double)UINT_MAX ? (uint)_heavy_thresh : UINT_MAX;
+  for( ulong pkt_idx=0UL; pkt_idx<pkt_cnt; pkt_idx++ ) {
+    int is_heavy = fd_rng_uint( rng )<heavy_thresh;
+    ulong src = is_heavy ? fd_rng_ulong_roll( rng, heavy_cnt ) : heavy_cnt + fd_rng_ulong_roll( rng, src_cnt );
+    addr [ pkt_idx ] = (uint)fd_ulong_hash( src );
+    heavy[ pkt_idx ] = (uchar)is_heavy;
+  }
+
+  /* The packet stream is replayed in real time at pkt_rate (i.e. the
+     rate limiter sees time advance by burst_max/pkt_rate between
+     bursts, independent of how fast the benchmark runs). */
+
+  double tick_per_ns    = fd_tempo_tick_per_ns( NULL );
+  ulong  interval       = fd_rlimit_rate_to_interval( 1e9*tick_per_ns, (double)rate );
+  ulong  tick_per_burst = (ulong)(1e9*tick_per_ns*(double)burst_max/(double)pkt_rate + 0.5);
+
+  FD_LOG_NOTICE(( "Benchmarking (--set-cnt %lu --rate %.1f --burst %lu --pkt-rate %.3e --burst-max %lu; interval %lu ticks)",
+                  set_cnt, (double)rate, burst, (double)pkt_rate, burst_max, interval ));
+
+  for( int pf=0; pf<2; pf++ ) {
+    fd_rlimit_t * rlimit = fd_rlimit_join( fd_rlimit_new( mem, set_cnt, interval, burst, fd_rng_ulong( rng ) ) ); FD_TEST( rlimit );
+
+    ulong now = (ulong)fd_tickcount();
+    long  dt  = -fd_log_wallclock();
+    for( ulong pkt_off=0UL; pkt_off<pkt_cnt; pkt_off+=burst_max ) {
+      ulong cnt = fd_ulong_min( pkt_cnt-pkt_off, burst_max );
+      uint const * a = addr + pkt_off;
+      uchar *      p = pass + pkt_off;
+      now += tick_per_burst;
+      if( pf ) for( ulong i=0UL; i<cnt; i++ ) fd_rlimit_prefetch( rlimit, a[i] );
+      for( ulong i=0UL; i<cnt; i++ ) p[i] = (uchar)fd_rlimit_take( rlimit, a[i], now );
+    }
+    dt += fd_log_wallclock();
+
+    ulong heavy_tx = 0UL; ulong heavy_rx = 0UL;
+    ulong light_tx = 0UL; ulong light_rx = 0UL;
+    for( ulong pkt_idx=0UL; pkt_idx<pkt_cnt; pkt_idx++ ) {
+      if( heavy[ pkt_idx ] ) { heavy_tx++; heavy_rx += (ulong)pass[ pkt_idx ]; }
+      else                   { light_tx++; light_rx += (ulong)pass[ pkt_idx ]; }
+    }
+    FD_TEST( fd_rlimit_pass_cnt( rlimit )==heavy_rx+light_rx );
+
+    FD_LOG_NOTICE(( "%-16s: %8.3f Mpkt/s, %7.3f ns/pkt, heavy pass %.3e, light pass %.5f, evict %lu",
+                    pf ? "rlimit (prefetch)" : "rlimit",
+                    1e3*((double)pkt_cnt)/((double)dt), ((double)dt)/((double)pkt_cnt),
+                    ((double)heavy_rx)/((double)fd_ulong_max( heavy_tx, 1UL )),
+                    ((double)light_rx)/((double)fd_ulong_max( light_tx, 1UL )),
+                    fd_rlimit_evict_cnt( rlimit ) ));
+
+    FD_TEST( fd_rlimit_delete( fd_rlimit_leave( rlimit ) )==mem );
+  }
+
+  fd_wksp_free_laddr( mem   );
+  fd_wksp_free_laddr( pass  );
+  fd_wksp_free_laddr( heavy );
+  fd_wksp_free_laddr( addr  );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
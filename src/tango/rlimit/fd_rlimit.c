@@ -0,0 +1,157 @@
+#include "fd_rlimit.h"
+
+FD_STATIC_ASSERT( FD_RLIMIT_SET_WAY_CNT*sizeof(fd_rlimit_entry_t)==FD_RLIMIT_SET_SZ, layout );
+FD_STATIC_ASSERT( sizeof(fd_rlimit_t)==FD_RLIMIT_ALIGN,                             layout );
+
+ulong
+fd_rlimit_align( void ) {
+  return FD_RLIMIT_ALIGN;
+}
+
+ulong
+fd_rlimit_footprint( ulong set_cnt ) {
+  if( FD_UNLIKELY( (!fd_ulong_is_pow2( set_cnt )) | (set_cnt>FD_RLIMIT_SET_CNT_MAX) ) ) return 0UL; /* Invalid set_cnt */
+  return FD_RLIMIT_FOOTPRINT( set_cnt ); /* no overflow (<=2^38) */
+}
+
+/* fd_rlimit_private_cfg_is_valid returns 1 if interval and burst are a
+   valid rate limit and 0 otherwise. */
+
+static int
+fd_rlimit_private_cfg_is_valid( ulong interval,
+                                ulong burst ) {
+  return (!!interval) & (!!burst) && ((burst-1UL) <= ((ulong)LONG_MAX)/interval);
+}
+
+void *
+fd_rlimit_new( void * shmem,
+               ulong  set_cnt,
+               ulong  interval,
+               ulong  burst,
+               ulong  seed ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_rlimit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_rlimit_footprint( set_cnt );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad set_cnt (%lu)", set_cnt ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_rlimit_private_cfg_is_valid( interval, burst ) ) ) {
+    FD_LOG_WARNING(( "bad interval (%lu) and/or burst (%lu)", interval, burst ));
+    return NULL;
+  }
+
+  fd_memset( shmem, 0, footprint );
+
+  fd_rlimit_t * rlimit = (fd_rlimit_t *)shmem;
+
+  rlimit->set_cnt  = set_cnt;
+  rlimit->seed     = seed;
+  rlimit->interval = interval;
+  rlimit->tol      = (burst-1UL)*interval;
+  rlimit->burst    = burst;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rlimit->magic ) = FD_RLIMIT_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_rlimit_t *
+fd_rlimit_join( void * _rlimit ) {
+
+  if( FD_UNLIKELY( !_rlimit ) ) {
+    FD_LOG_WARNING(( "NULL _rlimit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)_rlimit, fd_rlimit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned _rlimit" ));
+    return NULL;
+  }
+
+  fd_rlimit_t * rlimit = (fd_rlimit_t *)_rlimit;
+  if( FD_UNLIKELY( rlimit->magic!=FD_RLIMIT_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return rlimit;
+}
+
+void *
+fd_rlimit_leave( fd_rlimit_t * rlimit ) {
+
+  if( FD_UNLIKELY( !rlimit ) ) {
+    FD_LOG_WARNING(( "NULL rlimit" ));
+    return NULL;
+  }
+
+  return (void *)rlimit;
+}
+
+void *
+fd_rlimit_delete( void * _rlimit ) {
+
+  if( FD_UNLIKELY( !_rlimit ) ) {
+    FD_LOG_WARNING(( "NULL _rlimit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)_rlimit, fd_rlimit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned _rlimit" ));
+    return NULL;
+  }
+
+  fd_rlimit_t * rlimit = (fd_rlimit_t *)_rlimit;
+  if( FD_UNLIKELY( rlimit->magic != FD_RLIMIT_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( rlimit->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return _rlimit;
+}
+
+fd_rlimit_t *
+fd_rlimit_cfg( fd_rlimit_t * rlimit,
+               ulong         interval,
+               ulong         burst ) {
+
+  if( FD_UNLIKELY( !rlimit ) ) {
+    FD_LOG_WARNING(( "NULL rlimit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_rlimit_private_cfg_is_valid( interval, burst ) ) ) {
+    FD_LOG_WARNING(( "bad interval (%lu) and/or burst (%lu)", interval, burst ));
+    return NULL;
+  }
+
+  rlimit->interval = interval;
+  rlimit->tol      = (burst-1UL)*interval;
+  rlimit->burst    = burst;
+  return rlimit;
+}
+
+void
+fd_rlimit_reset( fd_rlimit_t * rlimit ) {
+  fd_memset( (uchar *)rlimit + FD_RLIMIT_ALIGN, 0, rlimit->set_cnt*FD_RLIMIT_SET_SZ );
+  rlimit->pass_cnt  = 0UL;
+  rlimit->drop_cnt  = 0UL;
+  rlimit->evict_cnt = 0UL;
+}
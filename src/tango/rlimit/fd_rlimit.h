@@ -0,0 +1,267 @@
+#ifndef HEADER_fd_src_tango_rlimit_fd_rlimit_h
+#define HEADER_fd_src_tango_rlimit_fd_rlimit_h
+
+/* A fd_rlimit_t rate limits traffic per IPv4 source address.  It keeps
+   a token bucket (see fd_rlimit_bucket.h) for each of the most recently
+   seen source addresses in a fixed size hash table such that a handful
+   of sources flooding the ingress can't crowd out everybody else.
+   Every source gets the same configured rate and burst.
+
+   The table is set associative: an address hashes to one of set_cnt
+   sets of FD_RLIMIT_SET_WAY_CNT entries (a set is a single cache line
+   so a lookup touches one cache line).  Entries within a set are kept
+   in most recently used order.  When a packet from an address not in
+   its set arrives, the least recently used entry of the set is evicted
+   and the new address starts with a full bucket.  Since a flooding
+   source is by definition recently used, it can only lose its (empty)
+   bucket if FD_RLIMIT_SET_WAY_CNT other sources hashing to the same set
+   have been seen more recently.  The hash is seeded such that remote
+   senders can't easily aim addresses at a particular set.  The table
+   should be sized such that the number of concurrently active sources
+   is comfortably less than the number of entries.
+
+   Like the tcache, it is strongly recommended that the rlimit be backed
+   by a single NUMA page (e.g. in a gigantic page backed workspace) if
+   used in performance critical contexts.  An rlimit is not safe for
+   concurrent use (use one per tile, as with the per-CPU map in the XDP
+   program). */
+
+#include "fd_rlimit_bucket.h"
+
+/* FD_RLIMIT_SET_WAY_CNT is the number of entries in a set.  A set is
+   FD_RLIMIT_SET_SZ bytes (one cache line). */
+
+#define FD_RLIMIT_SET_WAY_CNT (4UL)
+#define FD_RLIMIT_SET_SZ      (64UL)
+
+/* FD_RLIMIT_SET_CNT_MAX is the maximum number of sets */
+
+#define FD_RLIMIT_SET_CNT_MAX (1UL<<32)
+
+/* FD_RLIMIT_{ALIGN,FOOTPRINT} specify the alignment and footprint
+   needed for an rlimit with set_cnt sets.  ALIGN is at least double
+   cache line to mitigate various kinds of false sharing.  set_cnt is
+   assumed to be valid (i.e. an integer power of 2 in
+   [1,FD_RLIMIT_SET_CNT_MAX]).  These are provided to facilitate compile
+   time declarations. */
+
+#define FD_RLIMIT_ALIGN (128UL)
+#define FD_RLIMIT_FOOTPRINT( set_cnt ) (FD_RLIMIT_ALIGN + (set_cnt)*FD_RLIMIT_SET_SZ)
+
+/* fd_rlimit_entry_t is an entry in an rlimit set.  key is 0 if the
+   entry is unused and the source address with FD_RLIMIT_PRIVATE_KEY_USED
+   set otherwise.  tat is the theoretical arrival time of the source's
+   bucket. */
+
+#define FD_RLIMIT_PRIVATE_KEY_USED (1UL<<32)
+
+struct fd_rlimit_entry {
+  ulong key;
+  ulong tat;
+};
+
+typedef struct fd_rlimit_entry fd_rlimit_entry_t;
+
+/* fd_rlimit_t is an opaque handle of an rlimit object.  Details are
+   exposed here to facilitate usage of rlimit in performance critical
+   contexts. */
+
+#define FD_RLIMIT_MAGIC (0xf17eda2c3721a170UL) /* firedancer rlimit ver 0 */
+
+struct __attribute((aligned(FD_RLIMIT_ALIGN))) fd_rlimit_private {
+  ulong magic;     /* ==FD_RLIMIT_MAGIC */
+  ulong set_cnt;   /* Number of sets, power of 2 */
+  ulong seed;      /* Hash seed */
+  ulong interval;  /* Time units per token, positive */
+  ulong tol;       /* ==(burst-1)*interval */
+  ulong burst;     /* Max tokens in a bucket, positive */
+
+  /* Statistics (monotonically increasing since new or reset) */
+
+  ulong pass_cnt;  /* Number of packets that got a token */
+  ulong drop_cnt;  /* Number of packets that were rate limited */
+  ulong evict_cnt; /* Number of sources evicted from the table to make room for another */
+
+  /* Padding to FD_RLIMIT_ALIGN */
+
+  /* set_cnt sets of FD_RLIMIT_SET_WAY_CNT fd_rlimit_entry_t (set) */
+};
+
+typedef struct fd_rlimit_private fd_rlimit_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_rlimit_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as an rlimit.
+   fd_rlimit_align returns FD_RLIMIT_ALIGN.  If set_cnt is not an
+   integer power of 2 in [1,FD_RLIMIT_SET_CNT_MAX], footprint will
+   silently return 0 (and thus can be used by the caller to validate the
+   rlimit configuration parameters).  Otherwise, it returns
+   FD_RLIMIT_FOOTPRINT. */
+
+FD_FN_CONST ulong
+fd_rlimit_align( void );
+
+FD_FN_CONST ulong
+fd_rlimit_footprint( ulong set_cnt );
+
+/* fd_rlimit_new formats an unused memory region for use as an rlimit.
+   shmem is a non-NULL pointer to this region in the local address space
+   with the required footprint and alignment.  set_cnt is as described
+   above.  interval and burst are the initial rate limit (see
+   fd_rlimit_cfg).  seed is an arbitrary value used to seed the address
+   hash (should be unpredictable to remote senders).
+
+   Returns shmem (and the memory region it points to will be formatted
+   as an rlimit, caller is not joined, rlimit will be empty) on success
+   and NULL on failure (logs details).  Reasons for failure include
+   obviously bad shmem, bad set_cnt or bad interval / burst. */
+
+void *
+fd_rlimit_new( void * shmem,
+               ulong  set_cnt,
+               ulong  interval,
+               ulong  burst,
+               ulong  seed );
+
+/* fd_rlimit_join joins the caller to the rlimit.  _rlimit points to the
+   first byte of the memory region backing the rlimit in the caller's
+   address space.  Returns a pointer in the local address space to the
+   rlimit on success and NULL on failure (logs details).  Every
+   successful join should have a matching leave. */
+
+fd_rlimit_t *
+fd_rlimit_join( void * _rlimit );
+
+/* fd_rlimit_leave leaves a current local join.  Returns a pointer to
+   the underlying shared memory region on success and NULL on failure
+   (logs details).  Reasons for failure include rlimit is NULL. */
+
+void *
+fd_rlimit_leave( fd_rlimit_t * rlimit );
+
+/* fd_rlimit_delete unformats a memory region used as an rlimit.
+   Assumes nobody is joined to the region.  Returns a pointer to the
+   underlying shared memory region or NULL if used obviously in error
+   (e.g. _rlimit obviously does not point to an rlimit ... logs
+   details).  The ownership of the memory region is transferred to the
+   caller on success. */
+
+void *
+fd_rlimit_delete( void * _rlimit );
+
+/* fd_rlimit_rate_to_interval returns the interval (time units per
+   token) for a rate of rate tokens per second given a clock of
+   tick_per_s time units per second (e.g. fd_tempo_tick_per_ns( NULL )*
+   1e9 for fd_tickcount or 1e9 for ns).  The result is rounded to
+   nearest and at least 1. */
+
+FD_FN_CONST static inline ulong
+fd_rlimit_rate_to_interval( double tick_per_s,
+                            double rate ) {
+  double interval = tick_per_s / rate + 0.5;
+  return fd_ulong_max( (interval<(double)(1UL<<62)) ? (ulong)interval : (1UL<<62), 1UL );
+}
+
+/* fd_rlimit_cfg sets the rate limit of every source to one token per
+   interval time units with buckets holding at most burst tokens.
+   interval should be positive and burst should be in
+   [1,LONG_MAX/interval].  The new limit applies from the next packet
+   of each source on (existing buckets are not refilled or emptied).
+   Returns rlimit on success and NULL on failure (logs details, rlimit
+   unchanged).  Assumes rlimit is a current local join. */
+
+fd_rlimit_t *
+fd_rlimit_cfg( fd_rlimit_t * rlimit,
+               ulong         interval,
+               ulong         burst );
+
+/* Accessors.  Assumes rlimit is a current local join. */
+
+FD_FN_PURE static inline ulong fd_rlimit_set_cnt  ( fd_rlimit_t const * rlimit ) { return rlimit->set_cnt;   }
+FD_FN_PURE static inline ulong fd_rlimit_seed     ( fd_rlimit_t const * rlimit ) { return rlimit->seed;      }
+FD_FN_PURE static inline ulong fd_rlimit_interval ( fd_rlimit_t const * rlimit ) { return rlimit->interval;  }
+FD_FN_PURE static inline ulong fd_rlimit_burst    ( fd_rlimit_t const * rlimit ) { return rlimit->burst;     }
+FD_FN_PURE static inline ulong fd_rlimit_pass_cnt ( fd_rlimit_t const * rlimit ) { return rlimit->pass_cnt;  }
+FD_FN_PURE static inline ulong fd_rlimit_drop_cnt ( fd_rlimit_t const * rlimit ) { return rlimit->drop_cnt;  }
+FD_FN_PURE static inline ulong fd_rlimit_evict_cnt( fd_rlimit_t const * rlimit ) { return rlimit->evict_cnt; }
+
+/* fd_rlimit_reset forgets all sources (i.e. every source starts over
+   with a full bucket) and zeros the statistics.  Assumes rlimit is a
+   current local join.  This is O(footprint) and not intended to be used
+   in performance critical contexts. */
+
+void
+fd_rlimit_reset( fd_rlimit_t * rlimit );
+
+/* fd_rlimit_private_set returns the location of the set for source
+   address addr in the caller's address space. */
+
+FD_FN_PURE static inline fd_rlimit_entry_t *
+fd_rlimit_private_set( fd_rlimit_t const * rlimit,
+                       uint                addr ) {
+  ulong set_idx = fd_ulong_hash( rlimit->seed ^ (ulong)addr ) & (rlimit->set_cnt-1UL);
+  return (fd_rlimit_entry_t *)((ulong)rlimit + FD_RLIMIT_ALIGN + set_idx*FD_RLIMIT_SET_SZ);
+}
+
+/* fd_rlimit_take takes a token from source address addr's bucket at
+   time now.  Returns 1 if the packet is within the rate limit (a token
+   was taken) and 0 if it should be dropped.  A source not in the table
+   is added with a full bucket (evicting the set's least recently used
+   source if necessary).  Updates the statistics.  Assumes rlimit is a
+   current local join and that now is monotonically non-decreasing
+   between calls (in the wrapping sense). */
+
+static inline int
+fd_rlimit_take( fd_rlimit_t * rlimit,
+                uint          addr,
+                ulong         now ) {
+  fd_rlimit_entry_t * set = fd_rlimit_private_set( rlimit, addr );
+  ulong               key = FD_RLIMIT_PRIVATE_KEY_USED | (ulong)addr;
+
+  /* Find the source's entry (4 independent compares, with the most
+     recently used ways tested first) */
+
+  FD_STATIC_ASSERT( FD_RLIMIT_SET_WAY_CNT==4UL, unroll );
+  ulong way = fd_ulong_if( set[0].key==key, 0UL,
+              fd_ulong_if( set[1].key==key, 1UL,
+              fd_ulong_if( set[2].key==key, 2UL,
+              fd_ulong_if( set[3].key==key, 3UL, FD_RLIMIT_SET_WAY_CNT ) ) ) );
+
+  ulong tat;
+  if( FD_LIKELY( way<FD_RLIMIT_SET_WAY_CNT ) ) tat = set[ way ].tat;
+  else {
+    way  = FD_RLIMIT_SET_WAY_CNT-1UL; /* Evict the least recently used way */
+    rlimit->evict_cnt += (ulong)!!set[ way ].key;
+    tat  = now;                       /* Full bucket */
+  }
+
+  /* Move the entry to the front of the set */
+
+  for( ; way; way-- ) set[ way ] = set[ way-1UL ];
+
+  int pass = fd_rlimit_bucket_take( &tat, now, rlimit->interval, rlimit->tol );
+
+  set[0].key = key;
+  set[0].tat = tat;
+
+  rlimit->pass_cnt += (ulong) pass;
+  rlimit->drop_cnt += (ulong)!pass;
+  return pass;
+}
+
+/* fd_rlimit_prefetch issues a prefetch for the cache line a take of
+   addr will touch.  This is useful for overlapping the memory latency
+   of a batch of takes (e.g. prefetch the addresses of a batch of
+   received frames before rate limiting them).  Assumes rlimit is a
+   current local join. */
+
+static inline void
+fd_rlimit_prefetch( fd_rlimit_t const * rlimit,
+                    uint                addr ) {
+  __builtin_prefetch( fd_rlimit_private_set( rlimit, addr ), 1, 3 );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_tango_rlimit_fd_rlimit_h */
@@ -0,0 +1,47 @@
+#ifndef HEADER_fd_src_tango_rlimit_fd_rlimit_bucket_h
+#define HEADER_fd_src_tango_rlimit_fd_rlimit_bucket_h
+
+/* fd_rlimit_bucket provides the token bucket arithmetic shared by
+   fd_rlimit (userspace, e.g. an ingress tile) and the rate limiter in
+   fd_xdp_redirect_prog (eBPF).  It only depends on the base integer
+   types such that it can be included from both environments.
+
+   A token bucket that refills at one token per interval time units and
+   holds at most burst tokens is tracked by a single 64-bit "theoretical
+   arrival time" tat (this is the virtual scheduling form of a token
+   bucket, a.k.a. GCRA).  tat is the time at which the bucket would be
+   full again if nothing else arrived.  Taking a token at time now
+   succeeds if tat-now<=tol where tol==(burst-1)*interval (i.e. the
+   bucket has at least one token) and advances tat by interval.  A
+   bucket that has been idle long enough to be full (tat<=now) is
+   indistinguishable from a fresh one.
+
+   Times are in arbitrary monotonic units (e.g. fd_tickcount ticks in
+   userspace and bpf_ktime_get_ns ns in eBPF) and compared with
+   wrapping arithmetic (as with fd_seq). */
+
+#if defined(__bpf__)
+#include "../ebpf/fd_ebpf_base.h"
+#else
+#include "../fd_tango_base.h"
+#endif
+
+/* fd_rlimit_bucket_take tries to take a token from the bucket whose
+   theoretical arrival time is at *_tat at time now.  interval is the
+   number of time units per token (positive) and tol is the burst
+   tolerance (burst-1)*interval.  Returns 1 if a token was taken (*_tat
+   is advanced) and 0 if the bucket was empty (*_tat is unchanged). */
+
+static inline int
+fd_rlimit_bucket_take( ulong * _tat,
+                       ulong   now,
+                       ulong   interval,
+                       ulong   tol ) {
+  ulong tat = *_tat;
+  long  lag = (long)(tat - now);
+  if( FD_UNLIKELY( lag>(long)tol ) ) return 0;
+  *_tat = (lag<0L ? now : tat) + interval;
+  return 1;
+}
+
+#endif /* HEADER_fd_src_tango_rlimit_fd_rlimit_bucket_h */
@@ -0,0 +1,251 @@
+#include "../fd_tango.h"
+
+FD_STATIC_ASSERT( FD_RLIMIT_ALIGN==128UL,                                              unit_test );
+FD_STATIC_ASSERT( FD_RLIMIT_SET_SZ==FD_RLIMIT_SET_WAY_CNT*sizeof(fd_rlimit_entry_t),   unit_test );
+FD_STATIC_ASSERT( FD_RLIMIT_FOOTPRINT( 1UL )==FD_RLIMIT_ALIGN+64UL,                    unit_test );
+FD_STATIC_ASSERT( sizeof(fd_rlimit_t)==FD_RLIMIT_ALIGN,                                unit_test );
+
+#define SET_CNT (4096UL)
+
+static uchar __attribute__((aligned(FD_RLIMIT_ALIGN))) shmem [ FD_RLIMIT_FOOTPRINT( SET_CNT ) ];
+static uchar __attribute__((aligned(FD_RLIMIT_ALIGN))) shmem1[ FD_RLIMIT_FOOTPRINT( 1UL     ) ];
+
+/* Fairness test parameters: LIGHT_CNT sources send at about half the
+   limit and HEAVY_CNT sources flood at HEAVY_MULT times the limit. */
+
+#define LIGHT_CNT  (1000UL)
+#define HEAVY_CNT  (10UL)
+#define HEAVY_MULT (100UL)
+#define INTERVAL   (1000UL)
+#define BURST      (8UL)
+#define STEP       (100UL)   /* Simulated time per step */
+#define STEP_CNT   (20000UL)
+
+static ulong light_tx[ LIGHT_CNT ];
+static ulong light_rx[ LIGHT_CNT ];
+
+#define REF_CNT (64UL)
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Test the bucket arithmetic */
+
+  do {
+    ulong tat = 0UL;
+    ulong t0  = 1000000UL;
+    FD_TEST(  fd_rlimit_bucket_take( &tat, t0, 10UL, 20UL ) ); FD_TEST( tat==t0+10UL ); /* Idle bucket is full */
+    FD_TEST(  fd_rlimit_bucket_take( &tat, t0, 10UL, 20UL ) ); FD_TEST( tat==t0+20UL );
+    FD_TEST(  fd_rlimit_bucket_take( &tat, t0, 10UL, 20UL ) ); FD_TEST( tat==t0+30UL ); /* burst 3 */
+    FD_TEST( !fd_rlimit_bucket_take( &tat, t0, 10UL, 20UL ) ); FD_TEST( tat==t0+30UL ); /* empty */
+    FD_TEST( !fd_rlimit_bucket_take( &tat, t0+ 9UL, 10UL, 20UL ) );
+    FD_TEST(  fd_rlimit_bucket_take( &tat, t0+10UL, 10UL, 20UL ) ); FD_TEST( tat==t0+40UL ); /* refilled one */
+    FD_TEST( !fd_rlimit_bucket_take( &tat, t0+10UL, 10UL, 20UL ) );
+
+    /* Time wraps around */
+    tat = ULONG_MAX-5UL;
+    FD_TEST(  fd_rlimit_bucket_take( &tat, ULONG_MAX-5UL, 10UL, 0UL ) ); FD_TEST( tat==4UL );
+    FD_TEST( !fd_rlimit_bucket_take( &tat, ULONG_MAX,     10UL, 0UL ) );
+    FD_TEST(  fd_rlimit_bucket_take( &tat, 4UL,           10UL, 0UL ) ); FD_TEST( tat==14UL );
+  } while(0);
+
+  FD_TEST( fd_rlimit_rate_to_interval( 1e9, 1e6 )==1000UL );
+  FD_TEST( fd_rlimit_rate_to_interval( 1e9, 3e9 )==1UL    );
+  FD_TEST( fd_rlimit_rate_to_interval( 3e9, 7e5 )==4286UL );
+
+  /* Test footprint validation */
+
+  FD_TEST( fd_rlimit_align()==FD_RLIMIT_ALIGN );
+  FD_TEST( !fd_rlimit_footprint( 0UL                        ) );
+  FD_TEST( !fd_rlimit_footprint( 3UL                        ) );
+  FD_TEST( !fd_rlimit_footprint( FD_RLIMIT_SET_CNT_MAX<<1   ) );
+  FD_TEST( fd_rlimit_footprint( SET_CNT               )==FD_RLIMIT_FOOTPRINT( SET_CNT               ) );
+  FD_TEST( fd_rlimit_footprint( FD_RLIMIT_SET_CNT_MAX )==FD_RLIMIT_FOOTPRINT( FD_RLIMIT_SET_CNT_MAX ) );
+
+  /* Test construction */
+
+  ulong seed = fd_rng_ulong( rng );
+
+  FD_TEST( !fd_rlimit_new( NULL,    SET_CNT, INTERVAL, BURST,            seed ) ); /* NULL shmem */
+  FD_TEST( !fd_rlimit_new( shmem+1, SET_CNT, INTERVAL, BURST,            seed ) ); /* misaligned shmem */
+  FD_TEST( !fd_rlimit_new( shmem,   3UL,     INTERVAL, BURST,            seed ) ); /* bad set_cnt */
+  FD_TEST( !fd_rlimit_new( shmem,   SET_CNT, 0UL,      BURST,            seed ) ); /* bad interval */
+  FD_TEST( !fd_rlimit_new( shmem,   SET_CNT, INTERVAL, 0UL,              seed ) ); /* bad burst */
+  FD_TEST( !fd_rlimit_new( shmem,   SET_CNT, 2UL,      (1UL<<62)+2UL,    seed ) ); /* bad burst */
+
+  void * _rlimit = fd_rlimit_new( shmem, SET_CNT, INTERVAL, BURST, seed ); FD_TEST( _rlimit==(void *)shmem );
+
+  FD_TEST( !fd_rlimit_join( NULL    ) ); /* NULL _rlimit */
+  FD_TEST( !fd_rlimit_join( shmem+1 ) ); /* misaligned _rlimit */
+
+  fd_rlimit_t * rlimit = fd_rlimit_join( _rlimit ); FD_TEST( rlimit );
+
+  FD_TEST( fd_rlimit_set_cnt  ( rlimit )==SET_CNT  );
+  FD_TEST( fd_rlimit_seed     ( rlimit )==seed     );
+  FD_TEST( fd_rlimit_interval ( rlimit )==INTERVAL );
+  FD_TEST( fd_rlimit_burst    ( rlimit )==BURST    );
+  FD_TEST( fd_rlimit_pass_cnt ( rlimit )==0UL      );
+  FD_TEST( fd_rlimit_drop_cnt ( rlimit )==0UL      );
+  FD_TEST( fd_rlimit_evict_cnt( rlimit )==0UL      );
+
+  FD_TEST( !fd_rlimit_cfg( NULL,   INTERVAL, BURST ) );
+  FD_TEST( !fd_rlimit_cfg( rlimit, 0UL,      BURST ) );
+  FD_TEST( !fd_rlimit_cfg( rlimit, INTERVAL, 0UL   ) );
+  FD_TEST( fd_rlimit_interval( rlimit )==INTERVAL && fd_rlimit_burst( rlimit )==BURST ); /* unchanged */
+
+  /* Test take against a reference with an unbounded table (few enough
+     sources that none get evicted) */
+
+  do {
+    static uint  ref_addr[ REF_CNT ];
+    static ulong ref_tat [ REF_CNT ];
+    static int   ref_seen[ REF_CNT ];
+    for( ulong i=0UL; i<REF_CNT; i++ ) { ref_addr[i] = fd_rng_uint( rng ); ref_seen[i] = 0; }
+    ref_addr[0] = 0U; /* 0.0.0.0 is a valid key */
+
+    ulong now      = fd_rng_ulong( rng ); /* Also exercises time wrap around */
+    ulong pass_cnt = 0UL;
+    ulong drop_cnt = 0UL;
+    for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+      ulong i = fd_rng_ulong_roll( rng, REF_CNT );
+      now += fd_rng_ulong_roll( rng, INTERVAL/REF_CNT+1UL ); /* Sources send about 2x faster than the limit on average */
+
+      if( !ref_seen[i] ) { ref_tat[i] = now; ref_seen[i] = 1; }
+      int exp  = fd_rlimit_bucket_take( ref_tat+i, now, INTERVAL, (BURST-1UL)*INTERVAL );
+      int pass = fd_rlimit_take( rlimit, ref_addr[i], now );
+      FD_TEST( pass==exp );
+      pass_cnt += (ulong) pass;
+      drop_cnt += (ulong)!pass;
+    }
+    FD_TEST( fd_rlimit_pass_cnt ( rlimit )==pass_cnt );
+    FD_TEST( fd_rlimit_drop_cnt ( rlimit )==drop_cnt );
+    FD_TEST( fd_rlimit_evict_cnt( rlimit )==0UL      );
+    FD_TEST( pass_cnt && drop_cnt );
+  } while(0);
+
+  fd_rlimit_reset( rlimit );
+  FD_TEST( fd_rlimit_pass_cnt ( rlimit )==0UL );
+  FD_TEST( fd_rlimit_drop_cnt ( rlimit )==0UL );
+  FD_TEST( fd_rlimit_evict_cnt( rlimit )==0UL );
+
+  /* Test LRU eviction with a single set */
+
+  do {
+    fd_rlimit_t * r = fd_rlimit_join( fd_rlimit_new( shmem1, 1UL, 1000UL, 1UL, seed ) ); FD_TEST( r );
+    ulong now = 1UL;
+
+    FD_TEST(  fd_rlimit_take( r, 1U, now ) ); /* 1 drained */
+    FD_TEST( !fd_rlimit_take( r, 1U, now ) );
+    FD_TEST(  fd_rlimit_take( r, 2U, now ) ); /* MRU order: 2 1 */
+    FD_TEST(  fd_rlimit_take( r, 3U, now ) ); /* 3 2 1 */
+    FD_TEST(  fd_rlimit_take( r, 4U, now ) ); /* 4 3 2 1 */
+    FD_TEST( fd_rlimit_evict_cnt( r )==0UL );
+    FD_TEST( !fd_rlimit_take( r, 1U, now ) ); /* 1 still limited (1 4 3 2) */
+    FD_TEST(  fd_rlimit_take( r, 5U, now ) ); /* evicts 2 (5 1 4 3) */
+    FD_TEST( fd_rlimit_evict_cnt( r )==1UL );
+    FD_TEST( !fd_rlimit_take( r, 1U, now ) ); /* 1 still limited (1 5 4 3) */
+    FD_TEST( !fd_rlimit_take( r, 5U, now ) ); /* 5 drained (5 1 4 3) */
+    FD_TEST(  fd_rlimit_take( r, 6U, now ) ); /* evicts 3 (6 5 1 4) */
+    FD_TEST(  fd_rlimit_take( r, 7U, now ) ); /* evicts 4 (7 6 5 1) */
+    FD_TEST(  fd_rlimit_take( r, 8U, now ) ); /* evicts 1 (8 7 6 5) */
+    FD_TEST( fd_rlimit_evict_cnt( r )==4UL );
+    FD_TEST(  fd_rlimit_take( r, 1U, now ) ); /* 1 forgotten, full bucket again (evicts 5) */
+    FD_TEST(  fd_rlimit_take( r, 2U, now ) ); /* 2 forgotten (evicts 6) */
+    FD_TEST( !fd_rlimit_take( r, 8U, now ) ); /* 8 remembered */
+    FD_TEST( fd_rlimit_evict_cnt( r )==6UL );
+
+    /* Reconfiguring the rate applies to existing buckets */
+
+    FD_TEST( fd_rlimit_cfg( r, 10UL, 1UL )==r );
+    FD_TEST( !fd_rlimit_take( r, 8U, now+ 999UL ) ); /* tat of 8 is still now+1000 */
+    FD_TEST(  fd_rlimit_take( r, 8U, now+1000UL ) );
+    FD_TEST( !fd_rlimit_take( r, 8U, now+1009UL ) );
+    FD_TEST(  fd_rlimit_take( r, 8U, now+1010UL ) );
+
+    FD_TEST( fd_rlimit_delete( fd_rlimit_leave( r ) )==shmem1 );
+  } while(0);
+
+  /* Test fairness: heavy sources should get the configured rate (plus
+     one burst) and light sources should be unaffected by them */
+
+  do {
+    uint light_addr[ LIGHT_CNT ];
+    uint heavy_addr[ HEAVY_CNT ];
+    for( ulong i=0UL; i<LIGHT_CNT; i++ ) { light_addr[i] = fd_rng_uint( rng ); light_tx[i] = 0UL; light_rx[i] = 0UL; }
+    for( ulong i=0UL; i<HEAVY_CNT; i++ ) heavy_addr[i] = fd_rng_uint( rng );
+    ulong heavy_tx[ HEAVY_CNT ]; memset( heavy_tx, 0, sizeof(heavy_tx) );
+    ulong heavy_rx[ HEAVY_CNT ]; memset( heavy_rx, 0, sizeof(heavy_rx) );
+
+    ulong heavy_per_step = HEAVY_MULT*STEP/INTERVAL;
+    uint  light_thresh   = (uint)(((ulong)UINT_MAX) * STEP / (2UL*INTERVAL)); /* light sources send at half the limit */
+
+    ulong now = fd_rng_ulong( rng );
+    for( ulong step=0UL; step<STEP_CNT; step++ ) {
+      now += STEP;
+      for( ulong j=0UL; j<heavy_per_step; j++ ) {
+        for( ulong i=0UL; i<HEAVY_CNT; i++ ) {
+          heavy_tx[i]++;
+          heavy_rx[i] += (ulong)fd_rlimit_take( rlimit, heavy_addr[i], now + j );
+        }
+      }
+      for( ulong i=0UL; i<LIGHT_CNT; i++ ) {
+        if( fd_rng_uint( rng )>=light_thresh ) continue;
+        light_tx[i]++;
+        light_rx[i] += (ulong)fd_rlimit_take( rlimit, light_addr[i], now + heavy_per_step );
+      }
+    }
+
+    FD_TEST( fd_rlimit_evict_cnt( rlimit )==0UL );
+
+    ulong duration = STEP*STEP_CNT;
+    ulong heavy_max = duration/INTERVAL + BURST;
+    ulong heavy_min = duration/INTERVAL - 1UL;
+    ulong heavy_tot_tx = 0UL; ulong heavy_tot_rx = 0UL;
+    for( ulong i=0UL; i<HEAVY_CNT; i++ ) {
+      FD_TEST( heavy_min<=heavy_rx[i] && heavy_rx[i]<=heavy_max );
+      heavy_tot_tx += heavy_tx[i];
+      heavy_tot_rx += heavy_rx[i];
+    }
+
+    /* Light sources should be (nearly) unaffected: at least 99.9% of
+       the light traffic overall and at least 98% of each light source's
+       traffic should get through (checked in integer arithmetic). */
+
+    ulong light_tot_tx = 0UL; ulong light_tot_rx = 0UL;
+    ulong light_worst  = 0UL;
+    for( ulong i=0UL; i<LIGHT_CNT; i++ ) {
+      light_tot_tx += light_tx[i];
+      light_tot_rx += light_rx[i];
+      if( light_rx[i]*light_tx[light_worst] < light_rx[light_worst]*light_tx[i] ) light_worst = i;
+      FD_TEST( light_rx[i]*50UL > light_tx[i]*49UL );
+    }
+    FD_TEST( light_tot_rx*1000UL > light_tot_tx*999UL );
+    double light_frac = ((double)light_tot_rx)/((double)light_tot_tx);
+    double light_min  = ((double)light_rx[light_worst])/((double)light_tx[light_worst]);
+
+    FD_LOG_NOTICE(( "heavy: tx %lu rx %lu (%.3f); light: tx %lu rx %lu (%.5f, worst source %.3f); heavy share of tx %.3f -> rx %.3f",
+                    heavy_tot_tx, heavy_tot_rx, ((double)heavy_tot_rx)/((double)heavy_tot_tx),
+                    light_tot_tx, light_tot_rx, light_frac, light_min,
+                    ((double)heavy_tot_tx)/((double)(heavy_tot_tx+light_tot_tx)),
+                    ((double)heavy_tot_rx)/((double)(heavy_tot_rx+light_tot_rx)) ));
+  } while(0);
+
+  FD_TEST( fd_rlimit_leave( NULL )==NULL ); /* NULL rlimit */
+  FD_TEST( fd_rlimit_leave( rlimit )==_rlimit );
+
+  FD_TEST( !fd_rlimit_delete( NULL    ) ); /* NULL _rlimit */
+  FD_TEST( !fd_rlimit_delete( shmem+1 ) ); /* misaligned _rlimit */
+  FD_TEST( fd_rlimit_delete( _rlimit )==shmem );
+  FD_TEST( !fd_rlimit_join  ( shmem ) ); /* bad magic */
+  FD_TEST( !fd_rlimit_delete( shmem ) ); /* bad magic */
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
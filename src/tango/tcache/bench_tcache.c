@@ -0,0 +1,156 @@
+#include "../fd_tango.h"
+
+/* bench_tcache measures the single core dedup throughput of a tcache
+   as a function of depth and of how many tags are inserted at a time.
+   For each depth, the tcache (with the default sparse map) is first
+   loaded to steady state (i.e. every insert evicts the oldest tag) and
+   then a long stream of tags (a --dup-frac fraction of which are
+   recent duplicates) is inserted with individual FD_TCACHE_INSERT and
+   with fd_tcache_insert_batch for batch sizes 1,2,4,...,--batch-max.
+   For depths whose map does not fit in cache, individual inserts are
+   limited by DRAM latency while batched inserts overlap the misses. */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#define BATCH_MAX (256UL)
+
+static int batch_dup[ BATCH_MAX ];
+
+static ulong
+bench( ulong *       _oldest,
+       ulong *       ring,
+       ulong         depth,
+       ulong *       map,
+       ulong         map_cnt,
+       ulong const * tag,
+       ulong         tag_cnt,
+       ulong         batch_cnt, /* 0 <> individual inserts */
+       long *        _dt ) {
+  ulong oldest  = *_oldest;
+  ulong dup_cnt = 0UL;
+
+  long dt = -fd_log_wallclock();
+  if( !batch_cnt ) {
+    for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+      int dup;
+      FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, tag[ tag_idx ] );
+      dup_cnt += (ulong)dup;
+    }
+  } else {
+    for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx+=batch_cnt ) {
+      ulong cnt = fd_ulong_min( batch_cnt, tag_cnt-tag_idx );
+      oldest = fd_tcache_insert_batch( oldest, ring, depth, map, map_cnt, tag + tag_idx, cnt, batch_dup );
+      for( ulong dup_idx=0UL; dup_idx<cnt; dup_idx++ ) dup_cnt += (ulong)batch_dup[ dup_idx ];
+    }
+  }
+  dt += fd_log_wallclock();
+
+  *_oldest = oldest;
+  *_dt     = dt;
+  return dup_cnt;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                   );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 4UL                          );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx( cpu_idx ) );
+  ulong        depth_min = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth-min", NULL, 1UL<<20                      );
+  ulong        depth_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth-max", NULL, 1UL<<26                      );
+  ulong        batch_max = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch-max", NULL, 64UL                         );
+  ulong        tag_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--tag-cnt",   NULL, 1UL<<24                      );
+  float        dup_frac  = fd_env_strip_cmdline_float( &argc, &argv, "--dup-frac",  NULL, 0.1f                         );
+
+  if( FD_UNLIKELY( !depth_min || depth_min>depth_max ) ) FD_LOG_ERR(( "bad --depth-min / --depth-max" ));
+  if( FD_UNLIKELY( !batch_max || batch_max>BATCH_MAX ) ) FD_LOG_ERR(( "--batch-max should be in [1,%lu]", BATCH_MAX ));
+  if( FD_UNLIKELY( !tag_cnt                          ) ) FD_LOG_ERR(( "--tag-cnt should be positive" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp =
+    fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong * tag = (ulong *)fd_wksp_alloc_laddr( wksp, 0UL, tag_cnt*sizeof(ulong), 1UL );
+  if( FD_UNLIKELY( !tag ) ) FD_LOG_ERR(( "--tag-cnt too large for workspace" ));
+
+  FD_LOG_NOTICE(( "Benchmarking (--depth-min %lu --depth-max %lu --batch-max %lu --tag-cnt %lu --dup-frac %e)",
+                  depth_min, depth_max, batch_max, tag_cnt, (double)dup_frac ));
+
+  uint dup_thresh = (uint)(0.5f + dup_frac*(float)(1UL<<32));
+
+  for( ulong depth=depth_min; depth<=depth_max; depth<<=2 ) {
+
+    ulong  footprint = fd_tcache_footprint( depth, 0UL );
+    if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "bad depth %lu", depth ));
+    void * mem       = fd_wksp_alloc_laddr( wksp, fd_tcache_align(), footprint, 1UL );
+    if( FD_UNLIKELY( !mem ) ) { FD_LOG_WARNING(( "depth %lu: tcache too large for workspace; skipping", depth )); break; }
+
+    fd_tcache_t * tcache  = fd_tcache_join( fd_tcache_new( mem, depth, 0UL ) ); FD_TEST( tcache );
+    ulong         map_cnt = fd_tcache_map_cnt    ( tcache );
+    ulong *       ring    = fd_tcache_ring_laddr ( tcache );
+    ulong *       map     = fd_tcache_map_laddr  ( tcache );
+    ulong         oldest  = fd_tcache_oldest_laddr( tcache )[0];
+
+    /* Load the tcache to steady state */
+
+    for( ulong rem=depth; rem; rem-- ) {
+      ulong t; do t = fd_rng_ulong( rng ); while( FD_UNLIKELY( fd_tcache_tag_is_null( t ) ) );
+      int dup;
+      FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, t );
+      (void)dup;
+    }
+
+    for( ulong batch_cnt=0UL; batch_cnt<=batch_max; batch_cnt = fd_ulong_if( !batch_cnt, 1UL, batch_cnt<<1 ) ) {
+
+      /* Make a stream of unique tags with recent duplicates mixed in.
+         The stream is regenerated per run as the previous run inserted
+         its unique tags. */
+
+      for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+        ulong t;
+        if( fd_rng_uint( rng )<dup_thresh && tag_idx ) t = tag[ tag_idx - 1UL - fd_rng_ulong_roll( rng, fd_ulong_min( tag_idx, 1024UL ) ) ];
+        else do t = fd_rng_ulong( rng ); while( FD_UNLIKELY( fd_tcache_tag_is_null( t ) ) );
+        tag[ tag_idx ] = t;
+      }
+
+      long  dt;
+      ulong dup_cnt = bench( &oldest, ring, depth, map, map_cnt, tag, tag_cnt, batch_cnt, &dt );
+
+      FD_LOG_NOTICE(( "depth %9lu (map %6lu MiB), %s %3lu: %8.3f Mtag/s, %7.3f ns/tag (dup %lu)",
+                      depth, (map_cnt*sizeof(ulong))>>20, batch_cnt ? "batch" : "indiv", batch_cnt,
+                      1e3*((double)tag_cnt)/((double)dt), ((double)dt)/((double)tag_cnt), dup_cnt ));
+    }
+
+    FD_TEST( fd_tcache_delete( fd_tcache_leave( tcache ) )==mem );
+    fd_wksp_free_laddr( mem );
+  }
+
+  fd_wksp_free_laddr( tag );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -402,6 +402,89 @@ fd_tcache_remove( ulong * map,
     (oldest) = _fti_oldest;                                                      \
   } while(0)
 
+/* FD_TCACHE_PREFETCH_DIST is how many tags ahead the batch operations
+   below prefetch.  This should be large enough to cover DRAM latency
+   given the per tag resolve cost and small enough to not exceed the
+   number of outstanding misses a core can practically sustain. */
+
+#define FD_TCACHE_PREFETCH_DIST (16UL)
+
+/* FD_TCACHE_PREFETCH issues a software prefetch for the map slot where
+   probing for tag will start.  If is_write is non-zero, the prefetch
+   will be with intent to write.  Assumes map is non-NULL, map is indexed
+   [0,map_cnt) and map_cnt is a positive integer power-of-two.  tag can
+   be null (e.g. an evicted tag during startup, this is harmless). */
+
+#define FD_TCACHE_PREFETCH( map, map_cnt, tag, is_write ) \
+  __builtin_prefetch( (map) + fd_tcache_map_start( (tag), (map_cnt) ), (is_write) )
+
+/* fd_tcache_query_batch does FD_TCACHE_QUERY for tag[i] for i in
+   [0,tag_cnt) and sets found[i] to the corresponding result.  The map
+   slots of the tags are software prefetched FD_TCACHE_PREFETCH_DIST tags
+   ahead of where the queries are being resolved such that, for large
+   maps, the DRAM latency of the random probes overlap (rather than
+   being serialized as they would be for individual queries).  Same
+   assumptions as FD_TCACHE_QUERY (e.g. tag[*] are not null).  tag and
+   found should not overlap. */
+
+static inline void
+fd_tcache_query_batch( ulong const * map,
+                       ulong         map_cnt,
+                       ulong const * tag,
+                       ulong         tag_cnt,
+                       int *         found ) {
+  ulong pre_cnt = fd_ulong_min( tag_cnt, FD_TCACHE_PREFETCH_DIST );
+  for( ulong tag_idx=0UL; tag_idx<pre_cnt; tag_idx++ ) FD_TCACHE_PREFETCH( map, map_cnt, tag[ tag_idx ], 0 );
+  for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+    ulong pre_idx = tag_idx + FD_TCACHE_PREFETCH_DIST;
+    if( FD_LIKELY( pre_idx<tag_cnt ) ) FD_TCACHE_PREFETCH( map, map_cnt, tag[ pre_idx ], 0 );
+    ulong map_idx;
+    FD_TCACHE_QUERY( found[ tag_idx ], map_idx, map, map_cnt, tag[ tag_idx ] );
+    (void)map_idx;
+  }
+}
+
+/* fd_tcache_insert_batch does FD_TCACHE_INSERT for tag[i] for i in
+   [0,tag_cnt) in order and sets dup[i] to the corresponding result.
+   Returns the updated value of oldest.  The results and the final
+   tcache state are identical to doing the tag_cnt inserts individually
+   (including when a tag is duplicated within the batch).
+
+   Each unique insert does two random map probes: one for the inserted
+   tag and one to remove the tag it evicts.  Both are software
+   prefetched FD_TCACHE_PREFETCH_DIST tags ahead (the evicted tags are
+   read from the ring ahead of oldest, assuming the tags ahead are
+   unique).  Same assumptions as FD_TCACHE_INSERT.  tag and dup should
+   not overlap the tcache or each other. */
+
+static inline ulong
+fd_tcache_insert_batch( ulong         oldest,
+                        ulong *       ring,
+                        ulong         depth,
+                        ulong *       map,
+                        ulong         map_cnt,
+                        ulong const * tag,
+                        ulong         tag_cnt,
+                        int *         dup ) {
+  ulong evict   = oldest; /* ring location of the next tag whose removal should be prefetched */
+  ulong pre_cnt = fd_ulong_min( tag_cnt, FD_TCACHE_PREFETCH_DIST );
+  for( ulong tag_idx=0UL; tag_idx<pre_cnt; tag_idx++ ) {
+    FD_TCACHE_PREFETCH( map, map_cnt, tag [ tag_idx ], 1 );
+    FD_TCACHE_PREFETCH( map, map_cnt, ring[ evict   ], 1 );
+    evict++; if( evict>=depth ) evict = 0UL; /* cmov */
+  }
+  for( ulong tag_idx=0UL; tag_idx<tag_cnt; tag_idx++ ) {
+    ulong pre_idx = tag_idx + FD_TCACHE_PREFETCH_DIST;
+    if( FD_LIKELY( pre_idx<tag_cnt ) ) {
+      FD_TCACHE_PREFETCH( map, map_cnt, tag [ pre_idx ], 1 );
+      FD_TCACHE_PREFETCH( map, map_cnt, ring[ evict   ], 1 );
+      evict++; if( evict>=depth ) evict = 0UL; /* cmov */
+    }
+    FD_TCACHE_INSERT( dup[ tag_idx ], oldest, ring, depth, map, map_cnt, tag[ tag_idx ] );
+  }
+  return oldest;
+}
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_tango_tcache_fd_tcache_h */
@@ -199,6 +199,89 @@ main( int     argc,
     rem += (ulong)is_dup; /* Only count unique inserts */
   }
 
+  FD_LOG_NOTICE(( "Testing batch operations" ));
+
+  /* Run the same stream of tags through the tcache with individual
+     inserts and through a second identically configured tcache with
+     randomly sized batch inserts.  The per tag results and the final
+     tcache states should be identical.  Streams include duplicates
+     within a batch and duplicates of tags that get evicted by earlier
+     tags in the same batch. */
+
+  void *        mem2     = fd_wksp_alloc_laddr( wksp, align, footprint, 1UL ); FD_TEST( mem2 );
+  fd_tcache_t * tcache2  = fd_tcache_join( fd_tcache_new( mem2, depth, map_cnt ) ); FD_TEST( tcache2 );
+  ulong *       ring2    = fd_tcache_ring_laddr( tcache2 );
+  ulong *       map2     = fd_tcache_map_laddr ( tcache2 );
+  ulong         oldest2  = fd_tcache_reset( ring2, depth, map2, map_cnt ); FD_TEST( !oldest2 );
+
+  oldest = fd_tcache_reset( ring, depth, map, map_cnt ); FD_TEST( !oldest );
+
+# define BATCH_MAX (64UL)
+  ulong batch_tag  [ 2UL*BATCH_MAX ];
+  int   batch_dup  [ 2UL*BATCH_MAX ];
+  int   batch_found[ 2UL*BATCH_MAX ];
+
+  for( ulong rem=3UL*depth; rem; ) {
+    ulong batch_cnt = 1UL + fd_rng_ulong_roll( rng, BATCH_MAX );
+
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+      ulong tag;
+      uint  r = fd_rng_uint( rng ) & 3U;
+      if( r==0U && batch_idx ) tag = batch_tag[ fd_rng_ulong_roll( rng, batch_idx ) ]; /* dup within batch */
+      else if( r==1U ) { /* dup of a tag in the tcache (possibly about to be evicted) */
+        ulong age = fd_rng_ulong_roll( rng, depth );
+        tag = ring[ fd_ulong_if( oldest+age<depth, oldest+age, oldest+age-depth ) ];
+        if( FD_UNLIKELY( fd_tcache_tag_is_null( tag ) ) ) do tag = fd_rng_ulong( rng ); while( fd_tcache_tag_is_null( tag ) );
+      } else do tag = fd_rng_ulong( rng ); while( FD_UNLIKELY( fd_tcache_tag_is_null( tag ) ) );
+      batch_tag[ batch_idx ] = tag;
+    }
+
+    /* Query batch before inserting should match individual queries */
+
+    fd_tcache_query_batch( map2, map_cnt, batch_tag, batch_cnt, batch_found );
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+      int   found;
+      ulong map_idx;
+      FD_TCACHE_QUERY( found, map_idx, map, map_cnt, batch_tag[ batch_idx ] );
+      (void)map_idx;
+      FD_TEST( found==batch_found[ batch_idx ] );
+    }
+
+    oldest2 = fd_tcache_insert_batch( oldest2, ring2, depth, map2, map_cnt, batch_tag, batch_cnt, batch_dup );
+
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+      int dup;
+      FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, batch_tag[ batch_idx ] );
+      FD_TEST( dup==batch_dup[ batch_idx ] );
+      rem -= fd_ulong_min( (ulong)!dup, rem );
+    }
+
+    FD_TEST( oldest2==oldest );
+  }
+
+  /* Also cover the batch boundary cases */
+
+  oldest2 = fd_tcache_insert_batch( oldest2, ring2, depth, map2, map_cnt, batch_tag, 0UL, batch_dup );
+  FD_TEST( oldest2==oldest );
+  fd_tcache_query_batch( map2, map_cnt, batch_tag, 0UL, batch_found );
+
+  for( ulong batch_idx=0UL; batch_idx<2UL*BATCH_MAX; batch_idx++ )
+    do batch_tag[ batch_idx ] = fd_rng_ulong( rng ); while( fd_tcache_tag_is_null( batch_tag[ batch_idx ] ) );
+  oldest2 = fd_tcache_insert_batch( oldest2, ring2, depth, map2, map_cnt, batch_tag, 2UL*BATCH_MAX, batch_dup );
+  for( ulong batch_idx=0UL; batch_idx<2UL*BATCH_MAX; batch_idx++ ) {
+    int dup;
+    FD_TCACHE_INSERT( dup, oldest, ring, depth, map, map_cnt, batch_tag[ batch_idx ] );
+    FD_TEST( dup==batch_dup[ batch_idx ] );
+  }
+  FD_TEST( oldest2==oldest );
+# undef BATCH_MAX
+
+  FD_TEST( !memcmp( ring2, ring, depth  *sizeof(ulong) ) );
+  FD_TEST( !memcmp( map2,  map,  map_cnt*sizeof(ulong) ) );
+
+  FD_TEST( fd_tcache_delete( fd_tcache_leave( tcache2 ) )==mem2 );
+  fd_wksp_free_laddr( mem2 );
+
   FD_LOG_NOTICE(( "Benchmarking" ));
 
   ulong   bench_cnt = 1UL<<20;
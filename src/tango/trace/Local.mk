@@ -0,0 +1,4 @@
+$(call add-hdrs,fd_trace.h)
+$(call add-objs,fd_trace,fd_tango)
+$(call make-unit-test,test_trace,test_trace,fd_tango fd_util)
+$(call run-unit-test,test_trace,)
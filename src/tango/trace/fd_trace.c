@@ -0,0 +1,261 @@
+#include "fd_trace.h"
+
+#define FD_TRACE_MAGIC (0xf17eda2c377ace00UL) /* firedancer trace ver 0 */
+
+FD_TLS fd_trace_t * fd_trace_private_cur; /* NULL at thread start */
+
+ulong
+fd_trace_align( void ) {
+  return FD_TRACE_ALIGN;
+}
+
+ulong
+fd_trace_footprint( ulong depth ) {
+  if( FD_UNLIKELY( !((FD_TRACE_DEPTH_MIN<=depth) & (depth<=FD_TRACE_DEPTH_MAX) & fd_ulong_is_pow2( depth )) ) ) return 0UL;
+  return FD_TRACE_FOOTPRINT( depth );
+}
+
+void *
+fd_trace_new( void *       shmem,
+              ulong        depth,
+              char const * name ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_trace_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_trace_footprint( depth );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad depth" ));
+    return NULL;
+  }
+
+  fd_trace_t * trace = (fd_trace_t *)shmem;
+
+  memset( trace, 0, footprint );
+
+  trace->depth = depth;
+  if( name ) strncpy( trace->name, name, FD_TRACE_NAME_MAX-1UL );
+  trace->wr    = 0UL;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( trace->magic ) = FD_TRACE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_trace_t *
+fd_trace_join( void * shtrace ) {
+
+  if( FD_UNLIKELY( !shtrace ) ) {
+    FD_LOG_WARNING(( "NULL shtrace" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shtrace, fd_trace_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shtrace" ));
+    return NULL;
+  }
+
+  fd_trace_t * trace = (fd_trace_t *)shtrace;
+
+  if( FD_UNLIKELY( trace->magic!=FD_TRACE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return trace;
+}
+
+void *
+fd_trace_leave( fd_trace_t const * trace ) {
+
+  if( FD_UNLIKELY( !trace ) ) {
+    FD_LOG_WARNING(( "NULL trace" ));
+    return NULL;
+  }
+
+  return (void *)trace;
+}
+
+void *
+fd_trace_delete( void * shtrace ) {
+
+  if( FD_UNLIKELY( !shtrace ) ) {
+    FD_LOG_WARNING(( "NULL shtrace" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shtrace, fd_trace_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shtrace" ));
+    return NULL;
+  }
+
+  fd_trace_t * trace = (fd_trace_t *)shtrace;
+
+  if( FD_UNLIKELY( trace->magic!=FD_TRACE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( trace->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shtrace;
+}
+
+char const *
+fd_trace_id_cstr( uint id ) {
+  switch( id ) {
+  case FD_TRACE_ID_PUB:   return "pub";
+  case FD_TRACE_ID_FILT:  return "filt";
+  case FD_TRACE_ID_OVRN:  return "ovrn";
+  case FD_TRACE_ID_BACKP: return "backp";
+  case FD_TRACE_ID_HKEEP: return "hkeep";
+  default: break;
+  }
+  return id>=FD_TRACE_ID_APP ? "app" : "unknown";
+}
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+fd_trace_t *
+fd_trace_join_from_args( int *    pargc,
+                         char *** pargv ) {
+  char const * _trace = fd_env_strip_cmdline_cstr( pargc, pargv, "--trace", NULL, NULL ); /* NULL <> no tracing */
+  if( !_trace ) return NULL;
+
+  if( FD_UNLIKELY( !FD_HAS_TRACE ) ) FD_LOG_WARNING(( "built without FD_HAS_TRACE, --trace will not record any events" ));
+  FD_LOG_NOTICE(( "Joining --trace %s", _trace ));
+  fd_trace_t * trace = fd_trace_join( fd_wksp_map( _trace ) );
+  if( FD_UNLIKELY( !trace ) ) FD_LOG_ERR(( "fd_trace_join failed" ));
+  fd_trace_set( trace );
+  return trace;
+}
+
+void
+fd_trace_leave_from_args( fd_trace_t * trace ) {
+  if( !trace ) return;
+  fd_trace_set( NULL );
+  fd_wksp_unmap( fd_trace_leave( trace ) );
+}
+
+#endif
+
+#if FD_HAS_HOSTED && FD_HAS_DOUBLE
+
+#include <stdio.h>
+
+/* fd_trace_private_fputs_json writes the cstr s to file as the body of
+   a JSON string (i.e. escaping as necessary). */
+
+static void
+fd_trace_private_fputs_json( FILE *       file,
+                             char const * s ) {
+  for( ; *s; s++ ) {
+    int c = (int)(uchar)*s;
+    if(      (c=='"') | (c=='\\') ) fprintf( file, "\\%c", c );
+    else if( c<0x20               ) fprintf( file, "\\u%04x", (uint)c );
+    else                            fputc( c, file );
+  }
+}
+
+ulong
+fd_trace_export( void *                     file,
+                 fd_trace_t const * const * trace,
+                 ulong                      trace_cnt,
+                 double                     tick_per_ns ) {
+
+  if( FD_UNLIKELY( !file ) ) {
+    FD_LOG_WARNING(( "NULL file" ));
+    return ULONG_MAX;
+  }
+
+  if( FD_UNLIKELY( (!trace) & (!!trace_cnt) ) ) {
+    FD_LOG_WARNING(( "NULL trace" ));
+    return ULONG_MAX;
+  }
+
+  for( ulong trace_idx=0UL; trace_idx<trace_cnt; trace_idx++ ) {
+    if( FD_UNLIKELY( !trace[ trace_idx ] ) ) {
+      FD_LOG_WARNING(( "NULL trace[%lu]", trace_idx ));
+      return ULONG_MAX;
+    }
+  }
+
+  if( FD_UNLIKELY( !(tick_per_ns>0.) ) ) { /* Robust against NaN */
+    FD_LOG_WARNING(( "bad tick_per_ns" ));
+    return ULONG_MAX;
+  }
+
+  FILE * f = (FILE *)file;
+
+  /* Find the timestamp of the oldest retained event (events in a trace
+     are recorded by a single tile in timestamp order so this is the
+     oldest event currently readable in some trace) */
+
+  long ts0 = LONG_MAX;
+  for( ulong trace_idx=0UL; trace_idx<trace_cnt; trace_idx++ ) {
+    fd_trace_t const * t     = trace[ trace_idx ];
+    ulong              wr    = fd_trace_wr( t );
+    ulong              depth = fd_trace_depth( t );
+    fd_trace_event_t   event[1];
+    for( ulong idx=wr-fd_ulong_min( wr, depth-1UL ); idx<wr; idx++ )
+      if( FD_LIKELY( fd_trace_read( t, idx, event ) ) ) { ts0 = fd_long_min( ts0, event->ts ); break; }
+  }
+  if( FD_UNLIKELY( ts0==LONG_MAX ) ) ts0 = 0L; /* No events */
+
+  double us_per_tick = 1e-3 / tick_per_ns;
+
+  /* Write each trace as a track in the trace event JSON.  Frag events
+     are bound into flows by signature such that a frag published by
+     one tile and then consumed / republished by others shows up as a
+     single flow across the tracks.  seq and a1 are written as strings
+     as JSON readers typically only have 53-bit integer precision. */
+
+  ulong exported_cnt = 0UL;
+
+  fprintf( f, "{\"traceEvents\":[\n" );
+  for( ulong trace_idx=0UL; trace_idx<trace_cnt; trace_idx++ ) {
+    fd_trace_t const * t     = trace[ trace_idx ];
+    ulong              tid   = trace_idx+1UL;
+    ulong              wr    = fd_trace_wr( t );
+    ulong              depth = fd_trace_depth( t );
+
+    fprintf( f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"", trace_idx ? ",\n" : "", tid );
+    fd_trace_private_fputs_json( f, fd_trace_name( t )[0] ? fd_trace_name( t ) : "trace" );
+    fprintf( f, "\"}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"sort_index\":%lu}}", tid, tid );
+
+    for( ulong idx=wr-fd_ulong_min( wr, depth-1UL ); idx<wr; idx++ ) {
+      fd_trace_event_t event[1];
+      if( FD_UNLIKELY( !fd_trace_read( t, idx, event ) ) ) continue; /* Overwritten during export */
+
+      uint id = event->id;
+      fprintf( f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":0,"
+                  "\"args\":{\"id\":%u,\"seq\":\"%lu\",\"a0\":%u,\"a1\":\"0x%016lx\"}",
+               fd_trace_id_cstr( id ), tid, (double)(event->ts-ts0)*us_per_tick, id, event->seq, event->a0, event->a1 );
+      if(      id==FD_TRACE_ID_PUB  ) fprintf( f, ",\"bind_id\":\"0x%016lx\",\"flow_in\":true,\"flow_out\":true}", event->a1 );
+      else if( id==FD_TRACE_ID_FILT ) fprintf( f, ",\"bind_id\":\"0x%016lx\",\"flow_in\":true}",                   event->a1 );
+      else                            fputc( '}', f );
+      exported_cnt++;
+    }
+  }
+  fprintf( f, "\n],\"displayTimeUnit\":\"ns\"}\n" );
+
+  if( FD_UNLIKELY( ferror( f ) ) ) {
+    FD_LOG_WARNING(( "I/O error writing trace" ));
+    return ULONG_MAX;
+  }
+
+  return exported_cnt;
+}
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef HEADER_fd_src_tango_trace_fd_trace_h
+#define HEADER_fd_src_tango_trace_fd_trace_h
+
+/* trace provides APIs for low overhead binary event tracing of tiles.
+   A trace is a persistent shared memory ring of compact fixed size
+   events (tickcount timestamp, event id, frag sequence number and two
+   event specific arguments).  Each tile that wants to be traced gets
+   its own trace (i.e. there is a single writer per trace) such that
+   recording an event is a handful of stores to tile owned cache lines
+   followed by a single store of the ring's write cursor to publish it.
+   Old events are overwritten as the ring wraps.
+
+   Readers (e.g. fd_tango_ctl export-trace) can snapshot a trace at any
+   time, including while the tile is running, and detect events that
+   were overwritten while being read.  fd_trace_export converts a set of
+   traces into Chrome trace event JSON suitable for loading into
+   Perfetto (ui.perfetto.dev) or chrome://tracing, giving per-frag
+   timelines across tiles.
+
+   Tile run loops are instrumented with FD_TRACE.  FD_TRACE compiles to
+   nothing unless the build was done with FD_HAS_TRACE (e.g. make
+   EXTRAS=trace) such that tracing has zero overhead in normal builds.
+   When enabled, a tile records events into the trace installed for the
+   calling thread with fd_trace_set (and records nothing if no trace has
+   been installed). */
+
+#include "../fd_tango_base.h"
+
+/* FD_HAS_TRACE indicates if FD_TRACE instrumentation is compiled in. */
+
+#ifndef FD_HAS_TRACE
+#define FD_HAS_TRACE 0
+#endif
+
+/* FD_TRACE_{ALIGN,FOOTPRINT} specify the alignment and footprint needed
+   for a trace with depth events.  ALIGN is a positive integer power of
+   2.  FOOTPRINT is a multiple of ALIGN.  These are provided to
+   facilitate compile time declarations.  depth is assumed to be valid
+   (see fd_trace_footprint).  Events are 32 bytes. */
+
+#define FD_TRACE_ALIGN                (128UL)
+#define FD_TRACE_FOOTPRINT( depth )   (256UL + (depth)*32UL)
+
+/* FD_TRACE_{DEPTH_MIN,DEPTH_MAX} give the range of valid trace depths.
+   A depth must additionally be an integer power of 2. */
+
+#define FD_TRACE_DEPTH_MIN (4UL)
+#define FD_TRACE_DEPTH_MAX (1UL<<31)
+
+/* FD_TRACE_NAME_MAX gives the maximum size of a trace's name including
+   the terminating '\0' (the name is used to label the trace's track
+   when exported). */
+
+#define FD_TRACE_NAME_MAX (64UL)
+
+/* FD_TRACE_ID_* give the event ids of the standard events recorded by
+   the tiles.  For these, a0 is the frag payload size and a1 is the
+   frag signature (the signature is used to correlate a frag across
+   tiles when exported).
+
+     PUB   the tile published frag seq (seq is the tile's out seq)
+     FILT  the tile filtered the in frag seq (e.g. a dedup duplicate)
+     OVRN  the tile detected an overrun polling an in and is resuming
+           at seq (a0 and a1 are 0)
+     BACKP the tile became backpressured publishing seq (a0 and a1
+           are 0)
+     HKEEP the tile did housekeeping (seq, a0 and a1 are 0)
+
+   Ids at or above FD_TRACE_ID_APP are available for application
+   specific events. */
+
+#define FD_TRACE_ID_PUB   (1U)
+#define FD_TRACE_ID_FILT  (2U)
+#define FD_TRACE_ID_OVRN  (3U)
+#define FD_TRACE_ID_BACKP (4U)
+#define FD_TRACE_ID_HKEEP (5U)
+#define FD_TRACE_ID_APP   (256U)
+
+/* fd_trace_event_t specifies the layout of a trace event. */
+
+struct __attribute__((aligned(32))) fd_trace_event {
+  long  ts;  /* fd_tickcount() when the event occurred */
+  ulong seq; /* frag sequence number associated with the event */
+  uint  id;  /* event id, a FD_TRACE_ID_* */
+  uint  a0;  /* event specific argument */
+  ulong a1;  /* event specific argument */
+};
+
+typedef struct fd_trace_event fd_trace_event_t;
+
+/* fd_trace_t is a handle of a trace.  The layout is exposed here to
+   allow FD_TRACE to be inlined into tile run loops but it should
+   otherwise be treated as opaque. */
+
+struct __attribute__((aligned(FD_TRACE_ALIGN))) fd_trace_private {
+  ulong magic;                     /* == FD_TRACE_MAGIC */
+  ulong depth;                     /* Number of events in the ring, integer power of 2 */
+  char  name[ FD_TRACE_NAME_MAX ]; /* '\0' terminated name */
+  /* Padding to 128 alignment here */
+  ulong wr __attribute__((aligned(128))); /* Number of events ever written (event wr is at ring[ wr & (depth-1) ]) */
+  /* Padding to 128 alignment here */
+  /* depth fd_trace_event_t here */
+};
+
+typedef struct fd_trace_private fd_trace_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_trace_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a trace with depth
+   events.  Returns 0 if depth is not a valid trace depth. */
+
+FD_FN_CONST ulong
+fd_trace_align( void );
+
+FD_FN_CONST ulong
+fd_trace_footprint( ulong depth );
+
+/* fd_trace_new formats an unused memory region for use as a trace.
+   shmem is a non-NULL pointer to this region in the local address
+   space with the required footprint and alignment.  depth is the
+   number of events to retain (integer power of 2 in
+   [FD_TRACE_DEPTH_MIN,FD_TRACE_DEPTH_MAX]).  name is a cstr used to
+   label the trace when exported (NULL is fine and truncated to
+   FD_TRACE_NAME_MAX-1 characters).  The trace will initially contain
+   no events.  Returns shmem (and the memory region it points to will
+   be formatted as a trace, caller is not joined) on success and NULL
+   on failure (logs details). */
+
+void *
+fd_trace_new( void *       shmem,
+              ulong        depth,
+              char const * name );
+
+/* fd_trace_join joins the caller to the trace.  shtrace points to the
+   first byte of the memory region backing the trace in the caller's
+   address space.  Returns a pointer in the local address space to the
+   trace on success and NULL on failure (logs details).  There should
+   be only one writer joined to a trace at any given time. */
+
+fd_trace_t *
+fd_trace_join( void * shtrace );
+
+/* fd_trace_leave leaves a current local join.  Returns a pointer to the
+   underlying shared memory region on success and NULL on failure (logs
+   details).  Reasons for failure include trace is NULL. */
+
+void *
+fd_trace_leave( fd_trace_t const * trace );
+
+/* fd_trace_delete unformats a memory region used as a trace.  Assumes
+   nobody is joined to the region.  Returns a pointer to the underlying
+   shared memory region or NULL if used obviously in error (e.g.
+   shtrace obviously does not point to a trace ... logs details).  The
+   ownership of the memory region is transferred to the caller on
+   success. */
+
+void *
+fd_trace_delete( void * shtrace );
+
+/* Accessors.  fd_trace_depth returns the number of events retained by
+   the trace.  fd_trace_name returns the trace's name (lifetime is that
+   of the local join).  fd_trace_ring returns the location of the
+   trace's event ring in the caller's address space.  Assumes trace is a
+   current local join. */
+
+FD_FN_PURE  static inline ulong                    fd_trace_depth     ( fd_trace_t const * t ) { return t->depth; }
+FD_FN_CONST static inline char const *             fd_trace_name      ( fd_trace_t const * t ) { return t->name;  }
+FD_FN_CONST static inline fd_trace_event_t *       fd_trace_ring      ( fd_trace_t *       t ) { return (fd_trace_event_t *)(t+1); }
+FD_FN_CONST static inline fd_trace_event_t const * fd_trace_ring_const( fd_trace_t const * t ) { return (fd_trace_event_t const *)(t+1); }
+
+/* fd_trace_wr returns the number of events ever written to trace.  As
+   the slot of event wr might be in the process of being overwritten by
+   the writer, the events that can be read are the most recent
+   min(wr,depth-1) (i.e. the ones in [wr-min(wr,depth-1),wr) ).  This
+   is a compiler memory fence. */
+
+static inline ulong
+fd_trace_wr( fd_trace_t const * trace ) {
+  FD_COMPILER_MFENCE();
+  ulong wr = FD_VOLATILE_CONST( trace->wr );
+  FD_COMPILER_MFENCE();
+  return wr;
+}
+
+/* fd_trace_record records an event with timestamp ts, id, seq and
+   arguments a0 and a1 into trace.  Assumes trace is a current local
+   join and the caller is the trace's only writer.  The event fields
+   are written into the ring followed by a single store of the write
+   cursor to publish it (the stores are to cache lines that are only
+   rarely read by others). */
+
+static inline void
+fd_trace_record( fd_trace_t * trace,
+                 long         ts,
+                 uint         id,
+                 ulong        seq,
+                 uint         a0,
+                 ulong        a1 ) {
+  ulong              wr    = trace->wr;
+  fd_trace_event_t * event = fd_trace_ring( trace ) + (wr & (trace->depth-1UL));
+  event->ts  = ts;
+  event->seq = seq;
+  event->id  = id;
+  event->a0  = a0;
+  event->a1  = a1;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( trace->wr ) = wr+1UL;
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_trace_read copies the idx-th event ever written to trace into
+   *event.  Returns 1 on success and 0 if event idx is not available
+   (i.e. it has not been written yet or it was overwritten, possibly
+   while being read, by the trace wrapping).  On failure, *event is
+   clobbered.  Assumes trace is a current local join.  This is safe to
+   use while the trace is being written. */
+
+static inline int
+fd_trace_read( fd_trace_t const * trace,
+               ulong              idx,
+               fd_trace_event_t * event ) {
+  ulong depth = trace->depth;
+  if( FD_UNLIKELY( idx>=fd_trace_wr( trace ) ) ) return 0;
+  FD_COMPILER_MFENCE();
+  *event = fd_trace_ring_const( trace )[ idx & (depth-1UL) ];
+  /* The writer starts overwriting event idx's slot with event
+     idx+depth once it has advanced wr to idx+depth */
+  return fd_trace_wr( trace )<(idx+depth);
+}
+
+/* fd_trace_set installs trace as the trace the calling thread records
+   FD_TRACE events into (NULL to stop recording).  fd_trace returns the
+   calling thread's current trace.  Assumes trace is NULL or a current
+   local join.  Typically, a tile will do something like:
+
+     fd_trace_set( fd_trace_join( fd_wksp_map( _trace ) ) );
+
+   at startup.  Note that only one thread at a time should install a
+   given trace. */
+
+extern FD_TLS fd_trace_t * fd_trace_private_cur;
+
+static inline void         fd_trace_set( fd_trace_t * trace ) { fd_trace_private_cur = trace; }
+static inline fd_trace_t * fd_trace    ( void )               { return fd_trace_private_cur;  }
+
+/* FD_TRACE( ts, id, seq, a0, a1 ) records an event into the calling
+   thread's current trace (if any).  ts is typically the tile's most
+   recent tickcount observation such that tracing does not need any
+   additional tickcount reads.  This compiles to nothing (and the
+   arguments are not evaluated) if FD_HAS_TRACE is 0. */
+
+#if FD_HAS_TRACE
+#define FD_TRACE( ts, id, seq, a0, a1 ) do {                                                  \
+    fd_trace_t * _fd_trace = fd_trace_private_cur;                                            \
+    if( _fd_trace ) fd_trace_record( _fd_trace, (ts), (id), (seq), (uint)(a0), (ulong)(a1) ); \
+  } while(0)
+#else
+#define FD_TRACE( ts, id, seq, a0, a1 ) do {} while(0)
+#endif
+
+/* fd_trace_id_cstr returns a cstr with the name of event id (e.g.
+   "pub" for FD_TRACE_ID_PUB).  Returns "app" for application ids and
+   "unknown" otherwise.  The returned pointer has infinite lifetime. */
+
+FD_FN_CONST char const *
+fd_trace_id_cstr( uint id );
+
+/* fd_trace_join_from_args strips "--trace [gaddr]" from the command
+   line given by pargc / pargv (as fd_env_strip_cmdline_cstr).  If
+   present, the trace at gaddr is joined and installed as the calling
+   thread's trace (as a tile's main typically does at startup, logs a
+   warning if built without FD_HAS_TRACE as nothing will be recorded).
+   Returns the local join or NULL if --trace was not given.  Logs
+   details and terminates the thread group if the join fails.
+   fd_trace_leave_from_args uninstalls and leaves a trace returned by
+   fd_trace_join_from_args (NULL is a no-op). */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+fd_trace_t *
+fd_trace_join_from_args( int *    pargc,
+                         char *** pargv );
+
+void
+fd_trace_leave_from_args( fd_trace_t * trace );
+
+#endif
+
+/* fd_trace_export writes the events currently retained by the traces
+   trace[i] for i in [0,trace_cnt) to file as Chrome trace event JSON
+   (file should be non-NULL handle of a stream, e.g. on a hosted
+   platform a fopen'd FILE *).  Each trace is exported as its own track
+   (labeled with its name) and each event is exported as a zero
+   duration slice with its seq, a0 and a1 as arguments.  Tickcount
+   timestamps are converted to the microseconds used by the format with
+   tick_per_ns (e.g. from fd_tempo_tick_per_ns) relative to the oldest
+   exported event.  Frags are linked across tracks with flow events
+   keyed by frag signature (for the standard frag events).  Events
+   overwritten during the export are skipped.  Returns the number of
+   events exported on success and ULONG_MAX on failure (e.g. an I/O
+   error, logs details).  This can be used while the traces are being
+   written. */
+
+#if FD_HAS_HOSTED && FD_HAS_DOUBLE
+
+ulong
+fd_trace_export( void *                     file,
+                 fd_trace_t const * const * trace,
+                 ulong                      trace_cnt,
+                 double                     tick_per_ns );
+
+#endif
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_tango_trace_fd_trace_h */
@@ -0,0 +1,193 @@
+#include "../fd_tango.h"
+
+#if FD_HAS_HOSTED && FD_HAS_DOUBLE
+#include <stdio.h>
+#endif
+
+FD_STATIC_ASSERT( FD_TRACE_ALIGN==128UL, unit_test );
+FD_STATIC_ASSERT( FD_TRACE_FOOTPRINT( 4UL )==384UL, unit_test );
+FD_STATIC_ASSERT( sizeof(fd_trace_event_t)==32UL, unit_test );
+FD_STATIC_ASSERT( sizeof(fd_trace_t)==256UL, unit_test );
+
+FD_STATIC_ASSERT( FD_TRACE_ID_PUB  ==1U,   unit_test );
+FD_STATIC_ASSERT( FD_TRACE_ID_FILT ==2U,   unit_test );
+FD_STATIC_ASSERT( FD_TRACE_ID_OVRN ==3U,   unit_test );
+FD_STATIC_ASSERT( FD_TRACE_ID_BACKP==4U,   unit_test );
+FD_STATIC_ASSERT( FD_TRACE_ID_HKEEP==5U,   unit_test );
+FD_STATIC_ASSERT( FD_TRACE_ID_APP  ==256U, unit_test );
+
+#define DEPTH_MAX (1024UL)
+
+static uchar shmem[ 2 ][ FD_TRACE_FOOTPRINT( DEPTH_MAX ) ] __attribute__((aligned(FD_TRACE_ALIGN)));
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong depth = fd_env_strip_cmdline_ulong( &argc, &argv, "--depth", NULL, 64UL );
+
+  if( FD_UNLIKELY( !fd_trace_footprint( depth ) ) ) FD_LOG_ERR(( "--depth is not a valid trace depth" ));
+  if( FD_UNLIKELY( depth>DEPTH_MAX              ) ) FD_LOG_ERR(( "--depth too large for this unit test" ));
+
+  FD_LOG_NOTICE(( "Testing with --depth %lu", depth ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  FD_TEST( fd_trace_align()==FD_TRACE_ALIGN );
+  FD_TEST( !fd_trace_footprint( 0UL                        ) );
+  FD_TEST( !fd_trace_footprint( FD_TRACE_DEPTH_MIN-1UL     ) );
+  FD_TEST( !fd_trace_footprint( FD_TRACE_DEPTH_MAX+1UL     ) );
+  FD_TEST( !fd_trace_footprint( 3UL*FD_TRACE_DEPTH_MIN     ) );
+  FD_TEST(  fd_trace_footprint( FD_TRACE_DEPTH_MIN         )==FD_TRACE_FOOTPRINT( FD_TRACE_DEPTH_MIN ) );
+  FD_TEST(  fd_trace_footprint( FD_TRACE_DEPTH_MAX         )==FD_TRACE_FOOTPRINT( FD_TRACE_DEPTH_MAX ) );
+  FD_TEST(  fd_trace_footprint( depth                      )==FD_TRACE_FOOTPRINT( depth              ) );
+
+  /* Test failure cases of new / join / leave / delete */
+
+  FD_TEST( !fd_trace_new( NULL,          depth, "a" ) ); /* NULL shmem       */
+  FD_TEST( !fd_trace_new( shmem[0]+1UL,  depth, "a" ) ); /* misaligned shmem */
+  FD_TEST( !fd_trace_new( shmem[0],      3UL,   "a" ) ); /* bad depth        */
+
+  FD_TEST( !fd_trace_join( NULL         ) ); /* NULL shtrace       */
+  FD_TEST( !fd_trace_join( shmem[0]+1UL ) ); /* misaligned shtrace */
+  FD_TEST( !fd_trace_join( shmem[0]     ) ); /* bad magic          */
+
+  FD_TEST( !fd_trace_leave( NULL ) ); /* NULL trace */
+
+  FD_TEST( !fd_trace_delete( NULL         ) ); /* NULL shtrace       */
+  FD_TEST( !fd_trace_delete( shmem[0]+1UL ) ); /* misaligned shtrace */
+  FD_TEST( !fd_trace_delete( shmem[0]     ) ); /* bad magic          */
+
+  /* Test construction */
+
+  char long_name[ 2UL*FD_TRACE_NAME_MAX ];
+  memset( long_name, 'x', 2UL*FD_TRACE_NAME_MAX-1UL ); long_name[ 2UL*FD_TRACE_NAME_MAX-1UL ] = '\0';
+
+  fd_trace_t * trace0 = fd_trace_join( fd_trace_new( shmem[0], depth, "dedup \"0\"" ) ); FD_TEST( trace0 );
+  fd_trace_t * trace1 = fd_trace_join( fd_trace_new( shmem[1], depth, long_name     ) ); FD_TEST( trace1 );
+
+  FD_TEST( fd_trace_depth( trace0 )==depth );
+  FD_TEST( !strcmp( fd_trace_name( trace0 ), "dedup \"0\"" ) );
+  FD_TEST( strlen( fd_trace_name( trace1 ) )==FD_TRACE_NAME_MAX-1UL );
+  FD_TEST( fd_trace_wr( trace0 )==0UL );
+
+  fd_trace_event_t event[1];
+  FD_TEST( !fd_trace_read( trace0, 0UL, event ) );
+
+  FD_TEST( !strcmp( fd_trace_id_cstr( FD_TRACE_ID_PUB   ), "pub"     ) );
+  FD_TEST( !strcmp( fd_trace_id_cstr( FD_TRACE_ID_FILT  ), "filt"    ) );
+  FD_TEST( !strcmp( fd_trace_id_cstr( FD_TRACE_ID_OVRN  ), "ovrn"    ) );
+  FD_TEST( !strcmp( fd_trace_id_cstr( FD_TRACE_ID_BACKP ), "backp"   ) );
+  FD_TEST( !strcmp( fd_trace_id_cstr( FD_TRACE_ID_HKEEP ), "hkeep"   ) );
+  FD_TEST( !strcmp( fd_trace_id_cstr( FD_TRACE_ID_APP   ), "app"     ) );
+  FD_TEST( !strcmp( fd_trace_id_cstr( 0U                ), "unknown" ) );
+
+  /* Test recording and reading as the ring wraps */
+
+  ulong event_cnt = 3UL*depth + (fd_rng_ulong( rng ) & (depth-1UL));
+  for( ulong idx=0UL; idx<event_cnt; idx++ ) {
+    fd_trace_record( trace0, (long)(1000UL+idx), FD_TRACE_ID_PUB, idx, (uint)idx, ~idx );
+    FD_TEST( fd_trace_wr( trace0 )==idx+1UL );
+
+    FD_TEST( fd_trace_read( trace0, idx, event ) );
+    FD_TEST( event->ts==(long)(1000UL+idx) && event->id==FD_TRACE_ID_PUB && event->seq==idx && event->a0==(uint)idx &&
+             event->a1==~idx );
+    FD_TEST( !fd_trace_read( trace0, idx+1UL, event ) ); /* Not written yet */
+    if( idx>=depth-1UL ) FD_TEST( !fd_trace_read( trace0, idx-depth+1UL, event ) ); /* (Potentially being) overwritten */
+    if( idx>=depth-2UL ) {
+      ulong old = idx-depth+2UL; /* Oldest readable event */
+      FD_TEST( fd_trace_read( trace0, old, event ) && event->seq==old );
+    }
+  }
+
+  /* Test FD_TRACE records into the thread's current trace only when
+     compiled in */
+
+  FD_TEST( !fd_trace() );
+  FD_TRACE( 0L, FD_TRACE_ID_HKEEP, 0UL, 0U, 0UL ); /* No current trace, no-op */
+  FD_TEST( fd_trace_wr( trace1 )==0UL );
+
+  fd_trace_set( trace1 ); FD_TEST( fd_trace()==trace1 );
+  for( ulong idx=0UL; idx<depth/2UL; idx++ ) {
+    FD_TRACE( (long)(500UL+2UL*idx), (idx & 1UL) ? FD_TRACE_ID_FILT : FD_TRACE_ID_PUB, idx, 64U, idx );
+  }
+  FD_TRACE( 2000L, FD_TRACE_ID_APP, 0UL, 0U, 0UL );
+  FD_TEST( fd_trace_wr( trace1 )==(FD_HAS_TRACE ? depth/2UL+1UL : 0UL) );
+  fd_trace_set( NULL ); FD_TEST( !fd_trace() );
+
+  if( !FD_HAS_TRACE ) { /* Populate manually such that the export test below is the same */
+    for( ulong idx=0UL; idx<depth/2UL; idx++ )
+      fd_trace_record( trace1, (long)(500UL+2UL*idx), (idx & 1UL) ? FD_TRACE_ID_FILT : FD_TRACE_ID_PUB, idx, 64U, idx );
+    fd_trace_record( trace1, 2000L, FD_TRACE_ID_APP, 0UL, 0U, 0UL );
+  }
+
+# if FD_HAS_HOSTED && FD_HAS_DOUBLE
+
+  /* Test export */
+
+  fd_trace_t const * trace[2]; trace[0] = trace0; trace[1] = trace1;
+
+  FD_TEST( fd_trace_export( NULL,  trace, 2UL, 1. )==ULONG_MAX ); /* NULL file */
+
+  FILE * file = tmpfile(); FD_TEST( file );
+
+  FD_TEST( fd_trace_export( file,  NULL,  2UL, 1. )==ULONG_MAX ); /* NULL trace      */
+  FD_TEST( fd_trace_export( file,  trace, 2UL, 0. )==ULONG_MAX ); /* bad tick_per_ns */
+  fd_trace_t const * bad[2]; bad[0] = trace0; bad[1] = NULL;
+  FD_TEST( fd_trace_export( file,  bad,   2UL, 1. )==ULONG_MAX ); /* NULL trace[1]   */
+
+  FD_TEST( fd_trace_export( file, trace, 2UL, 2. )==depth-1UL + depth/2UL + 1UL );
+
+  static char json[ 256UL*(3UL*DEPTH_MAX/2UL+16UL) ];
+  ulong json_sz = (ulong)ftell( file ); FD_TEST( json_sz<sizeof(json) );
+  rewind( file );
+  FD_TEST( fread( json, 1UL, json_sz, file )==json_sz );
+  json[ json_sz ] = '\0';
+  FD_TEST( !fclose( file ) );
+
+  FD_TEST( !strncmp( json, "{\"traceEvents\":[\n", 17UL ) );
+  char const * tail = "\n],\"displayTimeUnit\":\"ns\"}\n";
+  FD_TEST( json_sz>strlen( tail ) && !strcmp( json + json_sz - strlen( tail ), tail ) );
+  FD_TEST( strstr( json, "\"args\":{\"name\":\"dedup \\\"0\\\"\"}" ) );
+
+  /* Count the events by kind and check the timestamp conversion (the
+     oldest event is trace1's first at tick 500 and 2 ticks per ns
+     gives 0.001 us per 2 ticks) */
+
+  ulong slice_cnt = 0UL; ulong flow_out_cnt = 0UL; ulong flow_in_cnt = 0UL;
+  for( char const * p=json; (p=strstr( p, "\"ph\":\"X\"" ))!=NULL; p++ ) slice_cnt++;
+  for( char const * p=json; (p=strstr( p, "\"flow_out\":true" ))!=NULL; p++ ) flow_out_cnt++;
+  for( char const * p=json; (p=strstr( p, "\"flow_in\":true" ))!=NULL; p++ ) flow_in_cnt++;
+  FD_TEST( slice_cnt   ==depth-1UL + depth/2UL + 1UL     );
+  FD_TEST( flow_out_cnt==depth-1UL + (depth/2UL+1UL)/2UL );
+  FD_TEST( flow_in_cnt ==depth-1UL + depth/2UL           );
+  FD_TEST( strstr( json, "\"name\":\"pub\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":0.000,\"dur\":0" ) );
+  FD_TEST( strstr( json, "\"name\":\"app\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":0.750,\"dur\":0" ) );
+
+  FD_LOG_NOTICE(( "exported %lu bytes", json_sz ));
+
+# endif
+
+# if FD_HAS_HOSTED && FD_HAS_X86
+  /* Test no --trace given */
+
+  fd_trace_t * cur = fd_trace();
+  FD_TEST( !fd_trace_join_from_args( &argc, &argv ) );
+  FD_TEST( fd_trace()==cur );
+  fd_trace_leave_from_args( NULL );
+  FD_TEST( fd_trace()==cur );
+# endif
+
+  /* Test destruction */
+
+  FD_TEST( fd_trace_delete( fd_trace_leave( trace1 ) )==shmem[1] );
+  FD_TEST( fd_trace_delete( fd_trace_leave( trace0 ) )==shmem[0] );
+  FD_TEST( !fd_trace_join( shmem[0] ) ); /* bad magic */
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,6 @@
+ifdef FD_HAS_HOSTED
+$(call add-hdrs,fd_uring.h fd_uring_aio.h)
+$(call add-objs,fd_uring fd_uring_aio,fd_tango)
+$(call make-unit-test,test_uring_aio,test_uring_aio,fd_tango fd_util)
+$(call run-unit-test,test_uring_aio)
+endif
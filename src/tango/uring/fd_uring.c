@@ -0,0 +1,98 @@
+/* syscall and MAP_POPULATE require _GNU_SOURCE */
+#define _GNU_SOURCE
+
+#if !defined(__linux__)
+#error "fd_uring requires Linux operating system with io_uring support"
+#endif
+
+#include "../../util/fd_util.h"
+#include "fd_uring.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+int
+fd_uring_sys_setup( uint                     entries,
+                    struct io_uring_params * params ) {
+  return (int)syscall( SYS_io_uring_setup, entries, params );
+}
+
+int
+fd_uring_sys_enter( int  ring_fd,
+                    uint to_submit,
+                    uint min_complete,
+                    uint flags ) {
+  return (int)syscall( SYS_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0UL );
+}
+
+int
+fd_uring_sys_register( int    ring_fd,
+                       uint   opcode,
+                       void * arg,
+                       uint   arg_cnt ) {
+  return (int)syscall( SYS_io_uring_register, ring_fd, opcode, arg, arg_cnt );
+}
+
+fd_uring_t *
+fd_uring_map( fd_uring_t *                   uring,
+              int                            ring_fd,
+              struct io_uring_params const * params ) {
+
+  memset( uring, 0, sizeof(fd_uring_t) );
+  uring->ring_fd = ring_fd;
+
+  if( FD_UNLIKELY( !(params->features & IORING_FEAT_SINGLE_MMAP) ) ) {
+    FD_LOG_WARNING(( "io_uring too old (no IORING_FEAT_SINGLE_MMAP)" ));
+    fd_uring_unmap( uring );
+    return NULL;
+  }
+
+  /* Map the SQ / CQ rings (one mapping) and the SQE array */
+
+  ulong ring_map_sz = fd_ulong_max( params->sq_off.array + params->sq_entries*sizeof(uint),
+                                    params->cq_off.cqes  + params->cq_entries*sizeof(struct io_uring_cqe) );
+  void * ring_mem = mmap( NULL, ring_map_sz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, (long)IORING_OFF_SQ_RING );
+  if( FD_UNLIKELY( ring_mem==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(IORING_OFF_SQ_RING,%lu) failed (%i-%s)", ring_map_sz, errno, strerror( errno ) ));
+    fd_uring_unmap( uring );
+    return NULL;
+  }
+  uring->ring_mem    = ring_mem;
+  uring->ring_map_sz = ring_map_sz;
+
+  ulong sqes_map_sz = params->sq_entries*sizeof(struct io_uring_sqe);
+  void * sqes = mmap( NULL, sqes_map_sz, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, (long)IORING_OFF_SQES );
+  if( FD_UNLIKELY( sqes==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(IORING_OFF_SQES,%lu) failed (%i-%s)", sqes_map_sz, errno, strerror( errno ) ));
+    fd_uring_unmap( uring );
+    return NULL;
+  }
+  uring->sqes        = (struct io_uring_sqe *)sqes;
+  uring->sqes_map_sz = sqes_map_sz;
+
+  uchar * ring_base = (uchar *)ring_mem;
+  uring->sq.head  = (uint *)(ring_base + params->sq_off.head        );
+  uring->sq.tail  = (uint *)(ring_base + params->sq_off.tail        );
+  uring->sq.flags = (uint *)(ring_base + params->sq_off.flags       );
+  uring->sq.mask  = *(uint *)(ring_base + params->sq_off.ring_mask  );
+  uring->sq.array = (uint *)(ring_base + params->sq_off.array       );
+  uring->cq.head  = (uint *)(ring_base + params->cq_off.head        );
+  uring->cq.tail  = (uint *)(ring_base + params->cq_off.tail        );
+  uring->cq.flags = (uint *)(ring_base + params->cq_off.flags       );
+  uring->cq.mask  = *(uint *)(ring_base + params->cq_off.ring_mask  );
+  uring->cq.cqes  = (struct io_uring_cqe *)(ring_base + params->cq_off.cqes);
+
+  return uring;
+}
+
+void
+fd_uring_unmap( fd_uring_t * uring ) {
+  if( uring->sqes     ) munmap( uring->sqes,     uring->sqes_map_sz );
+  if( uring->ring_mem ) munmap( uring->ring_mem, uring->ring_map_sz );
+  if( uring->ring_fd>=0 ) close( uring->ring_fd );
+  uring->sqes     = NULL;
+  uring->ring_mem = NULL;
+  uring->ring_fd  = -1;
+}
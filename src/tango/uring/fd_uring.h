@@ -0,0 +1,92 @@
+#ifndef HEADER_fd_src_tango_uring_fd_uring_h
+#define HEADER_fd_src_tango_uring_fd_uring_h
+
+#if defined(__linux__)
+
+/* fd_uring provides the raw io_uring plumbing shared by the io_uring
+   users of the tree (e.g. fd_uring_aio and the capture tile): syscall
+   wrappers (glibc does not provide them) and mapping of the kernel
+   managed SQ / CQ rings and SQE array into the local address space.
+   Users build and consume SQEs / CQEs directly through the mapped
+   rings. */
+
+#include "../fd_tango_base.h"
+
+#include <linux/io_uring.h>
+
+/* fd_uring_ring_t describes an io_uring submission or completion queue
+   in the thread group's local address space.  All pointers fall into
+   kernel-managed ring memory mmap'ed by fd_uring_map.  head and tail
+   are free running uint sequence numbers. */
+
+struct fd_uring_ring {
+  uint * head;  /* Points to head seq in shared ring */
+  uint * tail;  /* Points to tail seq in shared ring */
+  uint * flags; /* Points to ring flags */
+  uint   mask;  /* Ring depth - 1 */
+  union {
+    uint *                array; /* For the SQ, SQE index array */
+    struct io_uring_cqe * cqes;  /* For the CQ */
+  };
+};
+
+typedef struct fd_uring_ring fd_uring_ring_t;
+
+/* fd_uring_t is a mapped io_uring instance.  An fd_uring_t holds local
+   addresses so it may not be shared across thread groups. */
+
+struct fd_uring {
+  int                   ring_fd;     /* -1 if not mapped */
+  fd_uring_ring_t       sq;
+  fd_uring_ring_t       cq;
+  struct io_uring_sqe * sqes;
+  void *                ring_mem;    /* SQ and CQ rings mmap region (single mmap) */
+  ulong                 ring_map_sz;
+  ulong                 sqes_map_sz;
+};
+
+typedef struct fd_uring fd_uring_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* io_uring syscall wrappers.  Return as the corresponding syscall
+   (-1 with errno set on failure). */
+
+int
+fd_uring_sys_setup( uint                     entries,
+                    struct io_uring_params * params );
+
+int
+fd_uring_sys_enter( int  ring_fd,
+                    uint to_submit,
+                    uint min_complete,
+                    uint flags );
+
+int
+fd_uring_sys_register( int    ring_fd,
+                       uint   opcode,
+                       void * arg,
+                       uint   arg_cnt );
+
+/* fd_uring_map maps the rings of the io_uring instance ring_fd created
+   by fd_uring_sys_setup with the given params into uring.  The kernel
+   should support IORING_FEAT_SINGLE_MMAP.  uring takes ownership of
+   ring_fd.  Returns uring on success and NULL on failure (logs details,
+   ring_fd is closed and uring is left unmapped). */
+
+fd_uring_t *
+fd_uring_map( fd_uring_t *                   uring,
+              int                            ring_fd,
+              struct io_uring_params const * params );
+
+/* fd_uring_unmap unmaps the rings of a (possibly partially) mapped or
+   unmapped uring and closes its ring_fd.  uring is unmapped on
+   return. */
+
+void
+fd_uring_unmap( fd_uring_t * uring );
+
+FD_PROTOTYPES_END
+
+#endif /* defined(__linux__) */
+#endif /* HEADER_fd_src_tango_uring_fd_uring_h */
@@ -0,0 +1,599 @@
+#if !defined(__linux__)
+#error "fd_uring_aio requires Linux operating system with io_uring support"
+#endif
+
+#include "../../util/fd_util.h"
+#include "fd_uring_aio_private.h"
+
+#include <errno.h>
+#include <stddef.h>
+
+/* Only the kernel writes the rings' other ends.  The kernel reads them
+   with acquire / release semantics and the x86 memory model makes
+   compiler fences sufficient on this side (as in fd_xsk). */
+
+#define FD_ACQUIRE FD_COMPILER_MFENCE
+#define FD_RELEASE FD_COMPILER_MFENCE
+
+/* FD_URING_AIO_CANCEL_USER_DATA tags the completion of the cancel
+   issued on leave. */
+
+#define FD_URING_AIO_CANCEL_USER_DATA (ULONG_MAX-1UL)
+
+/* Forward declarations */
+
+static int
+fd_uring_aio_send( void *                    ctx,
+                   fd_aio_pkt_info_t const * batch,
+                   ulong                     batch_cnt,
+                   ulong *                   opt_batch_idx );
+
+/* fd_uring_aio_private_footprint computes the memory layout of an
+   fd_uring_aio_t.  Returns the footprint (0 if the params are invalid)
+   and, if uring_aio is non-NULL, stores the layout in it. */
+
+static ulong
+fd_uring_aio_private_footprint( ulong            rx_depth,
+                                ulong            tx_depth,
+                                ulong            buf_sz,
+                                ulong            pkt_cnt,
+                                fd_uring_aio_t * uring_aio ) {
+  if( FD_UNLIKELY( (!rx_depth) | (rx_depth>FD_URING_AIO_RX_DEPTH_MAX) | (!fd_ulong_is_pow2( rx_depth )) ) ) return 0UL;
+  if( FD_UNLIKELY( (!tx_depth) | (tx_depth>FD_URING_AIO_TX_DEPTH_MAX)                                   ) ) return 0UL;
+  if( FD_UNLIKELY( (buf_sz<128UL) | (buf_sz>65536UL) | (!fd_ulong_is_aligned( buf_sz, 64UL ))           ) ) return 0UL;
+  if( FD_UNLIKELY( (!pkt_cnt) | (pkt_cnt>FD_URING_AIO_RX_DEPTH_MAX)                                     ) ) return 0UL;
+
+  ulong buf_ring_off = fd_ulong_align_up( sizeof(fd_uring_aio_t), FD_URING_AIO_ALIGN );
+  ulong rx_buf_off   = fd_ulong_align_up( buf_ring_off + rx_depth*sizeof(struct io_uring_buf), 64UL );
+  ulong tx_buf_off   = rx_buf_off + rx_depth*buf_sz;
+  ulong tx_msg_off   = tx_buf_off + tx_depth*buf_sz;
+  ulong tx_stack_off = fd_ulong_align_up( tx_msg_off + tx_depth*sizeof(fd_uring_aio_tx_msg_t), alignof(ulong) );
+  ulong pkt_off      = fd_ulong_align_up( tx_stack_off + tx_depth*sizeof(ulong), FD_AIO_PKT_INFO_ALIGN );
+  ulong bid_off      = pkt_off + pkt_cnt*sizeof(fd_aio_pkt_info_t);
+  ulong footprint    = fd_ulong_align_up( bid_off + pkt_cnt*sizeof(ushort), FD_URING_AIO_ALIGN );
+
+  if( uring_aio ) {
+    uring_aio->rx_depth     = rx_depth;
+    uring_aio->tx_depth     = tx_depth;
+    uring_aio->buf_sz       = buf_sz;
+    uring_aio->pkt_cnt      = pkt_cnt;
+    uring_aio->buf_ring_off = buf_ring_off;
+    uring_aio->rx_buf_off   = rx_buf_off;
+    uring_aio->tx_buf_off   = tx_buf_off;
+    uring_aio->tx_msg_off   = tx_msg_off;
+    uring_aio->tx_stack_off = tx_stack_off;
+    uring_aio->pkt_off      = pkt_off;
+    uring_aio->bid_off      = bid_off;
+  }
+
+  return footprint;
+}
+
+ulong
+fd_uring_aio_align( void ) {
+  return FD_URING_AIO_ALIGN;
+}
+
+ulong
+fd_uring_aio_footprint( ulong rx_depth,
+                        ulong tx_depth,
+                        ulong buf_sz,
+                        ulong pkt_cnt ) {
+  return fd_uring_aio_private_footprint( rx_depth, tx_depth, buf_sz, pkt_cnt, NULL );
+}
+
+void *
+fd_uring_aio_new( void * mem,
+                  ulong  rx_depth,
+                  ulong  tx_depth,
+                  ulong  buf_sz,
+                  ulong  pkt_cnt ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_uring_aio_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_uring_aio_footprint( rx_depth, tx_depth, buf_sz, pkt_cnt );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "invalid footprint for rx_depth (%lu), tx_depth (%lu), buf_sz (%lu), pkt_cnt (%lu)",
+                     rx_depth, tx_depth, buf_sz, pkt_cnt ));
+    return NULL;
+  }
+
+  fd_memset( mem, 0, footprint );
+
+  fd_uring_aio_t * uring_aio = (fd_uring_aio_t *)mem;
+
+  fd_uring_aio_private_footprint( rx_depth, tx_depth, buf_sz, pkt_cnt, uring_aio );
+
+  uring_aio->sock_fd = -1;
+  uring_aio->uring.ring_fd = -1;
+
+  /* Mark object as valid */
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( uring_aio->magic ) = FD_URING_AIO_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return uring_aio;
+}
+
+/* fd_uring_aio_private_sqe returns the i-th free SQE past the current
+   SQ tail (zeroed) or NULL if the SQ does not have that many free
+   entries.  SQEs are made visible to the kernel by
+   fd_uring_aio_private_sqe_commit. */
+
+static struct io_uring_sqe *
+fd_uring_aio_private_sqe( fd_uring_aio_t * uring_aio,
+                          uint             i ) {
+  fd_uring_ring_t * sq   = &uring_aio->uring.sq;
+  uint              tail = *sq->tail + i; /* Only written by us */
+  uint              head = FD_VOLATILE_CONST( *sq->head );
+  if( FD_UNLIKELY( tail-head>sq->mask ) ) return NULL;
+  uint idx = tail & sq->mask;
+  struct io_uring_sqe * sqe = uring_aio->uring.sqes + idx;
+  memset( sqe, 0, sizeof(struct io_uring_sqe) );
+  sq->array[ idx ] = idx;
+  return sqe;
+}
+
+static void
+fd_uring_aio_private_sqe_commit( fd_uring_aio_t * uring_aio,
+                                 uint             cnt ) {
+  fd_uring_ring_t * sq = &uring_aio->uring.sq;
+  FD_RELEASE();
+  FD_VOLATILE( *sq->tail ) = *sq->tail + cnt;
+  uring_aio->sq_pending += cnt;
+}
+
+/* fd_uring_aio_private_enter submits pending SQEs and, if flags has
+   IORING_ENTER_GETEVENTS, runs pending completion work. */
+
+static void
+fd_uring_aio_private_enter( fd_uring_aio_t * uring_aio,
+                            uint             flags ) {
+  int ret = fd_uring_sys_enter( uring_aio->uring.ring_fd, uring_aio->sq_pending, 0U, flags );
+  if( FD_UNLIKELY( ret<0 ) ) {
+    /* EAGAIN / EBUSY: the kernel is out of resources or the CQ is
+       backlogged, pending SQEs are retried by the next service */
+    if( FD_UNLIKELY( (errno!=EAGAIN) & (errno!=EBUSY) & (errno!=EINTR) ) )
+      FD_LOG_WARNING(( "io_uring_enter failed (%i-%s)", errno, strerror( errno ) ));
+    return;
+  }
+  uring_aio->sq_pending -= (uint)ret;
+}
+
+/* fd_uring_aio_private_rx_arm (re)starts the multishot recvmsg if it
+   is not in flight.  Retried on the next service if the SQ is full. */
+
+static void
+fd_uring_aio_private_rx_arm( fd_uring_aio_t * uring_aio ) {
+  if( uring_aio->rx_armed ) return;
+  struct io_uring_sqe * sqe = fd_uring_aio_private_sqe( uring_aio, 0U );
+  if( FD_UNLIKELY( !sqe ) ) return;
+  sqe->opcode    = IORING_OP_RECVMSG;
+  sqe->fd        = uring_aio->sock_fd;
+  sqe->addr      = (ulong)&uring_aio->rx_msg;
+  sqe->len       = 1U;
+  sqe->ioprio    = IORING_RECV_MULTISHOT;
+  sqe->flags     = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = 0;
+  sqe->user_data = FD_URING_AIO_RX_USER_DATA;
+  fd_uring_aio_private_sqe_commit( uring_aio, 1U );
+  uring_aio->rx_armed = 1;
+}
+
+/* fd_uring_aio_private_rx_recycle gives the RX buffers bid[i] for i in
+   [0,bid_cnt) back to the kernel. */
+
+static void
+fd_uring_aio_private_rx_recycle( fd_uring_aio_t * uring_aio,
+                                 ushort const *   bid,
+                                 ulong            bid_cnt ) {
+  struct io_uring_buf * ring   = fd_uring_aio_buf_ring( uring_aio );
+  uchar *               rx_buf = fd_uring_aio_rx_buf  ( uring_aio );
+  ulong                 buf_sz = uring_aio->buf_sz;
+  ulong                 mask   = uring_aio->rx_depth - 1UL;
+  ushort                tail   = uring_aio->buf_tail;
+
+  /* Note: the ring tail overlays the resv field of ring[0] so the
+     entries are written field by field */
+
+  for( ulong i=0UL; i<bid_cnt; i++ ) {
+    struct io_uring_buf * buf = ring + (((ulong)tail + i) & mask);
+    buf->addr = (ulong)(rx_buf + (ulong)bid[i]*buf_sz);
+    buf->len  = (uint)buf_sz;
+    buf->bid  = bid[i];
+  }
+  tail = (ushort)(tail + bid_cnt);
+
+  FD_RELEASE();
+  FD_VOLATILE( *(ushort *)((ulong)ring + offsetof(struct io_uring_buf_ring, tail)) ) = tail;
+  uring_aio->buf_tail = tail;
+}
+
+/* fd_uring_aio_private_reap consumes completions until the CQ is empty
+   or pkt_cnt RX buffers were consumed.  Received datagrams are appended
+   to the uring_aio's pkts (returns their count at *_pkt_cnt) and the
+   consumed RX buffers to its bids (returns the count).  TX buffers of
+   completed sends go back to the free stack. */
+
+static ulong
+fd_uring_aio_private_reap( fd_uring_aio_t * uring_aio,
+                           ulong *          _pkt_cnt ) {
+  fd_uring_ring_t *   cq       = &uring_aio->uring.cq;
+  fd_aio_pkt_info_t * pkt      = fd_uring_aio_pkts    ( uring_aio );
+  ushort *            bid      = fd_uring_aio_bids    ( uring_aio );
+  ulong *             tx_stack = fd_uring_aio_tx_stack( uring_aio );
+  uchar *             rx_buf   = fd_uring_aio_rx_buf  ( uring_aio );
+  ulong               buf_sz   = uring_aio->buf_sz;
+  ulong               bid_max  = uring_aio->pkt_cnt;
+
+  uint head = *cq->head; /* Only written by us */
+  uint tail = FD_VOLATILE_CONST( *cq->tail );
+  FD_ACQUIRE();
+
+  ulong pkt_cnt = 0UL;
+  ulong bid_cnt = 0UL;
+  while( (head!=tail) & (bid_cnt<bid_max) ) {
+    struct io_uring_cqe const * cqe = cq->cqes + (head & cq->mask);
+    head++;
+
+    ulong user_data = cqe->user_data;
+    int   res       = cqe->res;
+    uint  flags     = cqe->flags;
+
+    if( FD_LIKELY( user_data==FD_URING_AIO_RX_USER_DATA ) ) {
+
+      if( FD_UNLIKELY( !(flags & IORING_CQE_F_MORE) ) ) uring_aio->rx_armed = 0; /* Multishot ended, rearm */
+
+      if( FD_LIKELY( flags & IORING_CQE_F_BUFFER ) ) {
+        ushort b = (ushort)(flags >> IORING_CQE_BUFFER_SHIFT);
+        bid[ bid_cnt++ ] = b;
+        if( FD_LIKELY( res>=0 ) ) {
+          /* rx_msg has no name or control space so the payload directly
+             follows the recvmsg out header */
+          struct io_uring_recvmsg_out const * out = (struct io_uring_recvmsg_out const *)(rx_buf + (ulong)b*buf_sz);
+          if( FD_UNLIKELY( out->flags & MSG_TRUNC ) ) uring_aio->rx_drop_cnt++;
+          else pkt[ pkt_cnt++ ] = (fd_aio_pkt_info_t){ .buf = (void *)(out+1), .buf_sz = (ushort)out->payloadlen };
+        }
+      } else if( FD_UNLIKELY( (res<0) & (res!=-ENOBUFS) & (res!=-ECANCELED) ) ) {
+        /* ENOBUFS just means all RX buffers were in use */
+        FD_LOG_WARNING(( "multishot recvmsg failed (%i-%s)", -res, strerror( -res ) ));
+      }
+
+    } else if( FD_LIKELY( user_data<uring_aio->tx_depth ) ) {
+
+      if( FD_UNLIKELY( res<0 ) ) uring_aio->tx_err_cnt++;
+      tx_stack[ uring_aio->tx_top++ ] = user_data;
+
+    } /* else cancel completion */
+  }
+
+  FD_RELEASE();
+  FD_VOLATILE( *cq->head ) = head;
+
+  *_pkt_cnt = pkt_cnt;
+  return bid_cnt;
+}
+
+/* fd_uring_aio_private_setup creates an io_uring instance, preferring
+   modes where completion work is only run when asked for (no
+   interrupts of the tile).  Returns the ring fd (and sets *_taskrun_flag
+   if the kernel will flag pending completion work in the SQ flags) or
+   -1 on failure (logs details). */
+
+static int
+fd_uring_aio_private_setup( uint                     sq_depth,
+                            uint                     cq_depth,
+                            struct io_uring_params * params,
+                            int *                    _taskrun_flag ) {
+  static uint const setup_flags[3] = {
+    IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_TASKRUN_FLAG, /* Linux 6.1+ */
+    IORING_SETUP_COOP_TASKRUN  | IORING_SETUP_TASKRUN_FLAG,                              /* Linux 5.19+ */
+    0U
+  };
+  for( ulong i=0UL; i<3UL; i++ ) {
+    memset( params, 0, sizeof(struct io_uring_params) );
+    params->flags      = setup_flags[i] | IORING_SETUP_CQSIZE;
+    params->cq_entries = cq_depth;
+    int ring_fd = fd_uring_sys_setup( sq_depth, params );
+    if( FD_LIKELY( ring_fd>=0 ) ) {
+      *_taskrun_flag = !!(setup_flags[i] & IORING_SETUP_TASKRUN_FLAG);
+      return ring_fd;
+    }
+    if( errno!=EINVAL ) break; /* EINVAL <> setup flags unsupported by this kernel */
+  }
+  FD_LOG_WARNING(( "io_uring_setup failed (%i-%s)", errno, strerror( errno ) ));
+  return -1;
+}
+
+fd_uring_aio_t *
+fd_uring_aio_join( void * shuring_aio,
+                   int    sock_fd ) {
+
+  if( FD_UNLIKELY( !shuring_aio ) ) {
+    FD_LOG_WARNING(( "NULL shuring_aio" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shuring_aio, fd_uring_aio_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shuring_aio" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( sock_fd<0 ) ) {
+    FD_LOG_WARNING(( "bad sock_fd" ));
+    return NULL;
+  }
+
+  fd_uring_aio_t * uring_aio = (fd_uring_aio_t *)shuring_aio;
+
+  if( FD_UNLIKELY( uring_aio->magic!=FD_URING_AIO_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic (not an fd_uring_aio_t?)" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( uring_aio->uring.ring_fd>=0 ) ) {
+    FD_LOG_WARNING(( "uring_aio in an unclean state, resetting" ));
+    /* continue */
+  }
+
+  /* Reset state */
+
+  ulong rx_depth = uring_aio->rx_depth;
+  ulong tx_depth = uring_aio->tx_depth;
+  ulong buf_sz   = uring_aio->buf_sz;
+
+  uring_aio->sock_fd     = sock_fd;
+  uring_aio->rx_armed    = 0;
+  uring_aio->sq_pending  = 0U;
+  uring_aio->buf_tail    = 0;
+  uring_aio->tx_top      = 0UL;
+  uring_aio->rx_drop_cnt = 0UL;
+  uring_aio->tx_err_cnt  = 0UL;
+  memset( &uring_aio->uring,  0, sizeof(fd_uring_t)    );
+  memset( &uring_aio->rx,     0, sizeof(fd_aio_t)      );
+  memset( &uring_aio->rx_msg, 0, sizeof(struct msghdr) );
+  uring_aio->uring.ring_fd = -1;
+
+  /* Create the io_uring.  The SQ holds the multishot recvmsg and a send
+     per TX buffer.  The CQ is sized to hold a completion per buffer
+     (the kernel buffers any overflow). */
+
+  uint sq_depth = (uint)fd_ulong_pow2_up( tx_depth + 1UL );
+  uint cq_depth = (uint)fd_ulong_pow2_up( rx_depth + tx_depth + 1UL );
+
+  struct io_uring_params params[1];
+  int ring_fd = fd_uring_aio_private_setup( sq_depth, cq_depth, params, &uring_aio->taskrun_flag );
+  if( FD_UNLIKELY( ring_fd<0 ) ) return NULL;
+
+  if( FD_UNLIKELY( !fd_uring_map( &uring_aio->uring, ring_fd, params ) ) ) return NULL;
+
+  /* Register the RX buffer ring (buffer group 0) and give the kernel
+     all RX buffers */
+
+  struct io_uring_buf_reg reg[1];
+  memset( reg, 0, sizeof(struct io_uring_buf_reg) );
+  reg->ring_addr    = (ulong)fd_uring_aio_buf_ring( uring_aio );
+  reg->ring_entries = (uint)rx_depth;
+  reg->bgid         = 0;
+  if( FD_UNLIKELY( fd_uring_sys_register( ring_fd, IORING_REGISTER_PBUF_RING, reg, 1U ) ) ) {
+    FD_LOG_WARNING(( "IORING_REGISTER_PBUF_RING failed (%i-%s)", errno, strerror( errno ) ));
+    fd_uring_unmap( &uring_aio->uring );
+    return NULL;
+  }
+
+  ushort * bid = fd_uring_aio_bids( uring_aio );
+  for( ulong b0=0UL; b0<rx_depth; b0+=uring_aio->pkt_cnt ) {
+    ulong bid_cnt = fd_ulong_min( rx_depth-b0, uring_aio->pkt_cnt );
+    for( ulong i=0UL; i<bid_cnt; i++ ) bid[i] = (ushort)(b0+i);
+    fd_uring_aio_private_rx_recycle( uring_aio, bid, bid_cnt );
+  }
+
+  /* Setup TX buffers */
+
+  uchar *                 tx_buf   = fd_uring_aio_tx_buf  ( uring_aio );
+  fd_uring_aio_tx_msg_t * tx_msg   = fd_uring_aio_tx_msg  ( uring_aio );
+  ulong *                 tx_stack = fd_uring_aio_tx_stack( uring_aio );
+  for( ulong tx_idx=0UL; tx_idx<tx_depth; tx_idx++ ) {
+    fd_uring_aio_tx_msg_t * m = tx_msg + tx_idx;
+    memset( m, 0, sizeof(fd_uring_aio_tx_msg_t) );
+    m->iov.iov_base   = tx_buf + tx_idx*buf_sz;
+    m->msg.msg_iov    = &m->iov;
+    m->msg.msg_iovlen = 1UL;
+    tx_stack[ uring_aio->tx_top++ ] = tx_idx;
+  }
+
+  fd_aio_t * tx = fd_aio_join( fd_aio_new( &uring_aio->tx, uring_aio, fd_uring_aio_send ) );
+  if( FD_UNLIKELY( !tx ) ) {
+    FD_LOG_WARNING(( "Failed to join local tx aio" ));
+    fd_uring_unmap( &uring_aio->uring );
+    return NULL;
+  }
+
+  /* Start receiving */
+
+  fd_uring_aio_private_rx_arm( uring_aio );
+  fd_uring_aio_private_enter( uring_aio, 0U );
+
+  return uring_aio;
+}
+
+void *
+fd_uring_aio_leave( fd_uring_aio_t * uring_aio ) {
+
+  if( FD_UNLIKELY( !uring_aio ) ) {
+    FD_LOG_WARNING(( "NULL uring_aio" ));
+    return NULL;
+  }
+
+  /* Cancel the multishot recvmsg and wait for it to end such that the
+     kernel is done writing to the RX buffers before the caller gets the
+     memory region back */
+
+  if( FD_LIKELY( uring_aio->uring.ring_fd>=0 ) ) {
+    struct io_uring_sqe * sqe = uring_aio->rx_armed ? fd_uring_aio_private_sqe( uring_aio, 0U ) : NULL;
+    if( FD_LIKELY( sqe ) ) {
+      sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+      sqe->fd        = -1;
+      sqe->addr      = FD_URING_AIO_RX_USER_DATA;
+      sqe->user_data = FD_URING_AIO_CANCEL_USER_DATA;
+      fd_uring_aio_private_sqe_commit( uring_aio, 1U );
+    }
+    for( ulong rem=1024UL; uring_aio->rx_armed && rem; rem-- ) {
+      int ret = fd_uring_sys_enter( uring_aio->uring.ring_fd, uring_aio->sq_pending, 1U, IORING_ENTER_GETEVENTS );
+      if( FD_LIKELY( ret>=0 ) ) uring_aio->sq_pending -= (uint)ret;
+      ulong pkt_cnt;
+      ulong bid_cnt = fd_uring_aio_private_reap( uring_aio, &pkt_cnt );
+      fd_uring_aio_private_rx_recycle( uring_aio, fd_uring_aio_bids( uring_aio ), bid_cnt ); /* Discard */
+    }
+    if( FD_UNLIKELY( uring_aio->rx_armed ) ) FD_LOG_WARNING(( "multishot recvmsg did not terminate" ));
+  }
+
+  fd_uring_unmap( &uring_aio->uring );
+
+  fd_aio_delete( fd_aio_leave( &uring_aio->rx ) );
+  fd_aio_delete( fd_aio_leave( &uring_aio->tx ) );
+
+  uring_aio->sock_fd = -1;
+
+  return (void *)uring_aio;
+}
+
+void *
+fd_uring_aio_delete( void * shuring_aio ) {
+
+  if( FD_UNLIKELY( !shuring_aio ) ) {
+    FD_LOG_WARNING(( "NULL shuring_aio" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shuring_aio, fd_uring_aio_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shuring_aio" ));
+    return NULL;
+  }
+
+  fd_uring_aio_t * uring_aio = (fd_uring_aio_t *)shuring_aio;
+
+  if( FD_UNLIKELY( uring_aio->magic!=FD_URING_AIO_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( uring_aio->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return (void *)uring_aio;
+}
+
+fd_aio_t const *
+fd_uring_aio_get_tx( fd_uring_aio_t const * uring_aio ) {
+  return &uring_aio->tx;
+}
+
+void
+fd_uring_aio_set_rx( fd_uring_aio_t * uring_aio,
+                     fd_aio_t const * aio ) {
+  if( aio ) fd_memcpy( &uring_aio->rx, aio, sizeof(fd_aio_t) );
+  else      memset   ( &uring_aio->rx, 0,   sizeof(fd_aio_t) );
+}
+
+ulong fd_uring_aio_rx_mtu     ( fd_uring_aio_t const * uring_aio ) { return uring_aio->buf_sz - sizeof(struct io_uring_recvmsg_out); }
+ulong fd_uring_aio_rx_drop_cnt( fd_uring_aio_t const * uring_aio ) { return uring_aio->rx_drop_cnt; }
+ulong fd_uring_aio_tx_err_cnt ( fd_uring_aio_t const * uring_aio ) { return uring_aio->tx_err_cnt;  }
+
+void
+fd_uring_aio_service( fd_uring_aio_t * uring_aio ) {
+
+  /* Submit SQEs the kernel did not take yet and, if the kernel flagged
+     completion work (or a CQ overflow backlog), run it */
+
+  uint sq_flags    = FD_VOLATILE_CONST( *uring_aio->uring.sq.flags );
+  uint enter_flags = ( (uring_aio->taskrun_flag & !!(sq_flags & IORING_SQ_TASKRUN)) | !!(sq_flags & IORING_SQ_CQ_OVERFLOW) )
+                   ? IORING_ENTER_GETEVENTS : 0U;
+  if( FD_UNLIKELY( uring_aio->sq_pending | enter_flags ) ) fd_uring_aio_private_enter( uring_aio, enter_flags );
+
+  /* Reap completions, forward received datagrams to the aio and give
+     the buffers back to the kernel */
+
+  ulong pkt_cnt;
+  ulong bid_cnt = fd_uring_aio_private_reap( uring_aio, &pkt_cnt );
+
+  if( FD_LIKELY( pkt_cnt && uring_aio->rx.send_func ) )
+    fd_aio_send( &uring_aio->rx, fd_uring_aio_pkts( uring_aio ), pkt_cnt, NULL );
+
+  if( FD_LIKELY( bid_cnt ) ) fd_uring_aio_private_rx_recycle( uring_aio, fd_uring_aio_bids( uring_aio ), bid_cnt );
+
+  /* Restart receiving if the multishot recvmsg ended (e.g. it ran out
+     of buffers) */
+
+  if( FD_UNLIKELY( !uring_aio->rx_armed ) ) {
+    fd_uring_aio_private_rx_arm( uring_aio );
+    fd_uring_aio_private_enter( uring_aio, 0U );
+  }
+}
+
+/* fd_uring_aio_send is an aio callback that transmits the given batch
+   of packets through the socket. */
+
+static int
+fd_uring_aio_send( void *                    ctx,
+                   fd_aio_pkt_info_t const * pkt,
+                   ulong                     pkt_cnt,
+                   ulong *                   opt_batch_idx ) {
+  if( FD_UNLIKELY( pkt_cnt==0UL ) ) return FD_AIO_SUCCESS;
+
+  fd_uring_aio_t *        uring_aio = (fd_uring_aio_t *)ctx;
+  uchar *                 tx_buf    = fd_uring_aio_tx_buf  ( uring_aio );
+  fd_uring_aio_tx_msg_t * tx_msg    = fd_uring_aio_tx_msg  ( uring_aio );
+  ulong *                 tx_stack  = fd_uring_aio_tx_stack( uring_aio );
+  ulong                   buf_sz    = uring_aio->buf_sz;
+
+  /* Stage one sendmsg per packet until the batch is done, we run out of
+     TX buffers / SQEs or hit a packet too large to send */
+
+  int   err     = FD_AIO_SUCCESS;
+  uint  sqe_cnt = 0U;
+  ulong pkt_idx;
+  for( pkt_idx=0UL; pkt_idx<pkt_cnt; pkt_idx++ ) {
+    ulong data_sz = pkt[ pkt_idx ].buf_sz;
+    if( FD_UNLIKELY( !data_sz ) ) continue;
+
+    if( FD_UNLIKELY( data_sz>buf_sz ) ) {
+      FD_LOG_WARNING(( "packet too large for uring_aio buffers (%lu > %lu), aborting send", data_sz, buf_sz ));
+      err = FD_AIO_ERR_INVAL;
+      break;
+    }
+
+    if( FD_UNLIKELY( !uring_aio->tx_top ) ) { err = FD_AIO_ERR_AGAIN; break; }
+    struct io_uring_sqe * sqe = fd_uring_aio_private_sqe( uring_aio, sqe_cnt );
+    if( FD_UNLIKELY( !sqe ) ) { err = FD_AIO_ERR_AGAIN; break; }
+
+    ulong tx_idx = tx_stack[ --uring_aio->tx_top ];
+    fd_memcpy( tx_buf + tx_idx*buf_sz, pkt[ pkt_idx ].buf, data_sz );
+    tx_msg[ tx_idx ].iov.iov_len = data_sz;
+
+    sqe->opcode    = IORING_OP_SENDMSG;
+    sqe->fd        = uring_aio->sock_fd;
+    sqe->addr      = (ulong)&tx_msg[ tx_idx ].msg;
+    sqe->len       = 1U;
+    sqe->user_data = tx_idx;
+    sqe_cnt++;
+  }
+
+  if( FD_LIKELY( sqe_cnt ) ) {
+    fd_uring_aio_private_sqe_commit( uring_aio, sqe_cnt );
+    fd_uring_aio_private_enter( uring_aio, 0U );
+  }
+
+  if( FD_UNLIKELY( err ) && opt_batch_idx ) *opt_batch_idx = pkt_idx;
+  return err;
+}
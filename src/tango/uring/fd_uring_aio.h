@@ -0,0 +1,148 @@
+#ifndef HEADER_fd_src_tango_uring_fd_uring_aio_h
+#define HEADER_fd_src_tango_uring_fd_uring_aio_h
+
+#if defined(__linux__)
+
+#include "../aio/fd_aio.h"
+
+/* fd_uring_aio_t is an fd_aio driver for a datagram socket (e.g. a UDP
+   socket) backed by io_uring.  It is meant for hosts that cannot run
+   XDP (see fd_xsk_aio for the AF_XDP driver) and exposes the same
+   set_rx / get_tx / service interface.
+
+   RX: a single multishot recvmsg keeps receiving datagrams into a pool
+   of rx_depth buffers of buf_sz bytes, the kernel picking free buffers
+   from a provided buffer ring.  fd_uring_aio_service reaps completions,
+   delivers up to pkt_cnt datagrams per call to the aio given to
+   fd_uring_aio_set_rx and then hands the buffers back to the kernel.
+   A datagram is delivered as its payload (i.e. unlike fd_xsk_aio there
+   are no Ethernet / IP / UDP headers).  Datagrams larger than
+   fd_uring_aio_rx_mtu() are dropped.
+
+   TX: each aio send copies its batch into free TX buffers (there are
+   tx_depth of them) and submits one sendmsg per packet with a single
+   io_uring_enter.  Packets are sent to the socket's default destination
+   so a socket used for TX should be connected.
+
+   The buffer pool and buffer ring live in the fd_uring_aio_t memory
+   region (e.g. a wksp allocation).  The io_uring instance itself is
+   created on join and holds local addresses of that region, so an
+   fd_uring_aio_t may not be shared across thread groups and should be
+   serviced by the thread that joined it. */
+
+#define FD_URING_AIO_ALIGN (4096UL) /* The kernel requires the buffer ring to be page aligned */
+
+/* FD_URING_AIO_{RX,TX}_DEPTH_MAX are the largest supported
+   rx_depth / tx_depth (limited by the io_uring buffer ring and
+   submission queue sizes). */
+
+#define FD_URING_AIO_RX_DEPTH_MAX (32768UL)
+#define FD_URING_AIO_TX_DEPTH_MAX (16384UL)
+
+struct __attribute__((aligned(FD_URING_AIO_ALIGN))) fd_uring_aio_private;
+typedef struct fd_uring_aio_private fd_uring_aio_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_uring_aio_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as an fd_uring_aio_t.
+   rx_depth is the number of RX buffers (a power of 2 in
+   [1,FD_URING_AIO_RX_DEPTH_MAX]), tx_depth is the number of TX buffers
+   (in [1,FD_URING_AIO_TX_DEPTH_MAX]), buf_sz is the size in bytes of
+   each buffer (a multiple of 64 in [128,65536]) and pkt_cnt is the max
+   number of packets to deliver per fd_uring_aio_service() call (in
+   [1,FD_URING_AIO_RX_DEPTH_MAX]).
+   footprint returns 0 if any of these is invalid. */
+
+FD_FN_CONST ulong
+fd_uring_aio_align( void );
+
+FD_FN_CONST ulong
+fd_uring_aio_footprint( ulong rx_depth,
+                        ulong tx_depth,
+                        ulong buf_sz,
+                        ulong pkt_cnt );
+
+/* fd_uring_aio_new formats an unused memory region for use as an
+   fd_uring_aio_t.  mem must point to a memory region that matches
+   fd_uring_aio_align() and fd_uring_aio_footprint().  Returns handle
+   suitable for fd_uring_aio_join() on success and NULL on failure (logs
+   details). */
+
+void *
+fd_uring_aio_new( void * mem,
+                  ulong  rx_depth,
+                  ulong  tx_depth,
+                  ulong  buf_sz,
+                  ulong  pkt_cnt );
+
+/* fd_uring_aio_join joins the caller to the uring_aio and sock_fd.
+   sock_fd should be an open datagram socket (bound if used for RX,
+   connected if used for TX) that outlives the join.  Creates the
+   io_uring instance, registers the RX buffer ring and starts
+   receiving.  Returns a pointer in the local address space to the
+   fd_uring_aio_t on success or NULL on failure (logs details).  Reasons
+   for failure include uring_aio is obviously not a fd_uring_aio_t and
+   io_uring being unsupported / disabled on this host (Linux 6.0 or
+   newer is required for multishot recvmsg).  There may only be one
+   active join at any given time. */
+
+fd_uring_aio_t *
+fd_uring_aio_join( void * uring_aio,
+                   int    sock_fd );
+
+/* fd_uring_aio_leave leaves a current local join, destroying the
+   io_uring instance (any TX still in flight may or may not be sent).
+   Does not close sock_fd.  Returns a pointer to the underlying memory
+   region on success and NULL on failure (logs details). */
+
+void *
+fd_uring_aio_leave( fd_uring_aio_t * uring_aio );
+
+/* fd_uring_aio_delete unformats a memory region used as an
+   fd_uring_aio_t.  Assumes nobody is joined to the region.  Returns a
+   pointer to the underlying memory region or NULL if used obviously in
+   error.  The ownership of the memory region is transferred to the
+   caller on success. */
+
+void *
+fd_uring_aio_delete( void * uring_aio );
+
+/* fd_uring_aio_set_rx sets the fd_aio_t instance called back with
+   received datagrams (NULL to discard them).  Requires periodic
+   fd_uring_aio_service() calls.  Delivered buffers are only valid for
+   the duration of the callback. */
+
+void
+fd_uring_aio_set_rx( fd_uring_aio_t * uring_aio,
+                     fd_aio_t const * aio );
+
+/* fd_uring_aio_get_tx gets the fd_aio_t instance to send datagrams via
+   sock_fd.  An aio send may yield FD_AIO_ERR_AGAIN if all TX buffers
+   are in flight (TX buffers are reclaimed by fd_uring_aio_service()) and
+   FD_AIO_ERR_INVAL if a packet is larger than buf_sz (packets before it
+   are sent). */
+
+FD_FN_CONST fd_aio_t const *
+fd_uring_aio_get_tx( fd_uring_aio_t const * uring_aio );
+
+/* fd_uring_aio_service delivers received datagrams to the RX aio,
+   returns their buffers to the kernel and reclaims TX buffers of
+   completed sends. */
+
+void
+fd_uring_aio_service( fd_uring_aio_t * uring_aio );
+
+/* Accessors.  rx_mtu is the largest datagram payload that can be
+   received, rx_drop_cnt is the number of datagrams dropped because they
+   exceeded it and tx_err_cnt is the number of sends that failed (e.g.
+   ECONNREFUSED on a connected socket whose peer is gone). */
+
+FD_FN_PURE ulong fd_uring_aio_rx_mtu     ( fd_uring_aio_t const * uring_aio );
+FD_FN_PURE ulong fd_uring_aio_rx_drop_cnt( fd_uring_aio_t const * uring_aio );
+FD_FN_PURE ulong fd_uring_aio_tx_err_cnt ( fd_uring_aio_t const * uring_aio );
+
+FD_PROTOTYPES_END
+
+#endif /* defined(__linux__) */
+#endif /* HEADER_fd_src_tango_uring_fd_uring_aio_h */
@@ -0,0 +1,113 @@
+#ifndef HEADER_fd_src_tango_uring_fd_uring_aio_private_h
+#define HEADER_fd_src_tango_uring_fd_uring_aio_private_h
+
+#if defined(__linux__)
+
+#include "fd_uring_aio.h"
+#include "fd_uring.h"
+
+#include <sys/socket.h>
+
+/* fd_uring_aio_tx_msg_t is the sendmsg descriptor of a TX buffer (the
+   kernel reads it while the send is in flight). */
+
+struct fd_uring_aio_tx_msg {
+  struct msghdr msg;
+  struct iovec  iov;
+};
+
+typedef struct fd_uring_aio_tx_msg fd_uring_aio_tx_msg_t;
+
+/* Private definition of an fd_uring_aio_t */
+
+#define FD_URING_AIO_MAGIC (0xf17eda2c75726e67UL) /* firedancer hex(urng) */
+
+/* FD_URING_AIO_RX_USER_DATA tags completions of the multishot recvmsg
+   (completions of sends are tagged with their TX buffer index). */
+
+#define FD_URING_AIO_RX_USER_DATA (ULONG_MAX)
+
+struct __attribute__((aligned(FD_URING_AIO_ALIGN))) fd_uring_aio_private {
+
+  /* Data Layout Config ***********************************************/
+
+  ulong magic;        /* ==FD_URING_AIO_MAGIC */
+  ulong rx_depth;     /* Number of RX buffers (power of 2) */
+  ulong tx_depth;     /* Number of TX buffers */
+  ulong buf_sz;       /* Size of each RX / TX buffer */
+  ulong pkt_cnt;      /* Max datagrams delivered per service */
+  ulong buf_ring_off; /* Offset of struct io_uring_buf  [ rx_depth        ] (page aligned) */
+  ulong rx_buf_off;   /* Offset of uchar                [ rx_depth*buf_sz ] */
+  ulong tx_buf_off;   /* Offset of uchar                [ tx_depth*buf_sz ] */
+  ulong tx_msg_off;   /* Offset of fd_uring_aio_tx_msg_t[ tx_depth        ] */
+  ulong tx_stack_off; /* Offset of ulong                [ tx_depth        ] */
+  ulong pkt_off;      /* Offset of fd_aio_pkt_info_t    [ pkt_cnt         ] */
+  ulong bid_off;      /* Offset of ushort               [ pkt_cnt         ] */
+
+  /* Join Config ******************************************************/
+
+  int             sock_fd;
+  int             taskrun_flag;  /* Non-zero if the kernel flags pending completions in sq.flags */
+  int             rx_armed;      /* Non-zero if the multishot recvmsg is in flight */
+  fd_aio_t        rx;            /* From outside to user (externally owned) */
+  fd_aio_t        tx;            /* From user to outside (owned by fd_uring_aio) */
+
+  fd_uring_t      uring;         /* ring_fd -1 if not joined */
+  uint            sq_pending;    /* SQEs produced but not yet taken by the kernel */
+  ushort          buf_tail;      /* Local copy of the buffer ring tail */
+
+  struct msghdr   rx_msg;        /* Multishot recvmsg template (no name or control data) */
+
+  ulong           tx_top;        /* Number of TX buffer indices on the free stack */
+
+  ulong           rx_drop_cnt;
+  ulong           tx_err_cnt;
+
+  /* Variable-length data *********************************************/
+
+  /* ... struct io_uring_buf   [ rx_depth        ] follows (page aligned) ... */
+  /* ... uchar                 [ rx_depth*buf_sz ] follows ... */
+  /* ... uchar                 [ tx_depth*buf_sz ] follows ... */
+  /* ... fd_uring_aio_tx_msg_t [ tx_depth        ] follows ... */
+  /* ... ulong                 [ tx_depth        ] follows ... */
+  /* ... fd_aio_pkt_info_t     [ pkt_cnt         ] follows ... */
+  /* ... ushort                [ pkt_cnt         ] follows ... */
+};
+
+FD_FN_PURE static inline struct io_uring_buf *
+fd_uring_aio_buf_ring( fd_uring_aio_t * uring_aio ) {
+  return (struct io_uring_buf *)( (ulong)uring_aio + uring_aio->buf_ring_off );
+}
+
+FD_FN_PURE static inline uchar *
+fd_uring_aio_rx_buf( fd_uring_aio_t * uring_aio ) {
+  return (uchar *)( (ulong)uring_aio + uring_aio->rx_buf_off );
+}
+
+FD_FN_PURE static inline uchar *
+fd_uring_aio_tx_buf( fd_uring_aio_t * uring_aio ) {
+  return (uchar *)( (ulong)uring_aio + uring_aio->tx_buf_off );
+}
+
+FD_FN_PURE static inline fd_uring_aio_tx_msg_t *
+fd_uring_aio_tx_msg( fd_uring_aio_t * uring_aio ) {
+  return (fd_uring_aio_tx_msg_t *)( (ulong)uring_aio + uring_aio->tx_msg_off );
+}
+
+FD_FN_PURE static inline ulong *
+fd_uring_aio_tx_stack( fd_uring_aio_t * uring_aio ) {
+  return (ulong *)( (ulong)uring_aio + uring_aio->tx_stack_off );
+}
+
+FD_FN_PURE static inline fd_aio_pkt_info_t *
+fd_uring_aio_pkts( fd_uring_aio_t * uring_aio ) {
+  return (fd_aio_pkt_info_t *)( (ulong)uring_aio + uring_aio->pkt_off );
+}
+
+FD_FN_PURE static inline ushort *
+fd_uring_aio_bids( fd_uring_aio_t * uring_aio ) {
+  return (ushort *)( (ulong)uring_aio + uring_aio->bid_off );
+}
+
+#endif /* defined(__linux__) */
+#endif /* HEADER_fd_src_tango_uring_fd_uring_aio_private_h */
@@ -0,0 +1,331 @@
+/* sendmmsg and recvmmsg require _GNU_SOURCE */
+#define _GNU_SOURCE
+
+#include "../fd_tango.h"
+
+#if FD_HAS_HOSTED && FD_HAS_ATOMIC && FD_HAS_X86 && defined(__linux__)
+
+#include "fd_uring_aio.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/* test_uring_aio: Sends datagrams over loopback UDP between two
+   fd_uring_aio_t and checks they arrive intact and in order, then
+   compares the RX throughput of fd_uring_aio against a plain recvmmsg
+   loop on the same traffic. */
+
+#define BUF_SZ   (2048UL)
+#define BURST    (64UL)
+
+/* pkt_sz returns the size of test datagram seq (in [8,sz_max]).  Bytes
+   [8,sz) of datagram seq are (uchar)(seq+j) and the first 8 bytes hold
+   seq. */
+
+static ulong
+pkt_sz( ulong seq,
+        ulong sz_max ) {
+  return 8UL + fd_ulong_hash( seq ) % (sz_max-7UL);
+}
+
+static void
+pkt_gen( uchar * buf,
+         ulong   seq,
+         ulong   sz ) {
+  memcpy( buf, &seq, sizeof(ulong) );
+  for( ulong j=8UL; j<sz; j++ ) buf[j] = (uchar)(seq+j);
+}
+
+struct rx_state {
+  int   check;
+  ulong sz_max;
+  ulong rx_cnt;
+  ulong rx_sz;
+};
+
+typedef struct rx_state rx_state_t;
+
+static int
+rx_cb( void *                    ctx,
+       fd_aio_pkt_info_t const * batch,
+       ulong                     batch_cnt,
+       ulong *                   opt_batch_idx ) {
+  (void)opt_batch_idx;
+  rx_state_t * state = (rx_state_t *)ctx;
+  for( ulong i=0UL; i<batch_cnt; i++ ) {
+    uchar const * p  = (uchar const *)batch[i].buf;
+    ulong         sz = batch[i].buf_sz;
+    if( state->check ) {
+      ulong seq; FD_TEST( sz>=8UL ); memcpy( &seq, p, sizeof(ulong) );
+      FD_TEST( seq==state->rx_cnt );
+      FD_TEST( sz==pkt_sz( seq, state->sz_max ) );
+      for( ulong j=8UL; j<sz; j++ ) FD_TEST( p[j]==(uchar)(seq+j) );
+    }
+    state->rx_cnt++;
+    state->rx_sz += sz;
+  }
+  return FD_AIO_SUCCESS;
+}
+
+/* udp_socket opens a UDP socket bound to an ephemeral loopback port
+   (returned at *_port) and, if peer_port is non-zero, connected to
+   loopback port peer_port. */
+
+static int
+udp_socket( ushort * _port,
+            ushort   peer_port ) {
+  int sock = socket( AF_INET, SOCK_DGRAM, 0 );
+  if( FD_UNLIKELY( sock<0 ) ) FD_LOG_ERR(( "socket failed (%i-%s)", errno, strerror( errno ) ));
+
+  union {
+    struct sockaddr    sa;
+    struct sockaddr_in in;
+  } addr;
+  memset( &addr, 0, sizeof(addr) );
+  addr.in.sin_family      = AF_INET;
+  addr.in.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  if( FD_UNLIKELY( bind( sock, &addr.sa, sizeof(struct sockaddr_in) ) ) )
+    FD_LOG_ERR(( "bind failed (%i-%s)", errno, strerror( errno ) ));
+
+  socklen_t addr_sz = sizeof(struct sockaddr_in);
+  FD_TEST( !getsockname( sock, &addr.sa, &addr_sz ) );
+  *_port = ntohs( addr.in.sin_port );
+
+  if( peer_port ) {
+    addr.in.sin_port = htons( peer_port );
+    if( FD_UNLIKELY( connect( sock, &addr.sa, sizeof(struct sockaddr_in) ) ) )
+      FD_LOG_ERR(( "connect failed (%i-%s)", errno, strerror( errno ) ));
+  }
+
+  return sock;
+}
+
+static uchar tx_frame[ BURST ][ BUF_SZ ];
+static uchar rx_frame[ BURST ][ BUF_SZ ];
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "normal"        );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1024UL          );
+  ulong        near_cpu  = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu",  NULL, fd_log_cpu_id() );
+  ulong        pkt_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-cnt",   NULL, 100000UL        );
+  ulong        sz_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--sz-max",    NULL, 1472UL          );
+  ulong        bench_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--bench-cnt", NULL, 262144UL        );
+  ulong        bench_sz  = fd_env_strip_cmdline_ulong( &argc, &argv, "--bench-sz",  NULL, 64UL            );
+
+  if( FD_UNLIKELY( (sz_max<8UL) | (sz_max>BUF_SZ-16UL) ) ) FD_LOG_ERR(( "--sz-max should be in [8,%lu]", BUF_SZ-16UL ));
+  if( FD_UNLIKELY( (bench_sz<1UL) | (bench_sz>BUF_SZ-16UL) ) ) FD_LOG_ERR(( "--bench-sz should be in [1,%lu]", BUF_SZ-16UL ));
+
+  /* Parameter validation */
+
+  FD_TEST( fd_uring_aio_align()==FD_URING_AIO_ALIGN );
+  FD_TEST( !fd_uring_aio_footprint( 0UL,    1UL, BUF_SZ, 1UL ) );
+  FD_TEST( !fd_uring_aio_footprint( 3UL,    1UL, BUF_SZ, 1UL ) );
+  FD_TEST( !fd_uring_aio_footprint( 65536UL,1UL, BUF_SZ, 1UL ) );
+  FD_TEST( !fd_uring_aio_footprint( 1UL,    0UL, BUF_SZ, 1UL ) );
+  FD_TEST( !fd_uring_aio_footprint( 1UL,    1UL, 100UL,  1UL ) );
+  FD_TEST( !fd_uring_aio_footprint( 1UL,    1UL, 64UL,   1UL ) );
+  FD_TEST( !fd_uring_aio_footprint( 1UL,    1UL, BUF_SZ, 0UL ) );
+  FD_TEST(  fd_uring_aio_footprint( 1UL,    1UL, BUF_SZ, 1UL ) );
+
+  FD_LOG_NOTICE(( "Creating anonymous wksp (--page-sz %s, --page-cnt %lu, --near-cpu %lu)", _page_sz, page_cnt, near_cpu ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  FD_TEST( !fd_uring_aio_new( NULL, 1UL, 1UL, BUF_SZ, 1UL ) );
+
+  /* RX side: lots of RX buffers, a single TX buffer.  TX side: the
+     reverse. */
+
+  ulong rx_footprint = fd_uring_aio_footprint( 256UL, 1UL, BUF_SZ, BURST );
+  ulong tx_footprint = fd_uring_aio_footprint( 1UL, BURST, BUF_SZ, BURST );
+  void * rx_mem = fd_wksp_alloc_laddr( wksp, fd_uring_aio_align(), rx_footprint, 1UL ); FD_TEST( rx_mem );
+  void * tx_mem = fd_wksp_alloc_laddr( wksp, fd_uring_aio_align(), tx_footprint, 1UL ); FD_TEST( tx_mem );
+
+  FD_TEST( !fd_uring_aio_new( (uchar *)rx_mem+1UL, 256UL, 1UL, BUF_SZ, BURST ) );
+  FD_TEST( fd_uring_aio_new( rx_mem, 256UL, 1UL, BUF_SZ, BURST )==rx_mem );
+  FD_TEST( fd_uring_aio_new( tx_mem, 1UL, BURST, BUF_SZ, BURST )==tx_mem );
+
+  ushort rx_port; int rx_sock = udp_socket( &rx_port, 0       );
+  ushort tx_port; int tx_sock = udp_socket( &tx_port, rx_port );
+  FD_LOG_NOTICE(( "Loopback UDP %hu -> %hu", tx_port, rx_port ));
+
+  FD_TEST( !fd_uring_aio_join( rx_mem, -1 ) );
+  fd_uring_aio_t * rx_aio = fd_uring_aio_join( rx_mem, rx_sock );
+  if( FD_UNLIKELY( !rx_aio ) ) {
+    FD_LOG_WARNING(( "skip: unit test requires io_uring with multishot recvmsg (Linux 6.0+)" ));
+    fd_wksp_free_laddr( tx_mem ); fd_wksp_free_laddr( rx_mem ); fd_wksp_delete_anonymous( wksp );
+    close( tx_sock ); close( rx_sock );
+    fd_halt();
+    return 0;
+  }
+  fd_uring_aio_t * tx_aio = fd_uring_aio_join( tx_mem, tx_sock ); FD_TEST( tx_aio );
+
+  FD_TEST( fd_uring_aio_rx_mtu( rx_aio )==BUF_SZ-16UL );
+
+  rx_state_t rx_state[1] = {{ .check = 1, .sz_max = sz_max, .rx_cnt = 0UL, .rx_sz = 0UL }};
+  fd_aio_t _rx_cb[1];
+  fd_aio_t * rx_cb_aio = fd_aio_join( fd_aio_new( _rx_cb, rx_state, rx_cb ) ); FD_TEST( rx_cb_aio );
+  fd_uring_aio_set_rx( rx_aio, rx_cb_aio );
+
+  fd_aio_t const * tx = fd_uring_aio_get_tx( tx_aio );
+
+  /* Send pkt_cnt datagrams of random sizes in random size batches,
+     keeping the number in flight below what the socket receive buffer
+     surely holds */
+
+  FD_LOG_NOTICE(( "Testing %lu datagrams (--sz-max %lu)", pkt_cnt, sz_max ));
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+  fd_aio_pkt_info_t batch[ BURST ];
+  ulong tx_seq = 0UL;
+  long  dead   = fd_log_wallclock() + (long)10e9;
+  while( rx_state->rx_cnt<pkt_cnt ) {
+    if( FD_UNLIKELY( fd_log_wallclock()>dead ) ) FD_LOG_ERR(( "timeout (rx %lu / %lu)", rx_state->rx_cnt, pkt_cnt ));
+
+    ulong batch_cnt = fd_ulong_min( 1UL + (fd_rng_ulong( rng ) % 16UL), pkt_cnt - tx_seq );
+    if( tx_seq-rx_state->rx_cnt>=32UL ) batch_cnt = 0UL;
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      ulong sz = pkt_sz( tx_seq+i, sz_max );
+      pkt_gen( tx_frame[i], tx_seq+i, sz );
+      batch[i] = (fd_aio_pkt_info_t){ .buf = tx_frame[i], .buf_sz = (ushort)sz };
+    }
+    if( batch_cnt ) {
+      ulong batch_idx = ULONG_MAX;
+      int   err       = fd_aio_send( tx, batch, batch_cnt, &batch_idx );
+      if( FD_LIKELY( !err ) ) tx_seq += batch_cnt;
+      else {
+        FD_TEST( err==FD_AIO_ERR_AGAIN ); FD_TEST( batch_idx<batch_cnt );
+        tx_seq += batch_idx;
+      }
+    }
+
+    fd_uring_aio_service( tx_aio );
+    fd_uring_aio_service( rx_aio );
+  }
+  FD_TEST( tx_seq==pkt_cnt );
+
+  /* Oversize packets: too large for the TX buffers aborts the send at
+     that packet, too large for the RX buffers is dropped on receipt */
+
+  ulong sz = pkt_sz( tx_seq, sz_max );
+  pkt_gen( tx_frame[0], tx_seq, sz );
+  batch[0] = (fd_aio_pkt_info_t){ .buf = tx_frame[0], .buf_sz = (ushort)sz       };
+  batch[1] = (fd_aio_pkt_info_t){ .buf = tx_frame[1], .buf_sz = (ushort)(BUF_SZ+1UL) };
+  ulong batch_idx = ULONG_MAX;
+  FD_TEST( fd_aio_send( tx, batch, 2UL, &batch_idx )==FD_AIO_ERR_INVAL ); FD_TEST( batch_idx==1UL );
+  tx_seq++;
+
+  FD_TEST( send( tx_sock, tx_frame[1], fd_uring_aio_rx_mtu( rx_aio )+1UL, 0 )==(long)fd_uring_aio_rx_mtu( rx_aio )+1L );
+
+  dead = fd_log_wallclock() + (long)10e9;
+  while( (rx_state->rx_cnt<tx_seq) | (fd_uring_aio_rx_drop_cnt( rx_aio )<1UL) ) {
+    if( FD_UNLIKELY( fd_log_wallclock()>dead ) ) FD_LOG_ERR(( "timeout" ));
+    fd_uring_aio_service( tx_aio );
+    fd_uring_aio_service( rx_aio );
+  }
+  FD_TEST( rx_state->rx_cnt==tx_seq );
+  FD_TEST( fd_uring_aio_rx_drop_cnt( rx_aio )==1UL );
+  FD_TEST( fd_uring_aio_tx_err_cnt ( tx_aio )==0UL );
+
+  FD_LOG_NOTICE(( "%lu datagrams (%lu bytes) received intact", rx_state->rx_cnt, rx_state->rx_sz ));
+
+  FD_TEST( fd_uring_aio_leave( tx_aio )==tx_mem );
+  FD_TEST( fd_uring_aio_leave( rx_aio )==rx_mem );
+  FD_TEST( fd_uring_aio_delete( tx_mem )==tx_mem );
+  FD_TEST( fd_uring_aio_delete( rx_mem )==rx_mem );
+  fd_wksp_free_laddr( tx_mem );
+
+  /* Throughput: the same bursts of bench_sz byte datagrams sent with
+     sendmmsg are received either through fd_uring_aio or with recvmmsg.
+     Only receiving is timed. */
+
+  FD_LOG_NOTICE(( "Benchmarking RX (--bench-cnt %lu, --bench-sz %lu)", bench_cnt, bench_sz ));
+
+  struct iovec   tx_iov[ BURST ]; struct mmsghdr tx_msg[ BURST ];
+  struct iovec   rx_iov[ BURST ]; struct mmsghdr rx_msg[ BURST ];
+  memset( tx_msg, 0, sizeof(tx_msg) ); memset( rx_msg, 0, sizeof(rx_msg) );
+  for( ulong i=0UL; i<BURST; i++ ) {
+    tx_iov[i] = (struct iovec){ .iov_base = tx_frame[i], .iov_len = bench_sz };
+    rx_iov[i] = (struct iovec){ .iov_base = rx_frame[i], .iov_len = BUF_SZ   };
+    tx_msg[i].msg_hdr.msg_iov = tx_iov + i; tx_msg[i].msg_hdr.msg_iovlen = 1UL;
+    rx_msg[i].msg_hdr.msg_iov = rx_iov + i; rx_msg[i].msg_hdr.msg_iovlen = 1UL;
+    memset( tx_frame[i], (int)i, bench_sz );
+  }
+
+  double rate[2];
+  for( int mode=0; mode<2; mode++ ) { /* 0 <> recvmmsg, 1 <> fd_uring_aio */
+
+    ushort bench_rx_port; int bench_rx_sock = udp_socket( &bench_rx_port, 0             );
+    ushort bench_tx_port; int bench_tx_sock = udp_socket( &bench_tx_port, bench_rx_port );
+
+    rx_state->check  = 0;
+    rx_state->rx_cnt = 0UL;
+    if( mode ) {
+      FD_TEST( fd_uring_aio_new( rx_mem, 256UL, 1UL, BUF_SZ, BURST )==rx_mem );
+      rx_aio = fd_uring_aio_join( rx_mem, bench_rx_sock ); FD_TEST( rx_aio );
+      fd_uring_aio_set_rx( rx_aio, rx_cb_aio );
+    }
+
+    long  dt     = 0L;
+    ulong rx_cnt = 0UL;
+    while( rx_cnt<bench_cnt ) {
+      FD_TEST( sendmmsg( bench_tx_sock, tx_msg, (uint)BURST, 0 )==(int)BURST );
+
+      long  tic = fd_log_wallclock();
+      ulong tgt = rx_cnt + BURST;
+      if( !mode ) {
+        while( rx_cnt<tgt ) {
+          int cnt = recvmmsg( bench_rx_sock, rx_msg, (uint)(tgt-rx_cnt), MSG_DONTWAIT, NULL );
+          if( FD_LIKELY( cnt>0 ) ) rx_cnt += (ulong)cnt;
+          else FD_TEST( errno==EAGAIN );
+        }
+      } else {
+        while( rx_state->rx_cnt<tgt ) fd_uring_aio_service( rx_aio );
+        rx_cnt = rx_state->rx_cnt;
+      }
+      dt += fd_log_wallclock() - tic;
+    }
+    rate[mode] = 1e9*(double)rx_cnt / (double)dt;
+
+    if( mode ) {
+      FD_TEST( fd_uring_aio_leave( rx_aio )==rx_mem );
+      FD_TEST( fd_uring_aio_delete( rx_mem )==rx_mem );
+    }
+    close( bench_tx_sock );
+    close( bench_rx_sock );
+  }
+
+  FD_LOG_NOTICE(( "recvmmsg     %.3e pkt/s", rate[0] ));
+  FD_LOG_NOTICE(( "fd_uring_aio %.3e pkt/s (%.2fx)", rate[1], rate[1]/rate[0] ));
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_aio_delete( fd_aio_leave( rx_cb_aio ) );
+  close( tx_sock );
+  close( rx_sock );
+  fd_wksp_free_laddr( rx_mem );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED, FD_HAS_ATOMIC, FD_HAS_X86 and Linux" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
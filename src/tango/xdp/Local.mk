@@ -6,8 +6,11 @@ $(call add-objs,fd_xsk fd_xsk_aio,fd_xdp)
 
 ifdef FD_HAS_LIBBPF
 $(call add-objs,fd_xdp_redirect_user,fd_xdp)
+$(call make-bin,fd_xdp_ctl,fd_xdp_ctl,fd_xdp fd_util)
+$(call make-ebpf-bin,fd_xdp_redirect_prog)
 $(call make-unit-test,test_xsk,test_xsk,fd_xdp fd_util)
 $(call run-unit-test,test_xsk)
+$(call make-unit-test,test_xdp_redirect_prog,test_xdp_redirect_prog,fd_util)
 endif # FD_HAS_LIBBPF
 
 endif # FD_HAS_HOSTED
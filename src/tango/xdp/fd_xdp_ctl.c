@@ -0,0 +1,238 @@
+#include "fd_xdp.h"
+
+#if FD_HAS_HOSTED && defined(__linux__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <linux/if_link.h>
+
+FD_IMPORT_CSTR( fd_xdp_ctl_help, "src/tango/xdp/fd_xdp_ctl_help" );
+
+/* cstr_to_xdp_mode converts a cstr to an XDP install mode.  Returns
+   UINT_MAX if s is not a valid mode. */
+
+static uint
+cstr_to_xdp_mode( char const * s ) {
+  if( !strcmp( s, "default" ) ) return 0U;
+  if( !strcmp( s, "skb"     ) ) return XDP_FLAGS_SKB_MODE;
+  if( !strcmp( s, "drv"     ) ) return XDP_FLAGS_DRV_MODE;
+  if( !strcmp( s, "hw"      ) ) return XDP_FLAGS_HW_MODE;
+  return UINT_MAX;
+}
+
+/* read_file reads the file at path into a malloc'd buffer.  Returns the
+   buffer (caller should free) and stores the file size at *_sz on
+   success.  Returns NULL on failure (logs details). */
+
+static void *
+read_file( char const * path,
+           ulong *      _sz ) {
+  FILE * file = fopen( path, "rb" );
+  if( FD_UNLIKELY( !file ) ) { FD_LOG_WARNING(( "fopen(%s) failed", path )); return NULL; }
+
+  long sz = -1L;
+  if( FD_LIKELY( !fseek( file, 0L, SEEK_END ) ) ) sz = ftell( file );
+  if( FD_UNLIKELY( (sz<=0L) || fseek( file, 0L, SEEK_SET ) ) ) {
+    FD_LOG_WARNING(( "unable to determine size of %s", path ));
+    fclose( file );
+    return NULL;
+  }
+
+  void * buf = malloc( (ulong)sz );
+  if( FD_UNLIKELY( !buf ) ) { FD_LOG_WARNING(( "malloc(%li) failed", sz )); fclose( file ); return NULL; }
+
+  if( FD_UNLIKELY( fread( buf, (ulong)sz, 1UL, file )!=1UL ) ) {
+    FD_LOG_WARNING(( "fread(%s) failed", path ));
+    free( buf );
+    fclose( file );
+    return NULL;
+  }
+
+  fclose( file );
+  *_sz = (ulong)sz;
+  return buf;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+# define SHIFT(n) argv+=(n),argc-=(n)
+
+  if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "no arguments" ));
+  char const * bin = argv[0];
+  SHIFT(1);
+
+  int cnt = 0;
+  while( argc ) {
+    char const * cmd = argv[0];
+    SHIFT(1);
+
+    if( !strcmp( cmd, "help" ) ) {
+
+      fputs( fd_xdp_ctl_help, stdout );
+
+      FD_LOG_NOTICE(( "%i: %s: success", cnt, cmd ));
+
+    } else if( !strcmp( cmd, "init" ) ) {
+
+      if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app = argv[0];
+
+      if( FD_UNLIKELY( fd_xdp_init( app ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_xdp_init( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, app, bin ));
+
+      FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, app ));
+      SHIFT( 1 );
+
+    } else if( !strcmp( cmd, "fini" ) ) {
+
+      if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app = argv[0];
+
+      if( FD_UNLIKELY( fd_xdp_fini( app ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_xdp_fini( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, app, bin ));
+
+      FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, app ));
+      SHIFT( 1 );
+
+    } else if( !strcmp( cmd, "hook-iface" ) ) {
+
+      if( FD_UNLIKELY( argc<4 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app    =                    argv[0];
+      char const * ifname =                    argv[1];
+      uint         mode   = cstr_to_xdp_mode(  argv[2] );
+      char const * path   =                    argv[3];
+
+      if( FD_UNLIKELY( mode==UINT_MAX ) )
+        FD_LOG_ERR(( "%i: %s: invalid mode %s\n\tDo %s help for help", cnt, cmd, argv[2], bin ));
+
+      ulong  prog_sz;
+      void * prog = read_file( path, &prog_sz );
+      if( FD_UNLIKELY( !prog ) ) FD_LOG_ERR(( "%i: %s: unable to read %s\n\tDo %s help for help", cnt, cmd, path, bin ));
+
+      if( FD_UNLIKELY( fd_xdp_hook_iface( app, ifname, mode, 0, prog, prog_sz ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_xdp_hook_iface( \"%s\", \"%s\", %s, %s ) failed\n\tDo %s help for help",
+                     cnt, cmd, app, ifname, argv[2], path, bin ));
+
+      free( prog );
+
+      FD_LOG_NOTICE(( "%i: %s %s %s %s %s: success", cnt, cmd, app, ifname, argv[2], path ));
+      SHIFT( 4 );
+
+    } else if( !strcmp( cmd, "unhook-iface" ) ) {
+
+      if( FD_UNLIKELY( argc<2 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app    = argv[0];
+      char const * ifname = argv[1];
+
+      if( FD_UNLIKELY( fd_xdp_unhook_iface( app, ifname ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_xdp_unhook_iface( \"%s\", \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, app, ifname, bin ));
+
+      FD_LOG_NOTICE(( "%i: %s %s %s: success", cnt, cmd, app, ifname ));
+      SHIFT( 2 );
+
+    } else if( !strcmp( cmd, "listen-udp" ) || !strcmp( cmd, "release-udp" ) ) {
+
+      if( FD_UNLIKELY( argc<3 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app  =                      argv[0];
+      ulong        ip4  = fd_cstr_to_ip4_addr( argv[1] );
+      ulong        port = fd_cstr_to_ulong   ( argv[2] );
+
+      if( FD_UNLIKELY( ip4==ULONG_MAX ) ) FD_LOG_ERR(( "%i: %s: invalid ip4 %s\n\tDo %s help for help", cnt, cmd, argv[1], bin ));
+      if( FD_UNLIKELY( port>USHORT_MAX ) ) FD_LOG_ERR(( "%i: %s: invalid port %s\n\tDo %s help for help", cnt, cmd, argv[2], bin ));
+
+      /* fd_cstr_to_ip4_addr returns the address in network byte order
+         while the listen API takes it in host byte order */
+
+      uint ip4_dst_addr = fd_uint_bswap( (uint)ip4 );
+
+      int err = !strcmp( cmd, "listen-udp" ) ? fd_xdp_listen_udp_port ( app, ip4_dst_addr, (uint)port, 0U )
+                                             : fd_xdp_release_udp_port( app, ip4_dst_addr, (uint)port     );
+      if( FD_UNLIKELY( err ) )
+        FD_LOG_ERR(( "%i: %s: %s %s %s failed\n\tDo %s help for help", cnt, cmd, app, argv[1], argv[2], bin ));
+
+      FD_LOG_NOTICE(( "%i: %s %s %s %lu: success", cnt, cmd, app, argv[1], port ));
+      SHIFT( 3 );
+
+    } else if( !strcmp( cmd, "rlimit-cfg" ) ) {
+
+      if( FD_UNLIKELY( argc<3 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app   =                   argv[0];
+      ulong        rate  = fd_cstr_to_ulong( argv[1] );
+      ulong        burst = fd_cstr_to_ulong( argv[2] );
+
+      if( FD_UNLIKELY( fd_xdp_rlimit_cfg( app, rate, burst ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_xdp_rlimit_cfg( \"%s\", %lu, %lu ) failed\n\tDo %s help for help", cnt, cmd, app, rate, burst, bin ));
+
+      FD_LOG_NOTICE(( "%i: %s %s %lu %lu: success", cnt, cmd, app, rate, burst ));
+      SHIFT( 3 );
+
+    } else if( !strcmp( cmd, "rlimit-stats" ) ) {
+
+      if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * app = argv[0];
+
+      ulong pass_cnt;
+      ulong drop_cnt;
+      if( FD_UNLIKELY( fd_xdp_rlimit_stats( app, &pass_cnt, &drop_cnt ) ) )
+        FD_LOG_ERR(( "%i: %s: fd_xdp_rlimit_stats( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, app, bin ));
+
+      printf( "%lu %lu\n", pass_cnt, drop_cnt );
+
+      FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, app ));
+      SHIFT( 1 );
+
+    } else if( !strcmp( cmd, "ifqueue-cnt" ) ) {
+
+      if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * ifname = argv[0];
+
+      ulong ifqueue_cnt = fd_xsk_ifqueue_cnt( ifname );
+      if( FD_UNLIKELY( !ifqueue_cnt ) )
+        FD_LOG_ERR(( "%i: %s: fd_xsk_ifqueue_cnt( \"%s\" ) failed\n\tDo %s help for help", cnt, cmd, ifname, bin ));
+
+      printf( "%lu\n", ifqueue_cnt );
+
+      FD_LOG_NOTICE(( "%i: %s %s: success", cnt, cmd, ifname ));
+      SHIFT( 1 );
+
+    } else {
+
+      FD_LOG_ERR(( "%i: %s: unknown command\n\t"
+                   "Do %s help for help", cnt, cmd, bin ));
+
+    }
+    cnt++;
+  }
+
+  if( FD_UNLIKELY( cnt<1 ) ) FD_LOG_NOTICE(( "processed %i commands\n\tDo %s help for help", cnt, bin ));
+  else                       FD_LOG_NOTICE(( "processed %i commands", cnt ));
+
+# undef SHIFT
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  if( FD_UNLIKELY( argc<1 ) ) FD_LOG_ERR(( "No arguments" ));
+  if( FD_UNLIKELY( argc>1 ) ) FD_LOG_ERR(( "fd_xdp_ctl not supported on this platform" ));
+  FD_LOG_NOTICE(( "processed 0 commands" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
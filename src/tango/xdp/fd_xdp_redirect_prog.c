@@ -5,8 +5,9 @@
    every packet as part of the XDP stage of the Linux host.  Its task is
    to forward packets to the appropriate destination which may be the
    XSKs handling Firedancer traffic or the regular Linux networking
-   stack for unrelated traffic.  It may also be used in the future to
-   protect against packet floods.
+   stack for unrelated traffic.  It also protects the XSKs from floods
+   by rate limiting matching traffic per source IP address (see
+   fd_xdp_rlimit_cfg in fd_xdp_redirect_user.h).
 
    The following code targets the Linux eBPF virtual machine which does
    not yet support libc and has strict control-flow and memory
@@ -19,6 +20,7 @@
 
 #include "../ebpf/fd_ebpf_base.h"
 #include "fd_xdp_redirect_prog.h"
+#include "../rlimit/fd_rlimit_bucket.h"
 
 #include <linux/bpf.h>
 #include <bpf/bpf_helpers.h>
@@ -58,6 +60,39 @@ struct {
   __type( value,       int                );
 } firedancer_udp_dsts SEC(".maps");
 
+/* firedancer_rlimit_cfg: Rate limiter configuration
+   Single entry (key 0).  Shared between interfaces and set from
+   userspace. */
+struct {
+  __uint( type,        BPF_MAP_TYPE_ARRAY       );
+  __uint( max_entries, 1U                       );
+  __type( key,         uint                     );
+  __type( value,       struct fd_xdp_rlimit_cfg );
+} firedancer_rlimit_cfg SEC(".maps");
+
+/* firedancer_rlimit_stats: Rate limiter counters
+   key is FD_XDP_RLIMIT_STAT_{PASS,DROP}.  Per-CPU such that counting
+   doesn't bounce cache lines between the CPUs handling RX queues. */
+struct {
+  __uint( type,        BPF_MAP_TYPE_PERCPU_ARRAY );
+  __uint( max_entries, FD_XDP_RLIMIT_STAT_CNT    );
+  __type( key,         uint                      );
+  __type( value,       ulong                     );
+} firedancer_rlimit_stats SEC(".maps");
+
+/* firedancer_rlimit: Per-source token buckets
+   key is the IPv4 source addr (in network byte order), value is the
+   bucket's theoretical arrival time in ns (see fd_rlimit_bucket.h).
+   Per-CPU such that updates need no atomics (the limit is thus applied
+   per CPU receiving the source's traffic) and LRU such that a flood of
+   spoofed source addrs only evicts idle buckets. */
+struct {
+  __uint( type,        BPF_MAP_TYPE_LRU_PERCPU_HASH );
+  __uint( max_entries, FD_XDP_RLIMIT_MAP_CNT        );
+  __type( key,         uint                         );
+  __type( value,       ulong                        );
+} firedancer_rlimit SEC(".maps");
+
 /* Executable Code ****************************************************/
 
 /* firedancer_redirect: Entrypoint of redirect XDP program.
@@ -94,8 +129,36 @@ int firedancer_redirect( struct xdp_md *ctx ) {
   uint * udp_value = bpf_map_lookup_elem( &firedancer_udp_dsts, &flow_key );
   if( !udp_value ) return XDP_PASS;
 
-  /* Look up the interface queue to find the socket to forward to */
+  /* Rate limit per source addr (if enabled) */
+  uint cfg_key = 0U;
+  struct fd_xdp_rlimit_cfg const * rlimit_cfg = bpf_map_lookup_elem( &firedancer_rlimit_cfg, &cfg_key );
+  if( rlimit_cfg && rlimit_cfg->interval ) {
+    uint  ip_srcaddr = *(uint *)( iphdr+12UL );
+    ulong now        = bpf_ktime_get_ns();
+    int   pass       = 1;
+
+    ulong * tat = bpf_map_lookup_elem( &firedancer_rlimit, &ip_srcaddr );
+    if( FD_LIKELY( tat ) ) {
+      pass = fd_rlimit_bucket_take( tat, now, rlimit_cfg->interval, rlimit_cfg->tol );
+    } else {
+      /* New (or evicted) source starts with a full bucket */
+      ulong new_tat = now + rlimit_cfg->interval;
+      bpf_map_update_elem( &firedancer_rlimit, &ip_srcaddr, &new_tat, BPF_ANY );
+    }
+
+    uint    stat_key = pass ? FD_XDP_RLIMIT_STAT_PASS : FD_XDP_RLIMIT_STAT_DROP;
+    ulong * stat     = bpf_map_lookup_elem( &firedancer_rlimit_stats, &stat_key );
+    if( FD_LIKELY( stat ) ) (*stat)++;
+
+    if( FD_UNLIKELY( !pass ) ) return XDP_DROP;
+  }
+
+  /* Look up the interface queue to find the socket to forward to.  On
+     multi-queue devices, each RX queue has its own XSK (RSS spreads
+     flows over queues).  Traffic on queues without an active XSK is
+     passed to the Linux networking stack (instead of aborted) such that
+     servicing a subset of queues degrades gracefully. */
   uint socket_key = ctx->rx_queue_index;
-  return bpf_redirect_map( &firedancer_xsks, socket_key, 0 );
+  return bpf_redirect_map( &firedancer_xsks, socket_key, XDP_PASS );
 }
 
@@ -10,4 +10,24 @@
 /* FD_XDP_UDP_MAP_CNT: Max supported number of UDP port mappings. */
 #define FD_XDP_UDP_MAP_CNT  64U
 
+/* FD_XDP_RLIMIT_MAP_CNT: Max number of source addresses tracked by the
+   per-source rate limiter (per CPU).  Least recently seen sources are
+   evicted beyond this, which forgets their rate limit history. */
+#define FD_XDP_RLIMIT_MAP_CNT 65536U
+
+/* FD_XDP_RLIMIT_STAT_{...}: Indices into the rate limiter's per-CPU
+   counter map (firedancer_rlimit_stats). */
+#define FD_XDP_RLIMIT_STAT_PASS 0U /* Packets that passed the rate limiter */
+#define FD_XDP_RLIMIT_STAT_DROP 1U /* Packets dropped by the rate limiter */
+#define FD_XDP_RLIMIT_STAT_CNT  2U
+
+/* fd_xdp_rlimit_cfg is the value type of the rate limiter config map
+   (firedancer_rlimit_cfg, one entry).  interval is the number of ns per
+   token (0 disables rate limiting) and tol is the burst tolerance (see
+   fd_rlimit_bucket.h). */
+struct fd_xdp_rlimit_cfg {
+  ulong interval;
+  ulong tol;
+};
+
 #endif /* HEADER_fd_src_tango_xdp_fd_xdp_redirect_prog_h */
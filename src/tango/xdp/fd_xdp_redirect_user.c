@@ -10,6 +10,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <linux/if_xdp.h>
 #include <linux/if_link.h>
@@ -48,6 +49,40 @@ fd_xdp_validate_name_cstr( char const * s,
 }
 
 
+/* fd_xdp_pin_new_map: Creates an eBPF map and pins it at
+   /sys/fs/bpf/{app_name}/{pin_name}.  Returns 0 on success and -1 on
+   error.  Reasons for error are logged to FD_LOG_WARNING. */
+static int
+fd_xdp_pin_new_map( char const *      app_name,
+                    enum bpf_map_type map_type,
+                    char const *      map_name,
+                    uint              key_size,
+                    uint              value_size,
+                    uint              max_entries,
+                    char const *      pin_name ) {
+  struct bpf_map_create_opts map_create_opts = { .sz = sizeof(struct bpf_map_create_opts) };
+  int map_fd = bpf_map_create( map_type, map_name, key_size, value_size, max_entries, &map_create_opts );
+  if( FD_UNLIKELY( map_fd<0 ) ) {
+    FD_LOG_WARNING(( "bpf_map_create(%d,\"%s\",%uU,%uU,%u,%p) failed (%d-%s)",
+                     (int)map_type, map_name, key_size, value_size, max_entries, (void *)&map_create_opts,
+                     errno, strerror( errno ) ));
+    return -1;
+  }
+
+  char path[ PATH_MAX ];
+  snprintf( path, PATH_MAX, "/sys/fs/bpf/%s/%s", app_name, pin_name );
+  if( FD_UNLIKELY( 0!=bpf_obj_pin( map_fd, path ) ) ) {
+    FD_LOG_WARNING(( "bpf_obj_pin(%u,%s) failed (%d-%s)",
+                     map_fd, path, errno, strerror( errno ) ));
+    close( map_fd );
+    return -1;
+  }
+
+  close( map_fd );
+  return 0;
+}
+
+
 int
 fd_xdp_init( char const * app_name ) {
   /* Validate arguments */
@@ -55,23 +90,7 @@ fd_xdp_init( char const * app_name ) {
   if( FD_UNLIKELY( 0!=fd_xdp_validate_name_cstr( app_name, NAME_MAX, "app_name" ) ) )
     return -1;
 
-  /* Create UDP dsts map */
-
-  struct bpf_map_create_opts map_create_opts = { .sz = sizeof(struct bpf_map_create_opts) };
-  int udp_dsts_map_fd = bpf_map_create(
-      /* map_type    */ BPF_MAP_TYPE_HASH,
-      /* map_name    */ "firedancer_udp_dsts",
-      /* key_size    */ 8U,
-      /* value_size  */ 4U,
-      /* max_entries */ FD_XDP_UDP_MAP_CNT,
-      /* opts        */ &map_create_opts );
-  if( FD_UNLIKELY( udp_dsts_map_fd<0 ) ) {
-    FD_LOG_WARNING(( "bpf_map_create(BPF_MAP_TYPE_HASH,\"firedancer_udp_dsts\",8U,4U,%u,%p) failed (%d-%s)",
-                     FD_XDP_UDP_MAP_CNT, (void *)&map_create_opts, errno, strerror( errno ) ));
-    return -1;
-  }
-
-  /* Pin UDP dsts map to BPF FS */
+  /* Create app dir in BPF FS */
 
   char path[ PATH_MAX ];
   snprintf( path, PATH_MAX, "/sys/fs/bpf/%s", app_name );
@@ -79,19 +98,26 @@ fd_xdp_init( char const * app_name ) {
   if( FD_UNLIKELY( 0!=mkdir( path, 0777UL ) && errno!=EEXIST ) ) {
     FD_LOG_WARNING(( "mkdir(%s) failed (%d-%s)",
                      path, errno, strerror( errno ) ));
-    close( udp_dsts_map_fd );
     return -1;
   }
 
-  snprintf( path, PATH_MAX, "/sys/fs/bpf/%s/udp_dsts", app_name );
-  if( FD_UNLIKELY( 0!=bpf_obj_pin( udp_dsts_map_fd, path ) ) ) {
-    FD_LOG_WARNING(( "bpf_obj_pin(%u,%s) failed (%d-%s)",
-                     udp_dsts_map_fd, path, errno, strerror( errno ) ));
-    close( udp_dsts_map_fd );
+  /* Create and pin UDP dsts map */
+
+  if( FD_UNLIKELY( 0!=fd_xdp_pin_new_map( app_name, BPF_MAP_TYPE_HASH, "firedancer_udp_dsts",
+                                          8U, 4U, FD_XDP_UDP_MAP_CNT, "udp_dsts" ) ) )
+    return -1;
+
+  /* Create and pin rate limiter config and stats maps (the rate
+     limiter starts disabled as the config map is zero initialized) */
+
+  if( FD_UNLIKELY( 0!=fd_xdp_pin_new_map( app_name, BPF_MAP_TYPE_ARRAY, "firedancer_rlimit_cfg",
+                                          4U, (uint)sizeof(struct fd_xdp_rlimit_cfg), 1U, "rlimit_cfg" ) ) )
+    return -1;
+
+  if( FD_UNLIKELY( 0!=fd_xdp_pin_new_map( app_name, BPF_MAP_TYPE_PERCPU_ARRAY, "firedancer_rlimit_stats",
+                                          4U, 8U, FD_XDP_RLIMIT_STAT_CNT, "rlimit_stats" ) ) )
     return -1;
-  }
 
-  close( udp_dsts_map_fd );
   return 0;
 }
 
@@ -147,6 +173,11 @@ fd_xdp_fini( char const * app_name ) {
 
   unlinkat( dirfd( app_dir ), "udp_dsts", 0 );
 
+  /* Remove rate limiter maps */
+
+  unlinkat( dirfd( app_dir ), "rlimit_cfg",   0 );
+  unlinkat( dirfd( app_dir ), "rlimit_stats", 0 );
+
   /* Remove app dir */
 
   closedir( app_dir );
@@ -159,6 +190,45 @@ fd_xdp_fini( char const * app_name ) {
 }
 
 
+/* fd_xdp_reuse_pinned_map: Replaces the map named map_name in obj with
+   the shared map pinned at /sys/fs/bpf/{app_name}/{pin_name}.  Returns
+   0 on success and -1 on error.  Reasons for error are logged to
+   FD_LOG_WARNING. */
+static int
+fd_xdp_reuse_pinned_map( struct bpf_object * obj,
+                         char const *        app_name,
+                         char const *        map_name,
+                         char const *        pin_name ) {
+  char path[ PATH_MAX ];
+  snprintf( path, PATH_MAX, "/sys/fs/bpf/%s/%s", app_name, pin_name );
+
+  int map_fd = bpf_obj_get( path );
+  if( FD_UNLIKELY( map_fd<0 ) ) {
+    FD_LOG_WARNING(( "bpf_obj_get(%s) failed (%d-%s)",
+                     path, errno, strerror( errno ) ));
+    return -1;
+  }
+
+  struct bpf_map * map = bpf_object__find_map_by_name( obj, map_name );
+  if( FD_UNLIKELY( !map ) ) {
+    FD_LOG_WARNING(( "bpf_object__find_map_by_name(%p,\"%s\") failed (%d-%s)",
+                     (void *)obj, map_name, errno, strerror( errno ) ));
+    close( map_fd );
+    return -1;
+  }
+
+  if( FD_UNLIKELY( 0!=bpf_map__reuse_fd( map, map_fd ) ) ) {
+    FD_LOG_WARNING(( "bpf_map__reuse_fd(%p,%u) failed (%d-%s)",
+                     (void *)map, map_fd, errno, strerror( errno ) ));
+    close( map_fd );
+    return -1;
+  }
+
+  close( map_fd );
+  return 0;
+}
+
+
 int
 fd_xdp_hook_iface( char const * app_name,
                    char const * ifname,
@@ -252,6 +322,15 @@ fd_xdp_hook_iface( char const * app_name,
 
   close( udp_dsts_map_fd );
 
+  /* Likewise, share the pinned rate limiter config and stats maps
+     across interfaces */
+
+  if( FD_UNLIKELY( 0!=fd_xdp_reuse_pinned_map( obj, app_name, "firedancer_rlimit_cfg",   "rlimit_cfg"   ) ||
+                   0!=fd_xdp_reuse_pinned_map( obj, app_name, "firedancer_rlimit_stats", "rlimit_stats" ) ) ) {
+    bpf_object__close( obj );
+    return -1;
+  }
+
   /* Load XSK map from object file. */
 
   struct bpf_map * xsks_map = bpf_object__find_map_by_name( obj, "firedancer_xsks" );
@@ -476,6 +555,121 @@ fd_xdp_release_udp_port( char const * app_name,
 }
 
 
+static int
+fd_xdp_get_pinned_map( char const * app_name,
+                       char const * pin_name ) {
+  char path[ PATH_MAX ];
+  snprintf( path, PATH_MAX, "/sys/fs/bpf/%s/%s", app_name, pin_name );
+
+  int map_fd = bpf_obj_get( path );
+  if( FD_UNLIKELY( map_fd<0 ) ) {
+    FD_LOG_WARNING(( "bpf_obj_get(%s) failed (%d-%s)", path, errno, strerror( errno ) ));
+    return -1;
+  }
+
+  return map_fd;
+}
+
+
+int
+fd_xdp_rlimit_cfg( char const * app_name,
+                   ulong        rate,
+                   ulong        burst ) {
+  /* Validate arguments */
+
+  if( FD_UNLIKELY( 0!=fd_xdp_validate_name_cstr( app_name, NAME_MAX, "app_name" ) ) )
+    return -1;
+
+  struct fd_xdp_rlimit_cfg cfg = { .interval = 0UL, .tol = 0UL };
+  if( rate ) {
+    if( FD_UNLIKELY( (rate>1000000000UL) | (!burst) ) ) {
+      FD_LOG_WARNING(( "bad rate (%lu) and/or burst (%lu)", rate, burst ));
+      return -1;
+    }
+    cfg.interval = 1000000000UL / rate;
+    if( FD_UNLIKELY( (burst-1UL) > ((ulong)LONG_MAX)/cfg.interval ) ) {
+      FD_LOG_WARNING(( "burst (%lu) too large for rate (%lu)", burst, rate ));
+      return -1;
+    }
+    cfg.tol = (burst-1UL)*cfg.interval;
+  }
+
+  /* Open map */
+
+  int rlimit_cfg_fd = fd_xdp_get_pinned_map( app_name, "rlimit_cfg" );
+  if( FD_UNLIKELY( rlimit_cfg_fd<0 ) ) return -1;
+
+  /* Update config */
+
+  uint key = 0U;
+  if( FD_UNLIKELY( 0!=bpf_map_update_elem( rlimit_cfg_fd, &key, &cfg, 0UL ) ) ) {
+    FD_LOG_WARNING(( "bpf_map_update_elem(fd=%d,key=%u,interval=%lu,tol=%lu,flags=0) failed (%d-%s)",
+                     rlimit_cfg_fd, key, cfg.interval, cfg.tol, errno, strerror( errno ) ));
+    close( rlimit_cfg_fd );
+    return -1;
+  }
+
+  /* Clean up */
+
+  close( rlimit_cfg_fd );
+  return 0;
+}
+
+
+int
+fd_xdp_rlimit_stats( char const * app_name,
+                     ulong *      opt_pass_cnt,
+                     ulong *      opt_drop_cnt ) {
+  /* Validate arguments */
+
+  if( FD_UNLIKELY( 0!=fd_xdp_validate_name_cstr( app_name, NAME_MAX, "app_name" ) ) )
+    return -1;
+
+  int cpu_cnt = libbpf_num_possible_cpus();
+  if( FD_UNLIKELY( cpu_cnt<=0 ) ) {
+    FD_LOG_WARNING(( "libbpf_num_possible_cpus() failed (%d)", cpu_cnt ));
+    return -1;
+  }
+
+  /* Open map */
+
+  int rlimit_stats_fd = fd_xdp_get_pinned_map( app_name, "rlimit_stats" );
+  if( FD_UNLIKELY( rlimit_stats_fd<0 ) ) return -1;
+
+  /* Sum per-CPU counters.  Lookups into per-CPU maps return one value
+     per possible CPU. */
+
+  ulong * val = (ulong *)malloc( (ulong)cpu_cnt*sizeof(ulong) );
+  if( FD_UNLIKELY( !val ) ) {
+    FD_LOG_WARNING(( "malloc(%lu) failed", (ulong)cpu_cnt*sizeof(ulong) ));
+    close( rlimit_stats_fd );
+    return -1;
+  }
+
+  ulong sum[ FD_XDP_RLIMIT_STAT_CNT ];
+  for( uint key=0U; key<FD_XDP_RLIMIT_STAT_CNT; key++ ) {
+    if( FD_UNLIKELY( 0!=bpf_map_lookup_elem( rlimit_stats_fd, &key, val ) ) ) {
+      FD_LOG_WARNING(( "bpf_map_lookup_elem(fd=%d,key=%u) failed (%d-%s)",
+                       rlimit_stats_fd, key, errno, strerror( errno ) ));
+      free( val );
+      close( rlimit_stats_fd );
+      return -1;
+    }
+    sum[ key ] = 0UL;
+    for( int cpu_idx=0; cpu_idx<cpu_cnt; cpu_idx++ ) sum[ key ] += val[ cpu_idx ];
+  }
+
+  if( opt_pass_cnt ) *opt_pass_cnt = sum[ FD_XDP_RLIMIT_STAT_PASS ];
+  if( opt_drop_cnt ) *opt_drop_cnt = sum[ FD_XDP_RLIMIT_STAT_DROP ];
+
+  /* Clean up */
+
+  free( val );
+  close( rlimit_stats_fd );
+  return 0;
+}
+
+
 static int
 fd_xdp_get_xsks_map( char const * app_name,
                      char const * ifname ) {
@@ -34,6 +34,7 @@
        - fd_xsk_join()
    - For each UDP/IP destination to listen on
      - fd_xdp_listen_udp_port()
+   - Optionally, fd_xdp_rlimit_cfg()
    - ... Application run ... */
 
 /* TODO: Support NUMA-aware eBPF maps */
@@ -61,8 +62,11 @@ FD_PROTOTYPES_BEGIN
    Assumes that /sys/fs/bpf is a valid bpffs mount.
    Creates the following files in /sys/fs/bpf/{app_name}/
 
-     udp_dsts  BPF_MAP_TYPE_HASH map, see firedancer_udp_dsts in
-               program ebpf_xdp_flow.c */
+     udp_dsts      BPF_MAP_TYPE_HASH map, see firedancer_udp_dsts in
+                   program ebpf_xdp_flow.c
+     rlimit_cfg    BPF_MAP_TYPE_ARRAY map, see firedancer_rlimit_cfg
+     rlimit_stats  BPF_MAP_TYPE_PERCPU_ARRAY map, see
+                   firedancer_rlimit_stats */
 int
 fd_xdp_init( char const * app_name );
 
@@ -154,6 +158,36 @@ fd_xdp_release_udp_port( char const * app_name,
                          uint         ip4_dst_addr,
                          uint         udp_dst_port );
 
+/* fd_xdp_rlimit_cfg configures the XDP redirect program's per source
+   rate limiter for traffic matching the app's listeners.  Each IPv4
+   source address may send up to rate packets per second with bursts of
+   up to burst packets (burst should be positive).  Traffic in excess is
+   dropped before reaching the XSKs.  rate 0 disables rate limiting
+   (the default after fd_xdp_init).  Takes effect immediately on all
+   interfaces hooked for this app.  Returns 0 on success and -1 on
+   error.  Reasons for error are logged to FD_LOG_WARNING.
+
+   The limit is enforced per CPU (buckets live in a per-CPU LRU map to
+   keep the fast path free of atomics), so a source whose traffic is
+   spread over N RX queues serviced by N CPUs may get up to N times the
+   configured rate.  Sources are tracked in a map of
+   FD_XDP_RLIMIT_MAP_CNT entries per CPU, with least recently seen
+   sources evicted first. */
+int
+fd_xdp_rlimit_cfg( char const * app_name,
+                   ulong        rate,
+                   ulong        burst );
+
+/* fd_xdp_rlimit_stats reads the rate limiter's counters for the given
+   app summed over all CPUs.  On success, returns 0 and stores the number
+   of packets that passed and were dropped by the rate limiter at
+   *opt_pass_cnt and *opt_drop_cnt (either may be NULL).  Returns -1 on
+   error.  Reasons for error are logged to FD_LOG_WARNING. */
+int
+fd_xdp_rlimit_stats( char const * app_name,
+                     ulong *      opt_pass_cnt,
+                     ulong *      opt_drop_cnt );
+
 /* Runtime API (unprivileged) *****************************************/
 
 /* fd_xsk_activate installs an XSK file descriptor into the XDP redirect
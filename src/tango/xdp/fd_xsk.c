@@ -6,6 +6,7 @@
 #include <linux/limits.h>
 
 #include <net/if.h>
+#include <dirent.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -19,6 +20,7 @@
 
 #include "fd_xsk_private.h"
 #include "fd_xdp_redirect_user.h"
+#include "fd_xdp_redirect_prog.h"
 
 /* TODO move this into more appropriate header file
    and set based on architecture, etc. */
@@ -130,6 +132,19 @@ fd_xsk_bind( void *       shxsk,
     return NULL;
   }
 
+  /* Check if queue exists.  The XSKMAP is indexed by queue. */
+
+  if( FD_UNLIKELY( ifqueue>=FD_XDP_XSKS_MAP_CNT ) ) {
+    FD_LOG_WARNING(( "ifqueue %u exceeds FD_XDP_XSKS_MAP_CNT (%u)", ifqueue, FD_XDP_XSKS_MAP_CNT ));
+    return NULL;
+  }
+
+  ulong ifqueue_cnt = fd_xsk_ifqueue_cnt( ifname );
+  if( FD_UNLIKELY( ifqueue_cnt && (ulong)ifqueue>=ifqueue_cnt ) ) {
+    FD_LOG_WARNING(( "Network interface %s has %lu RX queues (ifqueue %u)", ifname, ifqueue_cnt, ifqueue ));
+    return NULL;
+  }
+
   /* Assign */
 
   fd_memcpy( xsk->app_name_cstr, app_name, app_name_len+1UL );
@@ -139,6 +154,38 @@ fd_xsk_bind( void *       shxsk,
   return shxsk;
 }
 
+ulong
+fd_xsk_ifqueue_cnt( char const * ifname ) {
+
+  if( FD_UNLIKELY( !ifname ) ) {
+    FD_LOG_WARNING(( "NULL ifname" ));
+    return 0UL;
+  }
+  ulong if_name_len = strnlen( ifname, IF_NAMESIZE );
+  if( FD_UNLIKELY( (if_name_len==0UL) | (if_name_len==IF_NAMESIZE) || strchr( ifname, '/' ) ) ) {
+    FD_LOG_WARNING(( "bad ifname" ));
+    return 0UL;
+  }
+
+  char path[ PATH_MAX ];
+  snprintf( path, PATH_MAX, "/sys/class/net/%s/queues", ifname );
+
+  DIR * dir = opendir( path );
+  if( FD_UNLIKELY( !dir ) ) {
+    FD_LOG_WARNING(( "opendir(%s) failed (%d-%s)", path, errno, strerror( errno ) ));
+    return 0UL;
+  }
+
+  /* Queues are named rx-{idx} and tx-{idx} */
+
+  ulong cnt = 0UL;
+  struct dirent * ent;
+  while( (ent = readdir( dir )) ) cnt += (ulong)!strncmp( ent->d_name, "rx-", 3UL );
+
+  closedir( dir );
+  return cnt;
+}
+
 void *
 fd_xsk_unbind( void * shxsk ) {
   /* Argument checks */
@@ -230,6 +277,97 @@ fd_xsk_new( void *       shmem,
   return (void *)xsk;
 }
 
+ulong
+fd_xsk_footprint_umem( void ) {
+  return fd_ulong_align_up( sizeof(fd_xsk_t), FD_XSK_ALIGN );
+}
+
+void *
+fd_xsk_new_umem( void * shmem,
+                 void * umem,
+                 ulong  umem_sz,
+                 ulong  frame_sz,
+                 ulong  headroom,
+                 ulong  fr_depth,
+                 ulong  rx_depth,
+                 ulong  tx_depth,
+                 ulong  cr_depth ) {
+  /* Validate arguments */
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_xsk_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !umem ) ) {
+    FD_LOG_WARNING(( "NULL umem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)umem, FD_XSK_UMEM_ALIGN ) ) ) {
+    FD_LOG_WARNING(( "misaligned umem" ));
+    return NULL;
+  }
+
+  /* Linux 4.18 requires XSK frames to be 2048-byte aligned and no
+     larger than page size.  Ring depths must be powers of 2. */
+
+  if( FD_UNLIKELY( frame_sz!=2048UL && frame_sz!=4096UL ) ) {
+    FD_LOG_WARNING(( "invalid frame_sz (%lu)", frame_sz ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (!umem_sz) | (umem_sz%frame_sz) ) ) {
+    FD_LOG_WARNING(( "umem_sz (%lu) not a positive multiple of frame_sz (%lu)", umem_sz, frame_sz ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( headroom>(frame_sz>>1) ) ) {
+    FD_LOG_WARNING(( "headroom (%lu) too large for frame_sz (%lu)", headroom, frame_sz ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_pow2( fr_depth ) || !fd_ulong_is_pow2( rx_depth ) ||
+                   !fd_ulong_is_pow2( tx_depth ) || !fd_ulong_is_pow2( cr_depth ) ) ) {
+    FD_LOG_WARNING(( "ring depths must be powers of 2" ));
+    return NULL;
+  }
+
+  fd_xsk_t * xsk = (fd_xsk_t *)shmem;
+
+  /* Reset fd_xsk_t state */
+
+  fd_memset( xsk, 0, fd_xsk_footprint_umem() );
+
+  xsk->xsk_fd         = -1;
+  xsk->xdp_map_fd     = -1;
+  xsk->xdp_udp_map_fd = -1;
+
+  /* Copy config */
+
+  xsk->params.frame_sz = frame_sz;
+  xsk->params.fr_depth = fr_depth;
+  xsk->params.rx_depth = rx_depth;
+  xsk->params.tx_depth = tx_depth;
+  xsk->params.cr_depth = cr_depth;
+  xsk->params.umem_sz  = umem_sz;
+  xsk->params.headroom = headroom;
+  xsk->umem_ext        = umem;
+
+  /* Mark object as valid */
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( xsk->magic ) = FD_XSK_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return (void *)xsk;
+}
+
 void *
 fd_xsk_delete( void * shxsk ) {
 
@@ -378,12 +516,12 @@ fd_xsk_cleanup( fd_xsk_t * xsk ) {
    getsockopt().  Returns 1 on success, 0 on failure. */
 static int
 fd_xsk_setup_umem( fd_xsk_t * xsk ) {
-  /* Find byte offset of UMEM area */
+  /* Find byte offset of UMEM area (if it follows the fd_xsk_t) */
   ulong umem_off = fd_ulong_align_up( sizeof(fd_xsk_t), FD_XSK_UMEM_ALIGN );
 
   /* Initialize xdp_umem_reg */
-  xsk->umem.headroom   = 0; /* TODO no need for headroom for now */
-  xsk->umem.addr       = (ulong)xsk + umem_off;
+  xsk->umem.headroom   = (uint)xsk->params.headroom;
+  xsk->umem.addr       = xsk->umem_ext ? (ulong)xsk->umem_ext : (ulong)xsk + umem_off;
   xsk->umem.chunk_size = (uint)xsk->params.frame_sz;
   xsk->umem.len        =       xsk->params.umem_sz;
 
@@ -145,6 +145,10 @@ struct fd_xsk_params {
   /* umem_sz: Total size of XSK ring shared memory area (contiguous).
      Aligned by FD_XSK_ALIGN. */
   ulong umem_sz;
+
+  /* headroom: Number of bytes reserved at the start of each UMEM frame
+     before received packet data. */
+  ulong headroom;
 };
 typedef struct fd_xsk_params fd_xsk_params_t;
 
@@ -182,11 +186,54 @@ fd_xsk_new( void * shmem,
             ulong  tx_depth,
             ulong  cr_depth);
 
+/* fd_xsk_{footprint,new}_umem are variants of fd_xsk_{footprint,new}
+   for an fd_xsk_t whose UMEM is not part of its own memory region but
+   the caller provided umem_sz byte region at umem.  This allows laying
+   out the UMEM over memory that other tiles can address, e.g. the data
+   region of a dcache in a wksp, such that received frames can be
+   handed downstream without copying them.
+
+   fd_xsk_footprint_umem returns the footprint of an fd_xsk_t without
+   UMEM (its alignment is fd_xsk_align()).  umem should be aligned by
+   FD_XSK_UMEM_ALIGN and umem_sz should be a positive multiple of
+   frame_sz (the UMEM holds umem_sz/frame_sz frames).  headroom is the
+   number of bytes to reserve at the start of each frame before the
+   received packet data (in [0,frame_sz/2]).  Note that when a driver
+   supports AF_XDP zero copy, it reserves an additional
+   XDP_PACKET_HEADROOM bytes (256 as of Linux 5.x) before headroom.
+   The ring depths should be powers of 2.
+
+   umem is a pointer in the caller's local address space, so the
+   returned fd_xsk_t should only be joined by the caller's thread group
+   and umem should outlive any join. */
+
+FD_FN_CONST ulong
+fd_xsk_footprint_umem( void );
+
+void *
+fd_xsk_new_umem( void * shmem,
+                 void * umem,
+                 ulong  umem_sz,
+                 ulong  frame_sz,
+                 ulong  headroom,
+                 ulong  fr_depth,
+                 ulong  rx_depth,
+                 ulong  tx_depth,
+                 ulong  cr_depth );
+
 /* fd_xsk_bind assigns an XSK buffer to the network device with name
    ifname and RX queue index ifqueue.  fd_xsk_unbind unassigns an XSK
    buffer from any netdev queue.  shxsk points to the first byte of the
    memory region backing the fd_xsk_t in the caller's address space.
-   Returns shxsk on success or NULL on failure (logs details).
+   Returns shxsk on success or NULL on failure (logs details).  Fails if
+   ifqueue is not an RX queue of ifname (if the number of queues can be
+   determined, see fd_xsk_ifqueue_cnt) or is at least
+   FD_XDP_XSKS_MAP_CNT.
+
+   To receive on a multi-queue device (where RSS spreads flows over the
+   RX queues), bind one fd_xsk_t to each RX queue and service each from
+   its own tile.  The XDP redirect program steers each packet to the XSK
+   registered for the queue it arrived on.
 
    The app_name is used to discover the XSKMAP on join at path
    "/sys/fs/bpf/{bpf_app_name}/{ifname}/xsks". */
@@ -200,6 +247,14 @@ fd_xsk_bind( void *       shxsk,
 void *
 fd_xsk_unbind( void * shxsk );
 
+/* fd_xsk_ifqueue_cnt returns the number of RX queues of the network
+   device with name ifname (as exposed under
+   /sys/class/net/{ifname}/queues).  Returns 0 on failure (logs
+   details). */
+
+ulong
+fd_xsk_ifqueue_cnt( char const * ifname );
+
 /* fd_xsk_join joins the caller to the fd_xsk_t and starts packet
    redirection.  shxsk points to the first byte of the memory region
    backing the fd_xsk_t in the caller's address space.  Returns a
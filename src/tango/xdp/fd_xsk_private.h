@@ -80,6 +80,12 @@ struct __attribute__((aligned(FD_XSK_ALIGN))) fd_xsk_private {
 
   fd_xsk_params_t params;
 
+  /* umem_ext: Local address of the UMEM area if it is external to the
+     fd_xsk_t (see fd_xsk_new_umem), in the address space of the
+     thread group that created the fd_xsk_t.  NULL if the UMEM area
+     follows the fd_xsk_t. */
+  void * umem_ext;
+
   /* xdp_mode: XDP processing mode.  Defined by <linux/if_link.h>
 
      Valid values:
@@ -0,0 +1,218 @@
+/* test_xdp_redirect_prog: Loads fd_xdp_redirect_prog through the
+   kernel's eBPF verifier and runs the per source rate limiter (including
+   the LRU eviction path) with BPF_PROG_TEST_RUN.  Needs the eBPF object
+   (make ebpf-bin, requires clang with the bpf target) and CAP_BPF /
+   CAP_SYS_ADMIN.  This is only built with EXTRAS=libbpf and, as such,
+   is not part of run-unit-test.  E.g.
+
+     make EXTRAS=libbpf ebpf-bin unit-test
+     sudo build/linux/gcc/x86_64/unit-test/test_xdp_redirect_prog \
+       --prog build/ebpf/clang/bin/fd_xdp_redirect_prog.o
+
+   No interface is hooked and no map is pinned (the program's maps are
+   private to the test). */
+
+#define _GNU_SOURCE
+
+#include "../../util/fd_util.h"
+#include "../../util/net/fd_ip4.h"
+#include "fd_xdp_redirect_prog.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+
+/* test_pkt is an Ethernet / IPv4 / UDP packet (64 bytes as the program
+   only looks at packets of at least 60 bytes).  IPv4 addrs are in
+   network byte order (as FD_IP4_ADDR) and the UDP port in host byte
+   order. */
+
+static uchar test_pkt[ 64 ];
+
+static void
+test_pkt_init( uint ip4_src,
+               uint ip4_dst,
+               uint udp_dst ) {
+  memset( test_pkt, 0, sizeof(test_pkt) );
+  uchar * eth = test_pkt;
+  uchar * ip  = eth + 14;
+  uchar * udp = ip  + 20;
+  eth[12] = 0x08; eth[13] = 0x00;                    /* ethertype IPv4 */
+  ip[0]   = 0x45;                                    /* IPv4, IHL 5 */
+  ip[9]   = 0x11;                                    /* proto UDP */
+  FD_STORE( uint,   ip +12, ip4_src                           );
+  FD_STORE( uint,   ip +16, ip4_dst                           );
+  FD_STORE( ushort, udp+ 2, fd_ushort_bswap( (ushort)udp_dst ) );
+}
+
+static void
+test_pkt_src( uint ip4_src ) {
+  FD_STORE( uint, test_pkt+14+12, ip4_src );
+}
+
+/* test_run runs the program on test_pkt and returns its XDP action */
+
+static uint
+test_run( int prog_fd ) {
+  struct bpf_test_run_opts opts = {
+    .sz           = sizeof(struct bpf_test_run_opts),
+    .data_in      = test_pkt,
+    .data_size_in = (uint)sizeof(test_pkt),
+    .repeat       = 1,
+  };
+  if( FD_UNLIKELY( 0!=bpf_prog_test_run_opts( prog_fd, &opts ) ) )
+    FD_LOG_ERR(( "bpf_prog_test_run_opts(fd=%d) failed (%d-%s)", prog_fd, errno, strerror( errno ) ));
+  return opts.retval;
+}
+
+/* test_stat returns the rate limiter counter key summed over all CPUs */
+
+static ulong
+test_stat( int   stats_fd,
+           uint  key,
+           ulong cpu_cnt ) {
+  ulong * val = (ulong *)malloc( cpu_cnt*sizeof(ulong) );
+  FD_TEST( val );
+  FD_TEST( 0==bpf_map_lookup_elem( stats_fd, &key, val ) );
+  ulong sum = 0UL;
+  for( ulong cpu_idx=0UL; cpu_idx<cpu_cnt; cpu_idx++ ) sum += val[ cpu_idx ];
+  free( val );
+  return sum;
+}
+
+static int
+test_map_fd( struct bpf_object * obj,
+             char const *        name ) {
+  struct bpf_map * map = bpf_object__find_map_by_name( obj, name );
+  FD_TEST( map );
+  int fd = bpf_map__fd( map );
+  FD_TEST( fd>=0 );
+  return fd;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * prog_path = fd_env_strip_cmdline_cstr ( &argc, &argv, "--prog",  NULL, "build/ebpf/clang/bin/fd_xdp_redirect_prog.o" );
+  ulong        burst     = fd_env_strip_cmdline_ulong( &argc, &argv, "--burst", NULL, 4UL                                          );
+
+  FD_TEST( burst );
+
+  FD_LOG_NOTICE(( "Using --prog %s --burst %lu", prog_path, burst ));
+
+  /* The limit is enforced per CPU, keep all runs on one CPU */
+
+  int cpu_idx = sched_getcpu();
+  FD_TEST( cpu_idx>=0 );
+  cpu_set_t cpu_set[1];
+  CPU_ZERO( cpu_set );
+  CPU_SET( (ulong)cpu_idx, cpu_set );
+  FD_TEST( 0==sched_setaffinity( 0, sizeof(cpu_set_t), cpu_set ) );
+
+  int cpu_cnt = libbpf_num_possible_cpus();
+  FD_TEST( cpu_cnt>0 );
+
+  /* Load the program (this runs the verifier) */
+
+  struct bpf_object * obj = bpf_object__open_file( prog_path, NULL );
+  if( FD_UNLIKELY( !obj ) ) {
+    FD_LOG_WARNING(( "skip: bpf_object__open_file(%s) failed (%d-%s), build it with make ebpf-bin",
+                     prog_path, errno, strerror( errno ) ));
+    fd_halt();
+    return 0;
+  }
+  if( FD_UNLIKELY( 0!=bpf_object__load( obj ) ) ) {
+    if( (errno==EPERM) | (errno==EACCES) ) {
+      FD_LOG_WARNING(( "skip: unit test requires CAP_BPF and CAP_SYS_ADMIN capabilities" ));
+      bpf_object__close( obj );
+      fd_halt();
+      return 0;
+    }
+    FD_LOG_ERR(( "bpf_object__load(%s) failed (%d-%s)", prog_path, errno, strerror( errno ) ));
+  }
+
+  struct bpf_program * prog = bpf_object__find_program_by_name( obj, "firedancer_redirect" );
+  FD_TEST( prog );
+  int prog_fd = bpf_program__fd( prog );
+  FD_TEST( prog_fd>=0 );
+
+  int udp_dsts_fd = test_map_fd( obj, "firedancer_udp_dsts"     );
+  int cfg_fd      = test_map_fd( obj, "firedancer_rlimit_cfg"   );
+  int stats_fd    = test_map_fd( obj, "firedancer_rlimit_stats" );
+
+  /* Listen on 10.0.0.1:9000 */
+
+  uint ip4_dst = FD_IP4_ADDR( 10, 0, 0, 1 );
+  uint udp_dst = 9000U;
+  ulong flow_key = ((ulong)ip4_dst<<16) | (ulong)fd_ushort_bswap( (ushort)udp_dst ); /* See firedancer_udp_dsts */
+  int   flow_val = 1;
+  FD_TEST( 0==bpf_map_update_elem( udp_dsts_fd, &flow_key, &flow_val, BPF_ANY ) );
+
+  /* Unrelated traffic and listened traffic without a limit pass (no XSK
+     is active so matching traffic falls back to the Linux stack) */
+
+  uint ip4_src = FD_IP4_ADDR( 192, 168, 0, 1 );
+  test_pkt_init( ip4_src, ip4_dst, udp_dst+1U );
+  FD_TEST( test_run( prog_fd )==XDP_PASS );
+  test_pkt_init( ip4_src, ip4_dst, udp_dst );
+  for( ulong i=0UL; i<2UL*burst; i++ ) FD_TEST( test_run( prog_fd )==XDP_PASS );
+  FD_TEST( test_stat( stats_fd, FD_XDP_RLIMIT_STAT_PASS, (ulong)cpu_cnt )==0UL );
+  FD_TEST( test_stat( stats_fd, FD_XDP_RLIMIT_STAT_DROP, (ulong)cpu_cnt )==0UL );
+
+  /* Limit to burst packets per hour such that buckets do not refill
+     while the test runs */
+
+  uint key = 0U;
+  struct fd_xdp_rlimit_cfg cfg = { .interval = 3600UL*1000000000UL };
+  cfg.tol = (burst-1UL)*cfg.interval;
+  FD_TEST( 0==bpf_map_update_elem( cfg_fd, &key, &cfg, BPF_ANY ) );
+
+  /* A source gets burst packets through, then is dropped */
+
+  ulong pass_cnt = 0UL;
+  ulong drop_cnt = 0UL;
+
+  for( ulong i=0UL; i<burst; i++ ) { FD_TEST( test_run( prog_fd )==XDP_PASS ); pass_cnt++; }
+  for( ulong i=0UL; i<4UL;   i++ ) { FD_TEST( test_run( prog_fd )==XDP_DROP ); drop_cnt++; }
+
+  /* Other sources have their own buckets */
+
+  test_pkt_src( ip4_src+1U );
+  FD_TEST( test_run( prog_fd )==XDP_PASS ); pass_cnt++;
+  test_pkt_src( ip4_src );
+  FD_TEST( test_run( prog_fd )==XDP_DROP ); drop_cnt++;
+
+  /* A flood of spoofed sources (twice the map capacity) all start with
+     full buckets and evict the least recently seen sources, which
+     forgets the drained source's history */
+
+  ulong flood_cnt = 2UL*(ulong)FD_XDP_RLIMIT_MAP_CNT;
+  for( ulong i=0UL; i<flood_cnt; i++ ) {
+    test_pkt_src( FD_IP4_ADDR( 172, 16, 0, 0 ) + (uint)i );
+    FD_TEST( test_run( prog_fd )==XDP_PASS ); pass_cnt++;
+  }
+
+  test_pkt_src( ip4_src );
+  FD_TEST( test_run( prog_fd )==XDP_PASS ); pass_cnt++;
+
+  FD_TEST( test_stat( stats_fd, FD_XDP_RLIMIT_STAT_PASS, (ulong)cpu_cnt )==pass_cnt );
+  FD_TEST( test_stat( stats_fd, FD_XDP_RLIMIT_STAT_DROP, (ulong)cpu_cnt )==drop_cnt );
+
+  /* Disabling the limit lets everything through again */
+
+  cfg.interval = 0UL;
+  cfg.tol      = 0UL;
+  FD_TEST( 0==bpf_map_update_elem( cfg_fd, &key, &cfg, BPF_ANY ) );
+  for( ulong i=0UL; i<2UL*burst; i++ ) FD_TEST( test_run( prog_fd )==XDP_PASS );
+  FD_TEST( test_stat( stats_fd, FD_XDP_RLIMIT_STAT_PASS, (ulong)cpu_cnt )==pass_cnt );
+
+  bpf_object__close( obj );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
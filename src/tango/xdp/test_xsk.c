@@ -17,6 +17,7 @@ FD_STATIC_ASSERT( alignof(fd_xsk_frame_meta_t)>=8UL,                        alig
 /* fd_xsk_t memory region */
 
 static uchar _xsk[ 262144UL ] __attribute__((aligned(FD_XSK_ALIGN)));
+static uchar _umem[ 16384UL ] __attribute__((aligned(FD_XSK_UMEM_ALIGN)));
 
 /* Mock mmap'ed rings provided by kernel */
 
@@ -122,6 +123,29 @@ test_xsk( void ) {
   FD_TEST( NULL==fd_xsk_new( _xsk,               2048UL, 1UL, 1UL, 0UL, 1UL ) ); /* zero fr_depth  */
   FD_TEST( NULL==fd_xsk_new( _xsk,               2048UL, 1UL, 1UL, 1UL, 0UL ) ); /* zero fr_depth  */
 
+  /* Invalid new_umem params */
+
+  FD_TEST( fd_xsk_footprint_umem()>=sizeof(fd_xsk_t)                              );
+  FD_TEST( fd_xsk_footprint_umem()< fd_xsk_footprint( 2048UL, 1UL, 1UL, 1UL, 1UL ) );
+
+  FD_TEST( NULL==fd_xsk_new_umem( NULL, _umem,       16384UL, 2048UL,    0UL, 8UL, 8UL, 8UL, 8UL ) ); /* NULL shmem         */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, NULL,        16384UL, 2048UL,    0UL, 8UL, 8UL, 8UL, 8UL ) ); /* NULL umem          */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem+64UL,  8192UL,  2048UL,    0UL, 8UL, 8UL, 8UL, 8UL ) ); /* unalign umem       */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem,       0UL,     2048UL,    0UL, 8UL, 8UL, 8UL, 8UL ) ); /* zero umem_sz       */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem,       10000UL, 2048UL,    0UL, 8UL, 8UL, 8UL, 8UL ) ); /* inval umem_sz      */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem,       16384UL, 1000UL,    0UL, 8UL, 8UL, 8UL, 8UL ) ); /* inval frame_sz     */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem,       16384UL, 2048UL, 2048UL, 8UL, 8UL, 8UL, 8UL ) ); /* oversz headroom    */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem,       16384UL, 2048UL,    0UL, 6UL, 8UL, 8UL, 8UL ) ); /* non-pow2 fr_depth  */
+  FD_TEST( NULL==fd_xsk_new_umem( _xsk, _umem,       16384UL, 2048UL,    0UL, 8UL, 8UL, 8UL, 0UL ) ); /* zero cr_depth      */
+
+  /* Create new XSK with external UMEM */
+
+  void * shxsk_umem = fd_xsk_new_umem( _xsk, _umem, 16384UL, 2048UL, 22UL, 8UL, 8UL, 8UL, 8UL );
+  FD_TEST( shxsk_umem==_xsk );
+  FD_TEST( fd_xsk_get_params( (fd_xsk_t *)shxsk_umem )->umem_sz ==16384UL );
+  FD_TEST( fd_xsk_get_params( (fd_xsk_t *)shxsk_umem )->headroom==22UL    );
+  FD_TEST( fd_xsk_delete( shxsk_umem )==_xsk );
+
   /* Create new XSK */
 
   FD_TEST( fd_xsk_footprint( 2048UL, 8UL, 8UL, 8UL, 8UL )==69632UL );
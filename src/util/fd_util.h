@@ -15,8 +15,9 @@
 //#include "tile/fd_tile.h"         /* includes shmem/fd_shmem.h */
 #include "math/fd_stat.h"           /* includes bits/fd_bits.h */
 #include "rng/fd_rng.h"             /* includes bits/fd_bits.h */
-#include "tpool/fd_tpool.h"         /* includes tile/fd_tile.h and scratch/fd_scratch.h */
+#include "tpool/fd_steal.h"         /* includes tpool/fd_tpool.h */
 #include "alloc/fd_alloc.h"         /* includes wksp/fd_wksp.h */
+#include "perf/fd_perf.h"           /* includes log/fd_log.h */
 
 /* Additional fd_util APIs that are not included by default */
 
@@ -1,4 +1,4 @@
 $(call add-hdrs,fd_log.h)
 $(call add-objs,fd_log,fd_util)
 $(call make-unit-test,test_log,test_log,fd_util)
-
+$(call make-unit-test,bench_log,bench_log,fd_util)
@@ -0,0 +1,114 @@
+#include "../fd_util.h"
+
+/* bench_log measures the latency of FD_LOG_INFO calls (as seen by the
+   logging thread) when logging synchronously and when logging
+   asynchronously via a fd_log_async_t drained by a dedicated log tile
+   (tile 1, if available).  Run this with a log file (e.g. the default
+   autogenerated one) as INFO messages only go to the log file. */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#define RING_SZ  (1UL<<24)
+#define ITER_MAX (1UL<<20)
+
+static long lat[ ITER_MAX ];
+
+static uchar async_mem[ FD_LOG_ASYNC_FOOTPRINT( 1UL, RING_SZ ) ] __attribute__((aligned(FD_LOG_ASYNC_ALIGN)));
+
+static int
+log_tile_main( int     argc,
+               char ** argv ) {
+  (void)argc;
+  fd_log_async_run( (fd_log_async_t *)argv, 10000L );
+  return 0;
+}
+
+static void
+report( char const * name,
+        long *       lat,
+        ulong        cnt,
+        double       ns_per_tick ) {
+  fd_sort_up_long_inplace( lat, cnt );
+  double sum = 0.;
+  for( ulong i=0UL; i<cnt; i++ ) sum += (double)lat[i];
+# define NS(t) (ns_per_tick*(double)(t))
+  FD_LOG_NOTICE(( "%-5s: avg %8.1f ns, min %8.1f ns, p50 %8.1f ns, p99 %8.1f ns, p99.9 %9.1f ns, max %10.1f ns",
+                  name, NS( sum/(double)cnt ), NS( lat[0] ), NS( lat[cnt/2UL] ), NS( lat[(cnt*99UL)/100UL] ),
+                  NS( lat[(cnt*999UL)/1000UL] ), NS( lat[cnt-1UL] ) ));
+# undef NS
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong        iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 100000UL );
+  char const * _mode    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--mode",     NULL, "block"  );
+
+  int mode;
+  if(      !strcmp( _mode, "block" ) ) mode = FD_LOG_ASYNC_MODE_BLOCK;
+  else if( !strcmp( _mode, "drop"  ) ) mode = FD_LOG_ASYNC_MODE_DROP;
+  else FD_LOG_ERR(( "--mode should be block or drop" ));
+  if( FD_UNLIKELY( !((1UL<=iter_cnt) & (iter_cnt<=ITER_MAX)) ) ) FD_LOG_ERR(( "--iter-cnt should be in [1,%lu]", ITER_MAX ));
+
+  FD_LOG_NOTICE(( "Benchmarking (--iter-cnt %lu --mode %s, %s log tile)", iter_cnt, _mode,
+                  fd_tile_cnt()>1UL ? "with" : "no" ));
+
+  /* Calibrate the tickcounter */
+
+  long   wc0 = fd_log_wallclock(); long tc0 = fd_tickcount();
+  fd_log_sleep( (long)50e6 );
+  long   wc1 = fd_log_wallclock(); long tc1 = fd_tickcount();
+  double ns_per_tick = (double)(wc1-wc0) / (double)(tc1-tc0);
+
+  /* Synchronous */
+
+  for( ulong i=0UL; i<iter_cnt; i++ ) {
+    long t0 = fd_tickcount();
+    FD_LOG_INFO(( "bench_log sync %lu", i ));
+    lat[i] = fd_tickcount() - t0;
+  }
+  report( "sync", lat, iter_cnt, ns_per_tick );
+
+  /* Asynchronous */
+
+  fd_log_async_t * async = fd_log_async_join( fd_log_async_new( async_mem, 1UL, RING_SZ, mode ) ); FD_TEST( async );
+  fd_log_async_set( async );
+
+  fd_tile_exec_t * exec = NULL;
+  if( fd_tile_cnt()>1UL ) { exec = fd_tile_exec_new( 1UL, log_tile_main, 0, (char **)fd_type_pun( async ) ); FD_TEST( exec ); }
+
+  for( ulong i=0UL; i<iter_cnt; i++ ) {
+    long t0 = fd_tickcount();
+    FD_LOG_INFO(( "bench_log async %lu", i ));
+    lat[i] = fd_tickcount() - t0;
+  }
+
+  if( exec ) {
+    fd_log_async_halt( async );
+    int ret; FD_TEST( !fd_tile_exec_delete( exec, &ret ) ); FD_TEST( !ret );
+  }
+  fd_log_async_set( NULL );
+  report( "async", lat, iter_cnt, ns_per_tick );
+  FD_LOG_NOTICE(( "async: %lu messages dropped", fd_log_async_drop_cnt( async ) ));
+
+  FD_TEST( fd_log_async_delete( fd_log_async_leave( async ) )==async_mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
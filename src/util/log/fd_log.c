@@ -589,15 +589,410 @@ fd_log_private_hexdump_msg ( char const * descr,
 # undef FD_LOG_HEXDUMP_ADD_TO_LOG_BUF
 }
 
+/* ASYNC LOG APIS *****************************************************/
+
+/* A fd_log_async_t is a header followed by ring_cnt rings.  Each ring
+   is a ring header followed by ring_sz bytes of ring data.  The ring
+   header has a cache line written only by the ring's producer (the
+   thread that claimed the ring) and a cache line written only by the
+   drainer (the thread holding the drain lock).  Messages are stored in
+   the ring data as an 8 byte record header (the size of the message's
+   log file part in the low 32 bits and the size of its stderr part in
+   the high 32 bits) followed by the log file part and the stderr part,
+   padded to a multiple of 8 bytes.  Records never wrap around the end
+   of the ring data; if a record would, the space to the end of the
+   ring data is consumed by a pad record (record header ULONG_MAX).
+   prod and cons are the total number of bytes ever published / drained
+   to / from the ring. */
+
+#define FD_LOG_ASYNC_MAGIC (0xfd1094a5c3a61c00UL) /* fd log async ring magic, version 0 */
+
+#define FD_LOG_ASYNC_MSG_MAX (FD_LOG_BUF_SZ + 2048UL) /* Max bytes of a message part, including the log message prefix and any SNIPs */
+
+struct __attribute__((aligned(FD_LOG_ASYNC_ALIGN))) fd_log_async_private {
+  ulong magic;     /* == FD_LOG_ASYNC_MAGIC */
+  ulong ring_cnt;  /* Number of rings, positive */
+  ulong ring_sz;   /* Ring data bytes, power of 2 in [FD_LOG_ASYNC_RING_SZ_MIN,FD_LOG_ASYNC_RING_SZ_MAX] */
+  int   mode;      /* FD_LOG_ASYNC_MODE_* */
+  int   halt;      /* Non-zero if fd_log_async_run should halt */
+  ulong claim_cnt; /* Number of rings claimed (can exceed ring_cnt) */
+  ulong lock;      /* 1 if a thread is draining, 0 otherwise */
+};
+
+struct __attribute__((aligned(128))) fd_log_async_ring {
+  ulong prod;                                      /* Written by the producer */
+  ulong drop_cnt;                                  /* " */
+  ulong cons      __attribute__((aligned(128)));   /* Written by the drainer */
+  ulong drop_seen;                                 /* " */
+};
+
+typedef struct fd_log_async_ring fd_log_async_ring_t;
+
+FD_STATIC_ASSERT( sizeof(fd_log_async_t     )==128UL, layout );
+FD_STATIC_ASSERT( sizeof(fd_log_async_ring_t)==256UL, layout );
+
+FD_STATIC_ASSERT( 8UL+2UL*FD_LOG_ASYNC_MSG_MAX<=FD_LOG_ASYNC_RING_SZ_MIN/2UL, limits ); /* Records always eventually fit */
+
+static inline fd_log_async_ring_t *
+fd_log_private_async_ring_laddr( fd_log_async_t const * async,
+                                 ulong                  ring_idx ) {
+  return (fd_log_async_ring_t *)((ulong)async + sizeof(fd_log_async_t) + ring_idx*(sizeof(fd_log_async_ring_t)+async->ring_sz));
+}
+
+static fd_log_async_t * fd_log_private_async; /* NULL on start (i.e. synchronous logging) */
+
+/* fd_log_private_async_out is non-zero while the calling thread is
+   formatting a message for its async ring.  The message's log file and
+   stderr parts are staged in fd_log_private_async_msg. */
+
+static FD_TLS int   fd_log_private_async_out;
+static FD_TLS char  fd_log_private_async_msg   [ 2 ][ FD_LOG_ASYNC_MSG_MAX ];
+static FD_TLS ulong fd_log_private_async_msg_sz[ 2 ];
+
+static FD_TLS fd_log_async_t *      fd_log_private_async_owner; /* async from which the calling thread claimed its ring */
+static FD_TLS fd_log_async_ring_t * fd_log_private_async_claim; /* The claimed ring, NULL if none were left */
+
+/* fd_log_private_async_ring returns the calling thread's ring in async,
+   claiming one if necessary.  Returns NULL if all async's rings have
+   been claimed by other threads. */
+
+static fd_log_async_ring_t *
+fd_log_private_async_ring( fd_log_async_t * async ) {
+  if( FD_UNLIKELY( fd_log_private_async_owner!=async ) ) {
+#   if FD_HAS_ATOMIC
+    ulong ring_idx = FD_ATOMIC_FETCH_AND_ADD( &async->claim_cnt, 1UL );
+#   else
+    ulong ring_idx = async->claim_cnt++;
+#   endif
+    fd_log_private_async_claim = (ring_idx<async->ring_cnt) ? fd_log_private_async_ring_laddr( async, ring_idx ) : NULL;
+    fd_log_private_async_owner = async;
+  }
+  return fd_log_private_async_claim;
+}
+
+/* fd_log_private_fprintf is fprintf for the log streams.  If the
+   calling thread is formatting a message for its async ring, the output
+   is appended to the message's staging buffer for stream instead
+   (detectably truncated if too long). */
+
+static void
+fd_log_private_fprintf( FILE *       stream,
+                        char const * fmt, ... ) __attribute__((format(printf,2,3)));
+
+static void
+fd_log_private_fprintf( FILE *       stream,
+                        char const * fmt, ... ) {
+  va_list ap;
+  va_start( ap, fmt );
+  if( FD_LIKELY( !fd_log_private_async_out ) ) vfprintf( stream, fmt, ap );
+  else {
+    ulong part = (ulong)(stream==stderr);
+    ulong sz   = fd_log_private_async_msg_sz[ part ];
+    ulong rem  = FD_LOG_ASYNC_MSG_MAX - sz;
+    int   len  = vsnprintf( fd_log_private_async_msg[ part ] + sz, rem, fmt, ap );
+    if( len<0 ) len = 0; /* cmov */
+    if( (ulong)len>rem-1UL ) { /* Truncated, keep the message newline terminated */
+      len = (int)(rem-1UL);
+      fd_log_private_async_msg[ part ][ sz+(ulong)len-1UL ] = '\n';
+    }
+    fd_log_private_async_msg_sz[ part ] = sz + (ulong)len;
+  }
+  va_end( ap );
+}
+
+static ulong fd_log_private_async_drain( fd_log_async_t * async, int block );
+
+/* fd_log_private_async_push publishes the message staged by the calling
+   thread to its ring (if any) and clears the staging buffers.  If
+   no_drop, the caller waits for room even in drop mode (used for
+   messages at or above the flush level, e.g. the message explaining an
+   imminent exit / abort). */
+
+static void
+fd_log_private_async_push( fd_log_async_t *      async,
+                           fd_log_async_ring_t * ring,
+                           int                   no_drop ) {
+  ulong lf_sz = fd_log_private_async_msg_sz[ 0 ];
+  ulong se_sz = fd_log_private_async_msg_sz[ 1 ];
+  fd_log_private_async_msg_sz[ 0 ] = 0UL;
+  fd_log_private_async_msg_sz[ 1 ] = 0UL;
+  if( FD_UNLIKELY( !(lf_sz | se_sz) ) ) return;
+
+  ulong   ring_sz = async->ring_sz;
+  uchar * data    = (uchar *)(ring+1);
+  ulong   prod    = ring->prod;
+  ulong   off     = prod & (ring_sz-1UL);
+  ulong   rec_sz  = 8UL + fd_ulong_align_up( lf_sz + se_sz, 8UL );
+  ulong   pad_sz  = fd_ulong_if( off+rec_sz>ring_sz, ring_sz-off, 0UL );
+
+  for(;;) {
+    ulong cons = FD_VOLATILE_CONST( ring->cons );
+    if( FD_LIKELY( (pad_sz+rec_sz)<=(ring_sz-(prod-cons)) ) ) break;
+    if( (!no_drop) & (FD_VOLATILE_CONST( async->mode )==FD_LOG_ASYNC_MODE_DROP) ) {
+      FD_VOLATILE( ring->drop_cnt ) = ring->drop_cnt + 1UL;
+      return;
+    }
+    if( !fd_log_private_async_drain( async, 0 ) ) FD_SPIN_PAUSE(); /* Block, helping drain */
+  }
+
+  if( FD_UNLIKELY( pad_sz ) ) {
+    FD_STORE( ulong, data+off, ULONG_MAX );
+    prod += pad_sz;
+    off   = 0UL;
+  }
+  FD_STORE( ulong, data+off, lf_sz | (se_sz<<32) );
+  fd_memcpy( data+off+8UL,       fd_log_private_async_msg[ 0 ], lf_sz );
+  fd_memcpy( data+off+8UL+lf_sz, fd_log_private_async_msg[ 1 ], se_sz );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( ring->prod ) = prod + rec_sz;
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_log_private_async_drain drains async's rings to the caller's log
+   streams.  If block is zero and another thread is draining, returns 0
+   immediately.  Otherwise, waits for the other thread to finish and
+   then drains.  Returns the number of messages drained. */
+
+static ulong
+fd_log_private_async_drain( fd_log_async_t * async,
+                            int              block ) {
+  for(;;) {
+#   if FD_HAS_ATOMIC
+    if( FD_LIKELY( !FD_ATOMIC_CAS( &async->lock, 0UL, 1UL ) ) ) break;
+#   else
+    if( FD_LIKELY( !async->lock ) ) { async->lock = 1UL; break; }
+#   endif
+    if( !block ) return 0UL;
+    FD_SPIN_PAUSE();
+  }
+  FD_COMPILER_MFENCE();
+
+  FILE * log_file = FD_VOLATILE_CONST( fd_log_private_file );
+  ulong  ring_sz  = async->ring_sz;
+  ulong  ring_cnt = fd_ulong_min( FD_VOLATILE_CONST( async->claim_cnt ), async->ring_cnt );
+  ulong  msg_cnt  = 0UL;
+
+  for( ulong ring_idx=0UL; ring_idx<ring_cnt; ring_idx++ ) {
+    fd_log_async_ring_t * ring = fd_log_private_async_ring_laddr( async, ring_idx );
+    uchar const *         data = (uchar const *)(ring+1);
+
+    ulong cons = ring->cons;
+    ulong prod = FD_VOLATILE_CONST( ring->prod );
+    FD_COMPILER_MFENCE();
+
+    while( cons!=prod ) {
+      ulong         off = cons & (ring_sz-1UL);
+      ulong         hdr = FD_LOAD( ulong, data+off );
+      if( FD_UNLIKELY( hdr==ULONG_MAX ) ) { cons += ring_sz-off; continue; } /* Pad */
+      ulong         lf_sz = hdr & 0xffffffffUL;
+      ulong         se_sz = hdr >> 32;
+      uchar const * msg   = data + off + 8UL;
+      if( lf_sz && log_file ) fwrite( msg,       1UL, lf_sz, log_file );
+      if( se_sz             ) fwrite( msg+lf_sz, 1UL, se_sz, stderr   );
+      cons += 8UL + fd_ulong_align_up( lf_sz + se_sz, 8UL );
+      msg_cnt++;
+    }
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( ring->cons ) = cons;
+    FD_COMPILER_MFENCE();
+
+    ulong drop_cnt = FD_VOLATILE_CONST( ring->drop_cnt );
+    if( FD_UNLIKELY( drop_cnt!=ring->drop_seen ) ) {
+      ulong dropped = drop_cnt - ring->drop_seen;
+      ring->drop_seen = drop_cnt;
+
+      char now_cstr[ FD_LOG_WALLCLOCK_CSTR_BUF_SZ ];
+      fd_log_wallclock_cstr( fd_log_wallclock(), now_cstr );
+      if( log_file ) fprintf( log_file, "SNIP    %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s async log ring %lu full (%lu messages dropped)\n",
+                              now_cstr, fd_log_group_id(),fd_log_tid(), fd_log_user(),fd_log_host(),fd_log_cpu(),
+                              fd_log_app(),fd_log_group(),fd_log_thread(), ring_idx, dropped );
+      char * now_short_cstr = now_cstr+5; now_short_cstr[21] = '\0'; /* Lop off the year, ns resolution and timezone */
+      fprintf( stderr, "SNIP    %s %-6lu %-4s %-4s async log ring %lu full (%lu messages dropped)\n",
+               now_short_cstr, fd_log_tid(),fd_log_cpu(),fd_log_thread(), ring_idx, dropped );
+    }
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( async->lock ) = 0UL;
+  FD_COMPILER_MFENCE();
+  return msg_cnt;
+}
+
+ulong fd_log_async_align( void ) { return FD_LOG_ASYNC_ALIGN; }
+
+ulong
+fd_log_async_footprint( ulong ring_cnt,
+                        ulong ring_sz ) {
+  if( FD_UNLIKELY( !ring_cnt                               ) ) return 0UL;
+  if( FD_UNLIKELY( !fd_ulong_is_pow2( ring_sz )            ) ) return 0UL;
+  if( FD_UNLIKELY( !((FD_LOG_ASYNC_RING_SZ_MIN<=ring_sz) &
+                     (ring_sz<=FD_LOG_ASYNC_RING_SZ_MAX) ) ) ) return 0UL;
+  if( FD_UNLIKELY( ring_cnt>((ULONG_MAX-128UL)/(256UL+ring_sz)) ) ) return 0UL;
+  return FD_LOG_ASYNC_FOOTPRINT( ring_cnt, ring_sz );
+}
+
+void *
+fd_log_async_new( void * shmem,
+                  ulong  ring_cnt,
+                  ulong  ring_sz,
+                  int    mode ) {
+  fd_log_async_t * async = (fd_log_async_t *)shmem;
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_log_async_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_log_async_footprint( ring_cnt, ring_sz ) ) ) {
+    FD_LOG_WARNING(( "bad ring_cnt or ring_sz" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((mode==FD_LOG_ASYNC_MODE_DROP) | (mode==FD_LOG_ASYNC_MODE_BLOCK)) ) ) {
+    FD_LOG_WARNING(( "bad mode" ));
+    return NULL;
+  }
+
+  memset( async, 0, sizeof(fd_log_async_t) );
+  async->ring_cnt = ring_cnt;
+  async->ring_sz  = ring_sz;
+  async->mode     = mode;
+  for( ulong ring_idx=0UL; ring_idx<ring_cnt; ring_idx++ )
+    memset( fd_log_private_async_ring_laddr( async, ring_idx ), 0, sizeof(fd_log_async_ring_t) );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( async->magic ) = FD_LOG_ASYNC_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_log_async_t *
+fd_log_async_join( void * shasync ) {
+  fd_log_async_t * async = (fd_log_async_t *)shasync;
+
+  if( FD_UNLIKELY( !shasync ) ) {
+    FD_LOG_WARNING(( "NULL shasync" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shasync, fd_log_async_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shasync" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( async->magic!=FD_LOG_ASYNC_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return async;
+}
+
+void *
+fd_log_async_leave( fd_log_async_t * async ) {
+
+  if( FD_UNLIKELY( !async ) ) {
+    FD_LOG_WARNING(( "NULL async" ));
+    return NULL;
+  }
+
+  return (void *)async;
+}
+
+void *
+fd_log_async_delete( void * shasync ) {
+  fd_log_async_t * async = (fd_log_async_t *)shasync;
+
+  if( FD_UNLIKELY( !shasync ) ) {
+    FD_LOG_WARNING(( "NULL shasync" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shasync, fd_log_async_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shasync" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( async->magic!=FD_LOG_ASYNC_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( async->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shasync;
+}
+
+int  fd_log_async_mode    ( fd_log_async_t const * async           ) { return FD_VOLATILE_CONST( async->mode ); }
+void fd_log_async_mode_set( fd_log_async_t *       async, int mode ) { FD_VOLATILE( async->mode ) = mode;       }
+
+ulong
+fd_log_async_drop_cnt( fd_log_async_t const * async ) {
+  ulong drop_cnt = 0UL;
+  for( ulong ring_idx=0UL; ring_idx<async->ring_cnt; ring_idx++ )
+    drop_cnt += FD_VOLATILE_CONST( fd_log_private_async_ring_laddr( async, ring_idx )->drop_cnt );
+  return drop_cnt;
+}
+
 void
-fd_log_private_1( int          level,
-                  long         now,
-                  char const * file,
-                  int          line,
-                  char const * func,
-                  char const * msg ) {
+fd_log_async_set( fd_log_async_t * async ) {
+  fd_log_async_t * prev = fd_log_private_async;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( fd_log_private_async ) = async;
+  FD_COMPILER_MFENCE();
+  if( prev ) fd_log_private_async_drain( prev, 1 );
+}
 
-  if( level<fd_log_level_logfile() ) return;
+fd_log_async_t * fd_log_async( void ) { return FD_VOLATILE_CONST( fd_log_private_async ); }
+
+ulong fd_log_async_drain( fd_log_async_t * async ) { return fd_log_private_async_drain( async, 0 ); }
+
+void
+fd_log_async_run( fd_log_async_t * async,
+                  long             lazy ) {
+  for(;;) {
+    int halt = FD_VOLATILE_CONST( async->halt ); /* Observe halt before the drain such that the final drain gets everything */
+    FD_COMPILER_MFENCE();
+    ulong msg_cnt = fd_log_private_async_drain( async, 1 );
+    if( FD_UNLIKELY( halt ) ) break;
+    if( !msg_cnt ) {
+      if( lazy>0L ) fd_log_sleep( lazy );
+      else          FD_SPIN_PAUSE();
+    }
+  }
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( async->halt ) = 0;
+  FD_COMPILER_MFENCE();
+}
+
+void
+fd_log_async_halt( fd_log_async_t * async ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( async->halt ) = 1;
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_log_private_msg writes a log message to the log streams (or, if
+   the calling thread is logging asynchronously, formats the message
+   for its async log ring).  Returns 1 if the message itself was
+   written and 0 if it was filtered or deduplicated. */
+
+static int
+fd_log_private_msg( int          level,
+                    long         now,
+                    char const * file,
+                    int          line,
+                    char const * func,
+                    char const * msg ) {
 
   /* These are thread init so we call them regardless of permanent log
      enabled to their initialization time is guaranteed independent of
@@ -610,7 +1005,7 @@ fd_log_private_1( int          level,
   FILE * log_file   = FD_VOLATILE_CONST( fd_log_private_file );
   int    to_logfile = (!!log_file);
   int    to_stderr  = (level>=fd_log_level_stderr());
-  if( !(to_logfile | to_stderr) ) return;
+  if( !(to_logfile | to_stderr) ) return 0;
 
   /* Deduplicate the log if requested */
 
@@ -647,14 +1042,14 @@ fd_log_private_1( int          level,
         char then_cstr[ FD_LOG_WALLCLOCK_CSTR_BUF_SZ ];
         fd_log_wallclock_cstr( then, then_cstr );
 
-        if( to_logfile ) fprintf( log_file, "SNIP    %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s "
+        if( to_logfile ) fd_log_private_fprintf( log_file, "SNIP    %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s "
                                   "stopped repeating (%lu identical messages)\n",
                                   then_cstr, fd_log_group_id(),tid, fd_log_user(),fd_log_host(),cpu,
                                   fd_log_app(),fd_log_group(),thread, dedup_cnt+1UL );
 
         if( to_stderr ) {
           char * then_short_cstr = then_cstr+5; then_short_cstr[21] = '\0'; /* Lop off the year, ns resolution and timezone */
-          fprintf( stderr, "SNIP    %s %-6lu %-4s %-4s stopped repeating (%lu identical messages)\n",
+          fd_log_private_fprintf( stderr, "SNIP    %s %-6lu %-4s %-4s stopped repeating (%lu identical messages)\n",
                            then_short_cstr, tid,cpu,thread, dedup_cnt+1UL );
         }
 
@@ -679,12 +1074,12 @@ fd_log_private_1( int          level,
       if( (now-dedup_last) >= dedup_throttle ) {
         char now_cstr[ FD_LOG_WALLCLOCK_CSTR_BUF_SZ ];
         fd_log_wallclock_cstr( now, now_cstr );
-        if( to_logfile ) fprintf( log_file, "SNIP    %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s repeating (%lu identical messages)\n",
+        if( to_logfile ) fd_log_private_fprintf( log_file, "SNIP    %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s repeating (%lu identical messages)\n",
                                   now_cstr, fd_log_group_id(),tid, fd_log_user(),fd_log_host(),cpu,
                                   fd_log_app(),fd_log_group(),thread, dedup_cnt+1UL );
         if( to_stderr ) {
           char * now_short_cstr = now_cstr+5; now_short_cstr[21] = '\0'; /* Lop off the year, ns resolution and timezone */
-          fprintf( stderr, "SNIP    %s %-6lu %-4s %-4s repeating (%lu identical messages)\n",
+          fd_log_private_fprintf( stderr, "SNIP    %s %-6lu %-4s %-4s repeating (%lu identical messages)\n",
                    now_short_cstr, tid,cpu,thread, dedup_cnt+1UL );
         }
         dedup_last = now;
@@ -695,7 +1090,7 @@ fd_log_private_1( int          level,
     last_hash = hash;
     then      = now;
 
-    if( in_dedup ) return;
+    if( in_dedup ) return 0;
   }
 
   char now_cstr[ FD_LOG_WALLCLOCK_CSTR_BUF_SZ ];
@@ -712,7 +1107,7 @@ fd_log_private_1( int          level,
     /* 7 */ "EMERG  "
   };
 
-  if( to_logfile ) fprintf( log_file, "%s %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s %s(%i)[%s]: %s\n",
+  if( to_logfile ) fd_log_private_fprintf( log_file, "%s %s %6lu:%-6lu %s:%s:%-4s %s:%s:%-4s %s(%i)[%s]: %s\n",
                             level_cstr[level], now_cstr, fd_log_group_id(),tid, fd_log_user(),fd_log_host(),cpu,
                             fd_log_app(),fd_log_group(),thread, file,line,func, msg );
 
@@ -728,12 +1123,38 @@ fd_log_private_1( int          level,
       /* 7 */ TEXT_RED TEXT_BOLD TEXT_UNDERLINE TEXT_BLINK "EMERG  " TEXT_NORMAL
     };
     char * now_short_cstr = now_cstr+5; now_short_cstr[21] = '\0'; /* Lop off the year, ns resolution and timezone */
-    fprintf( stderr, "%s %s %-6lu %-4s %-4s %s(%i): %s\n", fd_log_private_colorize ? color_level_cstr[level] : level_cstr[level],
+    fd_log_private_fprintf( stderr, "%s %s %-6lu %-4s %-4s %s(%i): %s\n", fd_log_private_colorize ? color_level_cstr[level] : level_cstr[level],
              now_short_cstr, tid,cpu,thread, file, line, msg );
   }
 
-  if( level<fd_log_level_flush() ) return;
+  return 1;
+}
+
+void
+fd_log_private_1( int          level,
+                  long         now,
+                  char const * file,
+                  int          line,
+                  char const * func,
+                  char const * msg ) {
+
+  if( level<fd_log_level_logfile() ) return;
+
+  fd_log_async_t *      async = FD_VOLATILE_CONST( fd_log_private_async );
+  fd_log_async_ring_t * ring  = FD_UNLIKELY( !!async ) ? fd_log_private_async_ring( async ) : NULL;
+
+  fd_log_private_async_out = !!ring;
+  int written = fd_log_private_msg( level, now, file, line, func, msg );
+  fd_log_private_async_out = 0;
+
+  if( FD_UNLIKELY( !!ring ) ) fd_log_private_async_push( async, ring, level>=fd_log_level_flush() );
 
+  if( (!written) | (level<fd_log_level_flush()) ) return;
+
+  /* Get this message (and any messages in the async rings that precede
+     it) out before resuming */
+
+  if( FD_UNLIKELY( !!async ) ) fd_log_private_async_drain( async, 1 );
   fd_log_flush();
 }
 
@@ -746,6 +1167,9 @@ fd_log_private_2( int          level,
                   char const * msg ) {
   fd_log_private_1( level, now, file, line, func, msg );
 
+  fd_log_async_t * async = FD_VOLATILE_CONST( fd_log_private_async );
+  if( async ) fd_log_private_async_drain( async, 1 );
+
   if( level<fd_log_level_core() ) exit(1); /* atexit will call fd_log_private_cleanup implicitly */
 
   abort();
@@ -775,6 +1199,12 @@ fd_log_private_cleanup( void ) {
      has completed cleanup. */
 
   FD_ONCE_BEGIN {
+    /* Get out any messages still in the async log rings (we don't wait
+       on a concurrent drain as we might be in a signal handler that
+       interrupted it) */
+    fd_log_async_t * async = FD_VOLATILE_CONST( fd_log_private_async );
+    if( async ) fd_log_private_async_drain( async, 0 );
+
     FILE * log_file = FD_VOLATILE_CONST( fd_log_private_file );
     if(      !log_file                           ) fprintf( stderr, "No log\n" );
     else if( !strcmp( fd_log_private_path, "-" ) ) fprintf( stderr, "Log to stdout\n" );
@@ -1180,6 +1610,7 @@ fd_log_private_halt( void ) {
 
   /* At this point, log is offline */
 
+  fd_log_private_async          = NULL;
   fd_log_private_path[0]        = '\0';
 /*fd_log_private_file           = NULL;*/ /* Already handled by cleanup */
   fd_log_private_dedup          = 0;
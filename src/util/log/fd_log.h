@@ -516,6 +516,146 @@ void fd_log_level_stderr_set ( int level );
 void fd_log_level_flush_set  ( int level );
 void fd_log_level_core_set   ( int level );
 
+/* ASYNC LOGGING APIS *************************************************/
+
+/* By default, log messages are written to the log file and stderr by
+   the thread that logs them (i.e. a FD_LOG_NOTICE on a latency critical
+   thread can stall that thread on stdio and disk I/O).  A fd_log_async_t
+   allows a thread group to instead log asynchronously.  It holds up to
+   ring_cnt single producer / single consumer rings of ring_sz bytes.
+   While async logging is enabled for a thread group (see
+   fd_log_async_set), each thread that logs claims its own ring the
+   first time it logs and formats its messages into that ring (lock
+   free, no syscalls).  Some thread (typically a dedicated log tile,
+   see fd_log_async_run) drains the rings to the log file / stderr.
+
+   The fd_log_async_t memory region is position independent such that
+   it can be placed in a shared memory workspace and used by multiple
+   thread groups concurrently (the messages will be written to the log
+   streams of the thread group draining them).
+
+   When a thread's ring does not have room for a message, the message
+   is dropped (FD_LOG_ASYNC_MODE_DROP, the ring's drop counter is
+   incremented and the drop is reported in the log when the ring is next
+   drained) or the thread waits for room (FD_LOG_ASYNC_MODE_BLOCK, the
+   thread will drain the rings itself while waiting so this cannot
+   deadlock if nobody else is draining).
+
+   Messages at or above fd_log_level_flush() (e.g. WARNING and above by
+   default) are still written out by the logging thread before it
+   resumes: they are never dropped (the thread waits for room as in
+   block mode), the thread drains all rings (preserving message
+   ordering) and then flushes the log.  Threads that log after all rings have been
+   claimed log synchronously. */
+
+#define FD_LOG_ASYNC_MODE_DROP  (0)
+#define FD_LOG_ASYNC_MODE_BLOCK (1)
+
+#define FD_LOG_ASYNC_RING_SZ_MIN (1UL<<17)
+#define FD_LOG_ASYNC_RING_SZ_MAX (1UL<<30)
+
+/* FD_LOG_ASYNC_{ALIGN,FOOTPRINT} give the alignment and footprint of a
+   memory region suitable for a fd_log_async_t with ring_cnt rings of
+   ring_sz bytes.  ALIGN is an integer power of 2.  FOOTPRINT is a
+   multiple of ALIGN.  ring_cnt and ring_sz are assumed valid (ring_cnt
+   positive and ring_sz a power of 2 in
+   [FD_LOG_ASYNC_RING_SZ_MIN,FD_LOG_ASYNC_RING_SZ_MAX]).  These are
+   provided to facilitate compile time declarations. */
+
+#define FD_LOG_ASYNC_ALIGN                       (128UL)
+#define FD_LOG_ASYNC_FOOTPRINT( ring_cnt, ring_sz ) (128UL + (ring_cnt)*(256UL+(ring_sz)))
+
+struct fd_log_async_private;
+typedef struct fd_log_async_private fd_log_async_t;
+
+/* fd_log_async_{align,footprint} return FD_LOG_ASYNC_{ALIGN,FOOTPRINT}.
+   footprint returns 0 if ring_cnt or ring_sz is invalid (silent). */
+
+FD_FN_CONST ulong
+fd_log_async_align( void );
+
+FD_FN_CONST ulong
+fd_log_async_footprint( ulong ring_cnt,
+                        ulong ring_sz );
+
+/* fd_log_async_new formats an unused memory region with the appropriate
+   alignment and footprint as a fd_log_async_t with ring_cnt rings of
+   ring_sz bytes and the given FD_LOG_ASYNC_MODE_* full ring policy.
+   Returns shmem on success and NULL on failure (logs details).
+   fd_log_async_join joins the caller to the fd_log_async_t (returns a
+   local handle on success and NULL on failure, logs details).
+   fd_log_async_leave leaves a current local join (returns the
+   underlying shared memory region).  fd_log_async_delete unformats the
+   memory region (returns it on success and NULL on failure, logs
+   details).  The fd_log_async_t should not be in use by any thread
+   group (fd_log_async_set) when deleted. */
+
+void *
+fd_log_async_new( void * shmem,
+                  ulong  ring_cnt,
+                  ulong  ring_sz,
+                  int    mode );
+
+fd_log_async_t *
+fd_log_async_join( void * shasync );
+
+void *
+fd_log_async_leave( fd_log_async_t * async );
+
+void *
+fd_log_async_delete( void * shasync );
+
+/* fd_log_async_mode returns the current full ring policy of async and
+   fd_log_async_mode_set changes it (takes effect on subsequent
+   messages). */
+
+int  fd_log_async_mode    ( fd_log_async_t const * async );
+void fd_log_async_mode_set( fd_log_async_t *       async, int mode );
+
+/* fd_log_async_drop_cnt returns the number of messages dropped by
+   async over its lifetime (summed over its rings). */
+
+ulong
+fd_log_async_drop_cnt( fd_log_async_t const * async );
+
+/* fd_log_async_set enables async logging for the caller's thread group
+   using the rings of the current local join async.  NULL disables async
+   logging (after draining the previous async's rings).  fd_log_async()
+   returns the fd_log_async_t currently in use by the caller's thread
+   group (NULL if logging synchronously).  Not thread safe (it is
+   typically done once by the booting thread before starting other
+   threads).  The join should remain valid until async logging is
+   disabled. */
+
+void
+fd_log_async_set( fd_log_async_t * async );
+
+fd_log_async_t *
+fd_log_async( void );
+
+/* fd_log_async_drain writes all the messages currently in async's rings
+   to the caller's log streams in ring order (messages from any one
+   thread are written in order).  Returns the number of messages
+   written.  If another thread is currently draining async, returns 0
+   immediately.  Can be called by any thread. */
+
+ulong
+fd_log_async_drain( fd_log_async_t * async );
+
+/* fd_log_async_run drains async until fd_log_async_halt( async ) is
+   called, doing a final drain before returning.  It is meant to be the
+   main loop of a dedicated log tile.  When there is nothing to drain,
+   the caller sleeps for ~lazy ns (<=0 indicates to spin instead).
+   fd_log_async_halt is typically called by the booting thread after
+   other threads have stopped logging. */
+
+void
+fd_log_async_run( fd_log_async_t * async,
+                  long             lazy );
+
+void
+fd_log_async_halt( fd_log_async_t * async );
+
 /* These functions are for fd_log internal use only. */
 
 char const *
@@ -11,6 +11,16 @@ backtrace_test( void ) {
 
 static char large_blob[ 50000 ];
 
+static uchar async_mem[ FD_LOG_ASYNC_FOOTPRINT( 2UL, FD_LOG_ASYNC_RING_SZ_MIN ) ] __attribute__((aligned(FD_LOG_ASYNC_ALIGN)));
+
+static int
+async_tile_main( int     argc,
+                 char ** argv ) {
+  (void)argc;
+  fd_log_async_run( (fd_log_async_t *)argv, 1000L );
+  return 0;
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -170,6 +180,96 @@ main( int     argc,
   FD_TEST( "\"\\\"" );
 # endif
 
+  FD_LOG_NOTICE(( "Testing async logging" ));
+
+  FD_TEST( fd_log_async_align()==FD_LOG_ASYNC_ALIGN );
+  FD_TEST( !fd_log_async_footprint( 0UL, FD_LOG_ASYNC_RING_SZ_MIN         ) );
+  FD_TEST( !fd_log_async_footprint( 1UL, FD_LOG_ASYNC_RING_SZ_MIN/2UL     ) );
+  FD_TEST( !fd_log_async_footprint( 1UL, FD_LOG_ASYNC_RING_SZ_MIN+8UL     ) );
+  FD_TEST( !fd_log_async_footprint( 1UL, FD_LOG_ASYNC_RING_SZ_MAX*2UL     ) );
+  FD_TEST( !fd_log_async_footprint( ULONG_MAX/4UL, FD_LOG_ASYNC_RING_SZ_MIN ) );
+  FD_TEST( fd_log_async_footprint( 2UL, FD_LOG_ASYNC_RING_SZ_MIN )==FD_LOG_ASYNC_FOOTPRINT( 2UL, FD_LOG_ASYNC_RING_SZ_MIN ) );
+  FD_TEST( fd_ulong_is_aligned( FD_LOG_ASYNC_FOOTPRINT( 2UL, FD_LOG_ASYNC_RING_SZ_MIN ), FD_LOG_ASYNC_ALIGN ) );
+
+  FD_TEST( !fd_log_async_new( NULL,         2UL, FD_LOG_ASYNC_RING_SZ_MIN,     FD_LOG_ASYNC_MODE_DROP ) ); /* NULL shmem */
+  FD_TEST( !fd_log_async_new( async_mem+1,  2UL, FD_LOG_ASYNC_RING_SZ_MIN,     FD_LOG_ASYNC_MODE_DROP ) ); /* misaligned */
+  FD_TEST( !fd_log_async_new( async_mem,    0UL, FD_LOG_ASYNC_RING_SZ_MIN,     FD_LOG_ASYNC_MODE_DROP ) ); /* bad ring_cnt */
+  FD_TEST( !fd_log_async_new( async_mem,    2UL, FD_LOG_ASYNC_RING_SZ_MIN+8UL, FD_LOG_ASYNC_MODE_DROP ) ); /* bad ring_sz */
+  FD_TEST( !fd_log_async_new( async_mem,    2UL, FD_LOG_ASYNC_RING_SZ_MIN,     -1                     ) ); /* bad mode */
+  FD_TEST( !fd_log_async_join( async_mem ) ); /* not formatted */
+
+  FD_TEST( fd_log_async_new( async_mem, 2UL, FD_LOG_ASYNC_RING_SZ_MIN, FD_LOG_ASYNC_MODE_DROP )==async_mem );
+  fd_log_async_t * async = fd_log_async_join( async_mem ); FD_TEST( async );
+  FD_TEST( fd_log_async_mode    ( async )==FD_LOG_ASYNC_MODE_DROP );
+  FD_TEST( fd_log_async_drop_cnt( async )==0UL );
+
+  FD_TEST( !fd_log_async() );
+  fd_log_async_set( async );
+  FD_TEST( fd_log_async()==async );
+
+  /* Messages below the flush level wait in the caller's ring until
+     drained.  (When there is no log file, INFO messages are not
+     written anywhere and so never make it into the ring.) */
+
+  for( ulong i=0UL; i<4UL; i++ ) FD_LOG_NOTICE(( "Test async NOTICE %lu (written by fd_log_async_drain)", i ));
+  FD_TEST( fd_log_async_drain( async )==4UL );
+  FD_TEST( fd_log_async_drain( async )==0UL );
+
+  /* In drop mode, messages that don't fit are dropped and counted */
+
+  ulong msg_cnt = 10000UL;
+  for( ulong i=0UL; i<msg_cnt; i++ ) FD_LOG_INFO(( "Test async INFO %lu (drop mode)", i ));
+  ulong drop_cnt  = fd_log_async_drop_cnt( async );
+  ulong drain_cnt = fd_log_async_drain( async );
+  FD_LOG_NOTICE(( "async drop mode: %lu drained, %lu dropped", drain_cnt, drop_cnt ));
+  FD_TEST( (drain_cnt+drop_cnt==msg_cnt) | ((!drain_cnt) & (!drop_cnt)) );
+
+  /* In drop mode, messages at the flush level are not dropped when the
+     ring is full (e.g. the FD_LOG_ERR explaining an exit) */
+
+  static char pad[ 1024 ];
+  memset( pad, 'x', 1023UL );
+  for( ulong i=0UL; (i<1000UL) & (fd_log_async_drop_cnt( async )==drop_cnt); i++ )
+    FD_LOG_NOTICE(( "Test async NOTICE %lu (filling drop mode ring) %s", i, pad ));
+  FD_TEST( fd_log_async_drop_cnt( async )>drop_cnt ); /* Ring is full */
+  drop_cnt = fd_log_async_drop_cnt( async );
+  FD_LOG_WARNING(( "Test async WARNING  (full drop mode ring, not dropped)" ));
+  FD_TEST( fd_log_async_drop_cnt( async )==drop_cnt );
+  FD_TEST( fd_log_async_drain( async )==0UL );
+
+  /* In block mode, the caller drains its ring itself when it is full */
+
+  fd_log_async_mode_set( async, FD_LOG_ASYNC_MODE_BLOCK );
+  FD_TEST( fd_log_async_mode( async )==FD_LOG_ASYNC_MODE_BLOCK );
+  for( ulong i=0UL; i<msg_cnt; i++ ) FD_LOG_INFO(( "Test async INFO %lu (block mode)", i ));
+  FD_TEST( fd_log_async_drop_cnt( async )==drop_cnt );
+  fd_log_async_drain( async );
+
+  /* Messages at the flush level are drained by the caller */
+
+  FD_LOG_WARNING(( "Test async WARNING  (drained and flushed by the caller)" ));
+  FD_TEST( fd_log_async_drain( async )==0UL );
+
+  /* Dedicated log tile */
+
+  if( fd_tile_cnt()>1UL ) {
+    fd_tile_exec_t * exec = fd_tile_exec_new( 1UL, async_tile_main, 0, (char **)fd_type_pun( async ) ); FD_TEST( exec );
+    for( ulong i=0UL; i<msg_cnt; i++ ) FD_LOG_INFO(( "Test async INFO %lu (log tile)", i ));
+    FD_LOG_NOTICE(( "Test async NOTICE (log tile)" ));
+    fd_log_async_halt( async );
+    int ret; FD_TEST( !fd_tile_exec_delete( exec, &ret ) ); FD_TEST( !ret );
+    FD_TEST( fd_log_async_drain( async )==0UL );
+    FD_TEST( fd_log_async_drop_cnt( async )==drop_cnt );
+  }
+
+  fd_log_async_set( NULL );
+  FD_TEST( !fd_log_async() );
+  FD_LOG_NOTICE(( "Test NOTICE after async logging disabled" ));
+
+  FD_TEST( fd_log_async_leave ( async     )==async_mem );
+  FD_TEST( fd_log_async_delete( async_mem )==async_mem );
+  FD_TEST( !fd_log_async_join ( async_mem ) );
+
   /* Cancelling log messages */
   if( !volatile_yes ) FD_LOG_ERR((     "Test ERR          (warning+exit program with error 1)"     ));
   if( !volatile_yes ) backtrace_test();
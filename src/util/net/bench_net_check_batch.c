@@ -0,0 +1,132 @@
+#include "../fd_util.h"
+#include "fd_udp.h"
+
+/* bench_net_check_batch compares the throughput of validating ip4
+   header checksums and ip4/udp checksums one packet at a time (with
+   fd_ip4_hdr_check / fd_ip4_udp_check) against validating them
+   FD_IP4_{HDR,UDP}_CHECK_BATCH_MAX packets at a time (with
+   fd_ip4_{hdr,udp}_check_batch) for a range of udp payload sizes.  The
+   packets are a --pkt-cnt ring of valid packets such that the working
+   set fits in cache (i.e. this measures the compute cost of validation,
+   not the cost of pulling packets into the core). */
+
+#if FD_HAS_HOSTED
+
+#define PKT_STRIDE (2048UL)
+
+static uchar pkt_mem[ 4096UL*PKT_STRIDE ] __attribute__((aligned(128)));
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong pkt_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-cnt",  NULL, 256UL     );
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 1UL<<22   );
+  ulong pkt_off  = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-off",  NULL, 14UL      );
+
+  if( FD_UNLIKELY( (!pkt_cnt) | (pkt_cnt>4096UL) | (pkt_cnt % FD_IP4_UDP_CHECK_BATCH_MAX) ) )
+    FD_LOG_ERR(( "--pkt-cnt should be a positive multiple of %lu and at most 4096", FD_IP4_UDP_CHECK_BATCH_MAX ));
+  if( FD_UNLIKELY( iter_cnt<pkt_cnt ) ) FD_LOG_ERR(( "--iter-cnt should be at least --pkt-cnt" ));
+  if( FD_UNLIKELY( pkt_off>64UL      ) ) FD_LOG_ERR(( "--pkt-off should be at most 64" ));
+
+  FD_LOG_NOTICE(( "Benchmarking (--pkt-cnt %lu --iter-cnt %lu --pkt-off %lu)", pkt_cnt, iter_cnt, pkt_off ));
+
+  static ulong const payload_sz[] = { 0UL, 64UL, 512UL, 1232UL, 1472UL };
+
+  fd_ip4_hdr_t const * ip4[ 4096 ];
+  fd_udp_hdr_t const * udp[ 4096 ];
+
+  for( ulong sz_idx=0UL; sz_idx<sizeof(payload_sz)/sizeof(ulong); sz_idx++ ) {
+    ulong sz = payload_sz[ sz_idx ];
+
+    /* Make pkt_cnt valid packets (ip4 headers are --pkt-off bytes into
+       each packet buffer, by default where they would be after an
+       ethernet header) */
+
+    for( ulong pkt_idx=0UL; pkt_idx<pkt_cnt; pkt_idx++ ) {
+      uchar * pkt = pkt_mem + pkt_idx*PKT_STRIDE + pkt_off;
+      for( ulong j=0UL; j<20UL+8UL+sz; j++ ) pkt[j] = fd_rng_uchar( rng );
+      fd_ip4_hdr_t * h = (fd_ip4_hdr_t *)pkt;
+      fd_udp_hdr_t * u = (fd_udp_hdr_t *)(pkt+20UL);
+      pkt[0]      = (uchar)0x45;
+      h->check    = (ushort)0;
+      h->check    = fd_ip4_hdr_check( h );
+      u->net_len  = fd_ushort_bswap( (ushort)(8UL+sz) );
+      u->check    = (ushort)0;
+      u->check    = fd_ip4_udp_check( h->saddr, h->daddr, u, u+1 );
+      if( !u->check ) u->check = (ushort)0xffff; /* (0 and 0xffff are equivalent in one's complement) */
+      ip4[ pkt_idx ] = h;
+      udp[ pkt_idx ] = u;
+    }
+
+    /* Warm up and validate */
+
+    for( ulong pkt_idx=0UL; pkt_idx<pkt_cnt; pkt_idx++ ) {
+      FD_TEST( !fd_ip4_hdr_check( ip4[ pkt_idx ] ) );
+      FD_TEST( !fd_ip4_udp_check( ip4[ pkt_idx ]->saddr, ip4[ pkt_idx ]->daddr, udp[ pkt_idx ], udp[ pkt_idx ]+1 ) );
+    }
+
+    ulong batch_max = FD_IP4_UDP_CHECK_BATCH_MAX;
+    int   full      = (int)((1UL<<batch_max)-1UL);
+
+    ulong ok;
+    long  dt;
+
+#   define REPORT(name) FD_LOG_NOTICE(( "%-9s payload %4lu: %7.3f Mpkt/s, %7.3f ns/pkt (valid %lu)", \
+                                        name, sz, 1e3*(double)iter_cnt/(double)dt, (double)dt/(double)iter_cnt, ok ))
+
+    ok = 0UL;
+    dt = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter++ ) ok += (ulong)!fd_ip4_hdr_check( ip4[ iter % pkt_cnt ] );
+    dt += fd_log_wallclock();
+    REPORT( "ip4" );
+
+    ok = 0UL;
+    dt = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter+=batch_max ) ok += batch_max*(ulong)(fd_ip4_hdr_check_batch( ip4 + (iter % pkt_cnt), batch_max )==full);
+    dt += fd_log_wallclock();
+    REPORT( "ip4 batch" );
+
+    ok = 0UL;
+    dt = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+      ulong pkt_idx = iter % pkt_cnt;
+      ok += (ulong)!fd_ip4_udp_check( ip4[ pkt_idx ]->saddr, ip4[ pkt_idx ]->daddr, udp[ pkt_idx ], udp[ pkt_idx ]+1 );
+    }
+    dt += fd_log_wallclock();
+    REPORT( "udp" );
+
+    ok = 0UL;
+    dt = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter+=batch_max ) {
+      ulong pkt_idx = iter % pkt_cnt;
+      ok += batch_max*(ulong)(fd_ip4_udp_check_batch( ip4 + pkt_idx, udp + pkt_idx, batch_max )==full);
+    }
+    dt += fd_log_wallclock();
+    REPORT( "udp batch" );
+
+#   undef REPORT
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -0,0 +1,169 @@
+#include "../fd_util.h"
+#include "fd_pcap.h"
+
+/* bench_pcap compares the throughput of iterating over a capture with
+   the stream iterator (fd_pcap_iter_next, fread'ing each packet into a
+   buffer) against the mapped iterator (fd_pcap_mem_iter_next), both
+   copying each packet once into a buffer (fd_pcap_pkt_to_eth, as
+   fd_replay_tile does into its dcache) and touching packets in place.
+
+   The capture is --in if given.  Otherwise, a synthetic capture of
+   --gen-sz bytes of --pkt-sz byte packets is written to --gen (and
+   removed when done).  Captures larger than memory measure the storage
+   path.  With --cold 1, the capture is evicted from the page cache
+   before each pass (the default measures warm passes after a warm up
+   pass). */
+
+#if FD_HAS_HOSTED
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static void
+evict( char const * path ) {
+  int fd = open( path, O_RDONLY );
+  if( FD_UNLIKELY( fd<0 ) ) FD_LOG_ERR(( "open failed" ));
+  (void)posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+  close( fd );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * in_path  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--in",       NULL, NULL                  );
+  char const * gen_path = fd_env_strip_cmdline_cstr ( &argc, &argv, "--gen",      NULL, "/tmp/bench_pcap.pcap" );
+  ulong        gen_sz   = fd_env_strip_cmdline_ulong( &argc, &argv, "--gen-sz",   NULL, 4UL<<30               );
+  ulong        pkt_sz   = fd_env_strip_cmdline_ulong( &argc, &argv, "--pkt-sz",   NULL, 1024UL                );
+  ulong        iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 3UL                   );
+  int          cold     = fd_env_strip_cmdline_int  ( &argc, &argv, "--cold",     NULL, 0                     );
+
+  if( FD_UNLIKELY( (pkt_sz<64UL) | (pkt_sz>1514UL) ) ) FD_LOG_ERR(( "--pkt-sz should be in [64,1514]" ));
+  if( FD_UNLIKELY( !iter_cnt ) ) FD_LOG_ERR(( "--iter-cnt should be positive" ));
+
+  char const * path = in_path;
+  if( !path ) {
+    FD_LOG_NOTICE(( "Generating --gen %s (--gen-sz %lu --pkt-sz %lu)", gen_path, gen_sz, pkt_sz ));
+    FILE * file = fopen( gen_path, "w" );
+    if( FD_UNLIKELY( !file ) ) FD_LOG_ERR(( "fopen failed" ));
+    FD_TEST( fd_pcap_fwrite_hdr( file )==1UL );
+    uchar hdr[ 14 ]; memset( hdr, 0, 14UL ); hdr[12] = (uchar)0x08;
+    uchar payload[ 1514 ];
+    for( ulong i=0UL; i<1514UL; i++ ) payload[i] = (uchar)i;
+    ulong rec_sz = 16UL + pkt_sz + 4UL;
+    for( ulong off=24UL; off+rec_sz<=gen_sz; off+=rec_sz )
+      FD_TEST( fd_pcap_fwrite_pkt( (long)off, hdr, 14UL, payload, pkt_sz-14UL, 0U, file )==1UL );
+    if( FD_UNLIKELY( fclose( file ) ) ) FD_LOG_ERR(( "fclose failed" ));
+    path = gen_path;
+  }
+
+  static uchar buf[ 65536 ] __attribute__((aligned(128)));
+
+  ulong ref_cnt = 0UL;
+
+# define REPORT(name) FD_LOG_NOTICE(( "%-10s pass %lu: %lu pkt %lu B %7.3f Mpkt/s %7.3f GB/s", \
+                                      name, iter, cnt, sz, 1e3*(double)cnt/(double)dt, (double)sz/(double)dt ))
+
+  for( ulong iter=0UL; iter<=iter_cnt; iter++ ) { /* iter 0 is a warm up pass (unless cold) */
+
+    ulong cnt;
+    ulong sz;
+    long  dt;
+
+    /* Stream iterator */
+
+    if( cold ) evict( path );
+    cnt = 0UL; sz = 0UL;
+    dt  = -fd_log_wallclock();
+    do {
+      FILE * file = fopen( path, "r" );
+      if( FD_UNLIKELY( !file ) ) FD_LOG_ERR(( "fopen failed" ));
+      fd_pcap_iter_t * it = fd_pcap_iter_new( file ); FD_TEST( it );
+      for(;;) {
+        long  ts;
+        ulong pkt_sz = fd_pcap_iter_next( it, buf, sizeof(buf), &ts );
+        if( FD_UNLIKELY( !pkt_sz ) ) break;
+        cnt++; sz += pkt_sz;
+      }
+      FD_TEST( !fclose( fd_pcap_iter_delete( it ) ) );
+    } while(0);
+    dt += fd_log_wallclock();
+    if( iter ) REPORT( "fread" );
+    ref_cnt = cnt;
+
+    /* Mapped iterator, one copy */
+
+    if( cold ) evict( path );
+    cnt = 0UL; sz = 0UL;
+    dt  = -fd_log_wallclock();
+    do {
+      ulong        map_sz;
+      void const * map = fd_pcap_map( path, &map_sz ); FD_TEST( map );
+      fd_pcap_mem_iter_t _it[1];
+      fd_pcap_mem_iter_t * it = fd_pcap_mem_iter_new( _it, map, map_sz ); FD_TEST( it );
+      for(;;) {
+        ulong         pkt_sz;
+        long          ts;
+        uchar const * pkt = fd_pcap_mem_iter_next( it, &pkt_sz, &ts );
+        if( FD_UNLIKELY( !pkt ) ) break;
+        if( FD_UNLIKELY( pkt_sz>sizeof(buf) ) ) FD_LOG_ERR(( "packet too large" ));
+        sz += fd_pcap_pkt_to_eth( buf, pkt, pkt_sz, fd_pcap_mem_iter_type( it ) );
+        cnt++;
+      }
+      fd_pcap_unmap( map, map_sz );
+    } while(0);
+    dt += fd_log_wallclock();
+    if( iter ) REPORT( "mmap copy" );
+    FD_TEST( cnt==ref_cnt );
+
+    /* Mapped iterator, in place (touches the first and last cache line
+       of each packet) */
+
+    if( cold ) evict( path );
+    cnt = 0UL; sz = 0UL;
+    ulong sum = 0UL;
+    dt  = -fd_log_wallclock();
+    do {
+      ulong        map_sz;
+      void const * map = fd_pcap_map( path, &map_sz ); FD_TEST( map );
+      fd_pcap_mem_iter_t _it[1];
+      fd_pcap_mem_iter_t * it = fd_pcap_mem_iter_new( _it, map, map_sz ); FD_TEST( it );
+      for(;;) {
+        ulong         pkt_sz;
+        long          ts;
+        uchar const * pkt = fd_pcap_mem_iter_next( it, &pkt_sz, &ts );
+        if( FD_UNLIKELY( !pkt ) ) break;
+        sum += (ulong)pkt[0] + (ulong)pkt[ pkt_sz-1UL ];
+        cnt++; sz += pkt_sz;
+      }
+      fd_pcap_unmap( map, map_sz );
+    } while(0);
+    dt += fd_log_wallclock();
+    if( iter ) REPORT( "mmap touch" );
+    FD_TEST( cnt==ref_cnt );
+    FD_COMPILER_FORGET( sum );
+  }
+
+# undef REPORT
+
+  if( !in_path ) FD_TEST( !unlink( gen_path ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
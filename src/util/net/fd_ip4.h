@@ -115,6 +115,24 @@ fd_ip4_hdr_check_fast( fd_ip4_hdr_t const * hdr ) {
   return (ushort)~c;
 }
 
+/* fd_ip4_hdr_check_batch validates the header checksums of a batch of
+   up to FD_IP4_HDR_CHECK_BATCH_MAX ip4 headers.  hdr[i] for i in
+   [0,cnt) points to the first byte of a memory region containing the
+   i-th ip4 header and any options that follow it.  Returns a bit mask
+   where bit i is set if the i-th header has a valid checksum (i.e.
+   fd_ip4_hdr_check(hdr[i])==0) and clear otherwise (bits at or above
+   cnt are clear).  On targets with AVX, the headers are checksummed in
+   parallel (gathering the same header word from all the headers in the
+   batch at a time, headers with options are handled).  This is meant
+   for ingress paths that need to validate headers at high packet rates
+   where the hardware does not do checksum offload. */
+
+#define FD_IP4_HDR_CHECK_BATCH_MAX (8UL)
+
+FD_FN_PURE int
+fd_ip4_hdr_check_batch( fd_ip4_hdr_t const * const * hdr,
+                        ulong                        cnt );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_util_net_fd_ip4_h */
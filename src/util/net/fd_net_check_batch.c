@@ -0,0 +1,214 @@
+#include "fd_udp.h"
+
+#if FD_HAS_AVX
+
+#include "../simd/fd_avx.h"
+
+/* fd_net_check_private_fold reduces the 4 64-bit one's complement
+   partial sums in c into 16-bit one's complement sums (same reduction
+   as fd_ip4_hdr_check) and returns a mask whose lanes are set where the
+   complemented sum is zero (i.e. the checksum is valid). */
+
+static inline wc_t
+fd_net_check_private_fold( wv_t c ) {
+  wv_t m = wv_bcast( 0xffffUL );
+  c = wv_add( wv_add( wv_shr( c, 32 ), wv_and( wv_shr( c, 16 ), m ) ), wv_and( c, m ) );
+  c = wv_add( wv_shr( c, 16 ), wv_and( c, m ) );
+  c = wv_add( c, wv_shr( c, 16 ) );
+  return wv_eq( wv_and( c, m ), m ); /* ~c 16-bit is zero */
+}
+
+/* fd_net_check_private_hdr4 sums the ip4 header words of the (up to) 4
+   headers whose addresses are in the lanes of p.  Returns a mask of
+   which headers have valid checksums. */
+
+static inline wc_t
+fd_net_check_private_hdr4( wv_t p ) {
+
+  /* Gather the first word of each header (with the ihl, a zero ihl
+     header sums to zero as per the scalar implementation). */
+
+  __m128i w   = _mm256_i64gather_epi32( (int const *)NULL, p, 1 );
+  __m128i ihl = _mm_and_si128( w, _mm_set1_epi32( 0xf ) );
+  wv_t    c   = _mm256_cvtepu32_epi64( _mm_andnot_si128( _mm_cmpeq_epi32( ihl, _mm_setzero_si128() ), w ) );
+
+  /* Gather the remaining words of each header (masked off for lanes
+     whose headers are shorter such that we read exactly what the
+     scalar implementation would).  The first 5 words are almost always
+     the whole header. */
+
+  int ihl_max = _mm_extract_epi32( ihl, 0 );
+  ihl_max = fd_int_max( ihl_max, _mm_extract_epi32( ihl, 1 ) );
+  ihl_max = fd_int_max( ihl_max, _mm_extract_epi32( ihl, 2 ) );
+  ihl_max = fd_int_max( ihl_max, _mm_extract_epi32( ihl, 3 ) );
+
+  for( int i=1; i<ihl_max; i++ ) {
+    wv_t    q = wv_add( p, wv_bcast( 4UL*(ulong)i ) );
+    __m128i k = _mm_cmpgt_epi32( ihl, _mm_set1_epi32( i ) );
+    w = _mm256_mask_i64gather_epi32( _mm_setzero_si128(), (int const *)NULL, q, k, 1 );
+    c = wv_add( c, _mm256_cvtepu32_epi64( w ) );
+  }
+
+  return fd_net_check_private_fold( c );
+}
+
+int
+fd_ip4_hdr_check_batch( fd_ip4_hdr_t const * const * hdr,
+                        ulong                        cnt ) {
+  if( FD_UNLIKELY( !cnt ) ) return 0;
+
+  /* Pad the batch with copies of the first header so all lanes point to
+     valid memory.  The padding lanes are masked off below. */
+
+  ulong p[ FD_IP4_HDR_CHECK_BATCH_MAX ] __attribute__((aligned(32)));
+  for( ulong i=0UL; i<FD_IP4_HDR_CHECK_BATCH_MAX; i++ ) p[i] = (ulong)hdr[ fd_ulong_if( i<cnt, i, 0UL ) ];
+
+  /* (The lane masks are 4 wide 64-bit lanes) */
+  int mask = _mm256_movemask_pd( _mm256_castsi256_pd( fd_net_check_private_hdr4( wv_ld( p   ) ) ) ) |
+            (_mm256_movemask_pd( _mm256_castsi256_pd( fd_net_check_private_hdr4( wv_ld( p+4 ) ) ) ) << 4);
+  return mask & (int)((1UL<<cnt)-1UL);
+}
+
+/* fd_net_check_private_udp_payload returns a 64-bit one's complement
+   partial sum of the sz bytes of the udp payload at dgram (as 16-bit
+   words in memory order).  Assumes it is safe to read up to 3 bytes
+   past the end.
+
+   Payloads in packet buffers are usually only 2 byte aligned (e.g. 42
+   bytes after the start of an ethernet frame) such that half of the 32
+   byte loads below would straddle cache lines.  So, for all but small
+   payloads, the first load is of the 32 byte aligned block containing
+   the start of the payload with the bytes before the payload zeroed
+   (these bytes are in the same aligned block as the payload so reading
+   them is safe) and the remaining loads are aligned.  If the payload
+   starts at an odd address, the aligned loads are off by one byte from
+   the payload's 16-bit word grid.  Per RFC 1071, this just byte swaps
+   their one's complement sum. */
+
+static inline ulong
+fd_net_check_private_udp_payload( uchar const * dgram,
+                                  ulong         sz ) {
+
+  /* Sum the 16-bit halves of each 32-bit word into 32-bit lanes.  Each
+     load adds at most 2*(2^16-1) per lane so lanes can't overflow for
+     payloads smaller than 1 MiB (udp datagrams are less than 64 KiB). */
+
+  wu_t m  = wu_bcast( 0xffffU );
+  wu_t a0 = wu_zero();
+  wu_t a1 = wu_zero();
+
+  uchar const * p    = dgram;
+  ulong         off  = (ulong)dgram & 31UL;
+  int           swap = 0;
+  if( FD_LIKELY( (sz>=256UL) & (!!off) ) ) {
+    __m256i iota = _mm256_setr_epi8(  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+                                     16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 );
+    p -= off;
+    wu_t x = wu_and( wu_ld( (uint const *)p ), _mm256_cmpgt_epi8( iota, _mm256_set1_epi8( (char)(off-1UL) ) ) );
+    a0   = wu_add( wu_and( x, m ), wu_shr( x, 16 ) );
+    p   += 32UL;
+    sz  -= 32UL - off;
+    swap = (int)(off & 1UL);
+  }
+
+  for( ; sz>=64UL; sz-=64UL, p+=64UL ) {
+    wu_t x0 = wu_ldu( (uint const *) p        );
+    wu_t x1 = wu_ldu( (uint const *)(p+32UL) );
+    a0 = wu_add( a0, wu_add( wu_and( x0, m ), wu_shr( x0, 16 ) ) );
+    a1 = wu_add( a1, wu_add( wu_and( x1, m ), wu_shr( x1, 16 ) ) );
+  }
+
+  if( sz>=32UL ) {
+    wu_t x0 = wu_ldu( (uint const *)p );
+    a0 = wu_add( a0, wu_add( wu_and( x0, m ), wu_shr( x0, 16 ) ) );
+    sz -= 32UL; p += 32UL;
+  }
+
+  /* Sum the remaining whole words with a masked load (masked lanes are
+     not read so this won't read past the end) and then the last partial
+     word (as in fd_ip4_udp_check, this reads up to 3 bytes past the
+     end). */
+
+  ulong word_cnt = sz >> 2;
+  wc_t  k        = wi_lt( wi( 0, 1, 2, 3, 4, 5, 6, 7 ), wi_bcast( (int)word_cnt ) );
+  wu_t  x        = wu_ldif( k, (int const *)p );
+  a1 = wu_add( a1, wu_add( wu_and( x, m ), wu_shr( x, 16 ) ) );
+
+  a0 = wu_add( a0, a1 );
+  ulong c = wv_extract( wv_sum_all( wv_add( wu_to_wv( a0, 0 ), wu_to_wv( a0, 1 ) ) ), 0 );
+
+  ulong rem = sz & 3UL;
+  if( rem ) c += (ulong)( FD_LOAD( uint, p + 4UL*word_cnt ) & ((1U<<(8U*(uint)rem))-1U) );
+
+  if( FD_UNLIKELY( swap ) ) {
+    c = ( c>>32            ) +
+        ((c>>16) & 0xffffUL) +
+        ( c      & 0xffffUL);
+    c = ( c>>16            ) +
+        ( c      & 0xffffUL);
+    c = ( c>>16            ) +
+        ( c      & 0xffffUL);
+    c = (ulong)fd_ushort_bswap( (ushort)c );
+  }
+
+  return c;
+}
+
+int
+fd_ip4_udp_check_batch( fd_ip4_hdr_t const * const * ip4,
+                        fd_udp_hdr_t const * const * udp,
+                        ulong                        cnt ) {
+  int mask = 0;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_udp_hdr_t const * u = udp[i];
+    if( FD_UNLIKELY( !u->check ) ) { mask |= 1<<i; continue; } /* No checksum */
+
+    ushort net_len = u->net_len;
+    ulong  len     = (ulong)fd_ushort_bswap( net_len );
+    if( FD_UNLIKELY( len<sizeof(fd_udp_hdr_t) ) ) continue; /* Corrupt length */
+    ulong  sz      = len - sizeof(fd_udp_hdr_t);
+
+    ulong c = ((((ulong)FD_IP4_HDR_PROTOCOL_UDP)<<8) | (((ulong)net_len)<<16))
+            + ((ulong)ip4[i]->saddr)
+            + ((ulong)ip4[i]->daddr)
+            + ((ulong)u->u[0])
+            + ((ulong)u->u[1])
+            + fd_net_check_private_udp_payload( (uchar const *)(u+1), sz );
+
+    c  = ( c>>32            ) +
+         ((c>>16) & 0xffffUL) +
+         ( c      & 0xffffUL);
+    c  = ( c>>16            ) +
+         ( c      & 0xffffUL);
+    c += ( c>>16            );
+
+    mask |= ((int)!(ushort)~c) << i;
+  }
+  return mask;
+}
+
+#else /* Portable implementation */
+
+int
+fd_ip4_hdr_check_batch( fd_ip4_hdr_t const * const * hdr,
+                        ulong                        cnt ) {
+  int mask = 0;
+  for( ulong i=0UL; i<cnt; i++ ) mask |= ((int)!fd_ip4_hdr_check( hdr[i] )) << i;
+  return mask;
+}
+
+int
+fd_ip4_udp_check_batch( fd_ip4_hdr_t const * const * ip4,
+                        fd_udp_hdr_t const * const * udp,
+                        ulong                        cnt ) {
+  int mask = 0;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_udp_hdr_t const * u = udp[i];
+    if( FD_UNLIKELY( !u->check ) ) { mask |= 1<<i; continue; } /* No checksum */
+    if( FD_UNLIKELY( (ulong)fd_ushort_bswap( u->net_len )<sizeof(fd_udp_hdr_t) ) ) continue; /* Corrupt length */
+    mask |= ((int)!fd_ip4_udp_check( ip4[i]->saddr, ip4[i]->daddr, u, u+1 )) << i;
+  }
+  return mask;
+}
+
+#endif
@@ -1,9 +1,17 @@
+/* fd_pcap_map uses MADV_HUGEPAGE which requires _GNU_SOURCE */
+#define _GNU_SOURCE
+
 #include "fd_pcap.h"
 
 #if FD_HAS_HOSTED
 
 #include <stdio.h>
 #include <errno.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define FD_PCAP_HDR_NETWORK_ETHERNET  (1U)
 #define FD_PCAP_HDR_NETWORK_LINUX_SLL (113U)
@@ -37,6 +45,25 @@ typedef struct {
   ushort net_type;
 } fd_pcap_sll_hdr_t;
 
+/* fd_pcap_sll_to_eth writes into hdr an ethernet compatible header
+   that encodes the cooked sll header info in a reasonable way */
+
+static void
+fd_pcap_sll_to_eth( fd_eth_hdr_t *            hdr,
+                    fd_pcap_sll_hdr_t const * sll ) {
+  hdr->dst[0] = (uchar)(sll->dir    ); hdr->dst[1] = (uchar)(sll->dir     >> 8);
+  hdr->dst[2] = (uchar)(sll->ha_type); hdr->dst[3] = (uchar)(sll->ha_type >> 8);
+  hdr->dst[4] = (uchar)(sll->ha_len ); hdr->dst[5] = (uchar)(sll->ha_len  >> 8);
+  hdr->src[0] = sll->ha[0];            hdr->src[1] = sll->ha[1];
+  hdr->src[2] = sll->ha[2];            hdr->src[3] = sll->ha[3];
+  hdr->src[4] = sll->ha[4];            hdr->src[5] = sll->ha[5];
+  hdr->net_type = sll->net_type;
+
+  hdr->dst[0] = (uchar)(((ulong)hdr->dst[0] & ~3UL) | 2UL); /* Mark as a local admin unicast MAC */
+  hdr->src[0] = (uchar)(((ulong)hdr->src[0] & ~3UL) | 2UL); /* " */
+  /* FIXME: ENCODE LOST BITS TOO? */
+}
+
 fd_pcap_iter_t *
 fd_pcap_iter_new( void * _file ) {
   FILE * file = (FILE *)_file;
@@ -64,7 +91,7 @@ fd_pcap_iter_new( void * _file ) {
   }
 
   if( FD_UNLIKELY( !( (pcap->network==FD_PCAP_HDR_NETWORK_ETHERNET ) |
-                      (pcap->network!=FD_PCAP_HDR_NETWORK_LINUX_SLL) ) ) ) {
+                      (pcap->network==FD_PCAP_HDR_NETWORK_LINUX_SLL) ) ) ) {
     FD_LOG_WARNING(( "unsupported network type (neither an Ethernet nor a cooked socket pcap)" ));
     return NULL;
   }
@@ -117,20 +144,7 @@ fd_pcap_iter_next( fd_pcap_iter_t * iter,
       return 0UL;
     }
 
-    /* Construct an ethernet compatible header that encodes the sll
-       header info in a reasonable way */
-
-    hdr->dst[0] = (uchar)(sll->dir    ); hdr->dst[1] = (uchar)(sll->dir     >> 8);
-    hdr->dst[2] = (uchar)(sll->ha_type); hdr->dst[3] = (uchar)(sll->ha_type >> 8);
-    hdr->dst[4] = (uchar)(sll->ha_len ); hdr->dst[5] = (uchar)(sll->ha_len  >> 8);
-    hdr->src[0] = sll->ha[0];            hdr->src[1] = sll->ha[1];
-    hdr->src[2] = sll->ha[2];            hdr->src[3] = sll->ha[3];
-    hdr->src[4] = sll->ha[4];            hdr->src[5] = sll->ha[5];
-    hdr->net_type = sll->net_type;
-
-    hdr->dst[0] = (uchar)(((ulong)hdr->dst[0] & ~3UL) | 2UL); /* Mark as a local admin unicast MAC */
-    hdr->src[0] = (uchar)(((ulong)hdr->src[0] & ~3UL) | 2UL); /* " */
-    /* FIXME: ENCODE LOST BITS TOO? */
+    fd_pcap_sll_to_eth( hdr, sll );
 
     pkt_sz -= sizeof(fd_pcap_sll_hdr_t);
     pkt_sz += sizeof(fd_eth_hdr_t);
@@ -154,6 +168,449 @@ fd_pcap_iter_next( fd_pcap_iter_t * iter,
   return pkt_sz;
 }
 
+void const *
+fd_pcap_map( char const * path,
+             ulong *      _sz ) {
+
+  if( FD_UNLIKELY( !path ) ) { FD_LOG_WARNING(( "NULL path" )); return NULL; }
+  if( FD_UNLIKELY( !_sz  ) ) { FD_LOG_WARNING(( "NULL _sz"  )); return NULL; }
+
+  int fd = open( path, O_RDONLY );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "open(\"%s\") failed (%i-%s)", path, errno, strerror( errno ) ));
+    return NULL;
+  }
+
+  struct stat st[1];
+  if( FD_UNLIKELY( fstat( fd, st ) ) ) {
+    FD_LOG_WARNING(( "fstat(\"%s\") failed (%i-%s)", path, errno, strerror( errno ) ));
+    close( fd );
+    return NULL;
+  }
+
+  ulong sz = (ulong)st->st_size;
+  if( FD_UNLIKELY( !sz ) ) {
+    FD_LOG_WARNING(( "\"%s\" is empty", path ));
+    close( fd );
+    return NULL;
+  }
+
+  /* Double the file's readahead window (the mapping below holds its own
+     reference to the file so the fd can be closed right away). */
+
+  (void)posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+  void * mem = mmap( NULL, sz, PROT_READ, MAP_PRIVATE, fd, 0 );
+  int    err = errno;
+  if( FD_UNLIKELY( close( fd ) ) ) FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue",
+                                                    path, errno, strerror( errno ) ));
+  if( FD_UNLIKELY( mem==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(\"%s\",%lu KiB) failed (%i-%s)", path, sz>>10, err, strerror( err ) ));
+    return NULL;
+  }
+
+  /* Captures are read front to back, typically once.  MADV_SEQUENTIAL
+     makes page faults read ahead aggressively and lets the kernel drop
+     pages behind the iterator.  MADV_HUGEPAGE is best effort (only some
+     filesystems / kernels back file mappings with huge pages). */
+
+  if( FD_UNLIKELY( madvise( mem, sz, MADV_SEQUENTIAL ) ) )
+    FD_LOG_WARNING(( "madvise(\"%s\",MADV_SEQUENTIAL) failed (%i-%s); attempting to continue", path, errno, strerror( errno ) ));
+# ifdef MADV_HUGEPAGE
+  (void)madvise( mem, sz, MADV_HUGEPAGE );
+# endif
+
+  *_sz = sz;
+  return mem;
+}
+
+void
+fd_pcap_unmap( void const * mem,
+               ulong        sz ) {
+  if( FD_UNLIKELY( !mem ) ) { FD_LOG_WARNING(( "NULL mem" )); return; }
+  if( FD_UNLIKELY( munmap( (void *)mem, sz ) ) )
+    FD_LOG_WARNING(( "munmap(%lu KiB) failed (%i-%s)", sz>>10, errno, strerror( errno ) ));
+}
+
+/* pcapng block types and options used by fd_pcap_mem_iter */
+
+#define FD_PCAPNG_BLOCK_TYPE_SHB (0x0a0d0d0aU) /* Section header */
+#define FD_PCAPNG_BLOCK_TYPE_IDB (0x00000001U) /* Interface description */
+#define FD_PCAPNG_BLOCK_TYPE_SPB (0x00000003U) /* Simple packet */
+#define FD_PCAPNG_BLOCK_TYPE_EPB (0x00000006U) /* Enhanced packet */
+#define FD_PCAPNG_BYTE_ORDER     (0x1a2b3c4dU)
+
+#define FD_PCAPNG_OPT_END         ( 0U)
+#define FD_PCAPNG_OPT_IF_TSRESOL  ( 9U)
+#define FD_PCAPNG_OPT_IF_TSOFFSET (14U)
+
+#define FD_PCAPNG_TSRESOL_DEFAULT (6U) /* microseconds */
+
+static inline uint
+fd_pcap_mem_iter_u16( fd_pcap_mem_iter_t const * iter,
+                      uchar const *              p ) {
+  ushort x = fd_ushort_load_2( p );
+  return (uint)( iter->swap ? fd_ushort_bswap( x ) : x );
+}
+
+static inline uint
+fd_pcap_mem_iter_u32( fd_pcap_mem_iter_t const * iter,
+                      uchar const *              p ) {
+  uint x = fd_uint_load_4( p );
+  return iter->swap ? fd_uint_bswap( x ) : x;
+}
+
+static inline ulong
+fd_pcap_mem_iter_u64( fd_pcap_mem_iter_t const * iter,
+                      uchar const *              p ) {
+  ulong x = fd_ulong_load_8( p );
+  return iter->swap ? fd_ulong_bswap( x ) : x;
+}
+
+/* fd_pcap_link_type returns the FD_PCAP_ITER_TYPE_* of a pcap / pcapng
+   link type and ULONG_MAX if not supported. */
+
+static inline ulong
+fd_pcap_link_type( uint link_type ) {
+  switch( link_type & 0xffffU ) { /* Upper bits have FCS info */
+  case FD_PCAP_HDR_NETWORK_ETHERNET:  return FD_PCAP_ITER_TYPE_ETHERNET;
+  case FD_PCAP_HDR_NETWORK_LINUX_SLL: return FD_PCAP_ITER_TYPE_COOKED;
+  default: break;
+  }
+  return ULONG_MAX;
+}
+
+/* fd_pcapng_ts_to_ns converts a pcapng timestamp in units of if_tsresol
+   tsresol to ns. */
+
+static long
+fd_pcapng_ts_to_ns( ulong ts,
+                    uint  tsresol ) {
+  static ulong const pow10[ 20 ] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL,
+    10000000000UL, 100000000000UL, 1000000000000UL, 10000000000000UL, 100000000000000UL, 1000000000000000UL,
+    10000000000000000UL, 100000000000000000UL, 1000000000000000000UL, 10000000000000000000UL
+  };
+
+  uint v = tsresol & 0x7fU;
+  if( FD_LIKELY( !(tsresol & 0x80U) ) ) { /* units of 10^-v s */
+    if( v<=9U       ) return (long)( ts*pow10[ 9U-v ] );
+    if( v-9U>=20U   ) return 0L;
+    return (long)( ts/pow10[ v-9U ] );
+  }
+
+  /* units of 2^-v s.  Drop resolution below 2^-30 s (~1 ns) such that
+     the sub-second part can be scaled to ns without overflow. */
+  if( v>30U ) {
+    ts = (v-30U)<64U ? ts>>(v-30U) : 0UL;
+    v  = 30U;
+  }
+  ulong sec  = ts >> v;
+  ulong frac = ts & ((1UL<<v)-1UL);
+  return (long)( sec*1000000000UL + ((frac*1000000000UL)>>v) );
+}
+
+fd_pcap_mem_iter_t *
+fd_pcap_mem_iter_new( void *       _iter,
+                      void const * mem,
+                      ulong        sz ) {
+  fd_pcap_mem_iter_t * iter = (fd_pcap_mem_iter_t *)_iter;
+
+  if( FD_UNLIKELY( !iter ) ) { FD_LOG_WARNING(( "NULL iter" )); return NULL; }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)iter, alignof(fd_pcap_mem_iter_t) ) ) ) {
+    FD_LOG_WARNING(( "misaligned iter" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !mem ) ) { FD_LOG_WARNING(( "NULL mem" )); return NULL; }
+
+  iter->mem       = (uchar const *)mem;
+  iter->sz        = sz;
+  iter->ts        = 0L;
+  iter->iface_cnt = 0UL;
+
+  if( FD_UNLIKELY( sz<sizeof(uint) ) ) { FD_LOG_WARNING(( "capture too small" )); return NULL; }
+  uint magic = fd_uint_load_4( mem );
+
+  if( magic==FD_PCAPNG_BLOCK_TYPE_SHB ) {
+
+    /* Sections set their own byte order and interfaces as they are
+       encountered.  The first block must be a well formed SHB. */
+
+    if( FD_UNLIKELY( sz<28UL ) ) { FD_LOG_WARNING(( "pcapng section header truncated" )); return NULL; }
+    uint bom = fd_uint_load_4( iter->mem + 8UL );
+    if( FD_UNLIKELY( !((bom==FD_PCAPNG_BYTE_ORDER) | (bom==fd_uint_bswap( FD_PCAPNG_BYTE_ORDER ))) ) ) {
+      FD_LOG_WARNING(( "not a supported pcapng capture (bad byte order magic)" ));
+      return NULL;
+    }
+
+    iter->pcapng = 1;
+    iter->swap   = bom!=FD_PCAPNG_BYTE_ORDER;
+    iter->type   = FD_PCAP_ITER_TYPE_ETHERNET; /* Packets set their own type */
+    iter->ts_mul = 0L;                         /* Unused */
+    iter->off0   = 0UL;
+    iter->off    = 0UL;
+    return iter;
+  }
+
+  int  swap;
+  long ts_mul;
+  switch( magic ) {
+  case 0xa1b2c3d4U: swap = 0; ts_mul = 1000L; break;
+  case 0xa1b23c4dU: swap = 0; ts_mul =    1L; break;
+  case 0xd4c3b2a1U: swap = 1; ts_mul = 1000L; break;
+  case 0x4d3cb2a1U: swap = 1; ts_mul =    1L; break;
+  default:
+    FD_LOG_WARNING(( "not a supported pcap capture (bad magic number)" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( sz<sizeof(fd_pcap_hdr_t) ) ) { FD_LOG_WARNING(( "pcap header truncated" )); return NULL; }
+
+  iter->pcapng = 0;
+  iter->swap   = swap;
+  iter->ts_mul = ts_mul;
+
+  ulong type = fd_pcap_link_type( fd_pcap_mem_iter_u32( iter, iter->mem + offsetof( fd_pcap_hdr_t, network ) ) );
+  if( FD_UNLIKELY( type==ULONG_MAX ) ) {
+    FD_LOG_WARNING(( "unsupported network type (neither an Ethernet nor a cooked socket pcap)" ));
+    return NULL;
+  }
+
+  iter->type = type;
+  iter->off0 = sizeof(fd_pcap_hdr_t);
+  iter->off  = sizeof(fd_pcap_hdr_t);
+  return iter;
+}
+
+/* fd_pcap_mem_iter_pkt validates a pkt_sz (captured) / orig_sz
+   (original) byte packet of type type.  Returns 1 if valid and 0 if
+   not (logs details). */
+
+static inline int
+fd_pcap_mem_iter_pkt( ulong pkt_sz,
+                      ulong orig_sz,
+                      ulong type ) {
+  if( FD_UNLIKELY( pkt_sz!=orig_sz ) ) {
+    FD_LOG_WARNING(( "Read a truncated packet (%lu bytes to %lu bytes), run tcpdump with '-s0' option to capture everything",
+                     pkt_sz, orig_sz ));
+    return 0;
+  }
+  ulong hdr_sz = fd_ulong_if( type==FD_PCAP_ITER_TYPE_COOKED, sizeof(fd_pcap_sll_hdr_t), sizeof(fd_eth_hdr_t) );
+  if( FD_UNLIKELY( pkt_sz<hdr_sz ) ) {
+    FD_LOG_WARNING(( "Corrupt packet length %lu in capture", pkt_sz ));
+    return 0;
+  }
+  return 1;
+}
+
+uchar const *
+fd_pcap_mem_iter_next( fd_pcap_mem_iter_t * iter,
+                       ulong *              _pkt_sz,
+                       long *               _pkt_ts ) {
+  uchar const * mem = iter->mem;
+  ulong         sz  = iter->sz;
+  ulong         off = iter->off;
+
+  if( FD_LIKELY( !iter->pcapng ) ) {
+
+    if( FD_UNLIKELY( off>=sz ) ) return NULL; /* Normal end-of-capture */
+
+    if( FD_UNLIKELY( (sz-off)<sizeof(fd_pcap_pkt_hdr_t) ) ) {
+      FD_LOG_WARNING(( "Could not read link header from pcap (truncated pcap?)" ));
+      goto fail;
+    }
+
+    uchar const * hdr     = mem + off;
+    ulong         sec     = (ulong)fd_pcap_mem_iter_u32( iter, hdr + offsetof( fd_pcap_pkt_hdr_t, sec      ) );
+    ulong         subsec  = (ulong)fd_pcap_mem_iter_u32( iter, hdr + offsetof( fd_pcap_pkt_hdr_t, usec     ) );
+    ulong         pkt_sz  = (ulong)fd_pcap_mem_iter_u32( iter, hdr + offsetof( fd_pcap_pkt_hdr_t, incl_len ) );
+    ulong         orig_sz = (ulong)fd_pcap_mem_iter_u32( iter, hdr + offsetof( fd_pcap_pkt_hdr_t, orig_len ) );
+    off += sizeof(fd_pcap_pkt_hdr_t);
+
+    if( FD_UNLIKELY( !fd_pcap_mem_iter_pkt( pkt_sz, orig_sz, iter->type ) ) ) goto fail;
+    if( FD_UNLIKELY( pkt_sz>(sz-off) ) ) {
+      FD_LOG_WARNING(( "packet payload read failed (truncated pcap file?)" ));
+      goto fail;
+    }
+
+    iter->off = off + pkt_sz;
+    iter->ts  = (long)subsec*iter->ts_mul + 1000000000L*(long)sec;
+    *_pkt_sz  = pkt_sz;
+    *_pkt_ts  = iter->ts;
+    return mem + off;
+  }
+
+  for(;;) {
+
+    if( FD_UNLIKELY( off>=sz ) ) return NULL; /* Normal end-of-capture */
+
+    if( FD_UNLIKELY( (sz-off)<12UL ) ) {
+      FD_LOG_WARNING(( "pcapng block header truncated" ));
+      goto fail;
+    }
+
+    uchar const * blk      = mem + off;
+    uint          blk_type = fd_uint_load_4( blk ); /* Byte order independent for the SHB */
+
+    if( FD_UNLIKELY( blk_type==FD_PCAPNG_BLOCK_TYPE_SHB ) ) {
+
+      /* New section: pick up its byte order and forget the interfaces
+         of the previous section */
+
+      uint bom = fd_uint_load_4( blk + 8UL );
+      if( FD_UNLIKELY( !((bom==FD_PCAPNG_BYTE_ORDER) | (bom==fd_uint_bswap( FD_PCAPNG_BYTE_ORDER ))) ) ) {
+        FD_LOG_WARNING(( "pcapng section header has a bad byte order magic" ));
+        goto fail;
+      }
+      iter->swap      = bom!=FD_PCAPNG_BYTE_ORDER;
+      iter->iface_cnt = 0UL;
+
+    } else {
+
+      blk_type = fd_pcap_mem_iter_u32( iter, blk );
+
+    }
+
+    ulong blk_sz = (ulong)fd_pcap_mem_iter_u32( iter, blk + 4UL );
+    if( FD_UNLIKELY( (blk_sz<12UL) | (!fd_ulong_is_aligned( blk_sz, 4UL )) | (blk_sz>(sz-off)) ) ) {
+      FD_LOG_WARNING(( "pcapng block has a corrupt length %lu (truncated pcapng file?)", blk_sz ));
+      goto fail;
+    }
+    if( FD_UNLIKELY( fd_pcap_mem_iter_u32( iter, blk + blk_sz - 4UL )!=(uint)blk_sz ) ) {
+      FD_LOG_WARNING(( "pcapng block trailing length does not match" ));
+      goto fail;
+    }
+    off += blk_sz;
+
+    switch( blk_type ) {
+
+    case FD_PCAPNG_BLOCK_TYPE_SHB: {
+      if( FD_UNLIKELY( blk_sz<28UL ) ) { FD_LOG_WARNING(( "pcapng section header truncated" )); goto fail; }
+      uint major = fd_pcap_mem_iter_u16( iter, blk + 12UL );
+      if( FD_UNLIKELY( major!=1U ) ) { FD_LOG_WARNING(( "unsupported pcapng major version %u", major )); goto fail; }
+      break;
+    }
+
+    case FD_PCAPNG_BLOCK_TYPE_IDB: {
+      if( FD_UNLIKELY( blk_sz<20UL ) ) { FD_LOG_WARNING(( "pcapng interface description truncated" )); goto fail; }
+      if( FD_UNLIKELY( iter->iface_cnt>=FD_PCAP_MEM_ITER_IFACE_MAX ) ) {
+        FD_LOG_WARNING(( "too many pcapng interfaces for current implementation" ));
+        goto fail;
+      }
+      ulong type = fd_pcap_link_type( fd_pcap_mem_iter_u16( iter, blk + 8UL ) );
+      if( FD_UNLIKELY( type==ULONG_MAX ) ) {
+        FD_LOG_WARNING(( "unsupported link type (neither an Ethernet nor a cooked socket pcapng interface)" ));
+        goto fail;
+      }
+
+      fd_pcap_mem_iter_iface_t * iface = iter->iface + iter->iface_cnt;
+      iface->type    = (uint)type;
+      iface->tsresol = FD_PCAPNG_TSRESOL_DEFAULT;
+      iface->tsoff   = 0L;
+
+      /* Scan the options for the timestamp resolution and offset */
+
+      ulong opt_off = 16UL;
+      ulong opt_end = blk_sz - 4UL;
+      while( (opt_end-opt_off)>=4UL ) {
+        uint  opt_code = fd_pcap_mem_iter_u16( iter, blk + opt_off       );
+        ulong opt_sz   = fd_pcap_mem_iter_u16( iter, blk + opt_off + 2UL );
+        opt_off += 4UL;
+        if( opt_code==FD_PCAPNG_OPT_END ) break;
+        if( FD_UNLIKELY( opt_sz>(opt_end-opt_off) ) ) { FD_LOG_WARNING(( "pcapng interface option truncated" )); goto fail; }
+        if( (opt_code==FD_PCAPNG_OPT_IF_TSRESOL ) & (opt_sz==1UL) ) iface->tsresol = (uint)blk[ opt_off ];
+        if( (opt_code==FD_PCAPNG_OPT_IF_TSOFFSET) & (opt_sz==8UL) )
+          iface->tsoff = (long)( 1000000000UL*fd_pcap_mem_iter_u64( iter, blk + opt_off ) ); /* Wraps if corrupt */
+        opt_off += fd_ulong_align_up( opt_sz, 4UL );
+        if( FD_UNLIKELY( opt_off>opt_end ) ) break;
+      }
+
+      iter->iface_cnt++;
+      break;
+    }
+
+    case FD_PCAPNG_BLOCK_TYPE_EPB: {
+      if( FD_UNLIKELY( blk_sz<32UL ) ) { FD_LOG_WARNING(( "pcapng enhanced packet truncated" )); goto fail; }
+      ulong iface_idx = (ulong)fd_pcap_mem_iter_u32( iter, blk +  8UL );
+      ulong ts_hi     = (ulong)fd_pcap_mem_iter_u32( iter, blk + 12UL );
+      ulong ts_lo     = (ulong)fd_pcap_mem_iter_u32( iter, blk + 16UL );
+      ulong pkt_sz    = (ulong)fd_pcap_mem_iter_u32( iter, blk + 20UL );
+      ulong orig_sz   = (ulong)fd_pcap_mem_iter_u32( iter, blk + 24UL );
+      if( FD_UNLIKELY( iface_idx>=iter->iface_cnt ) ) { FD_LOG_WARNING(( "pcapng packet on an undescribed interface" )); goto fail; }
+      if( FD_UNLIKELY( pkt_sz>(blk_sz-32UL) ) ) { FD_LOG_WARNING(( "pcapng packet data truncated" )); goto fail; }
+      fd_pcap_mem_iter_iface_t const * iface = iter->iface + iface_idx;
+      if( FD_UNLIKELY( !fd_pcap_mem_iter_pkt( pkt_sz, orig_sz, (ulong)iface->type ) ) ) goto fail;
+
+      iter->off  = off;
+      iter->type = (ulong)iface->type;
+      iter->ts   = (long)( (ulong)fd_pcapng_ts_to_ns( (ts_hi<<32) | ts_lo, iface->tsresol ) + (ulong)iface->tsoff );
+      *_pkt_sz   = pkt_sz;
+      *_pkt_ts   = iter->ts;
+      return blk + 28UL;
+    }
+
+    case FD_PCAPNG_BLOCK_TYPE_SPB: {
+      if( FD_UNLIKELY( blk_sz<16UL ) ) { FD_LOG_WARNING(( "pcapng simple packet truncated" )); goto fail; }
+      if( FD_UNLIKELY( !iter->iface_cnt ) ) { FD_LOG_WARNING(( "pcapng packet on an undescribed interface" )); goto fail; }
+      ulong orig_sz = (ulong)fd_pcap_mem_iter_u32( iter, blk + 8UL );
+      ulong pkt_sz  = fd_ulong_min( orig_sz, blk_sz-16UL );
+      fd_pcap_mem_iter_iface_t const * iface = iter->iface; /* Simple packets are on interface 0 */
+      if( FD_UNLIKELY( !fd_pcap_mem_iter_pkt( pkt_sz, orig_sz, (ulong)iface->type ) ) ) goto fail;
+
+      iter->off  = off;
+      iter->type = (ulong)iface->type;
+      *_pkt_sz   = pkt_sz;
+      *_pkt_ts   = iter->ts;
+      return blk + 12UL;
+    }
+
+    default: /* Skip blocks without packets we don't care about */
+      break;
+    }
+  }
+
+fail:
+  iter->off = sz;
+  return NULL;
+}
+
+ulong
+fd_pcap_pkt_to_eth( void *        eth,
+                    uchar const * pkt,
+                    ulong         pkt_sz,
+                    ulong         pkt_type ) {
+  if( FD_LIKELY( pkt_type!=FD_PCAP_ITER_TYPE_COOKED ) ) {
+    fd_memcpy( eth, pkt, pkt_sz );
+    return pkt_sz;
+  }
+
+  fd_pcap_sll_hdr_t sll[1];
+  memcpy( sll, pkt, sizeof(fd_pcap_sll_hdr_t) ); /* pkt might be unaligned */
+  fd_pcap_sll_to_eth( (fd_eth_hdr_t *)eth, sll );
+
+  ulong payload_sz = pkt_sz - sizeof(fd_pcap_sll_hdr_t);
+  fd_memcpy( (uchar *)eth + sizeof(fd_eth_hdr_t), pkt + sizeof(fd_pcap_sll_hdr_t), payload_sz );
+  return sizeof(fd_eth_hdr_t) + payload_sz;
+}
+
+FD_STATIC_ASSERT( sizeof(fd_pcap_hdr_t    )==FD_PCAP_HDR_SZ,     layout );
+FD_STATIC_ASSERT( sizeof(fd_pcap_pkt_hdr_t)==FD_PCAP_PKT_HDR_SZ, layout );
+
+void
+fd_pcap_hdr_init( void * _hdr,
+                  uint   snaplen,
+                  uint   link_type ) {
+  fd_pcap_hdr_t hdr[1];
+  hdr->magic_number  = 0xa1b23c4dU;
+  hdr->version_major = (ushort)2;
+  hdr->version_minor = (ushort)4;
+  hdr->thiszone      = 0;
+  hdr->sigfigs       = 0U;
+  hdr->snaplen       = snaplen;
+  hdr->network       = link_type;
+  memcpy( _hdr, hdr, sizeof(fd_pcap_hdr_t) );
+}
+
 #define FD_PCAP_SNAPLEN (2048UL) /* FIXME: Allow for Jumbos? */
 
 ulong
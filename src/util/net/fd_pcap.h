@@ -7,11 +7,45 @@
 #define FD_PCAP_ITER_TYPE_ETHERNET (0UL)
 #define FD_PCAP_ITER_TYPE_COOKED   (1UL)
 
+/* FD_PCAP_MEM_ITER_IFACE_MAX is the maximum number of interfaces in a
+   pcapng section supported by a fd_pcap_mem_iter_t. */
+
+#define FD_PCAP_MEM_ITER_IFACE_MAX (16UL)
+
 /* Opaque handle of a pcap iterator */
 
 struct fd_pcap_iter;
 typedef struct fd_pcap_iter fd_pcap_iter_t;
 
+/* A fd_pcap_mem_iter_t iterates over the packets of a pcap or pcapng
+   capture held in memory (e.g. mapped with fd_pcap_map).  Unlike
+   fd_pcap_iter_t, packets are not copied out of the capture.  The
+   fields are private and should not be used directly. */
+
+struct fd_pcap_mem_iter_iface {
+  uint type;    /* FD_PCAP_ITER_TYPE_* of the interface's link type */
+  uint tsresol; /* pcapng if_tsresol of the interface */
+  long tsoff;   /* pcapng if_tsoffset of the interface in ns */
+};
+
+typedef struct fd_pcap_mem_iter_iface fd_pcap_mem_iter_iface_t;
+
+struct fd_pcap_mem_iter {
+  uchar const *            mem;       /* First byte of the capture */
+  ulong                    sz;        /* Capture size in bytes */
+  ulong                    off0;      /* Offset of the first record of the capture */
+  ulong                    off;       /* Offset of the next record, sz when iteration is over */
+  int                      pcapng;    /* 1 if a pcapng capture, 0 if a pcap capture */
+  int                      swap;      /* 1 if the capture (current pcapng section) is not in host byte order */
+  ulong                    type;      /* FD_PCAP_ITER_TYPE_* of the last packet returned (for pcap, of the capture) */
+  long                     ts;        /* Timestamp of the last packet returned */
+  long                     ts_mul;    /* For pcap captures, ns per timestamp sub-second unit */
+  ulong                    iface_cnt; /* For pcapng captures, number of interfaces in the current section */
+  fd_pcap_mem_iter_iface_t iface[ FD_PCAP_MEM_ITER_IFACE_MAX ];
+};
+
+typedef struct fd_pcap_mem_iter fd_pcap_mem_iter_t;
+
 FD_PROTOTYPES_BEGIN
 
 /* fd_pcap_iter_new creates an iterator suitable for reading a pcap
@@ -68,6 +102,135 @@ fd_pcap_iter_next( fd_pcap_iter_t * iter,
                    ulong            pkt_max,
                    long *           _pkt_ts );
 
+/* fd_pcap_map maps the capture at path read-only into the caller's
+   address space for use with a fd_pcap_mem_iter_t.  The mapping is
+   advised for sequential access (such that the kernel reads ahead
+   aggressively) and, where supported, to be backed by huge pages.
+   Returns a pointer to the first byte of the mapping and sets *_sz to
+   the capture size on success and returns NULL on failure (logs
+   details, *_sz untouched).  fd_pcap_unmap unmaps a mapping returned by
+   fd_pcap_map (logs details on failure). */
+
+void const *
+fd_pcap_map( char const * path,
+             ulong *      _sz );
+
+void
+fd_pcap_unmap( void const * mem,
+               ulong        sz );
+
+/* fd_pcap_mem_iter_new formats the memory pointed to by _iter as a
+   fd_pcap_mem_iter_t over the sz byte capture at mem.  The capture can
+   be a pcap (microsecond or nanosecond resolution, either byte order)
+   or pcapng capture of Ethernet and/or cooked packets.  Returns _iter
+   on success and NULL on failure (e.g. not a supported capture, logs
+   details).  The capture should be unchanged and its memory should
+   remain valid for the lifetime of the iterator.  fd_pcap_mem_iter_delete
+   returns the memory used by the iterator. */
+
+fd_pcap_mem_iter_t *
+fd_pcap_mem_iter_new( void *       _iter,
+                      void const * mem,
+                      ulong        sz );
+
+FD_FN_CONST static inline void * fd_pcap_mem_iter_delete( fd_pcap_mem_iter_t * iter ) { return (void *)iter; }
+
+/* fd_pcap_mem_iter_rewind resets iter to the first packet of the
+   capture. */
+
+static inline void
+fd_pcap_mem_iter_rewind( fd_pcap_mem_iter_t * iter ) {
+  iter->off       = iter->off0;
+  iter->iface_cnt = 0UL;
+}
+
+/* fd_pcap_mem_iter_next returns a pointer into the capture to the next
+   packet.  On success, *_pkt_sz will have the number of bytes captured
+   for the packet and *_pkt_ts will have the packet timestamp in ns.
+   The packet starts with its link layer header (fd_pcap_mem_iter_type
+   gives its type) and is valid for the lifetime of the iterator.
+   pcapng simple packets are given the timestamp of the preceding
+   packet.  Returns NULL on normal end-of-capture and on failure
+   (capture corruption, truncated packets, etc; logs details) and
+   subsequent calls will return NULL until the iterator is rewound.
+   On a NULL return, *_pkt_sz and *_pkt_ts are untouched. */
+
+uchar const *
+fd_pcap_mem_iter_next( fd_pcap_mem_iter_t * iter,
+                       ulong *              _pkt_sz,
+                       long *               _pkt_ts );
+
+/* fd_pcap_mem_iter_type returns the FD_PCAP_ITER_TYPE_* of the last
+   packet returned by fd_pcap_mem_iter_next. */
+
+FD_FN_PURE static inline ulong fd_pcap_mem_iter_type( fd_pcap_mem_iter_t const * iter ) { return iter->type; }
+
+/* fd_pcap_pkt_to_eth copies the pkt_sz byte packet pkt of type
+   FD_PCAP_ITER_TYPE_* pkt_type (e.g. as returned by
+   fd_pcap_mem_iter_next) into the memory region pointed to by eth,
+   formatted as by fd_pcap_iter_next (i.e. cooked packets get a phony
+   Ethernet header).  Returns the number of bytes written, which is at
+   most pkt_sz.  Assumes pkt_sz is at least the size of the link layer
+   header of pkt_type (fd_pcap_mem_iter_next guarantees this) and that
+   eth and pkt do not overlap. */
+
+ulong
+fd_pcap_pkt_to_eth( void *        eth,
+                    uchar const * pkt,
+                    ulong         pkt_sz,
+                    ulong         pkt_type );
+
+/* fd_pcap_pkt_eth_sz returns the number of bytes fd_pcap_pkt_to_eth
+   will write for a pkt_sz byte packet of type pkt_type (a cooked
+   header is 2 bytes larger than an Ethernet header). */
+
+FD_FN_CONST static inline ulong
+fd_pcap_pkt_eth_sz( ulong pkt_sz,
+                    ulong pkt_type ) {
+  return fd_ulong_if( pkt_type==FD_PCAP_ITER_TYPE_COOKED, pkt_sz-2UL, pkt_sz );
+}
+
+/* FD_PCAP_HDR_SZ and FD_PCAP_PKT_HDR_SZ are the sizes in bytes of a
+   pcap file header and of a pcap packet record header. */
+
+#define FD_PCAP_HDR_SZ     (24UL)
+#define FD_PCAP_PKT_HDR_SZ (16UL)
+
+/* FD_PCAP_LINK_TYPE_* are pcap link types for fd_pcap_hdr_init.  USER0
+   is the link type reserved for private use (e.g. for captures of
+   frags that are not Ethernet frames). */
+
+#define FD_PCAP_LINK_TYPE_ETHERNET (1U)
+#define FD_PCAP_LINK_TYPE_USER0    (147U)
+
+/* fd_pcap_hdr_init writes a little endian 2.4 nanosecond resolution
+   pcap header with the given snaplen and link_type to the
+   FD_PCAP_HDR_SZ bytes at hdr.  fd_pcap_pkt_hdr_init writes the record
+   header of a packet captured at ts (in ns) with incl_len of its
+   orig_len bytes included in the capture to the FD_PCAP_PKT_HDR_SZ
+   bytes at hdr (the incl_len bytes of the packet should follow).  hdr
+   need not be aligned.  These are the in-memory counterparts of
+   fd_pcap_fwrite_{hdr,pkt} for building captures in buffers (e.g. to
+   write them out in large blocks). */
+
+void
+fd_pcap_hdr_init( void * hdr,
+                  uint   snaplen,
+                  uint   link_type );
+
+static inline void
+fd_pcap_pkt_hdr_init( void * hdr,
+                      long   ts,
+                      ulong  incl_len,
+                      ulong  orig_len ) {
+  uint h[4];
+  h[0] = (uint)(((ulong)ts) / (ulong)1e9);
+  h[1] = (uint)(((ulong)ts) % (ulong)1e9); /* ns */
+  h[2] = (uint)incl_len;
+  h[3] = (uint)orig_len;
+  memcpy( hdr, h, FD_PCAP_PKT_HDR_SZ );
+}
+
 /* fd_pcap_fwrite_hdr write a little endian 2.4 Ethernet pcap header to
    the stream pointed to by file.  Same semantics as fwrite (returns
    number of headers written, which should be 1 on success and 0 on
@@ -94,6 +94,29 @@ fd_ip4_udp_check( uint                 ip4_saddr,
   return (ushort)~ul;
 }
 
+/* fd_ip4_udp_check_batch validates the udp checksums of a batch of up
+   to FD_IP4_UDP_CHECK_BATCH_MAX udp datagrams.  ip4[i] and udp[i] for i
+   in [0,cnt) point to the ip4 header (used for the pseudo header
+   addresses) and the udp header of the i-th datagram.  The datagram
+   payload is assumed to immediately follow the udp header (as it does
+   in a packet) and, as per fd_ip4_udp_check, it is assumed safe to read
+   up to 3 bytes past the end of each payload.  Returns a bit mask where
+   bit i is set if the i-th datagram has no checksum (udp[i]->check==0,
+   which is allowed in ip4) or has a valid checksum (i.e.
+   fd_ip4_udp_check(...)==0) and clear otherwise (including datagrams
+   whose udp length is too short to hold the udp header; bits at or
+   above cnt are clear).  On targets with AVX, the payloads are summed 32 bytes at
+   a time (the payload dominates the cost for all but the smallest
+   datagrams) and the datagrams of the batch are independent so their
+   sums overlap in the core. */
+
+#define FD_IP4_UDP_CHECK_BATCH_MAX (8UL)
+
+FD_FN_PURE int
+fd_ip4_udp_check_batch( fd_ip4_hdr_t const * const * ip4,
+                        fd_udp_hdr_t const * const * udp,
+                        ulong                        cnt );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_util_net_fd_udp_h */
@@ -54,5 +54,25 @@ LLVMFuzzerTestOneInput( uchar const * data,
 
   /* Release memfd */
   FD_TEST( fclose( file ) == 0 );
+
+  /* Iterate over the input in place as a pcap / pcapng capture.
+     Packets point into the input and are converted to Ethernet to
+     exercise the cooked header translation. */
+  fd_pcap_mem_iter_t _iter[1];
+  fd_pcap_mem_iter_t * iter = fd_pcap_mem_iter_new( _iter, data, size );
+  if ( FD_LIKELY( iter ) ) {
+    ulong pkt_sz;
+    long  pkt_ts;
+    uchar const * pkt;
+    while( (pkt = fd_pcap_mem_iter_next( iter, &pkt_sz, &pkt_ts )) ) {
+      FD_TEST( pkt>=data && pkt_sz<=size && (ulong)(pkt-data)<=size-pkt_sz );
+      if( pkt_sz<=128UL ) {
+        uchar buf[128];
+        FD_TEST( fd_pcap_pkt_to_eth( buf, pkt, pkt_sz, fd_pcap_mem_iter_type( iter ) )<=pkt_sz );
+      }
+    }
+    FD_TEST( fd_pcap_mem_iter_delete( iter ) == _iter );
+  }
+
   return 0;
 }
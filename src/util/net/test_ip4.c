@@ -19,11 +19,22 @@ FD_STATIC_ASSERT( FD_IP4_OPT_EOL==(uchar)  0, unit_test );
 
 FD_STATIC_ASSERT( sizeof(fd_ip4_hdr_t)==20UL, unit_test );
 
+FD_STATIC_ASSERT( FD_IP4_HDR_CHECK_BATCH_MAX==8UL, unit_test );
+
+/* Batch test buffer: FD_IP4_HDR_CHECK_BATCH_MAX headers with up to 40
+   bytes of options each (at random 4-byte aligned offsets) */
+
+#define HDR_STRIDE (128UL)
+
+static uchar hdr_mem[ FD_IP4_HDR_CHECK_BATCH_MAX*HDR_STRIDE ] __attribute__((aligned(128)));
+
 int
 main( int     argc,
       char ** argv ) {
   fd_boot( &argc, &argv );
 
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
   FD_TEST( (ulong)( &(((fd_ip4_hdr_t *)NULL)->tos         ) )== 1UL );
   FD_TEST( (ulong)( &(((fd_ip4_hdr_t *)NULL)->net_tot_len ) )== 2UL );
   FD_TEST( (ulong)( &(((fd_ip4_hdr_t *)NULL)->net_id      ) )== 4UL );
@@ -46,8 +57,51 @@ main( int     argc,
   FD_TEST( !fd_ip4_addr_is_mcast( ip4_addr_bcast ) ); FD_TEST(  fd_ip4_addr_is_bcast( ip4_addr_bcast ) );
 
   /* FIXME: TEST FD_IP4_HDR_NET_FRAG_OFF_IS_UNFRAGMENTED */ 
-  /* FIXME: TEST FD_IP4_HDR_CHECK */
-  /* FIXME: TEST FD_IP4_HDR_CHECK_FAST */
+
+  /* Test fd_ip4_hdr_check against a known header (192.168.0.1 ->
+     192.168.0.199, udp, check 0xb861) */
+
+  static uchar const known[20] __attribute__((aligned(4))) = {
+    0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+    0xb8, 0x61, 0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8, 0x00, 0xc7
+  };
+  fd_ip4_hdr_t known_hdr[1]; fd_memcpy( known_hdr, known, 20UL );
+  FD_TEST( !fd_ip4_hdr_check     ( known_hdr ) );
+  FD_TEST( !fd_ip4_hdr_check_fast( known_hdr ) );
+  known_hdr->check = (ushort)0;
+  FD_TEST( fd_ip4_hdr_check     ( known_hdr )==fd_ushort_bswap( (ushort)0xb861 ) );
+  FD_TEST( fd_ip4_hdr_check_fast( known_hdr )==fd_ushort_bswap( (ushort)0xb861 ) );
+
+  /* Test fd_ip4_hdr_check_batch against fd_ip4_hdr_check on fuzzed
+     headers (random options, random corruption, random batch sizes) */
+
+  for( ulong iter=0UL; iter<1000000UL; iter++ ) {
+    ulong cnt = fd_rng_ulong_roll( rng, FD_IP4_HDR_CHECK_BATCH_MAX+1UL );
+
+    fd_ip4_hdr_t const * hdr[ FD_IP4_HDR_CHECK_BATCH_MAX ];
+    int ref = 0;
+    for( ulong i=0UL; i<cnt; i++ ) {
+      uint * u = (uint *)( hdr_mem + i*HDR_STRIDE + 4UL*fd_rng_ulong_roll( rng, (HDR_STRIDE-60UL)/4UL+1UL ) );
+      fd_ip4_hdr_t * h = (fd_ip4_hdr_t *)u;
+      for( ulong j=0UL; j<15UL; j++ ) u[j] = fd_rng_uint( rng );
+
+      uint r = fd_rng_uint( rng );
+      ((uchar *)u)[0] = (uchar)(0x40U | ((r & 1U) ? 5U : fd_rng_uint_roll( rng, 16U ))); /* Mostly no options, sometimes garbage ihl */
+      if( (r>>1) & 3U ) { /* Usually valid, sometimes random check */
+        h->check = (ushort)0;
+        h->check = fd_ip4_hdr_check( h );
+        if( !((r>>3) & 7U) ) ((uchar *)u)[ fd_rng_ulong_roll( rng, 4UL*(ulong)fd_uint_max( h->ihl, 1U ) ) ] ^= (uchar)(1U<<fd_rng_uint_roll( rng, 8U ));
+      }
+      if( h->ihl==5U ) FD_TEST( fd_ip4_hdr_check_fast( h )==fd_ip4_hdr_check( h ) );
+
+      hdr[i] = h;
+      ref |= ((int)!fd_ip4_hdr_check( h )) << i;
+    }
+
+    FD_TEST( fd_ip4_hdr_check_batch( hdr, cnt )==ref );
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -68,6 +68,27 @@ main( int     argc,
 
   FD_TEST( fd_pcap_iter_delete( iter )==stream_in );
 
+  if( in_path ) {
+    FD_LOG_NOTICE(( "Mapping --in %s", in_path ));
+    ulong        map_sz;
+    void const * map = fd_pcap_map( in_path, &map_sz ); FD_TEST( map );
+    fd_pcap_mem_iter_t _mem_iter[1];
+    fd_pcap_mem_iter_t * mem_iter = fd_pcap_mem_iter_new( _mem_iter, map, map_sz ); FD_TEST( mem_iter );
+    ulong map_cnt = 0UL;
+    for(;;) {
+      ulong sz;
+      long  ts;
+      uchar const * pkt = fd_pcap_mem_iter_next( mem_iter, &sz, &ts );
+      if( FD_UNLIKELY( !pkt ) ) break;
+      if( FD_UNLIKELY( sz<64UL ) ) continue;
+      map_cnt++;
+    }
+    FD_LOG_NOTICE(( "%lu packets in mapped capture", map_cnt ));
+    FD_TEST( map_cnt==cnt );
+    FD_TEST( fd_pcap_mem_iter_delete( mem_iter )==_mem_iter );
+    fd_pcap_unmap( map, map_sz );
+  }
+
   if( stream_out && FD_UNLIKELY( fclose( stream_out ) ) ) FD_LOG_ERR(( "fclose failed" ));
   if( in_path    && FD_UNLIKELY( fclose( stream_in  ) ) ) FD_LOG_ERR(( "fclose failed" ));
 
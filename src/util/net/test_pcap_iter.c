@@ -0,0 +1,315 @@
+#include "../fd_util.h"
+#include "fd_pcap.h"
+
+#if FD_HAS_HOSTED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Helpers for building captures in memory */
+
+static uchar *
+put_u16( uchar * p, ulong x, int swap ) {
+  ushort y = (ushort)x; if( swap ) y = fd_ushort_bswap( y );
+  memcpy( p, &y, 2UL ); return p+2UL;
+}
+
+static uchar *
+put_u32( uchar * p, ulong x, int swap ) {
+  uint y = (uint)x; if( swap ) y = fd_uint_bswap( y );
+  memcpy( p, &y, 4UL ); return p+4UL;
+}
+
+static uchar *
+put_u64( uchar * p, ulong x, int swap ) {
+  if( swap ) x = fd_ulong_bswap( x );
+  memcpy( p, &x, 8UL ); return p+8UL;
+}
+
+/* put_pkt writes sz bytes of packet data seeded by seed */
+
+static uchar *
+put_pkt( uchar * p, ulong sz, ulong seed ) {
+  for( ulong i=0UL; i<sz; i++ ) p[i] = (uchar)(seed*31UL + i);
+  return p+sz;
+}
+
+/* ng_blk writes a pcapng block of type type with body [body,body+body_sz)
+   (padded to 4 bytes) */
+
+static uchar *
+ng_blk( uchar *       p,
+        ulong         type,
+        uchar const * body,
+        ulong         body_sz,
+        int           swap ) {
+  ulong blk_sz = 12UL + fd_ulong_align_up( body_sz, 4UL );
+  p = put_u32( p, type, swap );
+  p = put_u32( p, blk_sz, swap );
+  memcpy( p, body, body_sz ); memset( p+body_sz, 0, blk_sz-12UL-body_sz ); p += blk_sz-12UL;
+  return put_u32( p, blk_sz, swap );
+}
+
+static uchar *
+ng_shb( uchar * p, int swap ) {
+  uchar b[ 16 ]; uchar * q = b;
+  q = put_u32( q, 0x1a2b3c4dUL, swap ); q = put_u16( q, 1UL, swap ); q = put_u16( q, 0UL, swap );
+  q = put_u64( q, ULONG_MAX, swap );
+  return ng_blk( p, 0x0a0d0d0aUL, b, (ulong)(q-b), swap );
+}
+
+static uchar *
+ng_idb( uchar * p, ulong link_type, int tsresol, long tsoff, int swap ) {
+  uchar b[ 64 ]; uchar * q = b;
+  q = put_u16( q, link_type, swap ); q = put_u16( q, 0UL, swap ); q = put_u32( q, 0UL, swap );
+  if( tsresol>=0 ) { q = put_u16( q, 9UL, swap ); q = put_u16( q, 1UL, swap ); q = put_u32( q, (ulong)tsresol, 0 ); }
+  if( tsoff      ) { q = put_u16( q, 14UL, swap ); q = put_u16( q, 8UL, swap ); q = put_u64( q, (ulong)tsoff, swap ); }
+  q = put_u16( q, 0UL, swap ); q = put_u16( q, 0UL, swap );
+  return ng_blk( p, 1UL, b, (ulong)(q-b), swap );
+}
+
+static uchar *
+ng_epb( uchar * p, ulong iface, ulong ts, ulong sz, ulong seed, int swap ) {
+  uchar b[ 2048 ]; uchar * q = b;
+  q = put_u32( q, iface, swap ); q = put_u32( q, ts>>32, swap ); q = put_u32( q, ts & 0xffffffffUL, swap );
+  q = put_u32( q, sz, swap ); q = put_u32( q, sz, swap ); q = put_pkt( q, sz, seed );
+  return ng_blk( p, 6UL, b, (ulong)(q-b), swap );
+}
+
+/* check_pkt checks the next packet of iter is the sz byte packet seeded
+   by seed with timestamp ts and type type */
+
+static void
+check_pkt( fd_pcap_mem_iter_t * iter,
+           ulong                sz,
+           ulong                seed,
+           long                 ts,
+           ulong                type ) {
+  uchar ref[ 2048 ]; put_pkt( ref, sz, seed );
+  ulong         pkt_sz;
+  long          pkt_ts;
+  uchar const * pkt = fd_pcap_mem_iter_next( iter, &pkt_sz, &pkt_ts );
+  FD_TEST( pkt );
+  FD_TEST( pkt_sz==sz );
+  FD_TEST( pkt_ts==ts );
+  FD_TEST( fd_pcap_mem_iter_type( iter )==type );
+  FD_TEST( !memcmp( pkt, ref, sz ) );
+}
+
+static void
+test_mem_iter_pcap( void ) {
+  static uchar cap[ 4096 ];
+  fd_pcap_mem_iter_t _iter[1];
+
+  for( int swap=0; swap<2; swap++ ) {
+    for( int ns=0; ns<2; ns++ ) {
+      for( int cooked=0; cooked<2; cooked++ ) {
+        uchar * p = cap;
+        p = put_u32( p, ns ? 0xa1b23c4dUL : 0xa1b2c3d4UL, swap );
+        p = put_u16( p, 2UL, swap ); p = put_u16( p, 4UL, swap );
+        p = put_u32( p, 0UL, swap ); p = put_u32( p, 0UL, swap ); p = put_u32( p, 65535UL, swap );
+        p = put_u32( p, cooked ? 113UL : 1UL, swap );
+        for( ulong i=0UL; i<3UL; i++ ) {
+          ulong sz = 60UL + 17UL*i;
+          p = put_u32( p, 5UL+i, swap ); p = put_u32( p, 7UL, swap ); p = put_u32( p, sz, swap ); p = put_u32( p, sz, swap );
+          p = put_pkt( p, sz, i );
+        }
+        ulong cap_sz = (ulong)(p-cap);
+        ulong type   = cooked ? FD_PCAP_ITER_TYPE_COOKED : FD_PCAP_ITER_TYPE_ETHERNET;
+
+        fd_pcap_mem_iter_t * iter = fd_pcap_mem_iter_new( _iter, cap, cap_sz ); FD_TEST( iter==_iter );
+        for( ulong rewind=0UL; rewind<2UL; rewind++ ) {
+          for( ulong i=0UL; i<3UL; i++ ) check_pkt( iter, 60UL+17UL*i, i, (long)((5UL+i)*1000000000UL) + (ns ? 7L : 7000L), type );
+          ulong sz; long ts;
+          FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+          FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+          fd_pcap_mem_iter_rewind( iter );
+        }
+        FD_TEST( fd_pcap_mem_iter_delete( iter )==_iter );
+
+        /* Truncated capture stops at the truncated packet */
+        iter = fd_pcap_mem_iter_new( _iter, cap, cap_sz-1UL ); FD_TEST( iter );
+        ulong sz; long ts; ulong cnt = 0UL;
+        while( fd_pcap_mem_iter_next( iter, &sz, &ts ) ) cnt++;
+        FD_TEST( cnt==2UL );
+
+        /* Cross check against the stream iterator (which assumes ns) */
+        if( !swap && ns ) {
+          FILE * file = fmemopen( cap, cap_sz, "r" ); FD_TEST( file );
+          fd_pcap_iter_t * stream = fd_pcap_iter_new( file ); FD_TEST( stream );
+          iter = fd_pcap_mem_iter_new( _iter, cap, cap_sz ); FD_TEST( iter );
+          for(;;) {
+            uchar a[ 2048 ]; long a_ts; ulong a_sz = fd_pcap_iter_next( stream, a, 2048UL, &a_ts );
+            uchar b[ 2048 ]; long b_ts; ulong b_sz;
+            uchar const * pkt = fd_pcap_mem_iter_next( iter, &b_sz, &b_ts );
+            FD_TEST( (!a_sz)==(!pkt) );
+            if( !pkt ) break;
+            b_sz = fd_pcap_pkt_to_eth( b, pkt, b_sz, fd_pcap_mem_iter_type( iter ) );
+            FD_TEST( a_sz==b_sz ); FD_TEST( a_ts==b_ts ); FD_TEST( !memcmp( a, b, a_sz ) );
+          }
+          FD_TEST( !fclose( fd_pcap_iter_delete( stream ) ) );
+        }
+      }
+    }
+  }
+
+  /* Bad captures */
+  memset( cap, 0, 64UL );
+  FD_TEST( !fd_pcap_mem_iter_new( _iter, cap, 64UL ) ); /* bad magic */
+  put_u32( cap, 0xa1b2c3d4UL, 0 );
+  FD_TEST( !fd_pcap_mem_iter_new( _iter, cap, 10UL ) ); /* truncated header */
+  FD_TEST( !fd_pcap_mem_iter_new( _iter, cap, 64UL ) ); /* unsupported network type 0 */
+}
+
+static void
+test_mem_iter_pcapng( void ) {
+  static uchar cap[ 8192 ];
+  fd_pcap_mem_iter_t _iter[1];
+
+  for( int swap=0; swap<2; swap++ ) {
+    uchar * p = cap;
+    p = ng_shb( p, swap );
+    p = ng_idb( p, 1UL,   9, 2L, swap );                                  /* iface 0: Ethernet, ns, +2 s */
+    p = ng_idb( p, 113UL, -1, 0L, swap );                                 /* iface 1: cooked, us (default) */
+    p = ng_epb( p, 0UL, 1000UL, 64UL, 0UL, swap );
+    uchar unk[ 5 ] = { 1, 2, 3, 4, 5 }; p = ng_blk( p, 0x0bad0bcdUL, unk, 5UL, swap ); /* skipped */
+    p = ng_epb( p, 1UL, (1UL<<32) + 3UL, 61UL, 1UL, swap );
+    do {                                                                  /* simple packet on iface 0 */
+      uchar b[ 128 ]; uchar * q = b; q = put_u32( q, 66UL, swap ); q = put_pkt( q, 66UL, 2UL );
+      p = ng_blk( p, 3UL, b, (ulong)(q-b), swap );
+    } while(0);
+    p = ng_shb( p, !swap );                                               /* new section, opposite byte order */
+    p = ng_idb( p, 1UL, 0x80 | 20, 0L, !swap );                           /* iface 0: Ethernet, 2^-20 s */
+    p = ng_epb( p, 0UL, (3UL<<20) + (1UL<<19), 70UL, 3UL, !swap );
+    ulong cap_sz = (ulong)(p-cap);
+
+    fd_pcap_mem_iter_t * iter = fd_pcap_mem_iter_new( _iter, cap, cap_sz ); FD_TEST( iter );
+    for( ulong rewind=0UL; rewind<2UL; rewind++ ) {
+      long ts1 = (long)(((1UL<<32) + 3UL)*1000UL);
+      check_pkt( iter, 64UL, 0UL, 2000001000L, FD_PCAP_ITER_TYPE_ETHERNET );
+      check_pkt( iter, 61UL, 1UL, ts1,         FD_PCAP_ITER_TYPE_COOKED   );
+      check_pkt( iter, 66UL, 2UL, ts1,         FD_PCAP_ITER_TYPE_ETHERNET );
+      check_pkt( iter, 70UL, 3UL, 3500000000L, FD_PCAP_ITER_TYPE_ETHERNET );
+      ulong sz; long ts;
+      FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+      fd_pcap_mem_iter_rewind( iter );
+    }
+
+    /* Truncated / corrupt captures stop early */
+    ulong sz; long ts; ulong cnt;
+    iter = fd_pcap_mem_iter_new( _iter, cap, cap_sz-1UL ); FD_TEST( iter );
+    cnt = 0UL; while( fd_pcap_mem_iter_next( iter, &sz, &ts ) ) cnt++;
+    FD_TEST( cnt==3UL );
+
+    p = ng_shb( cap, swap );
+    p = ng_epb( p, 0UL, 0UL, 64UL, 0UL, swap ); /* no interface */
+    iter = fd_pcap_mem_iter_new( _iter, cap, (ulong)(p-cap) ); FD_TEST( iter );
+    FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+
+    p = ng_shb( cap, swap );
+    p = ng_idb( p, 1UL, -1, 0L, swap );
+    p = ng_epb( p, 0UL, 0UL, 64UL, 0UL, swap );
+    put_u32( p-4UL, 0UL, swap );                /* bad trailing length */
+    iter = fd_pcap_mem_iter_new( _iter, cap, (ulong)(p-cap) ); FD_TEST( iter );
+    FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+
+    p = ng_shb( cap, swap );
+    p = ng_idb( p, 105UL, -1, 0L, swap );       /* unsupported link type */
+    iter = fd_pcap_mem_iter_new( _iter, cap, (ulong)(p-cap) ); FD_TEST( iter );
+    FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+  }
+}
+
+/* test_hdr_init checks captures built with fd_pcap_hdr_init and
+   fd_pcap_pkt_hdr_init can be read back */
+
+static void
+test_hdr_init( void ) {
+  static uchar cap[ 4096 ];
+  fd_pcap_mem_iter_t _iter[1];
+
+  uchar * p = cap;
+  fd_pcap_hdr_init( p, 65535U, FD_PCAP_LINK_TYPE_ETHERNET ); p += FD_PCAP_HDR_SZ;
+  for( ulong i=0UL; i<3UL; i++ ) {
+    ulong sz = 60UL + 17UL*i;
+    fd_pcap_pkt_hdr_init( p, 1234567890123456789L + (long)i, sz, sz ); p += FD_PCAP_PKT_HDR_SZ;
+    p = put_pkt( p, sz, i );
+  }
+  ulong cap_sz = (ulong)(p-cap);
+
+  fd_pcap_mem_iter_t * iter = fd_pcap_mem_iter_new( _iter, cap, cap_sz ); FD_TEST( iter );
+  for( ulong i=0UL; i<3UL; i++ )
+    check_pkt( iter, 60UL + 17UL*i, i, 1234567890123456789L + (long)i, FD_PCAP_ITER_TYPE_ETHERNET );
+  ulong sz; long ts;
+  FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+  FD_TEST( fd_pcap_mem_iter_delete( iter )==_iter );
+}
+
+/* test_map checks a capture written to a file can be mapped with
+   fd_pcap_map and iterated over */
+
+static void
+test_map( void ) {
+  static uchar cap[ 4096 ];
+
+  uchar * p = cap;
+  fd_pcap_hdr_init( p, 65535U, FD_PCAP_LINK_TYPE_ETHERNET ); p += FD_PCAP_HDR_SZ;
+  for( ulong i=0UL; i<5UL; i++ ) {
+    ulong sz = 64UL + 33UL*i;
+    fd_pcap_pkt_hdr_init( p, 1000L*(long)i, sz, sz ); p += FD_PCAP_PKT_HDR_SZ;
+    p = put_pkt( p, sz, i );
+  }
+  ulong cap_sz = (ulong)(p-cap);
+
+  char path[] = "/tmp/test_pcap_iter.XXXXXX";
+  int fd = mkstemp( path );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "skip: mkstemp failed; not testing fd_pcap_map" ));
+    return;
+  }
+  FD_TEST( write( fd, cap, cap_sz )==(long)cap_sz );
+  FD_TEST( !close( fd ) );
+
+  ulong        map_sz = 0UL;
+  void const * map    = fd_pcap_map( path, &map_sz ); FD_TEST( map );
+  FD_TEST( map_sz==cap_sz );
+  FD_TEST( !unlink( path ) ); /* The mapping outlives the file name */
+
+  fd_pcap_mem_iter_t _iter[1];
+  fd_pcap_mem_iter_t * iter = fd_pcap_mem_iter_new( _iter, map, map_sz ); FD_TEST( iter );
+  for( ulong i=0UL; i<5UL; i++ )
+    check_pkt( iter, 64UL + 33UL*i, i, 1000L*(long)i, FD_PCAP_ITER_TYPE_ETHERNET );
+  ulong sz; long ts;
+  FD_TEST( !fd_pcap_mem_iter_next( iter, &sz, &ts ) );
+  FD_TEST( fd_pcap_mem_iter_delete( iter )==_iter );
+  fd_pcap_unmap( map, map_sz );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  test_mem_iter_pcap();
+  test_mem_iter_pcapng();
+  test_hdr_init();
+  test_map();
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_NOTICE(( "skip: unit test requires FD_HAS_HOSTED" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -3,18 +3,81 @@
 
 FD_STATIC_ASSERT( sizeof(fd_udp_hdr_t)==8UL, unit_test );
 
+FD_STATIC_ASSERT( FD_IP4_UDP_CHECK_BATCH_MAX==8UL, unit_test );
+
+/* Batch test buffer: FD_IP4_UDP_CHECK_BATCH_MAX packets (ip4 header,
+   udp header and up to PAYLOAD_MAX payload bytes at random offsets) */
+
+#define PAYLOAD_MAX (1500UL)
+#define PKT_STRIDE  (2048UL)
+
+static uchar pkt_mem[ FD_IP4_UDP_CHECK_BATCH_MAX*PKT_STRIDE ] __attribute__((aligned(128)));
+
+/* ref_check is the reference validity of a datagram as documented for
+   fd_ip4_udp_check_batch */
+
+static int
+ref_check( fd_ip4_hdr_t const * ip4,
+           fd_udp_hdr_t const * udp ) {
+  if( !udp->check ) return 1;
+  if( (ulong)fd_ushort_bswap( udp->net_len )<sizeof(fd_udp_hdr_t) ) return 0;
+  return !fd_ip4_udp_check( ip4->saddr, ip4->daddr, udp, udp+1 );
+}
+
 int
 main( int     argc,
       char ** argv ) {
   fd_boot( &argc, &argv );
 
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
   FD_TEST( (ulong)( &(((fd_udp_hdr_t *)NULL)->net_sport) )==0UL );
   FD_TEST( (ulong)( &(((fd_udp_hdr_t *)NULL)->net_dport) )==2UL );
   FD_TEST( (ulong)( &(((fd_udp_hdr_t *)NULL)->net_len  ) )==4UL );
   FD_TEST( (ulong)( &(((fd_udp_hdr_t *)NULL)->check    ) )==6UL );
   FD_TEST( (ulong)(  (((fd_udp_hdr_t *)NULL)->u        ) )==0UL );
 
-  /* FIXME: TEST FD_IP4_UDP_CHECK */
+  /* Test fd_ip4_udp_check_batch against fd_ip4_udp_check on fuzzed
+     datagrams (random payload sizes and alignments, random corruption,
+     missing checksums, bad lengths and random batch sizes) */
+
+  for( ulong iter=0UL; iter<200000UL; iter++ ) {
+    ulong cnt = fd_rng_ulong_roll( rng, FD_IP4_UDP_CHECK_BATCH_MAX+1UL );
+
+    fd_ip4_hdr_t const * ip4[ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    fd_udp_hdr_t const * udp[ FD_IP4_UDP_CHECK_BATCH_MAX ];
+    int ref = 0;
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ulong  payload_sz = fd_rng_uint_roll( rng, 2U ) ? fd_rng_ulong_roll( rng, 64UL ) : fd_rng_ulong_roll( rng, PAYLOAD_MAX+1UL );
+      uchar * pkt       = pkt_mem + i*PKT_STRIDE + fd_rng_ulong_roll( rng, 64UL );
+      for( ulong j=0UL; j<20UL+8UL+payload_sz+3UL; j++ ) pkt[j] = fd_rng_uchar( rng );
+
+      fd_ip4_hdr_t * h = (fd_ip4_hdr_t *)pkt;
+      fd_udp_hdr_t * u = (fd_udp_hdr_t *)(pkt+20UL);
+      u->net_len = fd_ushort_bswap( (ushort)(8UL+payload_sz) );
+
+      uint r = fd_rng_uint( rng );
+      if( (r & 7U)==0U ) u->net_len = fd_ushort_bswap( (ushort)fd_rng_uint_roll( rng, 8U ) ); /* Corrupt length */
+      else if( (r & 7U)==1U ) u->check = (ushort)0;                                           /* No checksum */
+      else if( (r & 7U)>=4U ) {                                                               /* Valid checksum */
+        u->check = (ushort)0;
+        u->check = fd_ip4_udp_check( h->saddr, h->daddr, u, u+1 );
+        if( !((r>>3) & 3U) ) { /* Flip a bit in the pseudo header / datagram, not in net_len (bytes 24:25) to stay in bounds */
+          ulong off = fd_rng_ulong_roll( rng, 8UL+8UL+payload_sz-2UL );
+          off += fd_ulong_if( off<12UL, 12UL, 14UL );
+          pkt[ off ] ^= (uchar)(1U<<fd_rng_uint_roll( rng, 8U ));
+        }
+      } /* else random checksum */
+
+      ip4[i] = h;
+      udp[i] = u;
+      ref |= ref_check( h, u ) << i;
+    }
+
+    FD_TEST( fd_ip4_udp_check_batch( ip4, udp, cnt )==ref );
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -0,0 +1,10 @@
+$(call add-hdrs,fd_perf.h)
+$(call add-objs,fd_perf,fd_util)
+$(call make-unit-test,test_perf,test_perf,fd_util)
+$(call run-unit-test,test_perf,)
+
+ifdef FD_HAS_HOSTED
+$(call add-objs,fd_perf_linux,fd_util)
+else
+$(call add-objs,fd_perf_stub,fd_util)
+endif
@@ -0,0 +1,36 @@
+#include "fd_perf.h"
+
+void
+fd_perf_drain( fd_perf_t * perf,
+               ulong *     diag ) {
+  ulong ctr[ FD_PERF_EVENT_CNT ];
+  if( FD_UNLIKELY( fd_perf_read( perf, ctr ) ) ) {
+    FD_VOLATILE( diag[ FD_PERF_DIAG_FAIL_CNT ] ) = FD_VOLATILE_CONST( diag[ FD_PERF_DIAG_FAIL_CNT ] ) + 1UL;
+    return;
+  }
+
+  /* Scaled counts are estimates and thus are not strictly monotonic
+     when the group is being multiplexed.  We don't let the accumulated
+     totals go backward in this case. */
+
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) {
+    ulong last = perf->last[ event ];
+    if( FD_LIKELY( ctr[ event ]>last ) ) {
+      FD_VOLATILE( diag[ event ] ) = FD_VOLATILE_CONST( diag[ event ] ) + (ctr[ event ] - last);
+      perf->last[ event ] = ctr[ event ];
+    }
+  }
+}
+
+char const *
+fd_perf_event_cstr( ulong event ) {
+  switch( event ) {
+  case FD_PERF_EVENT_CYCLES:    return "cycles";
+  case FD_PERF_EVENT_INSNS:     return "insns";
+  case FD_PERF_EVENT_LLC_MISS:  return "llc-miss";
+  case FD_PERF_EVENT_BR_MISS:   return "br-miss";
+  case FD_PERF_EVENT_DTLB_MISS: return "dtlb-miss";
+  default: break;
+  }
+  return "unknown";
+}
@@ -0,0 +1,119 @@
+#ifndef HEADER_fd_src_util_perf_fd_perf_h
+#define HEADER_fd_src_util_perf_fd_perf_h
+
+/* fd_perf provides APIs for a thread to sample the hardware performance
+   counters of its own execution (e.g. a tile measuring its IPC and
+   cache misses and publishing these as diagnostics).  On Linux, this
+   uses perf_event_open counting user space only events.  Availability
+   of performance counters depends on the build target, kernel, host
+   configuration (e.g. /proc/sys/kernel/perf_event_paranoid), process
+   permissions and hardware (e.g. many virtual machines don't expose
+   hardware counters).  As such, all usage should gracefully handle some
+   or all counters being unavailable. */
+
+#include "../log/fd_log.h"
+
+/* FD_PERF_EVENT_* give the indices of the events sampled by fd_perf.
+   These are contiguous in [0,FD_PERF_EVENT_CNT) such that a set of
+   event counts can be stored in a ulong array indexed by event.
+
+     CYCLES      is the number of core cycles (not reference cycles)
+     INSNS       is the number of instructions retired
+     LLC_MISS    is the number of last level cache misses
+     BR_MISS     is the number of mispredicted branches retired
+     DTLB_MISS   is the number of data TLB read misses */
+
+#define FD_PERF_EVENT_CYCLES    (0UL)
+#define FD_PERF_EVENT_INSNS     (1UL)
+#define FD_PERF_EVENT_LLC_MISS  (2UL)
+#define FD_PERF_EVENT_BR_MISS   (3UL)
+#define FD_PERF_EVENT_DTLB_MISS (4UL)
+#define FD_PERF_EVENT_CNT       (5UL)
+
+/* FD_PERF_DIAG_* give the layout of the diagnostics array updated by
+   fd_perf_drain.  Its first FD_PERF_EVENT_CNT entries are the event
+   counts (indexed by FD_PERF_EVENT_*) and FAIL_CNT is the number of
+   drains that failed to read the counters. */
+
+#define FD_PERF_DIAG_FAIL_CNT   (FD_PERF_EVENT_CNT)
+#define FD_PERF_DIAG_CNT        (FD_PERF_EVENT_CNT+1UL)
+
+/* fd_perf_t holds the state of a thread's performance counter
+   sampling.  Should be treated as opaque.  It is exposed here to allow
+   declaring them on the stack of the sampling thread (e.g.
+   'fd_perf_t _perf[1];'). */
+
+struct fd_perf_private {
+  ulong valid;                             /* Bit i set <> event i is being counted */
+  ulong grp_cnt;                           /* Number of counters in the group, in [0,FD_PERF_EVENT_CNT] */
+  int   fd   [ FD_PERF_EVENT_CNT ];        /* Group order file descriptors, fd[0] is the group leader */
+  ulong event[ FD_PERF_EVENT_CNT ];        /* Group order event indices */
+  ulong last [ FD_PERF_EVENT_CNT ];        /* Event indexed counts as of the last drain */
+  ulong fail_cnt;                          /* Number of failed reads since open (only the first is logged) */
+};
+
+typedef struct fd_perf_private fd_perf_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_perf_open starts counting the FD_PERF_EVENT_* events for the
+   calling thread.  perf points to the memory region the caller would
+   like to use to hold the sampling state.  The events are counted as a
+   single group (such that ratios between them are consistent even if
+   the kernel has to multiplex counters).  Events that can't be counted
+   on this host are skipped.  Returns perf on success (i.e. at least one
+   event is being counted) and NULL if no events could be counted (logs
+   details at INFO level, no cleanup of perf is necessary in this case).
+   A successful open should be closed by the same thread. */
+
+fd_perf_t *
+fd_perf_open( fd_perf_t * perf );
+
+/* fd_perf_valid returns a bit field indicating which events perf is
+   counting (bit i set indicates FD_PERF_EVENT i is counted).  Assumes
+   perf is a current open. */
+
+FD_FN_PURE static inline ulong fd_perf_valid( fd_perf_t const * perf ) { return perf->valid; }
+
+/* fd_perf_read reads the counts for events since perf was opened into
+   ctr (indexed by FD_PERF_EVENT_*).  Counts are scaled to account for
+   time spent multiplexed off the hardware.  Events not being counted
+   will read as zero.  Returns 0 on success and non-zero strerror
+   friendly error code on failure (ctr will be all zero in this case).
+   Only the first failure of an open is logged (a tile that keeps
+   failing would otherwise log at its housekeeping rate).  Assumes perf
+   is a current open and ctr is a FD_PERF_EVENT_CNT array. */
+
+int
+fd_perf_read( fd_perf_t * perf,
+              ulong *     ctr );
+
+/* fd_perf_drain adds the change in the counts for events since the last
+   drain (or open) into diag (a FD_PERF_DIAG_CNT array indexed by
+   FD_PERF_DIAG_*).  diag is updated with volatile writes such that it
+   can be a cnc application region (e.g. cnc_diag +
+   FD_CNC_DIAG_PERF_CYCLES) for consumption by remote monitors.
+   Intended to be called during a tile's housekeeping.  On a read
+   failure, only diag[ FD_PERF_DIAG_FAIL_CNT ] is updated. */
+
+void
+fd_perf_drain( fd_perf_t * perf,
+               ulong *     diag );
+
+/* fd_perf_close stops counting events.  Returns the memory region used
+   by perf (ownership returns to the caller). */
+
+void *
+fd_perf_close( fd_perf_t * perf );
+
+/* fd_perf_event_cstr returns a cstr with a short human readable name
+   for the given event.  The returned pointer has an infinite lifetime
+   (e.g. "cycles", "insns", ...).  Unrecognized events return
+   "unknown". */
+
+FD_FN_CONST char const *
+fd_perf_event_cstr( ulong event );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_util_perf_fd_perf_h */
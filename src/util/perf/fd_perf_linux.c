@@ -0,0 +1,151 @@
+/* syscall API requires _GNU_SOURCE */
+#define _GNU_SOURCE
+#include "fd_perf.h"
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* fd_perf_private_cfg gives the perf_event_open type and config of
+   each FD_PERF_EVENT_*.  LLC_MISS uses the generic cache misses event
+   (which the kernel maps to last level cache misses on common x86
+   hosts) as it is more widely available than the cache event. */
+
+static struct {
+  uint  type;
+  ulong config;
+} const fd_perf_private_cfg[ FD_PERF_EVENT_CNT ] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES    },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS  },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES  },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { PERF_TYPE_HW_CACHE, (ulong)PERF_COUNT_HW_CACHE_DTLB
+                     | ((ulong)PERF_COUNT_HW_CACHE_OP_READ     <<  8)
+                     | ((ulong)PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }
+};
+
+fd_perf_t *
+fd_perf_open( fd_perf_t * perf ) {
+
+  if( FD_UNLIKELY( !perf ) ) {
+    FD_LOG_WARNING(( "NULL perf" ));
+    return NULL;
+  }
+
+  perf->valid    = 0UL;
+  perf->grp_cnt  = 0UL;
+  perf->fail_cnt = 0UL;
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) {
+    perf->fd   [ event ] = -1;
+    perf->event[ event ] = 0UL;
+    perf->last [ event ] = 0UL;
+  }
+
+  /* Open the counters as a group of user space only counters for the
+     calling thread on whatever cpu it runs.  The first counter opened
+     successfully is the group leader.  The group is created disabled
+     and enabled once all members have joined such that all the
+     counters cover the same interval. */
+
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) {
+    struct perf_event_attr attr;
+    memset( &attr, 0, sizeof(attr) );
+    attr.type           = fd_perf_private_cfg[ event ].type;
+    attr.size           = (uint)sizeof(attr);
+    attr.config         = fd_perf_private_cfg[ event ].config;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled       = !perf->grp_cnt;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    int group_fd = perf->grp_cnt ? perf->fd[0] : -1;
+    int fd = (int)syscall( SYS_perf_event_open, &attr, 0 /* calling thread */, -1 /* any cpu */, group_fd, PERF_FLAG_FD_CLOEXEC );
+    if( FD_UNLIKELY( fd<0 ) ) {
+      FD_LOG_INFO(( "perf_event_open( %s ) failed (%i-%s); not counting", fd_perf_event_cstr( event ), errno, strerror( errno ) ));
+      continue;
+    }
+
+    perf->fd   [ perf->grp_cnt ] = fd;
+    perf->event[ perf->grp_cnt ] = event;
+    perf->grp_cnt++;
+    perf->valid |= 1UL << event;
+  }
+
+  if( FD_UNLIKELY( !perf->grp_cnt ) ) {
+    FD_LOG_INFO(( "no performance counters available" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( ioctl( perf->fd[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP ) ||
+                   ioctl( perf->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP ) ) ) {
+    FD_LOG_INFO(( "ioctl( PERF_EVENT_IOC_ENABLE ) failed (%i-%s); not counting", errno, strerror( errno ) ));
+    fd_perf_close( perf );
+    return NULL;
+  }
+
+  return perf;
+}
+
+int
+fd_perf_read( fd_perf_t * perf,
+              ulong *     ctr ) {
+
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) ctr[ event ] = 0UL;
+
+  /* Read the whole group in one go.  The layout is the number of
+     counters in the group, the time the group was enabled, the time
+     the group was running on the hardware and then the counts in group
+     order. */
+
+  ulong buf[ 3UL + FD_PERF_EVENT_CNT ];
+  ulong sz = (3UL + perf->grp_cnt)*sizeof(ulong);
+  long  rd = (long)read( perf->fd[0], buf, sz );
+  if( FD_UNLIKELY( rd!=(long)sz ) ) {
+    int err = (rd<0L) ? errno : EIO;
+    if( !perf->fail_cnt ) FD_LOG_WARNING(( "read perf group failed (%i-%s); further failures will not be logged", err, strerror( err ) ));
+    perf->fail_cnt++;
+    return err;
+  }
+
+  if( FD_UNLIKELY( buf[0]!=perf->grp_cnt ) ) {
+    if( !perf->fail_cnt ) FD_LOG_WARNING(( "unexpected perf group size; further failures will not be logged" ));
+    perf->fail_cnt++;
+    return EIO;
+  }
+
+  ulong enabled = buf[1];
+  ulong running = buf[2];
+  for( ulong grp_idx=0UL; grp_idx<perf->grp_cnt; grp_idx++ ) {
+    ulong val = buf[ 3UL+grp_idx ];
+    if( FD_UNLIKELY( running<enabled ) ) { /* Group was multiplexed, extrapolate */
+#     if FD_HAS_INT128
+      val = running ? (ulong)(((uint128)val*(uint128)enabled) / (uint128)running) : 0UL;
+#     else
+      val = running ? (ulong)(((double)val*(double)enabled) / (double)running) : 0UL;
+#     endif
+    }
+    ctr[ perf->event[ grp_idx ] ] = val;
+  }
+
+  return 0;
+}
+
+void *
+fd_perf_close( fd_perf_t * perf ) {
+
+  if( FD_UNLIKELY( !perf ) ) {
+    FD_LOG_WARNING(( "NULL perf" ));
+    return NULL;
+  }
+
+  /* Close members before the leader */
+
+  for( ulong grp_idx=perf->grp_cnt; grp_idx; grp_idx-- )
+    if( FD_UNLIKELY( close( perf->fd[ grp_idx-1UL ] ) ) )
+      FD_LOG_WARNING(( "close perf fd failed (%i-%s); attempting to continue", errno, strerror( errno ) ));
+
+  perf->valid   = 0UL;
+  perf->grp_cnt = 0UL;
+  return (void *)perf;
+}
@@ -0,0 +1,23 @@
+#include "fd_perf.h"
+#include <errno.h>
+
+fd_perf_t *
+fd_perf_open( fd_perf_t * perf ) {
+  (void)perf;
+  FD_LOG_INFO(( "no performance counter support for this build target" ));
+  return NULL;
+}
+
+int
+fd_perf_read( fd_perf_t * perf,
+              ulong *     ctr ) {
+  (void)perf;
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) ctr[ event ] = 0UL;
+  FD_LOG_WARNING(( "no performance counter support for this build target" ));
+  return ENOTSUP;
+}
+
+void *
+fd_perf_close( fd_perf_t * perf ) {
+  return (void *)perf;
+}
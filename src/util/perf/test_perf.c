@@ -0,0 +1,110 @@
+#include "../fd_util.h"
+
+FD_STATIC_ASSERT( FD_PERF_EVENT_CYCLES   ==0UL, unit_test );
+FD_STATIC_ASSERT( FD_PERF_EVENT_INSNS    ==1UL, unit_test );
+FD_STATIC_ASSERT( FD_PERF_EVENT_LLC_MISS ==2UL, unit_test );
+FD_STATIC_ASSERT( FD_PERF_EVENT_BR_MISS  ==3UL, unit_test );
+FD_STATIC_ASSERT( FD_PERF_EVENT_DTLB_MISS==4UL, unit_test );
+FD_STATIC_ASSERT( FD_PERF_EVENT_CNT      ==5UL, unit_test );
+
+/* spin does some branchy work on a buffer to give the counters
+   something to count */
+
+static uchar buf[ 1UL<<20 ];
+
+static ulong
+spin( fd_rng_t * rng,
+      ulong      iter_cnt ) {
+  ulong x = 0UL;
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong r = fd_rng_ulong( rng );
+    ulong i = r & (sizeof(buf)-1UL);
+    if( r & (1UL<<32) ) x += buf[ i ];
+    else                buf[ i ] = (uchar)x;
+  }
+  return x;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  FD_TEST( !strcmp( fd_perf_event_cstr( FD_PERF_EVENT_CYCLES    ), "cycles"    ) );
+  FD_TEST( !strcmp( fd_perf_event_cstr( FD_PERF_EVENT_INSNS     ), "insns"     ) );
+  FD_TEST( !strcmp( fd_perf_event_cstr( FD_PERF_EVENT_LLC_MISS  ), "llc-miss"  ) );
+  FD_TEST( !strcmp( fd_perf_event_cstr( FD_PERF_EVENT_BR_MISS   ), "br-miss"   ) );
+  FD_TEST( !strcmp( fd_perf_event_cstr( FD_PERF_EVENT_DTLB_MISS ), "dtlb-miss" ) );
+  FD_TEST( !strcmp( fd_perf_event_cstr( FD_PERF_EVENT_CNT       ), "unknown"   ) );
+
+  FD_TEST( !fd_perf_open( NULL ) );
+
+  fd_perf_t _perf[1];
+  fd_perf_t * perf = fd_perf_open( _perf );
+  if( FD_UNLIKELY( !perf ) ) {
+    FD_LOG_WARNING(( "skip: performance counters unavailable on this host" ));
+    fd_rng_delete( fd_rng_leave( rng ) );
+    fd_halt();
+    return 0;
+  }
+  FD_TEST( perf==_perf );
+
+  ulong valid = fd_perf_valid( perf );
+  FD_TEST( valid );
+  FD_TEST( !(valid>>FD_PERF_EVENT_CNT) );
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ )
+    FD_LOG_NOTICE(( "%-9s: %s", fd_perf_event_cstr( event ), ((valid>>event) & 1UL) ? "counting" : "unavailable" ));
+
+  /* Counts should be non-decreasing and events not counted should
+     read as zero */
+
+  ulong ctr0[ FD_PERF_EVENT_CNT ];
+  ulong ctr1[ FD_PERF_EVENT_CNT ];
+  FD_TEST( !fd_perf_read( perf, ctr0 ) );
+  FD_TEST( spin( rng, 1000000UL )!=ULONG_MAX );
+  FD_TEST( !fd_perf_read( perf, ctr1 ) );
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) {
+    if( !((valid>>event) & 1UL) ) { FD_TEST( !ctr0[ event ] ); FD_TEST( !ctr1[ event ] ); }
+    FD_LOG_NOTICE(( "%-9s: %lu", fd_perf_event_cstr( event ), ctr1[ event ]-ctr0[ event ] ));
+  }
+  if( valid & (1UL<<FD_PERF_EVENT_INSNS) ) FD_TEST( ctr1[ FD_PERF_EVENT_INSNS ]>ctr0[ FD_PERF_EVENT_INSNS ] );
+
+  /* Draining should accumulate the counts since open into diag */
+
+  ulong diag[ FD_PERF_DIAG_CNT ];
+  for( ulong idx=0UL; idx<FD_PERF_DIAG_CNT; idx++ ) diag[ idx ] = 0UL;
+  for( ulong rem=10UL; rem; rem-- ) {
+    FD_TEST( spin( rng, 100000UL )!=ULONG_MAX );
+    fd_perf_drain( perf, diag );
+  }
+  FD_TEST( !fd_perf_read( perf, ctr0 ) );
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) {
+    if( !((valid>>event) & 1UL) ) FD_TEST( !diag[ event ] );
+    FD_TEST( diag[ event ]<=ctr0[ event ] );
+  }
+  if( valid & (1UL<<FD_PERF_EVENT_INSNS) ) FD_TEST( diag[ FD_PERF_EVENT_INSNS ]>ctr1[ FD_PERF_EVENT_INSNS ]/2UL );
+  FD_TEST( !diag[ FD_PERF_DIAG_FAIL_CNT ] );
+
+  /* Failed reads should be counted (and leave the event counts alone) */
+
+  ulong diag_tmp[ FD_PERF_DIAG_CNT ];
+  for( ulong idx=0UL; idx<FD_PERF_DIAG_CNT; idx++ ) diag_tmp[ idx ] = diag[ idx ];
+  int fd0 = perf->fd[0];
+  perf->fd[0] = -1; /* make reads fail */
+  for( ulong rem=3UL; rem; rem-- ) fd_perf_drain( perf, diag );
+  perf->fd[0] = fd0;
+  FD_TEST( perf->fail_cnt==3UL );
+  FD_TEST( diag[ FD_PERF_DIAG_FAIL_CNT ]==3UL );
+  for( ulong event=0UL; event<FD_PERF_EVENT_CNT; event++ ) FD_TEST( diag[ event ]==diag_tmp[ event ] );
+
+  FD_TEST( fd_perf_close( perf )==_perf );
+  FD_TEST( !fd_perf_close( NULL ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -3,6 +3,8 @@
 #include "fd_shmem_private.h"
 #include <errno.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/sysinfo.h>
 
 /* The below uses the sysfs API added ~2009-Dec.  See
@@ -124,6 +126,35 @@ fd_numa_node_idx( ulong cpu_idx ) {
   return (ulong)node_idx;
 }
 
+ulong
+fd_numa_llc_idx( ulong cpu_idx ) {
+
+  /* On x86, sysfs cache index3 is the L3 (the last level cache on
+     essentially all relevant hosts).  The id file gives a system wide
+     unique id for the cache instance. */
+
+  char path[80];
+  int  fd = open( fd_cstr_printf( path, 80UL, NULL, "/sys/devices/system/cpu/cpu%lu/cache/index3/id", cpu_idx ), O_RDONLY );
+  if( FD_UNLIKELY( fd<0 ) ) return ULONG_MAX;
+
+  char buf[32];
+  long sz = (long)read( fd, buf, 32UL );
+  if( FD_UNLIKELY( close( fd ) ) )
+    FD_LOG_WARNING(( "close( \"%s\" ) failed (%i-%s); attempting to continue", path, errno, strerror( errno ) ));
+  if( FD_UNLIKELY( sz<=0L ) ) return ULONG_MAX;
+
+  ulong val = 0UL;
+  long  i   = 0L;
+  for( ; i<sz; i++ ) {
+    char c = buf[i];
+    if( !(('0'<=c) & (c<='9')) ) break;
+    val = (ulong)(c-'0') + 10UL*val;
+  }
+  if( FD_UNLIKELY( !i ) ) return ULONG_MAX; /* no digits */
+
+  return val;
+}
+
 /* FIXME: probably should do a FD_HAS_ASAN switch for the below to use
    the appropriate functionality when FD_HAS_ASAN is set (or maybe have
    a separate implementation for compiling under FD_HAS_ASAN). */
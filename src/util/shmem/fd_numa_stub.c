@@ -19,6 +19,12 @@ fd_numa_node_idx( ulong cpu_idx ) {
   return ULONG_MAX;
 }
 
+ulong
+fd_numa_llc_idx( ulong cpu_idx ) {
+  (void)cpu_idx;
+  return ULONG_MAX;
+}
+
 #include <errno.h>
 
 int
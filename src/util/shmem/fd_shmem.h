@@ -297,6 +297,18 @@ FD_FN_PURE ulong fd_shmem_numa_idx( ulong cpu_idx );
 
 FD_FN_PURE ulong fd_shmem_cpu_idx( ulong numa_idx );
 
+/* fd_shmem_llc_idx returns a label for the last level cache used by the
+   given logical cpu_idx.  cpus that share a last level cache have the
+   same label.  Labels are not necessarily contiguous and are only
+   meaningful for comparing cpus on the same numa node.  Given a cpu_idx
+   in [0,fd_shmem_cpu_cnt()), returns a value less than USHORT_MAX.
+   Returns ULONG_MAX otherwise.  The cpu -> llc mapping is determined at
+   thread group boot from sysfs.  If the host does not expose its cache
+   topology, each numa node is treated as having a single last level
+   cache. */
+
+FD_FN_PURE ulong fd_shmem_llc_idx( ulong cpu_idx );
+
 /* fd_shmem_numa_validate returns 0 if all the pages in the page_cnt
    page_sz pages pointed to by mem are on a numa node near cpu_idx and a
    strerror friendly non-zero error code otherwise (logs details).
@@ -28,6 +28,7 @@ static ulong  fd_shmem_private_numa_cnt;                      /* 0UL at thread g
 static ulong  fd_shmem_private_cpu_cnt;                       /* " */
 static ushort fd_shmem_private_numa_idx[ FD_SHMEM_CPU_MAX  ]; /* " */
 static ushort fd_shmem_private_cpu_idx [ FD_SHMEM_NUMA_MAX ]; /* " */
+static ushort fd_shmem_private_llc_idx [ FD_SHMEM_CPU_MAX  ]; /* " */
 
 ulong fd_shmem_numa_cnt( void ) { return fd_shmem_private_numa_cnt; }
 ulong fd_shmem_cpu_cnt ( void ) { return fd_shmem_private_cpu_cnt;  }
@@ -44,6 +45,12 @@ fd_shmem_cpu_idx( ulong numa_idx ) {
   return (ulong)fd_shmem_private_cpu_idx[ numa_idx ];
 }
 
+ulong
+fd_shmem_llc_idx( ulong cpu_idx ) {
+  if( FD_UNLIKELY( cpu_idx>=fd_shmem_private_cpu_cnt ) ) return ULONG_MAX;
+  return (ulong)fd_shmem_private_llc_idx[ cpu_idx ];
+}
+
 int
 fd_shmem_numa_validate( void const * mem,
                         ulong        page_sz,
@@ -590,6 +597,22 @@ fd_shmem_private_boot( int *    pargc,
     fd_shmem_private_cpu_idx [ numa_idx ] = (ushort)cpu_idx;
   }
 
+  /* Cache which cpus share a last level cache.  If the host doesn't
+     expose this for all cpus (common on virtual machines), assume each
+     numa node has a single shared last level cache.  llc_idx is an
+     arbitrary label here (it is not necessarily contiguous). */
+
+  int llc_ok = 1;
+  for( ulong cpu_idx=0UL; cpu_idx<cpu_cnt; cpu_idx++ ) {
+    ulong llc_idx = fd_numa_llc_idx( cpu_idx );
+    if( FD_UNLIKELY( llc_idx>=(ulong)USHORT_MAX ) ) { llc_ok = 0; break; }
+    fd_shmem_private_llc_idx[ cpu_idx ] = (ushort)llc_idx;
+  }
+  if( FD_UNLIKELY( !llc_ok ) ) {
+    FD_LOG_INFO(( "fd_shmem: last level cache topology unavailable; assuming one per numa node" ));
+    for( ulong cpu_idx=0UL; cpu_idx<cpu_cnt; cpu_idx++ ) fd_shmem_private_llc_idx[ cpu_idx ] = fd_shmem_private_numa_idx[ cpu_idx ];
+  }
+
   /* Determine the shared memory domain for this thread group */
 
   char const * shmem_base = fd_env_strip_cmdline_cstr( pargc, pargv, "--shmem-path", "FD_SHMEM_PATH", "/mnt/.fd" );
@@ -616,7 +639,8 @@ fd_shmem_private_halt( void ) {
 
   fd_shmem_private_numa_cnt = 0;
   fd_shmem_private_cpu_cnt  = 0;
-  fd_memset( fd_shmem_private_numa_idx, 0, FD_SHMEM_CPU_MAX );
+  fd_memset( fd_shmem_private_numa_idx, 0, sizeof(fd_shmem_private_numa_idx) );
+  fd_memset( fd_shmem_private_llc_idx,  0, sizeof(fd_shmem_private_llc_idx)  );
 
   fd_shmem_private_base[0] = '\0';
   fd_shmem_private_base_len = 0UL;
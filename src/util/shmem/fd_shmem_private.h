@@ -50,6 +50,17 @@ fd_numa_cpu_cnt( void );
 ulong
 fd_numa_node_idx( ulong cpu_idx );
 
+/* fd_numa_llc_idx determines an index for the last level cache used by
+   the given cpu_idx such that cpus that share a last level cache have
+   the same index.  Returns ULONG_MAX if this could not be determined.
+   This is not logged as many hosts (e.g. virtual machines) don't expose
+   their cache topology.  This function is only used during shmem
+   initialization as part of topology discovery so should not do any
+   fancy caching under the hood. */
+
+ulong
+fd_numa_llc_idx( ulong cpu_idx );
+
 /* FIXME: probably should clean up the below APIs to get something
    that allows for cleaner integration with fd_shmem_admin.c (e.g. if we
    are going to replace libnuma calls with our own, no reason to use the
@@ -40,11 +40,14 @@ main( int     argc,
 
   FD_TEST( fd_shmem_numa_idx( cpu_cnt )==ULONG_MAX );
   FD_TEST( fd_shmem_cpu_idx( numa_cnt )==ULONG_MAX );
+  FD_TEST( fd_shmem_llc_idx( cpu_cnt  )==ULONG_MAX );
   for( ulong cpu_idx=0UL; cpu_idx<cpu_cnt; cpu_idx++ ) {
     ulong numa_idx = fd_shmem_numa_idx( cpu_idx );
     FD_TEST( numa_idx<numa_cnt );
     FD_TEST( fd_shmem_cpu_idx( numa_idx )<=cpu_idx );
-    FD_LOG_NOTICE(( "cpu %lu -> numa %lu", cpu_idx, numa_idx ));
+    ulong llc_idx = fd_shmem_llc_idx( cpu_idx );
+    FD_TEST( llc_idx<(ulong)USHORT_MAX );
+    FD_LOG_NOTICE(( "cpu %lu -> numa %lu, llc %lu", cpu_idx, numa_idx, llc_idx ));
   }
 
   for( ulong numa_idx=0UL; numa_idx<numa_cnt; numa_idx++ ) {
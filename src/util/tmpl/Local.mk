@@ -1,8 +1,9 @@
-$(call add-hdrs,fd_smallset.c fd_set.c fd_set_dynamic.c fd_sort.c fd_map.c fd_map_dynamic.c fd_map_giant.c fd_prq.c fd_stack.c fd_queue.c fd_queue_dynamic.c fd_deque.c fd_deque_dynamic.c fd_voff.c fd_vec.c)
+$(call add-hdrs,fd_smallset.c fd_set.c fd_set_dynamic.c fd_sort.c fd_sort_radix.c fd_map.c fd_map_dynamic.c fd_map_giant.c fd_prq.c fd_stack.c fd_queue.c fd_queue_dynamic.c fd_deque.c fd_deque_dynamic.c fd_voff.c fd_vec.c)
 $(call make-unit-test,test_smallset,test_smallset,fd_util)
 $(call make-unit-test,test_set,test_set,fd_util)
 $(call make-unit-test,test_set_dynamic,test_set_dynamic,fd_util)
 $(call make-unit-test,test_sort,test_sort,fd_util)
+$(call make-unit-test,test_sort_radix,test_sort_radix,fd_util)
 $(call make-unit-test,test_map,test_map,fd_util)
 $(call make-unit-test,test_map_dynamic,test_map_dynamic,fd_util)
 $(call make-unit-test,test_map_giant,test_map_giant,fd_util)
@@ -14,10 +15,13 @@ $(call make-unit-test,test_deque,test_deque,fd_util)
 $(call make-unit-test,test_deque_dynamic,test_deque_dynamic,fd_util)
 $(call make-unit-test,test_voff,test_voff,fd_util)
 $(call make-unit-test,test_vec,test_vec,fd_util)
+$(call make-unit-test,bench_sort,bench_sort,fd_util)
+$(call make-unit-test,bench_sort_radix,bench_sort_radix,fd_util)
 $(call run-unit-test,test_smallset,)
 $(call run-unit-test,test_set,)
 $(call run-unit-test,test_set_dynamic,)
 $(call run-unit-test,test_sort,)
+$(call run-unit-test,test_sort_radix,)
 $(call run-unit-test,test_map,)
 $(call run-unit-test,test_map_dynamic,)
 $(call run-unit-test,test_map_giant,)
@@ -0,0 +1,135 @@
+#include "../fd_util.h"
+
+/* bench_sort compares the thread parallel sorts against the single
+   threaded sorts for random ulong keys over a range of sizes and
+   worker counts.  Run with several tiles (e.g. --tile-cpus 0-7) to see
+   the scaling.  The largest size is given by --cnt-max (sizes are
+   swept by factors of 4 from --cnt-min).  The bench needs ~3*8*cnt-max
+   bytes of memory (e.g. ~24 GiB for a 1e9 key sort). */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#define SORT_NAME     sort_ulong
+#define SORT_KEY_T    ulong
+#define SORT_PARALLEL 1
+#include "fd_sort.c"
+
+static void
+fill( ulong *    key,
+      ulong      cnt,
+      fd_rng_t * rng ) {
+  for( ulong i=0UL; i<cnt; i++ ) key[i] = fd_rng_ulong( rng );
+}
+
+static int
+is_sorted( ulong const * key,
+           ulong         cnt ) {
+  for( ulong i=1UL; i<cnt; i++ ) if( key[i]<key[i-1UL] ) return 0;
+  return 1;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal" );
+  ulong        cnt_min  = fd_env_strip_cmdline_ulong( &argc, &argv, "--cnt-min",  NULL, 1UL<<20  );
+  ulong        cnt_max  = fd_env_strip_cmdline_ulong( &argc, &argv, "--cnt-max",  NULL, 1UL<<24  );
+  ulong        iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 3UL      );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz                                   ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( !((1UL<=cnt_min) & (cnt_min<=cnt_max))     ) ) FD_LOG_ERR(( "--cnt-min and --cnt-max should satisfy 1<=cnt-min<=cnt-max" ));
+  if( FD_UNLIKELY( !sort_ulong_stable_cnt_valid( cnt_max ) ) ) FD_LOG_ERR(( "--cnt-max too large" ));
+  if( FD_UNLIKELY( !iter_cnt                                  ) ) FD_LOG_ERR(( "--iter-cnt should be positive" ));
+
+  ulong tile_cnt = fd_tile_cnt();
+
+  FD_LOG_NOTICE(( "Using --page-sz %s --cnt-min %lu --cnt-max %lu --iter-cnt %lu (tile_cnt %lu)",
+                  _page_sz, cnt_min, cnt_max, iter_cnt, tile_cnt ));
+
+  static uchar tpool_mem[ FD_TPOOL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tile_cnt ); FD_TEST( tpool );
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL )==tpool );
+
+  ulong   arr_sz   = fd_ulong_align_up( cnt_max*sizeof(ulong), page_sz );
+  ulong   page_cnt = 3UL*arr_sz / page_sz;
+  ulong   cpu_idx  = fd_tile_cpu_id( 0UL ); if( FD_UNLIKELY( cpu_idx>=fd_shmem_cpu_cnt() ) ) cpu_idx = 0UL;
+  uchar * mem      = (uchar *)fd_shmem_acquire( page_sz, page_cnt, cpu_idx );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "fd_shmem_acquire failed" ));
+  ulong * ref = (ulong *) mem;
+  ulong * key = (ulong *)(mem +     arr_sz);
+  ulong * tmp = (ulong *)(mem + 2UL*arr_sz);
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  for( ulong cnt=cnt_min; cnt<=cnt_max; cnt = (cnt<=(cnt_max>>2)) ? (cnt<<2) : (cnt_max+1UL) ) {
+
+    fill( ref, cnt, rng );
+    double ns_per = 1. / (double)(cnt*iter_cnt);
+
+    /* Single threaded references */
+
+    long dt_stable = 0L;
+    long dt_quick  = 0L;
+    for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+      memcpy( key, ref, cnt*sizeof(ulong) );
+      dt_stable -= fd_log_wallclock();
+      ulong * out = sort_ulong_stable_fast( key, cnt, tmp );
+      dt_stable += fd_log_wallclock();
+      FD_TEST( is_sorted( out, cnt ) );
+
+      memcpy( key, ref, cnt*sizeof(ulong) );
+      dt_quick -= fd_log_wallclock();
+      sort_ulong_inplace( key, cnt );
+      dt_quick += fd_log_wallclock();
+      FD_TEST( is_sorted( key, cnt ) );
+    }
+    FD_LOG_NOTICE(( "cnt %11lu: serial   stable %9.3f ns/key, inplace %9.3f ns/key",
+                    cnt, (double)dt_stable*ns_per, (double)dt_quick*ns_per ));
+
+    for( ulong worker_cnt=1UL; worker_cnt<=tile_cnt; worker_cnt++ ) {
+      long dt_para_stable = 0L;
+      long dt_para_quick  = 0L;
+      for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+        memcpy( key, ref, cnt*sizeof(ulong) );
+        dt_para_stable -= fd_log_wallclock();
+        ulong * out = sort_ulong_para_fast( tpool, 0UL,worker_cnt, key, cnt, tmp, 1 );
+        dt_para_stable += fd_log_wallclock();
+        FD_TEST( is_sorted( out, cnt ) );
+
+        memcpy( key, ref, cnt*sizeof(ulong) );
+        dt_para_quick -= fd_log_wallclock();
+        out = sort_ulong_para_fast( tpool, 0UL,worker_cnt, key, cnt, tmp, 0 );
+        dt_para_quick += fd_log_wallclock();
+        FD_TEST( is_sorted( out, cnt ) );
+      }
+      FD_LOG_NOTICE(( "cnt %11lu: %3lu workers stable %9.3f ns/key (speedup %6.2f), unstable %9.3f ns/key (speedup %6.2f)",
+                      cnt, worker_cnt,
+                      (double)dt_para_stable*ns_per, (double)dt_stable/(double)dt_para_stable,
+                      (double)dt_para_quick *ns_per, (double)dt_quick /(double)dt_para_quick ));
+    }
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_shmem_release( mem, page_sz, page_cnt );
+  FD_TEST( fd_tpool_fini( tpool )==(void *)tpool_mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include "../fd_util.h"
+
+/* bench_sort_radix compares fd_sort_radix.c against the comparison
+   based fd_sort.c for ulong and uint keys over a range of sizes
+   (--cnt-min to --cnt-max, swept by factors of 4) and key distributions
+   (uniform random keys and keys in a small range).  Each size is sorted
+   enough times to sort ~--work keys total.  The bench needs
+   ~3*8*cnt-max bytes of memory (e.g. ~2.4 GB for 100M keys). */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+#define SORT_NAME  cmp_ulong
+#define SORT_KEY_T ulong
+#include "fd_sort.c"
+
+#define SORT_NAME  cmp_uint
+#define SORT_KEY_T uint
+#include "fd_sort.c"
+
+#define SORT_NAME  radix_ulong
+#define SORT_KEY_T ulong
+#include "fd_sort_radix.c"
+
+#define SORT_NAME  radix_uint
+#define SORT_KEY_T uint
+#include "fd_sort_radix.c"
+
+#define STYLE_STABLE  (0) /* fd_sort stable_fast        */
+#define STYLE_INPLACE (1) /* fd_sort inplace            */
+#define STYLE_RADIX   (2) /* fd_sort_radix stable_fast  */
+#define STYLE_COPY    (3) /* Just the copy (subtracted) */
+#define STYLE_CNT     (4)
+
+static void *
+run( int    style,
+     int    w32,
+     void * key,
+     void * ref,
+     void * tmp,
+     ulong  cnt ) {
+  ulong sz = w32 ? sizeof(uint) : sizeof(ulong);
+  memcpy( key, ref, cnt*sz );
+  void * out = key;
+  if( w32 ) {
+    switch( style ) {
+    case STYLE_STABLE:  out = cmp_uint_stable_fast  ( (uint *)key, cnt, tmp ); break;
+    case STYLE_INPLACE: out = cmp_uint_inplace      ( (uint *)key, cnt      ); break;
+    case STYLE_RADIX:   out = radix_uint_stable_fast( (uint *)key, cnt, tmp ); break;
+    default: break;
+    }
+  } else {
+    switch( style ) {
+    case STYLE_STABLE:  out = cmp_ulong_stable_fast  ( (ulong *)key, cnt, tmp ); break;
+    case STYLE_INPLACE: out = cmp_ulong_inplace      ( (ulong *)key, cnt      ); break;
+    case STYLE_RADIX:   out = radix_ulong_stable_fast( (ulong *)key, cnt, tmp ); break;
+    default: break;
+    }
+  }
+  return out;
+}
+
+static int
+is_sorted( int          w32,
+           void const * out,
+           ulong        cnt ) {
+  if( w32 ) { uint  const * k = (uint  const *)out; for( ulong i=1UL; i<cnt; i++ ) if( k[i]<k[i-1UL] ) return 0; }
+  else      { ulong const * k = (ulong const *)out; for( ulong i=1UL; i<cnt; i++ ) if( k[i]<k[i-1UL] ) return 0; }
+  return 1;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz", NULL, "normal" );
+  ulong        cnt_min  = fd_env_strip_cmdline_ulong( &argc, &argv, "--cnt-min", NULL, 16UL     );
+  ulong        cnt_max  = fd_env_strip_cmdline_ulong( &argc, &argv, "--cnt-max", NULL, 1UL<<24  );
+  ulong        work     = fd_env_strip_cmdline_ulong( &argc, &argv, "--work",    NULL, 1UL<<24  );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz                               ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( !((1UL<=cnt_min) & (cnt_min<=cnt_max)) ) ) FD_LOG_ERR(( "--cnt-min and --cnt-max should satisfy 1<=cnt-min<=cnt-max" ));
+  if( FD_UNLIKELY( !cmp_ulong_stable_cnt_valid( cnt_max ) ) ) FD_LOG_ERR(( "--cnt-max too large" ));
+
+  FD_LOG_NOTICE(( "Using --page-sz %s --cnt-min %lu --cnt-max %lu --work %lu", _page_sz, cnt_min, cnt_max, work ));
+
+  ulong   arr_sz   = fd_ulong_align_up( cnt_max*sizeof(ulong), page_sz );
+  ulong   page_cnt = 3UL*arr_sz / page_sz;
+  uchar * mem      = (uchar *)fd_shmem_acquire( page_sz, page_cnt, 0UL );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "fd_shmem_acquire failed" ));
+  void * ref = (void *) mem;
+  void * key = (void *)(mem +     arr_sz);
+  void * tmp = (void *)(mem + 2UL*arr_sz);
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  static char const * dist_name[2] = { "uniform", "24-bit" };
+
+  for( int w32=0; w32<2; w32++ ) {
+    for( int dist=0; dist<2; dist++ ) {
+      FD_LOG_NOTICE(( "Benching %s keys (%s)", w32 ? "uint" : "ulong", dist_name[ dist ] ));
+      for( ulong cnt=cnt_min; cnt<=cnt_max; cnt = (cnt<=(cnt_max>>2)) ? (cnt<<2) : (cnt_max+1UL) ) {
+
+        for( ulong i=0UL; i<cnt; i++ ) {
+          ulong r = fd_rng_ulong( rng );
+          if( dist ) r &= 0xffffffUL;
+          if( w32 ) ((uint *)ref)[i] = (uint)r; else ((ulong *)ref)[i] = r;
+        }
+
+        /* Check the results */
+
+        for( int style=0; style<STYLE_COPY; style++ ) FD_TEST( is_sorted( w32, run( style, w32, key, ref, tmp, cnt ), cnt ) );
+
+        ulong iter_cnt = fd_ulong_max( work / cnt, 1UL );
+        double dt[ STYLE_CNT ];
+        for( int style=0; style<STYLE_CNT; style++ ) {
+          run( style, w32, key, ref, tmp, cnt ); /* warmup */
+          long elapsed = -fd_log_wallclock();
+          for( ulong iter=0UL; iter<iter_cnt; iter++ ) run( style, w32, key, ref, tmp, cnt );
+          elapsed += fd_log_wallclock();
+          dt[ style ] = (double)elapsed / (double)(iter_cnt*cnt);
+        }
+        for( int style=0; style<STYLE_COPY; style++ ) { double d = dt[ style ] - dt[ STYLE_COPY ]; dt[ style ] = d>1e-3 ? d : 1e-3; }
+
+        FD_LOG_NOTICE(( "cnt %10lu: stable %8.3f ns/key, inplace %8.3f ns/key, radix %8.3f ns/key (%5.2fx stable, %5.2fx inplace)",
+                        cnt, dt[ STYLE_STABLE ], dt[ STYLE_INPLACE ], dt[ STYLE_RADIX ],
+                        dt[ STYLE_STABLE ] / dt[ STYLE_RADIX ], dt[ STYLE_INPLACE ] / dt[ STYLE_RADIX ] ));
+      }
+    }
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_shmem_release( mem, page_sz, page_cnt );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
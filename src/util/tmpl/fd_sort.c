@@ -65,6 +65,48 @@
                          ulong    cnt,
                          ulong    rnk );
 
+   If SORT_PARALLEL is defined to 1, the following thread parallel
+   variants are also declared (see util/tpool/fd_tpool.h):
+
+     // Sort key[i] for i in [0,cnt) using tpool worker threads [t0,t1)
+     // (the caller masquerades as worker t0, same requirements as
+     // fd_tpool_exec_all_*).  Each worker sorts a contiguous block of
+     // keys and then the blocks are merged pairwise in ceil(lg(t1-t0))
+     // rounds.  The merges in each round are split evenly over all the
+     // workers (merge path partitioning) such that the load stays
+     // balanced through the final merge.  If stable is non-zero, the
+     // sort is stable.  Otherwise, the blocks are quick sorted
+     // (typically faster but equal keys might be reordered).  scratch
+     // has the same requirements as stable_fast.  Returns where the
+     // sorted values ended up.  Will be at either key or
+     // (double *)scratch.  Uses the single threaded sorts if there is
+     // only one worker or cnt is small (see SORT_PARALLEL_THRESH).
+
+     double *
+     sort_double_descend_para_fast( fd_tpool_t * tpool,
+                                    ulong        t0,
+                                    ulong        t1,
+                                    double *     key,
+                                    ulong        cnt,
+                                    void *       scratch,
+                                    int          stable );
+
+     // Same as above but does additional copying (in parallel) if
+     // necessary such that the final result ends up in key.  Returns
+     // key.  If scratch is NULL, the scratch region will be allocated
+     // from the caller's fd_scratch (the caller should be attached to a
+     // scratch with a free frame and stable_scratch_footprint( cnt )
+     // bytes free).
+
+     double *
+     sort_double_descend_para( fd_tpool_t * tpool,
+                               ulong        t0,
+                               ulong        t1,
+                               double *     key,
+                               ulong        cnt,
+                               void *       scratch,
+                               int          stable );
+
    It is fine to include this template multiple times in a compilation
    unit.  Just provide the specification before each inclusion.  Various
    additional options to tune the methods are described below. */
@@ -140,6 +182,25 @@
 #define SORT_IDX_IF(c,t,f) ((SORT_IDX_T)fd_ulong_if( (c), (ulong)(t), (ulong)(f) ))
 #endif
 
+/* SORT_PARALLEL indicates whether to declare the thread parallel
+   variants. */
+
+#ifndef SORT_PARALLEL
+#define SORT_PARALLEL 0
+#endif
+
+/* SORT_PARALLEL_THRESH gives the smallest number of keys per worker
+   where the parallel variants will actually use multiple workers.
+   Below this, the dispatch and merge passes cost more than they save. */
+
+#ifndef SORT_PARALLEL_THRESH
+#define SORT_PARALLEL_THRESH 8192
+#endif
+
+#if SORT_PARALLEL
+#include "../tpool/fd_tpool.h"
+#endif
+
 /**********************************************************************/
 
 #define SORT_(x)FD_EXPAND_THEN_CONCAT3(SORT_NAME,_,x)
@@ -160,6 +221,18 @@ SORT_(private_select)( SORT_KEY_T * key,
                        SORT_IDX_T   cnt,
                        SORT_IDX_T   rnk );
 
+#if SORT_PARALLEL
+SORT_KEY_T *
+SORT_(private_para)( fd_tpool_t * tpool,
+                     ulong        t0,
+                     ulong        t1,
+                     SORT_KEY_T * key,
+                     SORT_IDX_T   cnt,
+                     SORT_KEY_T * tmp,
+                     int          stable,
+                     int          to_key );
+#endif
+
 #else /* need implementations */
 
 #if SORT_IMPL_STYLE==0 /* local only */
@@ -564,6 +637,213 @@ SORT_(private_select)( SORT_KEY_T * key,
   /* never get here */
 }
 
+#if SORT_PARALLEL
+
+/* SORT_(private_para_blk) returns the index of the first key in block
+   blk when cnt keys are split into blk_cnt blocks.  The blocks are the
+   same as the batches fd_tpool_exec_all_batch assigns to workers over
+   [0,cnt).  Returns cnt for blk>=blk_cnt. */
+
+static inline ulong
+SORT_(private_para_blk)( ulong cnt,
+                         ulong blk,
+                         ulong blk_cnt ) {
+  if( FD_UNLIKELY( blk>=blk_cnt ) ) return cnt;
+  ulong b0; ulong b1; FD_TPOOL_PARTITION( 0UL,cnt,1UL, blk,blk_cnt, b0,b1 ); (void)b1;
+  return b0;
+}
+
+/* SORT_(private_para_corank) returns the number of keys in a[0,na)
+   among the first k keys output by a stable merge of sorted a[0,na)
+   with sorted b[0,nb) (the merge takes from a on ties).  Assumes k is
+   in [0,na+nb].  O(lg min(na,nb,k)). */
+
+static SORT_IDX_T
+SORT_(private_para_corank)( SORT_KEY_T const * a,
+                            SORT_IDX_T         na,
+                            SORT_KEY_T const * b,
+                            SORT_IDX_T         nb,
+                            SORT_IDX_T         k ) {
+  SORT_IDX_T lo = SORT_IDX_IF( k>nb, k-nb, (SORT_IDX_T)0 );
+  SORT_IDX_T hi = SORT_IDX_IF( k<na, k,    na            );
+  while( lo<hi ) {
+    SORT_IDX_T i = (SORT_IDX_T)(lo + ((hi-lo)>>1)); /* In [lo,hi) so i<na and k-i>0 */
+    SORT_IDX_T j = (SORT_IDX_T)(k - i);
+    /* If a[i] does not go after b[j-1] in the merge, we need more of a */
+    if( !(SORT_BEFORE( b[j-((SORT_IDX_T)1)], a[i] )) ) lo = (SORT_IDX_T)(i+((SORT_IDX_T)1));
+    else                                               hi = i;
+  }
+  return lo;
+}
+
+/* SORT_(private_para_merge_slice) stably merges a[0,na) and b[0,nb)
+   into out.  Either input can be empty. */
+
+static void
+SORT_(private_para_merge_slice)( SORT_KEY_T const * a,
+                                 SORT_IDX_T         na,
+                                 SORT_KEY_T const * b,
+                                 SORT_IDX_T         nb,
+                                 SORT_KEY_T *       out ) {
+  SORT_IDX_T i = ((SORT_IDX_T)0);
+  SORT_IDX_T j = ((SORT_IDX_T)0);
+  while( (i<na) & (j<nb) ) {
+    if( SORT_BEFORE( b[j], a[i] ) ) *out++ = b[j++];
+    else                            *out++ = a[i++];
+  }
+  while( i<na ) *out++ = a[i++];
+  while( j<nb ) *out++ = b[j++];
+}
+
+struct SORT_(private_para_args) {
+  SORT_KEY_T * key;     /* Keys to sort */
+  SORT_KEY_T * tmp;     /* Scratch */
+  SORT_KEY_T * src;     /* Merge round input (key or tmp) */
+  SORT_KEY_T * dst;     /* Merge round output (the other one) */
+  ulong        blk_cnt; /* Number of blocks (==number of workers) */
+  ulong        width;   /* Merge round width (in blocks) */
+  int          stable;
+};
+
+/* SORT_(private_para_block) sorts the worker's block [m0,m1) of key
+   (leaving the result in key). */
+
+static void
+SORT_(private_para_block)( void * tpool,
+                           ulong  t0,     ulong t1,
+                           void * _args,
+                           void * reduce, ulong stride,
+                           ulong  l0,     ulong l1,
+                           ulong  m0,     ulong m1,
+                           ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)reduce; (void)stride; (void)l0; (void)l1; (void)n0; (void)n1;
+  struct SORT_(private_para_args) const * args = (struct SORT_(private_para_args) const *)_args;
+
+  SORT_KEY_T * key = args->key + m0;
+  SORT_IDX_T   cnt = (SORT_IDX_T)(m1-m0);
+  if( args->stable ) {
+    SORT_KEY_T * tmp = args->tmp + m0;
+    if( SORT_(private_merge)( key, cnt, tmp )==tmp ) for( SORT_IDX_T i=((SORT_IDX_T)0); i<cnt; i++ ) key[i] = tmp[i];
+  } else {
+    SORT_(private_quick)( key, cnt );
+  }
+}
+
+/* SORT_(private_para_merge) does the worker's share [m0,m1) of the
+   output of a merge round.  Pairs of adjacent runs of width blocks in
+   src are merged into dst.  The worker's share can span several pair
+   merges (or a fraction of one) so the worker finds where its share
+   starts and ends in each pair's inputs by binary search (co-ranking). */
+
+static void
+SORT_(private_para_merge)( void * tpool,
+                           ulong  t0,     ulong t1,
+                           void * _args,
+                           void * reduce, ulong stride,
+                           ulong  l0,     ulong l1,
+                           ulong  m0,     ulong m1,
+                           ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)reduce; (void)stride; (void)l0; (void)n0; (void)n1;
+  struct SORT_(private_para_args) const * args = (struct SORT_(private_para_args) const *)_args;
+
+  SORT_KEY_T const * src     = args->src;
+  SORT_KEY_T *       dst     = args->dst;
+  ulong              cnt     = l1;
+  ulong              blk_cnt = args->blk_cnt;
+  ulong              width   = args->width;
+
+  for( ulong blk=0UL; blk<blk_cnt; blk+=2UL*width ) {
+    ulong p0 = SORT_(private_para_blk)( cnt, blk,                                   blk_cnt );
+    ulong pm = SORT_(private_para_blk)( cnt, fd_ulong_min( blk+    width, blk_cnt ), blk_cnt );
+    ulong p1 = SORT_(private_para_blk)( cnt, fd_ulong_min( blk+2UL*width, blk_cnt ), blk_cnt );
+    if( p1<=m0 ) continue;
+    if( p0>=m1 ) break;
+
+    SORT_KEY_T const * a  = src + p0;
+    SORT_IDX_T         na = (SORT_IDX_T)(pm-p0);
+    SORT_KEY_T const * b  = src + pm;
+    SORT_IDX_T         nb = (SORT_IDX_T)(p1-pm);
+
+    SORT_IDX_T k0 = (SORT_IDX_T)(fd_ulong_max( m0, p0 ) - p0);
+    SORT_IDX_T k1 = (SORT_IDX_T)(fd_ulong_min( m1, p1 ) - p0);
+    SORT_IDX_T i0 = SORT_(private_para_corank)( a,na, b,nb, k0 );
+    SORT_IDX_T i1 = SORT_(private_para_corank)( a,na, b,nb, k1 );
+
+    SORT_(private_para_merge_slice)( a + i0,      (SORT_IDX_T)(i1-i0),
+                                     b + (k0-i0), (SORT_IDX_T)((k1-i1)-(k0-i0)), dst + p0 + (ulong)k0 );
+  }
+}
+
+/* SORT_(private_para_copy) copies the worker's share [m0,m1) of tmp
+   to key. */
+
+static void
+SORT_(private_para_copy)( void * tpool,
+                          ulong  t0,     ulong t1,
+                          void * _args,
+                          void * reduce, ulong stride,
+                          ulong  l0,     ulong l1,
+                          ulong  m0,     ulong m1,
+                          ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)reduce; (void)stride; (void)l0; (void)l1; (void)n0; (void)n1;
+  struct SORT_(private_para_args) const * args = (struct SORT_(private_para_args) const *)_args;
+
+  SORT_KEY_T *       key = args->key;
+  SORT_KEY_T const * tmp = args->tmp;
+  for( ulong i=m0; i<m1; i++ ) key[i] = tmp[i];
+}
+
+SORT_IMPL_STATIC SORT_KEY_T *
+SORT_(private_para)( fd_tpool_t * tpool,
+                     ulong        t0,
+                     ulong        t1,
+                     SORT_KEY_T * key,
+                     SORT_IDX_T   cnt,
+                     SORT_KEY_T * tmp,
+                     int          stable,
+                     int          to_key ) {
+  ulong blk_cnt = t1 - t0;
+
+  /* If not worth going parallel, use the single threaded sorts */
+
+  if( blk_cnt<2UL || (ulong)cnt<blk_cnt*(ulong)(SORT_PARALLEL_THRESH) ) {
+    if( !stable ) return SORT_(private_quick)( key, cnt );
+    SORT_KEY_T * out = SORT_(private_merge)( key, cnt, tmp );
+    if( to_key && out==tmp ) for( SORT_IDX_T i=((SORT_IDX_T)0); i<cnt; i++ ) key[i] = tmp[i];
+    return to_key ? key : out;
+  }
+
+  /* Sort the blocks and then merge them in ceil(lg blk_cnt) rounds
+     ping-ponging between key and tmp. */
+
+  struct SORT_(private_para_args) args[1];
+  args->key     = key;
+  args->tmp     = tmp;
+  args->blk_cnt = blk_cnt;
+  args->stable  = stable;
+
+  fd_tpool_exec_all_batch( tpool, t0,t1, SORT_(private_para_block), NULL, args, NULL,0UL, 0UL,(ulong)cnt );
+
+  SORT_KEY_T * src = key;
+  SORT_KEY_T * dst = tmp;
+  for( ulong width=1UL; width<blk_cnt; width<<=1 ) {
+    args->src   = src;
+    args->dst   = dst;
+    args->width = width;
+    fd_tpool_exec_all_batch( tpool, t0,t1, SORT_(private_para_merge), NULL, args, NULL,0UL, 0UL,(ulong)cnt );
+    SORT_KEY_T * t = src; src = dst; dst = t;
+  }
+
+  if( to_key && src==tmp ) {
+    fd_tpool_exec_all_batch( tpool, t0,t1, SORT_(private_para_copy), NULL, args, NULL,0UL, 0UL,(ulong)cnt );
+    src = key;
+  }
+
+  return src;
+}
+
+#endif /* SORT_PARALLEL */
+
 #undef SORT_IMPL_STATIC
 
 #endif
@@ -611,10 +891,43 @@ SORT_(select)( SORT_KEY_T * key,
   return SORT_(private_select)( key, cnt, rnk );
 }
 
+#if SORT_PARALLEL
+
+static inline SORT_KEY_T *
+SORT_(para_fast)( fd_tpool_t * tpool,
+                  ulong        t0,
+                  ulong        t1,
+                  SORT_KEY_T * key,
+                  SORT_IDX_T   cnt,
+                  void *       scratch,
+                  int          stable ) {
+  return SORT_(private_para)( tpool, t0, t1, key, cnt, (SORT_KEY_T *)scratch, stable, 0 );
+}
+
+FD_FN_UNUSED static SORT_KEY_T * /* Work around -Winline */
+SORT_(para)( fd_tpool_t * tpool,
+             ulong        t0,
+             ulong        t1,
+             SORT_KEY_T * key,
+             SORT_IDX_T   cnt,
+             void *       scratch,
+             int          stable ) {
+  if( FD_LIKELY( scratch ) ) return SORT_(private_para)( tpool, t0, t1, key, cnt, (SORT_KEY_T *)scratch, stable, 1 );
+  fd_scratch_push();
+  SORT_KEY_T * tmp = (SORT_KEY_T *)fd_scratch_alloc( SORT_(stable_scratch_align)(), SORT_(stable_scratch_footprint)( cnt ) );
+  SORT_(private_para)( tpool, t0, t1, key, cnt, tmp, stable, 1 );
+  fd_scratch_pop();
+  return key;
+}
+
+#endif
+
 #endif
 
 #undef SORT_
 
+#undef SORT_PARALLEL_THRESH
+#undef SORT_PARALLEL
 #undef SORT_IDX_IF
 #undef SORT_IMPL_STYLE
 #undef SORT_QUICK_SWAP_MINIMIZE
@@ -0,0 +1,471 @@
+/* Declares a family of functions useful for single threaded stable
+   sorting of unsigned integer keys (uint or ulong), optionally with a
+   payload, in high performance contexts.  Unlike fd_sort.c, this is not
+   comparison based.  It uses a least significant digit radix sort (8
+   bit digits) that skips digits that are the same for all keys (so,
+   e.g., sorting small integers stored in ulongs only costs as much as
+   the number of digits actually in use).  Sorts too small to amortize
+   the radix passes use a merge sort.  On targets with FD_HAS_AVX,
+   finding the digits in use is vectorized and, for key only sorts, the
+   merge sort leaves (up to 16 keys) are done with an in-register
+   sorting network.  Example usage:
+
+     #define SORT_NAME  sort_tag
+     #define SORT_KEY_T ulong
+     #include "util/tmpl/fd_sort_radix.c"
+
+   will create the following API for use in the local compile unit:
+
+     // Return the alignment and footprint required for a scratch region
+     // adequate for sorting up to cnt elements.
+
+     ulong sort_tag_scratch_align    ( void      );
+     ulong sort_tag_scratch_footprint( ulong cnt );
+
+     // Sort key[i] for i in [0,cnt) ascending and stable in O(N D)
+     // operations where D is the number of 8 bit digits that differ
+     // between keys.  Scratch is a scratch workspace of suitable
+     // alignment and footprint.  Returns where the sorted values ended
+     // up.  Will be at either key or (ulong *)scratch.
+
+     ulong *
+     sort_tag_stable_fast( ulong * key,
+                           ulong   cnt,
+                           void *  scratch );
+
+     // Same as above but does additional copying if necessary such that
+     // the final result ends up in key.  Returns key.
+
+     ulong *
+     sort_tag_stable( ulong * key,
+                      ulong   cnt,
+                      void *  scratch );
+
+   If SORT_VAL_T is defined (e.g. "#define SORT_VAL_T myval_t" where
+   myval_t is a POD type), each key has a payload that is moved along
+   with it and the sorting API is instead:
+
+     // Sort key[i] for i in [0,cnt) as above, moving val[i] along with
+     // key[i].  The result ends up in key and val.  Returns key.
+
+     ulong *
+     sort_tag_stable( ulong *   key,
+                      myval_t * val,
+                      ulong     cnt,
+                      void *    scratch );
+
+   (The scratch footprint accounts for the payloads in this case.)
+
+   It is fine to include this template multiple times in a compilation
+   unit.  Just provide the specification before each inclusion. */
+
+#include "../bits/fd_bits.h"
+
+#if FD_HAS_AVX
+#include "../simd/fd_avx.h"
+#endif
+
+/* SORT_NAME gives the name of the function to declare (and the base
+   name of auxiliary and/or variant functions). */
+
+#ifndef SORT_NAME
+#error "SORT_NAME must be defined"
+#endif
+
+/* SORT_KEY_T gives the key type to sort.  Should be uint or ulong. */
+
+#ifndef SORT_KEY_T
+#error "SORT_KEY_T must be defined"
+#endif
+
+/* SORT_RADIX_THRESH gives the smallest number of keys per radix pass
+   where radix sort will be used.  Smaller sorts are done with a merge
+   sort (the fixed per pass costs of radix sort dominate otherwise).  As
+   the number of passes depends on how many digits vary between the
+   keys, this adapts to the keys (e.g. with the default, 64-bit keys
+   that differ in all digits use radix sort from 2048 keys while keys
+   that only differ in the low 16 bits use radix sort from 512 keys). */
+
+#ifndef SORT_RADIX_THRESH
+#define SORT_RADIX_THRESH 256
+#endif
+
+/**********************************************************************/
+
+#define SORT_(x)FD_EXPAND_THEN_CONCAT3(SORT_NAME,_,x)
+
+#ifdef SORT_VAL_T
+#define SORT_PRIVATE_VAL_T         SORT_VAL_T
+#define SORT_PRIVATE_VAL_ADD(p,n) ((p)+(n))
+#else
+#define SORT_PRIVATE_VAL_T         uchar /* unused */
+#define SORT_PRIVATE_VAL_ADD(p,n) (p)
+#endif
+
+FD_STATIC_ASSERT( sizeof(SORT_KEY_T)==4UL || sizeof(SORT_KEY_T)==8UL, unsupported_sort_key_t );
+
+FD_FN_CONST static inline ulong
+SORT_(private_val_off)( ulong cnt ) {
+  return fd_ulong_align_up( sizeof(SORT_KEY_T)*cnt, alignof(SORT_PRIVATE_VAL_T) );
+}
+
+#if !FD_HAS_AVX || defined(SORT_VAL_T) /* Otherwise, the network is used for small sorts */
+
+static void
+SORT_(private_insert)( SORT_KEY_T *         key,
+                       SORT_PRIVATE_VAL_T * val,
+                       ulong                cnt ) {
+  (void)val;
+  for( ulong i=1UL; i<cnt; i++ ) {
+    SORT_KEY_T key_i = key[i];
+#   ifdef SORT_VAL_T
+    SORT_VAL_T val_i = val[i];
+#   endif
+    ulong j = i;
+    while( j ) {
+      ulong k = j - 1UL;
+      SORT_KEY_T key_j = key[k]; if( !(key_i<key_j) ) break;
+      key[j] = key_j;
+#     ifdef SORT_VAL_T
+      val[j] = val[k];
+#     endif
+      j = k;
+    }
+    key[j] = key_i;
+#   ifdef SORT_VAL_T
+    val[j] = val_i;
+#   endif
+  }
+}
+
+#endif
+
+#if FD_HAS_AVX && !defined(SORT_VAL_T)
+
+/* The network works on keys widened to 64 bits with the sign bit
+   flipped such that unsigned order is signed order (AVX2 only has a
+   signed 64-bit compare). */
+
+/* SORT_(private_clean4) sorts the bitonic sequence in the lanes of x
+   (two half cleaner stages done in register).  Each stage takes the
+   partner lane where the partner is smaller (lower lanes) or larger
+   (upper lanes). */
+
+static inline wl_t
+SORT_(private_clean4)( wl_t x ) {
+  wl_t y = wl_permute( x, 2,3,0,1 ); x = wl_if( wc_xor( wl_gt( x, y ), wc_bcast_wide( 0,0,1,1 ) ), y, x );
+  /**/ y = wl_permute( x, 1,0,3,2 ); x = wl_if( wc_xor( wl_gt( x, y ), wc_bcast_wide( 0,1,0,1 ) ), y, x );
+  return x;
+}
+
+/* SORT_PRIVATE_CE does a lane wise compare exchange such that a holds
+   the smaller and b holds the larger of each lane. */
+
+#define SORT_PRIVATE_CE(a,b) do {                    \
+    wc_t _c = wl_gt( (a), (b) );                     \
+    wl_t _t = wl_if( _c, (b), (a) );                 \
+    (b)     = wl_if( _c, (a), (b) );                 \
+    (a)     = _t;                                    \
+  } while(0)
+
+/* SORT_(private_network) sorts key[i] for i in [0,cnt) with cnt<=16
+   using a bitonic sorting network over four 4 lane registers (unused
+   lanes are padded with the largest key).  This is not stable but key
+   only sorts can't tell. */
+
+static void
+SORT_(private_network)( SORT_KEY_T * key,
+                        ulong        cnt ) {
+  long buf[ 16 ] __attribute__((aligned(32)));
+  for( ulong i=0UL; i<cnt;  i++ ) buf[i] = (long)(((ulong)key[i]) ^ (1UL<<63));
+  for( ulong i=cnt; i<16UL; i++ ) buf[i] = LONG_MAX;
+
+  wl_t r0 = wl_ld( buf      );
+  wl_t r1 = wl_ld( buf+ 4UL );
+  wl_t r2 = wl_ld( buf+ 8UL );
+  wl_t r3 = wl_ld( buf+12UL );
+
+  /* Sort the columns and transpose such that each register holds a
+     sorted run of 4 */
+
+  SORT_PRIVATE_CE( r0, r1 ); SORT_PRIVATE_CE( r2, r3 );
+  SORT_PRIVATE_CE( r0, r2 ); SORT_PRIVATE_CE( r1, r3 );
+  SORT_PRIVATE_CE( r1, r2 );
+  wl_transpose_4x4( r0,r1,r2,r3, r0,r1,r2,r3 );
+
+  /* Merge runs of 4 into runs of 8 (r0,r1) and (r2,r3) */
+
+  r1 = wl_permute( r1, 3,2,1,0 ); SORT_PRIVATE_CE( r0, r1 ); r0 = SORT_(private_clean4)( r0 ); r1 = SORT_(private_clean4)( r1 );
+  r3 = wl_permute( r3, 3,2,1,0 ); SORT_PRIVATE_CE( r2, r3 ); r2 = SORT_(private_clean4)( r2 ); r3 = SORT_(private_clean4)( r3 );
+
+  /* Merge the runs of 8 into a run of 16 */
+
+  wl_t t = wl_permute( r3, 3,2,1,0 ); r3 = wl_permute( r2, 3,2,1,0 ); r2 = t;
+  SORT_PRIVATE_CE( r0, r2 ); SORT_PRIVATE_CE( r1, r3 );
+  SORT_PRIVATE_CE( r0, r1 ); SORT_PRIVATE_CE( r2, r3 );
+  r0 = SORT_(private_clean4)( r0 ); r1 = SORT_(private_clean4)( r1 );
+  r2 = SORT_(private_clean4)( r2 ); r3 = SORT_(private_clean4)( r3 );
+
+  wl_st( buf,      r0 );
+  wl_st( buf+ 4UL, r1 );
+  wl_st( buf+ 8UL, r2 );
+  wl_st( buf+12UL, r3 );
+  for( ulong i=0UL; i<cnt; i++ ) key[i] = (SORT_KEY_T)(((ulong)buf[i]) ^ (1UL<<63));
+}
+
+#undef SORT_PRIVATE_CE
+
+#endif
+
+/* SORT_(private_leaf) sorts key[i] (and val[i]) for i in [0,cnt) with
+   cnt<=16 in place. */
+
+static inline void
+SORT_(private_leaf)( SORT_KEY_T *         key,
+                     SORT_PRIVATE_VAL_T * val,
+                     ulong                cnt ) {
+# if FD_HAS_AVX && !defined(SORT_VAL_T)
+  (void)val;
+  SORT_(private_network)( key, cnt );
+# else
+  SORT_(private_insert)( key, val, cnt );
+# endif
+}
+
+/* SORT_(private_merge) stable merge sorts key[i] (and val[i]) for i in
+   [0,cnt) using tkey (and tval) as scratch.  Returns where the sorted
+   keys ended up (key or tkey).  The sorted vals will be in the
+   corresponding location.  Same structure as fd_sort.c's. */
+
+static SORT_KEY_T *
+SORT_(private_merge)( SORT_KEY_T *         key,
+                      SORT_PRIVATE_VAL_T * val,
+                      ulong                cnt,
+                      SORT_KEY_T *         tkey,
+                      SORT_PRIVATE_VAL_T * tval ) {
+  (void)val; (void)tval;
+
+  if( cnt<=16UL ) { SORT_(private_leaf)( key, val, cnt ); return key; }
+
+  ulong        cnt_left  = cnt >> 1;
+  ulong        cnt_right = cnt - cnt_left;
+  SORT_KEY_T * out_left  = SORT_(private_merge)( key,          SORT_PRIVATE_VAL_ADD( val,  0UL      ), cnt_left,
+                                                 tkey,         SORT_PRIVATE_VAL_ADD( tval, 0UL      ) );
+  SORT_KEY_T * out_right = SORT_(private_merge)( key+cnt_left, SORT_PRIVATE_VAL_ADD( val,  cnt_left ), cnt_right,
+                                                 tkey+cnt_left, SORT_PRIVATE_VAL_ADD( tval, cnt_left ) );
+
+  /* Merge into whichever of key / tkey out_left is not in (as in
+     fd_sort.c, out_right might overlap the right half of the output
+     but the merge never writes past where it reads) */
+
+  SORT_KEY_T * out = (out_left==key) ? tkey : key;
+# ifdef SORT_VAL_T
+  SORT_VAL_T * val_left  = (out_left ==key         ) ? val          : tval;
+  SORT_VAL_T * val_right = (out_right==key+cnt_left) ? val+cnt_left : tval+cnt_left;
+  SORT_VAL_T * val_out   = (out      ==key         ) ? val          : tval;
+# endif
+
+  ulong i = 0UL;
+  ulong j = 0UL;
+  ulong k = 0UL;
+  for(;;) { /* Note that cnt_left>0 and cnt_right>0 at this point */
+    if( out_right[k]<out_left[j] ) {
+#     ifdef SORT_VAL_T
+      val_out[i] = val_right[k];
+#     endif
+      out[i++] = out_right[k++];
+      if( k>=cnt_right ) break;
+    } else {
+#     ifdef SORT_VAL_T
+      val_out[i] = val_left[j];
+#     endif
+      out[i++] = out_left[j++];
+      if( j>=cnt_left ) break;
+    }
+  }
+  while( j<cnt_left  ) {
+#   ifdef SORT_VAL_T
+    val_out[i] = val_left[j];
+#   endif
+    out[i++] = out_left[j++];
+  }
+  while( k<cnt_right ) {
+#   ifdef SORT_VAL_T
+    val_out[i] = val_right[k];
+#   endif
+    out[i++] = out_right[k++];
+  }
+  return out;
+}
+
+/* SORT_(private_diff) returns the OR of key[i]^key[0] for i in [0,cnt)
+   (i.e. bit b is set if not all keys have the same bit b).  Assumes
+   cnt is positive. */
+
+static ulong
+SORT_(private_diff)( SORT_KEY_T const * key,
+                     ulong              cnt ) {
+  ulong k0   = (ulong)key[0];
+  ulong diff = 0UL;
+  ulong i    = 0UL;
+# if FD_HAS_AVX
+  if( sizeof(SORT_KEY_T)==8UL ) {
+    wv_t vk0  = wv_bcast( k0 );
+    wv_t acc0 = wv_zero();
+    wv_t acc1 = wv_zero();
+    for( ; i+8UL<=cnt; i+=8UL ) {
+      acc0 = wv_or( acc0, wv_xor( wv_ldu( (ulong const *)(key+i)     ), vk0 ) );
+      acc1 = wv_or( acc1, wv_xor( wv_ldu( (ulong const *)(key+i+4UL) ), vk0 ) );
+    }
+    acc0 = wv_or( acc0, acc1 );
+    diff = wv_extract( acc0, 0 ) | wv_extract( acc0, 1 ) | wv_extract( acc0, 2 ) | wv_extract( acc0, 3 );
+  } else {
+    wu_t vk0  = wu_bcast( (uint)k0 );
+    wu_t acc0 = wu_zero();
+    wu_t acc1 = wu_zero();
+    for( ; i+16UL<=cnt; i+=16UL ) {
+      acc0 = wu_or( acc0, wu_xor( wu_ldu( (uint const *)(key+i)     ), vk0 ) );
+      acc1 = wu_or( acc1, wu_xor( wu_ldu( (uint const *)(key+i+8UL) ), vk0 ) );
+    }
+    acc0 = wu_or( acc0, acc1 );
+    acc0 = wu_or( acc0, _mm256_permute2f128_si256( acc0, acc0, 1 ) );
+    diff = (ulong)( wu_extract( acc0, 0 ) | wu_extract( acc0, 1 ) | wu_extract( acc0, 2 ) | wu_extract( acc0, 3 ) );
+  }
+# endif
+  for( ; i<cnt; i++ ) diff |= ((ulong)key[i]) ^ k0;
+  return diff;
+}
+
+/* SORT_(private_radix) sorts key[i] (and val[i]) for i in [0,cnt) by
+   the pass_cnt digits at bit offsets shift[p] (least significant
+   first), ping-ponging between key / tkey (and val / tval) once for
+   each pass.  Returns where the sorted keys ended up (key or tkey).  The
+   sorted vals will be in the corresponding location. */
+
+static SORT_KEY_T *
+SORT_(private_radix)( SORT_KEY_T *         key,
+                      SORT_PRIVATE_VAL_T * val,
+                      ulong                cnt,
+                      SORT_KEY_T *         tkey,
+                      SORT_PRIVATE_VAL_T * tval,
+                      int const *          shift,
+                      ulong                pass_cnt ) {
+  (void)val; (void)tval;
+
+  /* Histogram all the digits in use in one pass over the keys */
+
+  ulong hist[ 8 ][ 256 ];
+  memset( hist, 0, pass_cnt*sizeof(hist[0]) );
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong k = (ulong)key[i];
+    for( ulong p=0UL; p<pass_cnt; p++ ) hist[ p ][ (k>>shift[p]) & 255UL ]++;
+  }
+
+  /* Scatter by each digit in turn */
+
+  SORT_KEY_T *         src_key = key;
+  SORT_KEY_T *         dst_key = tkey;
+  SORT_PRIVATE_VAL_T * src_val = val;
+  SORT_PRIVATE_VAL_T * dst_val = tval;
+  for( ulong p=0UL; p<pass_cnt; p++ ) {
+    ulong * h   = hist[ p ];
+    ulong   sum = 0UL;
+    for( ulong b=0UL; b<256UL; b++ ) { ulong c = h[b]; h[b] = sum; sum += c; }
+
+    int s = shift[p];
+    for( ulong i=0UL; i<cnt; i++ ) {
+      SORT_KEY_T k = src_key[i];
+      ulong      o = h[ (((ulong)k)>>s) & 255UL ]++;
+      dst_key[o] = k;
+#     ifdef SORT_VAL_T
+      dst_val[o] = src_val[i];
+#     endif
+    }
+
+    SORT_KEY_T *         t_key = src_key; src_key = dst_key; dst_key = t_key;
+    SORT_PRIVATE_VAL_T * t_val = src_val; src_val = dst_val; dst_val = t_val;
+  }
+
+  return src_key;
+}
+
+static SORT_KEY_T *
+SORT_(private_sort)( SORT_KEY_T *         key,
+                     SORT_PRIVATE_VAL_T * val,
+                     ulong                cnt,
+                     void *               scratch ) {
+  if( cnt<=16UL ) { SORT_(private_leaf)( key, val, cnt ); return key; }
+
+  SORT_KEY_T *         tkey = (SORT_KEY_T *)scratch;
+  SORT_PRIVATE_VAL_T * tval = (SORT_PRIVATE_VAL_T *)((ulong)scratch + SORT_(private_val_off)( cnt ));
+
+  /* Find the digits in use */
+
+  ulong diff = SORT_(private_diff)( key, cnt );
+  int   shift[ 8 ];
+  ulong pass_cnt = 0UL;
+  for( int s=0; s<8*(int)sizeof(SORT_KEY_T); s+=8 ) if( (diff>>s) & 255UL ) shift[ pass_cnt++ ] = s;
+  if( FD_UNLIKELY( !pass_cnt ) ) return key; /* All keys the same */
+
+  if( cnt<pass_cnt*(ulong)(SORT_RADIX_THRESH) ) return SORT_(private_merge)( key, val, cnt, tkey, tval );
+  return SORT_(private_radix)( key, val, cnt, tkey, tval, shift, pass_cnt );
+}
+
+FD_FN_CONST static inline ulong
+SORT_(scratch_align)( void ) {
+  return fd_ulong_max( alignof(SORT_KEY_T), alignof(SORT_PRIVATE_VAL_T) );
+}
+
+FD_FN_CONST static inline ulong
+SORT_(scratch_footprint)( ulong cnt ) {
+# ifdef SORT_VAL_T
+  return SORT_(private_val_off)( cnt ) + sizeof(SORT_VAL_T)*cnt;
+# else
+  return sizeof(SORT_KEY_T)*cnt;
+# endif
+}
+
+#ifdef SORT_VAL_T
+
+FD_FN_UNUSED static SORT_KEY_T * /* Work around -Winline */
+SORT_(stable)( SORT_KEY_T * key,
+               SORT_VAL_T * val,
+               ulong        cnt,
+               void *       scratch ) {
+  if( SORT_(private_sort)( key, val, cnt, scratch )!=key ) {
+    SORT_KEY_T const * tkey = (SORT_KEY_T const *)scratch;
+    SORT_VAL_T const * tval = (SORT_VAL_T const *)((ulong)scratch + SORT_(private_val_off)( cnt ));
+    for( ulong i=0UL; i<cnt; i++ ) key[i] = tkey[i];
+    for( ulong i=0UL; i<cnt; i++ ) val[i] = tval[i];
+  }
+  return key;
+}
+
+#else
+
+static inline SORT_KEY_T *
+SORT_(stable_fast)( SORT_KEY_T * key,
+                    ulong        cnt,
+                    void *       scratch ) {
+  return SORT_(private_sort)( key, NULL, cnt, scratch );
+}
+
+FD_FN_UNUSED static SORT_KEY_T * /* Work around -Winline */
+SORT_(stable)( SORT_KEY_T * key,
+               ulong        cnt,
+               void *       scratch ) {
+  SORT_KEY_T * out = SORT_(private_sort)( key, NULL, cnt, scratch );
+  if( out!=key ) for( ulong i=0UL; i<cnt; i++ ) key[i] = out[i];
+  return key;
+}
+
+#endif
+
+#undef SORT_PRIVATE_VAL_ADD
+#undef SORT_PRIVATE_VAL_T
+#undef SORT_
+
+#undef SORT_RADIX_THRESH
+#undef SORT_VAL_T
+#undef SORT_KEY_T
+#undef SORT_NAME
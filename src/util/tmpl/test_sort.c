@@ -15,6 +15,60 @@
 #define SORT_BEFORE(a,b) ((a)>(b))
 #include "fd_sort.c"
 
+/* Parallel variants.  A small SORT_PARALLEL_THRESH such that modest
+   sizes exercise the multiple worker code paths.  Keys carry their
+   original position to check stability. */
+
+struct pair {
+  uint val;
+  uint pos;
+};
+
+typedef struct pair pair_t;
+
+#define SORT_NAME            sort_pair
+#define SORT_KEY_T           pair_t
+#define SORT_BEFORE(a,b)     ((a).val<(b).val)
+#define SORT_PARALLEL        1
+#define SORT_PARALLEL_THRESH 4
+#include "fd_sort.c"
+
+#define PAIR_MAX (1UL<<16)
+
+static pair_t pair_ref[ PAIR_MAX ];
+static pair_t pair_tst[ PAIR_MAX ];
+static pair_t pair_tmp[ PAIR_MAX ];
+static uchar  pair_seen[ PAIR_MAX ];
+
+static uchar  scratch_smem[ sizeof(pair_t)*PAIR_MAX ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+static ulong  scratch_fmem[ 4 ]                       __attribute__((aligned(FD_SCRATCH_FMEM_ALIGN)));
+
+/* pair_check returns 1 if out holds a permutation of pair_ref[0,cnt)
+   (which has pos==idx) sorted by val */
+
+static int
+pair_check( pair_t const * out,
+            ulong          cnt ) {
+  memset( pair_seen, 0, cnt );
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong pos = (ulong)out[i].pos;
+    if( pos>=cnt || pair_seen[pos] || out[i].val!=pair_ref[pos].val ) return 0;
+    pair_seen[pos] = (uchar)1;
+    if( i && out[i].val<out[i-1UL].val ) return 0;
+  }
+  return 1;
+}
+
+/* pair_check_stable additionally checks equal vals kept their order */
+
+static int
+pair_check_stable( pair_t const * out,
+                   ulong          cnt ) {
+  if( !pair_check( out, cnt ) ) return 0;
+  for( ulong i=1UL; i<cnt; i++ ) if( out[i].val==out[i-1UL].val && out[i].pos<out[i-1UL].pos ) return 0;
+  return 1;
+}
+
 static TYPE *
 shuffle( fd_rng_t *   rng,
          TYPE *       y,
@@ -198,6 +252,53 @@ main( int     argc,
     FD_LOG_NOTICE(( "%lu: pass (cnt %lu)", trial, cnt ));
   }
 
+  ulong tile_cnt = fd_tile_cnt();
+
+  static uchar tpool_mem[ FD_TPOOL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tile_cnt ); FD_TEST( tpool );
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL )==tpool );
+
+  fd_scratch_attach( scratch_smem, scratch_fmem, sizeof(pair_t)*PAIR_MAX, 4UL );
+
+  for( ulong worker_cnt=1UL; worker_cnt<=tile_cnt; worker_cnt++ ) {
+    for( ulong trial=0UL; trial<100UL; trial++ ) {
+      ulong cnt = fd_rng_ulong( rng ) % (((trial & 15UL) ? 4096UL : PAIR_MAX) + 1UL);
+      ulong val_max = (fd_rng_ulong( rng ) % (cnt+1UL)) + 1UL; /* Lots of dups sometimes */
+      for( ulong i=0UL; i<cnt; i++ ) {
+        pair_ref[i].val = (uint)(fd_rng_ulong( rng ) % val_max);
+        pair_ref[i].pos = (uint)i;
+      }
+
+      memcpy( pair_tst, pair_ref, cnt*sizeof(pair_t) );
+      pair_t * out = sort_pair_para_fast( tpool, 0UL,worker_cnt, pair_tst, cnt, pair_tmp, 1 );
+      FD_TEST( (out==pair_tst) | (out==pair_tmp) );
+      FD_TEST( pair_check_stable( out, cnt ) );
+
+      memcpy( pair_tst, pair_ref, cnt*sizeof(pair_t) );
+      FD_TEST( sort_pair_para( tpool, 0UL,worker_cnt, pair_tst, cnt, pair_tmp, 1 )==pair_tst );
+      FD_TEST( pair_check_stable( pair_tst, cnt ) );
+
+      memcpy( pair_tst, pair_ref, cnt*sizeof(pair_t) );
+      FD_TEST( sort_pair_para( tpool, 0UL,worker_cnt, pair_tst, cnt, NULL, 1 )==pair_tst ); /* scratch from fd_scratch */
+      FD_TEST( pair_check_stable( pair_tst, cnt ) );
+
+      memcpy( pair_tst, pair_ref, cnt*sizeof(pair_t) );
+      out = sort_pair_para_fast( tpool, 0UL,worker_cnt, pair_tst, cnt, pair_tmp, 0 );
+      FD_TEST( (out==pair_tst) | (out==pair_tmp) );
+      FD_TEST( pair_check( out, cnt ) );
+
+      memcpy( pair_tst, pair_ref, cnt*sizeof(pair_t) );
+      FD_TEST( sort_pair_para( tpool, 0UL,worker_cnt, pair_tst, cnt, NULL, 0 )==pair_tst );
+      FD_TEST( pair_check( pair_tst, cnt ) );
+    }
+    FD_LOG_NOTICE(( "para: pass (worker_cnt %lu)", worker_cnt ));
+  }
+
+  FD_TEST( !fd_scratch_frame_used() );
+  fd_scratch_detach( NULL );
+
+  FD_TEST( fd_tpool_fini( tpool )==(void *)tpool_mem );
+
   fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
@@ -0,0 +1,153 @@
+#include "../fd_util.h"
+
+#define MAX (1UL<<16)
+
+/* References */
+
+#define SORT_NAME        ref_ulong
+#define SORT_KEY_T       ulong
+#include "fd_sort.c"
+
+#define SORT_NAME        ref_uint
+#define SORT_KEY_T       uint
+#include "fd_sort.c"
+
+/* Key only */
+
+#define SORT_NAME        sort_ulong
+#define SORT_KEY_T       ulong
+#include "fd_sort_radix.c"
+
+#define SORT_NAME        sort_uint
+#define SORT_KEY_T       uint
+#include "fd_sort_radix.c"
+
+/* Key and payload (the payload is the original position, used to check
+   stability) */
+
+struct pay {
+  ulong pos;
+  uint  tag;
+};
+
+typedef struct pay pay_t;
+
+#define SORT_NAME        sort_ulong_pay
+#define SORT_KEY_T       ulong
+#define SORT_VAL_T       pay_t
+#include "fd_sort_radix.c"
+
+#define SORT_NAME        sort_uint_pay
+#define SORT_KEY_T       uint
+#define SORT_VAL_T       pay_t
+#include "fd_sort_radix.c"
+
+static ulong ref_key[ MAX ];
+static ulong tst_key[ MAX ];
+static uint  ref_key32[ MAX ];
+static uint  tst_key32[ MAX ];
+static ulong org_key[ MAX ];
+static pay_t tst_val[ MAX ];
+
+static uchar scratch[ MAX*(sizeof(ulong)+sizeof(pay_t)) ] __attribute__((aligned(128)));
+
+/* rand_key returns a random key for distribution style dist:
+     0 - uniform over all 64 bits
+     1 - small range (low digits only)
+     2 - few distinct values (lots of ties)
+     3 - sparse digits (only some middle / high digits vary) */
+
+static ulong
+rand_key( fd_rng_t * rng,
+          int        dist ) {
+  ulong r = fd_rng_ulong( rng );
+  switch( dist ) {
+  case 1:  return r & 0xfffUL;
+  case 2:  return (r % 5UL) << 40;
+  case 3:  return r & 0xff00ff0000ff00UL;
+  default: break;
+  }
+  return r;
+}
+
+/* check_pay checks key[i],val[i] for i in [0,cnt) is a stable sort of
+   org_key (payload pos gives the original position) */
+
+static int
+check_pay( ulong const * key,
+           pay_t const * val,
+           ulong         cnt ) {
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong pos = val[i].pos;
+    if( pos>=cnt || key[i]!=ref_key[i] || val[i].tag!=(uint)(pos*3UL) ) return 0;
+    if( i && key[i]==key[i-1UL] && pos<=val[i-1UL].pos ) return 0;
+  }
+  return 1;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  FD_TEST( sort_ulong_scratch_footprint( MAX )<=sizeof(scratch) && sort_ulong_scratch_align()<=128UL );
+  FD_TEST( sort_uint_scratch_footprint ( MAX )<=sizeof(scratch) && sort_uint_scratch_align ()<=128UL );
+  FD_TEST( sort_ulong_pay_scratch_footprint( MAX )<=sizeof(scratch) && sort_ulong_pay_scratch_align()<=128UL );
+  FD_TEST( sort_uint_pay_scratch_footprint ( MAX )<=sizeof(scratch) && sort_uint_pay_scratch_align ()<=128UL );
+
+  for( ulong trial=0UL; trial<2000UL; trial++ ) {
+    ulong cnt  = (trial<512UL) ? (trial>>2) : (fd_rng_ulong( rng ) % (((trial & 15UL) ? 4096UL : MAX) + 1UL));
+    int   dist = (int)(trial & 3UL);
+
+    for( ulong i=0UL; i<cnt; i++ ) org_key[i] = rand_key( rng, dist );
+
+    /* ulong keys */
+
+    memcpy( ref_key, org_key, cnt*sizeof(ulong) );
+    FD_TEST( ref_ulong_stable( ref_key, cnt, tst_key )==ref_key );
+
+    memcpy( tst_key, org_key, cnt*sizeof(ulong) );
+    ulong * out = sort_ulong_stable_fast( tst_key, cnt, scratch );
+    FD_TEST( (out==tst_key) | (out==(ulong *)scratch) );
+    FD_TEST( !memcmp( out, ref_key, cnt*sizeof(ulong) ) );
+
+    memcpy( tst_key, org_key, cnt*sizeof(ulong) );
+    FD_TEST( sort_ulong_stable( tst_key, cnt, scratch )==tst_key );
+    FD_TEST( !memcmp( tst_key, ref_key, cnt*sizeof(ulong) ) );
+
+    memcpy( tst_key, org_key, cnt*sizeof(ulong) );
+    for( ulong i=0UL; i<cnt; i++ ) { tst_val[i].pos = i; tst_val[i].tag = (uint)(i*3UL); }
+    FD_TEST( sort_ulong_pay_stable( tst_key, tst_val, cnt, scratch )==tst_key );
+    FD_TEST( check_pay( tst_key, tst_val, cnt ) );
+
+    /* uint keys (use the low 32 bits) */
+
+    for( ulong i=0UL; i<cnt; i++ ) ref_key32[i] = (uint)(org_key[i] ^ (org_key[i]>>32));
+    memcpy( tst_key32, ref_key32, cnt*sizeof(uint) );
+    for( ulong i=0UL; i<cnt; i++ ) org_key[i] = (ulong)ref_key32[i];
+    FD_TEST( ref_uint_stable( ref_key32, cnt, scratch )==ref_key32 );
+
+    uint * out32 = sort_uint_stable_fast( tst_key32, cnt, scratch );
+    FD_TEST( (out32==tst_key32) | (out32==(uint *)scratch) );
+    FD_TEST( !memcmp( out32, ref_key32, cnt*sizeof(uint) ) );
+
+    for( ulong i=0UL; i<cnt; i++ ) tst_key32[i] = (uint)org_key[i];
+    FD_TEST( sort_uint_stable( tst_key32, cnt, scratch )==tst_key32 );
+    FD_TEST( !memcmp( tst_key32, ref_key32, cnt*sizeof(uint) ) );
+
+    for( ulong i=0UL; i<cnt; i++ ) { tst_key32[i] = (uint)org_key[i]; tst_val[i].pos = i; tst_val[i].tag = (uint)(i*3UL); }
+    FD_TEST( sort_uint_pay_stable( tst_key32, tst_val, cnt, scratch )==tst_key32 );
+    for( ulong i=0UL; i<cnt; i++ ) { ref_key[i] = (ulong)ref_key32[i]; tst_key[i] = (ulong)tst_key32[i]; }
+    FD_TEST( check_pay( tst_key, tst_val, cnt ) );
+
+    if( !(trial & 127UL) ) FD_LOG_NOTICE(( "%lu: pass (cnt %lu, dist %i)", trial, cnt, dist ));
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -1,4 +1,10 @@
 $(call add-hdrs,fd_tpool.h)
 $(call add-objs,fd_tpool,fd_util)
 $(call make-unit-test,test_tpool,test_tpool,fd_util)
+$(call make-unit-test,bench_tpool_numa,bench_tpool_numa,fd_util)
 
+$(call add-hdrs,fd_steal.h)
+$(call add-objs,fd_steal,fd_util)
+$(call make-unit-test,test_steal,test_steal,fd_util)
+$(call make-unit-test,bench_steal,bench_steal,fd_util)
+$(call run-unit-test,test_steal,)
@@ -0,0 +1,232 @@
+#include "../fd_util.h"
+
+/* bench_steal compares the scaling of fd_steal_for against the existing
+   fd_tpool_exec_all styles on parallel loops where the cost per item is
+   skewed:
+
+     flat    every item costs the same
+     ramp    item cost grows linearly with the item index (such that a
+             static block partition gives the last worker ~2x its fair
+             share when using 2 workers, more with more workers)
+     tail    item cost is heavy tailed (geometrically distributed with
+             rare items ~1000x the median cost and the expensive items
+             scattered randomly)
+
+   It also benches a recursive fork-join workload (naive fib) that has
+   no natural flat decomposition.  Run on a tile-cpus configuration with
+   several tiles (e.g. --tile-cpus 0-7) to see the scaling. */
+
+#if FD_HAS_ATOMIC
+
+#define ITEM_MAX (1UL<<20)
+
+static ulong sink[ ITEM_MAX ];
+
+#define SKEW_FLAT (0)
+#define SKEW_RAMP (1)
+#define SKEW_TAIL (2)
+#define SKEW_CNT  (3)
+
+static char const * skew_name[ SKEW_CNT ] = { "flat", "ramp", "tail" };
+
+struct bench_args {
+  int   skew;
+  ulong item_cnt;
+  ulong spin;
+};
+
+typedef struct bench_args bench_args_t;
+
+static inline ulong
+item_cost( bench_args_t const * args,
+           ulong                i ) {
+  ulong spin = args->spin;
+  switch( args->skew ) {
+  case SKEW_RAMP: return (2UL*spin*i) / args->item_cnt;
+  case SKEW_TAIL: return fd_ulong_max( spin >> 4, 1UL ) << fd_ulong_find_lsb( fd_ulong_hash( i ) | (1UL<<10) );
+  default:        break;
+  }
+  return spin;
+}
+
+static inline void
+item_do( bench_args_t const * args,
+         ulong                i ) {
+  ulong x = i;
+  for( ulong rem=item_cost( args, i ); rem; rem-- ) x = fd_ulong_hash( x );
+  sink[ i ] = x;
+}
+
+static void
+item_task( void * args,
+           ulong  i0,
+           ulong  i1 ) {
+  for( ulong i=i0; i<i1; i++ ) item_do( (bench_args_t const *)args, i );
+}
+
+static void
+item_tpool_task( void * tpool,
+                 ulong  t0,     ulong t1,
+                 void * args,
+                 void * reduce, ulong stride,
+                 ulong  l0,     ulong l1,
+                 ulong  m0,     ulong m1,
+                 ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)reduce; (void)stride; (void)l0; (void)l1; (void)n0; (void)n1;
+  item_task( args, m0, m1 );
+}
+
+/* fib */
+
+struct fib_job {
+  fd_steal_job_t job[1];
+  ulong          n;
+  ulong          res;
+};
+
+typedef struct fib_job fib_job_t;
+
+static ulong
+fib_serial( ulong n ) {
+  return n<2UL ? n : fib_serial( n-1UL ) + fib_serial( n-2UL );
+}
+
+static void
+fib_job( fd_steal_job_t * _job ) {
+  fib_job_t * f = (fib_job_t *)_job;
+  ulong       n = f->n;
+  if( n<16UL ) { f->res = fib_serial( n ); return; }
+  fib_job_t a[1]; a->job->fn = fib_job; a->n = n-1UL;
+  fd_steal_fork( a->job );
+  fib_job_t b[1]; b->job->fn = fib_job; b->n = n-2UL;
+  fib_job( b->job );
+  fd_steal_join( a->job );
+  f->res = a->res + b->res;
+}
+
+#define STYLE_BLOCK (0)
+#define STYLE_BATCH (1)
+#define STYLE_TASKQ (2)
+#define STYLE_STEAL (3)
+#define STYLE_CNT   (4)
+
+static char const * style_name[ STYLE_CNT ] = { "block", "batch", "taskq", "steal" };
+
+static void
+run( int            style,
+     fd_tpool_t *   tpool,
+     fd_steal_t *   steal,
+     ulong          worker_cnt,
+     bench_args_t * args,
+     ulong          grain ) {
+  switch( style ) {
+  case STYLE_BLOCK: fd_tpool_exec_all_block( tpool, 0UL,worker_cnt, item_tpool_task, NULL, args, NULL,0UL, 0UL,args->item_cnt ); break;
+  case STYLE_BATCH: fd_tpool_exec_all_batch( tpool, 0UL,worker_cnt, item_tpool_task, NULL, args, NULL,0UL, 0UL,args->item_cnt ); break;
+  case STYLE_TASKQ: fd_tpool_exec_all_taskq( tpool, 0UL,worker_cnt, item_tpool_task, NULL, args, NULL,0UL, 0UL,args->item_cnt ); break;
+  default:          fd_steal_for( steal, tpool, 0UL,worker_cnt, item_task, args, 0UL,args->item_cnt, grain );                 break;
+  }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong item_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--item-cnt", NULL, 65536UL );
+  ulong spin     = fd_env_strip_cmdline_ulong( &argc, &argv, "--spin",     NULL,    64UL );
+  ulong grain    = fd_env_strip_cmdline_ulong( &argc, &argv, "--grain",    NULL,    64UL );
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL,     8UL );
+  ulong fib_n    = fd_env_strip_cmdline_ulong( &argc, &argv, "--fib",      NULL,    30UL );
+
+  if( FD_UNLIKELY( !((1UL<=item_cnt) & (item_cnt<=ITEM_MAX)) ) ) FD_LOG_ERR(( "--item-cnt should be in [1,%lu]", ITEM_MAX ));
+  if( FD_UNLIKELY( !iter_cnt                                  ) ) FD_LOG_ERR(( "--iter-cnt should be positive" ));
+
+  ulong tile_cnt = fd_tile_cnt();
+
+  FD_LOG_NOTICE(( "Using --item-cnt %lu --spin %lu --grain %lu --iter-cnt %lu --fib %lu (tile_cnt %lu)",
+                  item_cnt, spin, grain, iter_cnt, fib_n, tile_cnt ));
+
+  static uchar tpool_mem[ FD_TPOOL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tile_cnt ); FD_TEST( tpool );
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL )==tpool );
+
+  static uchar steal_mem[ FD_STEAL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_STEAL_ALIGN)));
+  fd_steal_t * steal = fd_steal_init( steal_mem, tile_cnt ); FD_TEST( steal );
+
+  bench_args_t args[1];
+  args->item_cnt = item_cnt;
+  args->spin     = spin;
+
+  for( int skew=0; skew<SKEW_CNT; skew++ ) {
+    args->skew = skew;
+
+    FD_LOG_NOTICE(( "Benching %s", skew_name[ skew ] ));
+
+    /* Serial reference */
+
+    item_task( args, 0UL, item_cnt ); /* warmup */
+    long serial = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter++ ) { item_task( args, 0UL, item_cnt ); FD_COMPILER_MFENCE(); }
+    serial += fd_log_wallclock();
+    double serial_ns = (double)serial / (double)iter_cnt;
+    FD_LOG_NOTICE(( "%-6s %4lu workers %12.3f us", "serial", 1UL, 1e-3*serial_ns ));
+
+    for( ulong worker_cnt=1UL; worker_cnt<=tile_cnt; worker_cnt++ ) {
+      for( int style=0; style<STYLE_CNT; style++ ) {
+        run( style, tpool, steal, worker_cnt, args, grain ); /* warmup */
+        long elapsed = -fd_log_wallclock();
+        for( ulong iter=0UL; iter<iter_cnt; iter++ ) run( style, tpool, steal, worker_cnt, args, grain );
+        elapsed += fd_log_wallclock();
+        double dt = (double)elapsed / (double)iter_cnt;
+        if( style==STYLE_STEAL ) {
+          ulong steal_cnt = 0UL;
+          for( ulong worker_idx=0UL; worker_idx<worker_cnt; worker_idx++ ) steal_cnt += fd_steal_worker_steal_cnt( steal, worker_idx );
+          FD_LOG_NOTICE(( "%-6s %4lu workers %12.3f us (speedup %6.2f, %lu steals)", style_name[ style ], worker_cnt, 1e-3*dt,
+                          serial_ns/dt, steal_cnt ));
+        } else {
+          FD_LOG_NOTICE(( "%-6s %4lu workers %12.3f us (speedup %6.2f)", style_name[ style ], worker_cnt, 1e-3*dt, serial_ns/dt ));
+        }
+      }
+    }
+  }
+
+  FD_LOG_NOTICE(( "Benching fib(%lu)", fib_n ));
+
+  long  serial   = -fd_log_wallclock();
+  ulong expected = fib_serial( fib_n );
+  FD_COMPILER_MFENCE();
+  serial += fd_log_wallclock();
+  FD_LOG_NOTICE(( "%-6s %4lu workers %12.3f us", "serial", 1UL, 1e-3*(double)serial ));
+
+  for( ulong worker_cnt=1UL; worker_cnt<=tile_cnt; worker_cnt++ ) {
+    fib_job_t f[1]; f->job->fn = fib_job; f->n = fib_n;
+    long elapsed = -fd_log_wallclock();
+    fd_steal_exec( steal, tpool, 0UL,worker_cnt, f->job );
+    elapsed += fd_log_wallclock();
+    FD_TEST( f->res==expected );
+    ulong steal_cnt = 0UL;
+    for( ulong worker_idx=0UL; worker_idx<worker_cnt; worker_idx++ ) steal_cnt += fd_steal_worker_steal_cnt( steal, worker_idx );
+    FD_LOG_NOTICE(( "%-6s %4lu workers %12.3f us (speedup %6.2f, %lu steals)", "steal", worker_cnt, 1e-3*(double)elapsed,
+                    (double)serial/(double)elapsed, steal_cnt ));
+  }
+
+  FD_TEST( fd_steal_fini( steal )==(void *)steal_mem );
+  FD_TEST( fd_tpool_fini( tpool )==(void *)tpool_mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_ATOMIC capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -0,0 +1,222 @@
+#include "../fd_util.h"
+
+/* bench_tpool_numa compares flat vs hierarchical (numa aware)
+   partitioning of a memory bandwidth bound kernel (a STREAM style
+   triad a[i] = b[i] + s c[i]) over a tpool.  The arrays are split into
+   one segment per numa node spanned by the workers (as given by
+   fd_tpool_topo_node_partition) and each segment is allocated from
+   memory near that node.  The flat run uses fd_tpool_exec_all_batch in
+   worker index order (so workers can be assigned items whose memory is
+   on a remote node, depending on how --tile-cpus enumerated the cpus).
+   The hierarchical run uses fd_tpool_exec_all_numa (so workers only
+   touch node local memory).  To see a difference, run on a multi-socket
+   host with a --tile-cpus that interleaves the sockets (e.g. on a 2x8
+   core host with cores 0-7 on socket 0 and 8-15 on socket 1,
+   --tile-cpus 0,8,1,9,2,10,3,11). */
+
+#if FD_HAS_HOSTED && FD_HAS_X86
+
+struct seg {
+  double * a;
+  double * b;
+  double * c;
+  ulong    l0;       /* This segment holds items [l0,l1) */
+  ulong    l1;
+  ulong    page_cnt;
+  uchar    _pad[ 16 ];
+};
+
+typedef struct seg seg_t;
+
+struct bench {
+  seg_t * seg;
+  ulong   seg_cnt;
+  double  s;
+};
+
+typedef struct bench bench_t;
+
+/* triad does items [m0,m1), which might span multiple segments */
+
+static void
+triad( bench_t const * bench,
+       ulong           m0,
+       ulong           m1 ) {
+  double s = bench->s;
+  for( ulong g=0UL; g<bench->seg_cnt; g++ ) {
+    seg_t const * seg = bench->seg + g;
+    ulong         i0  = fd_ulong_max( m0, seg->l0 );
+    ulong         i1  = fd_ulong_min( m1, seg->l1 );
+    if( i0>=i1 ) continue;
+    double *       a = seg->a - seg->l0;
+    double const * b = seg->b - seg->l0;
+    double const * c = seg->c - seg->l0;
+    for( ulong i=i0; i<i1; i++ ) a[i] = b[i] + s*c[i];
+  }
+}
+
+static void
+triad_flat( void * tpool,
+            ulong  t0,     ulong t1,
+            void * args,
+            void * reduce, ulong stride,
+            ulong  l0,     ulong l1,
+            ulong  m0,     ulong m1,
+            ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)reduce; (void)stride; (void)l0; (void)l1; (void)n0; (void)n1;
+  triad( (bench_t const *)args, m0, m1 );
+}
+
+/* triad_numa uses its node's segment (passed via reduce) directly */
+
+static void
+triad_numa( void * tpool,
+            ulong  t0,     ulong t1,
+            void * args,
+            void * reduce, ulong stride,
+            ulong  l0,     ulong l1,
+            ulong  m0,     ulong m1,
+            ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)stride; (void)l0; (void)l1; (void)n0; (void)n1;
+  bench_t const * bench = (bench_t const *)args;
+  seg_t const *   seg   = (seg_t const *)reduce;
+  double          s     = bench->s;
+  double *        a     = seg->a - seg->l0;
+  double const *  b     = seg->b - seg->l0;
+  double const *  c     = seg->c - seg->l0;
+  for( ulong i=m0; i<m1; i++ ) a[i] = b[i] + s*c[i];
+}
+
+static void
+init_numa( void * tpool,
+           ulong  t0,     ulong t1,
+           void * args,
+           void * reduce, ulong stride,
+           ulong  l0,     ulong l1,
+           ulong  m0,     ulong m1,
+           ulong  n0,     ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)args; (void)stride; (void)l0; (void)l1; (void)n0; (void)n1;
+  seg_t const * seg = (seg_t const *)reduce;
+  double *      a   = seg->a - seg->l0;
+  double *      b   = seg->b - seg->l0;
+  double *      c   = seg->c - seg->l0;
+  for( ulong i=m0; i<m1; i++ ) { a[i] = 0.; b[i] = (double)i; c[i] = 1.; }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal"  );
+  ulong        n        = fd_env_strip_cmdline_ulong( &argc, &argv, "--n",        NULL, 1UL<<22  );
+  ulong        iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 16UL     );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz  ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+  if( FD_UNLIKELY( !n        ) ) FD_LOG_ERR(( "--n should be positive" ));
+  if( FD_UNLIKELY( !iter_cnt ) ) FD_LOG_ERR(( "--iter-cnt should be positive" ));
+
+  ulong tile_cnt = fd_tile_cnt();
+
+  FD_LOG_NOTICE(( "Using --page-sz %s --n %lu --iter-cnt %lu (tile_cnt %lu)", _page_sz, n, iter_cnt, tile_cnt ));
+
+  static uchar tpool_mem[ FD_TPOOL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tile_cnt ); FD_TEST( tpool );
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL )==tpool );
+
+  static fd_tpool_topo_t topo[1];
+  FD_TEST( fd_tpool_topo_init( topo, tpool, 0UL, tile_cnt ) );
+
+  /* Allocate each node's segment near the node */
+
+  static seg_t seg[ FD_TILE_MAX ];
+  bench_t bench[1];
+  bench->seg     = seg;
+  bench->seg_cnt = topo->node_cnt;
+  bench->s       = 3.;
+
+  for( ulong g=0UL; g<topo->node_cnt; g++ ) {
+    ulong l0; ulong l1; fd_tpool_topo_node_partition( topo, g, 0UL,n, &l0,&l1 );
+    ulong worker   = (ulong)topo->worker[ topo->node_pos[g] ];
+    ulong cpu_idx  = fd_tpool_worker_cpu_idx( tpool, worker );
+    if( FD_UNLIKELY( cpu_idx==ULONG_MAX ) ) cpu_idx = fd_tpool_worker_cpu_idx( tpool, 0UL ); /* floating, use the caller's */
+    if( FD_UNLIKELY( cpu_idx==ULONG_MAX ) ) cpu_idx = 0UL;
+    ulong arr_sz   = fd_ulong_align_up( fd_ulong_max( l1-l0, 1UL )*sizeof(double), page_sz );
+    ulong page_cnt = 3UL*arr_sz / page_sz;
+    uchar * mem = (uchar *)fd_shmem_acquire( page_sz, page_cnt, cpu_idx );
+    if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "fd_shmem_acquire failed" ));
+    seg[g].a        = (double *)mem;
+    seg[g].b        = (double *)(mem +     arr_sz);
+    seg[g].c        = (double *)(mem + 2UL*arr_sz);
+    seg[g].l0       = l0;
+    seg[g].l1       = l1;
+    seg[g].page_cnt = page_cnt;
+    FD_LOG_NOTICE(( "node %lu: workers %lu (numa %lu), items [%lu,%lu) near cpu %lu", g,
+                    (ulong)(topo->node_pos[g+1UL]-topo->node_pos[g]), fd_tpool_worker_numa_idx( tpool, worker ), l0, l1, cpu_idx ));
+  }
+
+  fd_tpool_exec_all_numa( tpool, topo, init_numa, NULL, bench, seg, sizeof(seg_t), 0UL,n );
+
+  double gb = 24e-9*(double)n; /* bytes moved per triad (2 reads + 1 write per item) */
+
+  for( ulong worker_cnt=1UL; worker_cnt<=tile_cnt; worker_cnt++ ) {
+
+    /* Note that the segments are laid out for all tile_cnt workers such
+       that smaller worker counts show how bandwidth scales with a fixed
+       data placement. */
+
+    static fd_tpool_topo_t sub[1];
+    FD_TEST( fd_tpool_topo_init( sub, tpool, 0UL, worker_cnt ) );
+
+    fd_tpool_exec_all_batch( tpool, 0UL,worker_cnt, triad_flat, NULL, bench, NULL,0UL, 0UL,n ); /* warmup */
+    long dt_flat = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter++ )
+      fd_tpool_exec_all_batch( tpool, 0UL,worker_cnt, triad_flat, NULL, bench, NULL,0UL, 0UL,n );
+    dt_flat += fd_log_wallclock();
+
+    /* The hierarchical run can only use the node segments directly when
+       the worker range is the one the data was laid out for */
+
+    fd_tpool_task_t task = worker_cnt==tile_cnt ? triad_numa : triad_flat;
+    fd_tpool_exec_all_numa( tpool, sub, task, NULL, bench, seg, sizeof(seg_t), 0UL,n ); /* warmup */
+    long dt_numa = -fd_log_wallclock();
+    for( ulong iter=0UL; iter<iter_cnt; iter++ )
+      fd_tpool_exec_all_numa( tpool, sub, task, NULL, bench, seg, sizeof(seg_t), 0UL,n );
+    dt_numa += fd_log_wallclock();
+
+    double flat = (double)dt_flat / (double)iter_cnt;
+    double numa = (double)dt_numa / (double)iter_cnt;
+    FD_LOG_NOTICE(( "%4lu workers (%lu nodes): flat %9.3f ms (%7.2f GB/s), hierarchical %9.3f ms (%7.2f GB/s)",
+                    worker_cnt, sub->node_cnt, 1e-6*flat, gb/(1e-9*flat), 1e-6*numa, gb/(1e-9*numa) ));
+  }
+
+  /* Spot check the results */
+
+  for( ulong rem=1000UL; rem; rem-- ) {
+    ulong i = fd_ulong_hash( rem ) % n;
+    ulong g = 0UL; while( i>=seg[g].l1 ) g++;
+    FD_TEST( seg[g].a[ i-seg[g].l0 ]==(double)i + 3. );
+  }
+
+  for( ulong g=0UL; g<topo->node_cnt; g++ ) fd_shmem_release( seg[g].a, page_sz, seg[g].page_cnt );
+
+  FD_TEST( fd_tpool_fini( tpool )==(void *)tpool_mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_X86 capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
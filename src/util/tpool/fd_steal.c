@@ -0,0 +1,335 @@
+#include "fd_steal.h"
+
+#if FD_HAS_ATOMIC
+
+FD_TLS fd_steal_private_worker_t * fd_steal_private_self = NULL;
+
+ulong
+fd_steal_align( void ) {
+  return FD_STEAL_ALIGN;
+}
+
+ulong
+fd_steal_footprint( ulong worker_max ) {
+  if( FD_UNLIKELY( !((1UL<=worker_max) & (worker_max<=FD_TILE_MAX)) ) ) return 0UL;
+  return FD_STEAL_FOOTPRINT( worker_max );
+}
+
+FD_STATIC_ASSERT( sizeof(fd_steal_t               )==128UL,                          fd_steal_footprint );
+FD_STATIC_ASSERT( sizeof(fd_steal_private_worker_t)==256UL+8UL*FD_STEAL_DEQUE_MAX,   fd_steal_footprint );
+
+fd_steal_t *
+fd_steal_init( void * mem,
+               ulong  worker_max ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_steal_align() ) ) ) {
+    FD_LOG_WARNING(( "bad alignment" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_steal_footprint( worker_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad worker_max" ));
+    return NULL;
+  }
+
+  fd_memset( mem, 0, footprint );
+
+  fd_steal_t * steal = (fd_steal_t *)mem;
+  steal->worker_max = worker_max;
+
+  fd_steal_private_worker_t * worker = fd_steal_private_worker( steal );
+  for( ulong worker_idx=0UL; worker_idx<worker_max; worker_idx++ ) {
+    worker[ worker_idx ].steal = steal;
+    worker[ worker_idx ].idx   = worker_idx;
+  }
+
+  return steal;
+}
+
+void *
+fd_steal_fini( fd_steal_t * steal ) {
+
+  if( FD_UNLIKELY( !steal ) ) {
+    FD_LOG_WARNING(( "NULL steal" ));
+    return NULL;
+  }
+
+  return (void *)steal;
+}
+
+/* fd_steal_private_steal tries to steal the job at the top of a random
+   victim's deque.  Returns the stolen job on success and NULL on
+   failure (e.g. the victim had nothing to steal or another thief got
+   there first). */
+
+static fd_steal_job_t *
+fd_steal_private_steal( fd_steal_private_worker_t * worker ) {
+  ulong worker_cnt = worker->steal->worker_cnt;
+  if( FD_UNLIKELY( worker_cnt<2UL ) ) return NULL;
+
+  /* Pick a victim uniformly from the other workers */
+
+  ulong rng = worker->rng + 0x9e3779b97f4a7c15UL;
+  worker->rng = rng;
+  ulong victim_idx = fd_ulong_hash( rng ) % (worker_cnt-1UL);
+  victim_idx += (ulong)(victim_idx>=worker->idx);
+
+  fd_steal_private_worker_t * victim = fd_steal_private_worker( worker->steal ) + victim_idx;
+
+  FD_COMPILER_MFENCE();
+  long t = FD_VOLATILE_CONST( victim->top    );
+  FD_COMPILER_MFENCE();
+  long b = FD_VOLATILE_CONST( victim->bottom );
+  FD_COMPILER_MFENCE();
+  if( t>=b ) return NULL;
+
+  fd_steal_job_t * job = FD_VOLATILE_CONST( victim->job[ ((ulong)t) & (FD_STEAL_DEQUE_MAX-1UL) ] );
+  FD_COMPILER_MFENCE();
+  if( FD_UNLIKELY( FD_ATOMIC_CAS( &victim->top, t, t+1L )!=t ) ) return NULL;
+
+  worker->steal_cnt++;
+  return job;
+}
+
+void
+fd_steal_private_help( fd_steal_private_worker_t * worker,
+                       fd_steal_job_t *            job ) {
+  for(;;) {
+    FD_COMPILER_MFENCE();
+    int done = FD_VOLATILE_CONST( job->done );
+    FD_COMPILER_MFENCE();
+    if( done ) break;
+    fd_steal_job_t * stolen = fd_steal_private_steal( worker );
+    if( FD_LIKELY( stolen ) ) { worker->job_cnt++; fd_steal_private_run( stolen ); }
+    else                      FD_SPIN_PAUSE();
+  }
+}
+
+static void
+fd_steal_private_exec_task( void * tpool,
+                            ulong  t0,     ulong t1,
+                            void * args,
+                            void * reduce, ulong stride,
+                            ulong  l0,     ulong l1,
+                            ulong  m0,     ulong m1,
+                            ulong  n0,     ulong n1 ) {
+  (void)t1; (void)reduce; (void)stride; (void)l0; (void)l1; (void)m0; (void)m1; (void)n1;
+
+  fd_steal_t *                steal  = (fd_steal_t *)tpool;
+  fd_steal_job_t *            root   = (fd_steal_job_t *)args;
+  fd_steal_private_worker_t * worker = fd_steal_private_worker( steal ) + (n0-t0);
+
+  fd_steal_private_self = worker;
+
+  if( n0==t0 ) {
+
+    /* Run the root job.  When it returns, all jobs it forked have been
+       joined so we can tell the other workers to leave. */
+
+    worker->job_cnt++;
+    fd_steal_private_run( root );
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( steal->done ) = 1;
+    FD_COMPILER_MFENCE();
+
+  } else {
+
+    /* Steal jobs until the root job is done */
+
+    for(;;) {
+      FD_COMPILER_MFENCE();
+      int done = FD_VOLATILE_CONST( steal->done );
+      FD_COMPILER_MFENCE();
+      if( done ) break;
+      fd_steal_job_t * stolen = fd_steal_private_steal( worker );
+      if( FD_LIKELY( stolen ) ) { worker->job_cnt++; fd_steal_private_run( stolen ); }
+      else                      FD_SPIN_PAUSE();
+    }
+
+  }
+
+  fd_steal_private_self = NULL;
+}
+
+void
+fd_steal_exec( fd_steal_t *     steal,
+               fd_tpool_t *     tpool,
+               ulong            t0,
+               ulong            t1,
+               fd_steal_job_t * root ) {
+  ulong worker_cnt = t1-t0;
+  if( FD_UNLIKELY( (t1<=t0) | (worker_cnt>steal->worker_max) | (t1>fd_tpool_worker_cnt( tpool )) ) )
+    FD_LOG_ERR(( "bad t0 %lu / t1 %lu (worker_max %lu, tpool worker_cnt %lu)",
+                 t0, t1, steal->worker_max, fd_tpool_worker_cnt( tpool ) ));
+
+  fd_steal_private_worker_t * worker = fd_steal_private_worker( steal );
+  for( ulong worker_idx=0UL; worker_idx<worker_cnt; worker_idx++ ) {
+    worker[ worker_idx ].top       = 0L;
+    worker[ worker_idx ].bottom    = 0L;
+    worker[ worker_idx ].steal_cnt = 0UL;
+    worker[ worker_idx ].job_cnt   = 0UL;
+    worker[ worker_idx ].rng       = fd_ulong_hash( worker_idx );
+  }
+  steal->worker_cnt = worker_cnt;
+  steal->done       = 0;
+  root->done        = 0;
+
+  FD_COMPILER_MFENCE();
+  fd_tpool_exec_all_raw( tpool, t0,t1, fd_steal_private_exec_task, steal, root, NULL,0UL, 0UL,0UL );
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_steal_for and fd_steal_reduce recursively split the range in half
+   forking the right half.  The contexts below are shared by all jobs in
+   the recursion (they live on the stack of the caller). */
+
+struct fd_steal_private_for_ctx {
+  fd_steal_task_t task;
+  void *          args;
+  ulong           grain;
+};
+
+typedef struct fd_steal_private_for_ctx fd_steal_private_for_ctx_t;
+
+static void
+fd_steal_private_for_rec( fd_steal_private_for_ctx_t const * ctx,
+                          ulong                              i0,
+                          ulong                              i1 );
+
+static void
+fd_steal_private_for_job( fd_steal_job_t * job ) {
+  fd_steal_private_for_rec( (fd_steal_private_for_ctx_t const *)job->args, job->i0, job->i1 );
+}
+
+static void
+fd_steal_private_for_rec( fd_steal_private_for_ctx_t const * ctx,
+                          ulong                              i0,
+                          ulong                              i1 ) {
+  if( (i1-i0)>ctx->grain ) {
+    ulong is = i0 + ((i1-i0)>>1);
+    fd_steal_job_t job[1];
+    job->fn   = fd_steal_private_for_job;
+    job->args = (void *)ctx;
+    job->i0   = is;
+    job->i1   = i1;
+    fd_steal_fork( job );
+    fd_steal_private_for_rec( ctx, i0, is );
+    fd_steal_join( job );
+    return;
+  }
+  if( FD_LIKELY( i1>i0 ) ) ctx->task( ctx->args, i0, i1 );
+}
+
+void
+fd_steal_for( fd_steal_t *    steal,
+              fd_tpool_t *    tpool,
+              ulong           t0,
+              ulong           t1,
+              fd_steal_task_t task,
+              void *          args,
+              ulong           i0,
+              ulong           i1,
+              ulong           grain ) {
+  fd_steal_private_for_ctx_t ctx[1];
+  ctx->task  = task;
+  ctx->args  = args;
+  ctx->grain = fd_ulong_max( grain, 1UL );
+
+  if( FD_UNLIKELY( fd_steal_private_self || !steal ) ) { /* Nested or serial */
+    fd_steal_private_for_rec( ctx, i0, i1 );
+    return;
+  }
+
+  fd_steal_job_t root[1];
+  root->fn   = fd_steal_private_for_job;
+  root->args = ctx;
+  root->i0   = i0;
+  root->i1   = i1;
+  fd_steal_exec( steal, tpool, t0,t1, root );
+}
+
+struct fd_steal_private_reduce_ctx {
+  fd_steal_reduce_task_t task;
+  fd_steal_combine_t     combine;
+  void *                 args;
+  ulong                  grain;
+};
+
+typedef struct fd_steal_private_reduce_ctx fd_steal_private_reduce_ctx_t;
+
+static void
+fd_steal_private_reduce_rec( fd_steal_private_reduce_ctx_t const * ctx,
+                             void *                                reduce,
+                             ulong                                 i0,
+                             ulong                                 i1 );
+
+static void
+fd_steal_private_reduce_job( fd_steal_job_t * job ) {
+  fd_steal_private_reduce_rec( (fd_steal_private_reduce_ctx_t const *)job->args, job->reduce, job->i0, job->i1 );
+}
+
+static void
+fd_steal_private_reduce_rec( fd_steal_private_reduce_ctx_t const * ctx,
+                             void *                                reduce,
+                             ulong                                 i0,
+                             ulong                                 i1 ) {
+  if( (i1-i0)<=ctx->grain ) {
+    ctx->task( ctx->args, reduce, i0, i1 );
+    return;
+  }
+  ulong is = i0 + ((i1-i0)>>1);
+  uchar reduce_right[ FD_STEAL_REDUCE_MAX ] __attribute__((aligned(64)));
+  fd_steal_job_t job[1];
+  job->fn     = fd_steal_private_reduce_job;
+  job->args   = (void *)ctx;
+  job->reduce = reduce_right;
+  job->i0     = is;
+  job->i1     = i1;
+  fd_steal_fork( job );
+  fd_steal_private_reduce_rec( ctx, reduce, i0, is );
+  fd_steal_join( job );
+  ctx->combine( ctx->args, reduce, reduce_right );
+}
+
+void
+fd_steal_reduce( fd_steal_t *           steal,
+                 fd_tpool_t *           tpool,
+                 ulong                  t0,
+                 ulong                  t1,
+                 fd_steal_reduce_task_t task,
+                 fd_steal_combine_t     combine,
+                 void *                 args,
+                 void *                 reduce,
+                 ulong                  reduce_sz,
+                 ulong                  i0,
+                 ulong                  i1,
+                 ulong                  grain ) {
+  if( FD_UNLIKELY( !((1UL<=reduce_sz) & (reduce_sz<=FD_STEAL_REDUCE_MAX)) ) ) FD_LOG_ERR(( "bad reduce_sz" ));
+
+  fd_steal_private_reduce_ctx_t ctx[1];
+  ctx->task    = task;
+  ctx->combine = combine;
+  ctx->args    = args;
+  ctx->grain   = fd_ulong_max( grain, 1UL );
+
+  if( FD_UNLIKELY( fd_steal_private_self || !steal ) ) { /* Nested or serial */
+    fd_steal_private_reduce_rec( ctx, reduce, i0, i1 );
+    return;
+  }
+
+  fd_steal_job_t root[1];
+  root->fn     = fd_steal_private_reduce_job;
+  root->args   = ctx;
+  root->reduce = reduce;
+  root->i0     = i0;
+  root->i1     = i1;
+  fd_steal_exec( steal, tpool, t0,t1, root );
+}
+
+#endif /* FD_HAS_ATOMIC */
@@ -0,0 +1,362 @@
+#ifndef HEADER_fd_src_util_tpool_fd_steal_h
+#define HEADER_fd_src_util_tpool_fd_steal_h
+
+/* fd_steal provides a work stealing fork-join scheduler that runs over
+   a range of tpool worker threads.  This is intended for irregular
+   and/or recursive workloads (e.g. divide-and-conquer algorithms with
+   data dependent subproblem sizes like building merkle trees, sorting,
+   rehashing, etc) where the static partitioning of
+   fd_tpool_exec_all_{rrobin,block,batch} balances poorly and where the
+   single shared counter of fd_tpool_exec_all_taskq becomes a point of
+   contention.
+
+   Each worker thread in the scheduler has its own Chase-Lev deque of
+   jobs.  A worker forks a job by pushing it onto the bottom of its
+   deque (a handful of non-atomic ops) and joins it by popping it back
+   off the bottom and running it itself if nobody stole it in the
+   meantime (the common case when there is enough parallelism, such
+   that the overhead of a fork-join is comparable to a function call).
+   Idle workers steal the oldest job (i.e. typically the largest
+   remaining subproblem) from the top of a random victim's deque.  A
+   worker waiting to join a stolen job doesn't spin idle: it steals
+   and runs other jobs until the stolen job completes (such that nested
+   fork-joins keep all the workers productive).
+
+   Typical usage:
+
+     static void
+     my_task( void * args,
+              ulong  i0,
+              ulong  i1 ) {
+       ... do items [i0,i1) ...
+     }
+
+     fd_steal_for( steal, tpool,t0,t1, my_task,args, i0,i1, grain );
+
+   will do items [i0,i1) in blocks of at most grain items over tpool
+   workers [t0,t1) (with the caller acting as worker t0, same as the
+   fd_tpool_exec_all_* conventions).  Within a task, further nested
+   fd_steal_for / fd_steal_reduce / fd_steal_fork-fd_steal_join calls
+   will automatically be scheduled over the same workers.
+
+   This requires FD_HAS_ATOMIC. */
+
+#include "fd_tpool.h"
+
+#if FD_HAS_ATOMIC
+
+/* FD_STEAL_DEQUE_MAX is the maximum number of outstanding forked jobs
+   a worker can have.  A fork when a worker's deque is full runs the
+   job immediately (i.e. degrades gracefully to serial execution).
+   Since typical recursive usage has a fork depth logarithmic in the
+   problem size, this is ample.  Integer power of 2. */
+
+#define FD_STEAL_DEQUE_MAX (256UL)
+
+/* FD_STEAL_REDUCE_MAX is the maximum size in bytes of a reduction value
+   supported by fd_steal_reduce. */
+
+#define FD_STEAL_REDUCE_MAX (128UL)
+
+/* FD_STEAL_{ALIGN,FOOTPRINT} give the alignment and footprint required
+   for a memory region to be used as a work stealing scheduler for up to
+   worker_max worker threads.  worker_max is assumed valid (i.e. in
+   [1,FD_TILE_MAX]). */
+
+#define FD_STEAL_ALIGN                   (128UL)
+#define FD_STEAL_FOOTPRINT( worker_max ) (128UL + ((ulong)(worker_max))*(256UL + 8UL*FD_STEAL_DEQUE_MAX))
+
+/* A fd_steal_job_t is a unit of work that can be forked and joined.
+   These are typically allocated on the stack of the forking worker and
+   must remain valid until joined.  fn is called with a pointer to the
+   job (such that the job payload fields, or a larger user struct that
+   starts with a fd_steal_job_t, can be used to pass arguments). */
+
+struct fd_steal_job;
+typedef struct fd_steal_job fd_steal_job_t;
+
+typedef void (*fd_steal_job_fn_t)( fd_steal_job_t * job );
+
+struct fd_steal_job {
+  fd_steal_job_fn_t fn;
+  void *            args;
+  void *            reduce;
+  ulong             i0;
+  ulong             i1;
+  int               done; /* Set to 1 by the worker that ran the job, internal use */
+};
+
+/* A fd_steal_task_t is the function signature used by fd_steal_for to
+   do items [i0,i1). */
+
+typedef void (*fd_steal_task_t)( void * args,
+                                 ulong  i0,
+                                 ulong  i1 );
+
+/* A fd_steal_reduce_task_t is the function signature used by
+   fd_steal_reduce to compute into reduce the reduction of items
+   [i0,i1).  A fd_steal_combine_t combines reduce (reduction of some
+   items [i0,is)) with reduce_right (reduction of items [is,i1)) into
+   reduce. */
+
+typedef void (*fd_steal_reduce_task_t)( void * args,
+                                        void * reduce,
+                                        ulong  i0,
+                                        ulong  i1 );
+
+typedef void (*fd_steal_combine_t)( void *       args,
+                                    void *       reduce,
+                                    void const * reduce_right );
+
+/* Private APIs *******************************************************/
+
+/* These are exposed here to facilitate inlining fork and join.  Note
+   that the deque operations rely on the x86 memory model (loads are not
+   reordered with other loads, stores are not reordered with other
+   stores) such that only the store-load ordering in pop requires a
+   hardware fence. */
+
+struct fd_steal_private;
+typedef struct fd_steal_private fd_steal_t;
+
+struct __attribute__((aligned(128))) fd_steal_private_worker {
+  long             top;                          /* Stolen from here, updated atomically by thieves and the owner */
+  ulong            steal_cnt;                    /* Number of jobs this worker stole, owner updated */
+  ulong            job_cnt;                      /* Number of jobs this worker ran, owner updated */
+  ulong            rng;                          /* Victim selection state, owner updated */
+  fd_steal_t *     steal;                        /* Scheduler this worker is part of */
+  ulong            idx;                          /* Index of this worker in the scheduler */
+  uchar            _pad0[ 128UL-48UL ];
+  long             bottom;                       /* Pushed to / popped from here, owner updated */
+  uchar            _pad1[ 128UL-8UL ];
+  fd_steal_job_t * job[ FD_STEAL_DEQUE_MAX ];    /* Deque storage, indexed by position modulo FD_STEAL_DEQUE_MAX */
+};
+
+typedef struct fd_steal_private_worker fd_steal_private_worker_t;
+
+struct __attribute__((aligned(128))) fd_steal_private {
+  ulong worker_max;  /* Positive */
+  ulong worker_cnt;  /* Number of workers in the current exec, in [0,worker_max] */
+  int   done;        /* 1 when the root job of the current exec has completed */
+  uchar _pad[ 128UL-20UL ];
+
+  /* worker_max fd_steal_private_worker_t here */
+};
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_steal_private_self is the calling thread's worker in the
+   scheduler it is currently executing in (NULL if none).  */
+
+extern FD_TLS fd_steal_private_worker_t * fd_steal_private_self;
+
+FD_FN_CONST static inline fd_steal_private_worker_t *
+fd_steal_private_worker( fd_steal_t const * steal ) {
+  return (fd_steal_private_worker_t *)(steal+1);
+}
+
+/* fd_steal_private_pop pops the job at the bottom of worker's deque.
+   Returns NULL if the deque is empty (i.e. the job was stolen).  Only
+   the owner of the deque should call this.  This is the Chase-Lev pop
+   and requires a full memory fence between publishing the reservation
+   of the bottom job and checking for thieves (the atomic exchange). */
+
+static inline fd_steal_job_t *
+fd_steal_private_pop( fd_steal_private_worker_t * worker ) {
+  long b = worker->bottom - 1L;
+  FD_COMPILER_MFENCE();
+  FD_ATOMIC_XCHG( &worker->bottom, b );
+  FD_COMPILER_MFENCE();
+  long t = FD_VOLATILE_CONST( worker->top );
+  FD_COMPILER_MFENCE();
+  fd_steal_job_t * job = NULL;
+  if( FD_LIKELY( t<=b ) ) {
+    job = worker->job[ ((ulong)b) & (FD_STEAL_DEQUE_MAX-1UL) ];
+    if( FD_UNLIKELY( t==b ) ) { /* Last job, race thieves for it */
+      if( FD_UNLIKELY( FD_ATOMIC_CAS( &worker->top, t, t+1L )!=t ) ) job = NULL;
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( worker->bottom ) = b+1L;
+      FD_COMPILER_MFENCE();
+    }
+  } else { /* Empty */
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( worker->bottom ) = b+1L;
+    FD_COMPILER_MFENCE();
+  }
+  return job;
+}
+
+/* fd_steal_private_run runs job on the caller and marks it as done */
+
+static inline void
+fd_steal_private_run( fd_steal_job_t * job ) {
+  job->fn( job );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( job->done ) = 1;
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_steal_private_help is called by a worker waiting for stolen job to
+   complete.  Runs other jobs until job is done. */
+
+void
+fd_steal_private_help( fd_steal_private_worker_t * worker,
+                       fd_steal_job_t *            job );
+
+FD_PROTOTYPES_END
+
+/* End of private APIs ************************************************/
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_steal_align returns FD_STEAL_ALIGN.  fd_steal_footprint returns
+   FD_STEAL_FOOTPRINT( worker_max ) if worker_max is in [1,FD_TILE_MAX]
+   and 0 otherwise. */
+
+FD_FN_CONST ulong fd_steal_align( void );
+FD_FN_CONST ulong fd_steal_footprint( ulong worker_max );
+
+/* fd_steal_init formats a memory region mem with the appropriate
+   alignment and footprint as a work stealing scheduler for up to
+   worker_max worker threads.  Returns a handle for the scheduler on
+   success and NULL on failure (logs details).  Like tpool, this uses
+   init/fini semantics as a scheduler isn't meaningfully sharable
+   between thread groups.  fd_steal_fini unformats the memory region
+   (no execs should be in progress) and returns mem on success and NULL
+   on failure (logs details). */
+
+fd_steal_t *
+fd_steal_init( void * mem,
+               ulong  worker_max );
+
+void *
+fd_steal_fini( fd_steal_t * steal );
+
+/* fd_steal_exec runs root over tpool workers [t0,t1) with the caller
+   acting as worker t0 (same as the fd_tpool_exec_all_* conventions).
+   The caller runs root while the other workers steal any jobs forked
+   by it (and by the jobs they run, recursively).  Returns when root and
+   all jobs it forked have completed (and all the workers have left the
+   scheduler).  t1-t0 should be in [1,worker_max] and t1 at most the
+   tpool's worker_cnt (logs details and terminates the thread group
+   otherwise).  Assumes tpool workers (t0,t1) are idle.  Execs on a scheduler cannot be nested (but a job
+   can fork and join arbitrarily).  If t1-t0 is 1, this simply runs root
+   on the caller (forks run serially). */
+
+void
+fd_steal_exec( fd_steal_t *     steal,
+               fd_tpool_t *     tpool,
+               ulong            t0,
+               ulong            t1,
+               fd_steal_job_t * root );
+
+/* fd_steal_fork makes job available for execution by other workers in
+   the scheduler the caller is executing in.  Assumes job->fn is set and
+   job is not already forked.  If the caller isn't executing in a
+   scheduler (or its deque is full), job is run immediately by the
+   caller.  Every fork should be joined (by the same thread) and joins
+   must be done in the reverse order of forks (i.e. fork-join are
+   strictly nested).
+
+   fd_steal_join waits for job to complete.  If job hasn't been stolen,
+   it is run immediately by the caller.  Otherwise, while the thief
+   runs job, the caller will run other jobs.  On return, the result of
+   job is visible to the caller. */
+
+static inline void
+fd_steal_fork( fd_steal_job_t * job ) {
+  job->done = 0;
+  fd_steal_private_worker_t * worker = fd_steal_private_self;
+  if( FD_UNLIKELY( !worker ) ) { fd_steal_private_run( job ); return; }
+  long b = worker->bottom;
+  long t = FD_VOLATILE_CONST( worker->top );
+  if( FD_UNLIKELY( (b-t)>=(long)FD_STEAL_DEQUE_MAX ) ) { fd_steal_private_run( job ); return; }
+  worker->job[ ((ulong)b) & (FD_STEAL_DEQUE_MAX-1UL) ] = job;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( worker->bottom ) = b+1L;
+  FD_COMPILER_MFENCE();
+}
+
+static inline void
+fd_steal_join( fd_steal_job_t * job ) {
+  if( FD_VOLATILE_CONST( job->done ) ) { FD_COMPILER_MFENCE(); return; } /* Ran at fork, or stolen and already done */
+  fd_steal_private_worker_t * worker = fd_steal_private_self;
+  fd_steal_job_t *            popped = fd_steal_private_pop( worker );
+  if( FD_LIKELY( popped ) ) { /* popped==job given strict nesting */
+    worker->job_cnt++;
+    fd_steal_private_run( popped );
+    return;
+  }
+  fd_steal_private_help( worker, job );
+}
+
+/* fd_steal_for does items [i0,i1) by calling task( args, j0,j1 ) on
+   disjoint blocks [j0,j1) of at most grain items (a zero grain is
+   treated as 1) that cover [i0,i1).  The range is recursively split in
+   half with the right halves forked for other workers to steal.  If
+   called from within a job, runs within the caller's scheduler
+   (steal/tpool/t0/t1 are ignored in this case and can be NULL/0).
+   Otherwise, runs over tpool workers [t0,t1) via steal as described in
+   fd_steal_exec (if steal is NULL, runs serially on the caller).
+
+   The grain trades parallelism against overhead: it should be large
+   enough that a block takes many times longer than a fork-join (~tens
+   of ns) but small enough that there are several blocks per worker. */
+
+void
+fd_steal_for( fd_steal_t *    steal,
+              fd_tpool_t *    tpool,
+              ulong           t0,
+              ulong           t1,
+              fd_steal_task_t task,
+              void *          args,
+              ulong           i0,
+              ulong           i1,
+              ulong           grain );
+
+/* fd_steal_reduce is like fd_steal_for but computes a reduction.  On
+   return, reduce will hold the reduction of items [i0,i1), computed by
+   calling task( args, reduce_blk, j0,j1 ) to reduce blocks of at most
+   grain items and combine( args, reduce_left, reduce_right ) to combine
+   the reductions of adjacent ranges.  reduce_sz is the size of a
+   reduction value in bytes, in [1,FD_STEAL_REDUCE_MAX].  The reduction
+   tree depends only on [i0,i1) and grain (not on how the jobs were
+   scheduled) such that the result is deterministic even if combine is
+   not associative (e.g. floating point sums).  Requires i1>i0. */
+
+void
+fd_steal_reduce( fd_steal_t *           steal,
+                 fd_tpool_t *           tpool,
+                 ulong                  t0,
+                 ulong                  t1,
+                 fd_steal_reduce_task_t task,
+                 fd_steal_combine_t     combine,
+                 void *                 args,
+                 void *                 reduce,
+                 ulong                  reduce_sz,
+                 ulong                  i0,
+                 ulong                  i1,
+                 ulong                  grain );
+
+/* fd_steal_worker_{steal,job}_cnt return the number of jobs worker
+   worker_idx (indexed relative to t0 of the most recent exec) stole /
+   ran.  Useful for diagnostics.  Assumes worker_idx<worker_max and no
+   exec in progress. */
+
+FD_FN_PURE static inline ulong
+fd_steal_worker_steal_cnt( fd_steal_t const * steal,
+                           ulong              worker_idx ) {
+  return fd_steal_private_worker( steal )[ worker_idx ].steal_cnt;
+}
+
+FD_FN_PURE static inline ulong
+fd_steal_worker_job_cnt( fd_steal_t const * steal,
+                         ulong              worker_idx ) {
+  return fd_steal_private_worker( steal )[ worker_idx ].job_cnt;
+}
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_ATOMIC */
+
+#endif /* HEADER_fd_src_util_tpool_fd_steal_h */
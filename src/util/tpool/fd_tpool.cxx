@@ -382,6 +382,185 @@ FD_TPOOL_EXEC_ALL_IMPL_FTR
 #undef FD_TPOOL_EXEC_ALL_IMPL_FTR
 #undef FD_TPOOL_EXEC_ALL_IMPL_HDR
 
+/* Topology aware exec_all ********************************************/
+
+ulong
+fd_tpool_worker_cpu_idx( fd_tpool_t const * tpool,
+                         ulong              worker_idx ) {
+  ulong tile_idx = worker_idx ? fd_tpool_worker_tile_idx( tpool, worker_idx ) : fd_tile_idx();
+  ulong cpu_idx  = fd_tile_cpu_id( tile_idx );
+  return cpu_idx<ULONG_MAX-1UL ? cpu_idx : ULONG_MAX; /* Floating tiles have no cpu */
+}
+
+ulong
+fd_tpool_worker_numa_idx( fd_tpool_t const * tpool,
+                          ulong              worker_idx ) {
+# if FD_HAS_HOSTED && FD_HAS_X86
+  return fd_shmem_numa_idx( fd_tpool_worker_cpu_idx( tpool, worker_idx ) );
+# else
+  (void)tpool; (void)worker_idx;
+  return ULONG_MAX;
+# endif
+}
+
+ulong
+fd_tpool_worker_llc_idx( fd_tpool_t const * tpool,
+                         ulong              worker_idx ) {
+# if FD_HAS_HOSTED && FD_HAS_X86
+  return fd_shmem_llc_idx( fd_tpool_worker_cpu_idx( tpool, worker_idx ) );
+# else
+  (void)tpool; (void)worker_idx;
+  return ULONG_MAX;
+# endif
+}
+
+fd_tpool_topo_t *
+fd_tpool_topo_init( fd_tpool_topo_t *  topo,
+                    fd_tpool_t const * tpool,
+                    ulong              t0,
+                    ulong              t1 ) {
+
+  if( FD_UNLIKELY( !topo ) ) {
+    FD_LOG_WARNING(( "NULL topo" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !tpool ) ) {
+    FD_LOG_WARNING(( "NULL tpool" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((t0<t1) & (t1<=fd_tpool_worker_cnt( tpool ))) ) ) {
+    FD_LOG_WARNING(( "bad worker range [%lu,%lu)", t0, t1 ));
+    return NULL;
+  }
+
+  ulong worker_cnt = t1-t0;
+
+  /* Compute the sort key for each worker.  We want worker t0 first,
+     then the other workers on its numa node (those sharing its last
+     level cache first), then the workers on the other numa nodes
+     grouped by node and then last level cache.  Ties are broken by
+     worker idx to make this deterministic. */
+
+  ulong numa[ FD_TILE_MAX ];
+  ulong llc [ FD_TILE_MAX ];
+  for( ulong t=t0; t<t1; t++ ) {
+    numa[ t-t0 ] = fd_tpool_worker_numa_idx( tpool, t );
+    llc [ t-t0 ] = fd_tpool_worker_llc_idx ( tpool, t );
+  }
+  ulong numa0 = numa[0];
+  ulong llc0  = llc [0];
+
+# define KEY_LT(i,j) (                                                                       \
+    (numa[i]!=numa0) != (numa[j]!=numa0) ? (numa[i]!=numa0) < (numa[j]!=numa0) :             \
+    numa[i]          != numa[j]          ? numa[i]          < numa[j]          :             \
+    (llc[i]!=llc0)   != (llc[j]!=llc0)   ? (llc[i]!=llc0)   < (llc[j]!=llc0)   :             \
+    llc[i]           != llc[j]           ? llc[i]           < llc[j]           : (i)<(j) )
+
+  /* Insertion sort the positions (worker_cnt is small and this is done
+     once per topo).  Position 0 is always t0 given the above key. */
+
+  for( ulong p=0UL; p<worker_cnt; p++ ) {
+    ulong i = p;
+    ulong q = p;
+    for( ; q && KEY_LT( i, (ulong)topo->worker[q-1UL]-t0 ); q-- ) topo->worker[q] = topo->worker[q-1UL];
+    topo->worker[q] = (ushort)(t0+i);
+  }
+
+# undef KEY_LT
+
+  /* Group positions into nodes */
+
+  ulong node_cnt = 0UL;
+  for( ulong p=0UL; p<worker_cnt; p++ ) {
+    if( !p || numa[ topo->worker[p]-t0 ]!=numa[ topo->worker[p-1UL]-t0 ] ) topo->node_pos[ node_cnt++ ] = (ushort)p;
+    topo->pos_node[p] = (ushort)(node_cnt-1UL);
+  }
+  topo->node_pos[ node_cnt ] = (ushort)worker_cnt;
+
+  topo->t0       = t0;
+  topo->t1       = t1;
+  topo->node_cnt = node_cnt;
+
+  return topo;
+}
+
+struct fd_tpool_private_numa_ctx {
+  fd_tpool_task_t         task;
+  void *                  task_tpool;
+  fd_tpool_topo_t const * topo;
+};
+
+typedef struct fd_tpool_private_numa_ctx fd_tpool_private_numa_ctx_t;
+
+/* fd_tpool_private_exec_all_numa_node executes positions [p0,p1) of
+   the topo.  It is run by the worker at position p0.  If the range
+   spans multiple nodes, we split at the node boundary closest to the
+   middle (such that only node_cnt-1 dispatches cross nodes overall).
+   Otherwise we split within the node like the other exec_all styles. */
+
+static void
+fd_tpool_private_exec_all_numa_node( void * _tpool,
+                                     ulong  p0,     ulong p1,
+                                     void * args,
+                                     void * reduce, ulong stride,
+                                     ulong  l0,     ulong l1,
+                                     ulong  _ctx,   ulong _unused,
+                                     ulong  t0,     ulong t1 ) {
+  fd_tpool_t *                        tpool = (fd_tpool_t *)_tpool;
+  fd_tpool_private_numa_ctx_t const * ctx   = (fd_tpool_private_numa_ctx_t const *)_ctx;
+  fd_tpool_topo_t const *             topo  = ctx->topo;
+
+  ulong p_cnt = p1-p0;
+  if( p_cnt>1UL ) {
+    ulong g0 = (ulong)topo->pos_node[ p0     ];
+    ulong g1 = (ulong)topo->pos_node[ p1-1UL ];
+    ulong ps;
+    if( FD_LIKELY( g0==g1 ) ) ps = p0 + fd_tpool_private_exec_all_split( p_cnt );
+    else {
+      ulong mid2 = p0+p1;
+      ps = (ulong)topo->node_pos[ g0+1UL ];
+      for( ulong g=g0+2UL; g<=g1; g++ ) {
+        ulong b = (ulong)topo->node_pos[ g ];
+        if( fd_long_abs( (long)(2UL*b) - (long)mid2 ) < fd_long_abs( (long)(2UL*ps) - (long)mid2 ) ) ps = b;
+      }
+    }
+    ulong ws = (ulong)topo->worker[ ps ];
+    fd_tpool_exec( tpool, ws, fd_tpool_private_exec_all_numa_node,
+    /**/                                 tpool, ps,p1, args, reduce,stride, l0,l1, _ctx,_unused, t0,t1 );
+    fd_tpool_private_exec_all_numa_node( tpool, p0,ps, args, reduce,stride, l0,l1, _ctx,_unused, t0,t1 );
+    fd_tpool_wait( tpool, ws );
+    return;
+  }
+
+  ulong t = (ulong)topo->worker  [ p0 ];
+  ulong g = (ulong)topo->pos_node[ p0 ];
+  ulong m0; ulong m1; FD_TPOOL_PARTITION( l0,l1,1UL, p0,t1-t0, m0,m1 );
+  void * node_reduce = reduce ? (void *)((ulong)reduce + g*stride) : NULL;
+  ctx->task( ctx->task_tpool,t0,t1, args,node_reduce,stride, l0,l1, m0,m1, t,t+1UL );
+}
+
+void
+fd_tpool_exec_all_numa( fd_tpool_t *            tpool,
+                        fd_tpool_topo_t const * topo,
+                        fd_tpool_task_t         task,
+                        void *                  task_tpool,
+                        void *                  task_args,
+                        void *                  task_reduce,
+                        ulong                   task_stride,
+                        ulong                   task_l0,
+                        ulong                   task_l1 ) {
+  fd_tpool_private_numa_ctx_t ctx[1];
+  ctx->task       = task;
+  ctx->task_tpool = task_tpool;
+  ctx->topo       = topo;
+  ulong t0 = topo->t0;
+  ulong t1 = topo->t1;
+  fd_tpool_private_exec_all_numa_node( tpool, 0UL,t1-t0, task_args, task_reduce,task_stride, task_l0,task_l1,
+                                       (ulong)ctx,0UL, t0,t1 );
+}
+
 char const *
 fd_tpool_worker_state_cstr( int state ) {
   switch( state ) {
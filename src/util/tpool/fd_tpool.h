@@ -923,6 +923,127 @@ fd_tpool_exec_all_taskq( fd_tpool_t *    tpool,
 
 #undef FD_TPOOL_EXEC_ALL_DECL
 
+/* Topology aware exec_all *********************************************
+
+   Worker threads are pushed into a tpool by tile index with no regard
+   for where the tiles are running.  On a multi-socket host, this means
+   the exec_all_* styles above can straddle numa nodes arbitrarily (e.g.
+   adjacent blocks of a block partition landing on different sockets
+   and dispatch messages crossing sockets at every level of the dispatch
+   tree).  The APIs below let the caller group a range of workers by
+   numa node (and, within a node, by shared last level cache) using the
+   topology fd_shmem discovered at boot and then dispatch over that
+   grouping hierarchically. */
+
+/* fd_tpool_worker_{cpu,numa,llc}_idx return the logical cpu, numa node
+   and last level cache label (see fd_shmem_llc_idx) used by tpool
+   worker worker_idx.  worker 0 is special: the values returned for it
+   are those of the calling thread.  Returns ULONG_MAX if not known
+   (e.g. the worker's tile was configured to float or the build target
+   does not support topology discovery).  Assumes tpool is valid and
+   worker_idx is in [0,worker_cnt). */
+
+ulong fd_tpool_worker_cpu_idx ( fd_tpool_t const * tpool, ulong worker_idx );
+ulong fd_tpool_worker_numa_idx( fd_tpool_t const * tpool, ulong worker_idx );
+ulong fd_tpool_worker_llc_idx ( fd_tpool_t const * tpool, ulong worker_idx );
+
+/* A fd_tpool_topo_t describes a grouping of tpool workers [t0,t1) by
+   node.  Workers are arranged into "positions" [0,t1-t0): position 0 is
+   always worker t0 (the thread that will do the dispatch), workers on
+   the same numa node are at contiguous positions (one "node" per numa
+   node spanned, with nodes indexed in [0,node_cnt) by position order
+   and node 0 being worker t0's numa node) and, within a node, workers
+   that share a last level cache are at contiguous positions.  Workers
+   with unknown topology are grouped into a single node.  These are
+   typically declared on the stack or statically (it is ~6 KiB) and
+   computed once for a given tpool and worker range. */
+
+struct fd_tpool_topo {
+  ulong  t0;                            /* Worker range */
+  ulong  t1;
+  ulong  node_cnt;                      /* Number of nodes, in [1,t1-t0] */
+  ushort worker  [ FD_TILE_MAX     ];   /* worker[p] is the worker at position p, worker[0]==t0 */
+  ushort pos_node[ FD_TILE_MAX     ];   /* pos_node[p] is the node of position p, monotonic in p */
+  ushort node_pos[ FD_TILE_MAX+1UL ];   /* node g has positions [node_pos[g],node_pos[g+1]) */
+};
+
+typedef struct fd_tpool_topo fd_tpool_topo_t;
+
+/* fd_tpool_topo_init computes the grouping of tpool workers [t0,t1)
+   into topo.  Returns topo on success and NULL on failure (logs
+   details, e.g. NULL topo, NULL tpool or bad range).  The tpool should
+   not be modified while the topo is in use. */
+
+fd_tpool_topo_t *
+fd_tpool_topo_init( fd_tpool_topo_t *  topo,
+                    fd_tpool_t const * tpool,
+                    ulong              t0,
+                    ulong              t1 );
+
+/* fd_tpool_topo_node_partition computes the range of tasks [node_l0,
+   node_l1) of [l0,l1) that fd_tpool_exec_all_numa assigns to node
+   node_idx.  These are contiguous and cover [l0,l1) in node order, with
+   each node getting a share proportional to its number of workers.
+   Useful to place the data a node will process in node local memory
+   (e.g. fd_shmem_acquire with a cpu_idx of one of its workers). */
+
+static inline void
+fd_tpool_topo_node_partition( fd_tpool_topo_t const * topo,
+                              ulong                   node_idx,
+                              ulong                   l0,
+                              ulong                   l1,
+                              ulong *                 _node_l0,
+                              ulong *                 _node_l1 ) {
+  ulong worker_cnt = topo->t1 - topo->t0;
+  ulong p0         = (ulong)topo->node_pos[ node_idx     ];
+  ulong p1         = (ulong)topo->node_pos[ node_idx+1UL ];
+  ulong node_l0; ulong tmp0; FD_TPOOL_PARTITION( l0,l1,1UL, p0,     worker_cnt, node_l0,tmp0    );
+  ulong tmp1; ulong node_l1; FD_TPOOL_PARTITION( l0,l1,1UL, p1-1UL, worker_cnt, tmp1,   node_l1 );
+  (void)tmp0; (void)tmp1;
+  *_node_l0 = node_l0;
+  *_node_l1 = node_l1;
+}
+
+/* fd_tpool_exec_all_numa is functionally equivalent to:
+
+     for( ulong p=0; p<t1-t0; p++ ) {
+       ulong t = topo->worker[p];
+       ulong g = topo->pos_node[p];
+       ulong batch_task_l0;
+       ulong batch_task_l1;
+       FD_TPOOL_PARTITION( task_l0,task_l1,1, p,t1-t0, batch_task_l0,batch_task_l1 );
+       task( task_tpool,t0,t1, task_args,task_reduce+g*task_stride,task_stride, task_l0,task_l1, batch_task_l0,batch_task_l1, t,t+1 );
+     }
+
+   where t0 and t1 are from topo.  That is, this is a batch style
+   exec_all where tasks are partitioned first across nodes (in
+   proportion to the number of workers on each node, see
+   fd_tpool_topo_node_partition) and then across workers within a node
+   (with workers that share a last level cache getting adjacent
+   batches).  task_reduce is treated as a pointer to a node_cnt element
+   array of task_stride byte regions and each worker gets the region of
+   its node.  This is intended to give each node its own node-local
+   scratch / reduction region (e.g. allocated near a cpu of one of its
+   workers).  If unused, pass NULL / 0 (task_reduce will be NULL for all
+   nodes in this case).
+
+   Dispatch is hierarchical too: the dispatch tree only crosses a node
+   boundary node_cnt-1 times (each node's first worker is dispatched
+   from another node and then dispatches to the rest of its node).  The
+   same usage restrictions as the other exec_all styles apply to worker
+   threads (t0,t1). */
+
+void
+fd_tpool_exec_all_numa( fd_tpool_t *            tpool,
+                        fd_tpool_topo_t const * topo,
+                        fd_tpool_task_t         task,
+                        void *                  task_tpool,
+                        void *                  task_args,
+                        void *                  task_reduce,
+                        ulong                   task_stride,
+                        ulong                   task_l0,
+                        ulong                   task_l1 );
+
 /* fd_tpool_worker_state_cstr converts an FD_TPOOL_WORKER_STATE_* code
    into a human readable cstr.  The lifetime of the returned pointer is
    infinite.  The returned pointer is always to a non-NULL cstr. */
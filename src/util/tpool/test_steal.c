@@ -0,0 +1,244 @@
+#include "../fd_util.h"
+
+#if FD_HAS_ATOMIC
+
+FD_STATIC_ASSERT( FD_STEAL_ALIGN           ==  128UL, unit_test );
+FD_STATIC_ASSERT( FD_STEAL_FOOTPRINT(1UL)  == 2432UL, unit_test );
+FD_STATIC_ASSERT( FD_STEAL_FOOTPRINT(2UL)  == 4736UL, unit_test );
+FD_STATIC_ASSERT( FD_STEAL_DEQUE_MAX       ==  256UL, unit_test );
+FD_STATIC_ASSERT( FD_STEAL_REDUCE_MAX      ==  128UL, unit_test );
+
+#define ITEM_MAX (65536UL)
+
+static uint item_cnt[ ITEM_MAX ];
+
+/* for coverage: each item should be visited exactly once */
+
+static void
+mark_task( void * args,
+           ulong  i0,
+           ulong  i1 ) {
+  ulong grain = (ulong)args;
+  FD_TEST( i0<i1 ); FD_TEST( (i1-i0)<=grain );
+  for( ulong i=i0; i<i1; i++ ) FD_ATOMIC_FETCH_AND_ADD( &item_cnt[i], 1U );
+}
+
+/* nested parallel for: each block of the outer loop does a parallel for
+   over its own sub range */
+
+static void
+nested_task( void * args,
+             ulong  i0,
+             ulong  i1 ) {
+  (void)args;
+  fd_steal_for( NULL, NULL, 0UL, 0UL, mark_task, (void *)3UL, i0*16UL, i1*16UL, 3UL );
+}
+
+/* reduce: sum of squares of items (with the combine order checked via
+   a (lo,hi) range carried along with the sum) */
+
+struct sum {
+  ulong lo;
+  ulong hi;
+  ulong sum;
+};
+
+typedef struct sum sum_t;
+
+static void
+sum_task( void * args,
+          void * reduce,
+          ulong  i0,
+          ulong  i1 ) {
+  (void)args;
+  sum_t * s = (sum_t *)reduce;
+  s->lo  = i0;
+  s->hi  = i1;
+  s->sum = 0UL;
+  for( ulong i=i0; i<i1; i++ ) s->sum += i*i;
+}
+
+static void
+sum_combine( void *       args,
+             void *       reduce,
+             void const * reduce_right ) {
+  (void)args;
+  sum_t *       l = (sum_t *)      reduce;
+  sum_t const * r = (sum_t const *)reduce_right;
+  FD_TEST( l->hi==r->lo );
+  l->hi   = r->hi;
+  l->sum += r->sum;
+}
+
+/* fib: an irregular recursive fork-join workload */
+
+struct fib_job {
+  fd_steal_job_t job[1];
+  ulong          n;
+  ulong          res;
+};
+
+typedef struct fib_job fib_job_t;
+
+static ulong
+fib_serial( ulong n ) {
+  return n<2UL ? n : fib_serial( n-1UL ) + fib_serial( n-2UL );
+}
+
+static void
+fib_job( fd_steal_job_t * _job ) {
+  fib_job_t * f = (fib_job_t *)_job;
+  ulong       n = f->n;
+  if( n<8UL ) { f->res = fib_serial( n ); return; }
+  fib_job_t a[1]; a->job->fn = fib_job; a->n = n-1UL;
+  fib_job_t b[1]; b->job->fn = fib_job; b->n = n-2UL;
+  fd_steal_fork( a->job );
+  fd_steal_fork( b->job );
+  fd_steal_join( b->job );
+  fd_steal_join( a->job );
+  f->res = a->res + b->res;
+}
+
+/* lazy: forks several jobs and then goes to sleep before joining them
+   (gives the other workers an opportunity to steal them even when the
+   workers are oversubscribed onto fewer cores).  Exercises stealing and
+   joining stolen jobs. */
+
+#define LAZY_CNT (8UL)
+
+static void
+lazy_mark_job( fd_steal_job_t * job ) {
+  mark_task( (void *)job->args, job->i0, job->i1 );
+}
+
+static void
+lazy_job( fd_steal_job_t * root ) {
+  fd_steal_job_t job[ LAZY_CNT ];
+  for( ulong idx=0UL; idx<LAZY_CNT; idx++ ) {
+    job[ idx ].fn   = lazy_mark_job;
+    job[ idx ].args = (void *)1000UL;
+    job[ idx ].i0   = root->i0 + idx*1000UL;
+    job[ idx ].i1   = root->i0 + idx*1000UL + 1000UL;
+    fd_steal_fork( job + idx );
+  }
+  fd_log_sleep( 100000L );
+  for( ulong idx=LAZY_CNT; idx; idx-- ) fd_steal_join( job + idx - 1UL );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 256UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong tile_cnt = fd_tile_cnt();
+
+  FD_LOG_NOTICE(( "Testing footprint" ));
+
+  FD_TEST( fd_steal_align()==FD_STEAL_ALIGN );
+  FD_TEST( !fd_steal_footprint( 0UL             ) );
+  FD_TEST( !fd_steal_footprint( FD_TILE_MAX+1UL ) );
+  for( ulong worker_max=1UL; worker_max<=FD_TILE_MAX; worker_max++ )
+    FD_TEST( fd_steal_footprint( worker_max )==FD_STEAL_FOOTPRINT( worker_max ) );
+
+  FD_LOG_NOTICE(( "Testing init / fini" ));
+
+  static uchar steal_mem[ FD_STEAL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_STEAL_ALIGN)));
+
+  FD_TEST( !fd_steal_init( NULL,          1UL             ) ); /* NULL mem */
+  FD_TEST( !fd_steal_init( steal_mem+1UL, 1UL             ) ); /* misaligned mem */
+  FD_TEST( !fd_steal_init( steal_mem,     0UL             ) ); /* bad worker_max */
+  FD_TEST( !fd_steal_init( steal_mem,     FD_TILE_MAX+1UL ) ); /* bad worker_max */
+  FD_TEST( !fd_steal_fini( NULL ) );                           /* NULL steal */
+
+  FD_LOG_NOTICE(( "Testing serial usage" ));
+
+  fd_memset( item_cnt, 0, sizeof(item_cnt) );
+  fd_steal_for( NULL, NULL, 0UL, 0UL, mark_task, (void *)7UL, 0UL, 1000UL, 7UL );
+  for( ulong i=0UL; i<1000UL; i++ ) FD_TEST( item_cnt[i]==1U );
+
+  fib_job_t f[1]; f->job->fn = fib_job; f->n = 20UL;
+  fd_steal_fork( f->job ); /* No scheduler, runs immediately */
+  FD_TEST( f->job->done );
+  fd_steal_join( f->job );
+  FD_TEST( f->res==fib_serial( 20UL ) );
+
+  FD_LOG_NOTICE(( "Testing parallel usage (tile_cnt %lu, --iter-cnt %lu)", tile_cnt, iter_cnt ));
+
+  static uchar tpool_mem[ FD_TPOOL_FOOTPRINT(FD_TILE_MAX) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tile_cnt ); FD_TEST( tpool );
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL )==tpool );
+
+  fd_steal_t * steal = fd_steal_init( steal_mem, tile_cnt ); FD_TEST( steal );
+
+  ulong steal_cnt = 0UL;
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong worker_cnt = fd_rng_ulong_roll( rng, tile_cnt ) + 1UL;
+    ulong t0         = fd_rng_ulong_roll( rng, tile_cnt-worker_cnt+1UL );
+    ulong t1         = t0 + worker_cnt;
+    ulong i0         = fd_rng_ulong_roll( rng, ITEM_MAX );
+    ulong i1         = i0 + fd_rng_ulong_roll( rng, ITEM_MAX-i0+1UL );
+    ulong grain      = fd_rng_ulong_roll( rng, 64UL ) + 1UL;
+
+    fd_memset( item_cnt, 0, sizeof(item_cnt) );
+    fd_steal_for( steal, tpool, t0,t1, mark_task, (void *)grain, i0,i1, grain );
+    for( ulong i=0UL; i<ITEM_MAX; i++ ) FD_TEST( item_cnt[i]==(uint)((i0<=i) & (i<i1)) );
+
+    ulong job_cnt = 0UL;
+    for( ulong worker_idx=0UL; worker_idx<worker_cnt; worker_idx++ ) job_cnt += fd_steal_worker_job_cnt( steal, worker_idx );
+    FD_TEST( job_cnt>=1UL );
+
+    if( i1>i0 ) {
+      sum_t s[1];
+      fd_steal_reduce( steal, tpool, t0,t1, sum_task, sum_combine, NULL, s, sizeof(sum_t), i0,i1, grain );
+      ulong expected = 0UL; for( ulong i=i0; i<i1; i++ ) expected += i*i;
+      FD_TEST( s->lo==i0 ); FD_TEST( s->hi==i1 ); FD_TEST( s->sum==expected );
+    }
+
+    ulong j1 = fd_ulong_min( i1, ITEM_MAX/16UL );
+    ulong j0 = fd_ulong_min( i0, j1 );
+    fd_memset( item_cnt, 0, sizeof(item_cnt) );
+    fd_steal_for( steal, tpool, t0,t1, nested_task, NULL, j0,j1, grain );
+    for( ulong i=0UL; i<ITEM_MAX; i++ ) FD_TEST( item_cnt[i]==(uint)((j0*16UL<=i) & (i<j1*16UL)) );
+
+    f->n = 10UL + fd_rng_ulong_roll( rng, 12UL );
+    fd_steal_exec( steal, tpool, t0,t1, f->job );
+    FD_TEST( f->job->done );
+    FD_TEST( f->res==fib_serial( f->n ) );
+
+    fd_steal_job_t lazy[1]; lazy->fn = lazy_job; lazy->i0 = fd_rng_ulong_roll( rng, ITEM_MAX-LAZY_CNT*1000UL+1UL );
+    fd_memset( item_cnt, 0, sizeof(item_cnt) );
+    fd_steal_exec( steal, tpool, t0,t1, lazy );
+    for( ulong i=0UL; i<ITEM_MAX; i++ ) FD_TEST( item_cnt[i]==(uint)((lazy->i0<=i) & (i<lazy->i0+LAZY_CNT*1000UL)) );
+
+    for( ulong worker_idx=0UL; worker_idx<worker_cnt; worker_idx++ ) steal_cnt += fd_steal_worker_steal_cnt( steal, worker_idx );
+    if( worker_cnt==1UL ) FD_TEST( !fd_steal_worker_steal_cnt( steal, 0UL ) );
+  }
+
+  FD_LOG_NOTICE(( "%lu jobs stolen", steal_cnt ));
+
+  FD_TEST( fd_steal_fini( steal )==(void *)steal_mem );
+  FD_TEST( fd_tpool_fini( tpool )==(void *)tpool_mem );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_ATOMIC capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -437,6 +437,81 @@ main( int     argc,
   }
 # endif
 
+  FD_LOG_NOTICE(( "Testing fd_tpool_topo" ));
+
+  static fd_tpool_topo_t topo[1];
+
+  FD_TEST( !fd_tpool_topo_init( NULL, tpool, 0UL, 1UL          ) ); /* NULL topo */
+  FD_TEST( !fd_tpool_topo_init( topo, NULL,  0UL, 1UL          ) ); /* NULL tpool */
+  FD_TEST( !fd_tpool_topo_init( topo, tpool, 0UL, 0UL          ) ); /* empty range */
+  FD_TEST( !fd_tpool_topo_init( topo, tpool, 0UL, tile_cnt+1UL ) ); /* bad range */
+
+  for( ulong t=0UL; t<tile_cnt; t++ ) {
+    ulong cpu_idx = fd_tpool_worker_cpu_idx( tpool, t );
+    FD_LOG_NOTICE(( "worker %lu: cpu %lu numa %lu llc %lu", t, cpu_idx, fd_tpool_worker_numa_idx( tpool, t ), fd_tpool_worker_llc_idx( tpool, t ) ));
+    FD_TEST( cpu_idx==fd_tile_cpu_id( t ) || (cpu_idx==ULONG_MAX && fd_tile_cpu_id( t )==ULONG_MAX-1UL) );
+  }
+
+  for( ulong rem=10000UL; rem; rem-- ) {
+    ulong tmp0   = fd_rng_ulong_roll( rng, tile_cnt );
+    ulong tmp1   = fd_rng_ulong_roll( rng, tile_cnt );
+    ulong job_t0 = fd_ulong_min( tmp0, tmp1 );
+    ulong job_t1 = fd_ulong_max( tmp0, tmp1 ) + 1UL;
+    FD_TEST( fd_tpool_topo_init( topo, tpool, job_t0, job_t1 )==topo );
+
+    ulong worker_cnt = job_t1-job_t0;
+    FD_TEST( topo->t0==job_t0 ); FD_TEST( topo->t1==job_t1 );
+    FD_TEST( (1UL<=topo->node_cnt) & (topo->node_cnt<=worker_cnt) );
+    FD_TEST( topo->worker[0]==job_t0 );
+    FD_TEST( !topo->node_pos[0] ); FD_TEST( topo->node_pos[ topo->node_cnt ]==worker_cnt );
+
+    ulong seen[ FD_TILE_MAX/64UL ]; fd_memset( seen, 0, sizeof(seen) );
+    for( ulong p=0UL; p<worker_cnt; p++ ) {
+      ulong t = (ulong)topo->worker[p];
+      ulong g = (ulong)topo->pos_node[p];
+      FD_TEST( (job_t0<=t) & (t<job_t1) );
+      FD_TEST( !fd_ulong_extract_bit( seen[t>>6], (int)(t&63UL) ) ); seen[t>>6] = fd_ulong_set_bit( seen[t>>6], (int)(t&63UL) );
+      FD_TEST( g<topo->node_cnt );
+      FD_TEST( ((ulong)topo->node_pos[g]<=p) & (p<(ulong)topo->node_pos[g+1UL]) );
+      FD_TEST( fd_tpool_worker_numa_idx( tpool, t )==fd_tpool_worker_numa_idx( tpool, topo->worker[ topo->node_pos[g] ] ) );
+    }
+
+    void * job_tpool  = (void *)fd_rng_ulong( rng );
+    void * job_args   = (void *)fd_rng_ulong( rng );
+    void * job_reduce = fd_rng_uint( rng ) & 1U ? (void *)fd_rng_ulong( rng ) : NULL;
+    ulong  job_stride = fd_rng_ulong( rng );
+    /**/   tmp0       = fd_rng_ulong( rng );
+    /**/   tmp1       = fd_rng_ulong( rng );
+    ulong  job_l0     = fd_ulong_min( tmp0, tmp1 );
+    ulong  job_l1     = fd_ulong_max( tmp0, tmp1 );
+
+    fd_memset( worker_tx, 0, FD_TILE_MAX*sizeof(test_args_t) );
+    fd_memset( worker_rx, 0, FD_TILE_MAX*sizeof(test_args_t) );
+    for( ulong p=0UL; p<worker_cnt; p++ ) {
+      ulong t = (ulong)topo->worker[p];
+      ulong g = (ulong)topo->pos_node[p];
+      ulong batch_l0;
+      ulong batch_l1;
+      FD_TPOOL_PARTITION( job_l0,job_l1,1UL, p,worker_cnt, batch_l0,batch_l1 );
+      worker_tx[t].tpool  = job_tpool;
+      worker_tx[t].t0     = job_t0;     worker_tx[t].t1     = job_t1;
+      worker_tx[t].args   = job_args;
+      worker_tx[t].reduce = job_reduce ? (void *)((ulong)job_reduce + g*job_stride) : NULL;
+      worker_tx[t].stride = job_stride;
+      worker_tx[t].l0     = job_l0;     worker_tx[t].l1     = job_l1;
+      worker_tx[t].m0     = batch_l0;   worker_tx[t].m1     = batch_l1;
+      worker_tx[t].n0     = t;          worker_tx[t].n1     = t+1UL;
+    }
+    fd_tpool_exec_all_numa( tpool, topo, worker_bulk, job_tpool, job_args, job_reduce,job_stride, job_l0,job_l1 );
+    FD_TEST( !memcmp( worker_tx, worker_rx, FD_TILE_MAX*sizeof(test_args_t) ) );
+
+    for( ulong g=0UL; g<topo->node_cnt; g++ ) {
+      ulong node_l0; ulong node_l1; fd_tpool_topo_node_partition( topo, g, job_l0,job_l1, &node_l0,&node_l1 );
+      FD_TEST( node_l0==worker_tx[ topo->worker[ topo->node_pos[g]       ] ].m0 );
+      FD_TEST( node_l1==worker_tx[ topo->worker[ topo->node_pos[g+1UL]-1 ] ].m1 );
+    }
+  }
+
   FD_TEST( fd_tpool_fini( tpool )==(void *)tpool_mem );
 
   FD_LOG_NOTICE(( "Testing fd_tpool_worker_state_cstr" ));